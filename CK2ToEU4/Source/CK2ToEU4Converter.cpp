@@ -1,16 +1,548 @@
 #include "CK2ToEU4Converter.h"
+#include "CK2World/CacheStore.h"
+#include "CK2World/Concurrency.h"
+#include "CK2World/ConversionMarks.h"
+#include "CK2World/Metrics.h"
+#include "CK2World/Progress.h"
+#include "CK2World/SaveGame/BinarySave.h"
+#include "CK2World/SaveGame/EntityQuery.h"
+#include "CK2World/SaveGame/MappedFile.h"
+#include "CK2World/SaveGame/SaveIndex.h"
+#include "CK2World/SaveGame/SaveInspector.h"
+#include "CK2World/SaveGame/SaveTuning.h"
+#include "CK2World/ThreadPool.h"
+#include "CK2World/Trace.h"
 #include "CK2World/World.h"
+#include "Configuration/BatchJobs.h"
 #include "Configuration/Configuration.h"
+#include "Configuration/JobFolder.h"
+#include "Configuration/JobScheduler.h"
+#include "Configuration/SaveFolder.h"
 #include "EU4World/EU4World.h"
+#include "EU4World/StaticData.h"
 #include "Log.h"
+#include "Mappers/LookupRecorder/LookupRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 
-void convertCK2ToEU4(const commonItems::ConverterVersion& converterVersion)
+namespace
+{
+// Fills in the thread count and character decoding the configuration left on auto, from a quick look at the save.
+// If the save can't be inspected, the settings stay on auto and the world reports the save's problem when loading it.
+Configuration tuneForSave(const Configuration& theConfiguration)
+{
+	if (theConfiguration.getThreads() && theConfiguration.getCharacterDecoding() != Configuration::CHARACTER_DECODING::AUTO)
+		return theConfiguration;
+	try
+	{
+		const auto inspection = CK2::inspectSave(theConfiguration.getSaveGamePath());
+		const auto tuning = CK2::tuneForSave(inspection,
+			 theConfiguration.getThreads(),
+			 theConfiguration.getCharacterDecoding(),
+			 std::thread::hardware_concurrency());
+		std::string decoding = "lazy";
+		if (tuning.characterDecoding == Configuration::CHARACTER_DECODING::EAGER)
+			decoding = "eager";
+		else if (tuning.characterDecoding == Configuration::CHARACTER_DECODING::SPILLED)
+			decoding = "spilled";
+		Log(LogLevel::Info) << "<> Tuned for " << inspection.gamestateBytes / (1024 * 1024) << " MiB of gamestate: " << tuning.threads << " threads, "
+								  << decoding << " character decoding.";
+		return theConfiguration.withTuning(tuning.threads, tuning.characterDecoding);
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not inspect the save to tune the conversion: " << e.what();
+		return theConfiguration;
+	}
+}
+
+// Runs a conversion's phases, taking a stop at the end of a profiling window (see CK2::PhaseTimings::window) as done.
+void convertWithin(const CK2::PhaseTimings& timings, const std::function<void()>& conversion)
+{
+	try
+	{
+		conversion();
+	}
+	catch (const CK2::PhaseTimings::Stopped& stop)
+	{
+		Log(LogLevel::Notice) << "* " << stop.what() << " *";
+		return;
+	}
+	if (timings.stops() && !timings.stopped())
+		Log(LogLevel::Warning) << "No phase by the name to stop after ran. The conversion went through, but wrote nothing.";
+}
+} // namespace
+
+void convertCK2ToEU4(const commonItems::ConverterVersion& converterVersion, const std::string& profileFrom, const std::string& stopAfter)
 {
 	Log(LogLevel::Progress) << "0 %";
-	const auto theConfiguration = Configuration(converterVersion);
-	const CK2::World sourceWorld(theConfiguration, converterVersion);
-	EU4::World destWorld(sourceWorld, theConfiguration, converterVersion);
+	CK2::Progress::open("progress.jsonl");
+	const Configuration configured(converterVersion);
+	const auto theConfiguration = tuneForSave(stopAfter.empty() ? configured : configured.withPhaseWindow(profileFrom, stopAfter));
+	CK2::Concurrency::configure(theConfiguration.getThreads(), theConfiguration.getTaskOrderSeed());
+	CK2::CacheStore::configure(converterVersion.getVersion(), theConfiguration.getCacheLimitMB() * 1024 * 1024, theConfiguration.getRemoteCache(),
+		 theConfiguration.getRemoteCacheKey());
+	if (theConfiguration.getTrace() == Configuration::TRACE::ENABLED)
+		CK2::Trace::enable();
+	if (theConfiguration.getLookupTrace() == Configuration::LOOKUP_TRACE::ENABLED)
+	{
+		Log(LogLevel::Info) << "<< Recording mapper lookups to: lookups.bin";
+		mappers::LookupRecorder::start("lookups.bin");
+	}
+	CK2::PhaseTimings timings;
+	if (theConfiguration.getHardwareCounters() == Configuration::HARDWARE_COUNTERS::ENABLED)
+		timings.enableHardwareCounters();
+	if (theConfiguration.getMemoryCensus() == Configuration::MEMORY_CENSUS::ENABLED)
+		timings.enableMemoryCensus();
+	if (theConfiguration.getContention() == Configuration::CONTENTION::ENABLED)
+		timings.enableContention();
+	timings.window(theConfiguration.getProfileFrom(), theConfiguration.getStopAfter());
+	// Every parallel loop and graph of the run shares one pool, the calling thread making up the configured count. Hardware
+	// counters only follow threads started after them and count them as they exit, so with those on each loop keeps
+	// starting threads of its own.
+	std::optional<CK2::ThreadPool::Scope> pool;
+	if (!CK2::Concurrency::serial() && theConfiguration.getHardwareCounters() != Configuration::HARDWARE_COUNTERS::ENABLED)
+		pool.emplace(CK2::Concurrency::threads() - 1);
+	EU4::StaticData staticData;
+	EU4::World::prefetchVanilla(theConfiguration, converterVersion, staticData);
+	// Neither world is ever torn down. The CK2 entities sit in the CK2 world's arena and point at each other every
+	// which way, and the EU4 countries and provinces link back to them and to each other; unwinding all of that only to
+	// hand the memory back to the OS a moment later takes seconds. Everything the conversion writes is closed by the time
+	// the EU4 world's constructor returns.
+	convertWithin(timings, [&] {
+		const auto& sourceWorld = *new CK2::World(theConfiguration, converterVersion, timings, staticData.ck2InstallSource());
+		new EU4::World(sourceWorld, theConfiguration, converterVersion, timings, staticData);
+	});
 
-	Log(LogLevel::Notice) << "* Conversion complete *";
+	timings.logTable();
+	if (theConfiguration.getTimings() == Configuration::TIMINGS::JSON)
+		timings.writeJSON("timings.json");
+	if (CK2::Trace::enabled())
+	{
+		Log(LogLevel::Info) << "<< Writing conversion trace to: trace.json";
+		CK2::Trace::write("trace.json");
+	}
+	mappers::LookupRecorder::stop();
+
+	CK2::Progress::close();
+	if (!timings.stops())
+		Log(LogLevel::Notice) << "* Conversion complete *";
 	Log(LogLevel::Progress) << "100 %";
 }
+
+namespace
+{
+struct BatchConversion
+{
+	const BatchJobs::Job& job;
+	std::optional<Configuration> configuration;
+	std::string worldKey; // CK2::World::buildKey, for jobs reusing worlds
+	std::string error;
+	bool converted = false;
+};
+
+// Built CK2 worlds kept for jobs with reuse_ck2_world on, keyed by CK2::World::buildKey. The EU4 side writes its marks
+// into the world it converts, so one conversion at a time holds a world, putting the marks back before it starts.
+// Worlds of the same save built with different CK2 settings (a sweep's) are built one at a time, so that only the
+// first parses the save and the others start from its snapshot. A world goes once the last job expecting it is done.
+class WorldShelf
+{
+  public:
+	struct Entry
+	{
+		std::mutex inUse;
+		std::unique_ptr<const CK2::World> world;
+		std::optional<CK2::ConversionMarks> marks; // after the world, so gone before it
+	};
+
+	// Counts in a job that is going to take key.
+	void expect(const std::string& key)
+	{
+		const std::lock_guard lock(entriesMutex);
+		++pending[key];
+	}
+
+	// The entry for key, created empty if this is the first job with it.
+	[[nodiscard]] std::shared_ptr<Entry> take(const std::string& key)
+	{
+		const std::lock_guard lock(entriesMutex);
+		auto& entry = entries[key];
+		if (!entry)
+			entry = std::make_shared<Entry>();
+		return entry;
+	}
+
+	// A job expecting key is done with it, converted or not. The last one lets the world go along with its entry.
+	void finish(const std::string& key)
+	{
+		std::shared_ptr<Entry> lastEntry;
+		{
+			const std::lock_guard lock(entriesMutex);
+			if (--pending[key])
+				return;
+			pending.erase(key);
+			if (const auto entry = entries.find(key); entry != entries.end())
+			{
+				lastEntry = std::move(entry->second);
+				entries.erase(entry);
+			}
+		}
+		// Torn down outside the lock, it takes a while.
+	}
+
+	// Held while building a world of the save.
+	[[nodiscard]] std::shared_ptr<std::mutex> building(const std::string& save)
+	{
+		const std::lock_guard lock(entriesMutex);
+		auto& saveMutex = builds[save];
+		if (!saveMutex)
+			saveMutex = std::make_shared<std::mutex>();
+		return saveMutex;
+	}
+
+  private:
+	std::mutex entriesMutex;
+	std::map<std::string, std::shared_ptr<Entry>> entries;
+	std::map<std::string, std::size_t> pending;
+	std::map<std::string, std::shared_ptr<std::mutex>> builds;
+};
+
+void convertBatchJob(BatchConversion& conversion,
+	 const commonItems::ConverterVersion& converterVersion,
+	 EU4::StaticData& staticData,
+	 WorldShelf& shelf,
+	 const std::atomic<bool>& cancelled)
+{
+	const auto& theConfiguration = *conversion.configuration;
+	Log(LogLevel::Notice) << "** Converting " << conversion.job.save << " into " << theConfiguration.getOutputName() << " **";
+	const CK2::Concurrency::JobCap threadCap(conversion.job.threads);
+	try
+	{
+		// Unlike a lone conversion's, the CK2 world is torn down once nothing needs it anymore, so a batch or a server
+		// running for days holds on to no more saves than it is converting.
+		CK2::PhaseTimings timings;
+		timings.cancelWith(cancelled);
+		if (theConfiguration.getHardwareCounters() == Configuration::HARDWARE_COUNTERS::ENABLED)
+			timings.enableHardwareCounters();
+		if (theConfiguration.getMemoryCensus() == Configuration::MEMORY_CENSUS::ENABLED)
+			timings.enableMemoryCensus();
+		if (theConfiguration.getContention() == Configuration::CONTENTION::ENABLED)
+			timings.enableContention();
+		timings.window(theConfiguration.getProfileFrom(), theConfiguration.getStopAfter());
+		convertWithin(timings, [&] {
+			// Declared so they go in the right order: the EU4 world first, as it links into the CK2 one, then the world
+			// lock and the CK2 world.
+			std::unique_ptr<const CK2::World> ownWorld;
+			std::shared_ptr<WorldShelf::Entry> shelved;
+			std::unique_lock<std::mutex> worldLock;
+			const CK2::World* sourceWorldPointer = nullptr;
+			if (!conversion.worldKey.empty())
+			{
+				shelved = shelf.take(conversion.worldKey);
+				worldLock = std::unique_lock(shelved->inUse);
+				if (shelved->world)
+				{
+					Log(LogLevel::Info) << "<> Reusing the CK2 world built for an earlier job with the same save and CK2 settings.";
+					shelved->marks->restore();
+					sourceWorldPointer = shelved->world.get();
+				}
+			}
+			if (!sourceWorldPointer)
+			{
+				std::unique_lock<std::mutex> buildLock;
+				if (shelved && theConfiguration.getSnapshot() != Configuration::SNAPSHOT::DISABLED)
+					buildLock = std::unique_lock(*shelf.building(theConfiguration.getSaveGamePath()));
+				ownWorld = std::make_unique<const CK2::World>(theConfiguration, converterVersion, timings, staticData.ck2InstallSource());
+				sourceWorldPointer = ownWorld.get();
+				if (shelved)
+				{
+					shelved->marks.emplace(*sourceWorldPointer);
+					shelved->world = std::move(ownWorld);
+				}
+			}
+			const auto& sourceWorld = *sourceWorldPointer;
+			EU4::World destWorld(sourceWorld, theConfiguration, converterVersion, timings, staticData);
+		});
+		if (theConfiguration.getTimings() == Configuration::TIMINGS::JSON)
+			timings.writeJSON("timings_" + theConfiguration.getOutputName() + ".json");
+		if (!timings.stops())
+			Log(LogLevel::Notice) << "** Converted " << theConfiguration.getOutputName() << " **";
+		conversion.converted = true;
+		++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "converted"}});
+		CK2::Metrics::observeConversion(timings);
+	}
+	catch (const std::exception& e)
+	{
+		conversion.error = e.what();
+		Log(LogLevel::Error) << "Converting " << conversion.job.save << " failed: " << e.what();
+		++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", cancelled ? "cancelled" : "failed"}});
+	}
+}
+
+void convertJobs(const BatchJobs& batch, const commonItems::ConverterVersion& converterVersion, EU4::StaticData& staticData, const std::atomic<bool>& cancelled)
+{
+	CK2::Concurrency::configure(batch.getThreads(), 0);
+	CK2::CacheStore::configure(converterVersion.getVersion(), batch.getCacheLimitMB() * 1024 * 1024, batch.getRemoteCache(), batch.getRemoteCacheKey());
+
+	// Every job's settings are read and checked before anything converts, so a typo doesn't surface hours in.
+	WorldShelf shelf;
+	std::vector<BatchConversion> conversions;
+	std::vector<JobScheduler::Request> requests;
+	std::set<std::string> outputNames;
+	for (const auto& job: batch.getJobs())
+	{
+		auto& conversion = conversions.emplace_back(BatchConversion{job});
+		auto& request = requests.emplace_back(JobScheduler::Request{job.priority});
+		try
+		{
+			std::istringstream settings(BatchJobs::settingsFor(job));
+			conversion.configuration.emplace(converterVersion, settings);
+			if (!outputNames.insert(conversion.configuration->getOutputName()).second)
+				throw std::runtime_error("Another job already writes output/" + conversion.configuration->getOutputName());
+			// These write to one fixed file per process; a batch has no single conversion to give it to.
+			if (conversion.configuration->getTrace() == Configuration::TRACE::ENABLED ||
+				 conversion.configuration->getLookupTrace() == Configuration::LOOKUP_TRACE::ENABLED)
+				Log(LogLevel::Warning) << "Traces aren't recorded in batch conversions, ignoring them for " << job.save;
+			if (batch.getMemoryBudgetMB())
+				request.estimatedBytes = CK2::estimateConversionBytes(CK2::inspectSave(conversion.configuration->getSaveGamePath(), false));
+			if (conversion.configuration->getReuseWorld() == Configuration::REUSE_WORLD::ENABLED)
+			{
+				conversion.worldKey = CK2::World::buildKey(*conversion.configuration, converterVersion.getVersion());
+				shelf.expect(conversion.worldKey);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			conversion.configuration.reset();
+			conversion.error = e.what();
+			Log(LogLevel::Error) << "Skipping " << job.save << ": " << e.what();
+			++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "rejected"}});
+		}
+	}
+
+	// Jobs side by side share one pool too, each still held to its own thread cap.
+	std::optional<CK2::ThreadPool::Scope> pool;
+	if (!CK2::Concurrency::serial() && std::none_of(conversions.begin(), conversions.end(), [](const BatchConversion& conversion) {
+			 return conversion.configuration && conversion.configuration->getHardwareCounters() == Configuration::HARDWARE_COUNTERS::ENABLED;
+		 }))
+		pool.emplace(CK2::Concurrency::threads());
+
+	// Conversions side by side share the install data, mappers and vanilla data of their setup and copy only what
+	// they change.
+	JobScheduler scheduler(requests, batch.getMemoryBudgetMB() * 1024 * 1024, cancelled);
+	auto& queued = CK2::Metrics::gauge("ck2toeu4_queued_jobs", {{"queue", "batch"}});
+	queued.store(static_cast<double>(conversions.size()));
+	const auto convertNext = [&conversions, &scheduler, &queued, &converterVersion, &staticData, &shelf, &cancelled] {
+		while (const auto index = scheduler.admit())
+		{
+			queued.store(static_cast<double>(scheduler.countWaiting()));
+			if (conversions[*index].configuration)
+				convertBatchJob(conversions[*index], converterVersion, staticData, shelf, cancelled);
+			if (!conversions[*index].worldKey.empty())
+				shelf.finish(conversions[*index].worldKey);
+			scheduler.release(*index);
+		}
+	};
+	std::vector<std::thread> workers;
+	for (std::size_t worker = 0; worker < std::min(batch.getConversions(), conversions.size()); ++worker)
+		workers.emplace_back(convertNext);
+	for (auto& worker: workers)
+		worker.join();
+	queued.store(0);
+	if (cancelled)
+		for (auto& conversion: conversions)
+			if (conversion.error.empty() && !conversion.converted)
+			{
+				conversion.error = "Cancelled.";
+				++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "cancelled"}});
+			}
+
+	std::size_t failed = 0;
+	for (const auto& conversion: conversions)
+		if (!conversion.error.empty())
+		{
+			Log(LogLevel::Error) << "FAILED " << conversion.job.save << ": " << conversion.error;
+			++failed;
+		}
+	if (failed)
+		throw std::runtime_error(std::to_string(failed) + " of " + std::to_string(conversions.size()) + " batch jobs failed.");
+	Log(LogLevel::Notice) << "* Batch of " << conversions.size() << " conversions complete *";
+}
+} // namespace
+
+void convertBatch(const commonItems::ConverterVersion& converterVersion, const std::string& jobsPath)
+{
+	EU4::StaticData staticData(true);
+	const std::atomic<bool> cancelled = false;
+	convertJobs(BatchJobs(jobsPath), converterVersion, staticData, cancelled);
+}
+
+namespace
+{
+std::string quoted(const std::string& argument)
+{
+#ifdef _WIN32
+	return "\"" + argument + "\"";
+#else
+	std::string quotedArgument = "'";
+	for (const auto character: argument)
+		quotedArgument += character == '\'' ? std::string("'\\''") : std::string(1, character);
+	return quotedArgument + "'";
+#endif
+}
+
+// Prepares one save at a time, each in a process of its own: preparing is a lone conversion that stops after the CK2
+// phases, whose world is left for the process exit to clean up.
+void watchSaves(const std::string& converterPath, const std::string& folder, const std::atomic<bool>& stop)
+{
+	SaveFolder saveFolder(folder);
+	Log(LogLevel::Notice) << "* Watching " << folder << " for new saves to prepare *";
+	while (!stop)
+	{
+		for (const auto& save: saveFolder.takeSettledSaves())
+		{
+			Log(LogLevel::Info) << "-> Preparing " << save << " in the background.";
+			auto command = quoted(converterPath) + " --prepare-save " + quoted(save);
+#ifdef _WIN32
+			command = "\"" + command + "\""; // cmd.exe takes off the outer pair
+#endif
+			if (const auto status = std::system(command.c_str()); status)
+				Log(LogLevel::Warning) << "Could not prepare " << save << ", it will convert from the start (exit status " << status << ").";
+			else
+				Log(LogLevel::Info) << "<> Prepared " << save << ".";
+			if (stop)
+				break;
+		}
+		for (auto waited = 0; waited < 8 && !stop; ++waited)
+			std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	}
+}
+} // namespace
+
+void serveConversions(const commonItems::ConverterVersion& converterVersion,
+	 const std::string& folder,
+	 const std::optional<std::uint16_t> metricsPort,
+	 const std::string& converterPath,
+	 const std::optional<std::string>& savesFolder)
+{
+	const JobFolder jobFolder(folder);
+	std::optional<CK2::MetricsServer> metrics;
+	if (metricsPort)
+	{
+		metrics.emplace(*metricsPort);
+		Log(LogLevel::Info) << "<> Serving metrics at http://127.0.0.1:" << metrics->getPort() << "/metrics";
+	}
+	// Kept for as long as the server runs, so only a job's first conversion of each setup pays for loading it.
+	EU4::StaticData staticData(true);
+	std::atomic<bool> stopPreparing = false;
+	std::thread preparer;
+	if (savesFolder)
+		preparer = std::thread(watchSaves, converterPath, *savesFolder, std::cref(stopPreparing));
+	Log(LogLevel::Notice) << "* Watching " << folder << " for jobs files, an empty file named stop in it stops the server *";
+	auto& queued = CK2::Metrics::gauge("ck2toeu4_queued_jobs", {{"queue", "folder"}});
+	while (!jobFolder.takeStopRequest())
+	{
+		const auto jobsPath = jobFolder.nextJobs();
+		const auto waiting = jobFolder.countJobs();
+		queued.store(static_cast<double>(waiting ? waiting - 1 : 0)); // not counting the one we're taking
+		if (!jobsPath)
+		{
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			continue;
+		}
+
+		// Watches for the jobs file's cancel file for as long as it converts.
+		std::atomic<bool> cancelled = jobFolder.takeCancelRequest(*jobsPath);
+		std::atomic<bool> settled = false;
+		std::thread cancelWatch([&jobFolder, &jobsPath, &cancelled, &settled] {
+			while (!settled && !cancelled)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(250));
+				if (jobFolder.takeCancelRequest(*jobsPath))
+				{
+					Log(LogLevel::Notice) << "* Cancelling " << *jobsPath << " *";
+					cancelled = true;
+				}
+			}
+		});
+		std::string error;
+		try
+		{
+			convertJobs(BatchJobs(*jobsPath), converterVersion, staticData, cancelled);
+		}
+		catch (const std::exception& e)
+		{
+			Log(LogLevel::Error) << *jobsPath << ": " << e.what();
+			error = e.what();
+		}
+		settled = true;
+		cancelWatch.join();
+		jobFolder.finish(*jobsPath, error);
+	}
+	stopPreparing = true;
+	if (preparer.joinable())
+		preparer.join();
+	Log(LogLevel::Notice) << "* Conversion server stopped *";
+}
+
+void prepareSaves(const std::string& converterPath, const std::string& folder)
+{
+	const std::atomic<bool> stop = false;
+	watchSaves(converterPath, folder, stop);
+}
+
+void prepareSave(const commonItems::ConverterVersion& converterVersion, const std::string& savePath)
+{
+	CK2::Concurrency::lowerPriority();
+	const auto theConfiguration = tuneForSave(Configuration(converterVersion).withSaveGamePath(savePath));
+	if (theConfiguration.getSnapshot() == Configuration::SNAPSHOT::DISABLED)
+	{
+		Log(LogLevel::Warning) << "Snapshots are disabled in configuration.txt, so there's nothing to prepare " << savePath << " into.";
+		return;
+	}
+	CK2::Concurrency::configure(theConfiguration.getThreads(), 0);
+	CK2::CacheStore::configure(converterVersion.getVersion(), theConfiguration.getCacheLimitMB() * 1024 * 1024, theConfiguration.getRemoteCache(),
+		 theConfiguration.getRemoteCacheKey());
+	CK2::PhaseTimings timings;
+	// Building the world reads the save and writes its snapshot, and asking for the install data compiles the mappers'
+	// configurables on the side. Like a lone conversion's, the world is never torn down.
+	EU4::StaticData staticData;
+	new CK2::World(theConfiguration, converterVersion, timings, staticData.ck2InstallSource());
+	Log(LogLevel::Notice) << "* Prepared " << savePath << " *";
+}
+
+void describeSave(const std::string& savePath)
+{
+	const auto inspection = CK2::inspectSave(savePath);
+	Log(LogLevel::Info) << "<> " << savePath << (inspection.compressed ? " (compressed, " : " (") << (inspection.binary ? "ironman, " : "") << inspection.fileBytes
+							  << " bytes)";
+	Log(LogLevel::Info) << "<> Savegame version: " << inspection.version << ", date: " << inspection.date;
+	Log(LogLevel::Info) << "<> Player: " << inspection.playerName << " of " << inspection.playerRealm;
+	Log(LogLevel::Info) << "<> Gamestate: " << inspection.gamestateBytes << " bytes";
+	auto blocks = inspection.blocks;
+	std::ranges::stable_sort(blocks, std::ranges::greater(), &CK2::SaveInspection::Block::bytes);
+	for (const auto& block: blocks)
+		Log(LogLevel::Info) << "\t" << block.name << ": " << block.bytes << " bytes" << (block.count > 1 ? " in " + std::to_string(block.count) + " blocks" : "");
+}
+
+void querySave(const std::string& savePath, const std::string& kind, const std::string& key)
+{
+	const CK2::MappedFile saveFile(savePath);
+	const std::string_view gamestate(saveFile.data(), saveFile.size());
+	if (gamestate.starts_with("PK") || CK2::isBinaryGamestate(gamestate))
+		throw std::runtime_error("Only uncompressed text saves can be queried.");
+	const auto index = CK2::SaveIndex::forSave(savePath, gamestate);
+	for (const auto& line: CK2::queryEntity(gamestate, index, kind, key))
+		Log(LogLevel::Info) << line;
+}
@@ -1,7 +1,33 @@
 #ifndef CK2TOEU4_CONVERTER_H
 #define CK2TOEU4_CONVERTER_H
 #include "ConverterVersion.h"
+#include <cstdint>
+#include <optional>
+#include <string>
 
-void convertCK2ToEU4(const commonItems::ConverterVersion& converterVersion);
+// Given a phase to stop after, converts only that far, writing nothing, and times only the phases from profileFrom on,
+// in place of configuration.txt's profile_from and stop_after.
+void convertCK2ToEU4(const commonItems::ConverterVersion& converterVersion, const std::string& profileFrom = "", const std::string& stopAfter = "");
+// Converts every job in the jobs file (see BatchJobs), loading the mappers and vanilla data once for all of them.
+void convertBatch(const commonItems::ConverterVersion& converterVersion, const std::string& jobsPath);
+// Converts the jobs files dropped into the folder (see JobFolder) one after another until told to stop, keeping what
+// it loaded from the installs for the next ones. Given a port, it also serves its metrics (see CK2::Metrics) there, and
+// given a saves folder, it prepares the saves turning up there meanwhile as prepareSaves does.
+void serveConversions(const commonItems::ConverterVersion& converterVersion,
+	 const std::string& folder,
+	 std::optional<std::uint16_t> metricsPort,
+	 const std::string& converterPath,
+	 const std::optional<std::string>& savesFolder);
+// Watches the CK2 save folder (see SaveFolder) until killed, and gets the CK2 half of converting each new save done as
+// it appears: converterPath --prepare-save <save> runs prepareSave on it in a process of its own.
+void prepareSaves(const std::string& converterPath, const std::string& folder);
+// Reads the save with configuration.txt's other settings, at background priority, as far as writing its snapshot.
+// Converting it afterwards with the same installs and mods then starts from there.
+void prepareSave(const commonItems::ConverterVersion& converterVersion, const std::string& savePath);
+// Logs the save's version, date, player and block sizes without converting (or loading) anything.
+void describeSave(const std::string& savePath);
+// Logs one character, title or province of the save and those it points at (see CK2::queryEntity), reading only
+// their entries through the save's SaveIndex.
+void querySave(const std::string& savePath, const std::string& kind, const std::string& key);
 
 #endif // CK2TOEU4_CONVERTER_H
@@ -0,0 +1,152 @@
+#include "AllocationProfile.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+// Constant-initialized, so they're ready before any static constructor allocates.
+constinit std::atomic<std::size_t> allocations = 0;
+constinit std::atomic<std::size_t> allocatedBytes = 0;
+} // namespace
+
+CK2::AllocationProfile::Totals CK2::AllocationProfile::totals()
+{
+	return Totals{allocations.load(std::memory_order_relaxed), allocatedBytes.load(std::memory_order_relaxed)};
+}
+
+#ifdef CK2TOEU4_ALLOCATION_PROFILE
+// The replaceable global allocation functions. Every form of new comes through one of these two, every form of delete
+// through the matching release.
+namespace
+{
+void* countedAllocation(std::size_t size) noexcept
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* countedAlignedAllocation(std::size_t size, const std::align_val_t alignment) noexcept
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	const auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+	return _aligned_malloc(size ? size : 1, align);
+#else
+	// aligned_alloc wants a whole number of alignments.
+	const auto rounded = size ? (size + align - 1) / align * align : align;
+	return std::aligned_alloc(align, rounded);
+#endif
+}
+
+void alignedRelease(void* pointer) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+void* throwingAllocation(const std::size_t size)
+{
+	if (auto* pointer = countedAllocation(size))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void* throwingAlignedAllocation(const std::size_t size, const std::align_val_t alignment)
+{
+	if (auto* pointer = countedAlignedAllocation(size, alignment))
+		return pointer;
+	throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(const std::size_t size)
+{
+	return throwingAllocation(size);
+}
+void* operator new[](const std::size_t size)
+{
+	return throwingAllocation(size);
+}
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+	return throwingAlignedAllocation(size, alignment);
+}
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+	return throwingAlignedAllocation(size, alignment);
+}
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return countedAlignedAllocation(size, alignment);
+}
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return countedAlignedAllocation(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	std::free(pointer);
+}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	std::free(pointer);
+}
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	alignedRelease(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	alignedRelease(pointer);
+}
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	alignedRelease(pointer);
+}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	alignedRelease(pointer);
+}
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedRelease(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedRelease(pointer);
+}
+#endif
@@ -0,0 +1,32 @@
+#ifndef CK2_ALLOCATION_PROFILE_H
+#define CK2_ALLOCATION_PROFILE_H
+#include <cstddef>
+
+namespace CK2
+{
+// Every operator new of the process, counted. Only in builds configured with CK2TOEU4_ALLOCATION_PROFILE, which swap in
+// a counting global allocator; PhaseTimings then notes each phase's share next to its other counts. Threads all bump the
+// same two counters, so expect such a build to run noticeably slower than a normal one.
+class AllocationProfile
+{
+  public:
+	struct Totals
+	{
+		std::size_t allocations = 0;
+		std::size_t bytes = 0;
+	};
+
+	[[nodiscard]] static constexpr bool enabled()
+	{
+#ifdef CK2TOEU4_ALLOCATION_PROFILE
+		return true;
+#else
+		return false;
+#endif
+	}
+	// Since the process started; zeroes when the profile isn't built in.
+	[[nodiscard]] static Totals totals();
+};
+} // namespace CK2
+
+#endif // CK2_ALLOCATION_PROFILE_H
@@ -0,0 +1,328 @@
+#include "CacheStore.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "RemoteCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+namespace fs = std::filesystem;
+
+namespace
+{
+// Layout: magic, build, key (each a 64-bit length and the bytes), the payload, then the payload's length and checksum.
+const std::string entryMagic = "CK2ToEU4 cache 1";
+constexpr std::uint64_t fnvBasis = 14695981039346656037ull;
+constexpr std::uint64_t fnvPrime = 1099511628211ull;
+
+std::mutex settingsMutex;
+std::string storeBuild;
+std::shared_ptr<const CK2::RemoteCache> remoteCache;
+std::string remoteCacheKey;
+std::atomic<std::size_t> storeLimit = 0;
+
+std::uint64_t checksum(std::uint64_t hash, const char* bytes, const std::size_t length)
+{
+	for (std::size_t index = 0; index < length; ++index)
+	{
+		hash ^= static_cast<unsigned char>(bytes[index]);
+		hash *= fnvPrime;
+	}
+	return hash;
+}
+
+// Passes the payload through to the file, keeping count and checksum on the way.
+class ChecksumBuffer: public std::streambuf
+{
+  public:
+	explicit ChecksumBuffer(std::streambuf& theTarget): target(theTarget) {}
+
+	std::uint64_t length = 0;
+	std::uint64_t hash = fnvBasis;
+
+  protected:
+	std::streamsize xsputn(const char* bytes, const std::streamsize count) override
+	{
+		const auto written = target.sputn(bytes, count);
+		hash = checksum(hash, bytes, static_cast<std::size_t>(written));
+		length += static_cast<std::uint64_t>(written);
+		return written;
+	}
+	int_type overflow(const int_type character) override
+	{
+		if (traits_type::eq_int_type(character, traits_type::eof()))
+			return traits_type::not_eof(character);
+		const auto byte = traits_type::to_char_type(character);
+		return xsputn(&byte, 1) == 1 ? character : traits_type::eof();
+	}
+
+  private:
+	std::streambuf& target;
+};
+
+void putNumber(std::ostream& output, const std::uint64_t value)
+{
+	output.write(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+void putString(std::ostream& output, const std::string& value)
+{
+	putNumber(output, value.size());
+	output.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// Reads forward through the header; false once it runs out of file.
+struct HeaderReader
+{
+	const char* data;
+	std::size_t size;
+	std::size_t position = 0;
+
+	bool getNumber(std::uint64_t& value)
+	{
+		if (size - position < sizeof value)
+			return false;
+		std::memcpy(&value, data + position, sizeof value);
+		position += sizeof value;
+		return true;
+	}
+	bool matches(const std::string& expected)
+	{
+		std::uint64_t length = 0;
+		if (!getNumber(length) || length != expected.size() || size - position < length)
+			return false;
+		const auto same = std::memcmp(data + position, expected.data(), expected.size()) == 0;
+		position += expected.size();
+		return same;
+	}
+};
+
+std::string currentBuild()
+{
+	const std::lock_guard lock(settingsMutex);
+	return storeBuild;
+}
+
+std::shared_ptr<const CK2::RemoteCache> currentRemote()
+{
+	const std::lock_guard lock(settingsMutex);
+	return remoteCache;
+}
+
+// Entries of different builds under the same key are different objects in the farm.
+std::string objectName(const std::string& key)
+{
+	return CK2::CacheStore::digest(currentBuild() + "\n" + key) + ".bin";
+}
+} // namespace
+
+void CK2::CacheStore::configure(const std::string& build, const std::size_t limitBytes, const std::string& remoteUrl, const std::string& remoteKey)
+{
+	const std::lock_guard lock(settingsMutex);
+	storeBuild = build;
+	storeLimit = limitBytes;
+	if (remoteUrl.empty())
+		remoteCache.reset();
+	else if (!remoteCache || remoteCache->getUrl() != remoteUrl || remoteCacheKey != remoteKey)
+		remoteCache = std::make_shared<const RemoteCache>(remoteUrl, remoteKey);
+	remoteCacheKey = remoteKey;
+}
+
+std::string CK2::CacheStore::digest(const std::string_view bytes)
+{
+	std::stringstream hex;
+	hex << std::hex << std::setw(16) << std::setfill('0') << checksum(fnvBasis, bytes.data(), bytes.size());
+	return hex.str();
+}
+
+std::string CK2::CacheStore::pathFor(const std::string& folder, const std::string& key)
+{
+	return std::string(root) + "/" + folder + "/" + digest(key) + ".bin";
+}
+
+std::optional<CK2::CacheStore::Entry> CK2::CacheStore::load(const std::string& path, const std::string& key, const SHARING sharing)
+{
+	auto entry = open(path, key);
+	const auto remote = sharing == SHARING::FARM ? currentRemote() : nullptr;
+	if (entry || !remote)
+		return entry;
+
+	const auto object = remote->get(objectName(key));
+	static auto& remoteHits = Metrics::lookups("remote_cache", true);
+	static auto& remoteMisses = Metrics::lookups("remote_cache", false);
+	(object ? remoteHits : remoteMisses).fetch_add(1, std::memory_order_relaxed);
+	if (!object)
+		return std::nullopt;
+	try
+	{
+		writeAside(path, [&object](std::ostream& output) {
+			output.write(object->data(), static_cast<std::streamsize>(object->size()));
+		});
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not keep " << path << " from the farm cache: " << e.what();
+		return std::nullopt;
+	}
+	Log(LogLevel::Info) << "<> " << path << " came from the farm cache.";
+	return open(path, key);
+}
+
+std::optional<CK2::CacheStore::Entry> CK2::CacheStore::open(const std::string& path, const std::string& key)
+{
+	const auto file = fs::u8path(path);
+	if (!fs::exists(file))
+		return std::nullopt;
+
+	Entry entry;
+	try
+	{
+		entry.file = MappedFile(path);
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Cache entry " << path << " is unreadable: " << e.what();
+		return std::nullopt;
+	}
+
+	HeaderReader header{entry.file.data(), entry.file.size()};
+	if (!header.matches(entryMagic) || !header.matches(currentBuild()))
+	{
+		Log(LogLevel::Info) << "<> " << path << " was made by a different converter build, ignoring it.";
+		return std::nullopt;
+	}
+	if (!header.matches(key))
+	{
+		Log(LogLevel::Info) << "<> " << path << " is out of date, ignoring it.";
+		return std::nullopt;
+	}
+
+	std::uint64_t length = 0;
+	std::uint64_t hash = 0;
+	HeaderReader trailer{entry.file.data(), entry.file.size(), entry.file.size() - std::min(entry.file.size(), 2 * sizeof(std::uint64_t))};
+	if (entry.file.size() - header.position < 2 * sizeof(std::uint64_t) || !trailer.getNumber(length) || !trailer.getNumber(hash) ||
+		 length != entry.file.size() - header.position - 2 * sizeof(std::uint64_t) || hash != checksum(fnvBasis, entry.file.data() + header.position, length))
+	{
+		Log(LogLevel::Warning) << "Cache entry " << path << " is damaged, ignoring it.";
+		return std::nullopt;
+	}
+	entry.offset = header.position;
+	entry.length = static_cast<std::size_t>(length);
+
+	// Recency is the modification time, which nothing else under the store looks at.
+	std::error_code error;
+	fs::last_write_time(file, fs::file_time_type::clock::now(), error);
+	return entry;
+}
+
+void CK2::CacheStore::save(const std::string& path,
+	 const std::string& key,
+	 const std::function<void(std::ostream&)>& writePayload,
+	 const SHARING sharing)
+{
+	writeAside(path, [&path, &key, &writePayload](std::ostream& output) {
+		putString(output, entryMagic);
+		putString(output, currentBuild());
+		putString(output, key);
+		ChecksumBuffer payloadBuffer(*output.rdbuf());
+		{
+			std::ostream payload(&payloadBuffer);
+			writePayload(payload);
+			if (!payload.good())
+				throw std::runtime_error("Could not write " + path + ".");
+		}
+		putNumber(output, payloadBuffer.length);
+		putNumber(output, payloadBuffer.hash);
+	});
+
+	// The entry as written goes up whole, so other machines check it the same way this one does.
+	if (const auto remote = sharing == SHARING::FARM ? currentRemote() : nullptr)
+	{
+		const MappedFile written(path);
+		if (remote->put(objectName(key), std::string_view(written.data(), written.size())))
+			Log(LogLevel::Info) << "<> " << path << " shared through the farm cache.";
+	}
+	evict();
+}
+
+void CK2::CacheStore::writeAside(const std::string& path, const std::function<void(std::ostream&)>& writeFile)
+{
+	const auto file = fs::u8path(path);
+	if (file.has_parent_path())
+		fs::create_directories(file.parent_path());
+
+	// Conversions sharing a process may write the same entry side by side; each writes a partial file of its own.
+	auto partialFile = file;
+	partialFile += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".partial";
+	try
+	{
+		std::ofstream output(partialFile, std::ios::binary | std::ios::trunc);
+		if (!output.is_open())
+			throw std::runtime_error("Could not open " + path + " for writing.");
+		writeFile(output);
+		output.close();
+		if (!output)
+			throw std::runtime_error("Could not write " + path + ".");
+		fs::rename(partialFile, file);
+	}
+	catch (...)
+	{
+		std::error_code error;
+		fs::remove(partialFile, error);
+		throw;
+	}
+}
+
+void CK2::CacheStore::evict()
+{
+	const auto limit = storeLimit.load();
+	std::error_code error;
+	if (!limit || !fs::exists(fs::u8path(std::string(root)), error))
+		return;
+
+	struct Stored
+	{
+		fs::path path;
+		fs::file_time_type used;
+		std::uintmax_t bytes = 0;
+	};
+	std::vector<Stored> entries;
+	std::uintmax_t totalBytes = 0;
+	for (fs::recursive_directory_iterator item(fs::u8path(std::string(root)), error), end; !error && item != end; item.increment(error))
+	{
+		if (!item->is_regular_file(error) || item->path().extension() == ".partial")
+			continue;
+		const auto bytes = item->file_size(error);
+		const auto used = item->last_write_time(error);
+		if (error)
+			continue;
+		entries.emplace_back(Stored{item->path(), used, bytes});
+		totalBytes += bytes;
+	}
+	if (totalBytes <= limit)
+		return;
+
+	// Readers holding an entry keep their mapping; on Windows the removal fails instead and the entry stays a while.
+	std::ranges::sort(entries, {}, &Stored::used);
+	std::size_t evicted = 0;
+	for (const auto& entry: entries)
+	{
+		if (totalBytes <= limit)
+			break;
+		if (fs::remove(entry.path, error))
+		{
+			totalBytes -= entry.bytes;
+			++evicted;
+		}
+	}
+	Log(LogLevel::Info) << "<> Evicted " << evicted << " cache entries, " << totalBytes / (1024 * 1024) << " MB left under " << root;
+}
@@ -0,0 +1,75 @@
+#ifndef CK2_CACHE_STORE_H
+#define CK2_CACHE_STORE_H
+#include "SaveGame/MappedFile.h"
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace CK2
+{
+// What every cache under snapshots/ stands on: the save snapshots, the vanilla EU4 cache, and everything kept through
+// CompiledConfigurables (mapping files, traits, province history, dynasties, title colors). A cache picks the path
+// and the key, which names everything that decides what the entry holds (its own format version included), and
+// writes its bytes; the store takes care of the rest the same way for all of them:
+// - every entry is stamped with the converter build that wrote it, and no other build reads it back;
+// - entries are written aside and renamed into place, so readers only ever see whole ones and never lock;
+// - a checksum over the payload turns a damaged entry into a miss rather than garbage;
+// - with a size limit, the entries used least recently go once the store outgrows it.
+//
+// Caches built from the installs alone can also be shared through a farm's RemoteCache: a local miss asks it before
+// building, and a freshly written entry goes up to it. Entries come down as they went up and pass the same checks.
+class CacheStore
+{
+  public:
+	enum class SHARING
+	{
+		LOCAL, // this machine only, like anything built from a save
+		FARM	 // also through the remote cache, if there is one
+	};
+
+	// A hit: the payload, mapped read-only for as long as the entry lives.
+	class Entry
+	{
+	  public:
+		[[nodiscard]] const char* data() const { return file.data() + offset; }
+		[[nodiscard]] auto size() const { return length; }
+
+	  private:
+		friend class CacheStore;
+		MappedFile file;
+		std::size_t offset = 0;
+		std::size_t length = 0;
+	};
+
+	// The build every entry is stamped with, how large the store may grow before eviction (0 for no limit), the
+	// remote cache's URL, empty for none, and the key its entries are signed with. Throws if the URL is unusable or
+	// the key is missing or short.
+	static void configure(const std::string& build, std::size_t limitBytes, const std::string& remoteUrl = "", const std::string& remoteKey = "");
+
+	// 64-bit FNV-1a, in hex. For telling contents apart, not for resisting anyone.
+	[[nodiscard]] static std::string digest(std::string_view bytes);
+	// A path in the folder under the store named after the key's digest, for caches whose entries have no natural name.
+	[[nodiscard]] static std::string pathFor(const std::string& folder, const std::string& key);
+
+	// Nothing if there is no entry at the path for this build and key, or it's damaged. A hit counts as a use.
+	[[nodiscard]] static std::optional<Entry> load(const std::string& path, const std::string& key, SHARING sharing = SHARING::LOCAL);
+	// Throws if the entry can't be written, leaving whatever was at the path before. Failing to share it is only logged.
+	static void save(const std::string& path,
+		 const std::string& key,
+		 const std::function<void(std::ostream&)>& writePayload,
+		 SHARING sharing = SHARING::LOCAL);
+	// Removes the least recently used entries until the store fits its limit. Every save() ends with this.
+	static void evict();
+
+	static constexpr std::string_view root = "snapshots";
+
+  private:
+	[[nodiscard]] static std::optional<Entry> open(const std::string& path, const std::string& key);
+	static void writeAside(const std::string& path, const std::function<void(std::ostream&)>& writeFile);
+};
+} // namespace CK2
+
+#endif // CK2_CACHE_STORE_H
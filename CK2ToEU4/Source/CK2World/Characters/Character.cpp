@@ -1,124 +1,201 @@
 #include "Character.h"
+#include "../../Parsing/DateScan.h"
+#include "../../Parsing/KeywordTable.h"
 #include "../Dynasties/Dynasty.h"
-#include "CommonRegexes.h"
+#include "../MemoryCensus.h"
+#include "../SaveGame/SaveBuffer.h"
 #include "Domain.h"
 #include "Log.h"
 #include "ParserHelpers.h"
 
 CK2::Character::Character(std::istream& theStream, int chrID): charID(chrID)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Character::registerKeys()
+CK2::Character::Character(const std::string_view theEntry, int chrID, std::shared_ptr<const void> theSource): charID(chrID)
 {
-	registerRegex("bn|name", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString nameStr(theStream);
-		name = nameStr.getString();
+	static const auto keywordTable = [] {
+		parsing::KeywordTable<Character> linkageTable;
+		registerLinkageKeys(linkageTable);
+		linkageTable.ignoreUnregistered();
+		return linkageTable;
+	}();
+	SaveBuffer entryBuffer(theEntry.data(), theEntry.size());
+	std::istream entryStream(&entryBuffer);
+	keywordTable.parseStream(*this, entryStream);
+
+	pendingDetails = std::make_unique<PendingDetails>();
+	pendingDetails->source = std::move(theSource);
+	pendingDetails->entry = theEntry;
+}
+
+void CK2::Character::decodePendingDetails() const
+{
+	static const auto keywordTable = [] {
+		parsing::KeywordTable<Character> detailTable;
+		registerDetailKeys(detailTable);
+		detailTable.ignoreUnregistered();
+		return detailTable;
+	}();
+	SaveBuffer entryBuffer(pendingDetails->entry.data(), pendingDetails->entry.size());
+	std::istream entryStream(&entryBuffer);
+	keywordTable.parseStream(const_cast<Character&>(*this), entryStream);
+
+	// Once the last pending character of a save lets go, so does the block.
+	pendingDetails->source.reset();
+	pendingDetails->entry = std::string_view();
+}
+
+parsing::KeywordTable<CK2::Character> CK2::Character::registerKeys()
+{
+	parsing::KeywordTable<Character> keywordTable;
+	registerLinkageKeys(keywordTable);
+	registerDetailKeys(keywordTable);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
+}
+
+void CK2::Character::registerLinkageKeys(parsing::KeywordTable<Character>& keywordTable)
+{
+	keywordTable.registerKeyword("job", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString jobStr(theStream);
+		character.job = parsing::Symbol(jobStr.getString());
 	});
-	registerKeyword("cul", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString cultureStr(theStream);
-		culture = cultureStr.getString();
+	keywordTable.registerKeyword("tr", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::intList trList(theStream);
+		for (const auto trait: trList.getInts())
+			character.ownDetails().traits.insert(trait);
 	});
-	registerKeyword("rel", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString religionStr(theStream);
-		religion = religionStr.getString();
+	keywordTable.registerKeyword("dnt", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleInt dynastyInt(theStream);
+		character.dynasty = std::pair(dynastyInt.getInt(), nullptr);
 	});
-	registerKeyword("fem", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString femStr(theStream);
-		female = femStr.getString() == "yes";
+	keywordTable.registerKeyword("lge", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleInt liegeInt(theStream);
+		character.liege = std::pair(liegeInt.getInt(), nullptr);
 	});
-	registerKeyword("gov", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString govStr(theStream);
-		government = govStr.getString();
+	keywordTable.registerKeyword("mot", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleInt motInt(theStream);
+		character.mother = std::pair(motInt.getInt(), nullptr);
 	});
-	registerKeyword("job", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString jobStr(theStream);
-		job = jobStr.getString();
+	keywordTable.registerKeyword("fat", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleInt fatInt(theStream);
+		character.father = std::pair(fatInt.getInt(), nullptr);
 	});
-	registerKeyword("md", [this](const std::string& unused, std::istream& theStream) {
-		const auto modifierString = commonItems::stringOfItem(theStream).getString();
-		// We have no interest in parsing modifiers. We're looking for one explicit modifier.
-		loan = modifierString.find("borrowed_from_jews") != std::string::npos;
+	keywordTable.registerKeyword("host", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleInt hostInt(theStream);
+		character.host = hostInt.getInt();
 	});
-	registerKeyword("tr", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::intList trList(theStream);
-		for (const auto trait: trList.getInts())
-			traits.insert(std::pair(trait, std::string()));
+	keywordTable.registerKeyword("spouse", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleInt spouseInt(theStream);
+		character.spouses.insert(std::pair(spouseInt.getInt(), nullptr));
 	});
-	registerKeyword("b_d", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString dateStr(theStream);
-		birthDate = date(dateStr.getString());
+	keywordTable.registerKeyword("dmn", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const auto newDomain = Domain(theStream);
+		character.primaryTitle = newDomain.getPrimaryTitle();
+		character.capital = newDomain.getCapital();
 	});
-	registerKeyword("d_d", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("d_d", [](Character& character, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString dateStr(theStream);
-		deathDate = date(dateStr.getString());
+		character.deathDate = parsing::parseDate(dateStr.getString());
 	});
-	registerKeyword("dnt", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt dynastyInt(theStream);
-		dynasty = std::pair(dynastyInt.getInt(), nullptr);
+}
+
+void CK2::Character::registerDetailKeys(parsing::KeywordTable<Character>& keywordTable)
+{
+	const auto nameHandler = [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString nameStr(theStream);
+		character.ownDetails().name = nameStr.getString();
+	};
+	keywordTable.registerKeyword("bn", nameHandler);
+	keywordTable.registerKeyword("name", nameHandler);
+	keywordTable.registerKeyword("cul", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString cultureStr(theStream);
+		character.ownDetails().culture = parsing::Symbol(cultureStr.getString());
 	});
-	registerKeyword("lge", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt liegeInt(theStream);
-		liege = std::pair(liegeInt.getInt(), nullptr);
+	keywordTable.registerKeyword("rel", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString religionStr(theStream);
+		character.ownDetails().religion = parsing::Symbol(religionStr.getString());
 	});
-	registerKeyword("mot", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt motInt(theStream);
-		mother = std::pair(motInt.getInt(), nullptr);
+	keywordTable.registerKeyword("fem", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString femStr(theStream);
+		character.ownDetails().female = femStr.getString() == "yes";
 	});
-	registerKeyword("fat", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt fatInt(theStream);
-		father = std::pair(fatInt.getInt(), nullptr);
+	keywordTable.registerKeyword("gov", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString govStr(theStream);
+		character.ownDetails().government = parsing::Symbol(govStr.getString());
+	});
+	keywordTable.registerKeyword("md", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const auto modifierString = commonItems::stringOfItem(theStream).getString();
+		// We have no interest in parsing modifiers. We're looking for one explicit modifier.
+		character.ownDetails().loan = modifierString.find("borrowed_from_jews") != std::string::npos;
 	});
-	registerKeyword("piety", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("b_d", [](Character& character, const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString dateStr(theStream);
+		character.ownDetails().birthDate = parsing::parseDate(dateStr.getString());
+	});
+	keywordTable.registerKeyword("piety", [](Character& character, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleDouble pieryDbl(theStream);
-		piety = pieryDbl.getDouble();
+		character.ownDetails().piety = pieryDbl.getDouble();
 	});
-	registerKeyword("wealth", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("wealth", [](Character& character, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleDouble wealthDbl(theStream);
-		wealth = wealthDbl.getDouble();
+		character.ownDetails().wealth = wealthDbl.getDouble();
 	});
-	registerKeyword("prs", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("prs", [](Character& character, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleDouble prsDbl(theStream);
-		prestige = prsDbl.getDouble();
-	});
-	registerKeyword("host", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt hostInt(theStream);
-		host = hostInt.getInt();
+		character.ownDetails().prestige = prsDbl.getDouble();
 	});
-	registerKeyword("att", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("att", [](Character& character, const std::string& unused, std::istream& theStream) {
 		const commonItems::intList skillsList(theStream);
 		const auto theList = skillsList.getInts();
-		skills.diplomacy = theList[0];
-		skills.martial = theList[1];
-		skills.stewardship = theList[2];
-		skills.intrigue = theList[3];
-		skills.learning = theList[4];
+		character.ownDetails().skills.diplomacy = theList[0];
+		character.ownDetails().skills.martial = theList[1];
+		character.ownDetails().skills.stewardship = theList[2];
+		character.ownDetails().skills.intrigue = theList[3];
+		character.ownDetails().skills.learning = theList[4];
 	});
-	registerKeyword("spouse", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt spouseInt(theStream);
-		spouses.insert(std::pair(spouseInt.getInt(), nullptr));
-	});
-	registerKeyword("dmn", [this](const std::string& unused, std::istream& theStream) {
-		const auto newDomain = Domain(theStream);
-		primaryTitle = newDomain.getPrimaryTitle();
-		capital = newDomain.getCapital();
-	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
 bool CK2::Character::hasTrait(const std::string& wantedTrait) const
 {
-	for (const auto& trait: traits)
-		if (trait.second == wantedTrait)
-			return true;
-	return false;
+	return heldDetails().traits.contains(std::string_view(wantedTrait));
+}
+
+void CK2::Character::unlinkRelatives()
+{
+	liege.second.reset();
+	mother.second.reset();
+	father.second.reset();
+	heir.second.reset();
+	children.clear();
+	spouses.clear();
+	if (auto* held = details.load(std::memory_order_relaxed))
+		held->advisers.clear();
+}
+
+void CK2::Character::unlink()
+{
+	unlinkRelatives();
+	dynasty.second.reset();
+	primaryTitle.second.reset();
+	changedPrimaryTitle.reset();
+	capital.second.reset();
+	capitalProvince.second.reset();
+}
+
+bool CK2::Character::isAlive() const
+{
+	// The save leaves d_d out for the living, so they keep the default.
+	static const date unset(1, 1, 1);
+	return getDeathDate() == unset;
 }
 
-const std::string& CK2::Character::getReligion() const
+const parsing::Symbol& CK2::Character::getReligion() const
 {
+	const auto& religion = decodeDetails().religion;
 	// The CK2 save omits the character religion in the case where the character religion matches the dynasty religion.
 	if (religion.empty() && dynasty.second)
 	{
@@ -130,11 +207,22 @@ const std::string& CK2::Character::getReligion() const
 	return religion;
 }
 
-const std::string& CK2::Character::getCulture() const
+const parsing::Symbol& CK2::Character::getCulture() const
 {
+	const auto& culture = decodeDetails().culture;
 	if (!culture.empty())
 		return culture;
 	if (dynasty.second && !dynasty.second->getCulture().empty())
 		return dynasty.second->getCulture();
 	return culture;
 }
+
+std::size_t CK2::Character::heapBytes() const
+{
+	const auto* held = details.load(std::memory_order_acquire);
+	const auto detailBytes = held ? sizeof(Details) + MemoryCensus::heapBytes(held->name) + MemoryCensus::heapBytes(held->courtierNames) +
+												  MemoryCensus::heapBytes(held->traits) + MemoryCensus::heapBytes(held->advisers)
+											  : 0;
+	return (pendingDetails ? sizeof(PendingDetails) : 0) + detailBytes + MemoryCensus::heapBytes(children) + MemoryCensus::heapBytes(spouses) +
+			 MemoryCensus::heapBytes(primaryTitle) + MemoryCensus::heapBytes(changedPrimaryTitle) + MemoryCensus::heapBytes(capital);
+}
@@ -1,9 +1,22 @@
 #ifndef CK2_CHARACTER_H
 #define CK2_CHARACTER_H
+#include "../../Parsing/Symbol.h"
 #include "../Provinces/Barony.h"
 #include "../Titles/Liege.h"
+#include "TraitSet.h"
 #include "Date.h"
-#include "Parser.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
 
 namespace CK2
 {
@@ -22,19 +35,27 @@ typedef struct Skills
 	int learning = 0;
 } Skills;
 
-class Character: commonItems::parser
+class Character
 {
   public:
+	Character() = default;
 	Character(std::istream& theStream, int chrID);
+	// Reads only what linking needs (family, liege, host, domain, job, death, traits) and keeps the rest of theEntry
+	// undecoded inside theSource until one of the detail getters asks for it. Most characters in a save are
+	// long dead and nobody ever does.
+	Character(std::string_view theEntry, int chrID, std::shared_ptr<const void> theSource);
+	~Character() { delete details.load(std::memory_order_relaxed); }
+	Character(const Character&) = delete;
+	Character& operator=(const Character&) = delete;
 
 	void setLiege(std::shared_ptr<Character> theLiege) { liege.second = std::move(theLiege); }
 
-	[[nodiscard]] const std::string& getCulture() const;
-	[[nodiscard]] const std::string& getReligion() const;
-	[[nodiscard]] const auto& getName() const { return name; }
-	[[nodiscard]] const auto& getBirthDate() const { return birthDate; }
+	[[nodiscard]] const parsing::Symbol& getCulture() const;
+	[[nodiscard]] const parsing::Symbol& getReligion() const;
+	[[nodiscard]] const auto& getName() const { return decodeDetails().name; }
+	[[nodiscard]] const auto& getBirthDate() const { return decodeDetails().birthDate; }
 	[[nodiscard]] const auto& getDeathDate() const { return deathDate; }
-	[[nodiscard]] const auto& getSkills() const { return skills; }
+	[[nodiscard]] const auto& getSkills() const { return decodeDetails().skills; }
 	[[nodiscard]] const auto& getSpouses() const { return spouses; }
 	[[nodiscard]] const auto& getChildren() const { return children; }
 	[[nodiscard]] const auto& getHeir() const { return heir; }
@@ -42,78 +63,146 @@ class Character: commonItems::parser
 	[[nodiscard]] const auto& getChangedPrimaryTitle() const { return changedPrimaryTitle; }
 	[[nodiscard]] const auto& getCapital() const { return capital; }
 	[[nodiscard]] const auto& getCapitalProvince() const { return capitalProvince; }
-	[[nodiscard]] const auto& getGovernment() const { return government; }
+	[[nodiscard]] const auto& getGovernment() const { return decodeDetails().government; }
 	[[nodiscard]] const auto& getLiege() const { return liege; }
 	[[nodiscard]] const auto& getMother() const { return mother; }
 	[[nodiscard]] const auto& getFather() const { return father; }
 	[[nodiscard]] const auto& getDynasty() const { return dynasty; }
-	[[nodiscard]] const auto& getCourtierNames() const { return courtierNames; }
-	[[nodiscard]] const auto& getTraits() const { return traits; }
+	[[nodiscard]] const auto& getCourtierNames() const { return heldDetails().courtierNames; }
+	[[nodiscard]] const auto& getTraits() const { return heldDetails().traits; }
 	[[nodiscard]] const auto& getJob() const { return job; }
-	[[nodiscard]] const auto& getAdvisers() const { return advisers; }
+	[[nodiscard]] const auto& getAdvisers() const { return heldDetails().advisers; }
 
-	[[nodiscard]] auto getPrestige() const { return prestige; }
-	[[nodiscard]] auto isFemale() const { return female; }
-	[[nodiscard]] auto getPiety() const { return piety; }
-	[[nodiscard]] auto getWealth() const { return wealth; }
-	[[nodiscard]] auto hasLoan() const { return loan; }
+	[[nodiscard]] auto getPrestige() const { return decodeDetails().prestige; }
+	[[nodiscard]] auto isFemale() const { return decodeDetails().female; }
+	[[nodiscard]] auto getPiety() const { return decodeDetails().piety; }
+	[[nodiscard]] auto getWealth() const { return decodeDetails().wealth; }
+	[[nodiscard]] auto hasLoan() const { return decodeDetails().loan; }
 	[[nodiscard]] auto getID() const { return charID; }
 	[[nodiscard]] auto getHost() const { return host; }
 	[[nodiscard]] auto isSpent() const { return spent; }
 
 	[[nodiscard]] bool hasTrait(const std::string& wantedTrait) const;
+	[[nodiscard]] bool isAlive() const;
 
 	void setDynasty(std::shared_ptr<Dynasty> theDynasty) { dynasty.second = std::move(theDynasty); }
-	void setCourtierNames(const std::map<std::string, bool>& theNames) { courtierNames = theNames; }
+	void setCourtierNames(std::vector<std::pair<parsing::Symbol, bool>> theNames) { ownDetails().courtierNames = std::move(theNames); }
 	void setSpouses(const std::map<int, std::shared_ptr<Character>>& newSpouses) { spouses = newSpouses; }
-	void setAdvisers(const std::map<int, std::shared_ptr<Character>>& newAdvisers) { advisers = newAdvisers; }
+	void setAdvisers(const std::map<int, std::shared_ptr<Character>>& newAdvisers) { ownDetails().advisers = newAdvisers; }
 	void setPrimaryTitle(std::shared_ptr<Title> theTitle) const { primaryTitle.second->setTitle(std::move(theTitle)); }
 	void setBaseTitle(std::shared_ptr<Title> theBaseTitle) const { primaryTitle.second->setBaseTitle(std::move(theBaseTitle)); }
 	void overridePrimaryTitle(const std::pair<std::string, std::shared_ptr<Title>>& theTitle) { changedPrimaryTitle = theTitle; }
 	void setCapitalBarony(std::shared_ptr<Barony> theCapitalBarony) { capital.second = std::move(theCapitalBarony); }
 	void insertCapitalProvince(const std::pair<int, std::shared_ptr<Province>>& theProvince) { capitalProvince = theProvince; }
-	void setTraits(const std::map<int, std::string>& theTraits) { traits = theTraits; }
+	void setTraits(const TraitSet& theTraits) { ownDetails().traits = theTraits; }
+	void nameTraits(const std::vector<std::string>& traitNames)
+	{
+		if (auto* held = details.load(std::memory_order_relaxed))
+			held->traits.name(traitNames);
+	}
 	void setMother(const std::pair<int, std::shared_ptr<Character>>& theMother) { mother = theMother; }
 	void setHeir(const std::pair<int, std::shared_ptr<Character>>& theHeir) { heir = theHeir; }
 	void setFather(const std::pair<int, std::shared_ptr<Character>>& theFather) { father = theFather; }
-	void registerChild(const std::pair<int, std::shared_ptr<Character>>& theChild) { children.insert(theChild); }
-	void addYears(const int years) { birthDate.subtractYears(years); }
+	void setChildren(std::vector<std::pair<int, std::shared_ptr<Character>>> theChildren) { children = std::move(theChildren); }
+	void addYears(const int years)
+	{
+		decode();
+		ownDetails().birthDate.subtractYears(years);
+	}
 	void setSpent() { spent = true; }
+	void unlinkRelatives(); // let go of every character we point at, IDs stay
+	void unlink();				// let go of every entity we point at, for the world to come apart
+	void decode() const { decodeDetails(); } // now rather than on first use
+	// For MemoryCensus. Leaves held-back details undecoded, and the block they point into is the save's.
+	[[nodiscard]] std::size_t heapBytes() const;
 
   private:
-	void registerKeys();
+	friend class ConversionMarks;
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Character> registerKeys();
+	static void registerLinkageKeys(parsing::KeywordTable<Character>& keywordTable);
+	static void registerDetailKeys(parsing::KeywordTable<Character>& keywordTable);
+
+	// Everything the linking passes and the sweeps over the whole table don't look at, kept in a record of its own so
+	// those sweeps only pull the links through the cache. Most of it arrives with the held-back part of the entry, and
+	// the record only once something is written to it; until then reads get one empty record shared by all.
+	struct Details
+	{
+		bool female = false;
+		bool loan = false; // borrowed_from_jews
+		double piety = 0;
+		double prestige = 0;
+		double wealth = 0;
+		parsing::Symbol culture;
+		parsing::Symbol religion;
+		std::string name;
+		parsing::Symbol government;
+		Skills skills;
+		date birthDate = date(1, 1, 1);
+		std::vector<std::pair<parsing::Symbol, bool>> courtierNames; // Names and genders, true=male, each name once in courtier ID order.
+		TraitSet traits;
+		std::map<int, std::shared_ptr<Character>> advisers;
+	};
+
+	// Decodes the held-back part of the entry on first use. Safe to call from several threads.
+	const Details& decodeDetails() const
+	{
+		if (pendingDetails)
+			std::call_once(pendingDetails->once, [this] { decodePendingDetails(); });
+		return heldDetails();
+	}
+	void decodePendingDetails() const;
+	// What we have so far, held-back details left undecoded.
+	[[nodiscard]] const Details& heldDetails() const
+	{
+		static const Details none;
+		const auto* held = details.load(std::memory_order_acquire);
+		return held ? *held : none;
+	}
+	// Two threads meeting here both end up with the one record that got published, the other's is dropped unwritten.
+	[[nodiscard]] Details& ownDetails()
+	{
+		auto* held = details.load(std::memory_order_acquire);
+		if (held)
+			return *held;
+		auto fresh = std::make_unique<Details>();
+		if (details.compare_exchange_strong(held, fresh.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+			return *fresh.release();
+		return *held;
+	}
+
+	struct PendingDetails
+	{
+		std::shared_ptr<const void> source; // whatever holds the character block the entry points into
+		std::string_view entry;
+		std::once_flag once;
+	};
+	std::unique_ptr<PendingDetails> pendingDetails;
+
+	// Ours, deleted with us. Set once: the linking passes read traits and advisers without decoding, from other threads
+	// than the one whose decode may be allocating the record, and find either nothing or all of it. From the heap, not
+	// the world's arena: it can be first written from any thread, in or out of the world's arena Scope, and most of
+	// what it holds lives in strings, vectors and maps on the heap all the same.
+	std::atomic<Details*> details = nullptr;
 
 	int charID = 0;
-	int host = 0; // a simple ID of the host Character, no link required.
-	bool female = false;
+	int host = 0;		 // a simple ID of the host Character, no link required.
 	bool spent = false; // if adviser, is already spent?
-	bool loan = false;  // borrowed_from_jews
-	double piety = 0;
-	double prestige = 0;
-	double wealth = 0;
-	std::string culture;
-	std::string religion;
-	std::string name;
-	std::string government;
-	std::string job;
-	Skills skills;
-	date birthDate = date("1.1.1");
-	date deathDate = date("1.1.1");
+	parsing::Symbol job;
+	date deathDate = date(1, 1, 1);
 
 	std::pair<int, std::shared_ptr<Dynasty>> dynasty;
 	std::pair<int, std::shared_ptr<Character>> liege;
 	std::pair<int, std::shared_ptr<Character>> mother;
 	std::pair<int, std::shared_ptr<Character>> father;
-	std::map<int, std::shared_ptr<Character>> children;
+	std::vector<std::pair<int, std::shared_ptr<Character>>> children; // by ID, so eldest first
 	std::pair<int, std::shared_ptr<Character>> heir;
 	std::map<int, std::shared_ptr<Character>> spouses;
 	std::pair<std::string, std::shared_ptr<Liege>> primaryTitle;
 	std::optional<std::pair<std::string, std::shared_ptr<Title>>> changedPrimaryTitle;
 	std::pair<std::string, std::shared_ptr<Barony>> capital;
 	std::pair<int, std::shared_ptr<Province>> capitalProvince;
-	std::map<std::string, bool> courtierNames; // A simple list of people's names and genders. True=male.
-	std::map<int, std::string> traits;
-	std::map<int, std::shared_ptr<Character>> advisers;
 };
 } // namespace CK2
 
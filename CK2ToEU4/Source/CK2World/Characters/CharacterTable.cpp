@@ -0,0 +1,101 @@
+#include "CharacterTable.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+// How far the index may reach for a table this size. Generous enough for any vanilla save, small enough that
+// one stray ID in the billions doesn't cost us gigabytes.
+std::size_t indexLimit(const std::size_t entryCount)
+{
+	return 4 * entryCount + 1024 * 1024;
+}
+
+bool lessByID(const CK2::CharacterTable::value_type& entry, const int ID)
+{
+	return entry.first < ID;
+}
+} // namespace
+
+CK2::CharacterTable::CharacterTable(std::vector<value_type> theEntries): entries(std::move(theEntries))
+{
+	std::stable_sort(entries.begin(), entries.end(), [](const value_type& lhs, const value_type& rhs) {
+		return lhs.first < rhs.first;
+	});
+	entries.erase(std::unique(entries.begin(),
+						  entries.end(),
+						  [](const value_type& lhs, const value_type& rhs) {
+							  return lhs.first == rhs.first;
+						  }),
+		 entries.end());
+	reindex();
+}
+
+bool CK2::CharacterTable::insert(value_type entry)
+{
+	// Saves list characters in ID order, so this is nearly always an append.
+	if (entries.empty() || entry.first > entries.back().first)
+	{
+		entries.emplace_back(std::move(entry));
+		extendIndex(entries.back().first);
+		return true;
+	}
+
+	const auto position = std::lower_bound(entries.begin(), entries.end(), entry.first, lessByID);
+	if (position != entries.end() && position->first == entry.first)
+		return false;
+	entries.insert(position, std::move(entry));
+	reindex();
+	return true;
+}
+
+CK2::CharacterTable::const_iterator CK2::CharacterTable::find(const int ID) const
+{
+	if (ID >= 0 && static_cast<std::size_t>(ID) < positions.size())
+	{
+		const auto position = positions[ID];
+		return position ? entries.begin() + (position - 1) : entries.end();
+	}
+
+	const auto position = std::lower_bound(entries.begin(), entries.end(), ID, lessByID);
+	if (position != entries.end() && position->first == ID)
+		return position;
+	return entries.end();
+}
+
+const std::shared_ptr<CK2::Character>& CK2::CharacterTable::at(const int ID) const
+{
+	const auto position = find(ID);
+	if (position == entries.end())
+		throw std::out_of_range("No character with ID " + std::to_string(ID));
+	return position->second;
+}
+
+void CK2::CharacterTable::reindex()
+{
+	positions.clear();
+	if (!entries.empty())
+		extendIndex(entries.back().first);
+}
+
+void CK2::CharacterTable::extendIndex(const int ID)
+{
+	// ID is the largest we hold and everything below the current index size is indexed already.
+	if (ID < 0)
+		return;
+	const auto target = std::min(static_cast<std::size_t>(ID) + 1, indexLimit(entries.size()));
+	if (target <= positions.size())
+		return;
+
+	const auto oldSize = positions.size();
+	positions.resize(target, 0);
+	for (auto position = entries.size(); position > 0; --position)
+	{
+		const auto entryID = entries[position - 1].first;
+		if (entryID < 0 || static_cast<std::size_t>(entryID) < oldSize)
+			break;
+		if (static_cast<std::size_t>(entryID) < target)
+			positions[entryID] = static_cast<std::uint32_t>(position);
+	}
+}
@@ -1,224 +1,369 @@
 #include "Characters.h"
 #include "../../Mappers/PersonalityScraper/PersonalityScraper.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../Concurrency.h"
 #include "../Dynasties/Dynasties.h"
+#include "../EntityArena.h"
 #include "../Provinces/Province.h"
 #include "../Provinces/Provinces.h"
+#include "../SaveGame/BlockLoader.h"
+#include "../SaveGame/SpillFile.h"
+#include "../SliceLog.h"
+#include "../TaskGraph.h"
 #include "../Titles/Title.h"
 #include "../Titles/Titles.h"
 #include "Character.h"
-#include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <ranges>
 
 CK2::Characters::Characters(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Characters::registerKeys()
+CK2::Characters::Characters(const std::string_view theBlock, const std::size_t shardCount, const DETAILS details)
 {
-	registerRegex("\\d+", [this](const std::string& charID, std::istream& theStream) {
-		auto newCharacter = std::make_shared<Character>(theStream, std::stoi(charID));
-		characters.insert(std::pair(newCharacter->getID(), newCharacter));
-	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
-}
-
-void CK2::Characters::linkDynasties(const Dynasties& theDynasties)
-{
-	auto counter = 0;
-	const auto& dynasties = theDynasties.getDynasties();
-	for (const auto& character: characters)
+	// Every character is self-contained and IDs are unique, so shards parse independently and merge without conflicts.
+	// Don't bother spinning up threads for slivers, small saves parse just fine in one or two shards.
+	constexpr std::size_t minimumShardSize = 1024 * 1024;
+	// Characters keep pointing into the block for their undecoded details, so it gets a copy of its own.
+	std::shared_ptr<const void> source;
+	std::string_view block;
+	if (details == DETAILS::SPILLED)
 	{
-		if (character.second->getDynasty().first)
-		{
-			const auto& dynastyItr = dynasties.find(character.second->getDynasty().first);
-			if (dynastyItr != dynasties.end())
-			{
-				character.second->setDynasty(dynastyItr->second);
-				counter++;
-			}
-			else
+		const auto spill = std::make_shared<const SpillFile>(theBlock);
+		block = spill->view();
+		source = spill;
+	}
+	else
+	{
+		const auto copy = std::make_shared<const std::string>(theBlock);
+		block = *copy;
+		source = copy;
+		heldBlock = copy;
+		heldBlockBytes = copy->capacity();
+	}
+	const auto eagerDetails = details == DETAILS::EAGER;
+	const auto shards = BlockLoader::splitEntries(block, std::min(shardCount, block.size() / minimumShardSize + 1));
+	std::vector<std::future<std::vector<CharacterTable::value_type>>> shardParsers;
+	for (const auto& shard: shards)
+		shardParsers.emplace_back(std::async(Concurrency::launchPolicy(), Concurrency::carry([shard, source, eagerDetails] {
+			static const auto characterID = parsing::TokenMatcher::digits();
+			std::vector<CharacterTable::value_type> shardCharacters;
+			for (const auto& [key, item]: BlockLoader::entriesOf(shard))
 			{
-				Log(LogLevel::Warning) << "Dynasty ID: " << character.second->getDynasty().first << " has no definition!";
+				const auto charID = std::string(key);
+				if (!characterID.matches(charID))
+					continue;
+				auto newCharacter = makeEntity<Character>(item, std::stoi(charID), source);
+				if (eagerDetails)
+					newCharacter->decode();
+				shardCharacters.emplace_back(newCharacter->getID(), newCharacter);
 			}
+			return shardCharacters;
+		})));
+
+	std::vector<CharacterTable::value_type> parsedCharacters;
+	std::exception_ptr error;
+	for (auto& shardParser: shardParsers)
+	{
+		try
+		{
+			auto shardCharacters = shardParser.get();
+			parsedCharacters.insert(parsedCharacters.end(), std::make_move_iterator(shardCharacters.begin()), std::make_move_iterator(shardCharacters.end()));
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
 		}
 	}
-	Log(LogLevel::Info) << "<> " << counter << " dynasties linked.";
+	if (error)
+		std::rethrow_exception(error);
+	characters = CharacterTable(std::move(parsedCharacters));
 }
 
-void CK2::Characters::linkLiegesAndSpouses()
+parsing::KeywordTable<CK2::Characters> CK2::Characters::registerKeys()
 {
-	auto counterLiege = 0;
-	auto counterSpouse = 0;
-	for (const auto& character: characters)
-	{
-		if (character.second->getLiege().first)
+	parsing::KeywordTable<Characters> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Characters& theCharacters, const std::string& charID, std::istream& theStream) {
+		auto newCharacter = makeEntity<Character>(theStream, std::stoi(charID));
+		theCharacters.characters.insert(std::pair(newCharacter->getID(), newCharacter));
+	});
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
+}
+
+void CK2::Characters::linkDynasties(const Dynasties& theDynasties)
+{
+	std::atomic<int> counter = 0;
+	SliceLog warnings(LogLevel::Warning);
+	forEachSlice(characters.size(), [this, &warnings, &theDynasties, &counter](const std::size_t first, const std::size_t last) {
+		auto sliceWarnings = warnings.slice(first);
+		for (const auto& character: std::ranges::subrange(characters.begin() + first, characters.begin() + last))
 		{
-			const auto& characterItr = characters.find(character.second->getLiege().first);
-			if (characterItr != characters.end())
-			{
-				character.second->setLiege(characterItr->second);
-				counterLiege++;
-			}
-			else
+			if (character.second->getDynasty().first)
 			{
-				Log(LogLevel::Warning) << "Liege ID: " << character.second->getLiege().first << " has no definition!";
+				if (const auto& dynasty = theDynasties.find(character.second->getDynasty().first))
+				{
+					character.second->setDynasty(dynasty);
+					counter++;
+				}
+				else
+				{
+					sliceWarnings.line("Dynasty ID") << "Dynasty ID: " << character.second->getDynasty().first << " has no definition!";
+				}
 			}
 		}
+	});
+	warnings.flush();
+	Log(LogLevel::Info) << "<> " << counter.load() << " dynasties linked.";
+}
 
-		if (!character.second->getSpouses().empty())
+void CK2::Characters::linkLiegesAndSpouses()
+{
+	std::atomic<int> counterLiege = 0;
+	std::atomic<int> counterSpouse = 0;
+	SliceLog warnings(LogLevel::Warning);
+	forEachSlice(characters.size(), [this, &warnings, &counterLiege, &counterSpouse](const std::size_t first, const std::size_t last) {
+		auto sliceWarnings = warnings.slice(first);
+		for (const auto& character: std::ranges::subrange(characters.begin() + first, characters.begin() + last))
 		{
-			std::map<int, std::shared_ptr<Character>> newSpouses;
-			for (const auto& spouse: character.second->getSpouses())
+			if (character.second->getLiege().first)
 			{
-				const auto& characterItr = characters.find(spouse.first);
+				const auto& characterItr = characters.find(character.second->getLiege().first);
 				if (characterItr != characters.end())
 				{
-					newSpouses.insert(std::pair(characterItr->first, characterItr->second));
-					counterSpouse++;
+					character.second->setLiege(characterItr->second);
+					counterLiege++;
 				}
 				else
 				{
-					Log(LogLevel::Warning) << "Spouse ID: " << spouse.first << " has no definition!";
+					sliceWarnings.line("Liege ID") << "Liege ID: " << character.second->getLiege().first << " has no definition!";
 				}
 			}
-			character.second->setSpouses(newSpouses);
+
+			if (!character.second->getSpouses().empty())
+			{
+				std::map<int, std::shared_ptr<Character>> newSpouses;
+				for (const auto& spouse: character.second->getSpouses())
+				{
+					const auto& characterItr = characters.find(spouse.first);
+					if (characterItr != characters.end())
+					{
+						newSpouses.insert(std::pair(characterItr->first, characterItr->second));
+						counterSpouse++;
+					}
+					else
+					{
+						sliceWarnings.line("Spouse ID") << "Spouse ID: " << spouse.first << " has no definition!";
+					}
+				}
+				character.second->setSpouses(newSpouses);
+			}
 		}
-	}
-	Log(LogLevel::Info) << "<> " << counterLiege << " lieges and " << counterSpouse << " spouses linked.";
+	});
+	warnings.flush();
+	Log(LogLevel::Info) << "<> " << counterLiege.load() << " lieges and " << counterSpouse.load() << " spouses linked.";
 }
 
 
 void CK2::Characters::linkMothersAndFathers()
 {
-	auto counterMother = 0;
-	auto counterFather = 0;
-	for (const auto& character: characters)
+	// Parents only learn about their children once everyone's parents are known: the slices below touch nothing but
+	// their own characters and hand back (parent, child) pairs, which are then grouped by parent in a single pass.
+	struct Parenthood
 	{
-		if (character.second->getMother().first)
+		std::shared_ptr<Character> parent;
+		CharacterTable::value_type child;
+	};
+	std::atomic<int> counterMother = 0;
+	std::atomic<int> counterFather = 0;
+	std::vector<Parenthood> parenthoods;
+	std::mutex parenthoodsMutex;
+	SliceLog warnings(LogLevel::Warning);
+	forEachSlice(characters.size(), [this, &warnings, &counterMother, &counterFather, &parenthoods, &parenthoodsMutex](const std::size_t first, const std::size_t last) {
+		auto sliceWarnings = warnings.slice(first);
+		std::vector<Parenthood> sliceParenthoods;
+		for (const auto& character: std::ranges::subrange(characters.begin() + first, characters.begin() + last))
 		{
-			const auto& characterItr = characters.find(character.second->getMother().first);
-			if (characterItr != characters.end())
-			{
-				character.second->setMother(std::pair(characterItr->first, characterItr->second));
-				characterItr->second->registerChild(character);
-				counterMother++;
-			}
-			else
+			if (character.second->getMother().first)
 			{
-				Log(LogLevel::Warning) << "Mother ID: " << character.second->getMother().first << " has no definition!";
+				const auto& characterItr = characters.find(character.second->getMother().first);
+				if (characterItr != characters.end())
+				{
+					character.second->setMother(std::pair(characterItr->first, characterItr->second));
+					sliceParenthoods.emplace_back(Parenthood{characterItr->second, character});
+					counterMother++;
+				}
+				else
+				{
+					sliceWarnings.line("Mother ID") << "Mother ID: " << character.second->getMother().first << " has no definition!";
+				}
 			}
-		}
 
-		if (character.second->getFather().first)
-		{
-			const auto& characterItr = characters.find(character.second->getFather().first);
-			if (characterItr != characters.end())
-			{
-				character.second->setFather(std::pair(characterItr->first, characterItr->second));
-				counterFather++;
-				characterItr->second->registerChild(character);
-			}
-			else
+			if (character.second->getFather().first)
 			{
-				Log(LogLevel::Warning) << "Father ID: " << character.second->getFather().first << " has no definition!";
+				const auto& characterItr = characters.find(character.second->getFather().first);
+				if (characterItr != characters.end())
+				{
+					character.second->setFather(std::pair(characterItr->first, characterItr->second));
+					counterFather++;
+					sliceParenthoods.emplace_back(Parenthood{characterItr->second, character});
+				}
+				else
+				{
+					sliceWarnings.line("Father ID") << "Father ID: " << character.second->getFather().first << " has no definition!";
+				}
 			}
 		}
+		const std::lock_guard lock(parenthoodsMutex);
+		parenthoods.insert(parenthoods.end(), std::make_move_iterator(sliceParenthoods.begin()), std::make_move_iterator(sliceParenthoods.end()));
+	});
+
+	std::sort(parenthoods.begin(), parenthoods.end(), [](const Parenthood& lhs, const Parenthood& rhs) {
+		if (lhs.parent->getID() != rhs.parent->getID())
+			return lhs.parent->getID() < rhs.parent->getID();
+		return lhs.child.first < rhs.child.first;
+	});
+	for (auto groupStart = parenthoods.begin(); groupStart != parenthoods.end();)
+	{
+		const auto& parent = groupStart->parent;
+		std::vector<CharacterTable::value_type> children;
+		auto groupEnd = groupStart;
+		for (; groupEnd != parenthoods.end() && groupEnd->parent == parent; ++groupEnd)
+			if (children.empty() || children.back().first != groupEnd->child.first) // someone listed as both mother and father
+				children.emplace_back(groupEnd->child);
+		parent->setChildren(std::move(children));
+		groupStart = groupEnd;
 	}
-	Log(LogLevel::Info) << "<> " << counterMother << " mothers and " << counterFather << " fathers linked.";
+	Log(LogLevel::Info) << "<> " << counterMother.load() << " mothers and " << counterFather.load() << " fathers linked.";
 }
 
 void CK2::Characters::linkPrimaryTitles(const Titles& theTitles)
 {
-	auto counterPrim = 0;
-	auto counterBase = 0;
+	std::atomic<int> counterPrim = 0;
+	std::atomic<int> counterBase = 0;
 	const auto& titles = theTitles.getTitles();
-	for (const auto& character: characters)
-	{
-		if (!character.second->getPrimaryTitle().first.empty())
+	SliceLog warnings(LogLevel::Warning);
+	forEachSlice(characters.size(), [this, &warnings, &titles, &counterPrim, &counterBase](const std::size_t first, const std::size_t last) {
+		auto sliceWarnings = warnings.slice(first);
+		for (const auto& character: std::ranges::subrange(characters.begin() + first, characters.begin() + last))
 		{
-			const auto& titleItr = titles.find(character.second->getPrimaryTitle().first);
-			if (titleItr != titles.end())
+			if (!character.second->getPrimaryTitle().first.empty())
 			{
-				character.second->setPrimaryTitle(titleItr->second);
-				counterPrim++;
-			}
-			else
-			{
-				Log(LogLevel::Warning) << "Primary title ID: " << character.second->getPrimaryTitle().first << " has no definition!";
-			}
-			if (!character.second->getPrimaryTitle().second->getBaseTitle().first.empty())
-			{
-				const auto& title2Itr = titles.find(character.second->getPrimaryTitle().second->getBaseTitle().first);
-				if (title2Itr != titles.end())
+				const auto& titleItr = titles.find(character.second->getPrimaryTitle().first);
+				if (titleItr != titles.end())
 				{
-					character.second->setBaseTitle(title2Itr->second);
-					counterBase++;
+					character.second->setPrimaryTitle(titleItr->second);
+					counterPrim++;
 				}
 				else
 				{
-					Log(LogLevel::Warning) << "Base title ID: " << character.second->getPrimaryTitle().second->getBaseTitle().first << " has no definition!";
+					sliceWarnings.line("Primary title ID") << "Primary title ID: " << character.second->getPrimaryTitle().first << " has no definition!";
+				}
+				if (!character.second->getPrimaryTitle().second->getBaseTitle().first.empty())
+				{
+					const auto& title2Itr = titles.find(character.second->getPrimaryTitle().second->getBaseTitle().first);
+					if (title2Itr != titles.end())
+					{
+						character.second->setBaseTitle(title2Itr->second);
+						counterBase++;
+					}
+					else
+					{
+						sliceWarnings.line("Base title ID") << "Base title ID: " << character.second->getPrimaryTitle().second->getBaseTitle().first << " has no definition!";
+					}
 				}
 			}
 		}
-	}
-	Log(LogLevel::Info) << "<> " << counterPrim << " primary titles and " << counterBase << " base titles linked.";
+	});
+	warnings.flush();
+	Log(LogLevel::Info) << "<> " << counterPrim.load() << " primary titles and " << counterBase.load() << " base titles linked.";
 }
 
 void CK2::Characters::linkCapitals(const Provinces& theProvinces)
 {
-	auto counterCapital = 0;
-	const auto& provinces = theProvinces.getProvinces();
+	std::atomic<int> counterCapital = 0;
+	SliceLog warnings(LogLevel::Warning);
+	forEachSlice(characters.size(), [this, &warnings, &theProvinces, &counterCapital](const std::size_t first, const std::size_t last) {
+		auto sliceWarnings = warnings.slice(first);
+		for (const auto& character: std::ranges::subrange(characters.begin() + first, characters.begin() + last))
+		{
+			if (!character.second->getCapital().first.empty())
+			{
+				if (const auto* location = theProvinces.findBarony(character.second->getCapital().first))
+				{
+					character.second->setCapitalBarony(location->barony);
+					character.second->insertCapitalProvince(std::pair(location->province->getID(), location->province));
+					counterCapital++;
+				}
+				else
+				{
+					sliceWarnings.line("Capital barony ID") << "Capital barony ID: " << character.second->getCapital().first << " has no definition!";
+				}
+			}
+		}
+	});
+	warnings.flush();
+	Log(LogLevel::Info) << "<> " << counterCapital.load() << " capital baronies linked.";
+}
 
-	// Extract all known baronies and linked provinces in a lookable place.
-	std::map<std::string, std::pair<std::shared_ptr<Barony>, std::pair<int, std::shared_ptr<Province>>>> baronyMap;
+void CK2::Characters::prune(const std::vector<bool>& kept)
+{
+	const auto isKept = [&kept](const int ID) {
+		return ID >= 0 && static_cast<std::size_t>(ID) < kept.size() && kept[ID];
+	};
 
-	for (const auto& province: provinces)
+	// Whoever is kept, and anyone they point at, stays alive past this, so their details are decoded while the block
+	// is still around. Pruned characters only point at others until they're unlinked below.
+	for (const auto& [ID, character]: characters)
 	{
-		const auto& baronies = province.second->getBaronies();
-		for (const auto& barony: baronies)
-		{
-			baronyMap.insert(std::pair(barony.first, std::pair(barony.second, std::pair(province.first, province.second))));
-		}
+		if (!isKept(ID))
+			continue;
+		character->decode();
+		const auto decode = [](const std::shared_ptr<Character>& relative) {
+			if (relative)
+				relative->decode();
+		};
+		decode(character->getLiege().second);
+		decode(character->getMother().second);
+		decode(character->getFather().second);
+		decode(character->getHeir().second);
+		for (const auto& child: character->getChildren())
+			decode(child.second);
+		for (const auto& spouse: character->getSpouses() | std::views::values)
+			decode(spouse);
+		for (const auto& adviser: character->getAdvisers() | std::views::values)
+			decode(adviser);
 	}
 
-	for (const auto& character: characters)
+	std::vector<CharacterTable::value_type> keptCharacters;
+	for (const auto& [ID, character]: characters)
 	{
-		if (!character.second->getCapital().first.empty())
-		{
-			const auto& baronyItr = baronyMap.find(character.second->getCapital().first);
-			if (baronyItr != baronyMap.end())
-			{
-				character.second->setCapitalBarony(baronyItr->second.first);
-				character.second->insertCapitalProvince(baronyItr->second.second);
-				counterCapital++;
-			}
-			else
-			{
-				Log(LogLevel::Warning) << "Capital barony ID: " << character.second->getCapital().first << " has no definition!";
-			}
-		}
+		if (isKept(ID))
+			keptCharacters.emplace_back(ID, character);
+		else
+			character->unlinkRelatives();
 	}
-	Log(LogLevel::Info) << "<> " << counterCapital << " capital baronies linked.";
+	characters = CharacterTable(std::move(keptCharacters));
 }
 
 void CK2::Characters::assignPersonalities(const mappers::PersonalityScraper& personalityScraper)
 {
 	auto counter = 0;
+	const auto& personalities = personalityScraper.getPersonalities();
 	for (const auto& character: characters)
 	{
-		std::map<int, std::string> translatedTraits;
-		for (const auto& trait: character.second->getTraits())
-		{
-			const auto& traitMatch = personalityScraper.getPersonalityForID(trait.first);
-			if (traitMatch)
-				translatedTraits.insert(std::pair(trait.first, *traitMatch));
-		}
-		counter += static_cast<int>(translatedTraits.size());
-		character.second->setTraits(translatedTraits);
+		character.second->nameTraits(personalities);
+		counter += static_cast<int>(character.second->getTraits().size());
 	}
 	Log(LogLevel::Info) << "<> " << counter << " personalities observed.";
 }
@@ -1,25 +1,47 @@
 #ifndef CK2_CHARACTERS_H
 #define CK2_CHARACTERS_H
+#include "CharacterTable.h"
 #include "Parser.h"
+#include <string_view>
 
 namespace mappers
 {
 class PersonalityScraper;
 }
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
 class Titles;
 class Dynasties;
 class Character;
 class Provinces;
-class Characters: commonItems::parser
+class Characters
 {
   public:
 	Characters() = default;
 	Characters(std::istream& theStream);
 
+	// What happens to the details (everything but the linkage) of characters parsed from a raw block. Lazy ones point
+	// into a copy of the block and decode on first use; spilled ones do the same, but the copy is kept in a mapped
+	// temp file (see SpillFile) so only the pages actually revisited stay resident. Eager ones decode while their
+	// shard parses and let the copy go straight after.
+	enum class DETAILS
+	{
+		LAZY,
+		EAGER,
+		SPILLED
+	};
+	// Splits theBlock at character boundaries and parses shards in parallel.
+	explicit Characters(std::string_view theBlock, std::size_t shardCount, DETAILS details = DETAILS::LAZY);
+
 	[[nodiscard]] const auto& getCharacters() const { return characters; }
+	// The in-memory copy of the block that undecoded details still point into, 0 once none do. Spilled copies live on disk.
+	[[nodiscard]] std::size_t getHeldBlockBytes() const { return heldBlock.expired() ? 0 : heldBlockBytes; }
 
 	void linkDynasties(const Dynasties& theDynasties);
 	void linkLiegesAndSpouses();
@@ -27,11 +49,19 @@ class Characters: commonItems::parser
 	void linkPrimaryTitles(const Titles& theTitles);
 	void linkCapitals(const Provinces& theProvinces);
 	void assignPersonalities(const mappers::PersonalityScraper& personalityScraper);
+	// Keeps only the characters whose IDs are flagged in kept. The rest let go of their relatives, so family cycles
+	// don't hold them up, and leave the table. Anyone still reachable gets their details decoded first, which lets
+	// the character block go once the last undecoded character does.
+	void prune(const std::vector<bool>& kept);
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Characters> registerKeys();
 
-	std::map<int, std::shared_ptr<Character>> characters;
+	CharacterTable characters;
+	std::weak_ptr<const void> heldBlock;
+	std::size_t heldBlockBytes = 0;
 };
 } // namespace CK2
 
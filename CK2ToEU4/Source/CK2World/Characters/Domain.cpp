@@ -1,4 +1,6 @@
 #include "Domain.h"
+#include "../../Parsing/ItemSkipper.h"
+#include "../EntityArena.h"
 #include "../Titles/Liege.h"
 #include "CommonRegexes.h"
 #include "Log.h"
@@ -22,14 +24,14 @@ void CK2::Domain::registerKeys()
 		std::stringstream tempStream(primTitleStr);
 		if (primTitleStr.find('{') != std::string::npos)
 		{
-			auto newPrimTitle = std::make_shared<Liege>(tempStream);
+			auto newPrimTitle = makeEntity<Liege>(tempStream);
 			primaryTitle = std::pair(newPrimTitle->getTitle().first, newPrimTitle);
 		}
 		else
 		{
-			auto newPrimTitle = std::make_shared<Liege>(commonItems::singleString(tempStream).getString());
+			auto newPrimTitle = makeEntity<Liege>(commonItems::singleString(tempStream).getString());
 			primaryTitle = std::pair(newPrimTitle->getTitle().first, newPrimTitle);
 		}
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
@@ -0,0 +1,65 @@
+#include "TraitSet.h"
+#include <algorithm>
+
+CK2::TraitSet::TraitSet(const std::initializer_list<int> traitIDs, const std::vector<std::string>& theNames)
+{
+	for (const auto traitID: traitIDs)
+		insert(traitID);
+	name(theNames);
+}
+
+void CK2::TraitSet::insert(const int traitID)
+{
+	if (traitID >= 0 && static_cast<std::size_t>(traitID) < width)
+	{
+		bits.set(static_cast<std::size_t>(traitID));
+		return;
+	}
+	const auto position = std::ranges::lower_bound(beyond, traitID);
+	if (position == beyond.end() || *position != traitID)
+		beyond.insert(position, traitID);
+}
+
+void CK2::TraitSet::name(const std::vector<std::string>& theNames)
+{
+	names = &theNames;
+	bits.reset(0);
+	for (auto traitID = theNames.size() + 1; traitID < width; ++traitID)
+		bits.reset(traitID);
+	std::erase_if(beyond, [&theNames](const int traitID) {
+		return traitID < 1 || static_cast<std::size_t>(traitID) > theNames.size();
+	});
+}
+
+bool CK2::TraitSet::contains(const int traitID) const
+{
+	if (traitID >= 0 && static_cast<std::size_t>(traitID) < width)
+		return bits.test(static_cast<std::size_t>(traitID));
+	return std::ranges::binary_search(beyond, traitID);
+}
+
+bool CK2::TraitSet::contains(const std::string_view traitName) const
+{
+	auto found = false;
+	forEachName([&found, traitName](const std::string_view name) {
+		found = found || name == traitName;
+	});
+	return found;
+}
+
+std::vector<int> CK2::TraitSet::getIDs() const
+{
+	std::vector<int> traitIDs;
+	traitIDs.reserve(size());
+	forEachID([&traitIDs](const int traitID) {
+		traitIDs.emplace_back(traitID);
+	});
+	return traitIDs;
+}
+
+std::string_view CK2::TraitSet::nameOf(const int traitID) const
+{
+	if (!names || traitID < 1 || static_cast<std::size_t>(traitID) > names->size() || !contains(traitID))
+		return {};
+	return (*names)[static_cast<std::size_t>(traitID) - 1];
+}
@@ -0,0 +1,68 @@
+#ifndef CK2_TRAIT_SET_H
+#define CK2_TRAIT_SET_H
+#include <bitset>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+// A character's traits, as the IDs the save lists them by. Vanilla and the usual mods stay well under width, and
+// those IDs are bits; anything past that goes into a sorted overflow. The names come from the install's trait index
+// once the set is named, and are only looked up when somebody asks for one.
+class TraitSet
+{
+  public:
+	static constexpr std::size_t width = 512;
+
+	TraitSet() = default;
+	TraitSet(std::initializer_list<int> traitIDs, const std::vector<std::string>& theNames);
+
+	void insert(int traitID);
+	// Hands over the trait names by ID - 1 and drops the IDs that have none, as the save may list traits a mod took away.
+	void name(const std::vector<std::string>& theNames);
+
+	[[nodiscard]] bool contains(int traitID) const;
+	[[nodiscard]] bool contains(std::string_view traitName) const;
+	[[nodiscard]] bool empty() const { return bits.none() && beyond.empty(); }
+	[[nodiscard]] std::size_t size() const { return bits.count() + beyond.size(); }
+	// In ascending order.
+	[[nodiscard]] std::vector<int> getIDs() const;
+	// Empty for an ID the set isn't named for.
+	[[nodiscard]] std::string_view nameOf(int traitID) const;
+
+	// Every trait, in ascending ID order.
+	template <typename Visit> void forEachID(Visit visit) const
+	{
+		for (const auto traitID: beyond)
+			if (traitID < 0)
+				visit(traitID);
+		for (std::size_t traitID = 0; traitID < width; ++traitID)
+			if (bits.test(traitID))
+				visit(static_cast<int>(traitID));
+		for (const auto traitID: beyond)
+			if (traitID >= 0)
+				visit(traitID);
+	}
+	// Every trait's name, in ascending ID order. Only named sets have any.
+	template <typename Visit> void forEachName(Visit visit) const
+	{
+		if (names)
+			forEachID([this, &visit](const int traitID) {
+				if (traitID >= 1 && static_cast<std::size_t>(traitID) <= names->size())
+					visit(std::string_view((*names)[static_cast<std::size_t>(traitID) - 1]));
+			});
+	}
+
+	[[nodiscard]] std::size_t heapBytes() const { return beyond.capacity() * sizeof(int); }
+
+  private:
+	std::bitset<width> bits;
+	std::vector<int> beyond;
+	const std::vector<std::string>* names = nullptr; // the world's trait index, which outlives every character
+};
+} // namespace CK2
+
+#endif // CK2_TRAIT_SET_H
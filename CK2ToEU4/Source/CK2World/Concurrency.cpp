@@ -0,0 +1,38 @@
+#include "Concurrency.h"
+#include <thread>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+std::atomic<std::size_t> CK2::Concurrency::configuredThreads = 0;
+std::atomic<std::uint32_t> CK2::Concurrency::seed = 0;
+std::atomic<std::uint32_t> CK2::Concurrency::shuffles = 0;
+thread_local std::size_t CK2::Concurrency::jobThreads = 0;
+
+void CK2::Concurrency::configure(const std::size_t threads, const std::uint32_t orderSeed)
+{
+	configuredThreads = orderSeed ? 1 : threads;
+	seed = orderSeed;
+	shuffles = 0;
+}
+
+void CK2::Concurrency::lowerPriority()
+{
+#ifdef _WIN32
+	// Background mode lowers disk and memory priority along with the CPU's.
+	SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_BEGIN);
+#else
+	setpriority(PRIO_PROCESS, 0, 19);
+#endif
+}
+
+std::size_t CK2::Concurrency::threads()
+{
+	std::size_t threads = configuredThreads.load(std::memory_order_relaxed);
+	if (!threads)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	return jobThreads ? std::min(threads, jobThreads) : threads;
+}
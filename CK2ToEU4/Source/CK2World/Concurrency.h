@@ -0,0 +1,75 @@
+#ifndef CK2_CONCURRENCY_H
+#define CK2_CONCURRENCY_H
+#include "EntityArena.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <vector>
+
+namespace CK2
+{
+// How much of a conversion runs side by side. Everything parallel gets a thread per core unless configured otherwise.
+// One thread runs the parallel steps one after another on the calling thread, and a nonzero order seed additionally
+// runs them in a seeded random order that still respects their dependencies, so output that depends on scheduling
+// shows up as a difference between runs.
+//
+// A job cap holds one conversion among several to fewer threads than that. It belongs to the thread that set it, and
+// reaches the threads that thread starts by way of carry(), as does the entity arena the thread is building into.
+class Concurrency
+{
+  public:
+	// threads = 0 is one per core. A seed implies one thread.
+	static void configure(std::size_t threads, std::uint32_t orderSeed);
+
+	// The configured count, or the calling thread's job cap if that's lower.
+	[[nodiscard]] static std::size_t threads();
+	[[nodiscard]] static bool serial() { return threads() == 1; }
+	[[nodiscard]] static std::uint32_t orderSeed() { return seed.load(std::memory_order_relaxed); }
+	// For std::async: deferred work runs on whoever get()s it.
+	[[nodiscard]] static std::launch launchPolicy() { return serial() ? std::launch::deferred : std::launch::async; }
+	// Puts the whole process, threads started later included, behind anything the user is doing: work nobody waits on.
+	static void lowerPriority();
+
+	// Leaves the items alone unless there's an order seed. Each call draws a fresh permutation.
+	template <typename Item> static void shuffle(std::vector<Item>& items)
+	{
+		if (!orderSeed())
+			return;
+		std::mt19937 generator(orderSeed() + shuffles.fetch_add(1, std::memory_order_relaxed));
+		std::shuffle(items.begin(), items.end(), generator);
+	}
+
+	// Caps threads() on the calling thread for as long as it lives. 0 lifts the cap.
+	class JobCap
+	{
+	  public:
+		explicit JobCap(const std::size_t threads): previous(jobThreads) { jobThreads = threads; }
+		~JobCap() { jobThreads = previous; }
+		JobCap(const JobCap&) = delete;
+		JobCap& operator=(const JobCap&) = delete;
+
+	  private:
+		std::size_t previous;
+	};
+	// The work, run under the calling thread's job cap and entity arena on whichever thread ends up running it.
+	template <typename Work> [[nodiscard]] static auto carry(Work work)
+	{
+		return [cap = jobThreads, arena = &EntityArena::current(), work = std::move(work)]() mutable {
+			const JobCap scope(cap);
+			const EntityArena::Scope entities(*arena);
+			return work();
+		};
+	}
+
+  private:
+	static std::atomic<std::size_t> configuredThreads;
+	static std::atomic<std::uint32_t> seed;
+	static std::atomic<std::uint32_t> shuffles;
+	static thread_local std::size_t jobThreads;
+};
+} // namespace CK2
+
+#endif // CK2_CONCURRENCY_H
@@ -0,0 +1,63 @@
+#include "Contention.h"
+#include "Trace.h"
+#include <mutex>
+
+std::atomic<bool> CK2::Contention::on = false;
+
+namespace
+{
+struct Sites
+{
+	std::mutex mutex;
+	std::vector<CK2::Contention::Site*> sites;
+};
+
+// Sites are defined at namespace scope all over, so the list has to exist before the first of them does.
+Sites& allSites()
+{
+	static Sites sites;
+	return sites;
+}
+} // namespace
+
+CK2::Contention::Site::Site(const std::string_view theName): name(theName), spanName("waiting at " + std::string(theName))
+{
+	auto& registry = allSites();
+	const std::lock_guard lock(registry.mutex);
+	registry.sites.emplace_back(this);
+}
+
+void CK2::Contention::Site::waited(const Clock::time_point start, const Clock::time_point end)
+{
+	waits.fetch_add(1, std::memory_order_relaxed);
+	nanoseconds.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()), std::memory_order_relaxed);
+	if (end - start >= std::chrono::milliseconds(1))
+		Trace::record(spanName, start, end);
+}
+
+void CK2::Contention::enable()
+{
+	on = true;
+}
+
+std::vector<CK2::Contention::Wait> CK2::Contention::totals()
+{
+	auto& registry = allSites();
+	const std::lock_guard lock(registry.mutex);
+	std::vector<Wait> totals;
+	for (const auto* site: registry.sites)
+		totals.emplace_back(Wait{site->name, site->waits.load(std::memory_order_relaxed), site->nanoseconds.load(std::memory_order_relaxed)});
+	return totals;
+}
+
+void CK2::Contention::reset()
+{
+	on = false;
+	auto& registry = allSites();
+	const std::lock_guard lock(registry.mutex);
+	for (auto* site: registry.sites)
+	{
+		site->waits = 0;
+		site->nanoseconds = 0;
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef CK2_CONTENTION_H
+#define CK2_CONTENTION_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+// How long a conversion's threads spend waiting on each other, per shared structure. Off unless enabled, and then a
+// free lock still costs only a try_lock; only a taken one is timed while it's waited for. PhaseTimings charges each
+// phase with the waits that fell into it, and the Trace shows every wait of a millisecond or more as a span.
+class Contention
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	// One per shared structure worth watching, defined next to it and living as long as the process.
+	class Site
+	{
+	  public:
+		explicit Site(std::string_view theName);
+		Site(const Site&) = delete;
+		Site& operator=(const Site&) = delete;
+
+		void waited(Clock::time_point start, Clock::time_point end);
+
+	  private:
+		friend class Contention;
+		std::string name;
+		std::string spanName; // on the Trace
+		std::atomic<std::uint64_t> waits = 0;
+		std::atomic<std::uint64_t> nanoseconds = 0;
+	};
+	struct Wait
+	{
+		std::string site;
+		std::uint64_t waits = 0;
+		std::uint64_t nanoseconds = 0;
+	};
+
+	static void enable();
+	[[nodiscard]] static bool enabled() { return on.load(std::memory_order_relaxed); }
+	// Every site so far with what it waited since the process started, in the order the sites were defined.
+	[[nodiscard]] static std::vector<Wait> totals();
+	// Zeroes every site and turns counting back off.
+	static void reset();
+
+  private:
+	static std::atomic<bool> on;
+};
+
+// Takes mutex as a Lock (std::unique_lock, std::shared_lock, ...), timing the wait at site if it was held.
+template <typename Lock> [[nodiscard]] Lock lockAt(Contention::Site& site, typename Lock::mutex_type& mutex)
+{
+	if (!Contention::enabled())
+		return Lock(mutex);
+	Lock lock(mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+	{
+		const auto start = Contention::Clock::now();
+		lock.lock();
+		site.waited(start, Contention::Clock::now());
+	}
+	return lock;
+}
+} // namespace CK2
+
+#endif // CK2_CONTENTION_H
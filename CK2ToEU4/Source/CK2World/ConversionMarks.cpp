@@ -0,0 +1,46 @@
+#include "ConversionMarks.h"
+#include "Characters/Character.h"
+#include "Provinces/Province.h"
+#include "Titles/Title.h"
+#include "Wonders/Wonder.h"
+#include "World.h"
+#include <ranges>
+
+CK2::ConversionMarks::ConversionMarks(const World& world)
+{
+	for (const auto& title: world.titles.getTitles() | std::views::values)
+		if (title)
+			titles.emplace_back(TitleMarks{title, title->vassals, title->generatedVassals, title->generatedLiege});
+
+	// Advisers are the only characters the EU4 side spends; they're taken along with whoever they advise.
+	for (const auto& character: world.characters.getCharacters() | std::views::values)
+	{
+		if (!character)
+			continue;
+		characters.emplace_back(character, character->spent);
+		for (const auto& adviser: character->getAdvisers() | std::views::values)
+			if (adviser)
+				characters.emplace_back(adviser, adviser->spent);
+	}
+
+	for (const auto& province: world.getProvinces() | std::views::values)
+		for (const auto& wonder: {province->getWonder(), province->getMonument()})
+			if (wonder && wonder->second)
+				wonders.emplace_back(wonder->second, wonder->second->spent);
+}
+
+void CK2::ConversionMarks::restore() const
+{
+	for (const auto& [title, vassals, generatedVassals, generatedLiege]: titles)
+	{
+		title->vassals = vassals;
+		title->generatedVassals = generatedVassals;
+		title->generatedLiege = generatedLiege;
+		title->tagCountry = {};
+	}
+	Title::hierarchyChanged();
+	for (const auto& [character, spent]: characters)
+		character->spent = spent;
+	for (const auto& [wonder, spent]: wonders)
+		wonder->spent = spent;
+}
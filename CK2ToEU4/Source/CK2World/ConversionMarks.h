@@ -0,0 +1,46 @@
+#ifndef CK2_CONVERSION_MARKS_H
+#define CK2_CONVERSION_MARKS_H
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CK2
+{
+class Character;
+class Title;
+class Wonder;
+class World;
+
+// The few things the EU4 side writes back into a finished CK2 world while converting it: the tag each title went to,
+// vassals handed from title to title along with their countries, and advisers and wonders marked spent once placed.
+// Taken right after the world is built, they let a server hand the same world to another conversion (different
+// mappings, same save and CK2 settings) by putting those marks back as they were first.
+//
+// In memory and within one process only: they point into the live world, and nothing of them is written out. So the
+// reuse they allow ends with the batch or server holding the world. A rerun in a new process builds the world anew, or
+// resumes from its checkpoint (ck2_checkpoint), which is written before the EU4 side marks anything, and then takes
+// fresh marks of its own.
+class ConversionMarks
+{
+  public:
+	explicit ConversionMarks(const World& world);
+
+	void restore() const;
+
+  private:
+	struct TitleMarks
+	{
+		std::shared_ptr<Title> title;
+		std::map<std::string, std::shared_ptr<Title>> vassals;
+		std::map<std::string, std::shared_ptr<Title>> generatedVassals;
+		std::pair<std::string, std::shared_ptr<Title>> generatedLiege;
+	};
+	std::vector<TitleMarks> titles;
+	std::vector<std::pair<std::shared_ptr<Character>, bool>> characters; // spent or not
+	std::vector<std::pair<std::shared_ptr<Wonder>, bool>> wonders;
+};
+} // namespace CK2
+
+#endif // CK2_CONVERSION_MARKS_H
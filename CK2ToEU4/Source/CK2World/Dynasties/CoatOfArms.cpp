@@ -1,4 +1,5 @@
 #include "CoatOfArms.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
@@ -14,7 +15,19 @@ void CK2::CoatOfArms::registerKeys()
 {
 	registerKeyword("religion", [this](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString religionStr(theStream);
-		religion = religionStr.getString();
+		religion = parsing::Symbol(religionStr.getString());
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
+}
+
+void CK2::CoatOfArms::writeCompiled(mappers::CompiledConfigurables::Writer& writer) const
+{
+	writer.put(religion.str());
+}
+
+void CK2::CoatOfArms::readCompiled(mappers::CompiledConfigurables::Reader& reader)
+{
+	std::string religionName;
+	reader.get(religionName);
+	religion = parsing::Symbol(religionName);
 }
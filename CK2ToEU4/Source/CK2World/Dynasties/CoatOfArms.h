@@ -1,5 +1,7 @@
 #ifndef CK2_COAT_OF_ARMS_H
 #define CK2_COAT_OF_ARMS_H
+#include "../../Mappers/CompiledConfigurables/CompiledConfigurables.h"
+#include "../../Parsing/Symbol.h"
 #include "Parser.h"
 
 namespace CK2
@@ -12,10 +14,15 @@ class CoatOfArms: commonItems::parser
 
 	[[nodiscard]] const auto& getReligion() const { return religion; }
 
+	void writeCompiled(mappers::CompiledConfigurables::Writer& writer) const;
+	void readCompiled(mappers::CompiledConfigurables::Reader& reader);
+
   private:
+	friend class Snapshot;
+
 	void registerKeys();
 
-	std::string religion;
+	parsing::Symbol religion;
 };
 } // namespace CK2
 
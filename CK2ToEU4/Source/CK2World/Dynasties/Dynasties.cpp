@@ -1,65 +1,155 @@
 #include "Dynasties.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../Concurrency.h"
+#include "../EntityArena.h"
+#include "../ModFiles.h"
 #include "Dynasty.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <ranges>
+#include <sstream>
 
 CK2::Dynasties::Dynasties(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
 void CK2::Dynasties::loadDynasties(const std::string& thePath)
 {
-	registerKeys();
-	parseFile(thePath);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseFile(*this, thePath);
+}
+
+void CK2::Dynasties::loadDynasties(const std::vector<std::string>& paths)
+{
+	static const auto keywordTable = registerKeys();
+	std::vector<Dynasties> parsed(paths.size());
+	std::atomic<std::size_t> nextPath = 0;
+	std::vector<std::future<void>> readers;
+	const auto readerCount = std::min<std::size_t>(Concurrency::threads(), paths.size());
+	for (std::size_t reader = 0; reader < readerCount; ++reader)
+		readers.emplace_back(std::async(Concurrency::launchPolicy(), Concurrency::carry([&paths, &parsed, &nextPath] {
+			for (auto path = nextPath++; path < paths.size(); path = nextPath++)
+			{
+				// Mods may keep theirs in an archive.
+				const auto contents = readModFile(paths[path]);
+				if (!contents)
+				{
+					Log(LogLevel::Error) << "Could not open " << paths[path] << " for parsing.";
+					continue;
+				}
+				std::istringstream theStream(*contents);
+				commonItems::absorbBOM(theStream);
+				keywordTable.parseStream(parsed[path], theStream);
+			}
+		})));
+	for (auto& reader: readers)
+		reader.get();
+
+	for (auto& fileDynasties: parsed)
+		for (auto& [dynID, dynasty]: fileDynasties.dynasties)
+			if (const auto& existing = dynasties.find(dynID); existing != dynasties.end())
+				existing->second->overrideWith(*dynasty);
+			else
+				dynasties.emplace(dynID, std::move(dynasty));
 }
 
 void CK2::Dynasties::underLoadDynasties(const std::string& thePath)
 {
-	registerUnderKeys();
-	parseFile(thePath);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerUnderKeys();
+	keywordTable.parseFile(*this, thePath);
 }
 
 void CK2::Dynasties::loadDynasties(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
+}
+
+std::shared_ptr<CK2::Dynasty> CK2::Dynasties::find(const int dynID) const
+{
+	if (const auto& dynastyItr = dynasties.find(dynID); dynastyItr != dynasties.end())
+		return dynastyItr->second;
+	if (base)
+		return base->find(dynID);
+	return nullptr;
+}
+
+std::size_t CK2::Dynasties::size() const
+{
+	if (!base)
+		return dynasties.size();
+	return base->size() + std::ranges::count_if(dynasties | std::views::keys, [this](const int dynID) {
+		return !base->find(dynID);
+	});
+}
+
+std::shared_ptr<CK2::Dynasty> CK2::Dynasties::materialize(const int dynID)
+{
+	if (const auto& dynastyItr = dynasties.find(dynID); dynastyItr != dynasties.end())
+		return dynastyItr->second;
+	if (!base)
+		return nullptr;
+	const auto& baseDynasty = base->find(dynID);
+	if (!baseDynasty)
+		return nullptr;
+	return dynasties.emplace(dynID, makeEntity<Dynasty>(*baseDynasty)).first->second;
+}
+
+void CK2::Dynasties::writeCompiled(mappers::CompiledConfigurables::Writer& writer) const
+{
+	writer.put(static_cast<std::uint64_t>(dynasties.size()));
+	for (const auto& dynasty: dynasties | std::views::values)
+		writer.put(*dynasty);
+}
+
+void CK2::Dynasties::readCompiled(mappers::CompiledConfigurables::Reader& reader)
+{
+	dynasties.clear();
+	for (auto count = reader.getCount(); count > 0; --count)
+	{
+		auto dynasty = makeEntity<Dynasty>();
+		reader.get(*dynasty);
+		dynasties.emplace_hint(dynasties.end(), dynasty->getID(), dynasty);
+	}
 }
 
-void CK2::Dynasties::registerKeys()
+parsing::KeywordTable<CK2::Dynasties> CK2::Dynasties::registerKeys()
 {
-	registerRegex("\\d+", [this](const std::string& theDynID, std::istream& theStream) {
-		if (dynasties.count(std::stoi(theDynID)))
+	parsing::KeywordTable<Dynasties> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Dynasties& theDynasties, const std::string& theDynID, std::istream& theStream) {
+		if (const auto& dynasty = theDynasties.materialize(std::stoi(theDynID)))
 		{
-			dynasties[std::stoi(theDynID)]->updateDynasty(theStream);
+			dynasty->updateDynasty(theStream);
 		}
 		else
 		{
-			auto newDynasty = std::make_shared<Dynasty>(theStream, std::stoi(theDynID));
-			dynasties.insert(std::pair(newDynasty->getID(), newDynasty));
+			auto newDynasty = makeEntity<Dynasty>(theStream, std::stoi(theDynID));
+			theDynasties.dynasties.insert(std::pair(newDynasty->getID(), newDynasty));
 		}
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
-void CK2::Dynasties::registerUnderKeys()
+parsing::KeywordTable<CK2::Dynasties> CK2::Dynasties::registerUnderKeys()
 {
-	registerRegex("\\d+", [this](const std::string& theDynID, std::istream& theStream) {
-		if (dynasties.count(std::stoi(theDynID)))
+	parsing::KeywordTable<Dynasties> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Dynasties& theDynasties, const std::string& theDynID, std::istream& theStream) {
+		if (const auto& dynasty = theDynasties.materialize(std::stoi(theDynID)))
 		{
-			dynasties[std::stoi(theDynID)]->underUpdateDynasty(theStream);
+			dynasty->underUpdateDynasty(theStream);
 		}
 		else
 		{
-			auto newDynasty = std::make_shared<Dynasty>(theStream, std::stoi(theDynID));
-			dynasties.insert(std::pair(newDynasty->getID(), newDynasty));
+			auto newDynasty = makeEntity<Dynasty>(theStream, std::stoi(theDynID));
+			theDynasties.dynasties.insert(std::pair(newDynasty->getID(), newDynasty));
 		}
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
@@ -1,27 +1,51 @@
 #ifndef CK2_DYNASTIES_H
 #define CK2_DYNASTIES_H
+#include "../../Mappers/CompiledConfigurables/CompiledConfigurables.h"
 #include "Parser.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
 class Dynasty;
-class Dynasties: commonItems::parser
+class Dynasties
 {
   public:
 	Dynasties() = default;
 	explicit Dynasties(std::istream& theStream); // For testing
+	// Dynasties of their own over the base's, for a save to update. Only what the save touches is copied out of the
+	// base, every other lookup goes through to it.
+	explicit Dynasties(std::shared_ptr<const Dynasties> theBase): base(std::move(theBase)) {}
 
 	void loadDynasties(const std::string& thePath);
+	// Files are parsed side by side but merged in this order, so a later file still overrides what it redefines.
+	void loadDynasties(const std::vector<std::string>& paths);
 	void underLoadDynasties(const std::string& thePath);
 	void loadDynasties(std::istream& theStream);
 
+	// Only those defined or updated here, not the base's.
 	[[nodiscard]] const auto& getDynasties() const { return dynasties; }
+	[[nodiscard]] std::shared_ptr<Dynasty> find(int dynID) const;
+	// Base's included.
+	[[nodiscard]] std::size_t size() const;
+
+	void writeCompiled(mappers::CompiledConfigurables::Writer& writer) const;
+	void readCompiled(mappers::CompiledConfigurables::Reader& reader);
 
   private:
-	void registerKeys();
-	void registerUnderKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Dynasties> registerKeys();
+	static parsing::KeywordTable<Dynasties> registerUnderKeys();
+
+	// Our own entry for dynID, copied out of the base the first time it's asked for. Null if neither has one.
+	[[nodiscard]] std::shared_ptr<Dynasty> materialize(int dynID);
 
 	std::map<int, std::shared_ptr<Dynasty>> dynasties;
+	std::shared_ptr<const Dynasties> base;
 };
 } // namespace CK2
 
@@ -1,70 +1,89 @@
 #include "Dynasty.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../MemoryCensus.h"
 #include "Log.h"
 #include "ParserHelpers.h"
 
 CK2::Dynasty::Dynasty(std::istream& theStream, int theDynID): dynID(theDynID)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
 void CK2::Dynasty::updateDynasty(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
 void CK2::Dynasty::underUpdateDynasty(std::istream& theStream)
 {
-	registerUnderKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerUnderKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Dynasty::registerKeys()
+void CK2::Dynasty::overrideWith(const Dynasty& later)
 {
-	registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
+	if (later.definedFields & NAME)
+		name = later.name;
+	if (later.definedFields & CULTURE)
+		culture = later.culture;
+	if (later.definedFields & RELIGION)
+		religion = later.religion;
+	if (later.definedFields & COAT_OF_ARMS)
+		coa = later.coa;
+	definedFields |= later.definedFields;
+}
+
+parsing::KeywordTable<CK2::Dynasty> CK2::Dynasty::registerKeys()
+{
+	parsing::KeywordTable<Dynasty> keywordTable;
+	keywordTable.registerKeyword("name", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString nameStr(theStream);
-		name = nameStr.getString();
+		dynasty.name = nameStr.getString();
+		dynasty.definedFields |= NAME;
 	});
-	registerKeyword("culture", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("culture", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString cultureStr(theStream);
-		culture = cultureStr.getString();
+		dynasty.culture = parsing::Symbol(cultureStr.getString());
+		dynasty.definedFields |= CULTURE;
 	});
-	registerKeyword("religion", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("religion", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString religionStr(theStream);
-		religion = religionStr.getString();
+		dynasty.religion = parsing::Symbol(religionStr.getString());
+		dynasty.definedFields |= RELIGION;
 	});
-	registerKeyword("coat_of_arms", [this](const std::string& unused, std::istream& theStream) {
-		coa = CoatOfArms(theStream);
+	keywordTable.registerKeyword("coat_of_arms", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
+		dynasty.coa = CoatOfArms(theStream);
+		dynasty.definedFields |= COAT_OF_ARMS;
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
-void CK2::Dynasty::registerUnderKeys()
+parsing::KeywordTable<CK2::Dynasty> CK2::Dynasty::registerUnderKeys()
 {
-	registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
+	parsing::KeywordTable<Dynasty> keywordTable;
+	keywordTable.registerKeyword("name", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString nameStr(theStream);
-		if (name.empty())
-			name = nameStr.getString();
+		if (dynasty.name.empty())
+			dynasty.name = nameStr.getString();
 	});
-	registerKeyword("culture", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("culture", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString cultureStr(theStream);
-		if (culture.empty())
-			culture = cultureStr.getString();
+		if (dynasty.culture.empty())
+			dynasty.culture = parsing::Symbol(cultureStr.getString());
 	});
-	registerKeyword("religion", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("religion", [](Dynasty& dynasty, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString religionStr(theStream);
-		if (religion.empty())
-			religion = religionStr.getString();
+		if (dynasty.religion.empty())
+			dynasty.religion = parsing::Symbol(religionStr.getString());
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
-const std::string& CK2::Dynasty::getReligion() const
+const parsing::Symbol& CK2::Dynasty::getReligion() const
 {
 	// CK2 seems to prefer the dynasty religion in the coat_of_arms section. As such we only
 	// fall back to the nominal dynasty religion if there's no religion in the coat_of_arms section.
@@ -72,3 +91,30 @@ const std::string& CK2::Dynasty::getReligion() const
 		return coa.getReligion();
 	return religion;
 }
+
+void CK2::Dynasty::writeCompiled(mappers::CompiledConfigurables::Writer& writer) const
+{
+	writer.put(dynID);
+	writer.put(culture.str());
+	writer.put(religion.str());
+	writer.put(name);
+	writer.put(coa);
+}
+
+void CK2::Dynasty::readCompiled(mappers::CompiledConfigurables::Reader& reader)
+{
+	std::string cultureName;
+	std::string religionName;
+	reader.get(dynID);
+	reader.get(cultureName);
+	reader.get(religionName);
+	reader.get(name);
+	reader.get(coa);
+	culture = parsing::Symbol(cultureName);
+	religion = parsing::Symbol(religionName);
+}
+
+std::size_t CK2::Dynasty::heapBytes() const
+{
+	return MemoryCensus::heapBytes(name);
+}
@@ -1,11 +1,17 @@
 #ifndef CK2_DYNASTY_H
 #define CK2_DYNASTY_H
+#include "../../Parsing/Symbol.h"
 #include "CoatOfArms.h"
 #include "Parser.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
-class Dynasty: commonItems::parser
+class Dynasty
 {
   public:
 	Dynasty() = default;
@@ -13,22 +19,39 @@ class Dynasty: commonItems::parser
 
 	void updateDynasty(std::istream& theStream);
 	void underUpdateDynasty(std::istream& theStream);
+	// Takes whatever a later definition of the same dynasty set, as parsing that definition over this one would.
+	void overrideWith(const Dynasty& later);
 
 	[[nodiscard]] const auto& getCulture() const { return culture; }
-	[[nodiscard]] const std::string& getReligion() const;
+	[[nodiscard]] const parsing::Symbol& getReligion() const;
 	[[nodiscard]] const auto& getName() const { return name; }
 
 	[[nodiscard]] auto getID() const { return dynID; }
+	[[nodiscard]] std::size_t heapBytes() const; // for MemoryCensus
+
+	void writeCompiled(mappers::CompiledConfigurables::Writer& writer) const;
+	void readCompiled(mappers::CompiledConfigurables::Reader& reader);
 
   private:
-	void registerKeys();
-	void registerUnderKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Dynasty> registerKeys();
+	static parsing::KeywordTable<Dynasty> registerUnderKeys();
+
+	enum FIELD : std::uint8_t
+	{
+		NAME = 1,
+		CULTURE = 2,
+		RELIGION = 4,
+		COAT_OF_ARMS = 8
+	};
 
 	int dynID = 0;
-	std::string culture;
-	std::string religion;
+	parsing::Symbol culture;
+	parsing::Symbol religion;
 	std::string name;
 	CoatOfArms coa;
+	std::uint8_t definedFields = 0; // FIELDs the parsed definitions set, for overrideWith.
 };
 } // namespace CK2
 
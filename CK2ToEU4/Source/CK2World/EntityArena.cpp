@@ -0,0 +1,24 @@
+#include "EntityArena.h"
+#include "Contention.h"
+
+namespace
+{
+CK2::Contention::Site arenaWaits("entity arena");
+} // namespace
+
+thread_local CK2::EntityArena* CK2::EntityArena::active = nullptr;
+
+CK2::EntityArena& CK2::EntityArena::process()
+{
+	// Deliberately never destroyed. Entities still referenced from statics at exit must not find their memory gone
+	// from under them.
+	static auto* const arena = new EntityArena;
+	return *arena;
+}
+
+void* CK2::EntityArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+	const auto lock = lockAt<std::unique_lock<std::mutex>>(arenaWaits, mutex);
+	taken.fetch_add(bytes, std::memory_order_relaxed);
+	return blocks.allocate(bytes, alignment);
+}
@@ -0,0 +1,61 @@
+#ifndef CK2_ENTITY_ARENA_H
+#define CK2_ENTITY_ARENA_H
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+namespace CK2
+{
+// Backing store for the entities of one CK2 world, or of one load of install data. Whatever owns the arena builds its
+// entities once and reads them until it is done with them, so nothing is handed back one entity at a time:
+// allocation bumps a pointer through large blocks, deallocation does nothing, and the blocks all go back together
+// when the owner drops the arena. The owner has to let go of every entity first. Shared with the parsing threads,
+// hence the lock.
+//
+// Entities go to the arena of the Scope the building thread is in, which carry() takes along to the threads it
+// starts. Outside of any they go to the process arena, which lasts until exit.
+class EntityArena: public std::pmr::memory_resource
+{
+  public:
+	EntityArena() = default;
+	EntityArena(const EntityArena&) = delete;
+	EntityArena& operator=(const EntityArena&) = delete;
+
+	[[nodiscard]] static EntityArena& process();
+	[[nodiscard]] static EntityArena& current() { return active ? *active : process(); }
+	[[nodiscard]] std::size_t bytesTaken() const { return taken.load(std::memory_order_relaxed); }
+
+	// Points makeEntity at the arena on the calling thread for as long as it lives.
+	class Scope
+	{
+	  public:
+		explicit Scope(EntityArena& arena): previous(active) { active = &arena; }
+		~Scope() { active = previous; }
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	  private:
+		EntityArena* previous;
+	};
+
+  private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {}
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	static thread_local EntityArena* active;
+
+	std::mutex mutex;
+	std::pmr::monotonic_buffer_resource blocks{1024 * 1024};
+	std::atomic<std::size_t> taken = 0;
+};
+
+// make_shared for world entities: object and control block come out of the current arena in one piece.
+template <typename Entity, typename... Args> std::shared_ptr<Entity> makeEntity(Args&&... args)
+{
+	return std::allocate_shared<Entity>(std::pmr::polymorphic_allocator<Entity>(&EntityArena::current()), std::forward<Args>(args)...);
+}
+} // namespace CK2
+
+#endif // CK2_ENTITY_ARENA_H
@@ -1,23 +1,42 @@
 #include "Flags.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
 
-CK2::Flags::Flags(std::istream& theStream)
+CK2::Flags::Flags(std::istream& theStream, const parsing::NameFilter& interests)
 {
-	registerKeys();
+	registerKeys(interests);
 	parseStream(theStream);
 	clearRegisteredKeywords();
 }
 
-void CK2::Flags::registerKeys()
+void CK2::Flags::registerKeys(const parsing::NameFilter& interests)
 {
-	registerRegex(commonItems::catchallRegex, [this](const std::string& flagname, std::istream& theStream) {
-		flags.insert(flagname);
-		commonItems::ignoreItem(flagname, theStream);
+	registerRegex(commonItems::catchallRegex, [this, &interests](const std::string& flagname, std::istream& theStream) {
+		if (interests.admits(flagname))
+			flags.insert(flagname);
+		parsing::ignoreItem(flagname, theStream);
 	});
 }
 
+const parsing::NameFilter& CK2::Flags::queriedFlags()
+{
+	static const parsing::NameFilter queried{"aztec_explorers",
+		 "aztec_reformation",
+		 "baltic_reformation",
+		 "bon_reformation",
+		 "finnish_reformation",
+		 "hellenic_reformation",
+		 "norse_reformation",
+		 "slavic_reformation",
+		 "tengri_reformation",
+		 "west_african_reformation",
+		 "zun_reformation",
+		 "flag_hellenic_greek_reformation"};
+	return queried;
+}
+
 std::set<std::string> CK2::Flags::fillReformationList()
 {
 	std::set<std::string> reformationList;
@@ -1,5 +1,6 @@
 #ifndef CK2_FLAGS_H
 #define CK2_FLAGS_H
+#include "../../Parsing/NameFilter.h"
 #include "Parser.h"
 #include <set>
 
@@ -9,7 +10,10 @@ class Flags: commonItems::parser
 {
   public:
 	Flags() = default;
-	explicit Flags(std::istream& theStream);
+	explicit Flags(std::istream& theStream, const parsing::NameFilter& interests = {});
+
+	// Every flag the accessors below look at; the world keeps only these.
+	[[nodiscard]] static const parsing::NameFilter& queriedFlags();
 
 	[[nodiscard]] const auto& getFlags() const { return flags; }
 	[[nodiscard]] std::set<std::string> fillReformationList();
@@ -28,7 +32,9 @@ class Flags: commonItems::parser
 	[[nodiscard]] bool zunReformation() { return flags.count("zun_reformation"); }
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	void registerKeys(const parsing::NameFilter& interests);
 
 	bool wasGreek() { return flags.count("flag_hellenic_greek_reformation"); }
 
@@ -0,0 +1,85 @@
+#include "HardwareCounters.h"
+#include "Log.h"
+#ifdef __linux__
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace
+{
+struct Event
+{
+	const char* name;
+	std::uint32_t type;
+	std::uint64_t config;
+};
+constexpr std::array<Event, 5> events = {Event{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	 Event{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	 Event{"cacheMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	 Event{"branchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+	 Event{"pageFaults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}};
+
+int openCounter(const Event& event)
+{
+	perf_event_attr attributes{};
+	attributes.size = sizeof attributes;
+	attributes.type = event.type;
+	attributes.config = event.config;
+	attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	attributes.inherit = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+	// glibc has no wrapper. This thread, any CPU, no group.
+	return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+} // namespace
+#endif
+
+CK2::HardwareCounters::HardwareCounters()
+{
+#ifdef __linux__
+	std::string refused;
+	for (const auto& event: events)
+	{
+		if (const auto descriptor = openCounter(event); descriptor >= 0)
+			counters.emplace_back(Counter{event.name, descriptor});
+		else
+			refused += std::string(refused.empty() ? "" : ", ") + event.name + " (" + std::strerror(errno) + ")";
+	}
+	if (!refused.empty())
+		Log(LogLevel::Warning) << "Hardware counters not available: " << refused;
+#else
+	Log(LogLevel::Warning) << "Hardware counters are only collected on Linux.";
+#endif
+}
+
+CK2::HardwareCounters::~HardwareCounters()
+{
+#ifdef __linux__
+	for (const auto& counter: counters)
+		close(counter.descriptor);
+#endif
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> CK2::HardwareCounters::read() const
+{
+	std::vector<std::pair<std::string, std::uint64_t>> readings;
+#ifdef __linux__
+	for (const auto& counter: counters)
+	{
+		std::uint64_t values[3] = {}; // value, time enabled, time running
+		if (::read(counter.descriptor, values, sizeof values) != sizeof values)
+			continue;
+		auto value = values[0];
+		if (values[2] && values[2] < values[1])
+			value = static_cast<std::uint64_t>(static_cast<double>(value) * static_cast<double>(values[1]) / static_cast<double>(values[2]));
+		readings.emplace_back(counter.name, value);
+	}
+#endif
+	return readings;
+}
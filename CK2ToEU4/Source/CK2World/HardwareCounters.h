@@ -0,0 +1,40 @@
+#ifndef CK2_HARDWARE_COUNTERS_H
+#define CK2_HARDWARE_COUNTERS_H
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CK2
+{
+// The CPU's own event counters (instructions, cycles, cache and branch misses) plus page faults, for telling whether a
+// phase got faster by doing less or by missing the cache less. Linux only, through perf_event_open; elsewhere, or where
+// the kernel won't hand them out (perf_event_paranoid, most containers and VMs), there are simply none.
+//
+// The counters follow the thread that opens them and every thread it starts afterwards, so the work a phase fans out
+// counts as well once those threads have finished, which std::async's threads have by the time the phase ends. Only
+// user-space events are counted, which is all an unprivileged process may ask for.
+class HardwareCounters
+{
+  public:
+	// Opens whichever counters the kernel allows, logging the ones it refuses.
+	HardwareCounters();
+	~HardwareCounters();
+	HardwareCounters(const HardwareCounters&) = delete;
+	HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+	[[nodiscard]] bool empty() const { return counters.empty(); }
+	// Totals since opening, one per open counter in a fixed order, scaled up if the kernel had to time-share them.
+	[[nodiscard]] std::vector<std::pair<std::string, std::uint64_t>> read() const;
+
+  private:
+	struct Counter
+	{
+		std::string name;
+		int descriptor = -1;
+	};
+	std::vector<Counter> counters;
+};
+} // namespace CK2
+
+#endif // CK2_HARDWARE_COUNTERS_H
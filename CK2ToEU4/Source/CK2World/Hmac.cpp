@@ -0,0 +1,112 @@
+#include "Hmac.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+constexpr std::array<std::uint32_t, 64> roundConstants = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98,
+	 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+	 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+	 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa,
+	 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr std::uint32_t rotateRight(const std::uint32_t value, const int bits)
+{
+	return value >> bits | value << (32 - bits);
+}
+
+void compress(std::array<std::uint32_t, 8>& state, const std::uint8_t* block)
+{
+	std::array<std::uint32_t, 64> schedule{};
+	for (auto word = 0; word < 16; ++word)
+		schedule[word] = static_cast<std::uint32_t>(block[word * 4]) << 24 | static_cast<std::uint32_t>(block[word * 4 + 1]) << 16 |
+							  static_cast<std::uint32_t>(block[word * 4 + 2]) << 8 | static_cast<std::uint32_t>(block[word * 4 + 3]);
+	for (auto word = 16; word < 64; ++word)
+	{
+		const auto sigma0 = rotateRight(schedule[word - 15], 7) ^ rotateRight(schedule[word - 15], 18) ^ schedule[word - 15] >> 3;
+		const auto sigma1 = rotateRight(schedule[word - 2], 17) ^ rotateRight(schedule[word - 2], 19) ^ schedule[word - 2] >> 10;
+		schedule[word] = schedule[word - 16] + sigma0 + schedule[word - 7] + sigma1;
+	}
+
+	auto [a, b, c, d, e, f, g, h] = state;
+	for (auto round = 0; round < 64; ++round)
+	{
+		const auto temp1 = h + (rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25)) + ((e & f) ^ (~e & g)) + roundConstants[round] + schedule[round];
+		const auto temp2 = (rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + temp1;
+		d = c;
+		c = b;
+		b = a;
+		a = temp1 + temp2;
+	}
+	const std::array<std::uint32_t, 8> worked = {a, b, c, d, e, f, g, h};
+	for (auto word = 0; word < 8; ++word)
+		state[word] += worked[word];
+}
+} // namespace
+
+CK2::Sha256Digest CK2::sha256(const std::string_view bytes)
+{
+	std::array<std::uint32_t, 8> state = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+	const auto* data = reinterpret_cast<const std::uint8_t*>(bytes.data());
+	auto remaining = bytes.size();
+	for (; remaining >= 64; remaining -= 64, data += 64)
+		compress(state, data);
+
+	// The tail, a 1 bit, zeros and the length in bits, over one block or two.
+	std::array<std::uint8_t, 128> tail{};
+	std::copy(data, data + remaining, tail.begin());
+	tail[remaining] = 0x80;
+	const auto tailSize = remaining < 56 ? 64 : 128;
+	const auto bits = static_cast<std::uint64_t>(bytes.size()) * 8;
+	for (auto byte = 0; byte < 8; ++byte)
+		tail[tailSize - 1 - byte] = static_cast<std::uint8_t>(bits >> (byte * 8));
+	for (auto block = 0; block < tailSize; block += 64)
+		compress(state, tail.data() + block);
+
+	Sha256Digest digest{};
+	for (auto word = 0; word < 8; ++word)
+		for (auto byte = 0; byte < 4; ++byte)
+			digest[word * 4 + byte] = static_cast<std::uint8_t>(state[word] >> (24 - byte * 8));
+	return digest;
+}
+
+CK2::Sha256Digest CK2::hmacSha256(const std::string_view key, const std::string_view message)
+{
+	std::array<char, 64> block{};
+	if (key.size() > block.size())
+	{
+		const auto hashedKey = sha256(key);
+		std::copy(hashedKey.begin(), hashedKey.end(), block.begin());
+	}
+	else
+	{
+		std::copy(key.begin(), key.end(), block.begin());
+	}
+
+	std::string inner(block.size(), '\0');
+	std::string outer(block.size(), '\0');
+	for (std::size_t byte = 0; byte < block.size(); ++byte)
+	{
+		inner[byte] = static_cast<char>(block[byte] ^ 0x36);
+		outer[byte] = static_cast<char>(block[byte] ^ 0x5c);
+	}
+	inner.append(message);
+	const auto innerDigest = sha256(inner);
+	outer.append(reinterpret_cast<const char*>(innerDigest.data()), innerDigest.size());
+	return sha256(outer);
+}
+
+bool CK2::sameDigest(const Sha256Digest& one, const std::string_view other)
+{
+	if (other.size() != one.size())
+		return false;
+	std::uint8_t difference = 0;
+	for (std::size_t byte = 0; byte < one.size(); ++byte)
+		difference |= static_cast<std::uint8_t>(one[byte] ^ static_cast<std::uint8_t>(other[byte]));
+	return !difference;
+}
@@ -0,0 +1,18 @@
+#ifndef CK2_HMAC_H
+#define CK2_HMAC_H
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace CK2
+{
+// SHA-256 and HMAC-SHA256 (FIPS 180-4, RFC 2104), for signing what goes through the farm cache. Only ever run over
+// whole objects in memory, so there's no streaming interface.
+using Sha256Digest = std::array<std::uint8_t, 32>;
+[[nodiscard]] Sha256Digest sha256(std::string_view bytes);
+[[nodiscard]] Sha256Digest hmacSha256(std::string_view key, std::string_view message);
+// Compares without giving away through its timing how much of the two matched.
+[[nodiscard]] bool sameDigest(const Sha256Digest& one, std::string_view other);
+} // namespace CK2
+
+#endif // CK2_HMAC_H
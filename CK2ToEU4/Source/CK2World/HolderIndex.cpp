@@ -0,0 +1,55 @@
+#include "HolderIndex.h"
+#include "Characters/Character.h"
+#include "Characters/Characters.h"
+#include "Concurrency.h"
+#include "Titles/Title.h"
+#include "Titles/Titles.h"
+#include <future>
+
+namespace
+{
+template <typename Entries> const typename Entries::mapped_type& lookup(const Entries& entries, const int holderID)
+{
+	static const typename Entries::mapped_type nothing;
+	const auto& entryItr = entries.find(holderID);
+	if (entryItr == entries.end())
+		return nothing;
+	return entryItr->second;
+}
+} // namespace
+
+CK2::HolderIndex::HolderIndex(const Characters& theCharacters, const Titles& theTitles)
+{
+	auto titleSweep = std::async(Concurrency::launchPolicy(), Concurrency::carry([this, &theTitles] {
+		for (const auto& title: theTitles.getTitles())
+			if (title.second->getHolder().first)
+				titles[title.second->getHolder().first].insert(title);
+	}));
+
+	for (const auto& character: theCharacters.getCharacters())
+	{
+		const auto host = character.second->getHost();
+		if (!host)
+			continue;
+		courtiers[host].insert(character);
+		if (!character.second->getJob().empty())
+			advisers[host].insert(character);
+	}
+
+	titleSweep.get();
+}
+
+const std::map<int, std::shared_ptr<CK2::Character>>& CK2::HolderIndex::getCourtiers(const int holderID) const
+{
+	return lookup(courtiers, holderID);
+}
+
+const std::map<int, std::shared_ptr<CK2::Character>>& CK2::HolderIndex::getAdvisers(const int holderID) const
+{
+	return lookup(advisers, holderID);
+}
+
+const std::map<std::string, std::shared_ptr<CK2::Title>>& CK2::HolderIndex::getTitles(const int holderID) const
+{
+	return lookup(titles, holderID);
+}
@@ -0,0 +1,37 @@
+#ifndef CK2_HOLDER_INDEX_H
+#define CK2_HOLDER_INDEX_H
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace CK2
+{
+class Character;
+class Characters;
+class Title;
+class Titles;
+
+// Who sits at whose court and who holds what, keyed by the holder's character ID. Characters only know their host
+// and titles only know their holder, so every step asking the reverse question used to sweep all characters or all
+// titles for its own map. This is built once, when holders stop changing, and shared by those steps. Parents need
+// no entry here, linkMothersAndFathers already hands every character its children.
+class HolderIndex
+{
+  public:
+	HolderIndex() = default;
+	HolderIndex(const Characters& theCharacters, const Titles& theTitles); // the character and title sweeps run side by side
+
+	// All lookups return an empty map for IDs that host or hold nothing.
+	[[nodiscard]] const std::map<int, std::shared_ptr<Character>>& getCourtiers(int holderID) const;
+	[[nodiscard]] const std::map<int, std::shared_ptr<Character>>& getAdvisers(int holderID) const;
+	[[nodiscard]] const std::map<std::string, std::shared_ptr<Title>>& getTitles(int holderID) const;
+
+  private:
+	std::unordered_map<int, std::map<int, std::shared_ptr<Character>>> courtiers;
+	std::unordered_map<int, std::map<int, std::shared_ptr<Character>>> advisers; // courtiers holding a council job
+	std::unordered_map<int, std::map<std::string, std::shared_ptr<Title>>> titles;
+};
+} // namespace CK2
+
+#endif // CK2_HOLDER_INDEX_H
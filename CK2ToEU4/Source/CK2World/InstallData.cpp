@@ -0,0 +1,66 @@
+#include "InstallData.h"
+#include "../Configuration/Configuration.h"
+#include "../Mappers/CompiledConfigurables/CompiledConfigurables.h"
+#include "CacheStore.h"
+#include "ModFiles.h"
+#include "Log.h"
+
+namespace
+{
+// Bump whenever the dynasty cache writes anything differently.
+const std::string dynastyCacheFormat = "dynasties 1";
+
+void loadDynasties(CK2::Dynasties& dynasties, const Configuration& theConfiguration, const Mods& mods)
+{
+	std::vector<std::string> paths;
+	for (auto& file: CK2::gatherModFiles(theConfiguration.getCK2Path(), mods, "common/dynasties", ".txt", "dynasties"))
+		paths.emplace_back(std::move(file.path));
+
+	// Stat rather than hash, the way province history is keyed: modded installs carry tens of thousands of dynasties.
+	const auto key = dynastyCacheFormat + mappers::CompiledConfigurables::fingerprint(paths);
+	const auto cacheName = CK2::CacheStore::pathFor("dynasties", key);
+	if (mappers::CompiledConfigurables::loadKeyed(cacheName, key, [&dynasties](mappers::CompiledConfigurables::Reader& reader) {
+			 reader.get(dynasties);
+		 }))
+	{
+		Log(LogLevel::Info) << ">> " << dynasties.getDynasties().size() << " dynasties loaded from " << cacheName;
+		return;
+	}
+
+	dynasties = CK2::Dynasties();
+	dynasties.loadDynasties(paths);
+	mappers::CompiledConfigurables::saveKeyed(cacheName, key, [&dynasties](mappers::CompiledConfigurables::Writer& writer) {
+		writer.put(dynasties);
+	});
+}
+
+void loadProvinces(mappers::ProvinceTitleMapper& provinceTitleMapper, const Configuration& theConfiguration, const Mods& mods)
+{
+	// Vanilla has errors and mismatches. Mods have targeted expansions and replacements. This means for vanilla we have to load a multimap,
+	// but for mods we're overwriting all multimap matches.
+	provinceTitleMapper.loadProvinces(theConfiguration.getCK2Path());
+
+	for (const auto& mod: mods)
+	{
+		if (!CK2::listModFolder(mod.path + "/history/provinces").empty())
+		{
+			Log(LogLevel::Info) << "\t>> Loading additional provinces from [" << mod.name << "]: " << mod.path + "/history/provinces/";
+			provinceTitleMapper.updateProvinces(mod.path);
+		}
+	}
+}
+} // namespace
+
+std::shared_ptr<const CK2::InstallData> CK2::InstallData::load(const Configuration& theConfiguration, const Mods& mods, const bool withDynasties)
+{
+	auto installData = std::make_shared<InstallData>();
+	if (withDynasties)
+	{
+		const EntityArena::Scope entities(installData->arena);
+		loadDynasties(installData->dynasties, theConfiguration, mods);
+	}
+	installData->personalityScraper.scrapePersonalities(theConfiguration);
+	Log(LogLevel::Info) << "-> Importing Province Titles";
+	loadProvinces(installData->provinceTitleMapper, theConfiguration, mods);
+	return installData;
+}
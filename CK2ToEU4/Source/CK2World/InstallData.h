@@ -0,0 +1,35 @@
+#ifndef CK2_INSTALL_DATA_H
+#define CK2_INSTALL_DATA_H
+#include "../Mappers/PersonalityScraper/PersonalityScraper.h"
+#include "../Mappers/ProvinceTitleMapper/ProvinceTitleMapper.h"
+#include "Dynasties/Dynasties.h"
+#include "EntityArena.h"
+#include "ModLoader/ModLoader.h"
+#include <functional>
+#include <memory>
+
+class Configuration;
+
+namespace CK2
+{
+// What the CK2 world reads from the install and its mods rather than from the save: the dynasty definitions, the
+// traits and the counties' province history. A world copies out whatever the save goes on to change.
+struct InstallData
+{
+	// First, so it goes last. Install data outlives any one world when conversions share it, so its dynasties can't
+	// sit in a world's arena; worlds that take them keep the whole record alive.
+	EntityArena arena;
+	Dynasties dynasties;
+	mappers::PersonalityScraper personalityScraper;
+	mappers::ProvinceTitleMapper provinceTitleMapper; // not yet filtered against any save
+
+	// A world resuming from a snapshot has its dynasties already and doesn't need them loaded.
+	[[nodiscard]] static std::shared_ptr<const InstallData> load(const Configuration& theConfiguration, const Mods& mods, bool withDynasties);
+};
+
+// Where a world gets its install data. A lone conversion loads its own; conversions sharing an EU4::StaticData
+// ask it instead, which loads everything once and ignores withDynasties.
+using InstallSource = std::function<std::shared_ptr<const InstallData>(const Configuration& theConfiguration, const Mods& mods, bool withDynasties)>;
+} // namespace CK2
+
+#endif // CK2_INSTALL_DATA_H
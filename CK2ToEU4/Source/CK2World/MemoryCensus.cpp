@@ -0,0 +1,23 @@
+#include "MemoryCensus.h"
+#include <algorithm>
+
+void CK2::MemoryCensus::add(const std::string& type, const std::size_t shallowBytes, const std::size_t heapBytes)
+{
+	auto& typeRow = row(type);
+	++typeRow.objects;
+	typeRow.shallowBytes += shallowBytes;
+	typeRow.deepBytes += shallowBytes + heapBytes;
+}
+
+void CK2::MemoryCensus::addOverhead(const std::string& type, const std::size_t bytes)
+{
+	row(type).deepBytes += bytes;
+}
+
+CK2::MemoryCensus::Row& CK2::MemoryCensus::row(const std::string& type)
+{
+	// A census has a handful of types.
+	if (const auto typeRow = std::ranges::find(rows, type, &Row::type); typeRow != rows.end())
+		return *typeRow;
+	return rows.emplace_back(Row{type});
+}
@@ -0,0 +1,94 @@
+#ifndef CK2_MEMORY_CENSUS_H
+#define CK2_MEMORY_CENSUS_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace CK2
+{
+// Where the memory sits, by kind of entity: how many there are, what they take themselves (sizeof) and what they take
+// with everything they own on the heap, which is strings past their inline buffer, vector capacity, a node per map or
+// set element and the shared_ptr control block every entity comes with. The tables holding them count towards their
+// type too. Links to other entities (shared_ptrs, IDs) cost only their own bytes; what they point at is counted
+// under its own type, and interned symbols aren't counted at all.
+//
+// The deep figures are estimates from the usual standard library layouts rather than allocator measurements: good
+// for telling which type dominates and whether a layout change moved its number, not for adding up to the RSS.
+class MemoryCensus
+{
+  public:
+	struct Row
+	{
+		std::string type;
+		std::size_t objects = 0;
+		std::size_t shallowBytes = 0;
+		std::size_t deepBytes = 0; // shallow bytes included
+	};
+
+	// One more object of the type.
+	void add(const std::string& type, std::size_t shallowBytes, std::size_t heapBytes);
+	// Memory of the type that isn't an object of its own, like the index of the table holding them.
+	void addOverhead(const std::string& type, std::size_t bytes);
+
+	// An entity held by shared_ptr, with a heapBytes() of its own.
+	template <typename Entity> void addEntity(const std::string& type, const Entity& entity) { add(type, sizeof(Entity) + controlBlockBytes, entity.heapBytes()); }
+	// Every entity of a table of (key, shared_ptr<Entity>), and the table itself.
+	template <typename Table> void addEntities(const std::string& type, const Table& table)
+	{
+		for (const auto& [key, entity]: table)
+			if (entity)
+				addEntity(type, *entity);
+		addOverhead(type, heapBytes(table));
+	}
+
+	[[nodiscard]] const auto& getRows() const { return rows; }
+
+	// What a value owns on the heap, through standard containers, pairs and optionals down to anything that has a
+	// heapBytes() of its own. Numbers, dates, symbols and links own nothing.
+	template <typename Value> [[nodiscard]] static std::size_t heapBytes(const Value& value)
+	{
+		if constexpr (requires { value.heapBytes(); })
+			return value.heapBytes();
+		else if constexpr (std::is_same_v<Value, std::string>)
+			return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+		else if constexpr (std::is_same_v<Value, std::string_view>)
+			return 0;
+		else if constexpr (requires { value.first; value.second; })
+			return heapBytes(value.first) + heapBytes(value.second);
+		else if constexpr (requires { value.has_value(); })
+			return value.has_value() ? heapBytes(*value) : 0;
+		else if constexpr (requires { value.begin(); value.size(); })
+		{
+			using Element = typename Value::value_type;
+			std::size_t bytes = 0;
+			if constexpr (requires { value.capacity(); })
+				bytes = value.capacity() * sizeof(Element);
+			else if constexpr (requires { value.bucket_count(); })
+				bytes = value.bucket_count() * sizeof(void*) + value.size() * (sizeof(Element) + hashNodeBytes);
+			else if constexpr (requires { typename Value::node_type; })
+				bytes = value.size() * (sizeof(Element) + treeNodeBytes);
+			else
+				bytes = value.size() * sizeof(Element); // our flat sets and tables
+			if constexpr (!std::is_trivially_copyable_v<Element>)
+				for (const auto& element: value)
+					bytes += heapBytes(element);
+			return bytes;
+		}
+		else
+			return 0;
+	}
+
+	static constexpr std::size_t controlBlockBytes = 3 * sizeof(void*); // vtable, both counts, the arena's allocator
+	static constexpr std::size_t treeNodeBytes = 4 * sizeof(void*);		 // colour, parent, left, right
+	static constexpr std::size_t hashNodeBytes = 2 * sizeof(void*);		 // next, cached hash
+
+  private:
+	Row& row(const std::string& type);
+
+	std::vector<Row> rows; // in the order their types first came up
+};
+} // namespace CK2
+
+#endif // CK2_MEMORY_CENSUS_H
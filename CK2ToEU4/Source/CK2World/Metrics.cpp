@@ -0,0 +1,287 @@
+#include "Metrics.h"
+#include "PhaseTimings.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <map>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#ifdef _WIN32
+#include <winsock2.h>
+
+#include <ws2tcpip.h> // after winsock2.h
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr std::array<double, 13> secondBounds = {0.01, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60, 120, 300};
+constexpr std::array<double, 8> byteBounds = {64.0 * 1048576, 128.0 * 1048576, 256.0 * 1048576, 512.0 * 1048576, 1024.0 * 1048576, 2048.0 * 1048576,
+	 4096.0 * 1048576, 8192.0 * 1048576};
+
+struct Family
+{
+	const char* name;
+	const char* type;
+	const char* help;
+	std::span<const double> bounds; // histograms only
+};
+const std::array<Family, 7> families = {Family{"ck2toeu4_jobs_total", "counter", "Conversions finished, by result."},
+	 Family{"ck2toeu4_queued_jobs", "gauge", "Work waiting: conversions of the batch at hand not yet started, and jobs files not yet taken up."},
+	 Family{"ck2toeu4_job_seconds", "histogram", "Wall time of whole conversions.", secondBounds},
+	 Family{"ck2toeu4_phase_seconds", "histogram", "Wall time of conversion phases.", secondBounds},
+	 Family{"ck2toeu4_job_peak_growth_bytes", "histogram", "How far each conversion raised the process' peak resident set.", byteBounds},
+	 Family{"ck2toeu4_peak_resident_bytes", "gauge", "Peak resident set of the process so far."},
+	 Family{"ck2toeu4_cache_lookups_total", "counter", "Cache lookups by cache (snapshot, vanilla_cache, vanilla_image, culture_match, remote_cache) and result."}};
+
+const Family& family(const std::string& name, const std::string_view type)
+{
+	const auto found = std::ranges::find_if(families, [&name](const Family& candidate) {
+		return name == candidate.name;
+	});
+	if (found == families.end() || found->type != type)
+		throw std::invalid_argument("No " + std::string(type) + " named " + name);
+	return *found;
+}
+
+struct Histogram
+{
+	std::vector<std::uint64_t> buckets; // per bound, not cumulative
+	double sum = 0;
+	std::uint64_t count = 0;
+};
+
+// name -> rendered labels -> series. Map nodes stay put, so handing out references to the atomics is safe.
+std::mutex seriesMutex;
+std::map<std::string, std::map<std::string, std::atomic<std::uint64_t>>> counters;
+std::map<std::string, std::map<std::string, std::atomic<double>>> gauges;
+std::map<std::string, std::map<std::string, Histogram>> histograms;
+
+std::string renderLabels(const CK2::Metrics::Labels& labels)
+{
+	std::string text;
+	for (const auto& [label, value]: labels)
+	{
+		text += text.empty() ? "" : ",";
+		text += label + "=\"";
+		for (const auto character: value)
+		{
+			if (character == '\n')
+			{
+				text += "\\n";
+				continue;
+			}
+			if (character == '"' || character == '\\')
+				text += '\\';
+			text += character;
+		}
+		text += '"';
+	}
+	return text;
+}
+
+std::string number(const double value)
+{
+	char digits[32];
+	const auto end = std::to_chars(digits, digits + sizeof digits, value).ptr;
+	return std::string(digits, end);
+}
+
+std::string series(const std::string& name, const std::string& labels)
+{
+	return labels.empty() ? name : name + "{" + labels + "}";
+}
+
+#ifdef _WIN32
+using Socket = SOCKET;
+constexpr Socket invalidSocket = INVALID_SOCKET;
+void closeSocket(const Socket socket)
+{
+	closesocket(socket);
+}
+#else
+using Socket = int;
+constexpr Socket invalidSocket = -1;
+void closeSocket(const Socket socket)
+{
+	close(socket);
+}
+#endif
+} // namespace
+
+std::atomic<std::uint64_t>& CK2::Metrics::counter(const std::string& name, const Labels& labels)
+{
+	family(name, "counter");
+	const std::lock_guard lock(seriesMutex);
+	return counters[name][renderLabels(labels)];
+}
+
+std::atomic<double>& CK2::Metrics::gauge(const std::string& name, const Labels& labels)
+{
+	family(name, "gauge");
+	const std::lock_guard lock(seriesMutex);
+	return gauges[name][renderLabels(labels)];
+}
+
+void CK2::Metrics::observe(const std::string& name, const Labels& labels, const double value)
+{
+	const auto& bounds = family(name, "histogram").bounds;
+	const std::lock_guard lock(seriesMutex);
+	auto& histogram = histograms[name][renderLabels(labels)];
+	histogram.buckets.resize(bounds.size());
+	if (const auto bucket = std::ranges::lower_bound(bounds, value); bucket != bounds.end())
+		++histogram.buckets[bucket - bounds.begin()];
+	histogram.sum += value;
+	++histogram.count;
+}
+
+std::atomic<std::uint64_t>& CK2::Metrics::lookups(const std::string& cache, const bool hit)
+{
+	return counter("ck2toeu4_cache_lookups_total", {{"cache", cache}, {"result", hit ? "hit" : "miss"}});
+}
+
+void CK2::Metrics::observeConversion(const PhaseTimings& timings)
+{
+	auto wallSeconds = 0.0;
+	std::size_t peakGrowthKB = 0;
+	for (const auto& phase: timings.getPhases())
+	{
+		observe("ck2toeu4_phase_seconds", {{"phase", phase.name}}, phase.wallSeconds);
+		wallSeconds += phase.wallSeconds;
+		peakGrowthKB += phase.peakGrowthKB;
+	}
+	observe("ck2toeu4_job_seconds", {}, wallSeconds);
+	observe("ck2toeu4_job_peak_growth_bytes", {}, static_cast<double>(peakGrowthKB) * 1024);
+	gauge("ck2toeu4_peak_resident_bytes").store(static_cast<double>(PhaseTimings::peakResidentKB()) * 1024, std::memory_order_relaxed);
+}
+
+std::string CK2::Metrics::render()
+{
+	const std::lock_guard lock(seriesMutex);
+	std::string text;
+	for (const auto& [name, type, help, bounds]: families)
+	{
+		text += std::string("# HELP ") + name + " " + help + "\n# TYPE " + name + " " + type + "\n";
+		if (const auto counter = counters.find(name); counter != counters.end())
+			for (const auto& [labels, value]: counter->second)
+				text += series(name, labels) + " " + std::to_string(value.load(std::memory_order_relaxed)) + "\n";
+		if (const auto gauge = gauges.find(name); gauge != gauges.end())
+			for (const auto& [labels, value]: gauge->second)
+				text += series(name, labels) + " " + number(value.load(std::memory_order_relaxed)) + "\n";
+		if (const auto histogram = histograms.find(name); histogram != histograms.end())
+			for (const auto& [labels, values]: histogram->second)
+			{
+				const auto separator = labels.empty() ? "" : ",";
+				std::uint64_t cumulative = 0;
+				for (std::size_t bucket = 0; bucket < bounds.size(); ++bucket)
+				{
+					cumulative += values.buckets[bucket];
+					text += std::string(name) + "_bucket{" + labels + separator + "le=\"" + number(bounds[bucket]) + "\"} " + std::to_string(cumulative) + "\n";
+				}
+				text += std::string(name) + "_bucket{" + labels + separator + "le=\"+Inf\"} " + std::to_string(values.count) + "\n";
+				text += series(std::string(name) + "_sum", labels) + " " + number(values.sum) + "\n";
+				text += series(std::string(name) + "_count", labels) + " " + std::to_string(values.count) + "\n";
+			}
+	}
+	return text;
+}
+
+void CK2::Metrics::reset()
+{
+	const std::lock_guard lock(seriesMutex);
+	counters.clear();
+	gauges.clear();
+	histograms.clear();
+}
+
+CK2::MetricsServer::MetricsServer(const std::uint16_t port)
+{
+#ifdef _WIN32
+	WSADATA winsock;
+	if (WSAStartup(MAKEWORD(2, 2), &winsock))
+		throw std::runtime_error("Could not start Winsock for the metrics server.");
+#endif
+	const Socket socketHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	socklen_t addressSize = sizeof address;
+	if (socketHandle == invalidSocket || bind(socketHandle, reinterpret_cast<sockaddr*>(&address), sizeof address) ||
+		 listen(socketHandle, 8) || getsockname(socketHandle, reinterpret_cast<sockaddr*>(&address), &addressSize))
+	{
+		if (socketHandle != invalidSocket)
+			closeSocket(socketHandle);
+		throw std::runtime_error("Could not listen for metrics scrapes on port " + std::to_string(port) + ".");
+	}
+	listener = static_cast<std::uintptr_t>(socketHandle);
+	this->port = ntohs(address.sin_port);
+	server = std::thread([this] {
+		serve();
+	});
+}
+
+CK2::MetricsServer::~MetricsServer()
+{
+	stopping = true;
+	server.join();
+	closeSocket(static_cast<Socket>(listener));
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+void CK2::MetricsServer::serve() const
+{
+	const auto socketHandle = static_cast<Socket>(listener);
+	while (!stopping)
+	{
+		// Wakes up now and then to see whether we're done; scrapes come every few seconds at most.
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(socketHandle, &readable);
+		timeval timeout{0, 250000};
+		if (select(static_cast<int>(socketHandle) + 1, &readable, nullptr, nullptr, &timeout) <= 0)
+			continue;
+		const Socket client = accept(socketHandle, nullptr, nullptr);
+		if (client == invalidSocket)
+			continue;
+
+		// The request line is all we look at.
+		std::string request;
+		char buffer[1024];
+		while (request.find("\r\n") == std::string::npos && request.size() < 8192)
+		{
+			const auto received = recv(client, buffer, sizeof buffer, 0);
+			if (received <= 0)
+				break;
+			request.append(buffer, static_cast<std::size_t>(received));
+		}
+		std::string response;
+		if (request.starts_with("GET /metrics ") || request.starts_with("GET /metrics?"))
+		{
+			const auto body = Metrics::render();
+			response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(body.size()) +
+						  "\r\nConnection: close\r\n\r\n" + body;
+		}
+		else
+		{
+			response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+		}
+		for (std::size_t sent = 0; sent < response.size();)
+		{
+			const auto chunk = send(client, response.data() + sent, static_cast<int>(response.size() - sent), 0);
+			if (chunk <= 0)
+				break;
+			sent += static_cast<std::size_t>(chunk);
+		}
+		closeSocket(client);
+	}
+}
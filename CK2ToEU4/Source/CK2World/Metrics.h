@@ -0,0 +1,65 @@
+#ifndef CK2_METRICS_H
+#define CK2_METRICS_H
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CK2
+{
+class PhaseTimings;
+
+// Throughput and latency of a long-running converter, in the Prometheus text format: finished conversions, their
+// phases' wall times, cache hits and misses, peak memory and how many jobs are waiting. The metric families are a
+// fixed list in Metrics.cpp, each with its help text; asking for one that isn't there is a bug and throws.
+//
+// Counters and gauges are plain atomics once looked up, so hot paths keep a reference in a static and pay one relaxed
+// add. Histograms take a lock, and see a few dozen observations per conversion. Everything is process-wide and
+// always on; only serving it needs a MetricsServer.
+class Metrics
+{
+  public:
+	using Labels = std::vector<std::pair<std::string, std::string>>;
+
+	// The same name and labels always give the same series, for as long as the process runs.
+	[[nodiscard]] static std::atomic<std::uint64_t>& counter(const std::string& name, const Labels& labels = {});
+	[[nodiscard]] static std::atomic<double>& gauge(const std::string& name, const Labels& labels = {});
+	static void observe(const std::string& name, const Labels& labels, double value);
+
+	// ck2toeu4_cache_lookups_total for the cache, labelled hit or miss.
+	[[nodiscard]] static std::atomic<std::uint64_t>& lookups(const std::string& cache, bool hit);
+	// A finished conversion's phases, total wall time and peak memory growth, plus the process' peak so far.
+	static void observeConversion(const PhaseTimings& timings);
+
+	// Every family in list order, each with its HELP and TYPE lines and whatever series it has so far.
+	[[nodiscard]] static std::string render();
+	// Drops every series. For tests.
+	static void reset();
+};
+
+// Serves Metrics::render() at http://127.0.0.1:<port>/metrics from a thread of its own, for as long as it lives. Only
+// the loopback interface listens; put a proxy in front to scrape it from elsewhere.
+class MetricsServer
+{
+  public:
+	// Port 0 takes any free one. Throws if the port can't be had.
+	explicit MetricsServer(std::uint16_t port);
+	~MetricsServer();
+	MetricsServer(const MetricsServer&) = delete;
+	MetricsServer& operator=(const MetricsServer&) = delete;
+
+	[[nodiscard]] auto getPort() const { return port; }
+
+  private:
+	void serve() const;
+
+	std::uintptr_t listener = 0; // the platform's socket handle
+	std::uint16_t port = 0;
+	std::atomic<bool> stopping = false;
+	std::thread server;
+};
+} // namespace CK2
+
+#endif // CK2_METRICS_H
@@ -0,0 +1,112 @@
+#include "ModArchive.h"
+#include "zip.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+CK2::ModArchive::ModArchive(std::string thePath): path(std::move(thePath))
+{
+	auto* handle = zip_open(path.c_str(), 0, 'r');
+	if (!handle)
+		throw std::runtime_error("Could not open mod archive " + path + ".");
+	const auto total = zip_entries_total(handle);
+	for (long index = 0; index < total; ++index)
+	{
+		if (zip_entry_openbyindex(handle, index))
+			continue;
+		if (!zip_entry_isdir(handle))
+		{
+			std::string name = zip_entry_name(handle);
+			std::ranges::replace(name, '\\', '/');
+			entries.emplace(std::move(name), index);
+		}
+		zip_entry_close(handle);
+	}
+	idleHandles.push_back(handle);
+}
+
+CK2::ModArchive::~ModArchive()
+{
+	for (auto* handle: idleHandles)
+		zip_close(handle);
+}
+
+std::shared_ptr<const CK2::ModArchive> CK2::ModArchive::open(const std::string& path)
+{
+	// A server converting job after job opens an archive again once it has been replaced.
+	static std::mutex archivesMutex;
+	static std::map<std::string, std::pair<std::string, std::shared_ptr<const ModArchive>>> archives; // with its stamp
+	std::error_code error;
+	const auto file = std::filesystem::u8path(path);
+	const auto stamp = std::to_string(std::filesystem::file_size(file, error)) + ":" +
+							 std::to_string(std::filesystem::last_write_time(file, error).time_since_epoch().count());
+	const std::lock_guard lock(archivesMutex);
+	auto& [openedStamp, archive] = archives[path];
+	if (!archive || openedStamp != stamp)
+	{
+		archive = std::make_shared<const ModArchive>(path);
+		openedStamp = stamp;
+	}
+	return archive;
+}
+
+std::optional<std::pair<std::string, std::string>> CK2::ModArchive::locate(const std::string_view path)
+{
+	const auto end = path.find(".zip/");
+	if (end == std::string_view::npos)
+		return std::nullopt;
+	return std::pair(std::string(path.substr(0, end + 4)), std::string(path.substr(end + 5)));
+}
+
+std::set<std::string> CK2::ModArchive::filesIn(std::string_view folder) const
+{
+	while (folder.ends_with('/'))
+		folder.remove_suffix(1);
+	const auto prefix = folder.empty() ? std::string() : std::string(folder) + "/";
+	std::set<std::string> files;
+	for (auto entry = entries.lower_bound(prefix); entry != entries.end() && entry->first.starts_with(prefix); ++entry)
+		if (const auto name = std::string_view(entry->first).substr(prefix.size()); name.find('/') == std::string_view::npos)
+			files.emplace(name);
+	return files;
+}
+
+std::optional<std::string> CK2::ModArchive::read(const std::string_view file) const
+{
+	const auto entry = entries.find(file);
+	if (entry == entries.end())
+		return std::nullopt;
+	auto* handle = borrowHandle();
+	if (!handle)
+		return std::nullopt;
+	std::optional<std::string> contents;
+	if (!zip_entry_openbyindex(handle, entry->second))
+	{
+		std::string inflated(static_cast<std::size_t>(zip_entry_size(handle)), '\0');
+		const auto inflatedBytes = zip_entry_noallocread(handle, inflated.data(), inflated.size());
+		if (inflated.empty() || (inflatedBytes >= 0 && static_cast<std::size_t>(inflatedBytes) == inflated.size()))
+			contents = std::move(inflated);
+		zip_entry_close(handle);
+	}
+	returnHandle(handle);
+	return contents;
+}
+
+zip_t* CK2::ModArchive::borrowHandle() const
+{
+	{
+		const std::lock_guard lock(handlesMutex);
+		if (!idleHandles.empty())
+		{
+			auto* handle = idleHandles.back();
+			idleHandles.pop_back();
+			return handle;
+		}
+	}
+	return zip_open(path.c_str(), 0, 'r');
+}
+
+void CK2::ModArchive::returnHandle(zip_t* handle) const
+{
+	const std::lock_guard lock(handlesMutex);
+	idleHandles.push_back(handle);
+}
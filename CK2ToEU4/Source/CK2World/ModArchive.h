@@ -0,0 +1,57 @@
+#ifndef CK2_MOD_ARCHIVE_H
+#define CK2_MOD_ARCHIVE_H
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct zip_t;
+
+namespace CK2
+{
+// A zipped mod read where it lies instead of being unpacked first. The central directory is indexed once when the
+// archive is first opened, and a file is only inflated when someone reads it.
+//
+// Files inside go by the archive's path followed by their own, "mod/Tianxia.zip/common/dynasties/00_dynasties.txt",
+// so they travel through the same lists of paths as loose files do; readModFile() and friends in ModFiles.h tell
+// the two apart.
+class ModArchive
+{
+  public:
+	explicit ModArchive(std::string path); // throws if it isn't a zip
+	~ModArchive();
+	ModArchive(const ModArchive&) = delete;
+	ModArchive& operator=(const ModArchive&) = delete;
+
+	// The archive at path, shared by everyone reading it through the conversion.
+	[[nodiscard]] static std::shared_ptr<const ModArchive> open(const std::string& path);
+	// A mod whose path is an archive rather than a folder.
+	[[nodiscard]] static bool isArchive(std::string_view modPath) { return modPath.ends_with(".zip"); }
+	// The archive and the path inside it, if path points into one.
+	[[nodiscard]] static std::optional<std::pair<std::string, std::string>> locate(std::string_view path);
+
+	// Names of the files directly in the folder ("common/dynasties"), like commonItems::GetAllFilesInFolder.
+	[[nodiscard]] std::set<std::string> filesIn(std::string_view folder) const;
+	// The file inflated, or nothing if the archive doesn't have it or it won't inflate.
+	[[nodiscard]] std::optional<std::string> read(std::string_view file) const;
+
+	[[nodiscard]] const auto& getPath() const { return path; }
+
+  private:
+	// zip handles aren't shareable between threads; each reader borrows one of its own, opening another if none is idle.
+	[[nodiscard]] zip_t* borrowHandle() const;
+	void returnHandle(zip_t* handle) const;
+
+	std::string path;
+	std::map<std::string, long, std::less<>> entries; // generic path inside the archive -> central directory index
+	mutable std::mutex handlesMutex;
+	mutable std::vector<zip_t*> idleHandles;
+};
+} // namespace CK2
+
+#endif // CK2_MOD_ARCHIVE_H
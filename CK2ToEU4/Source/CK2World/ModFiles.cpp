@@ -0,0 +1,103 @@
+#include "ModFiles.h"
+#include "CommonFunctions.h"
+#include "CommonRegexes.h"
+#include "Log.h"
+#include "ModArchive.h"
+#include "OSCompatibilityLayer.h"
+#include "Parser.h"
+#include "ParserHelpers.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+// The two lines of a .mod file that tell a zipped mod from a folder.
+class ModDescriptor: commonItems::parser
+{
+  public:
+	explicit ModDescriptor(const std::string& descriptorPath)
+	{
+		registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
+			name = commonItems::singleString(theStream).getString();
+		});
+		registerKeyword("archive", [this](const std::string& unused, std::istream& theStream) {
+			archive = commonItems::singleString(theStream).getString();
+		});
+		registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+		parseFile(descriptorPath);
+		clearRegisteredKeywords();
+	}
+
+	std::string name;
+	std::string archive; // relative to the documents folder, "mod/Tianxia.zip"
+};
+
+void addFolder(std::vector<CK2::ModFile>& files, const std::string& folderPath, const std::string_view extension)
+{
+	for (const auto& file: CK2::listModFolder(folderPath))
+		if (file.ends_with(extension))
+			files.emplace_back(CK2::ModFile{file, folderPath + file});
+}
+} // namespace
+
+std::vector<CK2::ModFile> CK2::gatherModFiles(const std::string& installPath, const Mods& mods, const std::string_view folder, const std::string_view extension,
+	 const std::string_view what)
+{
+	std::vector<ModFile> files;
+	addFolder(files, installPath + "/" + std::string(folder) + "/", extension);
+	for (const auto& mod: mods)
+	{
+		const auto modFolder = mod.path + "/" + std::string(folder) + "/";
+		const auto before = files.size();
+		addFolder(files, modFolder, extension);
+		if (files.size() > before)
+			Log(LogLevel::Info) << "\t>> Found some " << what << " in [" << mod.name << "]: " << modFolder;
+	}
+	return files;
+}
+
+Mods CK2::locateMods(const std::string& CK2DocsPath, const Mods& selected)
+{
+	// One mod at a time, so the zipped ones can go back in their place among what the loader returns.
+	Mods mods;
+	for (const auto& mod: selected)
+	{
+		const auto descriptorPath = CK2DocsPath + "/mod/" + trimPath(mod.path);
+		if (commonItems::DoesFileExist(descriptorPath))
+		{
+			const ModDescriptor descriptor(descriptorPath);
+			const auto archivePath = CK2DocsPath + "/" + descriptor.archive;
+			if (ModArchive::isArchive(descriptor.archive) && commonItems::DoesFileExist(archivePath))
+			{
+				Log(LogLevel::Info) << "\t>> Reading [" << descriptor.name << "] in place from " << archivePath;
+				mods.emplace_back(commonItems::Mod(descriptor.name, archivePath));
+				continue;
+			}
+		}
+		commonItems::ModLoader modLoader;
+		modLoader.loadMods(CK2DocsPath, Mods{mod});
+		for (const auto& loaded: modLoader.getMods())
+			mods.emplace_back(loaded);
+	}
+	return mods;
+}
+
+std::optional<std::string> CK2::readModFile(const std::string& path)
+{
+	if (const auto inArchive = ModArchive::locate(path))
+		return ModArchive::open(inArchive->first)->read(inArchive->second);
+	std::ifstream file(std::filesystem::u8path(path), std::ios::binary);
+	if (!file.is_open())
+		return std::nullopt;
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	return std::move(contents).str();
+}
+
+std::set<std::string> CK2::listModFolder(const std::string& folderPath)
+{
+	if (const auto inArchive = ModArchive::locate(folderPath + "/"))
+		return ModArchive::open(inArchive->first)->filesIn(inArchive->second);
+	return commonItems::GetAllFilesInFolder(folderPath);
+}
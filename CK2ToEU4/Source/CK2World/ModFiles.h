@@ -0,0 +1,35 @@
+#ifndef CK2_MOD_FILES_H
+#define CK2_MOD_FILES_H
+#include "ModLoader/ModLoader.h"
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+struct ModFile
+{
+	std::string name; // "k_france.tga"
+	std::string path; // where it was found, base folder, mod folder or mod archive (see ModArchive)
+};
+
+// The selected mods as commonItems::ModLoader finds them, in the order selected, except that a zipped mod isn't
+// unpacked: its path is the archive itself, read in place by everything below.
+[[nodiscard]] Mods locateMods(const std::string& CK2DocsPath, const Mods& selected);
+
+// The file's bytes as they are, whether it lies loose or in a mod archive. Nothing if it can't be read.
+[[nodiscard]] std::optional<std::string> readModFile(const std::string& path);
+// Names of the files directly in a folder, loose or in a mod archive, like commonItems::GetAllFilesInFolder.
+[[nodiscard]] std::set<std::string> listModFolder(const std::string& folderPath);
+
+// Every file with the given extension in one folder ("common/landed_titles") of the install and then of each mod, in
+// that order, so a caller merging them front to back lets mods override the base game and later mods earlier ones.
+// Each folder is listed once; a mod without it simply adds nothing. Mods that do add files get one line in the log,
+// "Found some <what> in [mod]".
+[[nodiscard]] std::vector<ModFile> gatherModFiles(const std::string& installPath, const Mods& mods, std::string_view folder, std::string_view extension,
+	 std::string_view what);
+} // namespace CK2
+
+#endif // CK2_MOD_FILES_H
@@ -1,4 +1,5 @@
 #include "Offmap.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
@@ -25,5 +26,5 @@ void CK2::Offmap::registerKeys()
 		const commonItems::singleInt holderInt(theStream);
 		holder = std::pair(holderInt.getInt(), nullptr);
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
@@ -18,6 +18,8 @@ class Offmap: commonItems::parser
 	void setHolder(const std::pair<int, std::shared_ptr<Character>>& theHolder) { holder = theHolder; }
 
   private:
+	friend class Snapshot;
+
 	void registerKeys();
 	std::string type;
 	std::pair<int, std::shared_ptr<Character>> holder;
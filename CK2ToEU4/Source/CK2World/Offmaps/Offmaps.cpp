@@ -1,23 +1,25 @@
 #include "Offmaps.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../EntityArena.h"
 #include "Log.h"
 #include "Offmap.h"
 #include "ParserHelpers.h"
 
 CK2::Offmaps::Offmaps(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Offmaps::registerKeys()
+parsing::KeywordTable<CK2::Offmaps> CK2::Offmaps::registerKeys()
 {
-	registerRegex(R"(\d+)", [this](const std::string& wonderID, std::istream& theStream) {
-		auto newOffmap = std::make_shared<Offmap>(theStream);
-		offmaps.insert(std::pair(std::stoi(wonderID), newOffmap));
+	parsing::KeywordTable<Offmaps> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Offmaps& theOffmaps, const std::string& wonderID, std::istream& theStream) {
+		auto newOffmap = makeEntity<Offmap>(theStream);
+		theOffmaps.offmaps.insert(std::pair(std::stoi(wonderID), newOffmap));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
 std::optional<std::pair<int, std::shared_ptr<CK2::Offmap>>> CK2::Offmaps::getChina() const
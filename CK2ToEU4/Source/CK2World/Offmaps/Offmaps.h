@@ -2,10 +2,15 @@
 #define CK2_OFFMAPS_H
 #include "Parser.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
 class Offmap;
-class Offmaps: commonItems::parser
+class Offmaps
 {
   public:
 	Offmaps() = default;
@@ -15,7 +20,9 @@ class Offmaps: commonItems::parser
 	[[nodiscard]] std::optional<std::pair<int, std::shared_ptr<Offmap>>> getChina() const;
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Offmaps> registerKeys();
 
 	std::map<int, std::shared_ptr<Offmap>> offmaps;
 };
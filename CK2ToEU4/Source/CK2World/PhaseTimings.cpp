@@ -0,0 +1,261 @@
+#include "PhaseTimings.h"
+#include "Concurrency.h"
+#include "Log.h"
+#include "Progress.h"
+#include "Trace.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+
+#include <psapi.h> // after windows.h
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+std::string escapeJSON(const std::string& text)
+{
+	std::string escaped;
+	for (const auto character: text)
+	{
+		if (character == '"' || character == '\\')
+			escaped += '\\';
+		escaped += character;
+	}
+	return escaped;
+}
+} // namespace
+
+void CK2::PhaseTimings::begin(const std::string& name)
+{
+	finish();
+	if (cancelled && cancelled->load(std::memory_order_relaxed))
+		throw std::runtime_error("Cancelled before " + name + ".");
+	if (stopReached)
+		throw Stopped("Stopped after " + stopAfter + " as configured.");
+	if (name == from)
+		from.clear();
+	Progress::phase(name);
+	open.emplace(OpenPhase{Phase{name}, std::chrono::steady_clock::now(), processCPUSeconds(), peakResidentKB(), AllocationProfile::totals()});
+	if (hardwareCounters)
+		open->hardwareStart = hardwareCounters->read();
+	if (contentionEnabled)
+	{
+		open->phase.threads = Concurrency::threads();
+		open->waitStart = Contention::totals();
+	}
+}
+
+void CK2::PhaseTimings::enableContention()
+{
+	Contention::enable();
+	contentionEnabled = true;
+}
+
+void CK2::PhaseTimings::enableHardwareCounters()
+{
+	if (hardwareCounters)
+		return;
+	hardwareCounters = std::make_unique<HardwareCounters>();
+	if (hardwareCounters->empty())
+		hardwareCounters.reset();
+}
+
+void CK2::PhaseTimings::window(std::string theFrom, std::string theStopAfter)
+{
+	from = std::move(theFrom);
+	stopAfter = std::move(theStopAfter);
+}
+
+void CK2::PhaseTimings::finish()
+{
+	if (!open)
+		return;
+	if (!stopAfter.empty() && open->phase.name == stopAfter)
+		stopReached = true;
+	if (!from.empty())
+	{
+		open.reset();
+		return;
+	}
+	auto& phase = open->phase;
+	const auto wallEnd = std::chrono::steady_clock::now();
+	phase.wallSeconds = std::chrono::duration<double>(wallEnd - open->wallStart).count();
+	Trace::record(phase.name, open->wallStart, wallEnd);
+	phase.cpuSeconds = processCPUSeconds() - open->cpuStart;
+	const auto peak = peakResidentKB();
+	phase.peakGrowthKB = peak > open->peakStart ? peak - open->peakStart : 0;
+	const auto allocations = AllocationProfile::totals();
+	phase.allocations = allocations.allocations - open->allocationStart.allocations;
+	phase.allocatedBytes = allocations.bytes - open->allocationStart.bytes;
+	if (hardwareCounters)
+		for (auto& [event, value]: hardwareCounters->read())
+			for (const auto& [startEvent, startValue]: open->hardwareStart)
+				if (startEvent == event)
+					phase.hardwareCounts.emplace_back(std::move(event), value > startValue ? value - startValue : 0);
+	if (phase.threads)
+	{
+		// Sites only ever get added, so the ones there at the start are still the first ones now.
+		auto waits = Contention::totals();
+		for (std::size_t site = 0; site < waits.size(); ++site)
+		{
+			if (site < open->waitStart.size())
+			{
+				waits[site].waits -= open->waitStart[site].waits;
+				waits[site].nanoseconds -= open->waitStart[site].nanoseconds;
+			}
+			if (waits[site].waits)
+				phase.waits.emplace_back(std::move(waits[site]));
+		}
+		Trace::count("parallel efficiency %", open->wallStart, 100 * phase.parallelEfficiency());
+		Trace::count("parallel efficiency %", wallEnd, 0);
+	}
+	phases.emplace_back(std::move(phase));
+	open.reset();
+}
+
+void CK2::PhaseTimings::count(const std::string& what, const std::size_t number)
+{
+	if (open)
+		open->phase.counts.emplace_back(what, number);
+}
+
+void CK2::PhaseTimings::census(const MemoryCensus& census)
+{
+	if (open)
+		open->phase.census = census.getRows();
+}
+
+void CK2::PhaseTimings::logTable() const
+{
+	Log(LogLevel::Info) << "<> Phase timings:      wall s      cpu s   peak +MB";
+	auto wallTotal = 0.0;
+	auto cpuTotal = 0.0;
+	for (const auto& phase: phases)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(2) << std::setw(10) << phase.wallSeconds << std::setw(11) << phase.cpuSeconds << std::setw(11)
+			  << phase.peakGrowthKB / 1024 << "   " << phase.name;
+		for (const auto& [what, number]: phase.counts)
+			line << ", " << number << " " << what;
+		for (const auto& [event, number]: phase.hardwareCounts)
+			line << ", " << number << " " << event;
+		if (phase.threads)
+			line << ", " << std::setprecision(0) << 100 * phase.parallelEfficiency() << "% of " << phase.threads << " threads busy";
+		for (const auto& wait: phase.waits)
+			line << ", " << std::setprecision(1) << static_cast<double>(wait.nanoseconds) / 1e6 << " ms waiting at " << wait.site << " (" << wait.waits << " times)";
+		if constexpr (AllocationProfile::enabled())
+			line << ", " << phase.allocations << " allocations of " << phase.allocatedBytes / 1024 << " KB";
+		Log(LogLevel::Info) << "<>          " << line.str();
+		for (const auto& row: phase.census)
+		{
+			std::ostringstream censusLine;
+			censusLine << std::fixed << std::setprecision(1) << row.type << ": " << row.objects << " objects, " << row.shallowBytes / 1048576.0 << " MB shallow, "
+						  << row.deepBytes / 1048576.0 << " MB deep";
+			Log(LogLevel::Info) << "<>                 " << censusLine.str();
+		}
+		wallTotal += phase.wallSeconds;
+		cpuTotal += phase.cpuSeconds;
+	}
+	std::ostringstream total;
+	total << std::fixed << std::setprecision(2) << std::setw(10) << wallTotal << std::setw(11) << cpuTotal << std::setw(11) << peakResidentKB() / 1024
+			<< "   Total (peak is the whole process)";
+	Log(LogLevel::Info) << "<>          " << total.str();
+	if constexpr (AllocationProfile::enabled())
+	{
+		const auto allocations = AllocationProfile::totals();
+		Log(LogLevel::Info) << "<> Allocations: " << allocations.allocations << " in all, " << allocations.bytes / 1024 / 1024 << " MB, phases or not.";
+	}
+}
+
+void CK2::PhaseTimings::writeJSON(const std::string& filePath) const
+{
+	std::ofstream output(filePath);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + filePath);
+	output << "{\n\t\"peakResidentKB\": " << peakResidentKB() << ",\n\t\"phases\": [";
+	for (std::size_t index = 0; index < phases.size(); ++index)
+	{
+		const auto& phase = phases[index];
+		output << (index ? ",\n" : "\n") << "\t\t{\"name\": \"" << escapeJSON(phase.name) << "\", \"wallSeconds\": " << phase.wallSeconds
+				 << ", \"cpuSeconds\": " << phase.cpuSeconds << ", \"peakGrowthKB\": " << phase.peakGrowthKB;
+		if constexpr (AllocationProfile::enabled())
+			output << ", \"allocations\": " << phase.allocations << ", \"allocatedBytes\": " << phase.allocatedBytes;
+		output << ", \"counts\": {";
+		for (std::size_t countIndex = 0; countIndex < phase.counts.size(); ++countIndex)
+			output << (countIndex ? ", " : "") << "\"" << escapeJSON(phase.counts[countIndex].first) << "\": " << phase.counts[countIndex].second;
+		output << "}";
+		if (!phase.hardwareCounts.empty())
+		{
+			output << ", \"hardware\": {";
+			for (std::size_t countIndex = 0; countIndex < phase.hardwareCounts.size(); ++countIndex)
+				output << (countIndex ? ", " : "") << "\"" << phase.hardwareCounts[countIndex].first << "\": " << phase.hardwareCounts[countIndex].second;
+			output << "}";
+		}
+		if (phase.threads)
+		{
+			output << ", \"threads\": " << phase.threads << ", \"parallelEfficiency\": " << phase.parallelEfficiency() << ", \"waits\": {";
+			for (std::size_t waitIndex = 0; waitIndex < phase.waits.size(); ++waitIndex)
+			{
+				const auto& wait = phase.waits[waitIndex];
+				output << (waitIndex ? ", " : "") << "\"" << escapeJSON(wait.site) << "\": {\"waits\": " << wait.waits << ", \"nanoseconds\": " << wait.nanoseconds << "}";
+			}
+			output << "}";
+		}
+		if (!phase.census.empty())
+		{
+			output << ", \"census\": [";
+			for (std::size_t rowIndex = 0; rowIndex < phase.census.size(); ++rowIndex)
+			{
+				const auto& row = phase.census[rowIndex];
+				output << (rowIndex ? ", " : "") << "{\"type\": \"" << escapeJSON(row.type) << "\", \"objects\": " << row.objects
+						 << ", \"shallowBytes\": " << row.shallowBytes << ", \"deepBytes\": " << row.deepBytes << "}";
+			}
+			output << "]";
+		}
+		output << "}";
+	}
+	output << "\n\t]\n}\n";
+}
+
+double CK2::PhaseTimings::processCPUSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation, exited, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user))
+		return 0;
+	const auto ticks = [](const FILETIME& time) {
+		return static_cast<double>(static_cast<unsigned long long>(time.dwHighDateTime) << 32 | time.dwLowDateTime);
+	};
+	return (ticks(kernel) + ticks(user)) / 1e7; // 100 ns ticks
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage))
+		return 0;
+	return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+std::size_t CK2::PhaseTimings::peakResidentKB()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters))
+		return 0;
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage))
+		return 0;
+#ifdef __APPLE__
+	return static_cast<std::size_t>(usage.ru_maxrss) / 1024; // bytes there, kilobytes on Linux
+#else
+	return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
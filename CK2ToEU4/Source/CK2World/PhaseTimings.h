@@ -0,0 +1,112 @@
+#ifndef CK2_PHASE_TIMINGS_H
+#define CK2_PHASE_TIMINGS_H
+#include "AllocationProfile.h"
+#include "Contention.h"
+#include "HardwareCounters.h"
+#include "MemoryCensus.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CK2
+{
+// Where a conversion spends itself, one conversion phase at a time. A phase runs from its begin() to the next begin()
+// or finish(), so both world constructors mark phases with one line apiece next to their progress markers. Timings
+// are recorded on the thread that drives the conversion; phases that fan out still count all their CPU time. Each phase
+// is also a span on the conversion Trace and a line of Progress, when those are on. An allocation-profiling build also counts the allocations made
+// during each phase, on any thread, and with enableHardwareCounters() each phase also gets its share of the CPU's
+// event counters. With enableMemoryCensus() the worlds also count their entities' memory at the end of their major
+// phases, and with enableContention() each phase notes how long its threads waited on shared structures and how busy
+// they were. Every begin() is also where a conversion can stop cleanly, so one cancelled through cancelWith() throws there,
+// and so does one profiling a window of phases (window()) once the window is done.
+class PhaseTimings
+{
+  public:
+	struct Phase
+	{
+		std::string name;
+		double wallSeconds = 0;
+		double cpuSeconds = 0;
+		std::size_t peakGrowthKB = 0; // how much this phase raised the process' peak resident set
+		std::size_t allocations = 0;	 // allocation-profiling builds only
+		std::size_t allocatedBytes = 0;
+		std::vector<std::pair<std::string, std::size_t>> counts;
+		std::vector<std::pair<std::string, std::uint64_t>> hardwareCounts; // with hardware counters only
+		std::vector<MemoryCensus::Row> census;										 // with a memory census only
+		std::size_t threads = 0;															 // with contention profiling only
+		std::vector<Contention::Wait> waits;												 // sites that waited, with contention profiling only
+
+		// CPU time over what the phase's threads could have spent: 1 when every one of them was busy throughout.
+		[[nodiscard]] double parallelEfficiency() const { return threads && wallSeconds > 0 ? cpuSeconds / (wallSeconds * static_cast<double>(threads)) : 0; }
+	};
+
+	// From the next begin() on. Quietly leaves them off if the platform or the kernel has none to give.
+	void enableHardwareCounters();
+
+	// Thrown by begin() in place of opening the phase after the window.
+	struct Stopped: std::runtime_error
+	{
+		using std::runtime_error::runtime_error;
+	};
+
+	// Throws std::runtime_error instead if the conversion was cancelled, or Stopped if the window just closed.
+	void begin(const std::string& name);
+	void finish();
+	// The flag outlives the conversion, and setting it stops the conversion at its next phase.
+	void cancelWith(const std::atomic<bool>& flag) { cancelled = &flag; }
+	// Keeps only the phases from `from` on (the ones before still run, untimed and untraced) and stops the conversion
+	// once `stopAfter` is done. Either may be empty: from the start, through the end.
+	void window(std::string from, std::string stopAfter);
+	[[nodiscard]] bool stops() const { return !stopAfter.empty(); }
+	// Whether the phase to stop after has run; false for a name no phase has.
+	[[nodiscard]] bool stopped() const { return stopReached; }
+	// Notes an entity count against the open phase, if any.
+	void count(const std::string& what, std::size_t number);
+
+	// From the next begin() on, times lock waits at every Contention site and rates each phase's use of its threads.
+	void enableContention();
+
+	// A census walks every entity, so the worlds only take one when asked to.
+	void enableMemoryCensus() { censusEnabled = true; }
+	[[nodiscard]] bool takesCensus() const { return censusEnabled; }
+	// Notes a census against the open phase, if any.
+	void census(const MemoryCensus& census);
+
+	[[nodiscard]] const auto& getPhases() const { return phases; }
+
+	void logTable() const;
+	// One object per phase in a "phases" array, for comparing runs without scraping the log.
+	void writeJSON(const std::string& filePath) const;
+
+	[[nodiscard]] static double processCPUSeconds();
+	[[nodiscard]] static std::size_t peakResidentKB();
+
+  private:
+	struct OpenPhase
+	{
+		Phase phase;
+		std::chrono::steady_clock::time_point wallStart;
+		double cpuStart = 0;
+		std::size_t peakStart = 0;
+		AllocationProfile::Totals allocationStart;
+		std::vector<std::pair<std::string, std::uint64_t>> hardwareStart;
+		std::vector<Contention::Wait> waitStart;
+	};
+	std::unique_ptr<HardwareCounters> hardwareCounters;
+	bool censusEnabled = false;
+	bool contentionEnabled = false;
+	const std::atomic<bool>* cancelled = nullptr;
+	std::string from;		// empty once the window is reached
+	std::string stopAfter; // empty to run through
+	bool stopReached = false;
+	std::optional<OpenPhase> open;
+	std::vector<Phase> phases;
+};
+} // namespace CK2
+
+#endif // CK2_PHASE_TIMINGS_H
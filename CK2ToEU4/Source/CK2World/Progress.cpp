@@ -0,0 +1,115 @@
+#include "Progress.h"
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+std::atomic<bool> CK2::Progress::on = false;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+// Advancing writes at most this often; phase changes always write.
+constexpr auto lineInterval = std::chrono::milliseconds(250);
+
+std::mutex progressMutex;
+std::ofstream output;
+Clock::time_point started;
+Clock::time_point phaseStarted;
+std::string phaseName;
+std::atomic<std::size_t> done = 0;
+std::atomic<std::size_t> total = 0;
+std::atomic<Clock::rep> lastLine = 0;
+
+std::string escapeJSON(const std::string& text)
+{
+	std::string escaped;
+	for (const auto character: text)
+	{
+		if (character == '"' || character == '\\')
+			escaped += '\\';
+		escaped += character;
+	}
+	return escaped;
+}
+
+double secondsBetween(const Clock::time_point start, const Clock::time_point end)
+{
+	return std::chrono::duration<double>(end - start).count();
+}
+
+// Under progressMutex.
+void writeLine(const Clock::time_point now)
+{
+	const auto itemsDone = done.load(std::memory_order_relaxed);
+	const auto itemsTotal = total.load(std::memory_order_relaxed);
+	output << "{\"seconds\": " << secondsBetween(started, now) << ", \"phase\": \"" << escapeJSON(phaseName) << "\", \"done\": " << itemsDone
+			 << ", \"total\": " << itemsTotal << ", \"etaSeconds\": ";
+	if (itemsDone && itemsDone <= itemsTotal)
+		output << secondsBetween(phaseStarted, now) * static_cast<double>(itemsTotal - itemsDone) / static_cast<double>(itemsDone);
+	else
+		output << "null";
+	output << "}\n";
+	output.flush();
+	lastLine = now.time_since_epoch().count();
+}
+} // namespace
+
+void CK2::Progress::open(const std::string& filePath)
+{
+	const std::lock_guard lock(progressMutex);
+	if (on)
+		return;
+	output.open(filePath, std::ios::trunc);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + filePath);
+	started = phaseStarted = Clock::now();
+	phaseName.clear();
+	done = 0;
+	total = 0;
+	on = true;
+}
+
+void CK2::Progress::close()
+{
+	const std::lock_guard lock(progressMutex);
+	if (!on)
+		return;
+	on = false;
+	output << "{\"seconds\": " << secondsBetween(started, Clock::now()) << ", \"finished\": true}\n";
+	output.close();
+}
+
+void CK2::Progress::phase(const std::string& name)
+{
+	if (!isOpen())
+		return;
+	const std::lock_guard lock(progressMutex);
+	if (!on)
+		return;
+	phaseName = name;
+	phaseStarted = Clock::now();
+	done = 0;
+	total = 0;
+	writeLine(phaseStarted);
+}
+
+void CK2::Progress::expect(const std::size_t items)
+{
+	if (isOpen())
+		total.fetch_add(items, std::memory_order_relaxed);
+}
+
+void CK2::Progress::advance(const std::size_t items)
+{
+	if (!isOpen())
+		return;
+	const auto itemsDone = done.fetch_add(items, std::memory_order_relaxed) + items;
+	const auto now = Clock::now();
+	const auto sinceLastLine = Clock::duration(now.time_since_epoch().count() - lastLine.load(std::memory_order_relaxed));
+	if (itemsDone != total.load(std::memory_order_relaxed) && sinceLastLine < lineInterval)
+		return;
+	const std::lock_guard lock(progressMutex);
+	if (on)
+		writeLine(now);
+}
@@ -0,0 +1,33 @@
+#ifndef CK2_PROGRESS_H
+#define CK2_PROGRESS_H
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace CK2
+{
+// Progress for machines: one JSON object per line, appended and flushed as it happens, so the frontend or a batch
+// runner can tail the file instead of parsing percentages out of the log. Every PhaseTimings phase starts a line of its
+// own; steps that know how much work they hold expect() it and advance() through it, from any thread, and the phase
+// reports done/total and an ETA from its own pace. A conversion that stops writing lines has stalled.
+//   {"seconds": 12.5, "phase": "Linking", "done": 3, "total": 11, "etaSeconds": 20.1}
+// Nothing is written until open().
+class Progress
+{
+  public:
+	static void open(const std::string& filePath);
+	[[nodiscard]] static bool isOpen() { return on.load(std::memory_order_relaxed); }
+	// Writes a last line marking the conversion finished.
+	static void close();
+
+	static void phase(const std::string& name);
+	// More work for the current phase; totals add up when a phase runs several steps.
+	static void expect(std::size_t items);
+	static void advance(std::size_t items = 1);
+
+  private:
+	static std::atomic<bool> on;
+};
+} // namespace CK2
+
+#endif // CK2_PROGRESS_H
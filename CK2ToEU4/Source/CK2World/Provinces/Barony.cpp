@@ -1,25 +1,56 @@
 #include "Barony.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../MemoryCensus.h"
 #include "Log.h"
 #include "ParserHelpers.h"
 
 CK2::Barony::Barony(std::istream& theStream, const std::string& baronyName): name(baronyName)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Barony::registerKeys()
+parsing::KeywordTable<CK2::Barony> CK2::Barony::registerKeys()
 {
-	registerKeyword("type", [this](const std::string& unused, std::istream& theStream) {
+	parsing::KeywordTable<Barony> keywordTable;
+	keywordTable.registerKeyword("type", [](Barony& barony, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString typeStr(theStream);
-		type = typeStr.getString();
+		barony.type = parsing::Symbol(typeStr.getString());
+		barony.holding = holdingOf(barony.type);
 	});
-	registerRegex("(ca|ct|tp|no|tb)_[A-Za-z0-9_-]+", [this](const std::string& building, std::istream& theStream) {
+	keywordTable.registerMatcher(parsing::TokenMatcher::prefixed({"ca_", "ct_", "tp_", "no_", "tb_"}), [](Barony& barony, const std::string& building, std::istream& theStream) {
 		const commonItems::singleString buildingStr(theStream);
 		if (buildingStr.getString() == "yes")
-			buildings.insert(building);
+			++barony.buildingCount;
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
+}
+
+CK2::Barony::HOLDING CK2::Barony::holdingOf(const parsing::Symbol& type)
+{
+	static const parsing::Symbol tribal("tribal");
+	static const parsing::Symbol nomad("nomad");
+	static const parsing::Symbol city("city");
+	static const parsing::Symbol temple("temple");
+	static const parsing::Symbol castle("castle");
+
+	if (type.empty())
+		return HOLDING::NONE;
+	if (type == tribal)
+		return HOLDING::TRIBAL;
+	if (type == nomad)
+		return HOLDING::NOMAD;
+	if (type == city)
+		return HOLDING::CITY;
+	if (type == temple)
+		return HOLDING::TEMPLE;
+	if (type == castle)
+		return HOLDING::CASTLE;
+	return HOLDING::OTHER;
+}
+
+std::size_t CK2::Barony::heapBytes() const
+{
+	return MemoryCensus::heapBytes(name);
 }
@@ -1,25 +1,51 @@
 #ifndef CK2_BARONY_H
 #define CK2_BARONY_H
+#include "../../Parsing/Symbol.h"
 #include "Parser.h"
-#include <set>
+
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
 
 namespace CK2
 {
-class Barony: commonItems::parser
+class Barony
 {
   public:
+	// The holding types development is weighed by. Anything else a mod comes up with is OTHER and weighs nothing.
+	enum class HOLDING
+	{
+		NONE,
+		TRIBAL,
+		NOMAD,
+		CITY,
+		TEMPLE,
+		CASTLE,
+		OTHER
+	};
+	static constexpr std::size_t holdingCount = 7;
+
+	Barony() = default;
 	Barony(std::istream& theStream, const std::string& baronyName);
 
-	[[nodiscard]] auto getBuildingCount() const { return static_cast<int>(buildings.size()); }
+	[[nodiscard]] static HOLDING holdingOf(const parsing::Symbol& type);
+
+	[[nodiscard]] auto getBuildingCount() const { return buildingCount; }
+	[[nodiscard]] std::size_t heapBytes() const; // for MemoryCensus
 	[[nodiscard]] const auto& getName() const { return name; }
 	[[nodiscard]] const auto& getType() const { return type; }
+	[[nodiscard]] auto getHolding() const { return holding; }
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Barony> registerKeys();
 
 	std::string name;
-	std::string type;
-	std::set<std::string> buildings;
+	parsing::Symbol type;
+	HOLDING holding = HOLDING::NONE; // type, sorted once
+	int buildingCount = 0; // buildings built, counted as they're parsed; nothing asks which
 };
 } // namespace CK2
 
@@ -1,76 +1,92 @@
 #include "Province.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../EntityArena.h"
+#include "../MemoryCensus.h"
 #include "../Titles/Title.h"
 #include "Barony.h"
-#include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
 
 CK2::Province::Province(std::istream& theStream, int provID): provinceID(provID)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
+	weighBuildings();
 }
 
-void CK2::Province::registerKeys()
+parsing::KeywordTable<CK2::Province> CK2::Province::registerKeys()
 {
-	registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
+	parsing::KeywordTable<Province> keywordTable;
+	keywordTable.registerKeyword("name", [](Province& province, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString nameStr(theStream);
-		name = nameStr.getString();
+		province.name = nameStr.getString();
 	});
-	registerKeyword("culture", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("culture", [](Province& province, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString cultureStr(theStream);
-		culture = cultureStr.getString();
+		province.culture = parsing::Symbol(cultureStr.getString());
 	});
-	registerKeyword("religion", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("religion", [](Province& province, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString religionStr(theStream);
-		religion = religionStr.getString();
+		province.religion = parsing::Symbol(religionStr.getString());
 	});
-	registerKeyword("primary_settlement", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("primary_settlement", [](Province& province, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString primarySettlementStr(theStream);
-		primarySettlement = std::pair(primarySettlementStr.getString(), nullptr);
+		province.primarySettlement = std::pair(primarySettlementStr.getString(), nullptr);
 	});
-	registerKeyword("max_settlements", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("max_settlements", [](Province& province, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleInt maxSettInt(theStream);
-		maxSettlements = maxSettInt.getInt();
+		province.maxSettlements = maxSettInt.getInt();
 	});
-	registerRegex("b_[A-Za-z0-9_-]+", [this](const std::string& baronyName, std::istream& theStream) {
-		auto barony = std::make_shared<Barony>(theStream, baronyName);
-		baronies.insert(std::pair(baronyName, barony));
+	keywordTable.registerMatcher(parsing::TokenMatcher::prefixed({"b_"}), [](Province& province, const std::string& baronyName, std::istream& theStream) {
+		auto barony = makeEntity<Barony>(theStream, baronyName);
+		province.baronies.insert(std::pair(baronyName, barony));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
-int CK2::Province::getBuildingWeight() const
+void CK2::Province::weighBuildings()
 {
 	// Having a barony counts as 3. Every building level counts as +1.
 	// As this translates to raw dev in province, ownership is not relevant.
 	// TODO: Add trade posts and hospitals.
 
-	int buildingWeight = 0;
+	buildingWeight = 0;
 	for (const auto& barony: baronies)
 	{
 		buildingWeight += 3 + barony.second->getBuildingCount();
 	}
-	return buildingWeight;
 }
 
 std::optional<std::pair<std::string, std::shared_ptr<CK2::Title>>> CK2::Province::belongsToDuchy() const
 {
-	if (deJureTitle.second && deJureTitle.second->getLiege().second && deJureTitle.second->getLiege().second->getTitle().second &&
-		 deJureTitle.second->getLiege().second->getTitle().first.find("d_") == 0)
-		return deJureTitle.second->getLiege().second->getTitle();
+	if (deJureTitle.second && deJureTitle.second->getLiege().second && deJureTitle.second->getLiege().second->getRank() == Title::RANK::DUCHY)
+		return deJureTitle.second->getLiege();
 	else
 		return std::nullopt;
 }
 
 std::optional<std::pair<std::string, std::shared_ptr<CK2::Title>>> CK2::Province::belongsToKingdom() const
 {
-	if (deJureTitle.second && deJureTitle.second->getLiege().second && deJureTitle.second->getLiege().second->getTitle().second &&
-		 deJureTitle.second->getLiege().second->getTitle().second->getLiege().second &&
-		 deJureTitle.second->getLiege().second->getTitle().second->getLiege().second->getTitle().second &&
-		 deJureTitle.second->getLiege().second->getTitle().second->getLiege().second->getTitle().first.find("k_") == 0)
-		return deJureTitle.second->getLiege().second->getTitle().second->getLiege().second->getTitle();
+	if (deJureTitle.second && deJureTitle.second->getLiege().second && deJureTitle.second->getLiege().second->getLiege().second &&
+		 deJureTitle.second->getLiege().second->getLiege().second->getRank() == Title::RANK::KINGDOM)
+		return deJureTitle.second->getLiege().second->getLiege();
 	else
 		return std::nullopt;
-}
\ No newline at end of file
+}
+
+void CK2::Province::unlink()
+{
+	primarySettlement.second.reset();
+	title.second.reset();
+	deJureTitle.second.reset();
+	wonder.reset();
+	monument.reset();
+	baronies.clear();
+}
+
+std::size_t CK2::Province::heapBytes() const
+{
+	return MemoryCensus::heapBytes(name) + MemoryCensus::heapBytes(primarySettlement) + MemoryCensus::heapBytes(title) + MemoryCensus::heapBytes(deJureTitle) +
+			 MemoryCensus::heapBytes(baronies);
+}
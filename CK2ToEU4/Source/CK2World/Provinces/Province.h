@@ -1,13 +1,19 @@
 #ifndef CK2_PROVINCE_H
 #define CK2_PROVINCE_H
+#include "../../Parsing/Symbol.h"
 #include "Parser.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
 class Title;
 class Wonder;
 class Barony;
-class Province: commonItems::parser
+class Province
 {
   public:
 	Province() = default;
@@ -22,13 +28,14 @@ class Province: commonItems::parser
 	[[nodiscard]] const auto& getDeJureTitle() const { return deJureTitle; }
 	[[nodiscard]] const auto& getWonder() const { return wonder; }
 	[[nodiscard]] const auto& getMonument() const { return monument; }
+	[[nodiscard]] std::size_t heapBytes() const; // for MemoryCensus
 
 	[[nodiscard]] auto isDeJureHRE() const { return deJureHRE; }
 	[[nodiscard]] auto getID() const { return provinceID; }
 	[[nodiscard]] auto getMaxSettlements() const { return maxSettlements; }
 	[[nodiscard]] auto getBaronyCount() const { return static_cast<int>(baronies.size()); }
 
-	[[nodiscard]] int getBuildingWeight() const;
+	[[nodiscard]] auto getBuildingWeight() const { return buildingWeight; }
 	[[nodiscard]] std::optional<std::pair<std::string, std::shared_ptr<Title>>> belongsToDuchy() const;	// defacto
 	[[nodiscard]] std::optional<std::pair<std::string, std::shared_ptr<Title>>> belongsToKingdom() const; // defacto
 
@@ -39,15 +46,20 @@ class Province: commonItems::parser
 	void loadWonder(const std::pair<int, std::shared_ptr<Wonder>>& theWonder) { wonder = theWonder; }
 	void loadMonument(const std::pair<int, std::shared_ptr<Wonder>>& theWonder) { monument = theWonder; }
 	void setDeJureHRE() { deJureHRE = true; }
+	void unlink(); // let go of every entity we point at, for the world to come apart
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Province> registerKeys();
+	void weighBuildings();
 
 	bool deJureHRE = false;
 	int provinceID = 0;
 	int maxSettlements = 0;
-	std::string culture;
-	std::string religion;
+	int buildingWeight = 0; // of the baronies, summed once they're in
+	parsing::Symbol culture;
+	parsing::Symbol religion;
 	std::string name;
 	std::pair<std::string, std::shared_ptr<Barony>> primarySettlement;
 	std::pair<std::string, std::shared_ptr<Title>> title;				  // owner title (e_francia or similar)
@@ -1,6 +1,8 @@
 #include "Provinces.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../../Parsing/Win1252.h"
+#include "../EntityArena.h"
 #include "../Titles/Title.h"
-#include "CommonRegexes.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
 #include "ParserHelpers.h"
@@ -8,18 +10,35 @@
 
 CK2::Provinces::Provinces(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
+	indexBaronies();
 }
 
-void CK2::Provinces::registerKeys()
+void CK2::Provinces::indexBaronies()
 {
-	registerRegex(R"(\d+)", [this](const std::string& provID, std::istream& theStream) {
-		auto newProvince = std::make_shared<Province>(theStream, std::stoi(provID));
-		provinces.insert(std::pair(newProvince->getID(), newProvince));
+	baronyIndex.clear();
+	for (const auto& [provinceID, province]: provinces)
+		for (const auto& [baronyName, barony]: province->getBaronies())
+			baronyIndex.emplace(baronyName, BaronyLocation{barony, province});
+}
+
+const CK2::Provinces::BaronyLocation* CK2::Provinces::findBarony(const std::string_view baronyName) const
+{
+	if (const auto& baronyItr = baronyIndex.find(baronyName); baronyItr != baronyIndex.end())
+		return &baronyItr->second;
+	return nullptr;
+}
+
+parsing::KeywordTable<CK2::Provinces> CK2::Provinces::registerKeys()
+{
+	parsing::KeywordTable<Provinces> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Provinces& theProvinces, const std::string& provID, std::istream& theStream) {
+		auto newProvince = makeEntity<Province>(theStream, std::stoi(provID));
+		theProvinces.provinces.insert(std::pair(newProvince->getID(), newProvince));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
 void CK2::Provinces::linkPrimarySettlements()
@@ -72,97 +91,26 @@ void CK2::Provinces::linkWonders(const Wonders& wonders) // No Leviathan DLC
 std::set<std::string> CK2::Provinces::linkMonuments(const Wonders& wonders, const Characters& characters) // Leviathan DLC
 {
 	auto counter = 0;
-	const std::set<std::string> premadeMonuments = {
-		 "wonder_pyramid_giza",
-		 "wonder_pagan_stones_stonehenge",
-		 "wonder_mausoleum_halicarnassus",
-		 "wonder_lighthouse_alexandria",
-		 "wonder_temple_hindu_konark",
-		 "wonder_apostolic_palace",
-		 "wonder_house_of_wisdom",
-		 "wonder_underground_city_petra",
-		 "wonder_cathedral_hagia_sophia",
-		 "wonder_cathedral_notre_dame" // Theses monuments have set definitions already
-	};
+	// The mappings don't change between conversions, so a batch parses them once.
+	static const mappers::MonumentsMapper monumentsMapper;
 
 	std::set<std::string> extantMonuments;
-	const mappers::MonumentsMapper monumentsMapper;
 	for (const auto& wonder: wonders.getWonders())
 	{
 		if (wonder.second)
 		{
 			const auto& monumentName = wonder.second->getType();
-			if (premadeMonuments.contains(monumentName))
+			const auto* rule = monumentsMapper.getMapping(monumentName);
+			const auto premade = rule && rule->isPremade();
+			if (premade)
 				extantMonuments.emplace(monumentName);
-			else if (wonder.second->getUpgrades().size() < 4)
-			{
-				if (monumentName == "wonder_cathedral" || monumentName == "wonder_mosque" || monumentName == "wonder_synagogue" ||
-					 monumentName == "wonder_temple_pagan" || monumentName == "wonder_temple_buddhist" || monumentName == "wonder_temple_hindu")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_religious_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_religious_upgrade_2");
-					wonder.second->addUpgrade("generic_religious_upgrade_3");
-				}
-				else if (monumentName == "wonder_statue_ruler" || monumentName == "wonder_statue_horse")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_statue_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_statue_upgrade_2");
-					wonder.second->addUpgrade("generic_statue_upgrade_3");
-				}
-				else if (monumentName == "wonder_fortress" || monumentName == "wonder_underground_city" || monumentName == "wonder_wall")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_fortification_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_fortification_upgrade_2");
-					wonder.second->addUpgrade("generic_fortification_upgrade_3");
-				}
-				else if (monumentName == "wonder_harbor" || monumentName == "wonder_lighthouse")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_coastal_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_coastal_upgrade_2");
-					wonder.second->addUpgrade("generic_coastal_upgrade_3");
-				}
-				else if (monumentName == "wonder_amphitheater" || monumentName == "wonder_palace" || monumentName == "wonder_garden")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_culture_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_culture_upgrade_2");
-					wonder.second->addUpgrade("generic_culture_upgrade_3");
-				}
-				else if (monumentName == "wonder_university" || monumentName == "wonder_library")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_learning_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_learning_upgrade_2");
-					wonder.second->addUpgrade("generic_learning_upgrade_3");
-				}
-				else if (monumentName == "wonder_mausoleum" || monumentName == "wonder_pyramid" || monumentName == "wonder_pagan_stones" ||
-							monumentName == "wonder_aztec_pyramid")
-				{
-					if (wonder.second->getUpgrades().size() < 2)
-						wonder.second->addUpgrade("generic_misc_upgrade_1");
-					if (wonder.second->getUpgrades().size() < 3)
-						wonder.second->addUpgrade("generic_misc_upgrade_2");
-					wonder.second->addUpgrade("generic_misc_upgrade_3");
-				}
-			}
-
-			if (wonder.second->getBuilder() > 0)
+			else if (rule && wonder.second->getUpgrades().size() < 4)
 			{
-				if (const auto& builder = characters.getCharacters().find(wonder.second->getBuilder()); builder != characters.getCharacters().end())
-				{
-					wonder.second->setBuilderCulture(builder->second->getCulture());
-					wonder.second->setBuilderReligion(builder->second->getReligion());
-				}
+				// Pads the monument up to tier 3, the last padding upgrade always goes in.
+				const auto& padding = rule->getUpgradePadding();
+				for (std::size_t index = 0; index < padding.size(); ++index)
+					if (index + 1 == padding.size() || wonder.second->getUpgrades().size() < index + 2)
+						wonder.second->addUpgrade(padding[index]);
 			}
 
 			const auto& provinceItr = provinces.find(wonder.second->getProvinceID());
@@ -241,11 +189,21 @@ std::set<std::string> CK2::Provinces::linkMonuments(const Wonders& wonders, cons
 			}
 
 			// Converts name to the proper encoding type
-			wonder.second->setName(commonItems::convertWin1252ToUTF8(wonder.second->getName()));
+			wonder.second->setName(parsing::win1252ToUTF8(wonder.second->getName()));
 
-			// Now we will finish building the monument
-			if (!premadeMonuments.contains(monumentName))
+			// Now we will finish building the monument. Premades are EU4's own and never look at the construction history.
+			if (!premade)
+			{
+				if (wonder.second->getBuilder() > 0)
+				{
+					if (const auto& builder = characters.getCharacters().find(wonder.second->getBuilder()); builder != characters.getCharacters().end())
+					{
+						wonder.second->setBuilderCulture(builder->second->getCulture());
+						wonder.second->setBuilderReligion(builder->second->getReligion());
+					}
+				}
 				buildMonument(monumentsMapper, wonder.second);
+			}
 		}
 		counter++;
 	}
@@ -265,13 +223,13 @@ void CK2::Provinces::buildMonument(const mappers::MonumentsMapper& monumentsMapp
 	{
 		bool addedMod = false;
 
-		if (const auto& upgItr = monumentsMapper.getWonders().find(upgrade); upgItr == monumentsMapper.getWonders().end())
+		const auto* mapping = monumentsMapper.getMapping(upgrade);
+		if (!mapping)
 		{
 			Log(LogLevel::Warning) << "Upgrade " << upgrade << " has no mapping!";
 			continue;
 		}
-
-		auto monumentsMapping = monumentsMapper.getWonders().find(upgrade)->second;
+		const auto& monumentsMapping = *mapping;
 
 		if (!wonder->hasBase() && monumentsMapping.getIsBase())
 			wonder->setBase(true);
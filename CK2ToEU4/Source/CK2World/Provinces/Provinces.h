@@ -6,28 +6,47 @@
 #include "../Wonders/Wonder.h"
 #include "../Wonders/Wonders.h"
 #include "Parser.h"
+#include <string_view>
+#include <unordered_map>
+
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
 
 namespace CK2
 {
+class Barony;
 class Province;
 class Wonders;
-class Provinces: commonItems::parser
+class Provinces
 {
   public:
+	struct BaronyLocation
+	{
+		std::shared_ptr<Barony> barony;
+		std::shared_ptr<Province> province;
+	};
+
 	Provinces() = default;
 	explicit Provinces(std::istream& theStream);
 	[[nodiscard]] const auto& getProvinces() const { return provinces; }
-
+	// Barony by name, across all provinces. Where two provinces claim the same barony, the lower ID has it.
+	[[nodiscard]] const BaronyLocation* findBarony(std::string_view baronyName) const;
 
 	void linkPrimarySettlements();
 	void linkWonders(const Wonders& wonders);																	 // No Leviathan DLC
 	std::set<std::string> linkMonuments(const Wonders& wonders, const Characters& characters); // Leviathan DLC
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Provinces> registerKeys();
 	void buildMonument(const mappers::MonumentsMapper& monumentsMapper, const std::shared_ptr<CK2::Wonder>& wonder);
+	void indexBaronies();
 
 	std::map<int, std::shared_ptr<Province>> provinces;
+	std::unordered_map<std::string_view, BaronyLocation> baronyIndex; // keys point into the provinces' barony maps
 };
 } // namespace CK2
 
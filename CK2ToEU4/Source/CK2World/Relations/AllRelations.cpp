@@ -1,21 +1,51 @@
 #include "AllRelations.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
 #include "ParserHelpers.h"
+#include <algorithm>
+#include <ranges>
 
 CK2::Diplomacy::Diplomacy(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
+	gatherTributaries();
 }
 
-void CK2::Diplomacy::registerKeys()
+parsing::KeywordTable<CK2::Diplomacy> CK2::Diplomacy::registerKeys()
 {
-	registerRegex(R"(diplo_\d+)", [this](const std::string& first, std::istream& theStream) {
+	parsing::KeywordTable<Diplomacy> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::prefixed({"diplo_"}, "0123456789"), [](Diplomacy& theDiplomacy, const std::string& first, std::istream& theStream) {
 		auto newRelations = Relations(theStream, first);
 		const auto pos = first.find('_');
 		const auto firstID = std::stoi(first.substr(pos + 1, first.length()));
-		diplomacy.insert(std::pair(firstID, newRelations));
+		theDiplomacy.diplomacy.insert(std::pair(firstID, newRelations));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
+}
+
+void CK2::Diplomacy::gatherTributaries()
+{
+	// CK2 tributaries are messy: a pairing may sit in either character's block, or both. Either way the tributary
+	// entry names the tributary, so the other side is the overlord.
+	tributaries.clear();
+	for (const auto& relations: diplomacy | std::views::values)
+		for (const auto& relation: relations.getRelations())
+		{
+			const auto autonomous = relation.getTributaryType() == "autonomous_tributary";
+			if (relation.isFirstOverlord())
+				tributaries.emplace_back(TributaryLink{relation.getFirst(), relation.getSecond(), autonomous});
+			else if (relation.isSecondOverlord())
+				tributaries.emplace_back(TributaryLink{relation.getSecond(), relation.getFirst(), autonomous});
+		}
+
+	// Where both blocks carry the pairing, the one seen first stands.
+	const auto byPairing = [](const TributaryLink& lhs, const TributaryLink& rhs) {
+		return std::pair(lhs.overlord, lhs.tributary) < std::pair(rhs.overlord, rhs.tributary);
+	};
+	std::ranges::stable_sort(tributaries, byPairing);
+	const auto duplicates = std::ranges::unique(tributaries, [](const TributaryLink& lhs, const TributaryLink& rhs) {
+		return lhs.overlord == rhs.overlord && lhs.tributary == rhs.tributary;
+	});
+	tributaries.erase(duplicates.begin(), duplicates.end());
 }
@@ -3,19 +3,38 @@
 #include "Parser.h"
 #include "Relations.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
-class Diplomacy: commonItems::parser
+class Diplomacy
 {
   public:
+	// One overlord-tributary pairing, whichever of the two diplo blocks it was recorded in.
+	struct TributaryLink
+	{
+		int overlord = 0;
+		int tributary = 0;
+		bool autonomous = false; // autonomous_tributary, which EU4 gets as a vassal
+	};
+
 	Diplomacy() = default;
 	explicit Diplomacy(std::istream& theStream);
 
 	[[nodiscard]] const auto& getDiplomacy() const { return diplomacy; }
+	[[nodiscard]] const auto& getTributaries() const { return tributaries; }
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Diplomacy> registerKeys();
+	void gatherTributaries();
+
 	std::map<int, Relations> diplomacy; // characterID, their relations
+	std::vector<TributaryLink> tributaries; // by overlord, then tributary, each pairing once
 };
 } // namespace CK2
 
@@ -1,18 +1,19 @@
 #include "Relation.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
 #include "ParserHelpers.h"
 
 CK2::Relation::Relation(std::istream& theStream, const int second): secondCharacterID(second)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Relation::registerKeys()
+parsing::KeywordTable<CK2::Relation> CK2::Relation::registerKeys()
 {
-	registerKeyword("tributary", [this](const std::string& unused, std::istream& theStream) {
-		tributary = Tributary(theStream);
+	parsing::KeywordTable<Relation> keywordTable;
+	keywordTable.registerKeyword("tributary", [](Relation& relation, const std::string& unused, std::istream& theStream) {
+		relation.tributary = Tributary(theStream);
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
@@ -3,9 +3,14 @@
 #include "Parser.h"
 #include "Tributary.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
-class Relation: commonItems::parser
+class Relation
 {
   public:
 	Relation() = default;
@@ -20,7 +25,9 @@ class Relation: commonItems::parser
 	[[nodiscard]] const auto& getTributaryType() const { return tributary.getTributaryType(); }
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Relation> registerKeys();
 
 	int firstCharacterID = 0;
 	int secondCharacterID = 0;
@@ -1,22 +1,23 @@
 #include "Relations.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
 #include "ParserHelpers.h"
 
 CK2::Relations::Relations(std::istream& theStream, std::string first)
 {
 	const auto pos = first.find('_');
-	const auto firstID = std::stoi(first.substr(pos + 1, first.length()));
-	registerKeys(firstID);
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	firstID = std::stoi(first.substr(pos + 1, first.length()));
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Relations::registerKeys(int first)
+parsing::KeywordTable<CK2::Relations> CK2::Relations::registerKeys()
 {
-	registerRegex("\\d+", [this, first](const std::string& second, std::istream& theStream) {
+	parsing::KeywordTable<Relations> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Relations& theRelations, const std::string& second, std::istream& theStream) {
 		auto newRelation = Relation(theStream, std::stoi(second));
-		newRelation.setFirst(first);
-		relations.emplace_back(newRelation);
+		newRelation.setFirst(theRelations.firstID);
+		theRelations.relations.emplace_back(newRelation);
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
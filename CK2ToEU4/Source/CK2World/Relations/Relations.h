@@ -3,9 +3,14 @@
 #include "Parser.h"
 #include "Relation.h"
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
-class Relations: commonItems::parser
+class Relations
 {
   public:
 	Relations() = default;
@@ -14,8 +19,11 @@ class Relations: commonItems::parser
 	[[nodiscard]] const auto& getRelations() const { return relations; }
 
   private:
-	void registerKeys(int first);
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Relations> registerKeys();
 
+	int firstID = 0; // the diplo_<id> these relations hang off
 	std::vector<Relation> relations;
 };
 } // namespace CK2
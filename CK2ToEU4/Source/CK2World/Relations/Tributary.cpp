@@ -1,4 +1,5 @@
 #include "Tributary.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "ParserHelpers.h"
 
@@ -19,5 +20,5 @@ void CK2::Tributary::registerKeys()
 		const commonItems::singleInt tributaryInt(theStream);
 		tributaryID = tributaryInt.getInt();
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
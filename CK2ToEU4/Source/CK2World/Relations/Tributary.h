@@ -14,6 +14,8 @@ class Tributary: commonItems::parser
 	[[nodiscard]] auto getTributaryID() const { return tributaryID; }
 
   private:
+	friend class Snapshot;
+
 	void registerKeys();
 
 	int tributaryID = 0;
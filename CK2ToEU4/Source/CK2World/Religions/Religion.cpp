@@ -1,4 +1,5 @@
 #include "Religion.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "ParserHelpers.h"
 
@@ -15,5 +16,5 @@ void CK2::Religion::registerKeys()
 		const auto featureVector = commonItems::stringList(theStream).getStrings();
 		features = std::vector(featureVector.begin(), featureVector.end());
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
\ No newline at end of file
@@ -14,6 +14,8 @@ class Religions: commonItems::parser
 	[[nodiscard]] const auto& getReformedReligion() const { return reformedReligions; }
 
   private:
+	friend class Snapshot;
+
 	void registerKeys();
 
 	std::map<std::string, std::vector<std::string>> reformedReligions;
@@ -0,0 +1,263 @@
+#include "RemoteCache.h"
+#include "Hmac.h"
+#include "Log.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+#ifdef _WIN32
+#include <winsock2.h>
+
+#include <ws2tcpip.h> // after winsock2.h
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr auto retryDelay = std::chrono::minutes(1);
+constexpr int timeoutSeconds = 30;
+constexpr std::size_t minimumKeySize = 16;
+constexpr std::size_t signatureSize = std::tuple_size_v<CK2::Sha256Digest>;
+
+// The name goes into the signature too, so a good entry can't be served up under another entry's name.
+CK2::Sha256Digest sign(const std::string& key, const std::string& name, const std::string_view bytes)
+{
+	auto message = name;
+	message += '\0';
+	message.append(bytes);
+	return CK2::hmacSha256(key, message);
+}
+
+#ifdef _WIN32
+using Socket = SOCKET;
+constexpr Socket invalidSocket = INVALID_SOCKET;
+void closeSocket(const Socket socket)
+{
+	closesocket(socket);
+}
+void setTimeouts(const Socket socket)
+{
+	const DWORD milliseconds = timeoutSeconds * 1000;
+	setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&milliseconds), sizeof milliseconds);
+	setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&milliseconds), sizeof milliseconds);
+}
+#else
+using Socket = int;
+constexpr Socket invalidSocket = -1;
+void closeSocket(const Socket socket)
+{
+	close(socket);
+}
+void setTimeouts(const Socket socket)
+{
+	const timeval timeout{timeoutSeconds, 0};
+	setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+	setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+}
+#endif
+
+bool sendAll(const Socket socket, const std::string_view bytes)
+{
+	for (std::size_t sent = 0; sent < bytes.size();)
+	{
+		const auto chunk = send(socket, bytes.data() + sent, static_cast<int>(std::min<std::size_t>(bytes.size() - sent, 1 << 20)), 0);
+		if (chunk <= 0)
+			return false;
+		sent += static_cast<std::size_t>(chunk);
+	}
+	return true;
+}
+
+std::string lowered(std::string text)
+{
+	std::ranges::transform(text, text.begin(), [](const unsigned char character) {
+		return static_cast<char>(std::tolower(character));
+	});
+	return text;
+}
+
+// Nothing if the body is cut short or the chunks don't add up.
+std::optional<std::string> unchunk(const std::string_view chunked)
+{
+	std::string body;
+	std::size_t position = 0;
+	while (true)
+	{
+		const auto lineEnd = chunked.find("\r\n", position);
+		if (lineEnd == std::string_view::npos)
+			return std::nullopt;
+		std::size_t length = 0;
+		try
+		{
+			length = std::stoull(std::string(chunked.substr(position, lineEnd - position)), nullptr, 16);
+		}
+		catch (std::exception&)
+		{
+			return std::nullopt;
+		}
+		position = lineEnd + 2;
+		if (!length)
+			return body;
+		if (chunked.size() - position < length + 2)
+			return std::nullopt;
+		body.append(chunked.substr(position, length));
+		position += length + 2;
+	}
+}
+} // namespace
+
+CK2::RemoteCache::RemoteCache(const std::string& theUrl, std::string theKey): url(theUrl), key(std::move(theKey))
+{
+	constexpr std::string_view scheme = "http://";
+	if (key.size() < minimumKeySize)
+		throw std::invalid_argument("The farm cache at " + url + " needs a remote_cache_key of at least " + std::to_string(minimumKeySize) +
+											 " characters, the same on every machine, to sign its entries with.");
+	if (!url.starts_with(scheme))
+		throw std::invalid_argument("The farm cache needs an http:// URL, not " + url + ".");
+	const auto authority = url.substr(scheme.size(), url.find('/', scheme.size()) - scheme.size());
+	if (authority.empty())
+		throw std::invalid_argument("The farm cache URL " + url + " names no host.");
+	if (url.size() > scheme.size() + authority.size())
+		prefix = url.substr(scheme.size() + authority.size());
+	while (prefix.ends_with('/'))
+		prefix.pop_back();
+	const auto colon = authority.rfind(':');
+	host = authority.substr(0, colon);
+	if (colon != std::string::npos)
+		port = authority.substr(colon + 1);
+
+#ifdef _WIN32
+	WSADATA winsock;
+	if (WSAStartup(MAKEWORD(2, 2), &winsock))
+		throw std::runtime_error("Could not start Winsock for the farm cache.");
+#endif
+}
+
+CK2::RemoteCache::~RemoteCache()
+{
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+std::optional<std::string> CK2::RemoteCache::get(const std::string& name) const
+{
+	auto response = exchange("GET", name, {});
+	if (!response || response->status != 200)
+		return std::nullopt;
+	auto& body = response->body;
+	const auto bytes = std::string_view(body).substr(0, body.size() - std::min(body.size(), signatureSize));
+	if (body.size() < signatureSize || !sameDigest(sign(key, name, bytes), std::string_view(body).substr(bytes.size())))
+	{
+		Log(LogLevel::Warning) << "The farm cache at " << url << " handed back " << name << " without a good signature, building locally.";
+		return std::nullopt;
+	}
+	body.resize(bytes.size());
+	return std::move(body);
+}
+
+bool CK2::RemoteCache::put(const std::string& name, const std::string_view bytes) const
+{
+	const auto signature = sign(key, name, bytes);
+	std::string signedBytes(bytes);
+	signedBytes.append(reinterpret_cast<const char*>(signature.data()), signature.size());
+	const auto response = exchange("PUT", name, signedBytes);
+	if (response && (response->status < 200 || response->status >= 300))
+		Log(LogLevel::Warning) << "The farm cache at " << url << " turned down " << name << " with status " << response->status << ".";
+	return response && response->status >= 200 && response->status < 300;
+}
+
+std::optional<CK2::RemoteCache::Response> CK2::RemoteCache::exchange(const std::string& method, const std::string& name, const std::string_view body) const
+{
+	const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+	if (now < retryAt)
+		return std::nullopt;
+	const auto giveUp = [this](const std::string& reason) -> std::optional<Response> {
+		Log(LogLevel::Warning) << "The farm cache at " << url << " " << reason << ", building locally for a minute.";
+		retryAt = (std::chrono::steady_clock::now() + retryDelay).time_since_epoch().count();
+		return std::nullopt;
+	};
+
+	addrinfo hints{};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* addresses = nullptr;
+	if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses))
+		return giveUp("can't be resolved");
+	auto socketHandle = invalidSocket;
+	for (const auto* address = addresses; address; address = address->ai_next)
+	{
+		socketHandle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+		if (socketHandle == invalidSocket)
+			continue;
+		setTimeouts(socketHandle);
+		if (!connect(socketHandle, address->ai_addr, static_cast<int>(address->ai_addrlen)))
+			break;
+		closeSocket(socketHandle);
+		socketHandle = invalidSocket;
+	}
+	freeaddrinfo(addresses);
+	if (socketHandle == invalidSocket)
+		return giveUp("can't be reached");
+
+	// One request per connection, and the server's closing it ends the response.
+	auto head = method + " " + prefix + "/" + name + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n";
+	if (method == "PUT")
+		head += "Content-Type: application/octet-stream\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+	head += "\r\n";
+	std::string raw;
+	if (sendAll(socketHandle, head) && sendAll(socketHandle, body))
+	{
+		char buffer[65536];
+		while (true)
+		{
+			const auto received = recv(socketHandle, buffer, sizeof buffer, 0);
+			if (received <= 0)
+				break;
+			raw.append(buffer, static_cast<std::size_t>(received));
+		}
+	}
+	closeSocket(socketHandle);
+
+	const auto headEnd = raw.find("\r\n\r\n");
+	if (!raw.starts_with("HTTP/1.") || raw.size() < 12 || headEnd == std::string::npos)
+		return giveUp("sent no usable response");
+	const auto headers = lowered(raw.substr(0, headEnd));
+	const std::string_view rest = std::string_view(raw).substr(headEnd + 4);
+	Response response;
+	std::optional<std::size_t> length;
+	try
+	{
+		response.status = std::stoi(raw.substr(9, 3));
+		if (const auto lengthAt = headers.find("\r\ncontent-length:"); lengthAt != std::string::npos)
+			length = std::stoull(headers.substr(lengthAt + 17));
+	}
+	catch (std::exception&)
+	{
+		return giveUp("sent no usable response");
+	}
+
+	if (headers.find("\r\ntransfer-encoding: chunked") != std::string::npos)
+	{
+		auto unchunked = unchunk(rest);
+		if (!unchunked)
+			return giveUp("cut a response short");
+		response.body = std::move(*unchunked);
+	}
+	else if (length)
+	{
+		if (rest.size() < *length)
+			return giveUp("cut a response short");
+		response.body = rest.substr(0, *length);
+	}
+	else
+	{
+		response.body = rest;
+	}
+	return response;
+}
@@ -0,0 +1,55 @@
+#ifndef CK2_REMOTE_CACHE_H
+#define CK2_REMOTE_CACHE_H
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace CK2
+{
+// An object store shared by a conversion farm, behind the CacheStore: whole objects fetched with GET and stored with
+// PUT under a base URL. An S3-style bucket open to the farm, nginx with WebDAV or a bazel-remote all do.
+//
+// The transport is plain http:// and anyone on the path, or with write access to the store, can hand back whatever
+// they like. So every object goes up with an HMAC-SHA256 over its name and bytes under a key the whole farm is
+// configured with (remote_cache_key), and an object that comes back without a good one is a miss. That keeps forged
+// and swapped entries out, not eyes: the store and the wire still see the entries in the clear, so keep it on the
+// farm's own network all the same.
+//
+// Nothing here throws once constructed. A store that can't be reached is skipped for a minute at a time, and every
+// failure reads as a miss, which the caller answers by building locally.
+class RemoteCache
+{
+  public:
+	// Throws unless the URL is http://host[:port][/prefix] and there is a key to sign with.
+	RemoteCache(const std::string& url, std::string key);
+	~RemoteCache();
+	RemoteCache(const RemoteCache&) = delete;
+	RemoteCache& operator=(const RemoteCache&) = delete;
+
+	// The object's bytes, or nothing if the store doesn't have it, can't be asked or hands back one we didn't sign.
+	[[nodiscard]] std::optional<std::string> get(const std::string& name) const;
+	// False if the store didn't take it.
+	bool put(const std::string& name, std::string_view bytes) const;
+
+	[[nodiscard]] const auto& getUrl() const { return url; }
+
+  private:
+	struct Response
+	{
+		int status = 0;
+		std::string body;
+	};
+	[[nodiscard]] std::optional<Response> exchange(const std::string& method, const std::string& name, std::string_view body) const;
+
+	std::string url;
+	std::string key;
+	std::string host;
+	std::string port = "80";
+	std::string prefix; // the URL's path, without a trailing slash
+	mutable std::atomic<std::int64_t> retryAt = 0; // steady clock ticks before which the store isn't asked again
+};
+} // namespace CK2
+
+#endif // CK2_REMOTE_CACHE_H
@@ -0,0 +1,272 @@
+#include "BinarySave.h"
+#include "Log.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+constexpr std::string_view binaryHeader = "CK2bin";
+
+// The IDs that aren't keywords.
+constexpr std::uint16_t equalsToken = 0x0001;
+constexpr std::uint16_t openToken = 0x0003;
+constexpr std::uint16_t closeToken = 0x0004;
+constexpr std::uint16_t int32Token = 0x000C;
+constexpr std::uint16_t fixed32Token = 0x000D; // thousandths
+constexpr std::uint16_t boolToken = 0x000E;
+constexpr std::uint16_t quotedToken = 0x000F;
+constexpr std::uint16_t uint32Token = 0x0014;
+constexpr std::uint16_t unquotedToken = 0x0017;
+constexpr std::uint16_t fixed64Token = 0x0167; // Q49.15
+constexpr std::uint16_t uint64Token = 0x029C;
+constexpr std::uint16_t int64Token = 0x0317;
+
+// Hours from -5000.1.1 to 0.1.1, on the game's calendar of 365-day years.
+constexpr std::int64_t hoursPerYear = 365 * 24;
+constexpr std::int64_t yearZero = 5000 * hoursPerYear;
+constexpr std::array<int, 12> monthDays = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+// The fields our parsers read as dates, dates whether or not the token table says so.
+constexpr std::array<std::string_view, 5> knownDateFields = {"date", "start_date", "b_d", "d_d", "wonder_historical_event_date"};
+
+class TokenReader
+{
+  public:
+	explicit TokenReader(const std::string_view data): data(data) {}
+
+	[[nodiscard]] bool done() const { return position >= data.size(); }
+
+	template <typename Value> [[nodiscard]] Value read()
+	{
+		need(sizeof(Value));
+		Value value;
+		std::memcpy(&value, data.data() + position, sizeof(Value)); // saves and every target we build for are little-endian
+		position += sizeof(Value);
+		return value;
+	}
+
+	[[nodiscard]] std::string_view readString()
+	{
+		const auto length = read<std::uint16_t>();
+		need(length);
+		const auto text = data.substr(position, length);
+		position += length;
+		return text;
+	}
+
+  private:
+	void need(const std::size_t bytes) const
+	{
+		if (data.size() - position < bytes)
+			throw std::runtime_error("Binary save ends in the middle of a token!");
+	}
+
+	std::string_view data;
+	std::size_t position = 0;
+};
+
+template <typename Integer> void appendInteger(std::string& text, const Integer value)
+{
+	char digits[24];
+	const auto end = std::to_chars(digits, digits + sizeof digits, value).ptr;
+	text.append(digits, end);
+}
+
+void appendFixed(std::string& text, const std::int64_t value, const std::int64_t scale, const int decimals)
+{
+	if (value < 0)
+		text.push_back('-');
+	const auto magnitude = value < 0 ? -value : value;
+	appendInteger(text, magnitude / scale);
+	text.push_back('.');
+	auto fraction = magnitude % scale;
+	// Scaled to the decimals we print, rounding down; Q49.15 has more precision than the text saves show anyway.
+	std::int64_t shown = 0;
+	for (auto decimal = 0; decimal < decimals; ++decimal)
+	{
+		fraction *= 10;
+		shown = shown * 10 + fraction / scale;
+		fraction %= scale;
+	}
+	char digits[24];
+	const auto end = std::to_chars(digits, digits + sizeof digits, shown).ptr;
+	text.append(static_cast<std::size_t>(decimals - (end - digits)), '0');
+	text.append(digits, end);
+}
+
+void appendDate(std::string& text, const std::int64_t hours)
+{
+	const auto sinceYearZero = hours - yearZero;
+	appendInteger(text, sinceYearZero / hoursPerYear);
+	auto day = static_cast<int>(sinceYearZero % hoursPerYear / 24);
+	auto month = 0;
+	while (day >= monthDays[month])
+		day -= monthDays[month++];
+	text.push_back('.');
+	appendInteger(text, month + 1);
+	text.push_back('.');
+	appendInteger(text, day + 1);
+}
+} // namespace
+
+CK2::BinaryTokens::BinaryTokens(std::istream& theStream)
+{
+	std::string line;
+	while (std::getline(theStream, line))
+	{
+		line = line.substr(0, line.find('#'));
+		const auto equals = line.find('=');
+		if (equals == std::string::npos)
+			continue;
+		auto idText = line.substr(0, equals);
+		auto keyword = line.substr(equals + 1);
+		const auto trim = [](std::string& text) {
+			text.erase(0, text.find_first_not_of(" \t\r"));
+			text.erase(text.find_last_not_of(" \t\r") + 1);
+		};
+		trim(idText);
+		trim(keyword);
+		std::string kind;
+		if (const auto space = keyword.find_first_of(" \t"); space != std::string::npos)
+		{
+			kind = keyword.substr(space + 1);
+			keyword.erase(space);
+			trim(kind);
+		}
+		if (idText.empty() || keyword.empty())
+			continue;
+		try
+		{
+			const auto wideID = std::stoul(idText, nullptr, 0);
+			if (wideID > 0xFFFF)
+				throw std::out_of_range(idText);
+			const auto ID = static_cast<std::uint16_t>(wideID);
+			if (!kind.empty() && kind != "date")
+				Log(LogLevel::Warning) << "Binary token " << keyword << " is marked " << kind << ", only date means anything.";
+			if (kind == "date" || std::ranges::find(knownDateFields, keyword) != knownDateFields.end())
+				dateFields.insert(ID);
+			else
+				dateFields.erase(ID);
+			keywords.insert_or_assign(ID, std::move(keyword));
+		}
+		catch (const std::exception&)
+		{
+			Log(LogLevel::Warning) << "Binary token " << idText << " is not a 16-bit ID, skipping it.";
+		}
+	}
+}
+
+CK2::BinaryTokens CK2::BinaryTokens::load(const std::string& filePath)
+{
+	std::ifstream tokenFile(std::filesystem::u8path(filePath));
+	if (!tokenFile.is_open())
+		throw std::runtime_error("Could not open " + filePath + " for reading binary tokens!");
+	return BinaryTokens(tokenFile);
+}
+
+const std::string* CK2::BinaryTokens::find(const std::uint16_t ID) const
+{
+	const auto keywordItr = keywords.find(ID);
+	return keywordItr != keywords.end() ? &keywordItr->second : nullptr;
+}
+
+bool CK2::isBinaryGamestate(const std::string_view gamestate)
+{
+	return gamestate.starts_with(binaryHeader);
+}
+
+std::string CK2::decodeBinaryGamestate(const std::string_view gamestate, const BinaryTokens& tokens)
+{
+	if (!isBinaryGamestate(gamestate))
+		throw std::runtime_error("Not a binary gamestate!");
+
+	// Text runs about twice the size of the tokens it came from.
+	std::string text = "CK2txt";
+	text.reserve(gamestate.size() * 2);
+	TokenReader reader(gamestate.substr(binaryHeader.size()));
+	std::size_t unknownTokens = 0;
+	auto afterEquals = false;
+	std::uint16_t previousID = 0;
+	std::uint16_t field = 0; // the key of the value after an =
+	while (!reader.done())
+	{
+		const auto ID = reader.read<std::uint16_t>();
+		if (ID == equalsToken)
+		{
+			text.push_back('=');
+			afterEquals = true;
+			field = previousID;
+			continue;
+		}
+		previousID = ID;
+		// One token per line, values right after their =.
+		const auto isValue = afterEquals;
+		if (!afterEquals)
+			text.push_back('\n');
+		afterEquals = false;
+
+		switch (ID)
+		{
+			case openToken:
+				text.push_back('{');
+				break;
+			case closeToken:
+				text.push_back('}');
+				break;
+			case int32Token:
+				if (const auto value = reader.read<std::int32_t>(); isValue && tokens.holdsDates(field) && value >= yearZero)
+					appendDate(text, value);
+				else
+					appendInteger(text, value);
+				break;
+			case fixed32Token:
+				appendFixed(text, reader.read<std::int32_t>(), 1000, 3);
+				break;
+			case boolToken:
+				text.append(reader.read<std::uint8_t>() ? "yes" : "no");
+				break;
+			case quotedToken:
+				text.push_back('"');
+				text.append(reader.readString());
+				text.push_back('"');
+				break;
+			case unquotedToken:
+				text.append(reader.readString());
+				break;
+			case uint32Token:
+				appendInteger(text, reader.read<std::uint32_t>());
+				break;
+			case fixed64Token:
+				appendFixed(text, reader.read<std::int64_t>(), 32768, 5);
+				break;
+			case uint64Token:
+				appendInteger(text, reader.read<std::uint64_t>());
+				break;
+			case int64Token:
+				appendInteger(text, reader.read<std::int64_t>());
+				break;
+			default:
+				if (const auto* keyword = tokens.find(ID))
+				{
+					text.append(*keyword);
+				}
+				else
+				{
+					char digits[8];
+					const auto end = std::to_chars(digits, digits + sizeof digits, ID, 16).ptr;
+					text.append("unknown_0x").append(digits, end);
+					++unknownTokens;
+				}
+		}
+	}
+	text.push_back('\n');
+
+	if (unknownTokens)
+		Log(LogLevel::Warning) << unknownTokens << " binary tokens are missing from the token table, their items will be skipped.";
+	return text;
+}
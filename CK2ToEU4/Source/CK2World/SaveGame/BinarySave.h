@@ -0,0 +1,48 @@
+#ifndef CK2_BINARY_SAVE_H
+#define CK2_BINARY_SAVE_H
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace CK2
+{
+// Token ID -> keyword, as read from configurables/ck2_binary_tokens.txt. Each line is "<id> = <keyword>", with the ID
+// in decimal or 0x hex, and "date" after the keyword for fields holding dates; # starts a comment. The fields our
+// parsers read dates from are known to hold them whether marked or not.
+class BinaryTokens
+{
+  public:
+	BinaryTokens() = default;
+	explicit BinaryTokens(std::istream& theStream);
+	// Throws if the file can't be read; an empty table is the caller's to judge.
+	[[nodiscard]] static BinaryTokens load(const std::string& filePath);
+
+	[[nodiscard]] const std::string* find(std::uint16_t ID) const;
+	[[nodiscard]] bool holdsDates(const std::uint16_t ID) const { return dateFields.contains(ID); }
+	[[nodiscard]] bool empty() const { return keywords.empty(); }
+	[[nodiscard]] std::size_t size() const { return keywords.size(); }
+
+  private:
+	std::unordered_map<std::uint16_t, std::string> keywords;
+	std::unordered_set<std::uint16_t> dateFields;
+};
+
+// Ironman saves store the gamestate as "CK2bin" and a run of binary tokens instead of text. Each token is a
+// little-endian 16-bit ID: a handful stand for =, { and } and for typed values that follow inline (integers,
+// fixed-point numbers, booleans, strings), and every other ID is a keyword from the game's own token list.
+//
+// Our entity parsers and the block loader all read CK2txt, so rather than teach each of them a second format we
+// decode the tokens back into that text in memory, in one linear pass with no lexing, and parse the result in place
+// like an uncompressed save. Nothing goes through an external tool or gets written to disk.
+//
+// The game stores dates as integers, in hours since the start of year -5000, with nothing to tell them from any other
+// integer. Only values of the fields the table knows to hold dates are written out as dates. Tokens missing from the
+// table come out as unknown_0x... keys, which the parsers skip, and are counted in the log.
+[[nodiscard]] bool isBinaryGamestate(std::string_view gamestate);
+[[nodiscard]] std::string decodeBinaryGamestate(std::string_view gamestate, const BinaryTokens& tokens);
+} // namespace CK2
+
+#endif // CK2_BINARY_SAVE_H
@@ -0,0 +1,248 @@
+#include "BlockLoader.h"
+#include "../../Parsing/ItemSkipper.h"
+#include "../CacheStore.h"
+#include "../Concurrency.h"
+#include "../Progress.h"
+#include "../Trace.h"
+#include "SaveBuffer.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+bool isSpace(const char c)
+{
+	return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+} // namespace
+
+void CK2::BlockLoader::defer(const std::string& blockName, std::istream& theStream, std::function<void(std::istream&)> loader)
+{
+	deferRaw(blockName, theStream, [loader = std::move(loader)](const std::string_view block) {
+		SaveBuffer blockBuffer(block.data(), block.size());
+		std::istream blockStream(&blockBuffer);
+		loader(blockStream);
+	});
+}
+
+void CK2::BlockLoader::deferRaw(const std::string& blockName, std::istream& theStream, std::function<void(std::string_view)> loader)
+{
+	// Same block twice? Let the first one finish so they don't race on the same target.
+	if (const auto& pending = pendingBlocks.find(blockName); pending != pendingBlocks.end())
+	{
+		pending->second.get();
+		pendingBlocks.erase(pending);
+	}
+
+	if (digesting)
+	{
+		// A block given twice is parsed both times: the last one parsed is what stands, so skipping either could be wrong.
+		const auto repeated = !handedOut.insert(blockName).second;
+		loader = [this, blockName, repeated, loader = std::move(loader)](const std::string_view block) {
+			const auto digest = repeated ? std::string() : CacheStore::digest(block);
+			const auto previous = previousDigests.find(blockName);
+			const auto unchanged = !digest.empty() && previous != previousDigests.end() && previous->second == digest;
+			{
+				const std::lock_guard lock(digestsMutex);
+				digests[blockName] = digest;
+				if (unchanged)
+					reused.insert(blockName);
+				else
+					reused.erase(blockName);
+			}
+			if (!unchanged)
+				loader(block);
+		};
+	}
+
+	Progress::expect(1);
+	if (saveData)
+	{
+		const auto position = static_cast<std::size_t>(theStream.tellg());
+		const auto length = measureItem(saveData + position, saveSize - position);
+		theStream.seekg(static_cast<std::streamoff>(position + length));
+		const auto* blockStart = saveData + position;
+		pendingBlocks.emplace(blockName, std::async(Concurrency::launchPolicy(), Concurrency::carry([blockName, blockStart, length, loader = std::move(loader)] {
+			const TraceSpan span("Parsing " + blockName);
+			loader(std::string_view(blockStart, length));
+			Progress::advance();
+		})));
+	}
+	else
+	{
+		auto block = readItem(theStream);
+		pendingBlocks.emplace(blockName, std::async(Concurrency::launchPolicy(), Concurrency::carry([blockName, block = std::move(block), loader = std::move(loader)] {
+			const TraceSpan span("Parsing " + blockName);
+			loader(std::string_view(block));
+			Progress::advance();
+		})));
+	}
+}
+
+void CK2::BlockLoader::wait()
+{
+	// Collect everyone before rethrowing, no thread may outlive the data it's parsing. Deferred blocks (a serial
+	// Concurrency) are parsed right here, in whatever order that asks for.
+	std::vector<std::future<void>*> blocks;
+	for (auto& block: pendingBlocks)
+		blocks.emplace_back(&block.second);
+	Concurrency::shuffle(blocks);
+
+	std::exception_ptr error;
+	for (auto* block: blocks)
+	{
+		try
+		{
+			block->get();
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+	pendingBlocks.clear();
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void CK2::BlockLoader::reuseUnchanged(std::map<std::string, std::string> previous)
+{
+	digesting = true;
+	previousDigests = std::move(previous);
+}
+
+std::size_t CK2::BlockLoader::measureItem(const char* data, const std::size_t size)
+{
+	return parsing::ItemSkipper::measure(std::string_view(data, size));
+}
+
+std::string CK2::BlockLoader::readItem(std::istream& theStream)
+{
+	// Same shape as measureItem, but we can't look ahead in a stream so we copy as we go.
+	std::string item;
+	auto* buffer = theStream.rdbuf();
+	using traits = std::char_traits<char>;
+
+	auto ch = buffer->sgetc();
+	while (ch != traits::eof() && isSpace(traits::to_char_type(ch)))
+	{
+		item.push_back(traits::to_char_type(buffer->sbumpc()));
+		ch = buffer->sgetc();
+	}
+	if (ch == '=')
+	{
+		item.push_back(traits::to_char_type(buffer->sbumpc()));
+		ch = buffer->sgetc();
+	}
+	while (ch != traits::eof() && isSpace(traits::to_char_type(ch)))
+	{
+		item.push_back(traits::to_char_type(buffer->sbumpc()));
+		ch = buffer->sgetc();
+	}
+	if (ch == traits::eof())
+	{
+		theStream.setstate(std::ios_base::eofbit);
+		return item;
+	}
+
+	if (ch != '{')
+	{
+		if (ch == '"')
+		{
+			item.push_back(traits::to_char_type(buffer->sbumpc()));
+			while ((ch = buffer->sbumpc()) != traits::eof())
+			{
+				item.push_back(traits::to_char_type(ch));
+				if (ch == '"')
+					break;
+			}
+			return item;
+		}
+		while (ch != traits::eof() && !isSpace(traits::to_char_type(ch)) && ch != '}')
+		{
+			item.push_back(traits::to_char_type(buffer->sbumpc()));
+			ch = buffer->sgetc();
+		}
+		return item;
+	}
+
+	auto depth = 0;
+	auto inQuotes = false;
+	while ((ch = buffer->sbumpc()) != traits::eof())
+	{
+		const auto c = traits::to_char_type(ch);
+		item.push_back(c);
+		if (c == '"')
+			inQuotes = !inQuotes;
+		else if (inQuotes)
+			continue;
+		else if (c == '{')
+			++depth;
+		else if (c == '}' && --depth == 0)
+			return item;
+	}
+	theStream.setstate(std::ios_base::eofbit);
+	return item;
+}
+
+std::vector<std::string_view> CK2::BlockLoader::splitEntries(const std::string_view block, const std::size_t shardCount)
+{
+	std::vector<std::string_view> shards;
+	const auto opening = block.find('{');
+	if (opening == std::string_view::npos)
+		return shards;
+
+	const auto* data = block.data();
+	const auto size = block.size();
+	const auto target = std::max<std::size_t>(1, (size - opening) / std::max<std::size_t>(1, shardCount));
+	auto position = opening + 1;
+	auto shardStart = position;
+	auto entryEnd = position;
+
+	while (position < size)
+	{
+		while (position < size && isSpace(data[position]))
+			++position;
+		if (position >= size || data[position] == '}')
+			break;
+
+		// key, then whatever value hangs off it.
+		while (position < size && !isSpace(data[position]) && data[position] != '=' && data[position] != '{' && data[position] != '}')
+			++position;
+		position += measureItem(data + position, size - position);
+		entryEnd = position;
+
+		if (entryEnd - shardStart >= target && shards.size() + 1 < shardCount)
+		{
+			shards.emplace_back(data + shardStart, entryEnd - shardStart);
+			shardStart = entryEnd;
+		}
+	}
+	if (entryEnd > shardStart)
+		shards.emplace_back(data + shardStart, entryEnd - shardStart);
+	return shards;
+}
+
+parsing::Generator<CK2::BlockLoader::Entry> CK2::BlockLoader::entriesOf(const std::string_view entries)
+{
+	const auto* data = entries.data();
+	const auto size = entries.size();
+	std::size_t position = 0;
+
+	while (position < size)
+	{
+		while (position < size && isSpace(data[position]))
+			++position;
+		if (position >= size || data[position] == '}')
+			break;
+
+		const auto keyStart = position;
+		while (position < size && !isSpace(data[position]) && data[position] != '=' && data[position] != '{' && data[position] != '}')
+			++position;
+		const auto key = std::string_view(data + keyStart, position - keyStart);
+		const auto itemLength = measureItem(data + position, size - position);
+		co_yield Entry{key, std::string_view(data + position, itemLength)};
+		position += itemLength;
+	}
+}
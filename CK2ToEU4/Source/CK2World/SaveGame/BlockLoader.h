@@ -0,0 +1,70 @@
+#ifndef CK2_BLOCK_LOADER_H
+#define CK2_BLOCK_LOADER_H
+#include "../../Parsing/Generator.h"
+#include <functional>
+#include <future>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+// Hands top-level gamestate blocks (characters, titles, provinces...) off to worker threads.
+// The main parser only brace-matches past each block and keeps going, while the block itself
+// is parsed concurrently with everything else.
+class BlockLoader
+{
+  public:
+	// A "key = item" entry as the walkers below hand it out, both views into the text walked.
+	struct Entry
+	{
+		std::string_view key;
+		std::string_view item; // "= { ... }" or "= value", with whatever spacing the save has
+	};
+
+	// When the gamestate lives in memory (a mapped save) blocks are parsed in place, otherwise they're copied out of the stream.
+	void setSource(const char* theSaveData, const std::size_t theSaveSize)
+	{
+		saveData = theSaveData;
+		saveSize = theSaveSize;
+	}
+	void defer(const std::string& blockName, std::istream& theStream, std::function<void(std::istream&)> loader);
+	// For loaders that want to carve up the raw block themselves. The view stays valid until wait() returns.
+	void deferRaw(const std::string& blockName, std::istream& theStream, std::function<void(std::string_view)> loader);
+	void wait();
+
+	// From here on every block is digested as it's handed out, and one that digests the same as in previous (a
+	// campaign's last save, see Snapshot::Campaign) skips its loader, keeping whatever the caller restored for it.
+	void reuseUnchanged(std::map<std::string, std::string> previous);
+	// Digests of the blocks handed out so far, and which of them were left alone. Complete once wait() returns.
+	[[nodiscard]] const auto& getDigests() const { return digests; }
+	[[nodiscard]] const auto& getReused() const { return reused; }
+
+	// Returns how many bytes, from the current position, the next item ("= { ... }" or "= value") spans.
+	[[nodiscard]] static std::size_t measureItem(const char* data, std::size_t size);
+	[[nodiscard]] static std::string readItem(std::istream& theStream);
+	// Splits the entries of a "= { key = {...} key = {...} }" block into at most shardCount runs of whole entries.
+	[[nodiscard]] static std::vector<std::string_view> splitEntries(std::string_view block, std::size_t shardCount);
+	// The entries of a run of "key = item" entries (a shard from splitEntries), found without tokenizing, each as it's
+	// pulled; a consumer that stops pulling stops the walk.
+	[[nodiscard]] static parsing::Generator<Entry> entriesOf(std::string_view entries);
+
+  private:
+	const char* saveData = nullptr;
+	std::size_t saveSize = 0;
+	std::map<std::string, std::future<void>> pendingBlocks;
+
+	bool digesting = false;
+	std::map<std::string, std::string> previousDigests; // read-only while blocks parse
+	std::set<std::string> handedOut;
+	std::mutex digestsMutex;
+	std::map<std::string, std::string> digests;
+	std::set<std::string> reused;
+};
+} // namespace CK2
+
+#endif // CK2_BLOCK_LOADER_H
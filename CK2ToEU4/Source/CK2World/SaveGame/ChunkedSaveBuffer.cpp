@@ -0,0 +1,93 @@
+#include "ChunkedSaveBuffer.h"
+#include <algorithm>
+
+CK2::ChunkedSaveBuffer::ChunkedSaveBuffer(const std::size_t maxQueuedBytes): maxQueuedBytes(maxQueuedBytes)
+{
+}
+
+bool CK2::ChunkedSaveBuffer::push(const char* data, const std::size_t size)
+{
+	std::unique_lock lock(mutex);
+	condition.wait(lock, [this] {
+		return queuedBytes < maxQueuedBytes || abandoned;
+	});
+	if (abandoned)
+		return false;
+
+	// Inflaters hand us small pieces; glue them into larger chunks so underflow() copies less putback.
+	if (chunks.empty() || chunks.back().size() >= chunkSize)
+	{
+		chunks.emplace_back();
+		chunks.back().reserve(chunkSize);
+	}
+	chunks.back().append(data, size);
+	queuedBytes += size;
+	lock.unlock();
+	condition.notify_all();
+	return true;
+}
+
+void CK2::ChunkedSaveBuffer::finish()
+{
+	{
+		std::lock_guard lock(mutex);
+		finished = true;
+	}
+	condition.notify_all();
+}
+
+void CK2::ChunkedSaveBuffer::fail(const std::exception_ptr& theError)
+{
+	{
+		std::lock_guard lock(mutex);
+		error = theError;
+		finished = true;
+	}
+	condition.notify_all();
+}
+
+void CK2::ChunkedSaveBuffer::abandon()
+{
+	{
+		std::lock_guard lock(mutex);
+		abandoned = true;
+		chunks.clear();
+		queuedBytes = 0;
+	}
+	condition.notify_all();
+}
+
+void CK2::ChunkedSaveBuffer::rethrowIfFailed() const
+{
+	if (error)
+		std::rethrow_exception(error);
+}
+
+CK2::ChunkedSaveBuffer::int_type CK2::ChunkedSaveBuffer::underflow()
+{
+	if (gptr() < egptr())
+		return traits_type::to_int_type(*gptr());
+
+	std::unique_lock lock(mutex);
+	condition.wait(lock, [this] {
+		return !chunks.empty() || finished || abandoned;
+	});
+	if (chunks.empty())
+		return traits_type::eof();
+
+	auto next = std::move(chunks.front());
+	chunks.pop_front();
+	queuedBytes -= next.size();
+	lock.unlock();
+	condition.notify_all();
+
+	const auto keep = std::min(putbackSize, static_cast<std::size_t>(gptr() - eback()));
+	std::string buffer;
+	buffer.reserve(keep + next.size());
+	buffer.append(gptr() - keep, keep);
+	buffer.append(next);
+	current = std::move(buffer);
+
+	setg(current.data(), current.data() + keep, current.data() + current.size());
+	return traits_type::to_int_type(*gptr());
+}
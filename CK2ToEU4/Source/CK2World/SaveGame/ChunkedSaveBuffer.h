@@ -0,0 +1,48 @@
+#ifndef CK2_CHUNKED_SAVE_BUFFER_H
+#define CK2_CHUNKED_SAVE_BUFFER_H
+#include "../../Parsing/ScannableBuffer.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+
+namespace CK2
+{
+// Stream buffer fed from another thread, chunk by chunk. The zip inflater pushes decompressed
+// gamestate into it while the parser reads from the other end, so we never hold the whole
+// inflated save in memory and parsing overlaps with decompression.
+class ChunkedSaveBuffer: public parsing::ScannableBuffer
+{
+  public:
+	explicit ChunkedSaveBuffer(std::size_t maxQueuedBytes = 32 * 1024 * 1024);
+
+	// Producer side. push() blocks while the queue is full and returns false once the reader is gone.
+	bool push(const char* data, std::size_t size);
+	void finish();
+	void fail(const std::exception_ptr& theError);
+
+	// Consumer side.
+	void abandon();
+	void rethrowIfFailed() const;
+
+  protected:
+	int_type underflow() override;
+
+  private:
+	static constexpr std::size_t chunkSize = 1024 * 1024;
+	static constexpr std::size_t putbackSize = 64 * 1024; // parser ungets tokens, keep some history across chunks.
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::string> chunks;
+	std::size_t queuedBytes = 0;
+	std::size_t maxQueuedBytes = 0;
+	bool finished = false;
+	bool abandoned = false;
+	std::exception_ptr error;
+	std::string current;
+};
+} // namespace CK2
+
+#endif // CK2_CHUNKED_SAVE_BUFFER_H
@@ -0,0 +1,155 @@
+#include "EntityQuery.h"
+#include "../Characters/Character.h"
+#include "../Provinces/Province.h"
+#include "../Titles/Title.h"
+#include "SaveIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+// The entity's item, "=\n\t{ ... }", if the index has it.
+std::optional<std::string_view> itemOf(const std::string_view gamestate, const CK2::SaveIndex& index, const std::string_view block, const std::string& key)
+{
+	const auto span = index.find(block, key);
+	if (!span)
+		return std::nullopt;
+	return CK2::SaveIndex::textOf(gamestate, *span).substr(key.size());
+}
+
+std::shared_ptr<CK2::Character> decodeCharacter(const std::string_view gamestate, const CK2::SaveIndex& index, const int charID)
+{
+	const auto item = itemOf(gamestate, index, "character", std::to_string(charID));
+	if (!item)
+		return nullptr;
+	auto character = std::make_shared<CK2::Character>(*item, charID, nullptr);
+	character->decode();
+	return character;
+}
+
+std::shared_ptr<CK2::Title> decodeTitle(const std::string_view gamestate, const CK2::SaveIndex& index, const std::string& name)
+{
+	const auto item = itemOf(gamestate, index, "title", name);
+	if (!item)
+		return nullptr;
+	std::istringstream theStream{std::string(*item)};
+	return std::make_shared<CK2::Title>(theStream, name);
+}
+
+std::shared_ptr<CK2::Province> decodeProvince(const std::string_view gamestate, const CK2::SaveIndex& index, const int provID)
+{
+	const auto item = itemOf(gamestate, index, "provinces", std::to_string(provID));
+	if (!item)
+		return nullptr;
+	std::istringstream theStream{std::string(*item)};
+	return std::make_shared<CK2::Province>(theStream, provID);
+}
+
+std::string describe(const CK2::Character& character)
+{
+	auto description = "character " + std::to_string(character.getID()) + ": " + character.getName() + ", born " + character.getBirthDate().toString();
+	if (!character.isAlive())
+		description += ", died " + character.getDeathDate().toString();
+	if (character.getDynasty().first)
+		description += ", dynasty " + std::to_string(character.getDynasty().first);
+	if (!character.getCulture().empty())
+		description += ", " + character.getCulture().str();
+	if (!character.getReligion().empty())
+		description += ", " + character.getReligion().str();
+	if (!character.getPrimaryTitle().first.empty())
+		description += ", holds " + character.getPrimaryTitle().first;
+	return description;
+}
+
+std::string describe(const CK2::Title& title)
+{
+	auto description = "title " + title.getName();
+	if (!title.getDisplayName().empty())
+		description += " (" + title.getDisplayName() + ")";
+	description += title.getHolder().first ? ", held by " + std::to_string(title.getHolder().first) : ", unheld";
+	if (!title.getLiege().first.empty())
+		description += ", liege " + title.getLiege().first;
+	if (!title.getDeJureLiege().first.empty())
+		description += ", de jure liege " + title.getDeJureLiege().first;
+	return description;
+}
+
+std::string describe(const CK2::Province& province)
+{
+	auto description = "province " + std::to_string(province.getID()) + ": " + province.getName();
+	if (!province.getCulture().empty())
+		description += ", " + province.getCulture().str();
+	if (!province.getReligion().empty())
+		description += ", " + province.getReligion().str();
+	description += ", " + std::to_string(province.getBaronyCount()) + " of " + std::to_string(province.getMaxSettlements()) + " settlements";
+	return description;
+}
+
+int numericKey(const std::string& key)
+{
+	if (key.empty() || !std::ranges::all_of(key, [](const unsigned char c) { return std::isdigit(c); }))
+		throw std::runtime_error("Characters and provinces go by number, not " + key + ".");
+	return std::stoi(key);
+}
+
+// The line for an entity one level down: what it is to the queried one, then its own description.
+template <typename Entity> std::string linked(const std::string& role, const std::string& key, const std::shared_ptr<Entity>& entity)
+{
+	return "\t" + role + ": " + (entity ? describe(*entity) : key + " (not in the save)");
+}
+} // namespace
+
+std::vector<std::string> CK2::queryEntity(const std::string_view gamestate, const SaveIndex& index, const std::string_view kind, const std::string& key)
+{
+	std::vector<std::string> lines;
+	if (kind == "character")
+	{
+		const auto character = decodeCharacter(gamestate, index, numericKey(key));
+		if (!character)
+			throw std::runtime_error("There is no character " + key + " in the save.");
+		lines.emplace_back(describe(*character));
+		const auto linkCharacter = [&](const std::string& role, const int charID) {
+			if (charID)
+				lines.emplace_back(linked(role, std::to_string(charID), decodeCharacter(gamestate, index, charID)));
+		};
+		linkCharacter("father", character->getFather().first);
+		linkCharacter("mother", character->getMother().first);
+		for (const auto& spouseID: character->getSpouses() | std::views::keys)
+			linkCharacter("spouse", spouseID);
+		linkCharacter("liege", character->getLiege().first);
+		if (const auto& primaryTitle = character->getPrimaryTitle().first; !primaryTitle.empty())
+			lines.emplace_back(linked("primary title", primaryTitle, decodeTitle(gamestate, index, primaryTitle)));
+	}
+	else if (kind == "title")
+	{
+		const auto title = decodeTitle(gamestate, index, key);
+		if (!title)
+			throw std::runtime_error("There is no title " + key + " in the save.");
+		lines.emplace_back(describe(*title));
+		if (const auto holderID = title->getHolder().first)
+			lines.emplace_back(linked("holder", std::to_string(holderID), decodeCharacter(gamestate, index, holderID)));
+		if (const auto& liege = title->getLiege().first; !liege.empty())
+			lines.emplace_back(linked("liege", liege, decodeTitle(gamestate, index, liege)));
+		if (const auto& deJureLiege = title->getDeJureLiege().first; !deJureLiege.empty())
+			lines.emplace_back(linked("de jure liege", deJureLiege, decodeTitle(gamestate, index, deJureLiege)));
+	}
+	else if (kind == "province")
+	{
+		const auto province = decodeProvince(gamestate, index, numericKey(key));
+		if (!province)
+			throw std::runtime_error("There is no province " + key + " in the save.");
+		lines.emplace_back(describe(*province));
+		for (const auto& barony: province->getBaronies() | std::views::keys)
+			lines.emplace_back(linked(barony == province->getPrimarySettlement().first ? "primary settlement" : "settlement", barony, decodeTitle(gamestate, index, barony)));
+	}
+	else
+	{
+		throw std::runtime_error("Only characters, titles and provinces can be queried, not " + std::string(kind) + ".");
+	}
+	return lines;
+}
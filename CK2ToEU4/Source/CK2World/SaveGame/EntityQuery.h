@@ -0,0 +1,20 @@
+#ifndef CK2_ENTITY_QUERY_H
+#define CK2_ENTITY_QUERY_H
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+class SaveIndex;
+
+// One character, title or province of an uncompressed save, found through the save's SaveIndex and decoded by the
+// same parsers a conversion uses, without reading anything else of the save. The entities it points at (a
+// character's parents, spouses, liege and primary title, a title's holder and lieges, a province's settlements) are
+// decoded as well, one level deep, and get a line each under the entity's own.
+//
+// kind is character, title or province; throws if the save has no such entity.
+[[nodiscard]] std::vector<std::string> queryEntity(std::string_view gamestate, const SaveIndex& index, std::string_view kind, const std::string& key);
+} // namespace CK2
+
+#endif // CK2_ENTITY_QUERY_H
@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+#include "OSCompatibilityLayer.h"
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CK2::MappedFile::MappedFile(const std::string& filePath)
+{
+#ifdef _WIN32
+	const auto widePath = commonItems::convertUTF8ToUTF16(filePath);
+	const auto file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Could not open " + filePath + " for mapping.");
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		close();
+		throw std::runtime_error("Could not determine size of " + filePath + ".");
+	}
+	mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+	if (!mappedSize)
+	{
+		mappedData = &emptyFile;
+		return;
+	}
+
+	mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle)
+	{
+		close();
+		throw std::runtime_error("Could not map " + filePath + ".");
+	}
+	mappedData = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!mappedData)
+	{
+		close();
+		throw std::runtime_error("Could not map " + filePath + ".");
+	}
+#else
+	const auto descriptor = ::open(filePath.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		throw std::runtime_error("Could not open " + filePath + " for mapping.");
+
+	struct stat fileStat{};
+	if (fstat(descriptor, &fileStat) != 0)
+	{
+		::close(descriptor);
+		throw std::runtime_error("Could not determine size of " + filePath + ".");
+	}
+	mappedSize = static_cast<std::size_t>(fileStat.st_size);
+	if (!mappedSize)
+	{
+		::close(descriptor);
+		mappedData = &emptyFile;
+		return;
+	}
+
+	auto* mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor); // the mapping keeps its own reference to the file.
+	if (mapping == MAP_FAILED)
+	{
+		mappedSize = 0;
+		throw std::runtime_error("Could not map " + filePath + ".");
+	}
+	madvise(mapping, mappedSize, MADV_SEQUENTIAL);
+	mappedData = static_cast<const char*>(mapping);
+#endif
+}
+
+CK2::MappedFile::~MappedFile()
+{
+	close();
+}
+
+CK2::MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+CK2::MappedFile& CK2::MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+	close();
+	mappedData = other.mappedData == &other.emptyFile ? &emptyFile : other.mappedData;
+	mappedSize = other.mappedSize;
+	fileHandle = other.fileHandle;
+	mappingHandle = other.mappingHandle;
+	other.mappedData = nullptr;
+	other.mappedSize = 0;
+	other.fileHandle = nullptr;
+	other.mappingHandle = nullptr;
+	return *this;
+}
+
+void CK2::MappedFile::close()
+{
+	if (mappedData && mappedData != &emptyFile)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mappedData);
+#else
+		munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+	}
+#ifdef _WIN32
+	if (mappingHandle)
+		CloseHandle(mappingHandle);
+	if (fileHandle)
+		CloseHandle(fileHandle);
+#endif
+	mappedData = nullptr;
+	mappedSize = 0;
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+}
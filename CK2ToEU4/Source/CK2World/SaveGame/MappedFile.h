@@ -0,0 +1,35 @@
+#ifndef CK2_MAPPED_FILE_H
+#define CK2_MAPPED_FILE_H
+#include <string>
+
+namespace CK2
+{
+// Read-only memory mapping of a file on disk. Pages are faulted in by the OS as the parser walks
+// the file, so an uncompressed save is never copied into our own heap.
+class MappedFile
+{
+  public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& filePath);
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	[[nodiscard]] const char* data() const { return mappedData; }
+	[[nodiscard]] auto size() const { return mappedSize; }
+	[[nodiscard]] auto isOpen() const { return mappedData != nullptr; }
+
+	void close();
+
+  private:
+	const char* mappedData = nullptr;
+	std::size_t mappedSize = 0;
+	void* fileHandle = nullptr;	 // windows only
+	void* mappingHandle = nullptr; // windows only
+	char emptyFile = 0;				 // zero-length files can't be mapped, we point here instead.
+};
+} // namespace CK2
+
+#endif // CK2_MAPPED_FILE_H
@@ -0,0 +1,39 @@
+#include "SaveBuffer.h"
+
+CK2::SaveBuffer::SaveBuffer(const char* data, const std::size_t size)
+{
+	// streambuf wants mutable pointers but we never write through them.
+	auto* begin = const_cast<char*>(data);
+	setg(begin, begin, begin + size);
+}
+
+CK2::SaveBuffer::pos_type CK2::SaveBuffer::seekoff(const off_type off, const std::ios_base::seekdir dir, const std::ios_base::openmode which)
+{
+	if (!(which & std::ios_base::in))
+		return {off_type(-1)};
+
+	off_type target;
+	if (dir == std::ios_base::beg)
+		target = off;
+	else if (dir == std::ios_base::cur)
+		target = gptr() - eback() + off;
+	else
+		target = egptr() - eback() + off;
+
+	if (target < 0 || target > egptr() - eback())
+		return {off_type(-1)};
+
+	setg(eback(), eback() + target, egptr());
+	return {target};
+}
+
+CK2::SaveBuffer::pos_type CK2::SaveBuffer::seekpos(const pos_type pos, const std::ios_base::openmode which)
+{
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+std::streamsize CK2::SaveBuffer::showmanyc()
+{
+	const auto remaining = egptr() - gptr();
+	return remaining > 0 ? remaining : -1;
+}
@@ -0,0 +1,21 @@
+#ifndef CK2_SAVE_BUFFER_H
+#define CK2_SAVE_BUFFER_H
+#include "../../Parsing/ScannableBuffer.h"
+
+namespace CK2
+{
+// Read-only stream buffer over memory we don't own (a mapped save or an inflated gamestate).
+// Lets the parser read the save in place instead of copying it into an istringstream.
+class SaveBuffer: public parsing::ScannableBuffer
+{
+  public:
+	SaveBuffer(const char* data, std::size_t size);
+
+  protected:
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+	std::streamsize showmanyc() override;
+};
+} // namespace CK2
+
+#endif // CK2_SAVE_BUFFER_H
@@ -0,0 +1,151 @@
+#include "SaveIndex.h"
+#include "../CacheStore.h"
+#include "BlockLoader.h"
+#include "Log.h"
+#include "SaveInspector.h"
+#include <algorithm>
+#include <ostream>
+#include <ranges>
+#include <stdexcept>
+
+namespace
+{
+// Bump whenever the index writes anything differently.
+const std::string saveIndexFormat = "save index 1";
+
+std::string storeKey(const std::string& saveHash)
+{
+	return saveIndexFormat + "|" + saveHash;
+}
+} // namespace
+
+void CK2::SaveIndex::Span::writeCompiled(mappers::CompiledConfigurables::Writer& writer) const
+{
+	writer.put(offset);
+	writer.put(bytes);
+}
+
+void CK2::SaveIndex::Span::readCompiled(mappers::CompiledConfigurables::Reader& reader)
+{
+	reader.get(offset);
+	reader.get(bytes);
+}
+
+void CK2::SaveIndex::Item::writeCompiled(mappers::CompiledConfigurables::Writer& writer) const
+{
+	writer.put(key);
+	writer.put(span);
+}
+
+void CK2::SaveIndex::Item::readCompiled(mappers::CompiledConfigurables::Reader& reader)
+{
+	reader.get(key);
+	reader.get(span);
+}
+
+CK2::SaveIndex CK2::SaveIndex::build(const std::string_view gamestate)
+{
+	SaveIndex index;
+	const auto spanOf = [gamestate](const std::string_view key, const std::string_view item) {
+		return Span{static_cast<std::uint64_t>(key.data() - gamestate.data()), static_cast<std::uint64_t>(key.size() + item.size())};
+	};
+
+	for (const auto& [key, item]: topLevelItems(gamestate))
+	{
+		index.blocks.emplace_back(Item{std::string(key), spanOf(key, item)});
+		if (std::ranges::find(indexedBlocks, key) == std::ranges::end(indexedBlocks))
+			continue;
+		const auto opening = item.find('{');
+		if (opening == std::string_view::npos)
+			continue;
+		auto& entries = index.entries[std::string(key)];
+		for (const auto& [entryKey, entryItem]: BlockLoader::entriesOf(item.substr(opening + 1)))
+			entries.emplace_back(Item{std::string(entryKey), spanOf(entryKey, entryItem)});
+	}
+
+	// Sorted for find(); the offsets still tell the save's own order.
+	for (auto& entries: index.entries | std::views::values)
+		std::ranges::stable_sort(entries, std::ranges::less(), &Item::key);
+	return index;
+}
+
+std::optional<CK2::SaveIndex> CK2::SaveIndex::load(const std::string& saveHash)
+{
+	const auto path = CacheStore::pathFor("save_index", saveHash);
+	const auto entry = CacheStore::load(path, storeKey(saveHash));
+	if (!entry)
+		return std::nullopt;
+
+	try
+	{
+		SaveIndex index;
+		mappers::CompiledConfigurables::Reader reader(entry->data(), entry->size());
+		reader.get(index.blocks);
+		reader.get(index.entries);
+		if (!reader.atEnd())
+			throw std::runtime_error("Trailing data after the save index.");
+		return index;
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Save index " << path << " is unusable: " << e.what();
+		return std::nullopt;
+	}
+}
+
+void CK2::SaveIndex::save(const std::string& saveHash) const
+{
+	const auto path = CacheStore::pathFor("save_index", saveHash);
+	try
+	{
+		CacheStore::save(path, storeKey(saveHash), [this](std::ostream& output) {
+			mappers::CompiledConfigurables::Writer writer(output);
+			writer.put(blocks);
+			writer.put(entries);
+		});
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not write " << path << ": " << e.what();
+	}
+}
+
+CK2::SaveIndex CK2::SaveIndex::forSave(const std::string& savePath, const std::string_view gamestate)
+{
+	// The stamp entry only names the save's hash; the index itself stays keyed by contents.
+	const auto stampKey = saveIndexFormat + "|stamp" + mappers::CompiledConfigurables::fingerprint({savePath});
+	const auto stampPath = CacheStore::pathFor("save_index", stampKey);
+	if (const auto stamp = CacheStore::load(stampPath, stampKey))
+		if (auto index = load(std::string(stamp->data(), stamp->size())))
+			return std::move(*index);
+
+	const auto saveHash = CacheStore::digest(gamestate);
+	auto index = load(saveHash);
+	if (!index)
+	{
+		index = build(gamestate);
+		index->save(saveHash);
+	}
+	try
+	{
+		CacheStore::save(stampPath, stampKey, [&saveHash](std::ostream& output) {
+			output << saveHash;
+		});
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not write " << stampPath << ": " << e.what();
+	}
+	return std::move(*index);
+}
+
+std::optional<CK2::SaveIndex::Span> CK2::SaveIndex::find(const std::string_view block, const std::string_view key) const
+{
+	const auto blockEntries = entries.find(std::string(block));
+	if (blockEntries == entries.end())
+		return std::nullopt;
+	const auto entry = std::ranges::lower_bound(blockEntries->second, key, std::ranges::less(), &Item::key);
+	if (entry == blockEntries->second.end() || entry->key != key)
+		return std::nullopt;
+	return entry->span;
+}
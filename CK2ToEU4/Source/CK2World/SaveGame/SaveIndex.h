@@ -0,0 +1,67 @@
+#ifndef CK2_SAVE_INDEX_H
+#define CK2_SAVE_INDEX_H
+#include "../../Mappers/CompiledConfigurables/CompiledConfigurables.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+// Where everything sits in an uncompressed save: every top-level item, and every entry of the character, title and
+// provinces blocks, as byte offsets into the gamestate. The brace-matching pre-scan builds it as it goes and keeps it
+// in the cache store under the save's hash, so whoever looks at the same save again (a re-conversion, --inspect, a
+// campaign's next conversion) can seek straight to any block or entity instead of scanning for it.
+class SaveIndex
+{
+  public:
+	struct Span
+	{
+		std::uint64_t offset = 0; // of the key
+		std::uint64_t bytes = 0;  // key and item, "140=\n\t{ ... }"
+
+		void writeCompiled(mappers::CompiledConfigurables::Writer& writer) const;
+		void readCompiled(mappers::CompiledConfigurables::Reader& reader);
+	};
+	struct Item
+	{
+		std::string key;
+		Span span;
+
+		void writeCompiled(mappers::CompiledConfigurables::Writer& writer) const;
+		void readCompiled(mappers::CompiledConfigurables::Reader& reader);
+	};
+
+	// The blocks whose entries are indexed one by one.
+	static constexpr std::string_view indexedBlocks[] = {"character", "title", "provinces"};
+
+	// Scans the gamestate once, the way inspectGamestate() does.
+	[[nodiscard]] static SaveIndex build(std::string_view gamestate);
+	// The index kept for the save with this hash (Snapshot::hashFile), if there is one.
+	[[nodiscard]] static std::optional<SaveIndex> load(const std::string& saveHash);
+	// Failing to write is only logged: the index is a convenience.
+	void save(const std::string& saveHash) const;
+	// The index of the save at savePath, whose text is gamestate. A save met before is recognized by its size and
+	// modification time, which costs no pass over it; any other is hashed, and indexed unless it already was.
+	[[nodiscard]] static SaveIndex forSave(const std::string& savePath, std::string_view gamestate);
+
+	// The entry of an indexed block ("character", "140"), if the save has it.
+	[[nodiscard]] std::optional<Span> find(std::string_view block, std::string_view key) const;
+	// The text a span covers in the gamestate it was built over.
+	[[nodiscard]] static std::string_view textOf(std::string_view gamestate, const Span& span)
+	{
+		return gamestate.substr(static_cast<std::size_t>(span.offset), static_cast<std::size_t>(span.bytes));
+	}
+
+	[[nodiscard]] const auto& getBlocks() const { return blocks; }
+	[[nodiscard]] const auto& getEntries() const { return entries; }
+
+  private:
+	std::vector<Item> blocks; // in save order, repeated keys (relation, dyn_title) included
+	std::map<std::string, std::vector<Item>> entries; // indexed block -> its entries, sorted by key
+};
+} // namespace CK2
+
+#endif // CK2_SAVE_INDEX_H
@@ -0,0 +1,187 @@
+#include "SaveInspector.h"
+#include "../../Parsing/ByteScan.h"
+#include "../../Parsing/ItemSkipper.h"
+#include "BinarySave.h"
+#include "CommonFunctions.h"
+#include "MappedFile.h"
+#include "SaveIndex.h"
+#include "zip.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+// The value of "= value" or "= \"value\"", without the quotes. Blocks have none.
+std::string_view scalarValue(std::string_view item)
+{
+	const auto* position = parsing::scan::skipSpaces(item.data(), item.data() + item.size());
+	if (position < item.data() + item.size() && *position == '=')
+		position = parsing::scan::skipSpaces(position + 1, item.data() + item.size());
+	item.remove_prefix(static_cast<std::size_t>(position - item.data()));
+	if (item.empty() || item.front() == '{')
+		return {};
+	if (item.front() == '"')
+	{
+		item.remove_prefix(1);
+		if (!item.empty() && item.back() == '"')
+			item.remove_suffix(1);
+	}
+	return item;
+}
+
+bool hasLeadingKeys(const CK2::SaveInspection& inspection)
+{
+	return !inspection.version.empty() && !inspection.date.empty() && !inspection.playerRealm.empty() && !inspection.playerName.empty();
+}
+
+void tallyBlock(CK2::SaveInspection& inspection, const std::string_view name, const std::size_t bytes)
+{
+	auto blockItr = std::ranges::find(inspection.blocks, name, &CK2::SaveInspection::Block::name);
+	if (blockItr == inspection.blocks.end())
+		blockItr = inspection.blocks.insert(inspection.blocks.end(), CK2::SaveInspection::Block{std::string(name)});
+	blockItr->bytes += bytes;
+	++blockItr->count;
+}
+
+// Saves written before the meta entry existed only have the gamestate. Its leading keys sit in the first few
+// kilobytes, so we inflate that much and abort the rest.
+constexpr std::size_t leadingBytes = 64 * 1024;
+
+void inspectCompressedSave(const std::string& savePath, CK2::SaveInspection& inspection)
+{
+	zip_t* zip = zip_open(savePath.c_str(), 0, 'r');
+	if (!zip)
+		throw std::runtime_error("Could not open save! Exiting!");
+
+	std::string gamestateEntry;
+	bool hasMeta = false;
+	const auto entries = zip_entries_total(zip);
+	for (auto i = 0; i < entries; ++i)
+	{
+		zip_entry_openbyindex(zip, i);
+		const std::string name = zip_entry_name(zip);
+		if (getExtension(name) == "ck2")
+		{
+			gamestateEntry = name;
+			inspection.gamestateBytes = static_cast<std::size_t>(zip_entry_size(zip));
+		}
+		else if (name == "meta")
+		{
+			hasMeta = true;
+		}
+		zip_entry_close(zip);
+	}
+
+	std::string leadingText;
+	if (hasMeta && zip_entry_open(zip, "meta") == 0)
+	{
+		void* meta = nullptr;
+		std::size_t metaSize = 0;
+		if (zip_entry_read(zip, &meta, &metaSize) >= 0 && meta)
+			leadingText.assign(static_cast<const char*>(meta), metaSize);
+		std::free(meta);
+		zip_entry_close(zip);
+	}
+	if (leadingText.empty() && !gamestateEntry.empty() && zip_entry_open(zip, gamestateEntry.c_str()) == 0)
+	{
+		const auto onInflate = [](void* arg, auto, const void* data, const size_t size) -> size_t {
+			auto& text = *static_cast<std::string*>(arg);
+			text.append(static_cast<const char*>(data), size);
+			return text.size() < leadingBytes ? size : 0;
+		};
+		(void)zip_entry_extract(zip, onInflate, &leadingText); // aborting early reports failure, we don't mind
+		zip_entry_close(zip);
+	}
+	zip_close(zip);
+
+	if (gamestateEntry.empty())
+		throw std::runtime_error("Unrecognized savegame structure! There is no gamestate in " + savePath + ".");
+	inspection.binary = CK2::isBinaryGamestate(leadingText);
+	if (!inspection.binary)
+		inspectGamestate(leadingText, inspection, false);
+}
+} // namespace
+
+parsing::Generator<CK2::BlockLoader::Entry> CK2::topLevelItems(const std::string_view text)
+{
+	const auto* position = text.data();
+	const auto* const end = text.data() + text.size();
+	while (true)
+	{
+		position = parsing::scan::skipSpaces(position, end);
+		if (position == end)
+			break;
+		if (*position == '#')
+		{
+			position = parsing::scan::find(position, end, '\n');
+			continue;
+		}
+		const auto* const keyEnd = parsing::scan::findWordEnd(position, end);
+		if (keyEnd == position)
+		{
+			// The brace closing CK2txt, or something that isn't a key. Neither is worth a block.
+			++position;
+			continue;
+		}
+		const std::string_view key(position, static_cast<std::size_t>(keyEnd - position));
+		if (key == "CK2txt")
+		{
+			position = keyEnd;
+			continue;
+		}
+
+		const auto itemBytes = parsing::ItemSkipper::measure(std::string_view(keyEnd, static_cast<std::size_t>(end - keyEnd)));
+		co_yield BlockLoader::Entry{key, std::string_view(keyEnd, itemBytes)};
+		position = keyEnd + itemBytes;
+	}
+}
+
+void CK2::inspectGamestate(const std::string_view text, SaveInspection& inspection, const bool measureBlocks)
+{
+	for (const auto& [key, item]: topLevelItems(text))
+	{
+		if (key == "version" && inspection.version.empty())
+			inspection.version = scalarValue(item);
+		else if (key == "date" && inspection.date.empty())
+			inspection.date = scalarValue(item);
+		else if (key == "player_realm" && inspection.playerRealm.empty())
+			inspection.playerRealm = scalarValue(item);
+		else if (key == "player_name" && inspection.playerName.empty())
+			inspection.playerName = scalarValue(item);
+
+		if (measureBlocks)
+			tallyBlock(inspection, key, key.size() + item.size());
+		else if (hasLeadingKeys(inspection))
+			break;
+	}
+}
+
+CK2::SaveInspection CK2::inspectSave(const std::string& savePath, const bool measureBlocks)
+{
+	SaveInspection inspection;
+	MappedFile saveFile(savePath);
+	inspection.fileBytes = saveFile.size();
+	if (saveFile.size() >= 2 && saveFile.data()[0] == 'P' && saveFile.data()[1] == 'K')
+	{
+		saveFile.close();
+		inspection.compressed = true;
+		inspectCompressedSave(savePath, inspection);
+		return inspection;
+	}
+
+	inspection.gamestateBytes = saveFile.size();
+	inspection.binary = isBinaryGamestate(std::string_view(saveFile.data(), saveFile.size()));
+	if (inspection.binary)
+		return inspection;
+	const std::string_view gamestate(saveFile.data(), saveFile.size());
+	inspectGamestate(gamestate, inspection, false);
+	if (!measureBlocks)
+		return inspection;
+
+	// Measuring is what builds the save's index, so a save inspected before is measured from the index it left.
+	const auto index = SaveIndex::forSave(savePath, gamestate);
+	for (const auto& block: index.getBlocks())
+		tallyBlock(inspection, block.key, static_cast<std::size_t>(block.span.bytes));
+	return inspection;
+}
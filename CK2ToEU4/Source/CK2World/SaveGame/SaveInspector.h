@@ -0,0 +1,46 @@
+#ifndef CK2_SAVE_INSPECTOR_H
+#define CK2_SAVE_INSPECTOR_H
+#include "BlockLoader.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CK2
+{
+// What a job needs to know about a save before committing to a conversion: which game version wrote it, when it
+// was saved, who played, and how heavy it is. Nothing is loaded; compressed saves only have their meta entry
+// inflated, and uncompressed saves are mapped and brace-matched, never tokenized.
+struct SaveInspection
+{
+	struct Block
+	{
+		std::string name;
+		std::size_t bytes = 0;
+		std::size_t count = 0; // relation, dyn_title and the like repeat at top level
+	};
+
+	bool compressed = false;
+	bool binary = false; // ironman; only the sizes are known
+	std::size_t fileBytes = 0;
+	std::size_t gamestateBytes = 0; // inflated size for compressed saves
+	std::string version;
+	std::string date;
+	std::string playerRealm;
+	std::string playerName;
+	std::vector<Block> blocks; // top-level items of the gamestate in the order they first appear; empty for compressed saves
+};
+
+// Each top-level key of a gamestate with the item hanging off it ("=\"1066.9.15\"", "=\n{ ... }"), past comments
+// and the CK2txt header, brace-matched as it's pulled.
+[[nodiscard]] parsing::Generator<BlockLoader::Entry> topLevelItems(std::string_view text);
+
+// Compressed saves report the gamestate's inflated size from the zip directory but no blocks; counting those would
+// mean inflating the lot. With measureBlocks off, uncompressed saves are read only until the leading keys are in;
+// with it on, they're measured through the save's SaveIndex, built and kept the first time round.
+[[nodiscard]] SaveInspection inspectSave(const std::string& savePath, bool measureBlocks = true);
+// Same, over gamestate (or meta) text already in memory.
+void inspectGamestate(std::string_view text, SaveInspection& inspection, bool measureBlocks = true);
+} // namespace CK2
+
+#endif // CK2_SAVE_INSPECTOR_H
@@ -0,0 +1,52 @@
+#include "SaveTuning.h"
+#include "SaveInspector.h"
+#include <algorithm>
+#include <ranges>
+
+namespace
+{
+constexpr std::size_t bytesPerThread = 8 * 1024 * 1024;
+constexpr std::size_t lazyCharacterBytes = 32 * 1024 * 1024;
+constexpr std::size_t spilledCharacterBytes = 256 * 1024 * 1024;
+constexpr std::size_t installDataBytes = 768 * 1024 * 1024;
+constexpr std::size_t bytesPerGamestateByte = 4;
+
+std::size_t characterBytes(const CK2::SaveInspection& inspection)
+{
+	if (const auto block = std::ranges::find(inspection.blocks, "character", &CK2::SaveInspection::Block::name); block != inspection.blocks.end())
+		return block->bytes;
+	// Compressed saves don't get their blocks measured. Characters are about a third of a gamestate.
+	return inspection.gamestateBytes / 3;
+}
+} // namespace
+
+CK2::SaveTuning CK2::tuneForSave(const SaveInspection& inspection,
+	 const std::size_t configuredThreads,
+	 const Configuration::CHARACTER_DECODING configuredDecoding,
+	 const std::size_t hardwareThreads)
+{
+	SaveTuning tuning;
+
+	tuning.threads = configuredThreads;
+	if (!tuning.threads)
+		tuning.threads = std::clamp<std::size_t>((inspection.gamestateBytes + bytesPerThread - 1) / bytesPerThread, 1, std::max<std::size_t>(hardwareThreads, 1));
+
+	tuning.characterDecoding = configuredDecoding;
+	if (tuning.characterDecoding == Configuration::CHARACTER_DECODING::AUTO)
+	{
+		const auto bytes = characterBytes(inspection);
+		if (bytes >= spilledCharacterBytes)
+			tuning.characterDecoding = Configuration::CHARACTER_DECODING::SPILLED;
+		else if (bytes >= lazyCharacterBytes)
+			tuning.characterDecoding = Configuration::CHARACTER_DECODING::LAZY;
+		else
+			tuning.characterDecoding = Configuration::CHARACTER_DECODING::EAGER;
+	}
+
+	return tuning;
+}
+
+std::size_t CK2::estimateConversionBytes(const SaveInspection& inspection)
+{
+	return installDataBytes + inspection.gamestateBytes * bytesPerGamestateByte;
+}
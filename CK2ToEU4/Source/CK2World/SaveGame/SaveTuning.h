@@ -0,0 +1,32 @@
+#ifndef CK2_SAVE_TUNING_H
+#define CK2_SAVE_TUNING_H
+#include "../../Configuration/Configuration.h"
+#include <cstddef>
+
+namespace CK2
+{
+struct SaveInspection;
+
+struct SaveTuning
+{
+	std::size_t threads = 1;
+	Configuration::CHARACTER_DECODING characterDecoding = Configuration::CHARACTER_DECODING::LAZY;
+};
+
+// Picks what the configuration left on auto (threads = 0, character decoding AUTO) from a save's inspection; whatever
+// was set explicitly is passed through. Small saves are done parsing before extra threads would pay for starting
+// up, so threads grow with the gamestate's size up to one per core. Character details are decoded up front for small
+// saves, which frees the character block straight after parsing, and only on demand once the block is big enough
+// that decoding the characters pruning throws away costs more than keeping the block around. Past that, megacampaign
+// blocks are spilled to a temp file rather than kept on the heap.
+[[nodiscard]] SaveTuning tuneForSave(const SaveInspection& inspection,
+	 std::size_t configuredThreads,
+	 Configuration::CHARACTER_DECODING configuredDecoding,
+	 std::size_t hardwareThreads);
+// Roughly how much memory converting the save takes at its peak, for deciding how many conversions fit side by side.
+// Whatever the save, the install data takes its share; on top of that the gamestate is held while it parses into
+// entities that take a few times its size again. Errs high rather than low.
+[[nodiscard]] std::size_t estimateConversionBytes(const SaveInspection& inspection);
+} // namespace CK2
+
+#endif // CK2_SAVE_TUNING_H
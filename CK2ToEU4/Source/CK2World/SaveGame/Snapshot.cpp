@@ -0,0 +1,1280 @@
+#include "Snapshot.h"
+#include "../../Parsing/DateScan.h"
+#include "../../Parsing/FlatSet.h"
+#include "../../Parsing/NameMap.h"
+#include "../CacheStore.h"
+#include "../Concurrency.h"
+#include "../Characters/Character.h"
+#include "../Characters/Characters.h"
+#include "../Characters/TraitSet.h"
+#include "../Dynasties/CoatOfArms.h"
+#include "../Dynasties/Dynasties.h"
+#include "../Dynasties/Dynasty.h"
+#include "../EntityArena.h"
+#include "../Flags/Flags.h"
+#include "../Offmaps/Offmap.h"
+#include "../Offmaps/Offmaps.h"
+#include "../Provinces/Barony.h"
+#include "../Provinces/Province.h"
+#include "../Provinces/Provinces.h"
+#include "../Relations/AllRelations.h"
+#include "../Relations/Relation.h"
+#include "../Relations/Relations.h"
+#include "../Relations/Tributary.h"
+#include "../Religions/Religions.h"
+#include "../Titles/Liege.h"
+#include "../Titles/Title.h"
+#include "../Titles/Titles.h"
+#include "../Vars/Vars.h"
+#include "../Wonders/Wonder.h"
+#include "../Wonders/Wonders.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <ranges>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+// The implementation comes with zip.c.
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.h"
+
+namespace
+{
+// Bump whenever anything below writes a field more, less or differently.
+const std::string snapshotFormat = "snapshot 7";
+const std::string campaignFormat = "campaign 1";
+const std::string checkpointFormat = "checkpoint 1";
+
+// Deflate never gets a block much below a thousandth of what it holds; a frame claiming more is corrupted.
+constexpr std::uint64_t maximumInflation = 1032;
+
+std::string storeKey(const std::string& key)
+{
+	return snapshotFormat + "|" + key;
+}
+
+// A checkpoint writes its entities as a snapshot does, so bumping either format retires it.
+std::string checkpointStoreKey(const std::string& key)
+{
+	return checkpointFormat + "|" + storeKey(key);
+}
+
+// What links lead to. Anything else only ever has the one owner that writes it out.
+template <typename T>
+concept Linked = std::same_as<T, CK2::Character> || std::same_as<T, CK2::Dynasty> || std::same_as<T, CK2::Title> || std::same_as<T, CK2::Province> ||
+					  std::same_as<T, CK2::Barony> || std::same_as<T, CK2::Wonder>;
+
+// Deflate at its fastest level: a snapshot is only worth having while loading it beats parsing the save.
+std::string compressFrame(const std::string& frame)
+{
+	if (frame.size() > std::numeric_limits<mz_ulong>::max())
+		throw std::runtime_error("Snapshot frame is too large to compress.");
+	auto compressedSize = mz_compressBound(static_cast<mz_ulong>(frame.size()));
+	std::string compressed(compressedSize, '\0');
+	if (mz_compress2(reinterpret_cast<unsigned char*>(compressed.data()),
+			  &compressedSize,
+			  reinterpret_cast<const unsigned char*>(frame.data()),
+			  static_cast<mz_ulong>(frame.size()),
+			  MZ_BEST_SPEED) != MZ_OK)
+		throw std::runtime_error("Could not compress a snapshot frame.");
+	compressed.resize(compressedSize);
+	return compressed;
+}
+
+std::pair<std::uint64_t, std::string> packFrame(const std::string& frame)
+{
+	return {frame.size(), compressFrame(frame)};
+}
+
+std::unique_ptr<char[]> decompressFrame(const char* compressed, const std::size_t compressedSize, const std::size_t size)
+{
+	if (size > std::numeric_limits<mz_ulong>::max() || compressedSize > std::numeric_limits<mz_ulong>::max())
+		throw std::runtime_error("Snapshot frame is too large to decompress.");
+	auto frame = std::make_unique_for_overwrite<char[]>(size);
+	auto decompressedSize = static_cast<mz_ulong>(size);
+	if (mz_uncompress(reinterpret_cast<unsigned char*>(frame.get()),
+			  &decompressedSize,
+			  reinterpret_cast<const unsigned char*>(compressed),
+			  static_cast<mz_ulong>(compressedSize)) != MZ_OK ||
+		 decompressedSize != size)
+		throw std::runtime_error("Snapshot frame does not decompress.");
+	return frame;
+}
+
+// Waits for every frame before passing on the first failure, the others are still writing into the world.
+template <typename Result> std::vector<Result> collectFrames(std::vector<std::future<Result>>& frames)
+{
+	std::vector<Result> results;
+	std::exception_ptr error;
+	for (auto& frame: frames)
+	{
+		try
+		{
+			results.emplace_back(frame.get());
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+	if (error)
+		std::rethrow_exception(error);
+	return results;
+}
+} // namespace
+
+// A checkpoint's entities, numbered per kind as the writing first meets them, whether as some table's own or as a
+// link's target. Reading hands out one entity per number, the same to every link and to whichever table fills it in.
+// The frames share it, each kind behind a lock of its own.
+class CK2::Snapshot::Graph
+{
+  public:
+	// Writing: the number of a link's target, and of an entity written out in full.
+	template <Linked T> [[nodiscard]] std::uint64_t link(const T* entity) { return number(entity, false); }
+	template <Linked T> [[nodiscard]] std::uint64_t hold(const T* entity) { return number(entity, true); }
+	// Whatever links lead to that no table wrote out, revolts merged into their base titles for one, as kind, number
+	// and entity until a kind of 0. Those can lead to more of the kind, so it goes round until none turn up.
+	void putDetached(Writer& writer);
+
+	// Reading: the entity a link leads to, and the one to fill in.
+	template <Linked T> [[nodiscard]] std::shared_ptr<T> linked(const std::uint64_t ordinal) { return find<T>(ordinal, false); }
+	template <Linked T> [[nodiscard]] std::shared_ptr<T> held(const std::uint64_t ordinal) { return find<T>(ordinal, true); }
+	void getDetached(Reader& reader);
+	// Once every frame is in: whether all the entities links lead to were filled in.
+	[[nodiscard]] bool complete() const
+	{
+		return std::apply(
+			 [](const auto&... kind) {
+				 return (std::ranges::all_of(kind.read | std::views::values, [](const auto& entity) { return entity.second; }) && ...);
+			 },
+			 kinds);
+	}
+
+  private:
+	template <typename T> struct Kind
+	{
+		std::mutex mutex;
+		std::unordered_map<const T*, std::pair<std::uint64_t, bool>> written; // number, and whether written out
+		std::unordered_map<std::uint64_t, std::pair<std::shared_ptr<T>, bool>> read; // entity, and whether filled in
+	};
+
+	template <typename T> std::uint64_t number(const T* entity, const bool hold)
+	{
+		auto& kind = std::get<Kind<T>>(kinds);
+		const std::lock_guard lock(kind.mutex);
+		auto& [ordinal, held] = kind.written.try_emplace(entity, kind.written.size(), false).first->second;
+		held = held || hold;
+		return ordinal;
+	}
+	template <typename T> std::shared_ptr<T> find(const std::uint64_t ordinal, const bool hold)
+	{
+		auto& kind = std::get<Kind<T>>(kinds);
+		const std::lock_guard lock(kind.mutex);
+		auto& [entity, held] = kind.read[ordinal];
+		if (hold && held)
+			throw std::runtime_error("Checkpoint holds an entity twice.");
+		if (!entity)
+			entity = makeEntity<T>();
+		held = held || hold;
+		return entity;
+	}
+	template <typename T> bool putDetachedOf(Writer& writer, std::uint8_t kindTag);
+	template <typename T> void getDetachedOf(Reader& reader);
+
+	std::tuple<Kind<Character>, Kind<Dynasty>, Kind<Title>, Kind<Province>, Kind<Barony>, Kind<Wonder>> kinds;
+};
+
+// Values go out as-is, containers as a count followed by their elements, entities through Snapshot::write.
+// Cross-references are written with putLink/putLinks: only the ID, never the object on the other end. In a
+// checkpoint the ID comes with the graph's number for that object, and entities written out in full with their own.
+class CK2::Snapshot::Writer
+{
+  public:
+	explicit Writer(std::ostream& theStream, Graph* theGraph = nullptr): stream(theStream), graph(theGraph) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> void put(const T value) { stream.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+	void put(const std::string& value)
+	{
+		put(static_cast<std::uint64_t>(value.size()));
+		stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+	}
+	void put(const parsing::Symbol& value) { put(value.str()); }
+	void put(const date& value) { put(value.toString()); }
+	void put(const GameVersion& value) { put(value.toString()); }
+	void put(const commonItems::Color& value)
+	{
+		for (const auto component: value.getRgbComponents())
+			put(component);
+	}
+	template <typename T> requires std::is_class_v<T> void put(const T& entity) { write(*this, entity); }
+	template <typename T> void put(const std::shared_ptr<T>& value)
+	{
+		put(value != nullptr);
+		if (!value)
+			return;
+		if constexpr (Linked<T>)
+			if (graph)
+				put(graph->hold(value.get()));
+		put(*value);
+	}
+	template <typename T> void put(const std::optional<T>& value)
+	{
+		put(value.has_value());
+		if (value)
+			put(*value);
+	}
+	template <typename First, typename Second> void put(const std::pair<First, Second>& value)
+	{
+		put(value.first);
+		put(value.second);
+	}
+	template <typename T> void put(const std::vector<T>& values) { putRange(values); }
+	template <typename T, typename Compare> void put(const std::set<T, Compare>& values) { putRange(values); }
+	template <typename T, typename Compare> void put(const parsing::FlatSet<T, Compare>& values) { putRange(values); }
+	template <typename Key, typename Value> void put(const std::map<Key, Value>& values) { putRange(values); }
+	template <typename Value> void put(const parsing::NameMap<Value>& values) { putRange(values); }
+	void put(const CharacterTable& values) { putRange(values); }
+
+	template <typename Key, typename Target> void putLink(const std::pair<Key, std::shared_ptr<Target>>& link)
+	{
+		put(link.first);
+		if (!graph)
+			return;
+		put(link.second != nullptr);
+		if (link.second)
+			put(graph->link(link.second.get()));
+	}
+	template <typename Key, typename Target> void putLink(const std::optional<std::pair<Key, std::shared_ptr<Target>>>& link)
+	{
+		put(link.has_value());
+		if (link)
+			putLink(*link);
+	}
+	template <typename Key, typename Target> void putLinks(const std::map<Key, std::shared_ptr<Target>>& links)
+	{
+		put(static_cast<std::uint64_t>(links.size()));
+		for (const auto& link: links)
+			putLink(link);
+	}
+	template <typename Key, typename Target> void putLinks(const std::vector<std::pair<Key, std::shared_ptr<Target>>>& links)
+	{
+		put(static_cast<std::uint64_t>(links.size()));
+		for (const auto& link: links)
+			putLink(link);
+	}
+	void putDetached() { graph->putDetached(*this); }
+
+  private:
+	template <typename Range> void putRange(const Range& values)
+	{
+		put(static_cast<std::uint64_t>(values.size()));
+		for (const auto& value: values)
+			put(value);
+	}
+
+	std::ostream& stream;
+	Graph* graph; // checkpoints only
+};
+
+// Mirror of Writer. Running off the end of the data throws, load() turns that into "no usable snapshot".
+class CK2::Snapshot::Reader
+{
+  public:
+	Reader(const char* theData, const std::size_t theSize, Graph* theGraph = nullptr): data(theData), size(theSize), graph(theGraph) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> void get(T& value)
+	{
+		std::memcpy(&value, take(sizeof(T)), sizeof(T));
+	}
+	void get(std::string& value)
+	{
+		const auto length = getCount();
+		const auto* characters = take(length);
+		value.assign(characters, length);
+	}
+	void get(parsing::Symbol& value)
+	{
+		const auto length = getCount();
+		value = parsing::Symbol(std::string_view(take(length), length));
+	}
+	void get(date& value)
+	{
+		std::string dateString;
+		get(dateString);
+		value = parsing::parseDate(dateString);
+	}
+	void get(GameVersion& value)
+	{
+		std::string versionString;
+		get(versionString);
+		value = GameVersion(versionString);
+	}
+	void get(commonItems::Color& value)
+	{
+		std::array<int, 3> components{};
+		for (auto& component: components)
+			get(component);
+		value = commonItems::Color(components);
+	}
+	template <typename T> requires std::is_class_v<T> void get(T& entity) { read(*this, entity); }
+	template <typename T> void get(std::shared_ptr<T>& value)
+	{
+		value.reset();
+		if (!getFlag())
+			return;
+		if constexpr (Linked<T>)
+			if (graph)
+				value = graph->held<T>(getOrdinal());
+		if (!value)
+			value = makeEntity<T>();
+		get(*value);
+	}
+	template <typename T> void get(std::optional<T>& value)
+	{
+		value.reset();
+		if (getFlag())
+		{
+			T newValue{};
+			get(newValue);
+			value = std::move(newValue);
+		}
+	}
+	template <typename First, typename Second> void get(std::pair<First, Second>& value)
+	{
+		get(value.first);
+		get(value.second);
+	}
+	template <typename T> void get(std::vector<T>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+			get(values.emplace_back());
+	}
+	template <typename T, typename Compare> void get(std::set<T, Compare>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			T value{};
+			get(value);
+			values.insert(values.end(), std::move(value));
+		}
+	}
+	template <typename T, typename Compare> void get(parsing::FlatSet<T, Compare>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			T value{};
+			get(value);
+			values.insert(value);
+		}
+	}
+	template <typename Key, typename Value> void get(std::map<Key, Value>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			std::pair<Key, Value> value;
+			get(value);
+			values.insert(values.end(), std::move(value));
+		}
+	}
+	template <typename Value> void get(parsing::NameMap<Value>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			std::pair<std::string, Value> value;
+			get(value);
+			values.emplace_hint(values.end(), std::move(value));
+		}
+	}
+	void get(CharacterTable& values)
+	{
+		std::vector<CharacterTable::value_type> entries;
+		get(entries);
+		values = CharacterTable(std::move(entries));
+	}
+
+	template <typename Key, typename Target> void getLink(std::pair<Key, std::shared_ptr<Target>>& link)
+	{
+		get(link.first);
+		getTarget(link.second);
+	}
+	template <typename Key, typename Target> void getLink(std::optional<std::pair<Key, std::shared_ptr<Target>>>& link)
+	{
+		link.reset();
+		if (getFlag())
+			getLink(link.emplace());
+	}
+	template <typename Key, typename Target> void getLinks(std::map<Key, std::shared_ptr<Target>>& links)
+	{
+		links.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			Key key{};
+			get(key);
+			std::shared_ptr<Target> target;
+			getTarget(target);
+			links.emplace_hint(links.end(), std::move(key), std::move(target));
+		}
+	}
+	template <typename Key, typename Target> void getLinks(std::vector<std::pair<Key, std::shared_ptr<Target>>>& links)
+	{
+		links.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			Key key{};
+			get(key);
+			std::shared_ptr<Target> target;
+			getTarget(target);
+			links.emplace_back(std::move(key), std::move(target));
+		}
+	}
+	void getDetached() { graph->getDetached(*this); }
+
+	[[nodiscard]] bool getFlag()
+	{
+		auto flag = false;
+		get(flag);
+		return flag;
+	}
+	[[nodiscard]] std::size_t getCount()
+	{
+		std::uint64_t count = 0;
+		get(count);
+		// Every element takes at least a byte, anything larger than what's left is a corrupted count.
+		if (count > size - position)
+			throw std::runtime_error("Snapshot is truncated.");
+		return static_cast<std::size_t>(count);
+	}
+	[[nodiscard]] bool atEnd() const { return position == size; }
+	[[nodiscard]] std::size_t remaining() const { return size - position; }
+
+  private:
+	// Outside checkpoints links come back unlinked, for the linking pass to fill in.
+	template <typename Target> void getTarget(std::shared_ptr<Target>& target)
+	{
+		target.reset();
+		if (graph && getFlag())
+			target = graph->linked<Target>(getOrdinal());
+	}
+	[[nodiscard]] std::uint64_t getOrdinal()
+	{
+		std::uint64_t ordinal = 0;
+		get(ordinal);
+		return ordinal;
+	}
+
+	const char* take(const std::size_t length)
+	{
+		if (length > size - position)
+			throw std::runtime_error("Snapshot is truncated.");
+		const auto* taken = data + position;
+		position += length;
+		return taken;
+	}
+
+	const char* data;
+	std::size_t size;
+	std::size_t position = 0;
+	Graph* graph; // checkpoints only
+};
+
+template <typename T> bool CK2::Snapshot::Graph::putDetachedOf(Writer& writer, const std::uint8_t kindTag)
+{
+	std::vector<const T*> detached;
+	{
+		auto& kind = std::get<Kind<T>>(kinds);
+		const std::lock_guard lock(kind.mutex);
+		for (const auto& [entity, numbered]: kind.written)
+			if (!numbered.second)
+				detached.emplace_back(entity);
+	}
+	for (const auto* entity: detached)
+	{
+		writer.put(kindTag);
+		writer.put(hold(entity));
+		writer.put(*entity);
+	}
+	return !detached.empty();
+}
+
+void CK2::Snapshot::Graph::putDetached(Writer& writer)
+{
+	for (auto more = true; more;)
+	{
+		more = putDetachedOf<Character>(writer, 1);
+		more = putDetachedOf<Dynasty>(writer, 2) || more;
+		more = putDetachedOf<Title>(writer, 3) || more;
+		more = putDetachedOf<Province>(writer, 4) || more;
+		more = putDetachedOf<Barony>(writer, 5) || more;
+		more = putDetachedOf<Wonder>(writer, 6) || more;
+	}
+	writer.put(std::uint8_t{0});
+}
+
+template <typename T> void CK2::Snapshot::Graph::getDetachedOf(Reader& reader)
+{
+	std::uint64_t ordinal = 0;
+	reader.get(ordinal);
+	reader.get(*held<T>(ordinal));
+}
+
+void CK2::Snapshot::Graph::getDetached(Reader& reader)
+{
+	std::uint8_t kindTag = 0;
+	for (reader.get(kindTag); kindTag != 0; reader.get(kindTag))
+		switch (kindTag)
+		{
+			case 1:
+				getDetachedOf<Character>(reader);
+				break;
+			case 2:
+				getDetachedOf<Dynasty>(reader);
+				break;
+			case 3:
+				getDetachedOf<Title>(reader);
+				break;
+			case 4:
+				getDetachedOf<Province>(reader);
+				break;
+			case 5:
+				getDetachedOf<Barony>(reader);
+				break;
+			case 6:
+				getDetachedOf<Wonder>(reader);
+				break;
+			default:
+				throw std::runtime_error("Checkpoint holds an entity of no known kind.");
+		}
+}
+
+std::string CK2::Snapshot::hashFile(const std::string& filePath)
+{
+	const MappedFile file(filePath);
+	return CacheStore::digest(std::string_view(file.data(), file.size()));
+}
+
+std::string CK2::Snapshot::makeKey(const std::string& saveHash,
+	 const std::string& converterVersion,
+	 const std::string& CK2Path,
+	 const Mods& mods,
+	 const std::vector<std::string>& options)
+{
+	// Mods and the CK2 install feed dynasties, which are loaded together with the save.
+	auto key = saveHash + "|" + converterVersion + "|" + CK2Path;
+	for (const auto& mod: mods)
+		key += "|" + mod.name + "=" + mod.path;
+	for (const auto& option: options)
+		key += "|" + option;
+	return key;
+}
+
+void CK2::Snapshot::save(const std::string& snapshotPath, const std::string& key, const State& state)
+{
+	store(snapshotPath, storeKey(key), writeFrames(state, nullptr));
+}
+
+bool CK2::Snapshot::load(const std::string& snapshotPath, const std::string& key, const State& state)
+{
+	return restore(snapshotPath, storeKey(key), state, nullptr);
+}
+
+void CK2::Snapshot::saveCheckpoint(const std::string& checkpointPath, const std::string& key, const State& state, const Built& built)
+{
+	// Which entities no table holds is only known once every link is out, so what the phases add goes last.
+	Graph graph;
+	auto frames = writeFrames(state, &graph);
+	std::ostringstream output;
+	Writer writer(output, &graph);
+	writeBuilt(writer, built);
+	frames.emplace_back(packFrame(std::move(output).str()));
+	store(checkpointPath, checkpointStoreKey(key), frames);
+}
+
+bool CK2::Snapshot::loadCheckpoint(const std::string& checkpointPath, const std::string& key, const State& state, const Built& built)
+{
+	return restore(checkpointPath, checkpointStoreKey(key), state, &built);
+}
+
+CK2::Snapshot::Frames CK2::Snapshot::writeFrames(const State& state, Graph* graph)
+{
+	std::vector<std::future<std::pair<std::uint64_t, std::string>>> framesWritten;
+	for (std::size_t frame = 0; frame < frameCount; ++frame)
+		framesWritten.emplace_back(std::async(Concurrency::launchPolicy(), Concurrency::carry([&state, graph, frame] {
+			std::ostringstream output;
+			Writer writer(output, graph);
+			writeFrame(writer, state, frame);
+			return packFrame(std::move(output).str());
+		})));
+	return collectFrames(framesWritten);
+}
+
+void CK2::Snapshot::store(const std::string& path, const std::string& storeKey, const Frames& frames)
+{
+	CacheStore::save(path, storeKey, [&frames](std::ostream& output) {
+		Writer writer(output);
+		writer.put(static_cast<std::uint64_t>(frames.size()));
+		for (const auto& [size, compressed]: frames)
+		{
+			writer.put(size);
+			writer.put(static_cast<std::uint64_t>(compressed.size()));
+		}
+		for (const auto& compressed: frames | std::views::values)
+			output.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+	});
+}
+
+bool CK2::Snapshot::restore(const std::string& path, const std::string& storeKey, const State& state, const Built* built)
+{
+	const auto entry = CacheStore::load(path, storeKey);
+	if (!entry)
+		return false;
+
+	// Checkpoints have a frame more, for what the phases added.
+	const auto expectedFrames = built ? frameCount + 1 : frameCount;
+	Graph graph;
+	auto* const frameGraph = built ? &graph : nullptr;
+	try
+	{
+		Reader reader(entry->data(), entry->size());
+		std::uint64_t frames = 0;
+		reader.get(frames);
+		if (frames != expectedFrames)
+			throw std::runtime_error("Snapshot has " + std::to_string(frames) + " frames.");
+		// Sizes first, so every frame's start is known before any of them is read.
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> sizes(expectedFrames);
+		for (auto& [size, compressedSize]: sizes)
+		{
+			reader.get(size);
+			reader.get(compressedSize);
+			if (size / maximumInflation > compressedSize)
+				throw std::runtime_error("Snapshot frame claims an impossible size.");
+		}
+		auto offset = entry->size() - reader.remaining();
+		std::vector<std::future<bool>> framesRead;
+		for (std::size_t frame = 0; frame < expectedFrames; ++frame)
+		{
+			const auto [size, compressedSize] = sizes[frame];
+			if (compressedSize > entry->size() - offset)
+				throw std::runtime_error("Snapshot is truncated.");
+			const auto* compressed = entry->data() + offset;
+			offset += compressedSize;
+			framesRead.emplace_back(std::async(Concurrency::launchPolicy(),
+				 Concurrency::carry([&state, built, frameGraph, frame, compressed, compressedSize, size] {
+					 const auto data = decompressFrame(compressed, compressedSize, size);
+					 Reader frameReader(data.get(), size, frameGraph);
+					 if (frame < frameCount)
+						 readFrame(frameReader, state, frame);
+					 else
+						 readBuilt(frameReader, *built);
+					 if (!frameReader.atEnd())
+						 throw std::runtime_error("Trailing data after a snapshot frame.");
+					 return true;
+				 })));
+		}
+		static_cast<void>(collectFrames(framesRead));
+		if (offset != entry->size())
+			throw std::runtime_error("Trailing data after the snapshot.");
+		if (built && !graph.complete())
+			throw std::runtime_error("Checkpoint links to entities it doesn't hold.");
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << (built ? "Checkpoint " : "Snapshot ") << path << " is unusable: " << e.what();
+		return false;
+	}
+	return true;
+}
+
+void CK2::Snapshot::saveCampaign(const std::string& campaignKey, const Campaign& campaign)
+{
+	CacheStore::save(CacheStore::pathFor("campaigns", campaignKey), campaignFormat + "|" + campaignKey, [&campaign](std::ostream& output) {
+		Writer writer(output);
+		writer.put(campaign.saveHash);
+		writer.put(campaign.blockDigests);
+	});
+}
+
+std::optional<CK2::Snapshot::Campaign> CK2::Snapshot::loadCampaign(const std::string& campaignKey)
+{
+	const auto path = CacheStore::pathFor("campaigns", campaignKey);
+	const auto entry = CacheStore::load(path, campaignFormat + "|" + campaignKey);
+	if (!entry)
+		return std::nullopt;
+
+	try
+	{
+		Campaign campaign;
+		Reader reader(entry->data(), entry->size());
+		reader.get(campaign.saveHash);
+		reader.get(campaign.blockDigests);
+		if (!reader.atEnd())
+			throw std::runtime_error("Trailing data after the campaign.");
+		return campaign;
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Campaign " << path << " is unusable: " << e.what();
+		return std::nullopt;
+	}
+}
+
+void CK2::Snapshot::writeFrame(Writer& writer, const State& state, const std::size_t frame)
+{
+	switch (frame)
+	{
+		case 0:
+			writer.put(state.characters);
+			break;
+		case 1:
+			writer.put(state.titles);
+			break;
+		case 2:
+			writer.put(state.provinces);
+			break;
+		case 3:
+			writer.put(state.dynasties);
+			break;
+		case 4:
+			writer.put(state.diplomacy);
+			break;
+		default:
+			writer.put(state.endDate);
+			writer.put(state.startDate);
+			writer.put(state.CK2Version);
+			writer.put(state.wonders);
+			writer.put(state.offmaps);
+			writer.put(state.flags);
+			writer.put(state.vars);
+			writer.put(state.religions);
+			writer.put(state.dynamicTitles);
+	}
+}
+
+void CK2::Snapshot::readFrame(Reader& reader, const State& state, const std::size_t frame)
+{
+	switch (frame)
+	{
+		case 0:
+			reader.get(state.characters);
+			break;
+		case 1:
+			reader.get(state.titles);
+			break;
+		case 2:
+			reader.get(state.provinces);
+			break;
+		case 3:
+			reader.get(state.dynasties);
+			break;
+		case 4:
+			reader.get(state.diplomacy);
+			break;
+		default:
+			reader.get(state.endDate);
+			reader.get(state.startDate);
+			reader.get(state.CK2Version);
+			reader.get(state.wonders);
+			reader.get(state.offmaps);
+			reader.get(state.flags);
+			reader.get(state.vars);
+			reader.get(state.religions);
+			reader.get(state.dynamicTitles);
+	}
+}
+
+void CK2::Snapshot::writeBuilt(Writer& writer, const Built& built)
+{
+	writer.putLinks(built.independentTitles);
+	writer.putLink(built.hreTitle);
+	writer.put(built.leviathanDLC);
+	writer.put(built.existentPremadeMonuments);
+	writer.putDetached();
+}
+
+void CK2::Snapshot::readBuilt(Reader& reader, const Built& built)
+{
+	reader.getLinks(built.independentTitles);
+	reader.getLink(built.hreTitle);
+	reader.get(built.leviathanDLC);
+	reader.get(built.existentPremadeMonuments);
+	reader.getDetached();
+}
+
+void CK2::Snapshot::write(Writer& writer, const Barony& barony)
+{
+	writer.put(barony.name);
+	writer.put(barony.type);
+	writer.put(barony.buildingCount);
+}
+
+void CK2::Snapshot::read(Reader& reader, Barony& barony)
+{
+	reader.get(barony.name);
+	reader.get(barony.type);
+	reader.get(barony.buildingCount);
+	barony.holding = Barony::holdingOf(barony.type);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Character& character)
+{
+	// Snapshots come back fully decoded, they have no block to point into.
+	const auto& details = character.decodeDetails();
+	writer.put(character.charID);
+	writer.put(character.host);
+	writer.put(details.female);
+	writer.put(character.spent);
+	writer.put(details.loan);
+	writer.put(details.piety);
+	writer.put(details.prestige);
+	writer.put(details.wealth);
+	writer.put(details.culture);
+	writer.put(details.religion);
+	writer.put(details.name);
+	writer.put(details.government);
+	writer.put(character.job);
+	writer.put(details.skills.diplomacy);
+	writer.put(details.skills.martial);
+	writer.put(details.skills.stewardship);
+	writer.put(details.skills.intrigue);
+	writer.put(details.skills.learning);
+	writer.put(details.birthDate);
+	writer.put(character.deathDate);
+	writer.putLink(character.dynasty);
+	writer.putLink(character.liege);
+	writer.putLink(character.mother);
+	writer.putLink(character.father);
+	writer.putLinks(character.children);
+	writer.putLink(character.heir);
+	writer.putLinks(character.spouses);
+	writer.put(character.primaryTitle); // the Liege is ours, only what it points to is a link
+	writer.putLink(character.changedPrimaryTitle);
+	writer.putLink(character.capital);
+	writer.putLink(character.capitalProvince);
+	writer.put(details.courtierNames);
+	writer.put(details.traits);
+	writer.putLinks(details.advisers);
+}
+
+void CK2::Snapshot::read(Reader& reader, Character& character)
+{
+	// Read back decoded, so the details come back whole.
+	auto& details = character.ownDetails();
+	reader.get(character.charID);
+	reader.get(character.host);
+	reader.get(details.female);
+	reader.get(character.spent);
+	reader.get(details.loan);
+	reader.get(details.piety);
+	reader.get(details.prestige);
+	reader.get(details.wealth);
+	reader.get(details.culture);
+	reader.get(details.religion);
+	reader.get(details.name);
+	reader.get(details.government);
+	reader.get(character.job);
+	reader.get(details.skills.diplomacy);
+	reader.get(details.skills.martial);
+	reader.get(details.skills.stewardship);
+	reader.get(details.skills.intrigue);
+	reader.get(details.skills.learning);
+	reader.get(details.birthDate);
+	reader.get(character.deathDate);
+	reader.getLink(character.dynasty);
+	reader.getLink(character.liege);
+	reader.getLink(character.mother);
+	reader.getLink(character.father);
+	reader.getLinks(character.children);
+	reader.getLink(character.heir);
+	reader.getLinks(character.spouses);
+	reader.get(character.primaryTitle);
+	reader.getLink(character.changedPrimaryTitle);
+	reader.getLink(character.capital);
+	reader.getLink(character.capitalProvince);
+	reader.get(details.courtierNames);
+	reader.get(details.traits);
+	reader.getLinks(details.advisers);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Characters& characters)
+{
+	writer.put(characters.characters);
+}
+
+void CK2::Snapshot::read(Reader& reader, Characters& characters)
+{
+	reader.get(characters.characters);
+}
+
+void CK2::Snapshot::write(Writer& writer, const CoatOfArms& coatOfArms)
+{
+	writer.put(coatOfArms.religion);
+}
+
+void CK2::Snapshot::read(Reader& reader, CoatOfArms& coatOfArms)
+{
+	reader.get(coatOfArms.religion);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Diplomacy& diplomacy)
+{
+	writer.put(diplomacy.diplomacy);
+}
+
+void CK2::Snapshot::read(Reader& reader, Diplomacy& diplomacy)
+{
+	reader.get(diplomacy.diplomacy);
+	diplomacy.gatherTributaries();
+}
+
+void CK2::Snapshot::write(Writer& writer, const Dynasties& dynasties)
+{
+	// Snapshots load without the install data, so the base's dynasties go in with the save's.
+	if (!dynasties.base)
+	{
+		writer.put(dynasties.dynasties);
+		return;
+	}
+	auto merged = dynasties.base->dynasties;
+	for (const auto& [dynID, dynasty]: dynasties.dynasties)
+		merged.insert_or_assign(dynID, dynasty);
+	writer.put(merged);
+}
+
+void CK2::Snapshot::read(Reader& reader, Dynasties& dynasties)
+{
+	reader.get(dynasties.dynasties);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Dynasty& dynasty)
+{
+	writer.put(dynasty.dynID);
+	writer.put(dynasty.culture);
+	writer.put(dynasty.religion);
+	writer.put(dynasty.name);
+	writer.put(dynasty.coa);
+}
+
+void CK2::Snapshot::read(Reader& reader, Dynasty& dynasty)
+{
+	reader.get(dynasty.dynID);
+	reader.get(dynasty.culture);
+	reader.get(dynasty.religion);
+	reader.get(dynasty.name);
+	reader.get(dynasty.coa);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Flags& flags)
+{
+	writer.put(flags.greekReformation);
+	writer.put(flags.flags);
+}
+
+void CK2::Snapshot::read(Reader& reader, Flags& flags)
+{
+	reader.get(flags.greekReformation);
+	reader.get(flags.flags);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Liege& liege)
+{
+	writer.put(liege.dynamic);
+	writer.put(liege.custom);
+	writer.putLink(liege.title);
+	writer.putLink(liege.baseTitle);
+}
+
+void CK2::Snapshot::read(Reader& reader, Liege& liege)
+{
+	reader.get(liege.dynamic);
+	reader.get(liege.custom);
+	reader.getLink(liege.title);
+	reader.getLink(liege.baseTitle);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Offmap& offmap)
+{
+	writer.put(offmap.type);
+	writer.putLink(offmap.holder);
+	writer.put(offmap.name);
+}
+
+void CK2::Snapshot::read(Reader& reader, Offmap& offmap)
+{
+	reader.get(offmap.type);
+	reader.getLink(offmap.holder);
+	reader.get(offmap.name);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Offmaps& offmaps)
+{
+	writer.put(offmaps.offmaps);
+}
+
+void CK2::Snapshot::read(Reader& reader, Offmaps& offmaps)
+{
+	reader.get(offmaps.offmaps);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Province& province)
+{
+	writer.put(province.deJureHRE);
+	writer.put(province.provinceID);
+	writer.put(province.maxSettlements);
+	writer.put(province.culture);
+	writer.put(province.religion);
+	writer.put(province.name);
+	writer.putLink(province.primarySettlement);
+	writer.putLink(province.title);
+	writer.putLink(province.deJureTitle);
+	writer.putLink(province.wonder);
+	writer.putLink(province.monument);
+	writer.put(province.baronies);
+}
+
+void CK2::Snapshot::read(Reader& reader, Province& province)
+{
+	reader.get(province.deJureHRE);
+	reader.get(province.provinceID);
+	reader.get(province.maxSettlements);
+	reader.get(province.culture);
+	reader.get(province.religion);
+	reader.get(province.name);
+	reader.getLink(province.primarySettlement);
+	reader.getLink(province.title);
+	reader.getLink(province.deJureTitle);
+	reader.getLink(province.wonder);
+	reader.getLink(province.monument);
+	reader.get(province.baronies);
+	province.weighBuildings();
+}
+
+void CK2::Snapshot::write(Writer& writer, const Provinces& provinces)
+{
+	writer.put(provinces.provinces);
+}
+
+void CK2::Snapshot::read(Reader& reader, Provinces& provinces)
+{
+	reader.get(provinces.provinces);
+	provinces.indexBaronies();
+}
+
+void CK2::Snapshot::write(Writer& writer, const Relation& relation)
+{
+	writer.put(relation.firstCharacterID);
+	writer.put(relation.secondCharacterID);
+	writer.put(relation.tributary);
+}
+
+void CK2::Snapshot::read(Reader& reader, Relation& relation)
+{
+	reader.get(relation.firstCharacterID);
+	reader.get(relation.secondCharacterID);
+	reader.get(relation.tributary);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Relations& relations)
+{
+	writer.put(relations.firstID);
+	writer.put(relations.relations);
+}
+
+void CK2::Snapshot::read(Reader& reader, Relations& relations)
+{
+	reader.get(relations.firstID);
+	reader.get(relations.relations);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Religions& religions)
+{
+	writer.put(religions.reformedReligions);
+}
+
+void CK2::Snapshot::read(Reader& reader, Religions& religions)
+{
+	reader.get(religions.reformedReligions);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Title& title)
+{
+	writer.put(title.inHRE);
+	writer.put(title.HREEmperor);
+	writer.put(title.thePope);
+	writer.put(title.theFraticelliPope);
+	writer.put(title.majorRevolt);
+	writer.put(title.electorate);
+	writer.put(title.name);
+	const auto& details = title.getDetails();
+	writer.put(details.displayName);
+	writer.put(details.genderLaw);
+	writer.put(details.successionLaw);
+	writer.put(details.color);
+	writer.put(details.laws);
+	writer.put(title.electors);
+	writer.putLinks(title.provinces);
+	writer.putLinks(title.deJureProvinces);
+	writer.putLinks(title.vassals);
+	writer.putLinks(title.deJureVassals);
+	writer.put(title.previousHolderIDs);
+	writer.putLinks(title.generatedVassals);
+	writer.putLink(title.holder);
+	writer.putLink(title.liege);
+	writer.putLink(title.deJureLiege);
+	writer.putLink(title.baseTitle);
+	writer.put(title.baseTitleBase);
+	writer.putLink(title.generatedLiege);
+	// tagCountry is assigned by the EU4 side, it's never set this early.
+}
+
+void CK2::Snapshot::read(Reader& reader, Title& title)
+{
+	reader.get(title.inHRE);
+	reader.get(title.HREEmperor);
+	reader.get(title.thePope);
+	reader.get(title.theFraticelliPope);
+	reader.get(title.majorRevolt);
+	reader.get(title.electorate);
+	reader.get(title.name);
+	title.rank = Title::rankOf(title.name);
+	Title::Details details;
+	reader.get(details.displayName);
+	reader.get(details.genderLaw);
+	reader.get(details.successionLaw);
+	reader.get(details.color);
+	reader.get(details.laws);
+	if (!details.displayName.empty() || !details.genderLaw.empty() || !details.successionLaw.empty() || details.color || !details.laws.empty())
+		title.details = std::make_unique<Title::Details>(std::move(details));
+	reader.get(title.electors);
+	reader.getLinks(title.provinces);
+	reader.getLinks(title.deJureProvinces);
+	reader.getLinks(title.vassals);
+	reader.getLinks(title.deJureVassals);
+	reader.get(title.previousHolderIDs);
+	reader.getLinks(title.generatedVassals);
+	reader.getLink(title.holder);
+	reader.getLink(title.liege);
+	reader.getLink(title.deJureLiege);
+	reader.getLink(title.baseTitle);
+	reader.get(title.baseTitleBase);
+	reader.getLink(title.generatedLiege);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Titles& titles)
+{
+	writer.put(titles.titles);
+}
+
+void CK2::Snapshot::read(Reader& reader, Titles& titles)
+{
+	reader.get(titles.titles);
+}
+
+void CK2::Snapshot::write(Writer& writer, const TraitSet& traits)
+{
+	writer.put(traits.getIDs());
+}
+
+void CK2::Snapshot::read(Reader& reader, TraitSet& traits)
+{
+	std::vector<int> traitIDs;
+	reader.get(traitIDs);
+	traits = TraitSet();
+	for (const auto traitID: traitIDs)
+		traits.insert(traitID);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Tributary& tributary)
+{
+	writer.put(tributary.tributaryID);
+	writer.put(tributary.tributaryType);
+}
+
+void CK2::Snapshot::read(Reader& reader, Tributary& tributary)
+{
+	reader.get(tributary.tributaryID);
+	reader.get(tributary.tributaryType);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Vars& vars)
+{
+	writer.put(vars.vars);
+}
+
+void CK2::Snapshot::read(Reader& reader, Vars& vars)
+{
+	reader.get(vars.vars);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Wonder& wonder)
+{
+	wonder.decode(); // snapshots come back fully decoded, they have no block to point into.
+	writer.put(wonder.wonderID);
+	writer.put(wonder.stage);
+	writer.put(wonder.provinceID);
+	writer.put(wonder.builderID);
+	writer.put(wonder.binaryDate);
+	writer.put(wonder.base);
+	writer.put(wonder.active);
+	writer.put(wonder.spent);
+	writer.put(wonder.type);
+	writer.put(wonder.name);
+	writer.put(wonder.desc);
+	writer.put(wonder.trueDate);
+	writer.put(wonder.canBeMoved);
+	writer.put(wonder.builderCulture);
+	writer.put(wonder.builderReligion);
+	writer.put(wonder.buildTrigger);
+	writer.put(wonder.upgrades);
+	writer.put(wonder.onUpgraded);
+	writer.put(wonder.provinceModifiers);
+	writer.put(wonder.areaModifiers);
+	writer.put(wonder.countryModifiers);
+}
+
+void CK2::Snapshot::read(Reader& reader, Wonder& wonder)
+{
+	reader.get(wonder.wonderID);
+	reader.get(wonder.stage);
+	reader.get(wonder.provinceID);
+	reader.get(wonder.builderID);
+	reader.get(wonder.binaryDate);
+	reader.get(wonder.base);
+	reader.get(wonder.active);
+	reader.get(wonder.spent);
+	reader.get(wonder.type);
+	reader.get(wonder.name);
+	reader.get(wonder.desc);
+	reader.get(wonder.trueDate);
+	reader.get(wonder.canBeMoved);
+	reader.get(wonder.builderCulture);
+	reader.get(wonder.builderReligion);
+	reader.get(wonder.buildTrigger);
+	reader.get(wonder.upgrades);
+	reader.get(wonder.onUpgraded);
+	reader.get(wonder.provinceModifiers);
+	reader.get(wonder.areaModifiers);
+	reader.get(wonder.countryModifiers);
+}
+
+void CK2::Snapshot::write(Writer& writer, const Wonders& wonders)
+{
+	writer.put(wonders.wonders);
+}
+
+void CK2::Snapshot::read(Reader& reader, Wonders& wonders)
+{
+	reader.get(wonders.wonders);
+}
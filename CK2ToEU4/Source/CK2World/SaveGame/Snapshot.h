@@ -0,0 +1,185 @@
+#ifndef CK2_SNAPSHOT_H
+#define CK2_SNAPSHOT_H
+#include "Date.h"
+#include "GameVersion.h"
+#include "ModLoader/ModLoader.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace CK2
+{
+class Barony;
+class Character;
+class Characters;
+class CoatOfArms;
+class Diplomacy;
+class Dynasties;
+class Dynasty;
+class Flags;
+class Liege;
+class Offmap;
+class Offmaps;
+class Province;
+class Provinces;
+class Relation;
+class Relations;
+class Religions;
+class Title;
+class Titles;
+class TraitSet;
+class Tributary;
+class Vars;
+class Wonder;
+class Wonders;
+
+// Binary dump of the world as it stands right after the save is parsed and before anything is linked.
+// Re-running the converter on the same save (to try a different shatter level or start date) loads this
+// instead of parsing the save again. Links are stored as the IDs the save gave us, the pointers are put back
+// by the usual linking pass.
+//
+// Snapshots are CacheStore entries, only ever read back by the same converter build on the same machine, so the
+// layout is native-endian and bumping snapshotFormat is all it takes to invalidate old ones.
+//
+// A late-game snapshot runs to hundreds of MB, so it goes out in frames, one per large table (characters, titles,
+// provinces, dynasties, relations) and one for the rest, each deflated on its own. The frames are written, and read
+// back into the world, side by side.
+//
+// A checkpoint is the same dump taken once the CK2 phases are done, so a rerun changing only the EU4 side starts
+// right there. By then a link no longer always leads where its ID says (heirs keyed by prestige, lieges overridden
+// under the old name, revolts gone from the titles table but still some titles' liege), and nothing relinks it, so a
+// checkpoint stores each link's target as well. Its frames are the snapshot's plus one for what the phases add.
+class Snapshot
+{
+  public:
+	// Everything World parses out of the save (and the game's dynasty files).
+	struct State
+	{
+		date& endDate;
+		date& startDate;
+		GameVersion& CK2Version;
+		Provinces& provinces;
+		Characters& characters;
+		Titles& titles;
+		Dynasties& dynasties;
+		Wonders& wonders;
+		Offmaps& offmaps;
+		Diplomacy& diplomacy;
+		Flags& flags;
+		Vars& vars;
+		Religions& religions;
+		std::map<std::string, Liege>& dynamicTitles;
+	};
+
+	// What the CK2 phases add to that, for checkpoints.
+	struct Built
+	{
+		std::map<std::string, std::shared_ptr<Title>>& independentTitles;
+		std::optional<std::pair<std::string, std::shared_ptr<Title>>>& hreTitle;
+		bool& leviathanDLC;
+		std::set<std::string>& existentPremadeMonuments;
+	};
+
+	// Where a campaign's last conversion left off: the save it converted, whose snapshot holds the parsed world, and
+	// a digest of each of that save's top-level blocks. Successive saves of a campaign (autosaves, mostly) share a
+	// good part of their blocks, and those that digest the same needn't be parsed again.
+	struct Campaign
+	{
+		std::string saveHash;
+		std::map<std::string, std::string> blockDigests;
+	};
+
+	// Hex digest of the file contents.
+	[[nodiscard]] static std::string hashFile(const std::string& filePath);
+	// Anything that changes what the parse produces belongs in the key; for a checkpoint, also whatever the CK2 phases
+	// act on (see World::phaseOptions).
+	[[nodiscard]] static std::string makeKey(const std::string& saveHash,
+		 const std::string& converterVersion,
+		 const std::string& CK2Path,
+		 const Mods& mods,
+		 const std::vector<std::string>& options = {});
+
+	static void save(const std::string& snapshotPath, const std::string& key, const State& state);
+	// False (and state left half-filled, the caller resets it) if there is no usable snapshot for this key.
+	[[nodiscard]] static bool load(const std::string& snapshotPath, const std::string& key, const State& state);
+
+	static void saveCheckpoint(const std::string& checkpointPath, const std::string& key, const State& state, const Built& built);
+	// As load, both left half-filled on a miss.
+	[[nodiscard]] static bool loadCheckpoint(const std::string& checkpointPath, const std::string& key, const State& state, const Built& built);
+
+	// A campaign's key is a snapshot key made over the save's path rather than its contents.
+	static void saveCampaign(const std::string& campaignKey, const Campaign& campaign);
+	[[nodiscard]] static std::optional<Campaign> loadCampaign(const std::string& campaignKey);
+
+  private:
+	class Graph;
+	class Writer;
+	class Reader;
+
+	// Raw size and deflated bytes of each frame.
+	using Frames = std::vector<std::pair<std::uint64_t, std::string>>;
+	[[nodiscard]] static Frames writeFrames(const State& state, Graph* graph);
+	static void store(const std::string& path, const std::string& storeKey, const Frames& frames);
+	[[nodiscard]] static bool restore(const std::string& path, const std::string& storeKey, const State& state, const Built* built);
+
+	// Frame by frame, in the order they're stored.
+	static constexpr std::size_t frameCount = 6;
+	static void writeFrame(Writer& writer, const State& state, std::size_t frame);
+	static void writeBuilt(Writer& writer, const Built& built);
+	static void write(Writer& writer, const Barony& barony);
+	static void write(Writer& writer, const Character& character);
+	static void write(Writer& writer, const Characters& characters);
+	static void write(Writer& writer, const CoatOfArms& coatOfArms);
+	static void write(Writer& writer, const Diplomacy& diplomacy);
+	static void write(Writer& writer, const Dynasties& dynasties);
+	static void write(Writer& writer, const Dynasty& dynasty);
+	static void write(Writer& writer, const Flags& flags);
+	static void write(Writer& writer, const Liege& liege);
+	static void write(Writer& writer, const Offmap& offmap);
+	static void write(Writer& writer, const Offmaps& offmaps);
+	static void write(Writer& writer, const Province& province);
+	static void write(Writer& writer, const Provinces& provinces);
+	static void write(Writer& writer, const Relation& relation);
+	static void write(Writer& writer, const Relations& relations);
+	static void write(Writer& writer, const Religions& religions);
+	static void write(Writer& writer, const Title& title);
+	static void write(Writer& writer, const Titles& titles);
+	static void write(Writer& writer, const TraitSet& traits);
+	static void write(Writer& writer, const Tributary& tributary);
+	static void write(Writer& writer, const Vars& vars);
+	static void write(Writer& writer, const Wonder& wonder);
+	static void write(Writer& writer, const Wonders& wonders);
+
+	static void readFrame(Reader& reader, const State& state, std::size_t frame);
+	static void readBuilt(Reader& reader, const Built& built);
+	static void read(Reader& reader, Barony& barony);
+	static void read(Reader& reader, Character& character);
+	static void read(Reader& reader, Characters& characters);
+	static void read(Reader& reader, CoatOfArms& coatOfArms);
+	static void read(Reader& reader, Diplomacy& diplomacy);
+	static void read(Reader& reader, Dynasties& dynasties);
+	static void read(Reader& reader, Dynasty& dynasty);
+	static void read(Reader& reader, Flags& flags);
+	static void read(Reader& reader, Liege& liege);
+	static void read(Reader& reader, Offmap& offmap);
+	static void read(Reader& reader, Offmaps& offmaps);
+	static void read(Reader& reader, Province& province);
+	static void read(Reader& reader, Provinces& provinces);
+	static void read(Reader& reader, Relation& relation);
+	static void read(Reader& reader, Relations& relations);
+	static void read(Reader& reader, Religions& religions);
+	static void read(Reader& reader, Title& title);
+	static void read(Reader& reader, Titles& titles);
+	static void read(Reader& reader, TraitSet& traits);
+	static void read(Reader& reader, Tributary& tributary);
+	static void read(Reader& reader, Vars& vars);
+	static void read(Reader& reader, Wonder& wonder);
+	static void read(Reader& reader, Wonders& wonders);
+};
+} // namespace CK2
+
+#endif // CK2_SNAPSHOT_H
@@ -0,0 +1,57 @@
+#include "SpillFile.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+namespace fs = std::filesystem;
+
+namespace
+{
+std::string spillPath()
+{
+	// Batch conversions can spill side by side, and several converters can share a temp folder.
+	static std::atomic<unsigned> spills = 0;
+	const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+	const auto name = "CK2ToEU4-" + std::to_string(stamp) + "-" + std::to_string(spills.fetch_add(1)) + ".spill";
+	return (fs::temp_directory_path() / name).string();
+}
+} // namespace
+
+CK2::SpillFile::SpillFile(const std::string_view data): path(spillPath())
+{
+	{
+		std::ofstream spill(fs::u8path(path), std::ios::binary | std::ios::trunc);
+		if (!spill.write(data.data(), static_cast<std::streamsize>(data.size())) || !spill.flush())
+		{
+			spill.close();
+			std::error_code error;
+			fs::remove(fs::u8path(path), error);
+			throw std::runtime_error("Could not spill " + std::to_string(data.size()) + " bytes to " + path + ".");
+		}
+	}
+	try
+	{
+		mapping = MappedFile(path);
+	}
+	catch (...)
+	{
+		std::error_code error;
+		fs::remove(fs::u8path(path), error);
+		throw;
+	}
+#ifndef _WIN32
+	fs::remove(fs::u8path(path)); // the mapping keeps the data reachable
+	path.clear();
+#endif
+}
+
+CK2::SpillFile::~SpillFile()
+{
+	mapping.close();
+	if (!path.empty())
+	{
+		std::error_code error;
+		fs::remove(fs::u8path(path), error);
+	}
+}
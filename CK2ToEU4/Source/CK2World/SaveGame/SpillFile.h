@@ -0,0 +1,29 @@
+#ifndef CK2_SPILL_FILE_H
+#define CK2_SPILL_FILE_H
+#include "MappedFile.h"
+#include <string>
+#include <string_view>
+
+namespace CK2
+{
+// A copy of some bytes kept in a temp file and mapped back in, rather than on the heap. Pages we haven't touched in a
+// while are clean file pages the OS can drop and fault back in, so a block we only revisit here and there (undecoded
+// character details) doesn't count against memory the way a heap copy would. The file goes away with the spill;
+// elsewhere than Windows it's unlinked as soon as it's mapped, so not even a crash leaves it behind.
+class SpillFile
+{
+  public:
+	explicit SpillFile(std::string_view data);
+	~SpillFile();
+	SpillFile(const SpillFile&) = delete;
+	SpillFile& operator=(const SpillFile&) = delete;
+
+	[[nodiscard]] std::string_view view() const { return {mapping.data(), mapping.size()}; }
+
+  private:
+	std::string path; // empty once unlinked
+	MappedFile mapping;
+};
+} // namespace CK2
+
+#endif // CK2_SPILL_FILE_H
@@ -0,0 +1,68 @@
+#include "SliceLog.h"
+#include "Contention.h"
+#include <algorithm>
+#include <ranges>
+
+namespace
+{
+CK2::Contention::Site sliceLogWaits("slice logs");
+} // namespace
+
+CK2::SliceLog::Slice::Slice(SliceLog& owner, const std::size_t first): owner(owner), first(first)
+{
+	discarded.setstate(std::ios_base::badbit);
+}
+
+std::ostream& CK2::SliceLog::Slice::line(const std::string_view category)
+{
+	auto categoryItr = std::ranges::find(categories, category, &Category::name);
+	if (categoryItr == categories.end())
+		categoryItr = categories.insert(categories.end(), Category{category});
+	++categoryItr->count;
+	// No slice can contribute more than the log keeps, whichever slices end up first.
+	if (categoryItr->examples.size() >= owner.examplesPerCategory)
+		return discarded;
+	return categoryItr->examples.emplace_back();
+}
+
+void CK2::SliceLog::take(const std::size_t first, std::vector<Category>&& categories)
+{
+	if (categories.empty())
+		return;
+	const auto lock = lockAt<std::unique_lock<std::mutex>>(sliceLogWaits, slicesMutex);
+	slices.emplace_back(first, std::move(categories));
+}
+
+void CK2::SliceLog::flush()
+{
+	std::vector<std::pair<std::size_t, std::vector<Category>>> handedOver;
+	{
+		const std::lock_guard lock(slicesMutex);
+		handedOver.swap(slices);
+	}
+	std::ranges::sort(handedOver, {}, [](const auto& slice) {
+		return slice.first;
+	});
+
+	std::vector<Category> totals;
+	for (auto& categories: handedOver | std::views::values)
+		for (auto& category: categories)
+		{
+			auto totalItr = std::ranges::find(totals, category.name, &Category::name);
+			if (totalItr == totals.end())
+				totalItr = totals.insert(totals.end(), Category{category.name});
+			totalItr->count += category.count;
+			for (auto& example: category.examples)
+				if (totalItr->examples.size() < examplesPerCategory)
+					totalItr->examples.emplace_back(std::move(example));
+		}
+
+	for (const auto& category: totals)
+	{
+		for (const auto& example: category.examples)
+			Log(level) << example.str();
+		if (category.count > category.examples.size())
+			Log(level) << "... and " << category.count - category.examples.size() << " more " << category.name << " lines like these (" << category.count
+						  << " in all).";
+	}
+}
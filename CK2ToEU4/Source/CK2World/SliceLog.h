@@ -0,0 +1,77 @@
+#ifndef CK2_SLICE_LOG_H
+#define CK2_SLICE_LOG_H
+#include "Log.h"
+#include <cstddef>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace CK2
+{
+// Log lines raised from inside a forEachSlice sweep. Logging straight from the slices has them queue up on the log
+// for every missing dynasty or spouse and print in whatever order the threads got there. Instead each slice collects
+// its own lines without taking a lock and hands them over once when it's done; flush() then writes them all from the
+// calling thread, in slice order, so the log reads the same as a serial run.
+//
+// Lines come in categories ("Spouse ID", "Capital barony ID"). A modded save can miss tens of thousands of spouses,
+// so only the first few lines of each category are kept and written, followed by a count of the rest. Lines past
+// that are counted without being formatted.
+//
+// Usage:
+//	SliceLog warnings(LogLevel::Warning);
+//	forEachSlice(count, [&warnings](first, last) { auto sliceWarnings = warnings.slice(first); ... sliceWarnings.line("Spouse ID") << ...; });
+//	warnings.flush();
+class SliceLog
+{
+	struct Category
+	{
+		std::string_view name;
+		std::size_t count = 0;
+		std::vector<std::ostringstream> examples;
+	};
+
+  public:
+	class Slice
+	{
+	  public:
+		~Slice() { owner.take(first, std::move(categories)); }
+		Slice(const Slice&) = delete;
+		Slice& operator=(const Slice&) = delete;
+
+		// Starts a new line; stream its parts into the result. The category must outlive the log, a literal will do.
+		std::ostream& line(std::string_view category);
+
+	  private:
+		friend class SliceLog;
+		Slice(SliceLog& owner, std::size_t first);
+
+		SliceLog& owner;
+		std::size_t first;
+		std::vector<Category> categories; // a handful at most, in the order they came up
+		std::ostringstream discarded;		 // failed, so anything streamed into it is dropped unformatted
+	};
+
+	explicit SliceLog(const LogLevel level, const std::size_t examplesPerCategory = 20): level(level), examplesPerCategory(examplesPerCategory) {}
+	~SliceLog() { flush(); }
+	SliceLog(const SliceLog&) = delete;
+	SliceLog& operator=(const SliceLog&) = delete;
+
+	// One per slice, keyed by where the slice starts.
+	[[nodiscard]] Slice slice(const std::size_t first) { return Slice(*this, first); }
+	// Writes out and forgets everything handed over so far. Call once the sweep is done.
+	void flush();
+
+  private:
+	void take(std::size_t first, std::vector<Category>&& categories);
+
+	LogLevel level;
+	std::size_t examplesPerCategory;
+	std::mutex slicesMutex;
+	std::vector<std::pair<std::size_t, std::vector<Category>>> slices;
+};
+} // namespace CK2
+
+#endif // CK2_SLICE_LOG_H
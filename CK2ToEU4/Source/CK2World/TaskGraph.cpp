@@ -0,0 +1,270 @@
+#include "TaskGraph.h"
+#include "Concurrency.h"
+#include "Progress.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+// Runs every helper alongside own, which runs on the calling thread, on the installed pool if there is one and on
+// threads of their own if not. The first failure is rethrown once all have finished: own's, then the helpers' in order.
+void runAlongside(std::vector<std::function<void()>> helpers, const std::function<void()>& own)
+{
+	auto* pool = CK2::ThreadPool::current();
+	std::optional<CK2::TaskGroup> group;
+	std::vector<std::future<void>> running;
+	for (auto& helper: helpers)
+		if (pool)
+		{
+			if (!group)
+				group.emplace(*pool);
+			group->run(CK2::Concurrency::carry(std::move(helper)));
+		}
+		else
+			running.emplace_back(std::async(std::launch::async, CK2::Concurrency::carry(std::move(helper))));
+
+	std::exception_ptr error;
+	try
+	{
+		own();
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+	const auto settle = [&error](const auto& wait) {
+		try
+		{
+			wait();
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	};
+	if (group)
+		settle([&group] {
+			group->wait();
+		});
+	for (auto& helper: running)
+		settle([&helper] {
+			helper.get();
+		});
+	if (error)
+		std::rethrow_exception(error);
+}
+} // namespace
+
+void CK2::TaskGraph::addTask(const std::string& name, const std::vector<std::string>& dependencies, std::function<void()> work)
+{
+	const auto findTask = [this](const std::string& wanted) {
+		return std::find_if(tasks.begin(), tasks.end(), [&wanted](const Task& task) {
+			return task.name == wanted;
+		});
+	};
+	if (findTask(name) != tasks.end())
+		throw std::invalid_argument("Task " + name + " is already registered!");
+
+	Task task{name, {}, std::move(work)};
+	for (const auto& dependency: dependencies)
+	{
+		const auto taskItr = findTask(dependency);
+		if (taskItr == tasks.end())
+			throw std::invalid_argument("Task " + name + " depends on unknown task " + dependency + "!");
+		task.dependencies.emplace_back(static_cast<std::size_t>(taskItr - tasks.begin()));
+	}
+	tasks.emplace_back(std::move(task));
+}
+
+void CK2::TaskGraph::run()
+{
+	Progress::expect(tasks.size());
+	if (Concurrency::serial())
+	{
+		runOneAtATime();
+		return;
+	}
+	if (auto* pool = ThreadPool::current())
+	{
+		runOnPool(*pool);
+		return;
+	}
+
+	// Dependencies always point backwards, so launching in order means every future a step waits on already exists.
+	std::vector<std::shared_future<void>> running;
+	running.reserve(tasks.size());
+	for (auto& task: tasks)
+	{
+		std::vector<std::shared_future<void>> prerequisites;
+		for (const auto dependency: task.dependencies)
+			prerequisites.emplace_back(running[dependency]);
+		running.emplace_back(std::async(std::launch::async, Concurrency::carry([&task, prerequisites = std::move(prerequisites)] {
+			for (const auto& prerequisite: prerequisites)
+				prerequisite.get();
+			const TraceSpan span(task.name);
+			task.work();
+			Progress::advance();
+		})).share());
+	}
+
+	std::exception_ptr error;
+	for (const auto& step: running)
+	{
+		try
+		{
+			step.get();
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+	tasks.clear();
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void CK2::TaskGraph::runOnPool(ThreadPool& pool)
+{
+	// A step goes on the pool once the last of its dependencies is done, so none of them holds a worker while it waits.
+	std::vector<std::vector<std::size_t>> dependents(tasks.size());
+	std::vector<std::atomic<std::size_t>> waitingOn(tasks.size());
+	for (std::size_t index = 0; index < tasks.size(); ++index)
+	{
+		waitingOn[index] = tasks[index].dependencies.size();
+		for (const auto dependency: tasks[index].dependencies)
+			dependents[dependency].emplace_back(index);
+	}
+	std::vector<std::atomic<bool>> failed(tasks.size());
+	std::vector<std::exception_ptr> errors(tasks.size());
+
+	TaskGroup steps(pool);
+	std::function<void(std::size_t)> launch = [&](const std::size_t index) {
+		steps.run(Concurrency::carry([&, index] {
+			auto& task = tasks[index];
+			if (std::any_of(task.dependencies.begin(), task.dependencies.end(), [&failed](const std::size_t dependency) {
+					 return failed[dependency].load();
+				 }))
+				failed[index] = true;
+			else
+				try
+				{
+					const TraceSpan span(task.name);
+					task.work();
+					Progress::advance();
+				}
+				catch (...)
+				{
+					errors[index] = std::current_exception();
+					failed[index] = true;
+				}
+			for (const auto dependent: dependents[index])
+				if (--waitingOn[dependent] == 0)
+					launch(dependent);
+		}));
+	};
+	for (std::size_t index = 0; index < tasks.size(); ++index)
+		if (tasks[index].dependencies.empty())
+			launch(index);
+	steps.wait();
+
+	tasks.clear();
+	for (const auto& error: errors)
+		if (error)
+			std::rethrow_exception(error);
+}
+
+void CK2::TaskGraph::runOneAtATime()
+{
+	// Any step whose dependencies have settled may go next; with an order seed it's a random one of them.
+	std::vector<bool> settled(tasks.size());
+	std::vector<bool> failed(tasks.size());
+	std::vector<std::exception_ptr> errors(tasks.size());
+	for (std::size_t round = 0; round < tasks.size(); ++round)
+	{
+		std::vector<std::size_t> ready;
+		for (std::size_t index = 0; index < tasks.size(); ++index)
+			if (!settled[index] && std::all_of(tasks[index].dependencies.begin(), tasks[index].dependencies.end(), [&settled](const std::size_t dependency) {
+					 return settled[dependency];
+				 }))
+				ready.emplace_back(index);
+		Concurrency::shuffle(ready);
+
+		const auto next = ready.front();
+		auto& task = tasks[next];
+		settled[next] = true;
+		if (std::any_of(task.dependencies.begin(), task.dependencies.end(), [&failed](const std::size_t dependency) {
+				 return failed[dependency];
+			 }))
+		{
+			failed[next] = true;
+			continue;
+		}
+		try
+		{
+			const TraceSpan span(task.name);
+			task.work();
+			Progress::advance();
+		}
+		catch (...)
+		{
+			failed[next] = true;
+			errors[next] = std::current_exception();
+		}
+	}
+
+	tasks.clear();
+	for (const auto& error: errors)
+		if (error)
+			std::rethrow_exception(error);
+}
+
+void CK2::forEachSlice(const std::size_t count, const std::function<void(std::size_t first, std::size_t last)>& work, const std::size_t minimumSliceSize)
+{
+	// Below the minimum a thread costs more than the slice it would walk. Keeps small saves and tests on the calling thread.
+	const auto sliceCount = std::min<std::size_t>(Concurrency::threads(), count / minimumSliceSize + 1);
+	if (sliceCount == 1)
+	{
+		work(0, count);
+		return;
+	}
+
+	const auto sliceSize = (count + sliceCount - 1) / sliceCount;
+	std::vector<std::function<void()>> slices;
+	for (std::size_t first = sliceSize; first < count; first += sliceSize)
+		slices.emplace_back([&work, first, last = std::min(count, first + sliceSize)] {
+			work(first, last);
+		});
+	runAlongside(std::move(slices), [&work, last = std::min(count, sliceSize)] {
+		work(0, last);
+	});
+}
+
+void CK2::forEachClaimed(const std::size_t count, const std::function<void(std::size_t index)>& work)
+{
+	std::vector<std::size_t> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	Concurrency::shuffle(order);
+
+	std::atomic<std::size_t> nextClaim = 0;
+	const auto claim = [&work, &order, &nextClaim] {
+		for (auto claimed = nextClaim++; claimed < order.size(); claimed = nextClaim++)
+			work(order[claimed]);
+	};
+	const auto threadCount = std::min(Concurrency::threads(), count);
+	if (threadCount <= 1)
+	{
+		claim();
+		return;
+	}
+
+	runAlongside(std::vector<std::function<void()>>(threadCount - 1, claim), claim);
+}
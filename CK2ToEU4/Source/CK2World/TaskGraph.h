@@ -0,0 +1,74 @@
+#ifndef CK2_TASK_GRAPH_H
+#define CK2_TASK_GRAPH_H
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CK2
+{
+class ThreadPool;
+
+// A handful of named steps and what each has to wait for. Every step starts as soon as the steps it depends on are
+// done, on the installed ThreadPool or else on a thread of its own, so steps that touch disjoint fields of the world run
+// side by side. Under a serial Concurrency they run one at a time on the calling thread instead, in a dependency order.
+class TaskGraph
+{
+  public:
+	// Dependencies must already be added. Throws std::invalid_argument for unknown or duplicate names.
+	void addTask(const std::string& name, const std::vector<std::string>& dependencies, std::function<void()> work);
+	// Blocks until every step has run or been skipped. A failing step skips everything downstream of it, and the
+	// first failure (in the order steps were added) is rethrown once the rest have settled.
+	void run();
+
+  private:
+	struct Task
+	{
+		std::string name;
+		std::vector<std::size_t> dependencies;
+		std::function<void()> work;
+	};
+	void runOnPool(ThreadPool& pool);
+	void runOneAtATime();
+
+	std::vector<Task> tasks;
+};
+
+// Calls work(first, last) over contiguous slices of [0, count), in parallel when count is large enough to be worth it.
+// The default minimum slice suits in-memory sweeps; work that opens files pays off on much smaller slices.
+void forEachSlice(std::size_t count, const std::function<void(std::size_t first, std::size_t last)>& work, std::size_t minimumSliceSize = 8192);
+// Calls work(index) for every index in [0, count), each thread claiming the next unclaimed index as it finishes the
+// last, so a few expensive items don't hold up a whole slice. For passes over hundreds of items of uneven cost rather
+// than millions of cheap ones. Under a serial Concurrency they run on the calling thread, shuffled by an order seed.
+void forEachClaimed(std::size_t count, const std::function<void(std::size_t index)>& work);
+
+// forEachSlice over the elements of a random-access container, for passes that don't need the indices.
+template <typename Container, typename Work> void forEachItem(Container& items, const Work& work, const std::size_t minimumSliceSize = 8192)
+{
+	forEachSlice(
+		 items.size(),
+		 [&items, &work](const std::size_t first, const std::size_t last) {
+			 for (auto index = first; index < last; ++index)
+				 work(items[index]);
+		 },
+		 minimumSliceSize);
+}
+
+// Folds [0, count) by map(first, last) over fixed slices, in parallel, then combines the slice results into init in
+// slice order. The slices don't depend on the thread count, so neither does the result, floating-point sums included.
+template <typename Result, typename Map, typename Combine>
+[[nodiscard]] Result reduceSlices(const std::size_t count, Result init, const Map& map, const Combine& combine, const std::size_t sliceSize = 8192)
+{
+	std::vector<std::optional<Result>> partials((count + sliceSize - 1) / sliceSize);
+	forEachClaimed(partials.size(), [&](const std::size_t slice) {
+		partials[slice].emplace(map(slice * sliceSize, std::min(count, (slice + 1) * sliceSize)));
+	});
+	for (auto& partial: partials)
+		init = combine(std::move(init), std::move(*partial));
+	return init;
+}
+} // namespace CK2
+
+#endif // CK2_TASK_GRAPH_H
@@ -0,0 +1,190 @@
+#include "ThreadPool.h"
+#include "Contention.h"
+#include <algorithm>
+
+std::atomic<CK2::ThreadPool*> CK2::ThreadPool::installed = nullptr;
+thread_local CK2::ThreadPool* CK2::ThreadPool::ownPool = nullptr;
+thread_local std::size_t CK2::ThreadPool::ownWorker = 0;
+
+namespace
+{
+CK2::Contention::Site groupWaits("task groups"); // waiting on work other threads took
+} // namespace
+
+CK2::ThreadPool::ThreadPool(const std::size_t workerCount)
+{
+	for (std::size_t worker = 0; worker < std::max<std::size_t>(workerCount, 1); ++worker)
+		workers.emplace_back(std::make_unique<Worker>());
+	// Started once every deque exists, as a worker may steal from any of them straight away.
+	for (std::size_t worker = 0; worker < workers.size(); ++worker)
+		workers[worker]->thread = std::thread([this, worker] {
+			work(worker);
+		});
+}
+
+CK2::ThreadPool::~ThreadPool()
+{
+	{
+		const std::lock_guard lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (const auto& worker: workers)
+		worker->thread.join();
+}
+
+CK2::ThreadPool::Scope::Scope(const std::size_t workerCount): pool(workerCount), previous(installed.exchange(&pool, std::memory_order_acq_rel))
+{
+}
+
+CK2::ThreadPool::Scope::~Scope()
+{
+	installed.store(previous, std::memory_order_release);
+}
+
+void CK2::ThreadPool::submit(std::shared_ptr<Task> task)
+{
+	const auto worker = ownPool == this ? ownWorker : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+	{
+		const std::lock_guard lock(workers[worker]->mutex);
+		workers[worker]->tasks.emplace_back(std::move(task));
+	}
+	{
+		const std::lock_guard lock(sleepMutex);
+		++queued;
+	}
+	wake.notify_one();
+}
+
+std::shared_ptr<CK2::ThreadPool::Task> CK2::ThreadPool::take(const std::size_t worker)
+{
+	std::shared_ptr<Task> task;
+	{
+		auto& own = *workers[worker];
+		const std::lock_guard lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+		}
+	}
+	for (std::size_t offset = 1; !task && offset < workers.size(); ++offset)
+	{
+		auto& other = *workers[(worker + offset) % workers.size()];
+		const std::lock_guard lock(other.mutex);
+		if (!other.tasks.empty())
+		{
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+		}
+	}
+	if (task)
+	{
+		const std::lock_guard lock(sleepMutex);
+		--queued;
+	}
+	return task;
+}
+
+void CK2::ThreadPool::work(const std::size_t worker)
+{
+	ownPool = this;
+	ownWorker = worker;
+	while (true)
+	{
+		if (const auto task = take(worker))
+		{
+			if (!task->claimed.exchange(true, std::memory_order_acq_rel))
+				task->work();
+			continue;
+		}
+		std::unique_lock lock(sleepMutex);
+		if (stopping && !queued)
+			return;
+		wake.wait(lock, [this] {
+			return queued || stopping;
+		});
+	}
+}
+
+CK2::TaskGroup::~TaskGroup()
+{
+	try
+	{
+		wait();
+	}
+	catch (...)
+	{
+	}
+}
+
+void CK2::TaskGroup::run(std::function<void()> work)
+{
+	auto task = std::make_shared<ThreadPool::Task>();
+	{
+		const std::lock_guard lock(mutex);
+		const auto index = tasks.size();
+		task->work = [this, index, work = std::move(work)] {
+			std::exception_ptr error;
+			try
+			{
+				work();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+			// Notified under the lock: the moment it's released, a waiter may return and the group be gone.
+			const std::lock_guard lock(mutex);
+			errors[index] = std::move(error);
+			--unfinished;
+			changed.notify_all();
+		};
+		tasks.emplace_back(task);
+		errors.emplace_back();
+		++unfinished;
+	}
+	changed.notify_all();
+	pool.submit(std::move(task));
+}
+
+void CK2::TaskGroup::wait()
+{
+	while (true)
+	{
+		std::shared_ptr<ThreadPool::Task> next;
+		{
+			std::unique_lock lock(mutex);
+			while (!next && helped < tasks.size())
+				if (const auto& task = tasks[helped++]; !task->claimed.exchange(true, std::memory_order_acq_rel))
+					next = task;
+			if (!next)
+			{
+				if (!unfinished)
+					break;
+				const auto timed = Contention::enabled();
+				const auto start = timed ? Contention::Clock::now() : Contention::Clock::time_point();
+				changed.wait(lock, [this] {
+					return !unfinished || helped < tasks.size();
+				});
+				if (timed)
+					groupWaits.waited(start, Contention::Clock::now());
+				continue;
+			}
+		}
+		next->work();
+	}
+
+	std::exception_ptr error;
+	{
+		const std::lock_guard lock(mutex);
+		for (auto& taskError: errors)
+			if (taskError && !error)
+				error = std::move(taskError);
+		tasks.clear();
+		errors.clear();
+		helped = 0;
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
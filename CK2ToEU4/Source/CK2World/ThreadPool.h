@@ -0,0 +1,107 @@
+#ifndef CK2_THREAD_POOL_H
+#define CK2_THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CK2
+{
+// The worker threads a conversion's parallel work shares, started once rather than by every loop and graph. Each
+// worker keeps a deque of its own: what it submits goes on the back and it works from the back, while idle workers
+// steal from the front of the others'. Work submitted from outside the pool is dealt out over the workers in turn.
+//
+// A conversion or a batch owns one through a Scope for as long as it runs, and forEachSlice, forEachClaimed and
+// TaskGraph put their work on it. With no Scope (tests, prepared saves, or hardware counters on, which only follow
+// threads started after them and count them once they exit) those start threads of their own as they always have.
+class ThreadPool
+{
+  public:
+	explicit ThreadPool(std::size_t workerCount);
+	~ThreadPool(); // runs whatever is still queued first
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	class Scope;
+	[[nodiscard]] static ThreadPool* current() { return installed.load(std::memory_order_acquire); }
+
+	[[nodiscard]] std::size_t size() const { return workers.size(); }
+
+  private:
+	friend class TaskGroup;
+	struct Task
+	{
+		std::function<void()> work;
+		std::atomic<bool> claimed = false; // by a worker or a waiting TaskGroup, whichever gets there first
+	};
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<std::shared_ptr<Task>> tasks;
+		std::thread thread;
+	};
+
+	void submit(std::shared_ptr<Task> task);
+	[[nodiscard]] std::shared_ptr<Task> take(std::size_t worker);
+	void work(std::size_t worker);
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<std::size_t> nextWorker = 0; // for work submitted from outside
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::size_t queued = 0; // tasks in any deque, claimed or not; under sleepMutex
+	bool stopping = false;
+
+	static std::atomic<ThreadPool*> installed;
+	static thread_local ThreadPool* ownPool; // the pool the calling thread works for, if any
+	static thread_local std::size_t ownWorker;
+};
+
+// Starts a pool that current() hands out for as long as this lives.
+class ThreadPool::Scope
+{
+  public:
+	explicit Scope(std::size_t workerCount);
+	~Scope();
+	Scope(const Scope&) = delete;
+	Scope& operator=(const Scope&) = delete;
+
+  private:
+	ThreadPool pool;
+	ThreadPool* previous;
+};
+
+// Work run on a pool and waited for together. wait() runs the group's own work that no worker has claimed yet instead
+// of only blocking, so groups nest: a slice loop inside a graph step never waits on a worker that is itself waiting. It
+// never picks up other groups' work, so a waiter holding a lock can't end up in work that wants the same lock.
+class TaskGroup
+{
+  public:
+	explicit TaskGroup(ThreadPool& thePool): pool(thePool) {}
+	~TaskGroup(); // waits, dropping any failure
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	// Safe to call from the group's own work, for work that only becomes ready as other work finishes.
+	void run(std::function<void()> work);
+	// Blocks until everything run so far has finished, then rethrows the first failure in the order it was run.
+	void wait();
+
+  private:
+	ThreadPool& pool;
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::vector<std::shared_ptr<ThreadPool::Task>> tasks;
+	std::vector<std::exception_ptr> errors; // one per task
+	std::size_t unfinished = 0;
+	std::size_t helped = 0; // tasks wait() has looked at
+};
+} // namespace CK2
+
+#endif // CK2_THREAD_POOL_H
@@ -1,4 +1,5 @@
 #include "Liege.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "ParserHelpers.h"
 
@@ -27,5 +28,5 @@ void CK2::Liege::registerKeys()
 		const commonItems::singleString dynamicStr(theStream);
 		dynamic = dynamicStr.getString() == "yes";
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
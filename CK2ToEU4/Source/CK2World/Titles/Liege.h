@@ -21,6 +21,8 @@ class Liege: commonItems::parser
 	[[nodiscard]] auto isCustom() const { return custom; }
 
   private:
+	friend class Snapshot;
+
 	void registerKeys();
 
 	bool dynamic = false;
@@ -1,108 +1,113 @@
 #include "Title.h"
+#include "../../Parsing/KeywordTable.h"
 #include "../Characters/Character.h"
+#include "../MemoryCensus.h"
 #include "../Provinces/Province.h"
-#include "CommonRegexes.h"
+#include "Liege.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <ranges>
+#include <sstream>
 
-CK2::Title::Title(std::istream& theStream, std::string theName): name(std::move(theName))
+namespace
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+// Liege, de jure liege and base title come either as a bare title name or as a Liege block. Either way the Liege is
+// only a stepping stone; the title keeps the names and links straight to the titles once they're all in.
+CK2::Liege readLiege(std::istream& theStream)
+{
+	const auto liegeStr = commonItems::stringOfItem(theStream).getString();
+	std::stringstream tempStream(liegeStr);
+	if (liegeStr.find('{') != std::string::npos)
+		return CK2::Liege(tempStream);
+	return CK2::Liege(commonItems::singleString(tempStream).getString());
+}
+} // namespace
+
+CK2::Title::Title(std::istream& theStream, std::string theName): rank(rankOf(theName)), name(std::move(theName))
+{
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
+}
+
+CK2::Title::RANK CK2::Title::rankOf(const std::string_view titleName)
+{
+	if (titleName.size() < 2 || titleName[1] != '_')
+		return RANK::OTHER;
+	switch (titleName[0])
+	{
+		case 'b':
+			return RANK::BARONY;
+		case 'c':
+			return RANK::COUNTY;
+		case 'd':
+			return RANK::DUCHY;
+		case 'k':
+			return RANK::KINGDOM;
+		case 'e':
+			return RANK::EMPIRE;
+		default:
+			return RANK::OTHER;
+	}
 }
 
-void CK2::Title::registerKeys()
+parsing::KeywordTable<CK2::Title> CK2::Title::registerKeys()
 {
-	registerKeyword("holder", [this](const std::string& unused, std::istream& theStream) {
+	parsing::KeywordTable<Title> keywordTable;
+	keywordTable.registerKeyword("holder", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleInt holderInt(theStream);
-		holder = std::pair(holderInt.getInt(), nullptr);
+		title.holder = std::pair(holderInt.getInt(), nullptr);
 	});
-	registerKeyword("color", [this](const std::string& unused, std::istream& theStream) {
-		color = commonItems::Color::Factory{}.getColor(theStream);
+	keywordTable.registerKeyword("color", [](Title& title, const std::string& unused, std::istream& theStream) {
+		title.editDetails().color = commonItems::Color::Factory{}.getColor(theStream);
 	});
-	registerKeyword("law", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("law", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString lawStr(theStream);
-		laws.insert(lawStr.getString());
+		title.editDetails().laws.insert(parsing::Symbol(lawStr.getString()));
 	});
-	registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("name", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString nameStr(theStream);
-		displayName = nameStr.getString();
+		title.editDetails().displayName = nameStr.getString();
 	});
-	registerKeyword("previous", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("previous", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::intList listList(theStream);
-		const auto& theList = listList.getInts();
-		for (const auto& prevHolder: theList)
-			previousHolders.insert(std::pair(prevHolder, nullptr));
+		title.previousHolderIDs = listList.getInts();
 	});
-	registerKeyword("major_revolt", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("major_revolt", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString revoltStr(theStream);
-		majorRevolt = revoltStr.getString() == "yes";
+		title.majorRevolt = revoltStr.getString() == "yes";
 	});
-	registerKeyword("gender", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("gender", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString genderStr(theStream);
-		genderLaw = genderStr.getString();
+		title.editDetails().genderLaw = parsing::Symbol(genderStr.getString());
 	});
-	registerKeyword("succession", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("succession", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString successionStr(theStream);
-		successionLaw = successionStr.getString();
+		title.editDetails().successionLaw = parsing::Symbol(successionStr.getString());
 	});
-	registerKeyword("succession_electors", [this](const std::string& unused, std::istream& theStream) {
+	keywordTable.registerKeyword("succession_electors", [](Title& title, const std::string& unused, std::istream& theStream) {
 		const commonItems::intList theList(theStream);
 		const auto& electorIDs = theList.getInts();
-		electors.insert(electorIDs.begin(), electorIDs.end());
+		title.electors.insert(electorIDs.begin(), electorIDs.end());
 	});
-	registerKeyword("base_title", [this](const std::string& unused, std::istream& theStream) {
-		// This can either be a single string or a Liege object.
-		const auto baseStr = commonItems::stringOfItem(theStream).getString();
-		std::stringstream tempStream(baseStr);
-		if (baseStr.find("{") != std::string::npos)
-		{
-			auto newBaseTitle = std::make_shared<Liege>(tempStream);
-			baseTitle = std::pair(newBaseTitle->getTitle().first, newBaseTitle);
-		}
-		else
-		{
-			auto newBaseTitle = std::make_shared<Liege>(commonItems::singleString(tempStream).getString());
-			baseTitle = std::pair(newBaseTitle->getTitle().first, newBaseTitle);
-		}
+	keywordTable.registerKeyword("base_title", [](Title& title, const std::string& unused, std::istream& theStream) {
+		const auto baseTitle = readLiege(theStream);
+		title.baseTitle = std::pair(baseTitle.getTitle().first, nullptr);
+		title.baseTitleBase = baseTitle.getBaseTitle().first;
 	});
-	registerKeyword("liege", [this](const std::string& unused, std::istream& theStream) {
-		// This can either be a single string or a Liege object.
-		const auto liegeStr = commonItems::stringOfItem(theStream).getString();
-		std::stringstream tempStream(liegeStr);
-		if (liegeStr.find("{") != std::string::npos)
-		{
-			auto newLiege = std::make_shared<Liege>(tempStream);
-			liege = std::pair(newLiege->getTitle().first, newLiege);
-		}
-		else
-		{
-			auto newLiege = std::make_shared<Liege>(commonItems::singleString(tempStream).getString());
-			liege = std::pair(newLiege->getTitle().first, newLiege);
-		}
+	keywordTable.registerKeyword("liege", [](Title& title, const std::string& unused, std::istream& theStream) {
+		title.liege = std::pair(readLiege(theStream).getTitle().first, nullptr);
 	});
-	registerKeyword("de_jure_liege", [this](const std::string& unused, std::istream& theStream) {
-		// This can again either be a single string or a Liege object.
-		const auto djLiegeStr = commonItems::stringOfItem(theStream).getString();
-		std::stringstream tempStream(djLiegeStr);
-		if (djLiegeStr.find("{") != std::string::npos)
-		{
-			auto newdjLiege = std::make_shared<Liege>(tempStream);
-			deJureLiege = std::pair(newdjLiege->getTitle().first, newdjLiege);
-		}
-		else
-		{
-			auto newdjLiege = std::make_shared<Liege>(commonItems::singleString(tempStream).getString());
-			deJureLiege = std::pair(newdjLiege->getTitle().first, newdjLiege);
-		}
+	keywordTable.registerKeyword("de_jure_liege", [](Title& title, const std::string& unused, std::istream& theStream) {
+		title.deJureLiege = std::pair(readLiege(theStream).getTitle().first, nullptr);
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
 void CK2::Title::congregateProvinces(const std::map<std::string, std::shared_ptr<Title>>& independentTitles)
 {
 	// We're gathering vassal provinces and adding to our own, unless they are independent (e_hre and similar).
+	// Our coalesced set already held them, so nobody's cache goes stale over this.
 	for (const auto& vassal: vassals)
 	{
 		if (!independentTitles.count(vassal.first))
@@ -115,7 +120,8 @@ void CK2::Title::congregateProvinces(const std::map<std::string, std::shared_ptr
 
 void CK2::Title::congregateDeJureProvinces()
 {
-	// We're gathering de jure vassal de jure provinces and adding to our own.
+	// We're gathering de jure vassal de jure provinces and adding to our own. As with congregateProvinces, our
+	// coalesced set already held them.
 	for (const auto& deJureVassal: deJureVassals)
 	{
 		const auto& deJureVassalDeJureProvinces = deJureVassal.second->coalesceDeJureProvinces();
@@ -123,51 +129,81 @@ void CK2::Title::congregateDeJureProvinces()
 	}
 }
 
-int CK2::Title::flagDeJureHREProvinces()
+int CK2::Title::flagDeJureHREProvinces() const
 {
-	auto counter = 0;
-	// Flag our dejure provinces, as well as our dejure vassals' provinces, wherever those may be.
-	// Actual flagging will happen on county level as higher titles have no dejure provinces linked to them at this stage.
-	for (const auto& deJureVassal: deJureVassals)
-	{
-		counter += deJureVassal.second->flagDeJureHREProvinces();
-	}
-	for (const auto& province: deJureProvinces)
-	{
-		province.second->setDeJureHRE();
-		counter++;
-	}
-	return counter;
+	// Flag our dejure provinces, as well as our dejure vassals' provinces, wherever those may be. The coalesced
+	// subtrees stay cached for congregateDeJureProvinces later on.
+	const auto& deJureTree = coalesceDeJureProvinces();
+	for (const auto& province: deJureTree | std::views::values)
+		province->setDeJureHRE();
+	return static_cast<int>(deJureTree.size());
 }
 
-std::map<int, std::shared_ptr<CK2::Province>> CK2::Title::coalesceProvinces() const
+const std::map<int, std::shared_ptr<CK2::Province>>& CK2::Title::coalesceProvinces() const
 {
+	if (coalesced.generation == hierarchyGeneration)
+		return coalesced.provinces;
+
 	// We're gathering vassal provinces + our own, and passing them on, adding nothing to ourselves.
-	std::map<int, std::shared_ptr<Province>> toReturn;
+	coalesced.provinces.clear();
 	for (const auto& vassal: vassals)
 	{
 		const auto& vassalProvinces = vassal.second->coalesceProvinces();
-		toReturn.insert(vassalProvinces.begin(), vassalProvinces.end());
+		coalesced.provinces.insert(vassalProvinces.begin(), vassalProvinces.end());
 	}
-	toReturn.insert(provinces.begin(), provinces.end());
-	return toReturn;
+	coalesced.provinces.insert(provinces.begin(), provinces.end());
+	coalesced.generation = hierarchyGeneration;
+	return coalesced.provinces;
 }
 
-std::map<int, std::shared_ptr<CK2::Province>> CK2::Title::coalesceDeJureProvinces() const
+const std::map<int, std::shared_ptr<CK2::Province>>& CK2::Title::coalesceDeJureProvinces() const
 {
+	if (coalescedDeJure.generation == deJureGeneration)
+		return coalescedDeJure.provinces;
+
 	// We're gathering vassal dejure provinces + our own, and passing them on, adding nothing to ourselves.
-	std::map<int, std::shared_ptr<Province>> toReturn;
+	coalescedDeJure.provinces.clear();
 	for (const auto& deJureVassal: deJureVassals)
 	{
 		const auto& vassalDeJureProvinces = deJureVassal.second->coalesceDeJureProvinces();
-		toReturn.insert(vassalDeJureProvinces.begin(), vassalDeJureProvinces.end());
+		coalescedDeJure.provinces.insert(vassalDeJureProvinces.begin(), vassalDeJureProvinces.end());
 	}
-	toReturn.insert(deJureProvinces.begin(), deJureProvinces.end());
-	return toReturn;
+	coalescedDeJure.provinces.insert(deJureProvinces.begin(), deJureProvinces.end());
+	coalescedDeJure.generation = deJureGeneration;
+	return coalescedDeJure.provinces;
 }
 
 void CK2::Title::registerGeneratedVassal(const std::pair<std::string, std::shared_ptr<Title>>& theVassal)
 {
 	generatedVassals.insert(theVassal);
 	vassals.erase(theVassal.first);
+	hierarchyChanged();
+}
+
+void CK2::Title::unlink()
+{
+	provinces.clear();
+	deJureProvinces.clear();
+	vassals.clear();
+	deJureVassals.clear();
+	previousHolders.clear();
+	generatedVassals.clear();
+	holder.second.reset();
+	liege.second.reset();
+	deJureLiege.second.reset();
+	baseTitle.second.reset();
+	generatedLiege.second.reset();
+	coalesced = CoalescedProvinces();
+	coalescedDeJure = CoalescedProvinces();
+}
+
+std::size_t CK2::Title::heapBytes() const
+{
+	return MemoryCensus::heapBytes(name) + (details ? sizeof(Details) + MemoryCensus::heapBytes(details->displayName) + MemoryCensus::heapBytes(details->laws) : 0) +
+			 MemoryCensus::heapBytes(electors) +
+			 MemoryCensus::heapBytes(provinces) + MemoryCensus::heapBytes(deJureProvinces) + MemoryCensus::heapBytes(vassals) +
+			 MemoryCensus::heapBytes(deJureVassals) + MemoryCensus::heapBytes(previousHolderIDs) + MemoryCensus::heapBytes(previousHolders) +
+			 MemoryCensus::heapBytes(generatedVassals) + MemoryCensus::heapBytes(liege) + MemoryCensus::heapBytes(deJureLiege) +
+			 MemoryCensus::heapBytes(baseTitle) + MemoryCensus::heapBytes(baseTitleBase) + MemoryCensus::heapBytes(tagCountry) + MemoryCensus::heapBytes(generatedLiege) +
+			 MemoryCensus::heapBytes(coalesced.provinces) + MemoryCensus::heapBytes(coalescedDeJure.provinces);
 }
@@ -1,27 +1,50 @@
 #ifndef CK2_TITLE_H
 #define CK2_TITLE_H
+#include "../../Parsing/FlatSet.h"
+#include "../../Parsing/Symbol.h"
 #include "Color.h"
-#include "Liege.h"
 #include "Parser.h"
+#include <atomic>
+#include <memory>
 #include <set>
+#include <vector>
 
 namespace EU4
 {
 class Country;
 } // namespace EU4
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
 class Character;
 class Province;
-class Title: commonItems::parser
+class Title
 {
   public:
+	enum class RANK
+	{
+		BARONY,
+		COUNTY,
+		DUCHY,
+		KINGDOM,
+		EMPIRE,
+		OTHER // anything not named b_, c_, d_, k_ or e_
+	};
+
+	Title() = default;
 	Title(std::istream& theStream, std::string theName);
 
+	// Read off the key prefix, e_france -> EMPIRE.
+	[[nodiscard]] static RANK rankOf(std::string_view titleName);
+
 	[[nodiscard]] const auto& getName() const { return name; }
-	[[nodiscard]] const auto& getDisplayName() const { return displayName; }
-	[[nodiscard]] const auto& getLaws() const { return laws; }
+	[[nodiscard]] const auto& getDisplayName() const { return getDetails().displayName; }
+	[[nodiscard]] const auto& getLaws() const { return getDetails().laws; }
 	[[nodiscard]] const auto& getLiege() const { return liege; }
 	[[nodiscard]] const auto& getDeJureLiege() const { return deJureLiege; }
 	[[nodiscard]] const auto& getHolder() const { return holder; }
@@ -32,13 +55,16 @@ class Title: commonItems::parser
 	[[nodiscard]] const auto& getProvinces() const { return provinces; }
 	[[nodiscard]] const auto& getDeJureProvinces() const { return deJureProvinces; }
 	[[nodiscard]] const auto& getBaseTitle() const { return baseTitle; }
-	[[nodiscard]] const auto& getColor() const { return color; }
-	[[nodiscard]] const auto& getGenderLaw() const { return genderLaw; }
-	[[nodiscard]] const auto& getSuccessionLaw() const { return successionLaw; }
+	[[nodiscard]] const auto& getBaseTitleBase() const { return baseTitleBase; }
+	[[nodiscard]] const auto& getColor() const { return getDetails().color; }
+	[[nodiscard]] const auto& getGenderLaw() const { return getDetails().genderLaw; }
+	[[nodiscard]] const auto& getSuccessionLaw() const { return getDetails().successionLaw; }
 	[[nodiscard]] const auto& getEU4Tag() const { return tagCountry; }
-	[[nodiscard]] const auto& getPreviousHolders() const { return previousHolders; }
+	[[nodiscard]] const auto& getPreviousHolderIDs() const { return previousHolderIDs; }
+	[[nodiscard]] const auto& getPreviousHolders() const { return previousHolders; } // empty until Titles::linkPreviousHolders
 	[[nodiscard]] const auto& getElectors() const { return electors; }
 
+	[[nodiscard]] auto getRank() const { return rank; }
 	[[nodiscard]] auto isInHRE() const { return inHRE; }
 	[[nodiscard]] auto isHREEmperor() const { return HREEmperor; }
 	[[nodiscard]] auto isThePope() const { return thePope; }
@@ -46,19 +72,18 @@ class Title: commonItems::parser
 	[[nodiscard]] auto isElector() const { return electorate; }
 	[[nodiscard]] auto isMajorRevolt() const { return majorRevolt; }
 
-	[[nodiscard]] std::map<int, std::shared_ptr<Province>> coalesceProvinces() const;
-	[[nodiscard]] std::map<int, std::shared_ptr<Province>> coalesceDeJureProvinces() const;
-	[[nodiscard]] int flagDeJureHREProvinces();
+	// Our provinces plus everything held below us. Built once and reused until some title's vassals or provinces
+	// change, so the reference is only good until then.
+	[[nodiscard]] const std::map<int, std::shared_ptr<Province>>& coalesceProvinces() const;
+	[[nodiscard]] const std::map<int, std::shared_ptr<Province>>& coalesceDeJureProvinces() const;
+	[[nodiscard]] int flagDeJureHREProvinces() const;
 
 	void congregateProvinces(const std::map<std::string, std::shared_ptr<Title>>& independentTitles);
 	void congregateDeJureProvinces();
 	void setHolder(std::shared_ptr<Character> theHolder) { holder.second = std::move(theHolder); }
-	void setLiegePrimaryTitle(std::shared_ptr<Title> theTitle) const { liege.second->setTitle(std::move(theTitle)); }
-	void setBaseTitleTitle(std::shared_ptr<Title> theTitle) const { baseTitle.second->setTitle(std::move(theTitle)); }
-	void setBaseTitleBaseTitle(std::shared_ptr<Title> theTitle) const { baseTitle.second->setBaseTitle(std::move(theTitle)); }
-	void setLiegeBaseTitle(std::shared_ptr<Title> theBaseTitle) const { liege.second->setBaseTitle(std::move(theBaseTitle)); }
-	void setDJLiegePrimaryTitle(std::shared_ptr<Title> theTitle) const { deJureLiege.second->setTitle(std::move(theTitle)); }
-	void setDJLiegeBaseTitle(std::shared_ptr<Title> theBaseTitle) const { deJureLiege.second->setBaseTitle(std::move(theBaseTitle)); }
+	void setLiege(std::shared_ptr<Title> theTitle) { liege.second = std::move(theTitle); }
+	void setDeJureLiege(std::shared_ptr<Title> theTitle) { deJureLiege.second = std::move(theTitle); }
+	void setBaseTitle(std::shared_ptr<Title> theTitle) { baseTitle.second = std::move(theTitle); }
 	void setInHRE() { inHRE = true; }
 	void setHREEmperor() { HREEmperor = true; }
 	void setThePope() { thePope = true; }
@@ -66,15 +91,47 @@ class Title: commonItems::parser
 	void setElectorate() { electorate = true; }
 	void setPreviousHolders(const std::map<int, std::shared_ptr<Character>>& thePreviousHolders) { previousHolders = thePreviousHolders; }
 	void overrideLiege() { liege = deJureLiege; }
-	void overrideLiege(const std::pair<std::string, std::shared_ptr<Liege>>& theLiege) { liege = theLiege; }
+	void overrideLiege(const std::pair<std::string, std::shared_ptr<Title>>& theLiege) { liege = theLiege; }
 	void registerGeneratedLiege(const std::pair<std::string, std::shared_ptr<Title>>& theLiege) { generatedLiege = theLiege; }
-	void registerVassal(const std::pair<std::string, std::shared_ptr<Title>>& theVassal) { vassals.insert(theVassal); }
+	void registerVassal(const std::pair<std::string, std::shared_ptr<Title>>& theVassal)
+	{
+		vassals.insert(theVassal);
+		hierarchyChanged();
+	}
+	// A whole run of vassals in one insert, as Titles links them.
+	void registerVassals(std::vector<std::pair<std::string, std::shared_ptr<Title>>>&& theVassals)
+	{
+		vassals.insert(std::make_move_iterator(theVassals.begin()), std::make_move_iterator(theVassals.end()));
+		hierarchyChanged();
+	}
 	void registerGeneratedVassal(const std::pair<std::string, std::shared_ptr<Title>>& theVassal);
-	void registerDeJureVassal(const std::pair<std::string, std::shared_ptr<Title>>& theVassal) { deJureVassals.insert(theVassal); }
-	void registerProvince(const std::pair<int, std::shared_ptr<Province>>& theProvince) { provinces.insert(theProvince); }
-	void registerDeJureProvince(const std::pair<int, std::shared_ptr<Province>>& theProvince) { deJureProvinces.insert(theProvince); }
-	void registerEU4Tag(const std::pair<std::string, std::shared_ptr<EU4::Country>>& theCountry) { tagCountry = theCountry; }
-	void clearVassals() { vassals.clear(); }
+	void registerDeJureVassal(const std::pair<std::string, std::shared_ptr<Title>>& theVassal)
+	{
+		deJureVassals.insert(theVassal);
+		deJureHierarchyChanged();
+	}
+	void registerDeJureVassals(std::vector<std::pair<std::string, std::shared_ptr<Title>>>&& theVassals)
+	{
+		deJureVassals.insert(std::make_move_iterator(theVassals.begin()), std::make_move_iterator(theVassals.end()));
+		deJureHierarchyChanged();
+	}
+	void registerProvince(const std::pair<int, std::shared_ptr<Province>>& theProvince)
+	{
+		provinces.insert(theProvince);
+		hierarchyChanged();
+	}
+	void registerDeJureProvince(const std::pair<int, std::shared_ptr<Province>>& theProvince)
+	{
+		deJureProvinces.insert(theProvince);
+		deJureHierarchyChanged();
+	}
+	void registerEU4Tag(const std::pair<std::string, EU4::Country*>& theCountry) { tagCountry = theCountry; }
+	[[nodiscard]] std::size_t heapBytes() const; // for MemoryCensus
+	void clearVassals()
+	{
+		vassals.clear();
+		hierarchyChanged();
+	}
 	void clearGeneratedVassals() { generatedVassals.clear(); }
 	void clearLiege()
 	{
@@ -86,9 +143,51 @@ class Title: commonItems::parser
 		holder.first = 0;
 		holder.second = nullptr;
 	}
+	void unlink(); // let go of every entity we point at, for the world to come apart
 
   private:
-	void registerKeys();
+	friend class ConversionMarks;
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Title> registerKeys();
+
+	// Any change to who holds what below whom, anywhere, drops every title's coalesced cache. Changes come in a
+	// handful of bursts between long read-only stretches, so tracking exactly whose liege chain went stale isn't
+	// worth it. Atomic as the linking steps register vassals and provinces from different threads.
+	static void hierarchyChanged() { ++hierarchyGeneration; }
+	inline static std::atomic<std::uint64_t> hierarchyGeneration = 1;
+	// De jure lines are only ever drawn while linking. Shattering and splitting vassals leave them be, so the de jure
+	// sets HRE flagging coalesces are still good by the time independents gather theirs.
+	static void deJureHierarchyChanged() { ++deJureGeneration; }
+	inline static std::atomic<std::uint64_t> deJureGeneration = 1;
+
+	struct CoalescedProvinces
+	{
+		std::uint64_t generation = 0;
+		std::map<int, std::shared_ptr<Province>> provinces;
+	};
+
+	// What only the EU4 side reads, kept in a record of its own so the passes over every title don't pull it through
+	// the cache. Plenty of titles have none of it; those share one empty record instead of allocating their own.
+	struct Details
+	{
+		std::string displayName; // visual name, "Cumania"
+		parsing::Symbol genderLaw; // for succession
+		parsing::Symbol successionLaw;
+		std::optional<commonItems::Color> color;
+		parsing::FlatSet<parsing::Symbol, std::less<>> laws;
+	};
+	[[nodiscard]] const Details& getDetails() const
+	{
+		static const Details none;
+		return details ? *details : none;
+	}
+	[[nodiscard]] Details& editDetails()
+	{
+		if (!details)
+			details = std::make_unique<Details>();
+		return *details;
+	}
 
 	bool inHRE = false;
 	bool HREEmperor = false;
@@ -96,26 +195,28 @@ class Title: commonItems::parser
 	bool theFraticelliPope = false;
 	bool majorRevolt = false;
 	bool electorate = false;
-	std::string name;			 // nominal name, k_something
-	std::string displayName; // visual name, "Cumania"
-	std::string genderLaw;	 // for succession
-	std::string successionLaw;
-	std::optional<commonItems::Color> color;
-
-	std::set<std::string> laws;
-	std::set<int> electors;
+	RANK rank = RANK::OTHER;
+	std::string name; // nominal name, k_something
+	std::unique_ptr<Details> details;
+
+	parsing::FlatSet<int> electors;
 	std::map<int, std::shared_ptr<Province>> provinces;
 	std::map<int, std::shared_ptr<Province>> deJureProvinces;
 	std::map<std::string, std::shared_ptr<Title>> vassals;
 	std::map<std::string, std::shared_ptr<Title>> deJureVassals;
+	std::vector<int> previousHolderIDs; // as the save lists them, resolved only for the titles we convert
 	std::map<int, std::shared_ptr<Character>> previousHolders;
 	std::map<std::string, std::shared_ptr<Title>> generatedVassals; // Vassals we split off deliberately.
 	std::pair<int, std::shared_ptr<Character>> holder;
-	std::pair<std::string, std::shared_ptr<Liege>> liege;
-	std::pair<std::string, std::shared_ptr<Liege>> deJureLiege;
-	std::pair<std::string, std::shared_ptr<Liege>> baseTitle;
-	std::pair<std::string, std::shared_ptr<EU4::Country>> tagCountry;
+	// The save nests a Liege block under these; only the titles it names are kept, linked straight to the titles.
+	std::pair<std::string, std::shared_ptr<Title>> liege;
+	std::pair<std::string, std::shared_ptr<Title>> deJureLiege;
+	std::pair<std::string, std::shared_ptr<Title>> baseTitle;
+	std::string baseTitleBase; // the base title's own base_title as the save nests it, for names of revolts of revolts
+	std::pair<std::string, EU4::Country*> tagCountry; // owned by the EU4 world
 	std::pair<std::string, std::shared_ptr<Title>> generatedLiege; // Liege we set manually.
+	mutable CoalescedProvinces coalesced;
+	mutable CoalescedProvinces coalescedDeJure;
 };
 } // namespace CK2
 
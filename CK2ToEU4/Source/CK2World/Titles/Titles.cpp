@@ -1,28 +1,61 @@
 #include "Titles.h"
 #include "../../Mappers/ProvinceTitleMapper/ProvinceTitleMapper.h"
+#include "../../Parsing/KeywordTable.h"
 #include "../Characters/Characters.h"
+#include "../EntityArena.h"
 #include "../Provinces/Province.h"
 #include "../Provinces/Provinces.h"
-#include "CommonRegexes.h"
-#include "Liege.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include "../TaskGraph.h"
 #include "Title.h"
+#include <algorithm>
+
+namespace
+{
+// One liege -> vassal link; a null liege marks a title without one.
+struct VassalEdge
+{
+	CK2::Title* liege = nullptr;
+	std::pair<std::string, std::shared_ptr<CK2::Title>> vassal;
+};
+
+// Groups the edges by liege, keeping each liege's vassals in the order given, and hands
+// every liege its run through registerRun in a single call. Returns how many edges were registered.
+std::size_t registerEdges(std::vector<VassalEdge>&& edges,
+	 void (CK2::Title::*registerRun)(std::vector<std::pair<std::string, std::shared_ptr<CK2::Title>>>&&))
+{
+	std::erase_if(edges, [](const VassalEdge& edge) {
+		return !edge.liege;
+	});
+	std::ranges::stable_sort(edges, std::less<>(), &VassalEdge::liege);
+	for (auto run = edges.begin(); run != edges.end();)
+	{
+		const auto liege = run->liege;
+		std::vector<std::pair<std::string, std::shared_ptr<CK2::Title>>> vassals;
+		for (; run != edges.end() && run->liege == liege; ++run)
+			vassals.emplace_back(std::move(run->vassal));
+		(liege->*registerRun)(std::move(vassals));
+	}
+	return edges.size();
+}
+} // namespace
 
 CK2::Titles::Titles(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Titles::registerKeys()
+parsing::KeywordTable<CK2::Titles> CK2::Titles::registerKeys()
 {
-	registerRegex("[A-Za-z0-9-_]+", [this](const std::string& titleName, std::istream& theStream) {
-		auto newTitle = std::make_shared<Title>(theStream, titleName);
-		titles.insert(std::pair(newTitle->getName(), newTitle));
+	parsing::KeywordTable<Titles> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::characters(parsing::TokenMatcher::identifierCharacters), [](Titles& theTitles, const std::string& titleName, std::istream& theStream) {
+		auto newTitle = makeEntity<Title>(theStream, titleName);
+		theTitles.titles.insert(std::pair(newTitle->getName(), newTitle));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
 
 void CK2::Titles::linkHolders(const Characters& theCharacters)
@@ -48,21 +81,21 @@ void CK2::Titles::linkHolders(const Characters& theCharacters)
 	Log(LogLevel::Info) << "<> " << counter << " title holders linked.";
 }
 
-void CK2::Titles::linkPreviousHolders(const Characters& theCharacters)
+void CK2::Titles::linkPreviousHolders(const Characters& theCharacters, const std::map<std::string, std::shared_ptr<Title>>& theTitles)
 {
 	auto counter = 0;
 	const auto& characters = theCharacters.getCharacters();
-	for (const auto& title: titles)
+	for (const auto& title: theTitles)
 	{
-		if (!title.second->getPreviousHolders().empty())
+		if (!title.second->getPreviousHolderIDs().empty())
 		{
 			std::map<int, std::shared_ptr<Character>> previousHolders;
-			for (const auto& previousHolder: title.second->getPreviousHolders())
+			for (const auto previousHolderID: title.second->getPreviousHolderIDs())
 			{
-				const auto& charItr = characters.find(previousHolder.first);
+				const auto& charItr = characters.find(previousHolderID);
 				if (charItr != characters.end())
 				{
-					previousHolders.insert(std::pair(previousHolder.first, charItr->second));
+					previousHolders.insert(std::pair(previousHolderID, charItr->second));
 					counter++;
 				}
 				else
@@ -79,9 +112,7 @@ void CK2::Titles::linkPreviousHolders(const Characters& theCharacters)
 void CK2::Titles::linkLiegePrimaryTitles()
 {
 	auto counterPrim = 0;
-	auto counterBase = 0;
 	auto counterDJPrim = 0;
-	auto counterDJBase = 0;
 	for (const auto& title: titles)
 	{
 		if (!title.second->getLiege().first.empty())
@@ -89,26 +120,13 @@ void CK2::Titles::linkLiegePrimaryTitles()
 			const auto& titleItr = titles.find(title.second->getLiege().first);
 			if (titleItr != titles.end())
 			{
-				title.second->setLiegePrimaryTitle(titleItr->second);
+				title.second->setLiege(titleItr->second);
 				counterPrim++;
 			}
 			else
 			{
 				Log(LogLevel::Warning) << "Primary liege title ID: " << title.second->getLiege().first << " has no definition!";
 			}
-			if (!title.second->getLiege().second->getBaseTitle().first.empty())
-			{
-				const auto& title2Itr = titles.find(title.second->getLiege().second->getBaseTitle().first);
-				if (title2Itr != titles.end())
-				{
-					title.second->setLiegeBaseTitle(title2Itr->second);
-					counterBase++;
-				}
-				else
-				{
-					Log(LogLevel::Warning) << "Base liege title ID: " << title.second->getLiege().second->getBaseTitle().first << " has no definition!";
-				}
-			}
 		}
 
 		if (!title.second->getDeJureLiege().first.empty())
@@ -116,58 +134,41 @@ void CK2::Titles::linkLiegePrimaryTitles()
 			const auto& titleItr = titles.find(title.second->getDeJureLiege().first);
 			if (titleItr != titles.end())
 			{
-				title.second->setDJLiegePrimaryTitle(titleItr->second);
+				title.second->setDeJureLiege(titleItr->second);
 				counterDJPrim++;
 			}
 			else
 			{
 				Log(LogLevel::Warning) << "Primary DJ liege title ID: " << title.second->getDeJureLiege().first << " has no definition!";
 			}
-			if (!title.second->getDeJureLiege().second->getBaseTitle().first.empty())
-			{
-				const auto& title2Itr = titles.find(title.second->getDeJureLiege().second->getBaseTitle().first);
-				if (title2Itr != titles.end())
-				{
-					title.second->setDJLiegeBaseTitle(title2Itr->second);
-					counterDJBase++;
-				}
-				else
-				{
-					Log(LogLevel::Warning) << "Base DJ liege title ID: " << title.second->getDeJureLiege().second->getBaseTitle().first << " has no definition!";
-				}
-			}
 		}
 	}
-	Log(LogLevel::Info) << "<> " << counterPrim << " liege titles and " << counterBase << " liege base titles linked.";
-	Log(LogLevel::Info) << "<> " << counterDJPrim << " dejure liege titles and " << counterDJBase << " dejure liege base titles linked.";
+	Log(LogLevel::Info) << "<> " << counterPrim << " liege titles linked.";
+	Log(LogLevel::Info) << "<> " << counterDJPrim << " dejure liege titles linked.";
 }
 
 void CK2::Titles::linkVassals()
 {
-	auto counter = 0;
-	auto counterDJ = 0;
-	// We have title->liege links but not vice versa. The vice versa ones are more useful.
+	// We have title->liege links but not vice versa. The vice versa ones are more useful. Lieges are linked already, so
+	// one parallel pass reads every title's edges off its own pointers, and each liege then takes its vassals in one go.
+	std::vector<const std::pair<const std::string, std::shared_ptr<Title>>*> ordered;
+	ordered.reserve(titles.size());
 	for (const auto& title: titles)
-	{
-		if (title.second->getLiege().second) // At this point these links should all be set.
+		ordered.emplace_back(&title);
+	std::vector<VassalEdge> deFacto(ordered.size());
+	std::vector<VassalEdge> deJure(ordered.size());
+	forEachSlice(ordered.size(), [&](const std::size_t first, const std::size_t last) {
+		for (auto index = first; index < last; ++index)
 		{
-			const auto& titleItr = titles.find(title.second->getLiege().first);
-			if (titleItr != titles.end())
-			{
-				titleItr->second->registerVassal(std::pair(title.first, title.second));
-				counter++;
-			}
+			const auto& [name, title] = *ordered[index];
+			if (const auto& liege = title->getLiege().second) // At this point these links should all be set.
+				deFacto[index] = VassalEdge{liege.get(), std::pair(name, title)};
+			if (const auto& deJureLiege = title->getDeJureLiege().second)
+				deJure[index] = VassalEdge{deJureLiege.get(), std::pair(name, title)};
 		}
-		if (title.second->getDeJureLiege().second)
-		{
-			const auto& titleItr = titles.find(title.second->getDeJureLiege().first);
-			if (titleItr != titles.end())
-			{
-				titleItr->second->registerDeJureVassal(std::pair(title.first, title.second));
-				counterDJ++;
-			}
-		}
-	}
+	});
+	const auto counter = registerEdges(std::move(deFacto), &Title::registerVassals);
+	const auto counterDJ = registerEdges(std::move(deJure), &Title::registerDeJureVassals);
 	Log(LogLevel::Info) << "<> " << counter << " vassals and " << counterDJ << " de jure vassals linked.";
 }
 
@@ -195,8 +196,8 @@ void CK2::Titles::linkProvinces(const Provinces& theProvinces, const mappers::Pr
 	{
 		const auto& titleName = title.first;
 		// We could just look up directly in the map but then we'd miss potential errors,
-		// so we check for c_ manually.
-		if (titleName.find("c_") == 0)
+		// so we check for counties manually.
+		if (title.second->getRank() == Title::RANK::COUNTY)
 		{
 			const auto& provinceItr = titleProvinceMap.find(titleName);
 			if (provinceItr != titleProvinceMap.end())
@@ -219,7 +220,6 @@ void CK2::Titles::linkBaseTitles()
 {
 	// This is relevant for revolts, so we know where to merge them.
 	auto counter = 0;
-	auto counterBase = 0;
 	for (const auto& title: titles)
 	{
 		if (!title.second->getBaseTitle().first.empty())
@@ -227,53 +227,44 @@ void CK2::Titles::linkBaseTitles()
 			const auto& titleItr = titles.find(title.second->getBaseTitle().first);
 			if (titleItr != titles.end())
 			{
-				title.second->setBaseTitleTitle(titleItr->second);
+				title.second->setBaseTitle(titleItr->second);
 				counter++;
 			}
 			else
 			{
 				Log(LogLevel::Warning) << "Base title title ID: " << title.second->getBaseTitle().first << " has no definition!";
 			}
-			if (!title.second->getBaseTitle().second->getBaseTitle().first.empty())
-			{
-				const auto& title2Itr = titles.find(title.second->getBaseTitle().second->getBaseTitle().first);
-				if (title2Itr != titles.end())
-				{
-					title.second->setBaseTitleBaseTitle(title2Itr->second);
-					counterBase++;
-				}
-				else
-				{
-					Log(LogLevel::Warning) << "Base title base title ID: " << title.second->getBaseTitle().second->getBaseTitle().first << " has no definition!";
-				}
-			}
 		}
 	}
-	Log(LogLevel::Info) << "<> " << counter << " base titles titles and " << counterBase << " base title base titles linked.";
+	Log(LogLevel::Info) << "<> " << counter << " base titles titles linked.";
 }
 
 void CK2::Titles::mergeRevolts()
 {
 	// major revolts need to have their leader drop the top-tier revolt title and relink
-	// to revolt's base_title.
+	// to revolt's base_title. The vassals' edges get rewritten first and registered afterwards, all at once.
 
-	std::set<std::string> droppedRevoltTitles;
+	std::vector<VassalEdge> relinked;
+	std::vector<std::string> droppedRevoltTitles;
 
 	for (const auto& title: titles)
 	{
 		if (!title.second->isMajorRevolt())
 			continue;
+		// A revolt based on another revolt hands its vassals on to wherever that one goes.
+		auto base = title.second->getBaseTitle();
+		for (auto hops = titles.size(); base.second && base.second->isMajorRevolt() && base.second != title.second && hops; --hops)
+			base = base.second->getBaseTitle();
 		// for a major revolt, scroll through all vassals and relink them to to base;
 		for (const auto& vassal: title.second->getVassals())
 		{
-			const auto& revoltBaseTitle = title.second->getBaseTitle();
-			vassal.second->overrideLiege(revoltBaseTitle);
-			const auto& newLiege = vassal.second->getLiege().second->getTitle();
-			newLiege.second->registerVassal(std::pair(vassal.first, vassal.second));
+			vassal.second->overrideLiege(base);
+			relinked.emplace_back(VassalEdge{base.second.get(), vassal});
 		}
 		title.second->clearVassals();
-		droppedRevoltTitles.insert(title.first);
+		droppedRevoltTitles.emplace_back(title.first);
 	}
+	registerEdges(std::move(relinked), &Title::registerVassals);
 	// finally, clear them out.
 	for (const auto& droppedRevolt: droppedRevoltTitles)
 	{
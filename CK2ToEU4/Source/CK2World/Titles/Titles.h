@@ -1,5 +1,6 @@
 #ifndef CK2_TITLES_H
 #define CK2_TITLES_H
+#include "../../Parsing/NameMap.h"
 #include "Parser.h"
 
 namespace mappers
@@ -7,12 +8,17 @@ namespace mappers
 class ProvinceTitleMapper;
 }
 
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
+
 namespace CK2
 {
 class Title;
 class Characters;
 class Provinces;
-class Titles: commonItems::parser
+class Titles
 {
   public:
 	Titles() = default;
@@ -21,7 +27,9 @@ class Titles: commonItems::parser
 	[[nodiscard]] const auto& getTitles() const { return titles; }
 
 	void linkHolders(const Characters& theCharacters);
-	void linkPreviousHolders(const Characters& theCharacters);
+	// Holder histories run long and only matter for the titles that become countries, so this runs late and only
+	// over those.
+	static void linkPreviousHolders(const Characters& theCharacters, const std::map<std::string, std::shared_ptr<Title>>& theTitles);
 	void linkLiegePrimaryTitles();
 	void linkVassals();
 	void linkBaseTitles();
@@ -29,9 +37,11 @@ class Titles: commonItems::parser
 	void mergeRevolts();
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Titles> registerKeys();
 
-	std::map<std::string, std::shared_ptr<Title>> titles;
+	parsing::NameMap<std::shared_ptr<Title>> titles;
 };
 } // namespace CK2
 
@@ -0,0 +1,100 @@
+#include "Trace.h"
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+std::atomic<bool> CK2::Trace::on = false;
+
+namespace
+{
+struct Event
+{
+	std::string name;
+	unsigned int thread = 0;
+	long long start = 0; // microseconds since enable()
+	long long duration = 0;
+	std::optional<double> counter; // a counter event if set, a span if not
+};
+
+std::mutex eventsMutex;
+std::vector<Event> events;
+CK2::Trace::Clock::time_point epoch;
+std::atomic<unsigned int> nextThread = 0;
+
+unsigned int threadNumber()
+{
+	thread_local const auto number = nextThread++;
+	return number;
+}
+
+long long microseconds(const CK2::Trace::Clock::duration duration)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+std::string escapeJSON(const std::string& text)
+{
+	std::string escaped;
+	for (const auto character: text)
+	{
+		if (character == '"' || character == '\\')
+			escaped += '\\';
+		escaped += character;
+	}
+	return escaped;
+}
+} // namespace
+
+void CK2::Trace::enable()
+{
+	const std::lock_guard lock(eventsMutex);
+	if (on)
+		return;
+	epoch = Clock::now();
+	on = true;
+}
+
+void CK2::Trace::record(const std::string_view name, const Clock::time_point start, const Clock::time_point end)
+{
+	if (!enabled())
+		return;
+	const auto thread = threadNumber();
+	const std::lock_guard lock(eventsMutex);
+	events.emplace_back(Event{std::string(name), thread, microseconds(start - epoch), microseconds(end - start)});
+}
+
+void CK2::Trace::count(const std::string_view name, const Clock::time_point at, const double value)
+{
+	if (!enabled())
+		return;
+	const std::lock_guard lock(eventsMutex);
+	events.emplace_back(Event{std::string(name), 0, microseconds(at - epoch), 0, value});
+}
+
+void CK2::Trace::write(const std::string& filePath)
+{
+	std::ofstream output(filePath);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + filePath);
+	const std::lock_guard lock(eventsMutex);
+	output << "{\"traceEvents\": [";
+	for (std::size_t index = 0; index < events.size(); ++index)
+	{
+		const auto& event = events[index];
+		output << (index ? ",\n" : "\n") << "{\"name\": \"" << escapeJSON(event.name);
+		if (event.counter)
+			output << "\", \"ph\": \"C\", \"pid\": 1, \"ts\": " << event.start << ", \"args\": {\"value\": " << *event.counter << "}}";
+		else
+			output << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread << ", \"ts\": " << event.start << ", \"dur\": " << event.duration << "}";
+	}
+	output << "\n], \"displayTimeUnit\": \"ms\"}\n";
+}
+
+void CK2::Trace::reset()
+{
+	const std::lock_guard lock(eventsMutex);
+	on = false;
+	events.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef CK2_TRACE_H
+#define CK2_TRACE_H
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace CK2
+{
+// A conversion timeline in the trace-event format chrome://tracing and ui.perfetto.dev load. Off unless enabled, and
+// then a span is one relaxed load. Spans are recorded from any thread; each thread shows up as its own track.
+class Trace
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	static void enable();
+	[[nodiscard]] static bool enabled() { return on.load(std::memory_order_relaxed); }
+	static void record(std::string_view name, Clock::time_point start, Clock::time_point end);
+	// Sets a counter track to value from at on, until it's set again.
+	static void count(std::string_view name, Clock::time_point at, double value);
+	// Everything recorded so far, as one "traceEvents" array of complete events.
+	static void write(const std::string& filePath);
+	// Drops whatever was recorded and turns tracing back off.
+	static void reset();
+
+  private:
+	static std::atomic<bool> on;
+};
+
+// Records its own lifetime as a span on the calling thread.
+class TraceSpan
+{
+  public:
+	explicit TraceSpan(const std::string_view name)
+	{
+		if (Trace::enabled())
+		{
+			active = true;
+			spanName = name;
+			start = Trace::Clock::now();
+		}
+	}
+	~TraceSpan()
+	{
+		if (active)
+			Trace::record(spanName, start, Trace::Clock::now());
+	}
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+
+  private:
+	bool active = false;
+	std::string spanName;
+	Trace::Clock::time_point start;
+};
+
+// For the one-liners that don't warrant a scope of their own.
+template <typename Work> void traced(const std::string_view name, Work&& work)
+{
+	const TraceSpan span(name);
+	work();
+}
+} // namespace CK2
+
+#endif // CK2_TRACE_H
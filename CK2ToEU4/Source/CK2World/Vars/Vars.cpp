@@ -1,21 +1,45 @@
 #include "Vars.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "ParserHelpers.h"
+#include <algorithm>
+#include <cctype>
 
-CK2::Vars::Vars(std::istream& theStream)
+namespace
 {
-	registerKeys();
+bool isVariableName(const std::string& name)
+{
+	return !name.empty() && std::ranges::all_of(name, [](const unsigned char character) {
+		return std::isalnum(character) || character == '_' || character == '.' || character == '-';
+	});
+}
+} // namespace
+
+CK2::Vars::Vars(std::istream& theStream, const parsing::NameFilter& interests)
+{
+	registerKeys(interests);
 	parseStream(theStream);
 	clearRegisteredKeywords();
 }
 
-void CK2::Vars::registerKeys()
+void CK2::Vars::registerKeys(const parsing::NameFilter& interests)
 {
-	registerRegex("[A-Za-z0-9_.-]+", [this](const std::string& varName, std::istream& theStream) {
+	// One catchall instead of a variable-name regex run on every key; names outside [A-Za-z0-9_.-] are still skipped.
+	registerRegex(commonItems::catchallRegex, [this, &interests](const std::string& varName, std::istream& theStream) {
+		if (!interests.admits(varName) || !isVariableName(varName))
+		{
+			parsing::ignoreItem(varName, theStream);
+			return;
+		}
 		const commonItems::singleDouble valueDbl(theStream);
 		vars.insert(std::pair(varName, valueDbl.getDouble()));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+}
+
+const parsing::NameFilter& CK2::Vars::queriedVars()
+{
+	static const parsing::NameFilter queried({}, {"global_chinese_"});
+	return queried;
 }
 
 std::optional<std::map<std::string, double>> CK2::Vars::getChineseReligions() const
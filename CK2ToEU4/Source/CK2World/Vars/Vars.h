@@ -1,5 +1,6 @@
 #ifndef CK2_VARS_H
 #define CK2_VARS_H
+#include "../../Parsing/NameFilter.h"
 #include "Parser.h"
 
 namespace CK2
@@ -8,13 +9,18 @@ class Vars: commonItems::parser
 {
   public:
 	Vars() = default;
-	explicit Vars(std::istream& theStream);
+	explicit Vars(std::istream& theStream, const parsing::NameFilter& interests = {});
+
+	// Every variable getChineseReligions() looks at; the world keeps only these.
+	[[nodiscard]] static const parsing::NameFilter& queriedVars();
 
 	[[nodiscard]] const auto& getVars() const { return vars; } // for testing
 	[[nodiscard]] std::optional<std::map<std::string, double>> getChineseReligions() const;
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	void registerKeys(const parsing::NameFilter& interests);
 
 	std::map<std::string, double> vars;
 };
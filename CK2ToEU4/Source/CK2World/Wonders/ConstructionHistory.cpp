@@ -1,4 +1,5 @@
 #include "ConstructionHistory.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
@@ -21,5 +22,5 @@ void CK2::ConstructionHistory::registerKeys()
 	registerKeyword("wonder_upgrade", [this](const std::string& mods, std::istream& theStream) {
 		upgrade = commonItems::singleString(theStream).getString();
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
@@ -1,60 +1,120 @@
 #include "Wonder.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/ItemSkipper.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../SaveGame/SaveBuffer.h"
 #include "ConstructionHistory.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <algorithm>
+#include <sstream>
 
 CK2::Wonder::Wonder(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = [] {
+		parsing::KeywordTable<Wonder> wonderTable;
+		registerKeys(wonderTable);
+		registerHistoryKeys(wonderTable);
+		wonderTable.ignoreUnregistered();
+		return wonderTable;
+	}();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Wonder::registerKeys()
+CK2::Wonder::Wonder(const std::string_view theEntry, std::shared_ptr<const void> theSource)
 {
-	registerKeyword("type", [this](const std::string& unused, std::istream& theStream) {
-		type = commonItems::singleString(theStream).getString();
-		upgrades.emplace_back(type);
-	});
-	registerKeyword("province", [this](const std::string& unused, std::istream& theStream) {
-		provinceID = commonItems::singleInt(theStream).getInt();
+	static const auto keywordTable = [] {
+		parsing::KeywordTable<Wonder> wonderTable;
+		registerKeys(wonderTable);
+		wonderTable.registerKeyword("construction_history", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+			wonder.historyAt = wonder.upgrades.size();
+			parsing::ignoreItem(unused, theStream);
+		});
+		wonderTable.ignoreUnregistered();
+		return wonderTable;
+	}();
+	SaveBuffer entryBuffer(theEntry.data(), theEntry.size());
+	std::istream entryStream(&entryBuffer);
+	keywordTable.parseStream(*this, entryStream);
+
+	pendingHistory = std::make_unique<PendingHistory>();
+	pendingHistory->source = std::move(theSource);
+	pendingHistory->entry = theEntry;
+}
+
+void CK2::Wonder::decodePendingHistory() const
+{
+	static const auto keywordTable = [] {
+		parsing::KeywordTable<Wonder> historyTable;
+		registerHistoryKeys(historyTable);
+		historyTable.ignoreUnregistered();
+		return historyTable;
+	}();
+	SaveBuffer entryBuffer(pendingHistory->entry.data(), pendingHistory->entry.size());
+	std::istream entryStream(&entryBuffer);
+	keywordTable.parseStream(const_cast<Wonder&>(*this), entryStream);
+
+	// Once the last pending wonder of a save lets go, so does the block.
+	pendingHistory->source.reset();
+	pendingHistory->entry = std::string_view();
+}
+
+void CK2::Wonder::registerKeys(parsing::KeywordTable<Wonder>& keywordTable)
+{
+	keywordTable.registerKeyword("type", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		wonder.type = commonItems::singleString(theStream).getString();
+		wonder.upgrades.emplace_back(wonder.type);
 	});
-	registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
-		name = commonItems::singleString(theStream).getString();
+	keywordTable.registerKeyword("province", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		wonder.provinceID = commonItems::singleInt(theStream).getInt();
 	});
-	registerKeyword("desc", [this](const std::string& mods, std::istream& theStream) {
-		desc = commonItems::singleString(theStream).getString();
+	keywordTable.registerKeyword("name", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		wonder.name = commonItems::singleString(theStream).getString();
 	});
-	registerKeyword("construction_history", [this](const std::string& mods, std::istream& theStream) {
-		for (const auto& blob: commonItems::blobList(theStream).getBlobs())
-		{
-			std::stringstream tempStream(blob);
-			auto historyItem = ConstructionHistory(tempStream);
-			if (const auto& tempBuilderID = historyItem.getBuilderID(); builderID == 0 && tempBuilderID > 0)
-				builderID = tempBuilderID;
-			if (const auto& tempDate = historyItem.getBinaryDate(); binaryDate == 0 || tempDate < binaryDate) // Gets the earliest date
-				binaryDate = tempDate;
-			if (!historyItem.getUpgrade().empty())
-				upgrades.emplace_back(historyItem.getUpgrade());
-		}
+	keywordTable.registerKeyword("desc", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		wonder.desc = commonItems::singleString(theStream).getString();
 	});
-	registerKeyword("stage", [this](const std::string& unused, std::istream& theStream) {
-		stage = commonItems::singleInt(theStream).getInt();
-		if (stage < 0)
+	keywordTable.registerKeyword("stage", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		wonder.stage = commonItems::singleInt(theStream).getInt();
+		if (wonder.stage < 0)
 		{
-			stage = 0;
-			upgrades.emplace_back("generic_misc_upgrade_3");
+			wonder.stage = 0;
+			wonder.upgrades.emplace_back("generic_misc_upgrade_3");
 		}
-		else if (stage > 3) // For mods
+		else if (wonder.stage > 3) // For mods
 		{
-			stage = 3;
+			wonder.stage = 3;
 		}
 	});
-	registerKeyword("active", [this](const std::string& unused, std::istream& theStream) {
-		active = (commonItems::singleString(theStream).getString() == "yes");
+	keywordTable.registerKeyword("active", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		wonder.active = (commonItems::singleString(theStream).getString() == "yes");
+	});
+}
+
+void CK2::Wonder::registerHistoryKeys(parsing::KeywordTable<Wonder>& keywordTable)
+{
+	keywordTable.registerKeyword("construction_history", [](Wonder& wonder, const std::string& unused, std::istream& theStream) {
+		if (!wonder.pendingHistory)
+			wonder.historyAt = wonder.upgrades.size();
+		wonder.readHistory(theStream);
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+}
+
+void CK2::Wonder::readHistory(std::istream& theStream)
+{
+	std::vector<std::string> historyUpgrades;
+	for (const auto& blob: commonItems::blobList(theStream).getBlobs())
+	{
+		std::stringstream tempStream(blob);
+		auto historyItem = ConstructionHistory(tempStream);
+		if (const auto& tempBuilderID = historyItem.getBuilderID(); builderID == 0 && tempBuilderID > 0)
+			builderID = tempBuilderID;
+		if (const auto& tempDate = historyItem.getBinaryDate(); binaryDate == 0 || tempDate < binaryDate) // Gets the earliest date
+			binaryDate = tempDate;
+		if (!historyItem.getUpgrade().empty())
+			historyUpgrades.emplace_back(historyItem.getUpgrade());
+	}
+	// Deferred histories are read after the stage had its say, so they go back where the save had them.
+	upgrades.insert(upgrades.begin() + static_cast<std::ptrdiff_t>(std::min(historyAt, upgrades.size())), historyUpgrades.begin(), historyUpgrades.end());
 }
 
 void CK2::Wonder::setTrueDate(int binDate)
@@ -1,15 +1,27 @@
 #ifndef CK2_WONDER_H
 #define CK2_WONDER_H
-#include "Parser.h"
-#include <set>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
 
 namespace CK2
 {
-class Wonder: commonItems::parser
+class Wonder
 {
   public:
 	Wonder() = default;
 	explicit Wonder(std::istream& theStream);
+	// Reads type, province, stage and the like up front and keeps the construction history undecoded inside
+	// theSource until the builder, date or upgrades are asked for. Only monuments that make it to output ever are.
+	Wonder(std::string_view theEntry, std::shared_ptr<const void> theSource);
 
 	[[nodiscard]] const auto& getType() const { return type; }
 	[[nodiscard]] const auto& getName() const { return name; }
@@ -17,8 +29,8 @@ class Wonder: commonItems::parser
 	[[nodiscard]] auto getWonderID() const { return wonderID; }
 	[[nodiscard]] auto getStage() const { return stage; }
 	[[nodiscard]] auto getProvinceID() const { return provinceID; }
-	[[nodiscard]] auto getBuilder() const { return builderID; }
-	[[nodiscard]] auto getBinaryDate() const { return binaryDate; }
+	[[nodiscard]] auto getBuilder() const { return decodeHistory().builderID; }
+	[[nodiscard]] auto getBinaryDate() const { return decodeHistory().binaryDate; }
 	[[nodiscard]] auto isActive() const { return active; }
 	[[nodiscard]] auto hasBase() const { return base; }
 	[[nodiscard]] auto isTransferrable() const { return active && stage == 3; }
@@ -31,10 +43,10 @@ class Wonder: commonItems::parser
 	[[nodiscard]] const auto& getProvinceModifiers() const { return provinceModifiers; }
 	[[nodiscard]] const auto& getAreaModifiers() const { return areaModifiers; }
 	[[nodiscard]] const auto& getCountryModifiers() const { return countryModifiers; }
-	[[nodiscard]] const auto& getUpgrades() const { return upgrades; }
+	[[nodiscard]] const auto& getUpgrades() const { return decodeHistory().upgrades; }
 	[[nodiscard]] auto isSpent() const { return spent; }
 
-	void addUpgrade(const std::string& mod) { upgrades.emplace_back(mod); }
+	void addUpgrade(const std::string& mod) { decodeHistory().upgrades.emplace_back(mod); }
 	void setWonderID(int mod) { wonderID = mod; }
 	void setName(const std::string& newName) { name = newName; }
 	void setTrueDate(int binDate);
@@ -48,9 +60,33 @@ class Wonder: commonItems::parser
 	void addCountryModifier(const std::pair<std::string, std::vector<double>>& mod) { countryModifiers.emplace(mod); }
 	void addOnUpgraded(const std::string& on) { onUpgraded.emplace_back(on); }
 	void setSpent() { spent = true; }
+	void decode() const { decodeHistory(); } // now rather than on first use
 
   private:
-	void registerKeys();
+	friend class ConversionMarks;
+	friend class Snapshot;
+
+	static void registerKeys(parsing::KeywordTable<Wonder>& keywordTable);
+	static void registerHistoryKeys(parsing::KeywordTable<Wonder>& keywordTable);
+	void readHistory(std::istream& theStream);
+
+	// Decodes the held-back construction history on first use. Safe to call from several threads.
+	Wonder& decodeHistory() const
+	{
+		if (pendingHistory)
+			std::call_once(pendingHistory->once, [this] { decodePendingHistory(); });
+		return const_cast<Wonder&>(*this); // the history is logically part of a const Wonder, it just arrives late.
+	}
+	void decodePendingHistory() const;
+
+	struct PendingHistory
+	{
+		std::shared_ptr<const void> source; // whatever holds the wonder block the entry points into
+		std::string_view entry;
+		std::once_flag once;
+	};
+	std::unique_ptr<PendingHistory> pendingHistory;
+	std::size_t historyAt = 0; // where the history's upgrades go among those the type and stage put in
 
 	int wonderID = -1;
 	int stage = 0;
@@ -1,22 +1,43 @@
 #include "Wonders.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/KeywordTable.h"
+#include "../EntityArena.h"
+#include "../SaveGame/BlockLoader.h"
 #include "Log.h"
 #include "ParserHelpers.h"
 #include "Wonder.h"
 
 CK2::Wonders::Wonders(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto keywordTable = registerKeys();
+	keywordTable.parseStream(*this, theStream);
 }
 
-void CK2::Wonders::registerKeys()
+CK2::Wonders::Wonders(const std::string_view theBlock)
 {
-	registerRegex(R"(\d+)", [this](const std::string& wonderID, std::istream& theStream) {
-		auto newWonder = std::make_shared<Wonder>(theStream);
+	static const auto wonderID = parsing::TokenMatcher::digits();
+	const auto opening = theBlock.find('{');
+	if (opening == std::string_view::npos)
+		return;
+	const auto source = std::make_shared<const std::string>(theBlock.substr(opening + 1));
+	for (const auto& [key, item]: BlockLoader::entriesOf(*source))
+	{
+		const auto theID = std::string(key);
+		if (!wonderID.matches(theID))
+			continue;
+		auto newWonder = makeEntity<Wonder>(item, source);
+		newWonder->setWonderID(std::stoi(theID));
+		wonders.insert(std::pair(std::stoi(theID), newWonder));
+	}
+}
+
+parsing::KeywordTable<CK2::Wonders> CK2::Wonders::registerKeys()
+{
+	parsing::KeywordTable<Wonders> keywordTable;
+	keywordTable.registerMatcher(parsing::TokenMatcher::digits(), [](Wonders& theWonders, const std::string& wonderID, std::istream& theStream) {
+		auto newWonder = makeEntity<Wonder>(theStream);
 		newWonder->setWonderID(std::stoi(wonderID));
-		wonders.insert(std::pair(std::stoi(wonderID), newWonder));
+		theWonders.wonders.insert(std::pair(std::stoi(wonderID), newWonder));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
 }
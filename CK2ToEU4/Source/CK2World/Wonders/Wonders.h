@@ -1,20 +1,31 @@
 #ifndef CK2_WONDERS_H
 #define CK2_WONDERS_H
 #include "Parser.h"
+#include <string_view>
+
+namespace parsing
+{
+template <typename Entity> class KeywordTable;
+}
 
 namespace CK2
 {
 class Wonder;
-class Wonders: commonItems::parser
+class Wonders
 {
   public:
 	Wonders() = default;
 	explicit Wonders(std::istream& theStream);
+	// From the wonder block's raw text. Construction histories stay undecoded in a copy of the block until some
+	// wonder's are asked for; the copy goes once every such wonder has decoded or gone.
+	explicit Wonders(std::string_view theBlock);
 
 	[[nodiscard]] const auto& getWonders() const { return wonders; }
 
   private:
-	void registerKeys();
+	friend class Snapshot;
+
+	static parsing::KeywordTable<Wonders> registerKeys();
 
 	std::map<int, std::shared_ptr<Wonder>> wonders;
 };
@@ -1,53 +1,80 @@
 #include "World.h"
 #include "../Configuration/Configuration.h"
+#include "../Parsing/ItemSkipper.h"
+#include "../Parsing/Symbol.h"
+#include "CacheStore.h"
 #include "Characters/Character.h"
 #include "CommonFunctions.h"
+#include "Concurrency.h"
 #include "CommonRegexes.h"
 #include "Date.h"
+#include "Dynasties/Dynasty.h"
 #include "GameVersion.h"
+#include "Metrics.h"
 #include "Log.h"
+#include "ModFiles.h"
 #include "OSCompatibilityLayer.h"
 #include "Offmaps/Offmap.h"
 #include "ParserHelpers.h"
 #include "Religions/Religions.h"
+#include "SaveGame/BinarySave.h"
+#include "SaveGame/BlockLoader.h"
+#include "SaveGame/ChunkedSaveBuffer.h"
+#include "SaveGame/SaveBuffer.h"
+#include "SaveGame/Snapshot.h"
+#include "TaskGraph.h"
 #include "Titles/Liege.h"
 #include "Titles/Title.h"
 #include "zip.h"
 #include <cmath>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <ranges>
+#include <thread>
+#include <unordered_set>
 namespace fs = std::filesystem;
 
-CK2::World::World(const Configuration& theConfiguration, const commonItems::ConverterVersion& converterVersion)
+namespace
 {
+// The laws heir resolution and the HRE setup branch on, interned up front so those checks are pointer compares.
+const parsing::Symbol primogeniture("primogeniture");
+const parsing::Symbol ultimogeniture("ultimogeniture");
+const parsing::Symbol gavelkind("gavelkind");
+const parsing::Symbol electiveGavelkind("elective_gavelkind");
+const parsing::Symbol nomadSuccession("nomad_succession");
+const parsing::Symbol tanistry("tanistry");
+const parsing::Symbol eldership("eldership");
+const parsing::Symbol turkishSuccession("turkish_succession");
+const parsing::Symbol feudalElective("feudal_elective");
+const parsing::Symbol agnatic("agnatic");
+const parsing::Symbol cognatic("cognatic");
+const parsing::Symbol trueCognatic("true_cognatic");
+} // namespace
+
+CK2::World::World(const Configuration& theConfiguration,
+	 const commonItems::ConverterVersion& converterVersion,
+	 PhaseTimings& timings,
+	 const InstallSource& installSource)
+{
+	const EntityArena::Scope entities(arena);
 	Log(LogLevel::Info) << "*** Hello CK2, Deus Vult! ***";
+	if (theConfiguration.getCharacterDecoding() == Configuration::CHARACTER_DECODING::EAGER)
+		characterDetails = Characters::DETAILS::EAGER;
+	else if (theConfiguration.getCharacterDecoding() == Configuration::CHARACTER_DECODING::SPILLED)
+		characterDetails = Characters::DETAILS::SPILLED;
 	registerKeys(converterVersion);
 	Log(LogLevel::Progress) << "4 %";
 
+	timings.begin("Verifying CK2 save");
 	Log(LogLevel::Info) << "-> Verifying CK2 save.";
 	verifySave(theConfiguration.getSaveGamePath());
 
-	Log(LogLevel::Info) << "-> Importing CK2 save.";
-	if (!saveGame.compressed)
-	{
-		std::ifstream inBinary(fs::u8path(theConfiguration.getSaveGamePath()), std::ios::binary);
-		if (!inBinary.is_open())
-		{
-			Log(LogLevel::Error) << "Could not open " << theConfiguration.getSaveGamePath() << " for parsing.";
-			throw std::runtime_error("Could not open " + theConfiguration.getSaveGamePath() + " for parsing.");
-		}
-		std::stringstream inStream;
-		inStream << inBinary.rdbuf();
-		saveGame.gamestate = inStream.str();
-	}
-
+	timings.begin("Locating mods in mod folder");
 	Log(LogLevel::Info) << "-> Locating mods in mod folder";
-	commonItems::ModLoader modLoader;
-	modLoader.loadMods(theConfiguration.getCK2DocsPath(), theConfiguration.getMods());
-	mods = modLoader.getMods();
+	mods = locateMods(theConfiguration.getCK2DocsPath(), theConfiguration.getMods());
 	Log(LogLevel::Progress) << "6 %";
 
-	// We must load initializers before the savegame.
 	// Do we have an override mod?
 	std::string overrideModPath;
 	for (const auto& mod: mods)
@@ -55,135 +82,357 @@ CK2::World::World(const Configuration& theConfiguration, const commonItems::Conv
 			overrideModPath = "CleanSlate";
 		else if (mod.name == "Tianxia: Silk Road Expansion")
 			overrideModPath = "Tianxia";
-	reformedReligionMapper.initReformedReligionMapper(overrideModPath);
-	loadDynasties(theConfiguration);
-	Log(LogLevel::Progress) << "7 %";
 
-	personalityScraper.scrapePersonalities(theConfiguration);
+	// Reruns changing only the EU4 side pick up where the CK2 phases ended, straight from the world they built.
+	std::string saveHash;
+	if (theConfiguration.getSnapshot() != Configuration::SNAPSHOT::DISABLED || theConfiguration.getCheckpoint() != Configuration::CHECKPOINT::DISABLED)
+		saveHash = Snapshot::hashFile(theConfiguration.getSaveGamePath());
+	std::string checkpointPath;
+	std::string checkpointKey;
+	if (theConfiguration.getCheckpoint() != Configuration::CHECKPOINT::DISABLED)
+	{
+		checkpointKey = Snapshot::makeKey(saveHash, converterVersion.getVersion(), theConfiguration.getCK2Path(), mods, phaseOptions(theConfiguration));
+		checkpointPath = CacheStore::pathFor("checkpoints", checkpointKey);
+	}
+	if (theConfiguration.getCheckpoint() == Configuration::CHECKPOINT::RESUME)
+	{
+		timings.begin("Loading Checkpoint");
+		Log(LogLevel::Info) << "-> Looking for a checkpoint of this world.";
+		const auto resumed = loadCheckpoint(checkpointPath, checkpointKey);
+		++Metrics::lookups("checkpoint", resumed);
+		if (resumed)
+		{
+			Log(LogLevel::Info) << "<> Loaded the built world from " << checkpointPath << ", skipping the CK2 phases.";
+			resumeFromCheckpoint(theConfiguration, overrideModPath, timings);
+			return;
+		}
+	}
+
+	timings.begin("Loading Snapshot");
+	// Reruns on the same save pick up where the previous parse ended.
+	std::string snapshotPath;
+	std::string snapshotKey;
+	if (theConfiguration.getSnapshot() != Configuration::SNAPSHOT::DISABLED)
+	{
+		snapshotPath = "snapshots/" + saveHash + ".snapshot";
+		snapshotKey = Snapshot::makeKey(saveHash, converterVersion.getVersion(), theConfiguration.getCK2Path(), mods);
+	}
+	auto fromSnapshot = false;
+	if (!snapshotPath.empty())
+	{
+		Log(LogLevel::Info) << "-> Looking for a snapshot of this save.";
+		fromSnapshot = loadSnapshot(snapshotPath, snapshotKey);
+		if (fromSnapshot)
+			Log(LogLevel::Info) << "<> Loaded the parsed save from " << snapshotPath << ", skipping the import.";
+		++Metrics::lookups("snapshot", fromSnapshot);
+	}
+	// A later save of a campaign converted before starts out as the last one, and only parses the blocks that changed.
+	std::string campaignKey;
+	std::map<std::string, std::string> previousDigests;
+	if (!fromSnapshot && theConfiguration.getSnapshot() == Configuration::SNAPSHOT::CAMPAIGN)
+	{
+		campaignKey = Snapshot::makeKey("campaign " + theConfiguration.getSaveGamePath(), converterVersion.getVersion(), theConfiguration.getCK2Path(), mods);
+		previousDigests = loadCampaign(campaignKey, converterVersion.getVersion(), theConfiguration.getCK2Path());
+		blockLoader.reuseUnchanged(previousDigests);
+	}
 	Log(LogLevel::Progress) << "8 %";
 
-	auto gameState = std::istringstream(saveGame.gamestate);
-	parseStream(gameState);
+	// None of the install and configurables data depends on the save, so it loads while the save is read. Only the
+	// save's dynasties block has to wait for it, as it updates the install's dynasties.
+	installData = std::async(Concurrency::launchPolicy(), Concurrency::carry([&installSource, &theConfiguration, this, fromSnapshot] {
+		return installSource(theConfiguration, mods, !fromSnapshot);
+	})).share();
+	auto reformedReligions = std::async(Concurrency::launchPolicy(), Concurrency::carry([this, overrideModPath] {
+		reformedReligionMapper.initReformedReligionMapper(overrideModPath);
+	}));
+
+	timings.begin("Importing Save");
+	if (!fromSnapshot)
+	{
+		importSave(theConfiguration.getSaveGamePath());
+		if (!campaignKey.empty())
+			settleReusedBlocks(previousDigests);
+		// A save without a dynasties block still has the install's.
+		if (!installDynastiesTaken)
+			takeInstallDynasties();
+	}
+
+	timings.begin("Waiting for Install Data");
+	personalityScraper = installData.get()->personalityScraper;
+	provinceTitleMapper = installData.get()->provinceTitleMapper;
+	reformedReligions.get();
+	// Install data and save are in, and with them nearly every symbol the conversion will see.
+	parsing::Symbol::renumber();
+	if (!fromSnapshot && !snapshotPath.empty() && saveSnapshot(snapshotPath, snapshotKey) && !campaignKey.empty())
+		saveCampaign(campaignKey, saveHash);
 	Log(LogLevel::Progress) << "10 %";
-	clearRegisteredKeywords();
+	timings.count("characters", characters.getCharacters().size());
+	timings.count("titles", titles.getTitles().size());
+	timings.count("provinces", provinces.getProvinces().size());
+	takeCensus(timings);
+	Log(LogLevel::Info) << ">> Loaded " << flags.getFlags().size() << " relevant Global Flags.";
+	Log(LogLevel::Info) << ">> Loaded " << provinces.getProvinces().size() << " provinces.";
+	Log(LogLevel::Info) << ">> Loaded " << characters.getCharacters().size() << " characters.";
+	Log(LogLevel::Info) << ">> Loaded " << titles.getTitles().size() << " titles.";
+	Log(LogLevel::Info) << ">> Loaded " << religions.getReformedReligion().size() << " Reformed Religions.";
+	Log(LogLevel::Info) << ">> Loaded " << dynasties.size() << " dynasties.";
+	Log(LogLevel::Info) << ">> Loaded " << wonders.getWonders().size() << " wonders.";
+	Log(LogLevel::Info) << ">> Loaded " << offmaps.getOffmaps().size() << " offmaps.";
+	Log(LogLevel::Info) << ">> Loaded " << diplomacy.getDiplomacy().size() << " personal diplomacies.";
+	Log(LogLevel::Info) << ">> Loaded " << vars.getVars().size() << " relevant global variables.";
 	Log(LogLevel::Info) << ">> Loaded " << dynamicTitles.size() << " dynamic titles.";
-	Log(LogLevel::Info) << "-> Importing Province Titles";
-	loadProvinces(theConfiguration);
 	Log(LogLevel::Progress) << "11 %";
+	timings.begin("Setting Flags");
 	Log(LogLevel::Info) << "-> Setting Flags";
-	invasion = flags.getInvasion();					  // Sunset Invasion
-	reformationList = flags.fillReformationList(); // Reformed Pagans
-	if (flags.hellenicReformation())
-		greekReformation = flags.isGreek(); // Were Hellenes Greek or Roman?
+	setFlags();
 	Log(LogLevel::Progress) << "12 %";
 
 	Log(LogLevel::Info) << "*** Building World ***";
 
-	// Link all the intertwining pointers
-	Log(LogLevel::Info) << "-- Filtering Excess Province Titles";
-	provinceTitleMapper.filterSelf(provinces, titles);
-	Log(LogLevel::Progress) << "13 %";
-	Log(LogLevel::Info) << "-- Linking Characters With Dynasties";
-	characters.linkDynasties(dynasties);
-	Log(LogLevel::Progress) << "14 %";
-	Log(LogLevel::Info) << "-- Linking Characters With Lieges and Spouses";
-	characters.linkLiegesAndSpouses();
-	Log(LogLevel::Progress) << "15 %";
-	Log(LogLevel::Info) << "-- Linking Characters With Family";
-	characters.linkMothersAndFathers();
-	Log(LogLevel::Progress) << "16 %";
-	Log(LogLevel::Info) << "-- Linking Characters With Primary Titles";
-	characters.linkPrimaryTitles(titles);
-	Log(LogLevel::Progress) << "17 %";
-	Log(LogLevel::Info) << "-- Linking Characters With Capitals";
-	characters.linkCapitals(provinces);
-	Log(LogLevel::Progress) << "18 %";
-	Log(LogLevel::Info) << "-- Linking Provinces With Primary Baronies";
-	provinces.linkPrimarySettlements();
-	Log(LogLevel::Progress) << "19 %";
-	Log(LogLevel::Info) << "-- Linking Provinces With Wonders";
-	leviathanDLC = commonItems::DoesFileExist(theConfiguration.getEU4Path() + "/dlc/dlc106_leviathan/dlc106.dlc");
-	if (isLeviathanDLCPresent())
-		setExistentPremadeMonuments(provinces.linkMonuments(wonders, characters));
-	else
-		provinces.linkWonders(wonders);
-	Log(LogLevel::Progress) << "20 %";
-	Log(LogLevel::Info) << "-- Linking Titles With Holders";
-	titles.linkHolders(characters);
-	Log(LogLevel::Progress) << "21 %";
-	Log(LogLevel::Info) << "-- Linking Titles With Previous Holders";
-	titles.linkPreviousHolders(characters);
-	Log(LogLevel::Progress) << "22 %";
-	Log(LogLevel::Info) << "-- Linking Titles With Liege and DeJure Titles";
-	titles.linkLiegePrimaryTitles();
-	Log(LogLevel::Progress) << "23 %";
-	Log(LogLevel::Info) << "-- Linking Titles With Vassals and DeJure Vassals";
-	titles.linkVassals();
-	Log(LogLevel::Progress) << "24 %";
-	Log(LogLevel::Info) << "-- Linking Titles With Provinces";
-	titles.linkProvinces(provinces, provinceTitleMapper); // Untestable due to disk access.
-	Log(LogLevel::Progress) << "25 %";
-	Log(LogLevel::Info) << "-- Linking Titles With Base Titles";
-	titles.linkBaseTitles();
+	timings.begin("Linking");
+	// Link all the intertwining pointers. Each step writes fields no other step touches, and a step reading what
+	// another one writes lists it as a dependency; whatever isn't listed runs alongside. Wonders name statues after
+	// their builders' primary titles, so they wait for those.
+	TaskGraph linking;
+	linking.addTask("province titles", {}, [this] {
+		Log(LogLevel::Info) << "-- Filtering Excess Province Titles";
+		provinceTitleMapper.filterSelf(provinces, titles);
+	});
+	linking.addTask("dynasties", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Characters With Dynasties";
+		characters.linkDynasties(dynasties);
+	});
+	linking.addTask("lieges and spouses", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Characters With Lieges and Spouses";
+		characters.linkLiegesAndSpouses();
+	});
+	linking.addTask("family", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Characters With Family";
+		characters.linkMothersAndFathers();
+	});
+	linking.addTask("primary titles", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Characters With Primary Titles";
+		characters.linkPrimaryTitles(titles);
+	});
+	linking.addTask("capitals", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Characters With Capitals";
+		characters.linkCapitals(provinces);
+	});
+	linking.addTask("primary settlements", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Provinces With Primary Baronies";
+		provinces.linkPrimarySettlements();
+	});
+	linking.addTask("wonders", {"primary titles"}, [this, &theConfiguration] {
+		Log(LogLevel::Info) << "-- Linking Provinces With Wonders";
+		leviathanDLC = commonItems::DoesFileExist(theConfiguration.getEU4Path() + "/dlc/dlc106_leviathan/dlc106.dlc");
+		if (isLeviathanDLCPresent())
+			setExistentPremadeMonuments(provinces.linkMonuments(wonders, characters));
+		else
+			provinces.linkWonders(wonders);
+	});
+	linking.addTask("holders", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Titles With Holders";
+		titles.linkHolders(characters);
+	});
+	linking.addTask("liege titles", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Titles With Liege and DeJure Titles";
+		titles.linkLiegePrimaryTitles();
+	});
+	linking.addTask("vassals", {"liege titles"}, [this] {
+		Log(LogLevel::Info) << "-- Linking Titles With Vassals and DeJure Vassals";
+		titles.linkVassals();
+	});
+	linking.addTask("title provinces", {"province titles"}, [this] {
+		Log(LogLevel::Info) << "-- Linking Titles With Provinces";
+		titles.linkProvinces(provinces, provinceTitleMapper); // Untestable due to disk access.
+	});
+	linking.addTask("base titles", {}, [this] {
+		Log(LogLevel::Info) << "-- Linking Titles With Base Titles";
+		titles.linkBaseTitles();
+	});
+	linking.run();
 	Log(LogLevel::Progress) << "26 %";
+	takeCensus(timings);
+	timings.begin("Linking The Celestial Emperor");
 	Log(LogLevel::Info) << "-- Linking The Celestial Emperor";
 	linkCelestialEmperor();
 	Log(LogLevel::Progress) << "30 %";
+	timings.begin("Creating Reformed Religions");
 	Log(LogLevel::Info) << "-- Creating Reformed Religions";
 	createReformedFeatures();
 	Log(LogLevel::Progress) << "31 %";
 
 	// Filter top-tier active titles and assign them provinces.
 
+	timings.begin("Merging Independent Baronies");
 	Log(LogLevel::Info) << "-- Merging Independent Baronies";
 	mergeIndependentBaronies();
 	Log(LogLevel::Progress) << "32 %";
+	timings.begin("Merging Revolts Into Base");
 	Log(LogLevel::Info) << "-- Merging Revolts Into Base";
 	titles.mergeRevolts();
 	Log(LogLevel::Progress) << "33 %";
+	timings.begin("Flagging HRE Provinces");
 	Log(LogLevel::Info) << "-- Flagging HRE Provinces";
 	flagHREProvinces(theConfiguration);
+	timings.begin("Shattering HRE");
 	Log(LogLevel::Info) << "-- Shattering HRE";
 	shatterHRE(theConfiguration);
 	Log(LogLevel::Progress) << "34 %";
+	timings.begin("Shattering Empires");
 	Log(LogLevel::Info) << "-- Shattering Empires";
 	shatterEmpires(theConfiguration);
 	Log(LogLevel::Progress) << "35 %";
+	timings.begin("Indexing Courts and Holdings");
+	Log(LogLevel::Info) << "-- Indexing Courts and Holdings";
+	holderIndex = HolderIndex(characters, titles); // shattering was the last step to take titles away from anyone.
+	timings.begin("Filtering Independent Titles");
 	Log(LogLevel::Info) << "-- Filtering Independent Titles";
 	filterIndependentTitles();
 	Log(LogLevel::Progress) << "36 %";
+	timings.begin("Splitting Off Vassals");
 	Log(LogLevel::Info) << "-- Splitting Off Vassals";
 	splitVassals(theConfiguration);
 	Log(LogLevel::Progress) << "37 %";
+	timings.begin("Rounding Up Some People");
 	Log(LogLevel::Info) << "-- Rounding Up Some People";
 	gatherCourtierNames();
 	Log(LogLevel::Progress) << "38 %";
+	timings.begin("Congregating Provinces for Independent Titles");
 	Log(LogLevel::Info) << "-- Congregating Provinces for Independent Titles";
 	congregateProvinces();
 	Log(LogLevel::Progress) << "39 %";
+	timings.begin("Distributing Electorates");
 	Log(LogLevel::Info) << "-- Distributing Electorates";
 	linkElectors();
 	Log(LogLevel::Progress) << "40 %";
+	timings.begin("Congregating DeJure Provinces for Independent Titles");
 	Log(LogLevel::Info) << "-- Congregating DeJure Provinces for Independent Titles";
 	congregateDeJureProvinces();
 	Log(LogLevel::Progress) << "41 %";
-	Log(LogLevel::Info) << "-- Performing Province Sanity Check";
-	sanityCheckifyProvinces();
+	if (theConfiguration.getValidation() != Configuration::VALIDATION::OFF)
+	{
+		timings.begin("Performing Province Sanity Check");
+		Log(LogLevel::Info) << "-- Performing Province Sanity Check";
+		sanityCheckifyProvinces(theConfiguration);
+	}
 	Log(LogLevel::Progress) << "42 %";
+	timings.begin("Filtering Provinceless Titles");
 	Log(LogLevel::Info) << "-- Filtering Provinceless Titles";
 	filterProvincelessTitles();
 	Log(LogLevel::Progress) << "43 %";
+	timings.begin("Determining Heirs");
 	Log(LogLevel::Info) << "-- Determining Heirs";
 	determineHeirs();
 	Log(LogLevel::Progress) << "44 %";
+	timings.begin("Decyphering Personalities");
 	Log(LogLevel::Info) << "-- Decyphering Personalities";
 	characters.assignPersonalities(personalityScraper);
 	Log(LogLevel::Progress) << "45 %";
+	timings.begin("Altering Sunset");
 	alterSunset(theConfiguration);
+	if (!checkpointPath.empty())
+	{
+		timings.begin("Writing Checkpoint");
+		saveCheckpoint(checkpointPath, checkpointKey);
+	}
+	releaseCharacters(timings);
+}
+
+void CK2::World::resumeFromCheckpoint(const Configuration& theConfiguration, const std::string& overrideModPath, PhaseTimings& timings)
+{
+	// What follows from the flags and the reform mappings alone is made anew, so edits to those mappings count.
+	timings.begin("Setting Flags");
+	Log(LogLevel::Info) << "-> Setting Flags";
+	setFlags();
+	timings.begin("Creating Reformed Religions");
+	Log(LogLevel::Info) << "-- Creating Reformed Religions";
+	reformedReligionMapper.initReformedReligionMapper(overrideModPath);
+	createReformedFeatures();
+	alterSunset(theConfiguration);
+	Log(LogLevel::Progress) << "45 %";
+	releaseCharacters(timings);
+}
+
+void CK2::World::setFlags()
+{
+	invasion = flags.getInvasion();					  // Sunset Invasion
+	reformationList = flags.fillReformationList(); // Reformed Pagans
+	if (flags.hellenicReformation())
+		greekReformation = flags.isGreek(); // Were Hellenes Greek or Roman?
+}
+
+void CK2::World::releaseCharacters(PhaseTimings& timings)
+{
+	timings.begin("Linking Previous Holders");
+	Log(LogLevel::Info) << "-- Linking Independent Titles With Previous Holders";
+	Titles::linkPreviousHolders(characters, independentTitles);
+	timings.begin("Releasing Unused Characters");
+	Log(LogLevel::Info) << "-- Releasing Unused Characters";
+	pruneCharacters();
+	takeCensus(timings);
+	timings.finish();
 	Log(LogLevel::Info) << "*** Good-bye CK2, rest in peace. ***";
 	Log(LogLevel::Progress) << "47 %";
 }
 
+CK2::World::~World()
+{
+	// Entities point at each other every which way, so left to themselves none would ever be destroyed and whatever
+	// they hold on the heap would outlive the arena. Cutting every link lets each go with its last owner.
+	for (const auto& character: characters.getCharacters() | std::views::values)
+		character->unlink();
+	for (const auto& title: titles.getTitles() | std::views::values)
+		title->unlink();
+	for (const auto& province: provinces.getProvinces() | std::views::values)
+		province->unlink();
+}
+
+std::string CK2::World::buildKey(const Configuration& theConfiguration, const std::string& converterVersion)
+{
+	auto key = Snapshot::hashFile(theConfiguration.getSaveGamePath()) + "|" + converterVersion;
+	key += "|" + theConfiguration.getCK2Path() + "|" + theConfiguration.getCK2DocsPath();
+	for (const auto& mod: theConfiguration.getMods())
+		key += "|" + mod.path;
+	for (const auto& option: phaseOptions(theConfiguration))
+		key += "|" + option;
+	// A reused world keeps the reforms it was built with, where a checkpoint's are made anew.
+	for (const auto& modified: configurablesModified({"reformed_religions_mappings.txt", "pagan_religions.txt"}))
+		key += "|" + modified;
+	return key;
+}
+
+std::vector<std::string> CK2::World::phaseOptions(const Configuration& theConfiguration)
+{
+	// The EU4 install only for its Leviathan DLC, which decides whether wonders become monuments.
+	std::vector<std::string> options{theConfiguration.getEU4Path()};
+	for (const auto option: {static_cast<int>(theConfiguration.getHRE()),
+				static_cast<int>(theConfiguration.getShatterEmpires()),
+				static_cast<int>(theConfiguration.getShatterLevel()),
+				static_cast<int>(theConfiguration.getShatterHRELevel()),
+				static_cast<int>(theConfiguration.getSplitVassals()),
+				static_cast<int>(theConfiguration.getSunset())})
+		options.emplace_back(std::to_string(option));
+
+	// Only the CK2 phases' own configurables; editing the EU4 mappings is what reusing a world is for.
+	const auto modified = configurablesModified({"shatter_empires.txt", "i_am_hre.txt", "vassal_splitoff.txt", "monuments_mappings.txt"});
+	options.insert(options.end(), modified.begin(), modified.end());
+	return options;
+}
+
+std::vector<std::string> CK2::World::configurablesModified(const std::initializer_list<const char*> files)
+{
+	std::vector<std::string> modified;
+	for (const auto* folder: {"configurables/", "configurables/CleanSlate/", "configurables/Tianxia/"})
+		for (const auto* file: files)
+		{
+			std::error_code error;
+			const auto written = fs::last_write_time(fs::u8path(std::string(folder) + file), error);
+			modified.emplace_back(std::to_string(error ? 0 : written.time_since_epoch().count()));
+		}
+	return modified;
+}
+
 void CK2::World::registerKeys(const commonItems::ConverterVersion& converterVersion)
 {
 	registerKeyword("CK2txt", [](const std::string& unused, std::istream& theStream) {
@@ -198,8 +447,9 @@ void CK2::World::registerKeys(const commonItems::ConverterVersion& converterVers
 	});
 	registerKeyword("flags", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Flags";
-		flags = Flags(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << flags.getFlags().size() << " Global Flags.";
+		blockLoader.defer("flags", theStream, [this](std::istream& blockStream) {
+			flags = Flags(blockStream, Flags::queriedFlags());
+		});
 	});
 	registerKeyword("version", [this, converterVersion](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString versionString(theStream);
@@ -219,38 +469,46 @@ void CK2::World::registerKeys(const commonItems::ConverterVersion& converterVers
 	});
 	registerKeyword("provinces", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Provinces";
-		provinces = Provinces(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << provinces.getProvinces().size() << " provinces.";
+		blockLoader.defer("provinces", theStream, [this](std::istream& blockStream) {
+			provinces = Provinces(blockStream);
+		});
 	});
 	registerKeyword("character", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Characters";
-		characters = Characters(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << characters.getCharacters().size() << " characters.";
+		blockLoader.deferRaw("character", theStream, [this](const std::string_view block) {
+			characters = Characters(block, Concurrency::threads(), characterDetails);
+		});
 	});
 	registerKeyword("title", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Titles";
-		titles = Titles(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << titles.getTitles().size() << " titles.";
+		blockLoader.defer("title", theStream, [this](std::istream& blockStream) {
+			titles = Titles(blockStream);
+		});
 	});
 	registerKeyword("religion", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Religions";
-		religions = Religions(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << religions.getReformedReligion().size() << " Reformed Religions.";
+		blockLoader.defer("religion", theStream, [this](std::istream& blockStream) {
+			religions = Religions(blockStream);
+		});
 	});
 	registerKeyword("dynasties", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Dynasties";
-		dynasties.loadDynasties(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << dynasties.getDynasties().size() << " dynasties.";
+		blockLoader.defer("dynasties", theStream, [this](std::istream& blockStream) {
+			takeInstallDynasties();
+			dynasties.loadDynasties(blockStream);
+		});
 	});
 	registerKeyword("wonder", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Wonders";
-		wonders = Wonders(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << wonders.getWonders().size() << " wonders.";
+		blockLoader.deferRaw("wonder", theStream, [this](const std::string_view block) {
+			wonders = Wonders(block);
+		});
 	});
 	registerKeyword("offmap_powers", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Offmaps";
-		offmaps = Offmaps(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << offmaps.getOffmaps().size() << " offmaps.";
+		blockLoader.defer("offmap_powers", theStream, [this](std::istream& blockStream) {
+			offmaps = Offmaps(blockStream);
+		});
 	});
 	registerKeyword("dyn_title", [this](const std::string& unused, std::istream& theStream) {
 		const auto dynTitle = Liege(theStream);
@@ -258,52 +516,203 @@ void CK2::World::registerKeys(const commonItems::ConverterVersion& converterVers
 	});
 	registerKeyword("relation", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Diplomacy";
-		diplomacy = Diplomacy(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << diplomacy.getDiplomacy().size() << " personal diplomacies.";
+		blockLoader.defer("relation", theStream, [this](std::istream& blockStream) {
+			diplomacy = Diplomacy(blockStream);
+		});
 	});
 	registerKeyword("vars", [this](const std::string& unused, std::istream& theStream) {
 		Log(LogLevel::Info) << "-> Loading Variables";
-		vars = Vars(theStream);
-		Log(LogLevel::Info) << ">> Loaded " << vars.getVars().size() << " global variables.";
+		blockLoader.defer("vars", theStream, [this](std::istream& blockStream) {
+			vars = Vars(blockStream, Vars::queriedVars());
+		});
 	});
 
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	registerRegex(commonItems::catchallRegex, parsing::ignoreItem);
 }
 
-void CK2::World::loadDynasties(const Configuration& theConfiguration)
+void CK2::World::takeInstallDynasties()
 {
-	auto fileNames = commonItems::GetAllFilesInFolder(theConfiguration.getCK2Path() + "/common/dynasties/");
-	for (const auto& file: fileNames)
-		dynasties.loadDynasties(theConfiguration.getCK2Path() + "/common/dynasties/" + file);
-	for (const auto& mod: mods)
+	const auto install = installData.get();
+	dynasties = Dynasties(std::shared_ptr<const Dynasties>(install, &install->dynasties));
+	installDynastiesTaken = true;
+}
+
+void CK2::World::importSave(const std::string& saveGamePath)
+{
+	Log(LogLevel::Info) << "-> Importing CK2 save.";
+	// Heavy blocks are handed to blockLoader as we reach them and parse in parallel with the rest of the save.
+	if (saveGame.binary)
+	{
+		parseBinaryGamestate(saveGamePath);
+	}
+	else if (saveGame.compressed)
+	{
+		parseCompressedGamestate(saveGamePath);
+		blockLoader.wait();
+	}
+	else
 	{
-		fileNames = commonItems::GetAllFilesInFolder(mod.path + "/common/dynasties/");
-		for (const auto& file: fileNames)
+		try
 		{
-			if (file.find(".txt") == std::string::npos)
-				continue;
-			Log(LogLevel::Info) << "\t>> Loading additional dynasties from [" << mod.name << "]: " << mod.path + "/common/dynasties/" + file;
-			dynasties.loadDynasties(mod.path + "/common/dynasties/" + file);
+			saveGame.mappedGamestate = MappedFile(saveGamePath);
+		}
+		catch (std::exception& e)
+		{
+			Log(LogLevel::Error) << "Could not open " << saveGamePath << " for parsing: " << e.what();
+			throw std::runtime_error("Could not open " + saveGamePath + " for parsing.");
 		}
+
+		// Parse straight out of the mapping, no intermediate string copies.
+		SaveBuffer saveBuffer(saveGame.mappedGamestate.data(), saveGame.mappedGamestate.size());
+		std::istream gameState(&saveBuffer);
+		blockLoader.setSource(saveGame.mappedGamestate.data(), saveGame.mappedGamestate.size());
+		parseStream(gameState);
+		blockLoader.wait();
+		saveGame.mappedGamestate.close();
 	}
+	clearRegisteredKeywords();
 }
 
-void CK2::World::loadProvinces(const Configuration& theConfiguration)
+bool CK2::World::loadSnapshot(const std::string& snapshotPath, const std::string& snapshotKey)
 {
-	// Vanilla has errors and mismatches. Mods have targeted expansions and replacements. This means for vanilla we have to load a multimap,
-	// but for mods we're overwriting all multimap matches.
-	provinceTitleMapper.loadProvinces(theConfiguration.getCK2Path());
+	if (Snapshot::load(snapshotPath, snapshotKey, snapshotState()))
+		return true;
+	clearSnapshotState();
+	return false;
+}
 
-	for (const auto& mod: mods)
+bool CK2::World::loadCheckpoint(const std::string& checkpointPath, const std::string& checkpointKey)
+{
+	if (Snapshot::loadCheckpoint(checkpointPath, checkpointKey, snapshotState(), builtState()))
+		return true;
+	clearSnapshotState();
+	independentTitles.clear();
+	hreTitle.reset();
+	existentPremadeMonuments.clear();
+	return false;
+}
+
+void CK2::World::saveCheckpoint(const std::string& checkpointPath, const std::string& checkpointKey)
+{
+	// Only ever a shortcut for the next run, like the snapshot.
+	try
 	{
-		if (commonItems::DoesFolderExist(mod.path + "/history/provinces/"))
-		{
-			Log(LogLevel::Info) << "\t>> Loading additional provinces from [" << mod.name << "]: " << mod.path + "/history/provinces/";
-			provinceTitleMapper.updateProvinces(mod.path);
-		}
+		Snapshot::saveCheckpoint(checkpointPath, checkpointKey, snapshotState(), builtState());
+		Log(LogLevel::Info) << "<> Checkpoint of the built world written to " << checkpointPath;
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not write a checkpoint of the world: " << e.what();
 	}
 }
 
+void CK2::World::clearSnapshotState()
+{
+	// Whatever a failed load got into, the regular import starts from scratch.
+	endDate = date(1444, 11, 11);
+	startDate = date(1, 1, 1);
+	CK2Version = GameVersion();
+	provinces = Provinces();
+	characters = Characters();
+	titles = Titles();
+	dynasties = Dynasties();
+	wonders = Wonders();
+	offmaps = Offmaps();
+	diplomacy = Diplomacy();
+	flags = Flags();
+	vars = Vars();
+	religions = Religions();
+	dynamicTitles.clear();
+}
+
+bool CK2::World::saveSnapshot(const std::string& snapshotPath, const std::string& snapshotKey)
+{
+	// A snapshot is only ever a shortcut, failing to write one doesn't stop the conversion.
+	try
+	{
+		Snapshot::save(snapshotPath, snapshotKey, snapshotState());
+		Log(LogLevel::Info) << "<> Snapshot of the parsed save written to " << snapshotPath;
+		return true;
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not write a snapshot of the save: " << e.what();
+		return false;
+	}
+}
+
+std::map<std::string, std::string> CK2::World::loadCampaign(const std::string& campaignKey, const std::string& converterVersion, const std::string& CK2Path)
+{
+	const auto campaign = Snapshot::loadCampaign(campaignKey);
+	if (!campaign)
+		return {};
+	Log(LogLevel::Info) << "-> Looking for the snapshot of this campaign's last save.";
+	if (!loadSnapshot("snapshots/" + campaign->saveHash + ".snapshot", Snapshot::makeKey(campaign->saveHash, converterVersion, CK2Path, mods)))
+		return {};
+	// Dynamic titles aren't a block of their own; every save reads its own.
+	dynamicTitles.clear();
+	return campaign->blockDigests;
+}
+
+void CK2::World::settleReusedBlocks(const std::map<std::string, std::string>& previousDigests)
+{
+	// The last save's dynasties already have the install's in them.
+	if (blockLoader.getReused().contains("dynasties"))
+		installDynastiesTaken = true;
+
+	// Blocks the last save had and this one doesn't mustn't linger.
+	for (const auto& blockName: previousDigests | std::views::keys)
+	{
+		if (blockLoader.getDigests().contains(blockName))
+			continue;
+		if (blockName == "flags")
+			flags = Flags();
+		else if (blockName == "provinces")
+			provinces = Provinces();
+		else if (blockName == "character")
+			characters = Characters();
+		else if (blockName == "title")
+			titles = Titles();
+		else if (blockName == "religion")
+			religions = Religions();
+		else if (blockName == "dynasties")
+			dynasties = Dynasties();
+		else if (blockName == "wonder")
+			wonders = Wonders();
+		else if (blockName == "offmap_powers")
+			offmaps = Offmaps();
+		else if (blockName == "relation")
+			diplomacy = Diplomacy();
+		else if (blockName == "vars")
+			vars = Vars();
+	}
+
+	Log(LogLevel::Info) << "<> " << blockLoader.getReused().size() << " of " << blockLoader.getDigests().size()
+							  << " blocks unchanged since the campaign's last save, taken from its snapshot.";
+}
+
+void CK2::World::saveCampaign(const std::string& campaignKey, const std::string& saveHash) const
+{
+	try
+	{
+		Snapshot::saveCampaign(campaignKey, Snapshot::Campaign{saveHash, blockLoader.getDigests()});
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not note this save as the campaign's last: " << e.what();
+	}
+}
+
+CK2::Snapshot::State CK2::World::snapshotState()
+{
+	return Snapshot::State{endDate, startDate, CK2Version, provinces, characters, titles, dynasties, wonders, offmaps, diplomacy, flags, vars, religions, dynamicTitles};
+}
+
+CK2::Snapshot::Built CK2::World::builtState()
+{
+	return Snapshot::Built{independentTitles, hreTitle, leviathanDLC, existentPremadeMonuments};
+}
+
 void CK2::World::linkElectors()
 {
 	// Finding electorates is not entirely trivial. CK2 has 8 slots, one of which is usually the Emperor himself, but
@@ -331,7 +740,7 @@ void CK2::World::linkElectors()
 		Log(LogLevel::Info) << ">< HRE has too many electors.";
 		return;
 	}
-	if (hre->second->getSuccessionLaw() != "feudal_elective")
+	if (hre->second->getSuccessionLaw() != feudalElective)
 	{
 		Log(LogLevel::Info) << ">< HRE does not have feudal elective succession law.";
 		return;
@@ -341,19 +750,12 @@ void CK2::World::linkElectors()
 	auto counter = 0;
 
 	// Preambule done, we start here.
-	// Make a registry of indep titles and their holders.
-	std::map<int, std::map<std::string, std::shared_ptr<Title>>> holderTitles; // holder/titles
 	std::pair<int, std::shared_ptr<Character>> hreHolder;
-
 	for (const auto& title: independentTitles)
 	{
-		if (title.second->getHolder().first)
+		if (title.second->getHolder().first && title.second->isHREEmperor())
 		{
-			holderTitles[title.second->getHolder().first].insert(title);
-			if (title.second->isHREEmperor())
-			{
-				hreHolder = title.second->getHolder();
-			}
+			hreHolder = title.second->getHolder();
 		}
 	}
 
@@ -382,13 +784,16 @@ void CK2::World::linkElectors()
 		}
 
 		// How many indep titles does he hold? If any?
-		const auto& regItr = holderTitles.find(elector);
-		if (regItr == holderTitles.end())
+		std::map<std::string, std::shared_ptr<Title>> electorTitles;
+		for (const auto& title: holderIndex.getTitles(elector))
+			if (independentTitles.count(title.first))
+				electorTitles.insert(title);
+		if (electorTitles.empty())
 		{
 			continue; // This fellow was cheated out of electorate titles.
 		}
 
-		if (regItr->second.size() > 1)
+		if (electorTitles.size() > 1)
 		{
 			// Which title is his primary?
 			const auto& primaryTitle = charItr->second->getPrimaryTitle();
@@ -397,7 +802,7 @@ void CK2::World::linkElectors()
 				// We have a person without a primary title, possibly an ex-king, holding multiple actual titles.
 				// To make matters worse, he may not even be of a religion allowing PUs.
 				// Well, grab the first one with some land.
-				for (const auto& title: regItr->second)
+				for (const auto& title: electorTitles)
 				{
 					if (!title.second->getProvinces().empty())
 					{
@@ -416,7 +821,7 @@ void CK2::World::linkElectors()
 		}
 		else
 		{
-			regItr->second.begin()->second->setElectorate();
+			electorTitles.begin()->second->setElectorate();
 			counter++;
 		}
 	}
@@ -459,14 +864,13 @@ void CK2::World::linkCelestialEmperor() const
 		Log(LogLevel::Info) << ">< Celestial emperor has no dynasty!";
 		return;
 	}
-	const auto& dyns = dynasties.getDynasties();
-	const auto& dynastyItr = dyns.find(holder.second->getDynasty().first);
-	if (dynastyItr == dyns.end())
+	const auto& dynasty = dynasties.find(holder.second->getDynasty().first);
+	if (!dynasty)
 	{
 		Log(LogLevel::Info) << ">< Celestial emperor's dynasty has no definition!";
 		return;
 	}
-	holder.second->setDynasty(dynastyItr->second);
+	holder.second->setDynasty(dynasty);
 	Log(LogLevel::Info) << "<> One Celestial Emperor linked.";
 }
 
@@ -476,16 +880,16 @@ void CK2::World::determineHeirs()
 	for (const auto& title: independentTitles)
 	{
 		const auto& holder = title.second->getHolder();
-		auto law = title.second->getSuccessionLaw();
-		auto gender = title.second->getGenderLaw();
+		const auto& law = title.second->getSuccessionLaw();
+		const auto& gender = title.second->getGenderLaw();
 
-		if (law == "primogeniture" || law == "elective_gavelkind" || law == "gavelkind" || law == "nomad_succession")
+		if (law == primogeniture || law == electiveGavelkind || law == gavelkind || law == nomadSuccession)
 			resolvePrimogeniture(gender, holder);
-		else if (law == "ultimogeniture")
+		else if (law == ultimogeniture)
 			resolveUltimogeniture(gender, holder);
-		else if (law == "tanistry" || law == "eldership")
+		else if (law == tanistry || law == eldership)
 			resolveTanistry(gender, holder);
-		else if (law == "turkish_succession")
+		else if (law == turkishSuccession)
 			resolveTurkish(holder);
 	}
 	Log(LogLevel::Info) << "<> Heirs resolved where possible.";
@@ -493,24 +897,24 @@ void CK2::World::determineHeirs()
 
 void CK2::World::resolveTurkish(const std::pair<int, std::shared_ptr<Character>>& holder) const
 {
-	auto children = holder.second->getChildren();
 	std::vector<std::pair<int, std::shared_ptr<Character>>> childVector;
+	childVector.reserve(holder.second->getChildren().size());
 
 	// instead of filtering by id, we're filtering by raw prestige.
-	for (const auto& child: children)
+	for (const auto& child: holder.second->getChildren())
 		childVector.emplace_back(std::pair(lround(child.second->getPrestige()), child.second));
 	std::sort(childVector.begin(), childVector.end());
 
 	for (const auto& child: childVector)
 	{
-		if (child.second->getDeathDate() != date("1.1.1"))
+		if (!child.second->isAlive())
 			continue;
 		holder.second->setHeir(std::pair(child.second->getID(), child.second));
 		return;
 	}
 }
 
-void CK2::World::resolveTanistry(const std::string& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const
+void CK2::World::resolveTanistry(const parsing::Symbol& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const
 {
 	// We have no clue who a tanistry successor might be.
 	// Such luck! It's the uncle/aunt the son/daughter was named after!
@@ -520,23 +924,19 @@ void CK2::World::resolveTanistry(const std::string& genderLaw, const std::pair<i
 		heir.second->addYears(35);
 }
 
-void CK2::World::resolvePrimogeniture(const std::string& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const
+void CK2::World::resolvePrimogeniture(const parsing::Symbol& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const
 {
-	auto children = holder.second->getChildren();
-
-	// Using the awesome knowledge that a smaller ID means earlier character, we don't have to sort them by age.
-	std::vector<std::pair<int, std::shared_ptr<Character>>> childVector;
-	for (const auto& child: children)
-		childVector.emplace_back(child);
-	std::sort(childVector.begin(), childVector.end());
+	// Using the awesome knowledge that a smaller ID means earlier character, and children being kept by ID,
+	// we don't have to sort them by age.
+	const auto& childVector = holder.second->getChildren();
 
 	std::pair<int, std::shared_ptr<Character>> son;		  // primary heir candidate
 	std::pair<int, std::shared_ptr<Character>> daughter; // primary heir candidate
 
 	for (const auto& child: childVector)
 	{
-		if (child.second->getDeathDate() != date("1.1.1"))
-			continue; // Dead.
+		if (!child.second->isAlive())
+			continue;
 		if (!son.first && !child.second->isFemale())
 			son = child;
 		if (son.first && !child.second->isFemale() && son.first == child.first - 1)
@@ -547,17 +947,17 @@ void CK2::World::resolvePrimogeniture(const std::string& genderLaw, const std::p
 			daughter = child; // Twins have reversed IDs, yay!
 	}
 
-	if ((genderLaw == "agnatic" || genderLaw == "cognatic") && son.first)
+	if ((genderLaw == agnatic || genderLaw == cognatic) && son.first)
 	{
 		holder.second->setHeir(son);
 		return;
 	}
-	if (genderLaw == "cognatic" && daughter.first)
+	if (genderLaw == cognatic && daughter.first)
 	{
 		holder.second->setHeir(daughter);
 		return;
 	}
-	if (genderLaw == "true_cognatic" && (son.first || daughter.first))
+	if (genderLaw == trueCognatic && (son.first || daughter.first))
 	{
 		if (son.first && daughter.first)
 		{
@@ -580,18 +980,13 @@ void CK2::World::resolvePrimogeniture(const std::string& genderLaw, const std::p
 	}
 }
 
-void CK2::World::resolveUltimogeniture(const std::string& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const
+void CK2::World::resolveUltimogeniture(const parsing::Symbol& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const
 {
-	auto children = holder.second->getChildren();
-	std::vector<std::pair<int, std::shared_ptr<Character>>> childVector;
-	for (const auto& child: children)
-		childVector.emplace_back(child);
-	std::sort(childVector.rbegin(), childVector.rend());
 	std::pair<int, std::shared_ptr<Character>> son;
 	std::pair<int, std::shared_ptr<Character>> daughter;
-	for (const auto& child: childVector)
+	for (const auto& child: std::views::reverse(holder.second->getChildren())) // youngest first
 	{
-		if (child.second->getDeathDate() != date("1.1.1"))
+		if (!child.second->isAlive())
 			continue;
 		if (!son.first && !child.second->isFemale())
 			son = child;
@@ -599,17 +994,17 @@ void CK2::World::resolveUltimogeniture(const std::string& genderLaw, const std::
 			daughter = child;
 	}
 
-	if ((genderLaw == "agnatic" || genderLaw == "cognatic") && son.first)
+	if ((genderLaw == agnatic || genderLaw == cognatic) && son.first)
 	{
 		holder.second->setHeir(son);
 		return;
 	}
-	if (genderLaw == "cognatic" && daughter.first)
+	if (genderLaw == cognatic && daughter.first)
 	{
 		holder.second->setHeir(daughter);
 		return;
 	}
-	if (genderLaw == "true_cognatic" && (son.first || daughter.first))
+	if (genderLaw == trueCognatic && (son.first || daughter.first))
 	{
 		if (son.first && daughter.first)
 		{
@@ -626,6 +1021,68 @@ void CK2::World::resolveUltimogeniture(const std::string& genderLaw, const std::
 }
 
 
+void CK2::World::pruneCharacters()
+{
+	// From here on characters are only reached through titles and offmaps: their holders, past holders, and the
+	// spouses, heirs, advisers and parents EU4 reads off those. Whoever else the save had can go.
+	std::vector<bool> kept;
+	std::vector<std::shared_ptr<Character>> holders;
+	const auto keep = [&kept](const std::shared_ptr<Character>& character) {
+		if (!character || character->getID() < 0)
+			return false;
+		const auto ID = static_cast<std::size_t>(character->getID());
+		if (ID >= kept.size())
+			kept.resize(ID + 1);
+		if (kept[ID])
+			return false;
+		kept[ID] = true;
+		return true;
+	};
+	for (const auto& title: titles.getTitles() | std::views::values)
+	{
+		if (keep(title->getHolder().second))
+			holders.emplace_back(title->getHolder().second);
+		for (const auto& previousHolder: title->getPreviousHolders() | std::views::values)
+			keep(previousHolder);
+	}
+	for (const auto& offmap: offmaps.getOffmaps() | std::views::values)
+		if (keep(offmap->getHolder().second))
+			holders.emplace_back(offmap->getHolder().second);
+	for (const auto& holder: holders)
+	{
+		keep(holder->getHeir().second);
+		keep(holder->getMother().second);
+		keep(holder->getFather().second);
+		for (const auto& spouse: holder->getSpouses() | std::views::values)
+			keep(spouse);
+		for (const auto& adviser: holder->getAdvisers() | std::views::values)
+			keep(adviser);
+	}
+
+	const auto before = characters.getCharacters().size();
+	characters.prune(kept);
+	holderIndex = HolderIndex(); // courtiers were gathered already, and it holds on to every one of them.
+	Log(LogLevel::Info) << "<> " << characters.getCharacters().size() << " characters kept, " << before - characters.getCharacters().size() << " released.";
+}
+
+void CK2::World::takeCensus(PhaseTimings& timings) const
+{
+	if (!timings.takesCensus())
+		return;
+	MemoryCensus census;
+	census.addEntities("Character", characters.getCharacters());
+	if (const auto blockBytes = characters.getHeldBlockBytes())
+		census.add("Character block", 0, blockBytes);
+	census.addEntities("Title", titles.getTitles());
+	census.addEntities("Province", provinces.getProvinces());
+	for (const auto& [provinceID, province]: provinces.getProvinces())
+		for (const auto& [baronyName, barony]: province->getBaronies())
+			if (barony)
+				census.addEntity("Barony", *barony); // the map is the province's
+	census.addEntities("Dynasty", dynasties.getDynasties());
+	timings.census(census);
+}
+
 void CK2::World::gatherCourtierNames()
 {
 	// We're using this function to Locate courtiers, assemble their names as potential Monarch Names in EU4,
@@ -633,33 +1090,31 @@ void CK2::World::gatherCourtierNames()
 
 	auto counter = 0;
 	auto counterAdvisors = 0;
-	std::map<int, std::map<std::string, bool>> holderCourtiers;					 // holder-name/male
-	std::map<int, std::map<int, std::shared_ptr<Character>>> holderAdvisors; // holder-advisors
 
-	for (const auto& character: characters.getCharacters())
-	{
-		if (character.second->getHost())
-		{
-			holderCourtiers[character.second->getHost()].insert(std::pair(character.second->getName(), !character.second->isFemale()));
-			if (!character.second->getJob().empty())
-				holderAdvisors[character.second->getHost()].insert(character);
-		}
-	}
 	for (const auto& title: independentTitles)
 	{
 		if (title.second->getHolder().first)
 		{
-			const auto containerItr = holderCourtiers.find(title.second->getHolder().first);
-			if (containerItr != holderCourtiers.end())
+			const auto& courtiers = holderIndex.getCourtiers(title.second->getHolder().first);
+			if (!courtiers.empty())
 			{
-				title.second->getHolder().second->setCourtierNames(containerItr->second);
-				counter += static_cast<int>(containerItr->second.size());
+				// A name comes up a lot in one court. Interned, it's stored once and the first courtier to bear it sets the gender.
+				std::vector<std::pair<parsing::Symbol, bool>> courtierNames; // name/male
+				std::unordered_set<parsing::Symbol> seenNames;
+				for (const auto& courtier: courtiers)
+				{
+					const parsing::Symbol name(courtier.second->getName());
+					if (seenNames.insert(name).second)
+						courtierNames.emplace_back(name, !courtier.second->isFemale());
+				}
+				counter += static_cast<int>(courtierNames.size());
+				title.second->getHolder().second->setCourtierNames(std::move(courtierNames));
 			}
-			const auto adviserItr = holderAdvisors.find(title.second->getHolder().first);
-			if (adviserItr != holderAdvisors.end())
+			const auto& advisers = holderIndex.getAdvisers(title.second->getHolder().first);
+			if (!advisers.empty())
 			{
-				title.second->getHolder().second->setAdvisers(adviserItr->second);
-				counterAdvisors += static_cast<int>(adviserItr->second.size());
+				title.second->getHolder().second->setAdvisers(advisers);
+				counterAdvisors += static_cast<int>(advisers.size());
 			}
 		}
 	}
@@ -687,9 +1142,9 @@ void CK2::World::splitVassals(const Configuration& theConfiguration)
 			continue;
 		auto relevantVassals = 0;
 		std::string relevantVassalPrefix;
-		if (title.first.find("e_") == 0)
+		if (title.second->getRank() == Title::RANK::EMPIRE)
 			relevantVassalPrefix = "k_";
-		else if (title.first.find("k_") == 0)
+		else if (title.second->getRank() == Title::RANK::KINGDOM)
 			relevantVassalPrefix = "d_";
 		else
 			continue; // Not splitting off counties.
@@ -714,7 +1169,7 @@ void CK2::World::splitVassals(const Configuration& theConfiguration)
 
 			// a vassal goes indep if they (control 1/relevantvassals + 10% land) * factor defined in vassal_splitoff.txt.
 			double threshold = static_cast<double>(provincesClaimed.size()) / relevantVassals + 0.1 * static_cast<double>(provincesClaimed.size());
-			threshold *= vassalSplitoffMapper.getFactor();
+			threshold *= vassalSplitoffMapper->getFactor();
 			if (static_cast<double>(vassalProvincesClaimed.size()) > threshold)
 				newIndeps.insert(vassal);
 		}
@@ -723,7 +1178,7 @@ void CK2::World::splitVassals(const Configuration& theConfiguration)
 	// Now let's free them.
 	for (const auto& newIndep: newIndeps)
 	{
-		const auto& liege = newIndep.second->getLiege().second->getTitle();
+		const auto& liege = newIndep.second->getLiege();
 		liege.second->registerGeneratedVassal(newIndep);
 		newIndep.second->registerGeneratedLiege(liege);
 		independentTitles.insert(newIndep);
@@ -738,127 +1193,230 @@ void CK2::World::verifySave(const std::string& saveGamePath)
 	if (!saveFile.is_open())
 		throw std::runtime_error("Could not open save! Exiting!");
 
-	char buffer[3];
-	saveFile.get(buffer, 3);
+	char buffer[7] = {};
+	saveFile.read(buffer, 6);
 	if (buffer[0] == 'P' && buffer[1] == 'K')
 	{
 		if (!uncompressSave(saveGamePath))
 			throw std::runtime_error("Failed to unpack the compressed save!");
 		saveGame.compressed = true;
 	}
+	else
+	{
+		saveGame.binary = isBinaryGamestate(buffer);
+	}
 	saveFile.close();
 }
 
 bool CK2::World::uncompressSave(const std::string& saveGamePath)
 {
+	// We only check what's inside here. Gamestate is inflated later, straight into the parser, and nothing reads the
+	// metadata, so it stays packed.
 	zip_t* zip = zip_open(saveGamePath.c_str(), 0, 'r');
+	if (!zip)
+		return false;
 	const auto n = zip_entries_total(zip);
 	for (auto i = 0; i < n; ++i)
 	{
 		zip_entry_openbyindex(zip, i);
 		{
-			const char* name = zip_entry_name(zip);
-			if (std::string(name) == "meta")
-			{
-				Log(LogLevel::Info) << ">> Uncompressing metadata";
-				void* meta = nullptr;
-				size_t metaSize;
-				zip_entry_read(zip, &meta, &metaSize);
-				char* chtMeta = static_cast<char*>(meta);
-				saveGame.metadata = std::string(chtMeta);
-			}
-			else if (getExtension(std::string(name)) == "ck2")
+			const std::string name = zip_entry_name(zip);
+			if (getExtension(name) == "ck2")
 			{
-				Log(LogLevel::Info) << ">> Uncompressing gamestate";
-				void* ck2 = nullptr;
-				size_t ck2Size;
-				zip_entry_read(zip, &ck2, &ck2Size);
-				char* chrCk2 = static_cast<char*>(ck2);
-				saveGame.gamestate = std::string(chrCk2);
+				saveGame.gamestateEntry = name;
+				// Only the header, enough to tell ironman from text. Stopping the inflation early reports a failure.
+				std::string header;
+				const auto onInflate = [](void* arg, auto, const void* data, const size_t size) -> size_t {
+					auto& text = *static_cast<std::string*>(arg);
+					text.append(static_cast<const char*>(data), size);
+					return text.size() < 6 ? size : 0;
+				};
+				(void)zip_entry_extract(zip, onInflate, &header);
+				saveGame.binary = isBinaryGamestate(header);
 			}
-			else
+			else if (name != "meta")
 			{
-				throw std::runtime_error("Unrecognized savegame structure! What is this file: " + std::string(name) + "?");
+				zip_entry_close(zip);
+				zip_close(zip);
+				throw std::runtime_error("Unrecognized savegame structure! What is this file: " + name + "?");
 			}
 		}
 		zip_entry_close(zip);
 	}
 	zip_close(zip);
 
-	return true;
+	return !saveGame.gamestateEntry.empty();
 }
 
-void CK2::World::filterIndependentTitles()
+void CK2::World::parseCompressedGamestate(const std::string& saveGamePath)
 {
-	const auto& allTitles = titles.getTitles();
-	std::map<std::string, std::shared_ptr<Title>> potentialIndeps;
+	Log(LogLevel::Info) << ">> Uncompressing gamestate";
 
-	for (const auto& title: allTitles)
+	// Inflater thread feeds the parser as it goes, so we never hold the whole inflated gamestate.
+	ChunkedSaveBuffer saveBuffer;
+	std::thread inflater([&saveBuffer, &saveGamePath, this] {
+		try
+		{
+			zip_t* zip = zip_open(saveGamePath.c_str(), 0, 'r');
+			if (!zip || zip_entry_open(zip, saveGame.gamestateEntry.c_str()) != 0)
+			{
+				if (zip)
+					zip_close(zip);
+				throw std::runtime_error("Failed to open gamestate in the compressed save!");
+			}
+			const auto onInflate = [](void* arg, auto, const void* data, const size_t size) -> size_t {
+				if (!static_cast<ChunkedSaveBuffer*>(arg)->push(static_cast<const char*>(data), size))
+					return 0; // parser bailed on us, abort inflation.
+				return size;
+			};
+			const auto status = zip_entry_extract(zip, onInflate, &saveBuffer);
+			zip_entry_close(zip);
+			zip_close(zip);
+			if (status < 0)
+				throw std::runtime_error("Failed to unpack the compressed save!");
+			saveBuffer.finish();
+		}
+		catch (...)
+		{
+			saveBuffer.fail(std::current_exception());
+		}
+	});
+
+	std::istream gameState(&saveBuffer);
+	try
 	{
-		const auto& liege = title.second->getLiege();
-		const auto& holder = title.second->getHolder();
-		if (!holder.first)
-			continue; // don't bother with titles without holders.
-		if (liege.first.empty())
+		parseStream(gameState);
+	}
+	catch (...)
+	{
+		saveBuffer.abandon();
+		inflater.join();
+		throw;
+	}
+	saveBuffer.abandon();
+	inflater.join();
+	saveBuffer.rethrowIfFailed();
+}
+
+void CK2::World::parseBinaryGamestate(const std::string& saveGamePath)
+{
+	Log(LogLevel::Info) << ">> Decoding binary gamestate";
+	const auto tokens = BinaryTokens::load("configurables/ck2_binary_tokens.txt");
+	if (tokens.empty())
+		throw std::runtime_error("This is an ironman save. The converter doesn't ship CK2's binary token list, so it can't read one: save a "
+										 "non-ironman copy of the game, or fill in configurables/ck2_binary_tokens.txt for your CK2 version.");
+
+	// The tokens are decoded whole, the text they make is what gets parsed.
+	std::string gamestate;
+	if (saveGame.compressed)
+	{
+		zip_t* zip = zip_open(saveGamePath.c_str(), 0, 'r');
+		if (!zip || zip_entry_open(zip, saveGame.gamestateEntry.c_str()) != 0)
 		{
-			// this is a potential indep.
-			potentialIndeps.insert(std::pair(title.first, title.second));
+			if (zip)
+				zip_close(zip);
+			throw std::runtime_error("Failed to open gamestate in the compressed save!");
 		}
+		void* binary = nullptr;
+		std::size_t binarySize = 0;
+		const auto status = zip_entry_read(zip, &binary, &binarySize);
+		zip_entry_close(zip);
+		zip_close(zip);
+		if (status < 0 || !binary)
+		{
+			std::free(binary);
+			throw std::runtime_error("Failed to unpack the compressed save!");
+		}
+		try
+		{
+			gamestate = decodeBinaryGamestate(std::string_view(static_cast<const char*>(binary), binarySize), tokens);
+		}
+		catch (...)
+		{
+			std::free(binary);
+			throw;
+		}
+		std::free(binary);
+	}
+	else
+	{
+		const MappedFile binary(saveGamePath);
+		gamestate = decodeBinaryGamestate(std::string_view(binary.data(), binary.size()), tokens);
 	}
+	Log(LogLevel::Info) << "<> Decoded " << gamestate.size() / (1024 * 1024) << " MiB of gamestate with " << tokens.size() << " known tokens.";
 
-	// Check if we hold any actual land (b|c_something). (Only necessary for the holder,
-	// no need to recurse, we're just filtering landless titular titles like mercenaries
-	// or landless Pope. If a character holds a landless titular title along actual title
-	// (like Caliphate), it's not relevant at this stage as he's independent anyway.
+	SaveBuffer saveBuffer(gamestate.data(), gamestate.size());
+	std::istream gameState(&saveBuffer);
+	blockLoader.setSource(gamestate.data(), gamestate.size());
+	parseStream(gameState);
+	blockLoader.wait();
+}
 
-	// First, split off all county_title holders into a container.
-	std::set<int> countyHolders;
-	std::map<int, std::map<std::string, std::shared_ptr<Title>>> allTitleHolders;
+void CK2::World::filterIndependentTitles()
+{
+	const auto& allTitles = titles.getTitles();
+
+	// One sweep finds the potential indeps (held titles without a liege) and who holds actual land (b|c_something).
+	// Land only matters for the holder, no need to recurse, we're just filtering landless titular titles like
+	// mercenaries or landless Pope. If a character holds a landless titular title along actual title (like
+	// Caliphate), it's not relevant at this stage as they're independent anyway.
+	std::vector<const std::pair<const std::string, std::shared_ptr<Title>>*> potentialIndeps;
+	std::vector<bool> countyHolders; // by character ID
 	for (const auto& title: allTitles)
 	{
-		if (title.second->getHolder().first && (title.second->getName().find("c_") == 0 || title.second->getName().find("b_") == 0))
+		const auto holderID = title.second->getHolder().first;
+		if (holderID <= 0)
+			continue; // don't bother with titles without holders.
+		if (title.second->getLiege().first.empty())
+			potentialIndeps.emplace_back(&title); // this is a potential indep.
+		if (title.second->getRank() == Title::RANK::COUNTY || title.second->getRank() == Title::RANK::BARONY)
 		{
-			countyHolders.insert(title.second->getHolder().first);
+			if (countyHolders.size() <= static_cast<std::size_t>(holderID))
+				countyHolders.resize(static_cast<std::size_t>(holderID) + 1, false);
+			countyHolders[holderID] = true;
 		}
-		allTitleHolders[title.second->getHolder().first].insert(title);
 	}
 
+	// Whoever holds the papacies makes every independent title of theirs papal.
+	const auto holderOf = [&allTitles](const std::string& titleName) {
+		const auto& titleItr = allTitles.find(titleName);
+		return titleItr != allTitles.end() ? titleItr->second->getHolder().first : 0;
+	};
+	const auto popeID = holderOf("k_papal_state");
+	const auto fraticelliPopeID = holderOf("d_fraticelli");
+
 	// Then look at all potential indeps and see if their holders are up there.
 	auto counter = 0;
-	for (const auto& indep: potentialIndeps)
+	for (const auto* indep: potentialIndeps)
 	{
-		const auto& holderID = indep.second->getHolder().first;
-		if (countyHolders.count(holderID))
+		const auto holderID = indep->second->getHolder().first;
+		if (static_cast<std::size_t>(holderID) >= countyHolders.size() || !countyHolders[holderID])
+			continue;
+		// this fellow holds a county, so their indep title is an actual title.
+		independentTitles.insert(*indep);
+		counter++;
+		// Set The Pope(s)
+		if (indep->first == "k_papal_state")
 		{
-			// this fellow holds a county, so his indep title is an actual title.
-			independentTitles.insert(std::pair(indep.first, indep.second));
-			counter++;
-			// Set The Pope(s)
-			if (indep.first == "k_papal_state")
-			{
-				indep.second->setThePope();
-				Log(LogLevel::Debug) << indep.first << " is the Pope.";
-			}
-			else if (indep.first == "d_fraticelli")
+			indep->second->setThePope();
+			Log(LogLevel::Debug) << indep->first << " is the Pope.";
+		}
+		else if (indep->first == "d_fraticelli")
+		{
+			indep->second->setTheFraticelliPope();
+			Log(LogLevel::Debug) << indep->first << " is the Fraticelli Pope.";
+		}
+		else
+		{
+			if (holderID == fraticelliPopeID)
 			{
-				indep.second->setTheFraticelliPope();
-				Log(LogLevel::Debug) << indep.first << " is the Fraticelli Pope.";
+				indep->second->setTheFraticelliPope();
+				Log(LogLevel::Debug) << indep->first << " belongs to the Fraticelli Pope.";
 			}
-			else
+			if (holderID == popeID)
 			{
-				for (const auto& ownedTitle: allTitleHolders[holderID])
-				{
-					if (ownedTitle.first == "k_papal_state")
-					{
-						indep.second->setThePope();
-						Log(LogLevel::Debug) << indep.first << " belongs to the Pope.";
-					}
-					else if (ownedTitle.first == "d_fraticelli")
-					{
-						indep.second->setTheFraticelliPope();
-						Log(LogLevel::Debug) << indep.first << " belongs to the Fraticelli Pope.";
-					}
-				}
+				indep->second->setThePope();
+				Log(LogLevel::Debug) << indep->first << " belongs to the Pope.";
 			}
 		}
 	}
@@ -878,11 +1436,11 @@ void CK2::World::mergeIndependentBaronies() const
 		if (liege.first.empty())
 		{
 			// this is an indep.
-			if (title.first.find("b_") == 0)
+			if (title.second->getRank() == Title::RANK::BARONY)
 			{
 				// it's a barony.
 				const auto& djLiege = title.second->getDeJureLiege();
-				if (djLiege.first.find("c_") == 0)
+				if (Title::rankOf(djLiege.first) == Title::RANK::COUNTY)
 				{
 					// we're golden.
 					if (!title.second)
@@ -929,10 +1487,32 @@ void CK2::World::congregateDeJureProvinces()
 	Log(LogLevel::Info) << "<> " << counter << " de jure provinces claimed by independents.";
 }
 
-void CK2::World::sanityCheckifyProvinces()
+void CK2::World::sanityCheckifyProvinces(const Configuration& theConfiguration) const
 {
 	// This is a watchdog function intended to complain if multiple independent titles
 	// link to a single province.
+	if (theConfiguration.getValidation() == Configuration::VALIDATION::SUMMARY)
+	{
+		// One bit per province ID, and a count of the provinces found held twice.
+		std::vector<bool> held;
+		auto excess = 0;
+		for (const auto& indep: independentTitles)
+			for (const auto& province: indep.second->getProvinces())
+			{
+				const auto provinceID = static_cast<std::size_t>(province.first);
+				if (provinceID >= held.size())
+					held.resize(provinceID + 1);
+				if (held[provinceID])
+					++excess;
+				held[provinceID] = true;
+			}
+		if (!excess)
+			Log(LogLevel::Info) << "<> Province sanity check passed, all provinces accounted for.";
+		else
+			Log(LogLevel::Warning) << "!! Province sanity check failed! We have " << excess << " excess provinces! Set validation to full for which.";
+		return;
+	}
+
 	std::map<int, std::vector<std::string>> provinceTitlesMap; // we store all holders for every province.
 	auto sanity = true;
 
@@ -988,9 +1568,9 @@ void CK2::World::shatterEmpires(const Configuration& theConfiguration) const
 	{
 		if (hreTitle && empire.first == hreTitle->first)
 			continue; // This is HRE, wrong function for that one.
-		if (theConfiguration.getShatterEmpires() == Configuration::SHATTER_EMPIRES::CUSTOM && !shatterEmpiresMapper.isEmpireShatterable(empire.first))
+		if (theConfiguration.getShatterEmpires() == Configuration::SHATTER_EMPIRES::CUSTOM && !shatterEmpiresMapper->isEmpireShatterable(empire.first))
 			continue; // Only considering those listed.
-		if (empire.first.find("e_") != 0 && theConfiguration.getShatterEmpires() != Configuration::SHATTER_EMPIRES::CUSTOM)
+		if (empire.second->getRank() != Title::RANK::EMPIRE && theConfiguration.getShatterEmpires() != Configuration::SHATTER_EMPIRES::CUSTOM)
 			continue; // Otherwise only empires.
 		if (empire.second->getVassals().empty())
 			continue; // Not relevant.
@@ -999,11 +1579,11 @@ void CK2::World::shatterEmpires(const Configuration& theConfiguration) const
 		std::map<std::string, std::shared_ptr<Title>> members;
 		for (const auto& vassal: empire.second->getVassals())
 		{
-			if (vassal.first.find("d_") == 0 || vassal.first.find("c_") == 0)
+			if (vassal.second->getRank() == Title::RANK::DUCHY || vassal.second->getRank() == Title::RANK::COUNTY)
 			{
 				members.insert(std::pair(vassal.first, vassal.second));
 			}
-			else if (vassal.first.find("k_") == 0)
+			else if (vassal.second->getRank() == Title::RANK::KINGDOM)
 			{
 				if (shatterKingdoms && !vassal.second->isThePope() && !vassal.second->isTheFraticelliPope() && vassal.first != "k_orthodox")
 				{ // hard override for special empire members
@@ -1022,7 +1602,7 @@ void CK2::World::shatterEmpires(const Configuration& theConfiguration) const
 					members.insert(std::pair(vassal.first, vassal.second));
 				}
 			}
-			else if (vassal.first.find("b_") != 0)
+			else if (vassal.second->getRank() != Title::RANK::BARONY)
 			{
 				Log(LogLevel::Warning) << "Unrecognized vassal level: " << vassal.first;
 			}
@@ -1056,7 +1636,7 @@ void CK2::World::flagHREProvinces(const Configuration& theConfiguration)
 			hreTitleStr = "e_roman_empire";
 			break;
 		case Configuration::I_AM_HRE::CUSTOM:
-			hreTitleStr = iAmHreMapper.getHRE();
+			hreTitleStr = iAmHreMapper->getHRE();
 			break;
 		case Configuration::I_AM_HRE::NONE:
 			Log(LogLevel::Info) << ">< HRE Provinces not available due to configuration disabling HRE Mechanics.";
@@ -1099,11 +1679,11 @@ void CK2::World::shatterHRE(const Configuration& theConfiguration) const
 	std::map<std::string, std::shared_ptr<Title>> hreMembers;
 	for (const auto& vassal: hreTitle->second->getVassals())
 	{
-		if (vassal.first.find("d_") == 0 || vassal.first.find("c_") == 0)
+		if (vassal.second->getRank() == Title::RANK::DUCHY || vassal.second->getRank() == Title::RANK::COUNTY)
 		{
 			hreMembers.insert(std::pair(vassal.first, vassal.second));
 		}
-		else if (vassal.first.find("k_") == 0)
+		else if (vassal.second->getRank() == Title::RANK::KINGDOM)
 		{
 			if (vassal.first == "k_papacy" || vassal.first == "k_papal_state" || vassal.first == "k_orthodox" ||
 				 theConfiguration.getShatterHRELevel() == Configuration::SHATTER_HRE_LEVEL::KINGDOM) // hard override for special HRE members
@@ -1120,7 +1700,7 @@ void CK2::World::shatterHRE(const Configuration& theConfiguration) const
 			vassal.second->clearHolder();
 			vassal.second->clearLiege();
 		}
-		else if (vassal.first.find("b_") != 0)
+		else if (vassal.second->getRank() != Title::RANK::BARONY)
 		{
 			Log(LogLevel::Warning) << "Unrecognized HRE vassal: " << vassal.first;
 		}
@@ -1137,7 +1717,7 @@ void CK2::World::shatterHRE(const Configuration& theConfiguration) const
 			Log(LogLevel::Debug) << "Nominal kingdom: " << nominalKingdom->first;
 			for (const auto& member: hreMembers)
 			{
-				if (member.first.find("k_") != 0)
+				if (member.second->getRank() != Title::RANK::KINGDOM)
 					continue;
 				if (nominalKingdom->first == member.first && member.second->getHolder().first == hreHolder.first)
 				{
@@ -1157,7 +1737,7 @@ void CK2::World::shatterHRE(const Configuration& theConfiguration) const
 				Log(LogLevel::Debug) << "Nominal duchy: " << nominalDuchy->first;
 				for (const auto& member: hreMembers)
 				{
-					if (member.first.find("d_") != 0)
+					if (member.second->getRank() != Title::RANK::DUCHY)
 						continue;
 					if (nominalDuchy->first == member.first && member.second->getHolder().first == hreHolder.first)
 					{
@@ -1175,7 +1755,7 @@ void CK2::World::shatterHRE(const Configuration& theConfiguration) const
 			Log(LogLevel::Debug) << "HRE capital's county: " << hreCapital.second->getDeJureTitle().first;
 			for (const auto& member: hreMembers)
 			{
-				if (member.first.find("c_") != 0)
+				if (member.second->getRank() != Title::RANK::COUNTY)
 					continue;
 				if (hreCapital.second->getDeJureTitle().first == member.first && member.second->getHolder().first == hreHolder.first)
 				{
@@ -1253,59 +1833,62 @@ void CK2::World::createReformedFeatures()
 		wereNoReformations = false;
 	}
 
+	const auto& entries = reformedReligionMapper.getReligionEntries();
+
 	// All Reformed Religions
 	for (const auto& reformation: reformationList)
 	{
+		const auto& reformationEntry = entries.find(reformation)->second;
 		mappers::ReformedReligionMapping tempReligion;
 
 		tempReligion.setName(reformation);
-		tempReligion.setIconNumber(reformedReligionMapper.getReligionEntries().find(reformation)->second.getIconNumber());
-		tempReligion.setColor(reformedReligionMapper.getReligionEntries().find(reformation)->second.getColor());
-		for (auto tempReform: religions.getReformedReligion().find(reformation)->second)
+		tempReligion.setIconNumber(reformationEntry.getIconNumber());
+		tempReligion.setColor(reformationEntry.getColor());
+		for (const auto& tempReform: religions.getReformedReligion().find(reformation)->second)
 		{
-			tempReligion.addCountryModifiers(reformedReligionMapper.getReligionEntries().find(tempReform)->second.getCountryModifiers());
-			tempReligion.addProvinceModifiers(reformedReligionMapper.getReligionEntries().find(tempReform)->second.getProvinceModifiers());
-			tempReligion.addSecondary(reformedReligionMapper.getReligionEntries().find(tempReform)->second.getSecondary());
+			const auto& reformEntry = entries.find(tempReform)->second;
+			tempReligion.addCountryModifiers(reformEntry.getCountryModifiers());
+			tempReligion.addProvinceModifiers(reformEntry.getProvinceModifiers());
+			tempReligion.addSecondary(reformEntry.getSecondary());
 			if (unique.count(tempReform) || tempReligion.getUniqueMechanics().length() == 0) // Ensures that unique Mechanics get in
-				tempReligion.setUniqueMechanics(reformedReligionMapper.getReligionEntries().find(tempReform)->second.getUniqueMechanics());
-			tempReligion.addNonUniqueMechanics(reformedReligionMapper.getReligionEntries().find(tempReform)->second.getNonUniqueMechanics());
+				tempReligion.setUniqueMechanics(reformEntry.getUniqueMechanics());
+			tempReligion.addNonUniqueMechanics(reformEntry.getNonUniqueMechanics());
 		}
-		tempReligion.setHereticStrings(reformedReligionMapper.getReligionEntries().find(reformation)->second.getHereticStrings());
+		tempReligion.setHereticStrings(reformationEntry.getHereticStrings());
 
-		religionReforms.push_back(tempReligion);
+		religionReforms.emplace_back(std::move(tempReligion));
 	}
 
-	// And now for all the unreformed religions
-	for (const auto& religion: reformedReligionMapper.getReligionEntries())
+	// And now for all the unreformed religions. Once anything reformed, reform features (religion_...) never count,
+	// and a single reformed feature rules them all out.
+	std::unordered_set<std::string> reformedNames;
+	auto featureReformed = false;
+	for (const auto& reform: religionReforms)
 	{
-		bool tester = false;
-		for (auto reform: religionReforms)
-		{
-			if (religion.first == reform.getName() || !reform.getName().find("religion_") || !religion.first.find("religion_"))
-			{
-				tester = true;
-				break;
-			}
-		}
-		if (!tester)
-			unreformationList.insert(religion.first);
+		reformedNames.insert(reform.getName());
+		if (reform.getName().starts_with("religion_"))
+			featureReformed = true;
 	}
+	for (const auto& religionName: entries | std::views::keys)
+		if (religionReforms.empty() || (!featureReformed && !religionName.starts_with("religion_") && !reformedNames.contains(religionName)))
+			unreformationList.insert(religionName);
 
-	for (auto unreformed: unreformationList)
+	for (const auto& unreformed: unreformationList)
 	{
+		const auto& unreformedEntry = entries.find(unreformed)->second;
 		mappers::ReformedReligionMapping tempUnreligion;
 
 		tempUnreligion.setName(unreformed);
-		tempUnreligion.setIconNumber(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getIconNumber());
-		tempUnreligion.setColor(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getColor());
-		tempUnreligion.setCountryModifiers(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getCountryModifiers());
-		tempUnreligion.setProvinceModifiers(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getProvinceModifiers());
-		tempUnreligion.setSecondary(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getSecondary());
-		tempUnreligion.setUniqueMechanics(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getUniqueMechanics());
-		tempUnreligion.setNonUniqueMechanics(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getNonUniqueMechanics());
-		tempUnreligion.setHereticStrings(reformedReligionMapper.getReligionEntries().find(unreformed)->second.getHereticStrings());
-
-		unreligionReforms.push_back(tempUnreligion);
+		tempUnreligion.setIconNumber(unreformedEntry.getIconNumber());
+		tempUnreligion.setColor(unreformedEntry.getColor());
+		tempUnreligion.setCountryModifiers(unreformedEntry.getCountryModifiers());
+		tempUnreligion.setProvinceModifiers(unreformedEntry.getProvinceModifiers());
+		tempUnreligion.setSecondary(unreformedEntry.getSecondary());
+		tempUnreligion.setUniqueMechanics(unreformedEntry.getUniqueMechanics());
+		tempUnreligion.setNonUniqueMechanics(unreformedEntry.getNonUniqueMechanics());
+		tempUnreligion.setHereticStrings(unreformedEntry.getHereticStrings());
+
+		unreligionReforms.emplace_back(std::move(tempUnreligion));
 	}
 
 	Log(LogLevel::Info) << "<> " << reformationList.size() << " religion(s) reformed in CK2.";
@@ -1,6 +1,7 @@
 #ifndef CK2_WORLD_H
 #define CK2_WORLD_H
 #include "../Mappers/IAmHreMapper/IAmHreMapper.h"
+#include "../Mappers/LazyMapper/LazyMapper.h"
 #include "../Mappers/PersonalityScraper/PersonalityScraper.h"
 #include "../Mappers/ProvinceTitleMapper/ProvinceTitleMapper.h"
 #include "../Mappers/ReformedReligionMapper/ReformedReligionMapper.h"
@@ -11,18 +12,28 @@
 #include "ConverterVersion.h"
 #include "Date.h"
 #include "Dynasties/Dynasties.h"
+#include "EntityArena.h"
 #include "Flags/Flags.h"
 #include "GameVersion.h"
+#include "HolderIndex.h"
+#include "InstallData.h"
 #include "ModLoader/ModLoader.h"
 #include "Offmaps/Offmaps.h"
 #include "Parser.h"
+#include "PhaseTimings.h"
 #include "Provinces/Province.h"
 #include "Provinces/Provinces.h"
 #include "Relations/AllRelations.h"
 #include "Religions/Religions.h"
+#include "SaveGame/BlockLoader.h"
+#include "SaveGame/MappedFile.h"
+#include "SaveGame/Snapshot.h"
 #include "Titles/Liege.h"
 #include "Titles/Titles.h"
 #include "Vars/Vars.h"
+#include <future>
+#include <initializer_list>
+#include <vector>
 #include "Wonders/Wonders.h"
 
 class Configuration;
@@ -32,7 +43,13 @@ namespace CK2
 class World: commonItems::parser
 {
   public:
-	explicit World(const Configuration& theConfiguration, const commonItems::ConverterVersion& converterVersion);
+	World(const Configuration& theConfiguration,
+		 const commonItems::ConverterVersion& converterVersion,
+		 PhaseTimings& timings,
+		 const InstallSource& installSource = InstallData::load);
+	~World();
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
 
 	[[nodiscard]] const auto& getProvinceTitleMapper() const { return provinceTitleMapper; }
 	[[nodiscard]] const auto& getIndepTitles() const { return independentTitles; }
@@ -54,17 +71,45 @@ class World: commonItems::parser
 
 	void setExistentPremadeMonuments(std::set<std::string> premades) { existentPremadeMonuments = premades; }
 
+	// Tells worlds apart by everything that goes into building one: the save, installs and mods, the settings the CK2
+	// phases act on and the configurables they read. Two conversions with the same key build identical worlds.
+	[[nodiscard]] static std::string buildKey(const Configuration& theConfiguration, const std::string& converterVersion);
+	// The settings and configurables of those that a checkpoint's key takes on top of the snapshot's.
+	[[nodiscard]] static std::vector<std::string> phaseOptions(const Configuration& theConfiguration);
+
   private:
+	friend class ConversionMarks;
+
 	void registerKeys(const commonItems::ConverterVersion& converterVersion);
 
 	bool uncompressSave(const std::string& saveGamePath);
+	void parseCompressedGamestate(const std::string& saveGamePath);
+	void parseBinaryGamestate(const std::string& saveGamePath);
+	void importSave(const std::string& saveGamePath);
+	[[nodiscard]] bool loadSnapshot(const std::string& snapshotPath, const std::string& snapshotKey);
+	bool saveSnapshot(const std::string& snapshotPath, const std::string& snapshotKey);
+	void clearSnapshotState();
+	[[nodiscard]] bool loadCheckpoint(const std::string& checkpointPath, const std::string& checkpointKey);
+	void saveCheckpoint(const std::string& checkpointPath, const std::string& checkpointKey);
+	// From a loaded checkpoint on to where the constructor ends.
+	void resumeFromCheckpoint(const Configuration& theConfiguration, const std::string& overrideModPath, PhaseTimings& timings);
+	// The campaign's last save restored from its snapshot, and the digests of that save's blocks. Nothing if it can't be.
+	[[nodiscard]] std::map<std::string, std::string> loadCampaign(const std::string& campaignKey, const std::string& converterVersion, const std::string& CK2Path);
+	void settleReusedBlocks(const std::map<std::string, std::string>& previousDigests);
+	void saveCampaign(const std::string& campaignKey, const std::string& saveHash) const;
+	[[nodiscard]] Snapshot::State snapshotState();
+	[[nodiscard]] Snapshot::Built builtState();
+	// When each of these was last written, in configurables/ and the override mods' folders under it.
+	[[nodiscard]] static std::vector<std::string> configurablesModified(std::initializer_list<const char*> files);
+	void setFlags();
+	void releaseCharacters(PhaseTimings& timings); // the last steps, once the world is built
 	void alterSunset(const Configuration& theConfiguration);
 	void verifySave(const std::string& saveGamePath);
 	void filterIndependentTitles();
 	void mergeIndependentBaronies() const;
 	void congregateProvinces();
 	void congregateDeJureProvinces();
-	void sanityCheckifyProvinces();
+	void sanityCheckifyProvinces(const Configuration& theConfiguration) const;
 	void shatterHRE(const Configuration& theConfiguration) const;
 	void flagHREProvinces(const Configuration& theConfiguration);
 	void shatterEmpires(const Configuration& theConfiguration) const;
@@ -73,31 +118,38 @@ class World: commonItems::parser
 	void gatherCourtierNames();
 	void determineHeirs();
 	void createReformedFeatures();
-	void resolvePrimogeniture(const std::string& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const;
-	void resolveUltimogeniture(const std::string& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const;
-	void resolveTanistry(const std::string& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const;
+	void resolvePrimogeniture(const parsing::Symbol& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const;
+	void resolveUltimogeniture(const parsing::Symbol& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const;
+	void resolveTanistry(const parsing::Symbol& genderLaw, const std::pair<int, std::shared_ptr<Character>>& holder) const;
 	void resolveTurkish(const std::pair<int, std::shared_ptr<Character>>& holder) const;
 	void linkCelestialEmperor() const;
 	void linkElectors();
-	void loadDynasties(const Configuration& theConfiguration);
-	void loadProvinces(const Configuration& theConfiguration);
+	void takeInstallDynasties();
+	void pruneCharacters();
+	void takeCensus(PhaseTimings& timings) const; // if timings takes one
 
+	// Members go in the reverse order, so these two go last: the arena holding our entities, and the install data
+	// whose dynasties our characters may still point at while the rest comes apart.
+	EntityArena arena;
+	std::shared_future<std::shared_ptr<const InstallData>> installData; // loading alongside the save
 	bool leviathanDLC;
 	bool invasion = false;
 	bool wereNoReformations = true;
 	bool greekReformation = false;
-	date endDate = date("1444.11.11");
-	date startDate = date("1.1.1");
+	date endDate = date(1444, 11, 11);
+	date startDate = date(1, 1, 1);
 	GameVersion CK2Version;
 	std::optional<std::pair<std::string, std::shared_ptr<Title>>> hreTitle; // loaded by configuration option.
 
 	struct saveData
 	{
 		bool compressed = false;
-		std::string metadata;
-		std::string gamestate;
+		bool binary = false;		  // ironman, decoded to text before parsing
+		std::string gamestateEntry; // name of the gamestate inside compressed saves, inflated while parsing
+		MappedFile mappedGamestate; // uncompressed saves are read in place
 	};
 	saveData saveGame;
+	Characters::DETAILS characterDetails = Characters::DETAILS::LAZY;
 
 	Provinces provinces;
 	Characters characters;
@@ -110,12 +162,14 @@ class World: commonItems::parser
 	Flags flags;
 	Vars vars;
 	Religions religions;
-	mappers::ShatterEmpiresMapper shatterEmpiresMapper;
-	mappers::IAmHreMapper iAmHreMapper;
+	HolderIndex holderIndex;
+	bool installDynastiesTaken = false;
+	mappers::LazyMapper<mappers::ShatterEmpiresMapper> shatterEmpiresMapper;
+	mappers::LazyMapper<mappers::IAmHreMapper> iAmHreMapper;
 	mappers::PersonalityScraper personalityScraper;
 	mappers::ProvinceTitleMapper provinceTitleMapper;
 	mappers::ReformedReligionMapper reformedReligionMapper;
-	mappers::VassalSplitoffMapper vassalSplitoffMapper;
+	mappers::LazyMapper<mappers::VassalSplitoffMapper> vassalSplitoffMapper;
 	std::map<std::string, std::shared_ptr<Title>> independentTitles;
 	std::map<std::string, Liege> dynamicTitles; // Reusing Liege as it has identical structure
 	std::vector<mappers::ReformedReligionMapping> religionReforms;
@@ -123,6 +177,7 @@ class World: commonItems::parser
 	std::set<std::string> reformationList;
 	std::set<std::string> unreformationList;
 	std::set<std::string> existentPremadeMonuments;
+	BlockLoader blockLoader; // last, so pending block parsers are joined before anything they write to goes away.
 };
 } // namespace CK2
 
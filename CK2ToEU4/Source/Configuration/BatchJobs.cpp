@@ -0,0 +1,163 @@
+#include "BatchJobs.h"
+#include "CommonRegexes.h"
+#include "Configuration.h"
+#include "Log.h"
+#include "ParserHelpers.h"
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+// The settings a sweep may vary, those the CK2 world is built with first so that a world's variants come one after
+// another.
+constexpr std::array sweepableSettings{"shatter_empires", "shatter_level", "split_vassals", "dejure", "development", "start_date"};
+
+class JobParser: commonItems::parser
+{
+  public:
+	JobParser(std::istream& theStream, const bool sweep)
+	{
+		if (sweep)
+			for (const auto* setting: sweepableSettings)
+				registerKeyword(setting, [this, setting](const std::string& unused, std::istream& theStream) {
+					const auto values = commonItems::stringList(theStream).getStrings();
+					if (!values.empty())
+						options.emplace_back(setting, values);
+				});
+		registerKeyword("save", [this](const std::string& unused, std::istream& theStream) {
+			job.save = commonItems::singleString(theStream).getString();
+		});
+		registerKeyword("configuration", [this](const std::string& unused, std::istream& theStream) {
+			job.configuration = commonItems::singleString(theStream).getString();
+		});
+		registerKeyword("output_name", [this](const std::string& unused, std::istream& theStream) {
+			job.outputName = commonItems::singleString(theStream).getString();
+		});
+		registerKeyword("priority", [this](const std::string& unused, std::istream& theStream) {
+			const auto priority = commonItems::singleString(theStream).getString();
+			if (priority == "interactive")
+				job.priority = BatchJobs::PRIORITY::INTERACTIVE;
+			else if (priority == "bulk")
+				job.priority = BatchJobs::PRIORITY::BULK;
+			else
+				Log(LogLevel::Warning) << "Unknown job priority " << priority << ", converting as bulk.";
+		});
+		registerKeyword("threads", [this](const std::string& unused, std::istream& theStream) {
+			job.threads = std::stoull(commonItems::singleString(theStream).getString());
+		});
+		registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+		parseStream(theStream);
+		clearRegisteredKeywords();
+		std::ranges::stable_sort(options, {}, [](const auto& option) {
+			return std::ranges::find(sweepableSettings, option.first) - sweepableSettings.begin();
+		});
+	}
+
+	BatchJobs::Job job;
+	std::vector<std::pair<std::string, std::vector<std::string>>> options;
+};
+} // namespace
+
+BatchJobs::BatchJobs(const std::string& filePath)
+{
+	registerKeys();
+	parseFile(filePath);
+	clearRegisteredKeywords();
+	Log(LogLevel::Info) << "<> " << jobs.size() << " jobs read from " << filePath;
+}
+
+BatchJobs::BatchJobs(std::istream& theStream)
+{
+	registerKeys();
+	parseStream(theStream);
+	clearRegisteredKeywords();
+}
+
+void BatchJobs::registerKeys()
+{
+	registerKeyword("conversions", [this](const std::string& unused, std::istream& theStream) {
+		conversions = std::max<std::size_t>(1, std::stoull(commonItems::singleString(theStream).getString()));
+	});
+	registerKeyword("threads", [this](const std::string& unused, std::istream& theStream) {
+		threads = std::stoull(commonItems::singleString(theStream).getString());
+	});
+	registerKeyword("memory_budget", [this](const std::string& unused, std::istream& theStream) {
+		memoryBudgetMB = std::stoull(commonItems::singleString(theStream).getString());
+	});
+	registerKeyword("cache_limit", [this](const std::string& unused, std::istream& theStream) {
+		cacheLimitMB = std::stoull(commonItems::singleString(theStream).getString());
+	});
+	registerKeyword("remote_cache", [this](const std::string& unused, std::istream& theStream) {
+		remoteCache = commonItems::singleString(theStream).getString();
+	});
+	registerKeyword("remote_cache_key", [this](const std::string& unused, std::istream& theStream) {
+		remoteCacheKey = commonItems::singleString(theStream).getString();
+	});
+	registerKeyword("job", [this](const std::string& unused, std::istream& theStream) {
+		auto job = JobParser(theStream, false).job;
+		if (job.save.empty())
+		{
+			Log(LogLevel::Warning) << "Skipping a batch job without a save.";
+			return;
+		}
+		jobs.emplace_back(std::move(job));
+	});
+	registerKeyword("sweep", [this](const std::string& unused, std::istream& theStream) {
+		const JobParser sweep(theStream, true);
+		if (sweep.job.save.empty())
+		{
+			Log(LogLevel::Warning) << "Skipping a sweep without a save.";
+			return;
+		}
+		addSweep(sweep.job, sweep.options);
+	});
+	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+}
+
+void BatchJobs::addSweep(const Job& base, const std::vector<std::pair<std::string, std::vector<std::string>>>& options)
+{
+	auto named = base;
+	if (named.outputName.empty())
+		named.outputName = std::filesystem::u8path(base.save).stem().string();
+	named.settings.emplace_back("reuse_ck2_world", std::to_string(static_cast<int>(Configuration::REUSE_WORLD::ENABLED)));
+
+	// Counts through the combinations like an odometer, the last setting turning fastest.
+	std::vector<std::size_t> picked(options.size(), 0);
+	std::size_t variants = 0;
+	while (true)
+	{
+		auto job = named;
+		for (std::size_t option = 0; option < options.size(); ++option)
+		{
+			const auto& [setting, values] = options[option];
+			job.outputName += "_" + setting + values[picked[option]];
+			job.settings.emplace_back(setting, values[picked[option]]);
+		}
+		jobs.emplace_back(std::move(job));
+		++variants;
+
+		auto option = options.size();
+		while (option > 0 && ++picked[option - 1] == options[option - 1].second.size())
+			picked[--option] = 0;
+		if (option == 0)
+			break;
+	}
+	Log(LogLevel::Info) << "<> Sweeping " << base.save << " over " << variants << " variants.";
+}
+
+std::string BatchJobs::settingsFor(const Job& job)
+{
+	std::ifstream configurationFile(std::filesystem::u8path(job.configuration), std::ios::binary);
+	if (!configurationFile.is_open())
+		throw std::runtime_error("Could not open " + job.configuration);
+	std::string settings{std::istreambuf_iterator<char>(configurationFile), std::istreambuf_iterator<char>()};
+	// Later keys win. An empty output name falls back to the save's name, whatever the configuration had.
+	settings += "\nSaveGame = \"" + job.save + "\"\n";
+	settings += "output_name = \"" + job.outputName + "\"\n";
+	for (const auto& [key, value]: job.settings)
+		settings += key + " = \"" + value + "\"\n";
+	return settings;
+}
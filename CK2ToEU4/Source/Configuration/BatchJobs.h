@@ -0,0 +1,71 @@
+#ifndef BATCH_JOBS_H
+#define BATCH_JOBS_H
+#include "Parser.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The jobs file of a batch conversion, CK2ToEU4Converter --batch <file>:
+//   conversions = "4"		  # side by side at most, default 1
+//   threads = "0"				  # shared by all of them, 0 for one per core
+//   memory_budget = "16384" # MB the conversions side by side may take between them, 0 (default) for no limit
+//   cache_limit = "8192"	  # MB the caches under snapshots/ may grow to, 0 (default) for no limit
+//   remote_cache = "http://cache:8080/ck2toeu4" # the farm's shared cache of install-derived data, none by default
+//   remote_cache_key = "..." # required with remote_cache: at least 16 characters, the same on every machine
+//   job = { save = "a.ck2" configuration = "configuration.txt" output_name = "a" priority = interactive threads = "2" }
+//   sweep = { save = "a.ck2" output_name = "a" shatter_empires = { "1" "3" } dejure = { "1" "2" } }
+// A job's configuration defaults to configuration.txt and its output name to the save's file name. Interactive jobs
+// start before bulk ones (the default), and a job's threads, 0 by default, caps what it may use of the shared ones.
+// Entries of the remote cache are signed with the key and those that come back unsigned or mis-signed are rebuilt,
+// but the traffic itself is plain HTTP, so the cache belongs on the farm's own network.
+// A sweep takes the same settings as a job and becomes one job for every combination of the values listed for
+// shatter_empires, shatter_level, split_vassals, dejure, development and start_date, each written over the
+// configuration and named after them (a_shatter_empires1_dejure1, ...). Its jobs reuse their CK2 worlds, so the
+// save is parsed once and each world is built once for the variants differing only in their EU4 settings.
+class BatchJobs: commonItems::parser
+{
+  public:
+	enum class PRIORITY
+	{
+		INTERACTIVE = 1,
+		BULK = 2
+	};
+	struct Job
+	{
+		std::string save;
+		std::string configuration = "configuration.txt";
+		std::string outputName;
+		PRIORITY priority = PRIORITY::BULK;
+		std::size_t threads = 0;
+		std::vector<std::pair<std::string, std::string>> settings; // written over the configuration, for sweeps
+	};
+
+	explicit BatchJobs(const std::string& filePath);
+	explicit BatchJobs(std::istream& theStream);
+
+	[[nodiscard]] const auto& getJobs() const { return jobs; }
+	[[nodiscard]] const auto& getConversions() const { return conversions; }
+	[[nodiscard]] const auto& getThreads() const { return threads; }
+	[[nodiscard]] const auto& getMemoryBudgetMB() const { return memoryBudgetMB; }
+	[[nodiscard]] const auto& getCacheLimitMB() const { return cacheLimitMB; }
+	[[nodiscard]] const auto& getRemoteCache() const { return remoteCache; }
+	[[nodiscard]] const auto& getRemoteCacheKey() const { return remoteCacheKey; }
+
+	// The job's configuration file with its save, output name and settings written over it, for Configuration to parse.
+	[[nodiscard]] static std::string settingsFor(const Job& job);
+
+  private:
+	void registerKeys();
+	void addSweep(const Job& base, const std::vector<std::pair<std::string, std::vector<std::string>>>& options);
+
+	std::vector<Job> jobs;
+	std::size_t conversions = 1;
+	std::size_t threads = 0;
+	std::size_t memoryBudgetMB = 0;
+	std::size_t cacheLimitMB = 0;
+	std::string remoteCache;
+	std::string remoteCacheKey;
+};
+
+#endif // BATCH_JOBS_H
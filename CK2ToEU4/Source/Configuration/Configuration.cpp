@@ -14,13 +14,19 @@ Configuration::Configuration(const commonItems::ConverterVersion& converterVersi
 	parseFile("configuration.txt");
 	clearRegisteredKeywords();
 	setOutputName();
-	verifyCK2Path();
-	verifyCK2Version(converterVersion);
-	verifyEU4Path();
-	verifyEU4Version(converterVersion);
+	verifyInstalls(converterVersion);
 	Log(LogLevel::Progress) << "3 %";
 }
 
+Configuration::Configuration(const commonItems::ConverterVersion& converterVersion, std::istream& theStream)
+{
+	registerKeys();
+	parseStream(theStream);
+	clearRegisteredKeywords();
+	setOutputName();
+	verifyInstalls(converterVersion);
+}
+
 Configuration::Configuration(std::istream& theStream)
 {
 	registerKeys();
@@ -108,6 +114,115 @@ void Configuration::registerKeys()
 		development = DEVELOPMENT(std::stoi(developmentString.getString()));
 		Log(LogLevel::Info) << "Development set to: " << developmentString.getString();
 	});
+	registerKeyword("snapshot", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString snapshotString(theStream);
+		snapshot = SNAPSHOT(std::stoi(snapshotString.getString()));
+		Log(LogLevel::Info) << "Snapshot set to: " << snapshotString.getString();
+	});
+	registerKeyword("archive", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString archiveString(theStream);
+		archive = ARCHIVE(std::stoi(archiveString.getString()));
+		Log(LogLevel::Info) << "Archive set to: " << archiveString.getString();
+	});
+	registerKeyword("incremental", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString incrementalString(theStream);
+		incremental = INCREMENTAL(std::stoi(incrementalString.getString()));
+		Log(LogLevel::Info) << "Incremental output set to: " << incrementalString.getString();
+	});
+	registerKeyword("staging", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString stagingString(theStream);
+		staging = STAGING(std::stoi(stagingString.getString()));
+		Log(LogLevel::Info) << "Output staging set to: " << stagingString.getString();
+	});
+	registerKeyword("output_sink", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString outputSinkString(theStream);
+		outputSink = OUTPUT_SINK(std::stoi(outputSinkString.getString()));
+		Log(LogLevel::Info) << "Output sink set to: " << outputSinkString.getString();
+	});
+	registerKeyword("validation", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString validationString(theStream);
+		validation = VALIDATION(std::stoi(validationString.getString()));
+		Log(LogLevel::Info) << "Validation set to: " << validationString.getString();
+	});
+	registerKeyword("timings", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString timingsString(theStream);
+		timings = TIMINGS(std::stoi(timingsString.getString()));
+		Log(LogLevel::Info) << "Phase timings set to: " << timingsString.getString();
+	});
+	registerKeyword("hardware_counters", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString hardwareCountersString(theStream);
+		hardwareCounters = HARDWARE_COUNTERS(std::stoi(hardwareCountersString.getString()));
+		Log(LogLevel::Info) << "Hardware counters set to: " << hardwareCountersString.getString();
+	});
+	registerKeyword("memory_census", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString memoryCensusString(theStream);
+		memoryCensus = MEMORY_CENSUS(std::stoi(memoryCensusString.getString()));
+		Log(LogLevel::Info) << "Memory census set to: " << memoryCensusString.getString();
+	});
+	registerKeyword("contention", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString contentionString(theStream);
+		contention = CONTENTION(std::stoi(contentionString.getString()));
+		Log(LogLevel::Info) << "Contention profiling set to: " << contentionString.getString();
+	});
+	registerKeyword("trace", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString traceString(theStream);
+		trace = TRACE(std::stoi(traceString.getString()));
+		Log(LogLevel::Info) << "Conversion trace set to: " << traceString.getString();
+	});
+	registerKeyword("lookup_trace", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString lookupTraceString(theStream);
+		lookupTrace = LOOKUP_TRACE(std::stoi(lookupTraceString.getString()));
+		Log(LogLevel::Info) << "Lookup trace set to: " << lookupTraceString.getString();
+	});
+	registerKeyword("reuse_ck2_world", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString reuseString(theStream);
+		reuseWorld = REUSE_WORLD(std::stoi(reuseString.getString()));
+		Log(LogLevel::Info) << "CK2 world reuse set to: " << reuseString.getString();
+	});
+	registerKeyword("ck2_checkpoint", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString checkpointString(theStream);
+		checkpoint = CHECKPOINT(std::stoi(checkpointString.getString()));
+		Log(LogLevel::Info) << "CK2 world checkpoint set to: " << checkpointString.getString();
+	});
+	registerKeyword("threads", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString threadsString(theStream);
+		threads = std::stoul(threadsString.getString());
+		Log(LogLevel::Info) << "Threads set to: " << threadsString.getString();
+	});
+	registerKeyword("cache_limit", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString cacheLimitString(theStream);
+		cacheLimitMB = std::stoull(cacheLimitString.getString());
+		Log(LogLevel::Info) << "Cache limit set to: " << cacheLimitString.getString() << " MB";
+	});
+	registerKeyword("remote_cache", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString remoteCacheString(theStream);
+		remoteCache = remoteCacheString.getString();
+		Log(LogLevel::Info) << "Remote cache set to: " << remoteCache;
+	});
+	registerKeyword("remote_cache_key", [this](const std::string& unused, std::istream& theStream) {
+		remoteCacheKey = commonItems::singleString(theStream).getString();
+		Log(LogLevel::Info) << "Remote cache key set.";
+	});
+	registerKeyword("character_decoding", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString decodingString(theStream);
+		characterDecoding = CHARACTER_DECODING(std::stoi(decodingString.getString()));
+		Log(LogLevel::Info) << "Character decoding set to: " << decodingString.getString();
+	});
+	registerKeyword("task_order_seed", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString seedString(theStream);
+		taskOrderSeed = static_cast<std::uint32_t>(std::stoul(seedString.getString()));
+		Log(LogLevel::Info) << "Task order seed set to: " << seedString.getString();
+	});
+	registerKeyword("profile_from", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString profileFromString(theStream);
+		profileFrom = profileFromString.getString();
+		Log(LogLevel::Info) << "Profiling from phase: " << profileFrom;
+	});
+	registerKeyword("stop_after", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString stopAfterString(theStream);
+		stopAfter = stopAfterString.getString();
+		Log(LogLevel::Info) << "Stopping after phase: " << stopAfter;
+	});
 	registerKeyword("selectedMods", [this](const std::string& unused, std::istream& theStream) {
 		for (const auto& path: commonItems::getStrings(theStream))
 			mods.emplace_back(Mod("", path));
@@ -116,6 +231,14 @@ void Configuration::registerKeys()
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
+void Configuration::verifyInstalls(const commonItems::ConverterVersion& converterVersion) const
+{
+	verifyCK2Path();
+	verifyCK2Version(converterVersion);
+	verifyEU4Path();
+	verifyEU4Version(converterVersion);
+}
+
 void Configuration::verifyCK2Path() const
 {
 	if (!commonItems::DoesFolderExist(CK2Path))
@@ -202,3 +325,33 @@ void Configuration::verifyEU4Version(const commonItems::ConverterVersion& conver
 		throw std::runtime_error("Converter vs EU4 installation mismatch!");
 	}
 }
+
+Configuration Configuration::withOutputName(const std::string& name) const
+{
+	auto renamed = *this;
+	renamed.outputName = name;
+	return renamed;
+}
+
+Configuration Configuration::withTuning(const std::size_t theThreads, const CHARACTER_DECODING theCharacterDecoding) const
+{
+	auto tuned = *this;
+	tuned.threads = theThreads;
+	tuned.characterDecoding = theCharacterDecoding;
+	return tuned;
+}
+
+Configuration Configuration::withSaveGamePath(const std::string& path) const
+{
+	auto moved = *this;
+	moved.SaveGamePath = path;
+	return moved;
+}
+
+Configuration Configuration::withPhaseWindow(const std::string& from, const std::string& theStopAfter) const
+{
+	auto windowed = *this;
+	windowed.profileFrom = from;
+	windowed.stopAfter = theStopAfter;
+	return windowed;
+}
@@ -3,6 +3,7 @@
 #include "ConverterVersion.h"
 #include "ModLoader/ModLoader.h"
 #include "Parser.h"
+#include <cstdint>
 
 class Configuration: commonItems::parser
 {
@@ -10,6 +11,8 @@ class Configuration: commonItems::parser
 	Configuration() = default;
 	explicit Configuration(const commonItems::ConverterVersion& converterVersion);
 	explicit Configuration(std::istream& theStream);
+	// A batch job's settings, verified against the installs like configuration.txt's.
+	Configuration(const commonItems::ConverterVersion& converterVersion, std::istream& theStream);
 
 	enum class STARTDATE
 	{
@@ -72,6 +75,87 @@ class Configuration: commonItems::parser
 		HISTORIC = 1,
 		DYNAMIC = 2
 	};
+	enum class SNAPSHOT
+	{
+		ENABLED = 1,
+		DISABLED = 2,
+		CAMPAIGN = 3 // also start a later save of the same campaign from the last one's snapshot, parsing only what changed
+	};
+	enum class ARCHIVE
+	{
+		FOLDER = 1,
+		ZIP = 2
+	};
+	enum class INCREMENTAL
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class STAGING
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class VALIDATION
+	{
+		OFF = 1,		 // skip the passes that only report
+		SUMMARY = 2, // run them as cheap counts, with one line apiece
+		FULL = 3		 // and name every offender
+	};
+	enum class OUTPUT_SINK
+	{
+		DISK = 1,
+		COUNT = 2, // write nothing, only count the generated files and their bytes
+		HASH = 3	  // also digest them
+	};
+	enum class TIMINGS
+	{
+		LOG = 1,
+		JSON = 2
+	};
+	enum class HARDWARE_COUNTERS
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class MEMORY_CENSUS
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class CONTENTION
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class TRACE
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class LOOKUP_TRACE
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class REUSE_WORLD
+	{
+		DISABLED = 1,
+		ENABLED = 2
+	};
+	enum class CHECKPOINT
+	{
+		DISABLED = 1,
+		ENABLED = 2, // write the CK2 world out once it's built
+		RESUME = 3	 // and start from it when there is one, going straight on to the EU4 side
+	};
+	enum class CHARACTER_DECODING
+	{
+		AUTO = 1,
+		LAZY = 2,
+		EAGER = 3,
+		SPILLED = 4
+	};
 
 	[[nodiscard]] const auto& getSaveGamePath() const { return SaveGamePath; }
 	[[nodiscard]] const auto& getCK2Path() const { return CK2Path; }
@@ -90,10 +174,42 @@ class Configuration: commonItems::parser
 	[[nodiscard]] const auto& getMods() const { return mods; }
 	[[nodiscard]] const auto& getSplitVassals() const { return splitVassals; }
 	[[nodiscard]] const auto& getStartDateOption() const { return startDate; }
+	[[nodiscard]] const auto& getSnapshot() const { return snapshot; }
+	[[nodiscard]] const auto& getArchive() const { return archive; }
+	[[nodiscard]] const auto& getIncremental() const { return incremental; }
+	[[nodiscard]] const auto& getStaging() const { return staging; }
+	[[nodiscard]] const auto& getOutputSink() const { return outputSink; }
+	[[nodiscard]] const auto& getValidation() const { return validation; }
+	[[nodiscard]] const auto& getTimings() const { return timings; }
+	[[nodiscard]] const auto& getHardwareCounters() const { return hardwareCounters; }
+	[[nodiscard]] const auto& getMemoryCensus() const { return memoryCensus; }
+	[[nodiscard]] const auto& getContention() const { return contention; }
+	[[nodiscard]] const auto& getTrace() const { return trace; }
+	[[nodiscard]] const auto& getLookupTrace() const { return lookupTrace; }
+	[[nodiscard]] const auto& getThreads() const { return threads; }
+	[[nodiscard]] const auto& getCacheLimitMB() const { return cacheLimitMB; }
+	[[nodiscard]] const auto& getRemoteCache() const { return remoteCache; }
+	[[nodiscard]] const auto& getRemoteCacheKey() const { return remoteCacheKey; }
+	[[nodiscard]] const auto& getCharacterDecoding() const { return characterDecoding; }
+	[[nodiscard]] const auto& getReuseWorld() const { return reuseWorld; }
+	[[nodiscard]] const auto& getCheckpoint() const { return checkpoint; }
+	[[nodiscard]] const auto& getTaskOrderSeed() const { return taskOrderSeed; }
+	[[nodiscard]] const auto& getProfileFrom() const { return profileFrom; }
+	[[nodiscard]] const auto& getStopAfter() const { return stopAfter; }
+
+	// The same settings writing under another output name, for assembling a mod beside the one it replaces.
+	[[nodiscard]] Configuration withOutputName(const std::string& name) const;
+	// The same settings with what was left on auto filled in for a particular save (see CK2::tuneForSave).
+	[[nodiscard]] Configuration withTuning(std::size_t theThreads, CHARACTER_DECODING theCharacterDecoding) const;
+	// The same settings reading another save, for preparing the saves of a watched folder (see SaveFolder).
+	[[nodiscard]] Configuration withSaveGamePath(const std::string& path) const;
+	// The same settings profiling only a window of phases (see CK2::PhaseTimings::window), for --stop-after.
+	[[nodiscard]] Configuration withPhaseWindow(const std::string& from, const std::string& theStopAfter) const;
 
   private:
 	void registerKeys();
 	void setOutputName();
+	void verifyInstalls(const commonItems::ConverterVersion& converterVersion) const;
 	void verifyCK2Path() const;
 	void verifyEU4Path() const;
 	void verifyCK2Version(const commonItems::ConverterVersion& converterVersion) const;
@@ -104,6 +220,10 @@ class Configuration: commonItems::parser
 	std::string CK2DocsPath;
 	std::string EU4Path;
 	std::string outputName;
+	std::string remoteCache; // http:// URL of the farm's shared cache, empty for none
+	std::string remoteCacheKey; // signs and checks its entries, the same on every machine of the farm
+	std::string profileFrom; // time and trace phases only from this one on, empty for all
+	std::string stopAfter;	 // stop once this phase is done, writing no mod; empty to convert through
 
 	STARTDATE startDate = STARTDATE::EU;
 	I_AM_HRE iAmHre = I_AM_HRE::HRE;
@@ -116,6 +236,24 @@ class Configuration: commonItems::parser
 	DEVELOPMENT development = DEVELOPMENT::IMPORT;
 	DEJURE dejure = DEJURE::ENABLED;
 	SPLITVASSALS splitVassals = SPLITVASSALS::YES;
+	SNAPSHOT snapshot = SNAPSHOT::ENABLED;				 // reuse the parsed save on reruns
+	ARCHIVE archive = ARCHIVE::FOLDER;					 // ship the mod as a loose folder or as one zip
+	INCREMENTAL incremental = INCREMENTAL::DISABLED; // keep unchanged output files looking untouched between runs
+	STAGING staging = STAGING::DISABLED;				 // assemble the mod aside and swap it in once complete
+	OUTPUT_SINK outputSink = OUTPUT_SINK::DISK;		 // write the mod, or only count (and hash) it for benchmarks
+	VALIDATION validation = VALIDATION::SUMMARY;		 // how much the diagnostic passes check and report
+	TIMINGS timings = TIMINGS::LOG;						 // phase timings in the log only, or also in timings.json
+	HARDWARE_COUNTERS hardwareCounters = HARDWARE_COUNTERS::DISABLED; // CPU event counters per phase, Linux only
+	MEMORY_CENSUS memoryCensus = MEMORY_CENSUS::DISABLED;				 // memory by entity type at the end of the major phases
+	CONTENTION contention = CONTENTION::DISABLED;						 // lock waits and parallel efficiency per phase
+	TRACE trace = TRACE::DISABLED;						 // write the conversion timeline to trace.json
+	LOOKUP_TRACE lookupTrace = LOOKUP_TRACE::DISABLED; // record every mapper lookup to lookups.bin
+	REUSE_WORLD reuseWorld = REUSE_WORLD::DISABLED;	 // batches and servers convert an identical CK2 world only once, in-process
+	CHECKPOINT checkpoint = CHECKPOINT::DISABLED;		 // reruns changing only the EU4 side skip the CK2 phases
+	std::size_t threads = 0;									 // 0 to size it to the save, up to one per core
+	std::size_t cacheLimitMB = 0;								 // how large snapshots/ may grow before old entries go, 0 for no limit
+	CHARACTER_DECODING characterDecoding = CHARACTER_DECODING::AUTO; // character details up front, on first use, or on first use from a temp file
+	std::uint32_t taskOrderSeed = 0;							 // nonzero runs parallel steps one at a time, in a seeded random order
 
 	Mods mods;
 };
@@ -0,0 +1,52 @@
+#include "JobFolder.h"
+#include <filesystem>
+#include <fstream>
+
+JobFolder::JobFolder(std::string theFolder): folder(std::move(theFolder))
+{
+	std::filesystem::create_directories(std::filesystem::u8path(folder + "/done"));
+	std::filesystem::create_directories(std::filesystem::u8path(folder + "/failed"));
+}
+
+std::optional<std::string> JobFolder::nextJobs() const
+{
+	const auto pending = pendingJobs();
+	if (pending.empty())
+		return std::nullopt;
+	return folder + "/" + *pending.begin();
+}
+
+std::size_t JobFolder::countJobs() const
+{
+	return pendingJobs().size();
+}
+
+std::set<std::string> JobFolder::pendingJobs() const
+{
+	std::set<std::string> pending;
+	for (const auto& entry: std::filesystem::directory_iterator(std::filesystem::u8path(folder)))
+		if (entry.is_regular_file() && entry.path().extension() == ".txt")
+			pending.insert(entry.path().filename().string());
+	return pending;
+}
+
+bool JobFolder::takeStopRequest() const
+{
+	std::error_code error;
+	return std::filesystem::remove(std::filesystem::u8path(folder + "/stop"), error);
+}
+
+bool JobFolder::takeCancelRequest(const std::string& jobsPath) const
+{
+	std::error_code error;
+	return std::filesystem::remove(std::filesystem::u8path(jobsPath).replace_extension(".cancel"), error);
+}
+
+void JobFolder::finish(const std::string& jobsPath, const std::string& error) const
+{
+	const auto path = std::filesystem::u8path(jobsPath);
+	const auto destination = std::filesystem::u8path(folder) / (error.empty() ? "done" : "failed") / path.filename();
+	std::filesystem::rename(path, destination);
+	if (!error.empty())
+		std::ofstream(std::filesystem::path(destination).replace_extension(".error")) << error << "\n";
+}
@@ -0,0 +1,34 @@
+#ifndef JOB_FOLDER_H
+#define JOB_FOLDER_H
+#include <optional>
+#include <set>
+#include <string>
+
+// The folder a conversion server watches, CK2ToEU4Converter --watch <folder>. Each <name>.txt dropped into it is a
+// jobs file (see BatchJobs); write it elsewhere and move it in whole. Once converted it goes to done/, or to failed/
+// next to a <name>.error with the reason. An empty file named stop shuts the server down between jobs files, and an
+// empty <name>.cancel cancels that jobs file: its jobs that haven't started never do, and the running ones stop at their
+// next phase.
+class JobFolder
+{
+  public:
+	explicit JobFolder(std::string folder);
+
+	// The pending jobs file first by name, if any.
+	[[nodiscard]] std::optional<std::string> nextJobs() const;
+	// How many jobs files are waiting, the next one included.
+	[[nodiscard]] std::size_t countJobs() const;
+	// Removes the stop file, so the next server started on the folder doesn't stop straight away.
+	[[nodiscard]] bool takeStopRequest() const;
+	// Likewise for the jobs file's cancel file.
+	[[nodiscard]] bool takeCancelRequest(const std::string& jobsPath) const;
+	// An empty error is a success.
+	void finish(const std::string& jobsPath, const std::string& error) const;
+
+  private:
+	[[nodiscard]] std::set<std::string> pendingJobs() const;
+
+	std::string folder;
+};
+
+#endif // JOB_FOLDER_H
@@ -0,0 +1,49 @@
+#include "JobScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+JobScheduler::JobScheduler(const std::vector<Request>& theRequests, const std::size_t theBudgetBytes, const std::atomic<bool>& theCancelled):
+	 requests(theRequests), queue(theRequests.size()), budgetBytes(theBudgetBytes), cancelled(theCancelled)
+{
+	std::iota(queue.begin(), queue.end(), 0);
+	std::ranges::stable_sort(queue, [this](const std::size_t one, const std::size_t other) {
+		return requests[one].priority < requests[other].priority;
+	});
+}
+
+std::optional<std::size_t> JobScheduler::admit()
+{
+	std::unique_lock lock(queueMutex);
+	while (true)
+	{
+		if (nextInQueue == queue.size() || cancelled.load(std::memory_order_relaxed))
+			return std::nullopt;
+		const auto next = queue[nextInQueue];
+		if (!budgetBytes || !running || runningBytes + requests[next].estimatedBytes <= budgetBytes)
+		{
+			++nextInQueue;
+			++running;
+			runningBytes += requests[next].estimatedBytes;
+			return next;
+		}
+		// Woken by a job finishing; the timeout only notices a cancellation.
+		released.wait_for(lock, std::chrono::milliseconds(250));
+	}
+}
+
+void JobScheduler::release(const std::size_t index)
+{
+	{
+		const std::lock_guard lock(queueMutex);
+		--running;
+		runningBytes -= requests[index].estimatedBytes;
+	}
+	released.notify_all();
+}
+
+std::size_t JobScheduler::countWaiting()
+{
+	const std::lock_guard lock(queueMutex);
+	return queue.size() - nextInQueue;
+}
@@ -0,0 +1,48 @@
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+#include "BatchJobs.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// Decides when each conversion of a batch may start. Interactive jobs go first, then bulk ones, each kind in the order
+// they were listed. A job starts once its estimated memory fits next to that of the jobs already running, or when none
+// are, so a job bigger than the whole budget still converts, alone. Smaller jobs behind it don't overtake a job that
+// doesn't fit yet; they would keep the big ones waiting for good.
+class JobScheduler
+{
+  public:
+	struct Request
+	{
+		BatchJobs::PRIORITY priority = BatchJobs::PRIORITY::BULK;
+		std::size_t estimatedBytes = 0;
+	};
+
+	// A zero budget starts every job as soon as a worker asks for one. Once cancelled, no more jobs start.
+	JobScheduler(const std::vector<Request>& requests, std::size_t budgetBytes, const std::atomic<bool>& cancelled);
+
+	// Blocks until the next job may start and returns its index among the requests, or nothing once all have started
+	// or the batch was cancelled.
+	[[nodiscard]] std::optional<std::size_t> admit();
+	// The job is done with its memory.
+	void release(std::size_t index);
+
+	// Jobs that haven't started.
+	[[nodiscard]] std::size_t countWaiting();
+
+  private:
+	std::vector<Request> requests;
+	std::vector<std::size_t> queue; // in the order they start
+	std::size_t nextInQueue = 0;
+	std::size_t budgetBytes = 0;
+	std::size_t runningBytes = 0;
+	std::size_t running = 0;
+	const std::atomic<bool>& cancelled;
+	std::mutex queueMutex;
+	std::condition_variable released;
+};
+
+#endif // JOB_SCHEDULER_H
@@ -0,0 +1,45 @@
+#include "SaveFolder.h"
+
+SaveFolder::SaveFolder(std::string theFolder): folder(std::move(theFolder))
+{
+	lastSeen = scan();
+	handedOut = lastSeen;
+}
+
+std::vector<std::string> SaveFolder::takeSettledSaves()
+{
+	auto seen = scan();
+	std::vector<std::string> settled;
+	for (const auto& [path, fingerprint]: seen)
+	{
+		const auto previous = lastSeen.find(path);
+		if (previous == lastSeen.end() || previous->second != fingerprint)
+			continue;
+		if (const auto taken = handedOut.find(path); taken != handedOut.end() && taken->second == fingerprint)
+			continue;
+		handedOut[path] = fingerprint;
+		settled.push_back(path);
+	}
+	lastSeen = std::move(seen);
+	return settled;
+}
+
+std::map<std::string, SaveFolder::Fingerprint> SaveFolder::scan() const
+{
+	// A save the game is halfway through writing, or deleting, just doesn't show this time.
+	std::map<std::string, Fingerprint> seen;
+	std::error_code error;
+	for (const auto& entry: std::filesystem::directory_iterator(std::filesystem::u8path(folder), error))
+	{
+		if (!entry.is_regular_file(error) || entry.path().extension() != ".ck2")
+			continue;
+		const auto size = entry.file_size(error);
+		if (error)
+			continue;
+		const auto written = entry.last_write_time(error);
+		if (error)
+			continue;
+		seen.emplace(folder + "/" + entry.path().filename().string(), Fingerprint{size, written});
+	}
+	return seen;
+}
@@ -0,0 +1,35 @@
+#ifndef SAVE_FOLDER_H
+#define SAVE_FOLDER_H
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+// The CK2 save folder as CK2ToEU4Converter --prepare <folder> watches it: the saves that turn up in it while it's
+// watched, new or overwritten, each handed out once it has stopped changing. The game writes a save over a few
+// seconds, so one is only taken after two polls in a row saw it the same size and age.
+class SaveFolder
+{
+  public:
+	// The saves already there when watching starts aren't handed out until they change.
+	explicit SaveFolder(std::string folder);
+
+	// The saves that settled since the last poll, by name.
+	[[nodiscard]] std::vector<std::string> takeSettledSaves();
+
+  private:
+	struct Fingerprint
+	{
+		std::uintmax_t size = 0;
+		std::filesystem::file_time_type written;
+		bool operator==(const Fingerprint&) const = default;
+	};
+	[[nodiscard]] std::map<std::string, Fingerprint> scan() const;
+
+	std::string folder;
+	std::map<std::string, Fingerprint> lastSeen;	// as of the last poll
+	std::map<std::string, Fingerprint> handedOut; // as each save was handed out
+};
+
+#endif // SAVE_FOLDER_H
@@ -0,0 +1,42 @@
+#include "CapitalTable.h"
+#include "../../CK2World/Characters/Character.h"
+#include "../../CK2World/Provinces/Province.h"
+#include "../../CK2World/Titles/Title.h"
+#include "../../CK2World/World.h"
+#include "../../Mappers/ProvinceMapper/ProvinceMapper.h"
+
+void EU4::CapitalTable::build(const CK2::World& sourceWorld, const mappers::ProvinceMapper& provinceMapper)
+{
+	capitals.clear();
+	const auto add = [this, &provinceMapper](const std::pair<int, std::shared_ptr<CK2::Character>>& holder) {
+		if (!holder.second || capitals.contains(holder.first))
+			return;
+		const auto ck2Province = holder.second->getCapitalProvince().first;
+		if (!ck2Province)
+			return;
+		capitals.emplace(holder.first, Capital{ck2Province, provinceMapper.getEU4ProvinceNumbers(ck2Province)});
+	};
+	for (const auto& title: sourceWorld.getIndepTitles())
+		add(title.second->getHolder());
+	for (const auto& province: sourceWorld.getProvinces())
+		if (province.second->getTitle().second)
+			add(province.second->getTitle().second->getHolder());
+}
+
+const EU4::CapitalTable::Capital* EU4::CapitalTable::of(const int holderID) const
+{
+	const auto capital = capitals.find(holderID);
+	return capital != capitals.end() ? &capital->second : nullptr;
+}
+
+int EU4::CapitalTable::firstEU4Province(const int holderID) const
+{
+	const auto* capital = of(holderID);
+	return capital && !capital->eu4Provinces.empty() ? capital->eu4Provinces.front() : 0;
+}
+
+bool EU4::CapitalTable::isCapital(const int holderID, const int ck2ProvinceID) const
+{
+	const auto* capital = of(holderID);
+	return capital && capital->ck2Province == ck2ProvinceID;
+}
@@ -0,0 +1,42 @@
+#ifndef EU4_CAPITAL_TABLE_H
+#define EU4_CAPITAL_TABLE_H
+#include <span>
+#include <unordered_map>
+
+namespace CK2
+{
+class World;
+}
+namespace mappers
+{
+class ProvinceMapper;
+}
+
+namespace EU4
+{
+// Where each CK2 holder's capital lands in EU4, resolved once before countries are imported. Tag assignment and
+// country setup take the first EU4 province, capital verification walks the rest in order, and province import asks
+// whether a CK2 province is its own holder's capital. Covers the holders of independent titles and of counties.
+class CapitalTable
+{
+  public:
+	struct Capital
+	{
+		int ck2Province = 0;
+		std::span<const int> eu4Provinces; // in the province mapper's order, the first being the one to pick
+	};
+
+	// The spans point into provinceMapper, which has to outlive the table.
+	void build(const CK2::World& sourceWorld, const mappers::ProvinceMapper& provinceMapper);
+
+	// Nullptr for holders without a capital.
+	[[nodiscard]] const Capital* of(int holderID) const;
+	[[nodiscard]] int firstEU4Province(int holderID) const; // 0 if there's none
+	[[nodiscard]] bool isCapital(int holderID, int ck2ProvinceID) const;
+
+  private:
+	std::unordered_map<int, Capital> capitals; // by CK2 holder
+};
+} // namespace EU4
+
+#endif // EU4_CAPITAL_TABLE_H
@@ -1,26 +1,151 @@
 #include "Country.h"
 #include "../../CK2World/Characters/Character.h"
 #include "../../CK2World/Dynasties/Dynasty.h"
+#include "../../CK2World/MemoryCensus.h"
 #include "../../CK2World/Provinces/Province.h"
 #include "../../CK2World/Titles/Title.h"
 #include "../../Mappers/ColorScraper/ColorScraper.h"
 #include "../../Mappers/CultureMapper/CultureMapper.h"
 #include "../../Mappers/GovernmentsMapper/GovernmentsMapper.h"
-#include "../../Mappers/ProvinceMapper/ProvinceMapper.h"
 #include "../../Mappers/RegionMapper/RegionMapper.h"
 #include "../../Mappers/ReligionMapper/ReligionMapper.h"
 #include "../../Mappers/RulerPersonalitiesMapper/RulerPersonalitiesMapper.h"
 #include "../Province/EU4Province.h"
+#include "CapitalTable.h"
 #include "CommonFunctions.h"
 #include "Log.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <unordered_map>
 
-EU4::Country::Country(std::string theTag, const std::string& filePath): tag(std::move(theTag))
+namespace
+{
+// Religion and culture groups assignReforms asks about, as bits. Built the first time anyone asks.
+enum REFORM_GROUP : std::uint32_t
+{
+	MUSLIM = 1u << 0,
+	MAZDAN = 1u << 1,
+	BUDDHIST = 1u << 2,
+	EASTERN = 1u << 3,
+	INDIAN = 1u << 4, // Dharmic + Buddhists
+	PROTESTANT = 1u << 5,
+	ORTHODOX = 1u << 6,
+	PAGAN = 1u << 7,
+	CHINESE = 1u << 8,
+	RUSSIAN = 1u << 9, // Not all East Slavic
+	DRAVIDIAN = 1u << 10,
+	WEST_ARYAN = 1u << 11,
+	BALTIC = 1u << 12,
+	LATIN = 1u << 13
+};
+
+std::unordered_map<std::string, std::uint32_t> buildReformGroups(const std::vector<std::pair<REFORM_GROUP, std::vector<std::string>>>& groups)
+{
+	std::unordered_map<std::string, std::uint32_t> members;
+	for (const auto& [group, names]: groups)
+		for (const auto& name: names)
+			members[name] |= group;
+	return members;
+}
+
+const std::unordered_map<std::string, std::uint32_t>& religionReformGroups()
+{
+	static const auto groups = buildReformGroups({
+		 {MUSLIM, {"sunni", "zikri", "yazidi", "ibadi", "kharijite", "shiite", "druze", "hurufi", "qarmatian"}},
+		 {MAZDAN, {"zoroastrian", "mazdaki", "manichean", "khurmazta"}},
+		 {BUDDHIST, {"buddhism", "vajrayana", "mahayana"}},
+		 {EASTERN, {"confucianism", "shinto", "buddhism", "vajrayana", "mahayana"}},
+		 {INDIAN, {"buddhism", "vajrayana", "mahayana", "hinduism", "jain"}},
+		 {PROTESTANT, {"protestant", "reformed", "hussite", "cathar", "waldensian", "lollard"}},
+		 {ORTHODOX, {"orthodox", "monothelite", "iconoclast", "paulician", "bogomilist"}},
+		 {PAGAN,
+			  {"pagan_religion",
+					"norse_pagan",
+					"norse_pagan_reformed",
+					"tengri_pagan",
+					"tengri_pagan_reformed",
+					"baltic_pagan",
+					"baltic_pagan_reformed",
+					"finnish_pagan",
+					"finnish_pagan_reformed",
+					"slavic_pagan",
+					"slavic_pagan_reformed",
+					"shamanism",
+					"west_african_pagan",
+					"west_african_pagan_reformed",
+					"hellenic_pagan",
+					"hellenic_pagan_reformed",
+					"zun_pagan",
+					"zun_pagan_reformed",
+					"bon",
+					"bon_reformed",
+					"animism",
+					"totemism",
+					"inti",
+					"nahuatl",
+					"mesoamerican_religion"}},
+	});
+	return groups;
+}
+
+const std::unordered_map<std::string, std::uint32_t>& cultureReformGroups()
+{
+	static const auto groups = buildReformGroups({
+		 {CHINESE,
+			  {"vietnamese_new",
+					"korean_new",
+					"tibetan_new",
+					"altaic_new",
+					"manchu_new",
+					"chihan",
+					"cantonese",
+					"jin",
+					"wu",
+					"chimin",
+					"hakka",
+					"gan",
+					"xiang",
+					"sichuanese",
+					"jianghuai",
+					"xibei",
+					"hubei",
+					"zhongyuan",
+					"shandong_culture"}},
+		 {RUSSIAN, {"ilmenian", "volhynian", "severian", "russian", "russian_culture", "novgorodian", "ryazanian"}},
+		 {DRAVIDIAN, {"kannada", "malayalam", "tamil", "telegu"}},
+		 {WEST_ARYAN, {"gujarati", "saurashtri", "marathi", "sindhi", "rajput", "malvi"}},
+		 {BALTIC, {"estonian", "lithuanian", "latvian", "old_prussian"}},
+		 {LATIN,
+			  {"lombard",
+					"tuscan",
+					"sardinian",
+					"romagnan",
+					"ligurian",
+					"venetian",
+					"dalmatian ",
+					"neapolitan",
+					"piedmontese",
+					"umbrian",
+					"sicilian",
+					"maltese",
+					"italian"}},
+	});
+	return groups;
+}
+
+std::uint32_t reformGroupsOf(const std::unordered_map<std::string, std::uint32_t>& groups, const std::string& name)
+{
+	const auto& groupsItr = groups.find(name);
+	return groupsItr != groups.end() ? groupsItr->second : 0;
+}
+} // namespace
+
+EU4::Country::Country(std::string theTag, const std::string& filePath): tag(std::move(theTag)), details(CountryDetails(filePath))
 {
 	// Load from a country file, if one exists. Otherwise rely on defaults.
 	const auto startPos = filePath.find("/countries");
 	commonCountryFile = filePath.substr(startPos + 1, filePath.length() - startPos);
-	details = CountryDetails(filePath);
 
 	// We also must set a dummy history filepath for those countries that don't actually have a history file.
 	const auto lastslash = filePath.find_last_of('/');
@@ -33,7 +158,7 @@ void EU4::Country::loadHistory(const std::string& filePath)
 {
 	const auto startPos = filePath.find("/history");
 	historyCountryFile = filePath.substr(startPos + 1, filePath.length() - startPos);
-	details.parseHistory(filePath);
+	details.edit().parseHistory(filePath);
 }
 
 void EU4::Country::initializeFromTitle(std::string theTag,
@@ -41,13 +166,14 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 	 const mappers::GovernmentsMapper& governmentsMapper,
 	 const mappers::ReligionMapper& religionMapper,
 	 const mappers::CultureMapper& cultureMapper,
-	 const mappers::ProvinceMapper& provinceMapper,
+	 const CapitalTable& capitals,
 	 const mappers::ColorScraper& colorScraper,
 	 const mappers::LocalizationMapper& localizationMapper,
 	 const mappers::RulerPersonalitiesMapper& rulerPersonalitiesMapper,
 	 Configuration::STARTDATE startDateOption,
 	 date theConversionDate)
 {
+	auto& details = this->details.edit(); // a country a title takes over is rewritten throughout
 	tag = std::move(theTag);
 	if (startDateOption == Configuration::STARTDATE::CK)
 		conversionDate = theConversionDate;
@@ -55,6 +181,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		conversionDate = date(1444, 11, 11);
 	title.first = theTitle->getName();
 	title.second = std::move(theTitle);
+	details.loadNames(); // monarch names are rebuilt from the title's holders below
 	if (commonCountryFile.empty())
 		commonCountryFile = "countries/" + title.first + ".txt";
 	if (historyCountryFile.empty())
@@ -79,15 +206,15 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		Log(LogLevel::Warning) << "No government match for " << actualHolder->getGovernment() << " for title: " << title.first << ", defaulting to monarchy.";
 		details.government = "monarchy";
 	}
-	if (title.first.find("e_") == 0)
+	if (title.second->getRank() == CK2::Title::RANK::EMPIRE)
 		details.governmentRank = 3;
-	else if (title.first.find("k_") == 0)
+	else if (title.second->getRank() == CK2::Title::RANK::KINGDOM)
 		details.governmentRank = 2;
 	else
 		details.governmentRank = 1;
 	// Reforms will be set later to ensure that all other aspects of a country have been correctly set first
 	// do we have a religion?
-	std::string baseReligion;
+	parsing::Symbol baseReligion;
 	if (!actualHolder->getReligion().empty())
 		baseReligion = actualHolder->getReligion();
 	else
@@ -102,15 +229,9 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 	}
 	// Change capitals for anyone not aztec.
 	if (tag != "AZT")
-	{
-		const auto& capitalMatch = provinceMapper.getEU4ProvinceNumbers(actualHolder->getCapitalProvince().first);
-		if (!capitalMatch.empty())
-			details.capital = *capitalMatch.begin();
-		else
-			details.capital = 0; // We will see warning about this earlier, no need for more spam.
-	}
+		details.capital = capitals.firstEU4Province(title.second->getHolder().first); // 0 warned about earlier, no need for more spam.
 	// do we have a culture? Pope is special as always.
-	std::string baseCulture;
+	parsing::Symbol baseCulture;
 	if (title.second->isThePope() || title.second->isTheFraticelliPope())
 		baseCulture = actualHolder->getCapitalProvince().second->getCulture();
 	else if (!actualHolder->getCulture().empty())
@@ -131,7 +252,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		if (techMatch)
 			details.technologyGroup = *techMatch;
 	} // We will set it later if primaryCulture is unavailable at this stage.
-	if (title.first.find("c_") == 0)
+	if (title.second->getRank() == CK2::Title::RANK::COUNTY)
 		details.fixedCapital = true;
 	else
 		details.fixedCapital = false;
@@ -223,7 +344,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 	{
 		for (const auto& courtier: title.second->getHolder().second->getCourtierNames())
 		{
-			const auto& blockItr = details.monarchNames.find(courtier.first);
+			const auto& blockItr = details.monarchNames.find(courtier.first.str());
 			if (blockItr == details.monarchNames.end())
 			{
 				auto female = !courtier.second;
@@ -231,7 +352,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 				if (female)
 					chance = -1;
 				std::pair<int, int> newBlock = std::pair(0, chance);
-				details.monarchNames.insert(std::pair(courtier.first, newBlock));
+				details.monarchNames.insert(std::pair(courtier.first.str(), newBlock));
 			}
 		}
 	}
@@ -269,7 +390,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto nameLocalizationMatch = localizationMapper.getLocBlockForKey("d_fraticelli");
 		if (nameLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag, *nameLocalizationMatch));
+			localizations.try_emplace(tag, nameLocalizationMatch->toBlock());
 			nameSet = true;
 		}
 	}
@@ -281,7 +402,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		newblock.spanish = title.second->getDisplayName();
 		newblock.french = title.second->getDisplayName();
 		newblock.german = title.second->getDisplayName();
-		localizations.insert(std::pair(tag, newblock));
+		localizations.try_emplace(tag, std::move(newblock));
 		nameSet = true;
 	}
 	if (!nameSet)
@@ -289,7 +410,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto nameLocalizationMatch = localizationMapper.getLocBlockForKey(title.first);
 		if (nameLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag, *nameLocalizationMatch));
+			localizations.try_emplace(tag, nameLocalizationMatch->toBlock());
 			nameSet = true;
 		}
 	}
@@ -299,7 +420,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto nameLocalizationMatch = localizationMapper.getLocBlockForKey(baseTitleName);
 		if (nameLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag, *nameLocalizationMatch));
+			localizations.try_emplace(tag, nameLocalizationMatch->toBlock());
 			nameSet = true;
 		}
 	}
@@ -311,7 +432,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto nameLocalizationMatch = localizationMapper.getLocBlockForKey(alternateName);
 		if (nameLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag, *nameLocalizationMatch));
+			localizations.try_emplace(tag, nameLocalizationMatch->toBlock());
 			nameSet = true;
 		}
 	}
@@ -326,7 +447,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 			newblock.spanish = capitalName;
 			newblock.french = capitalName;
 			newblock.german = capitalName;
-			localizations.insert(std::pair(tag, newblock));
+			localizations.try_emplace(tag, std::move(newblock));
 			nameSet = true;
 		}
 	}
@@ -400,7 +521,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 
 	if (details.government == "monarchy" && dynastyTitleNames.count(details.primaryCulture) && actualHolder->getDynasty().first &&
 		 !actualHolder->getDynasty().second->getName().empty() && !hardcodedExclusions.count(title.first) &&
-		 (title.first.find("e_") == 0 || title.first.find("k_") == 0))
+		 (title.second->getRank() == CK2::Title::RANK::EMPIRE || title.second->getRank() == CK2::Title::RANK::KINGDOM))
 	{
 		const auto& dynastyName = actualHolder->getDynasty().second->getName();
 		mappers::LocBlock newblock;
@@ -439,14 +560,14 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto adjLocalizationMatch = localizationMapper.getLocBlockForKey("d_fraticelli_adj");
 		if (adjLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag + "_ADJ", *adjLocalizationMatch));
+			localizations.try_emplace(tag + "_ADJ", adjLocalizationMatch->toBlock());
 			adjSet = true;
 		}
 	}
 
 	if (!adjSet && dynastyTitleNames.count(details.primaryCulture) && actualHolder->getDynasty().first &&
 		 !actualHolder->getDynasty().second->getName().empty() && title.first != "k_rum" && title.first != "k_israel" && title.first != "e_india" &&
-		 (title.first.find("e_") == 0 || title.first.find("k_") == 0))
+		 (title.second->getRank() == CK2::Title::RANK::EMPIRE || title.second->getRank() == CK2::Title::RANK::KINGDOM))
 	{
 		const auto& dynastyName = actualHolder->getDynasty().second->getName();
 		mappers::LocBlock newblock;
@@ -454,7 +575,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		newblock.spanish = "de los " + dynastyName;
 		newblock.french = "des " + dynastyName;
 		newblock.german = dynastyName + "-";
-		localizations.insert(std::pair(tag + "_ADJ", newblock));
+		localizations.try_emplace(tag + "_ADJ", std::move(newblock));
 		adjSet = true;
 	}
 	if (!adjSet && !title.second->getDisplayName().empty())
@@ -464,7 +585,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		newblock.spanish = "de " + title.second->getDisplayName();
 		newblock.french = "de " + title.second->getDisplayName();
 		newblock.german = title.second->getDisplayName() + "s";
-		localizations.insert(std::pair(tag + "_ADJ", newblock));
+		localizations.try_emplace(tag + "_ADJ", std::move(newblock));
 		adjSet = true;
 	}
 	if (!adjSet)
@@ -472,7 +593,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto adjLocalizationMatch = localizationMapper.getLocBlockForKey(title.first + "_adj");
 		if (adjLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag + "_ADJ", *adjLocalizationMatch));
+			localizations.try_emplace(tag + "_ADJ", adjLocalizationMatch->toBlock());
 			adjSet = true;
 		}
 	}
@@ -483,17 +604,17 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto adjLocalizationMatch = localizationMapper.getLocBlockForKey(baseTitleAdj);
 		if (adjLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag + "_ADJ", *adjLocalizationMatch));
+			localizations.try_emplace(tag + "_ADJ", adjLocalizationMatch->toBlock());
 			adjSet = true;
 		}
-		if (!adjSet && !title.second->getBaseTitle().second->getBaseTitle().first.empty())
+		if (!adjSet && !title.second->getBaseTitleBase().empty())
 		{
 			// maybe basetitlebasetitle?
-			baseTitleAdj = title.second->getBaseTitle().second->getBaseTitle().first + "_adj";
+			baseTitleAdj = title.second->getBaseTitleBase() + "_adj";
 			adjLocalizationMatch = localizationMapper.getLocBlockForKey(baseTitleAdj);
 			if (adjLocalizationMatch)
 			{
-				localizations.insert(std::pair(tag + "_ADJ", *adjLocalizationMatch));
+				localizations.try_emplace(tag + "_ADJ", adjLocalizationMatch->toBlock());
 				adjSet = true;
 			}
 		}
@@ -506,7 +627,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto adjLocalizationMatch = localizationMapper.getLocBlockForKey(alternateAdj);
 		if (adjLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag + "_ADJ", *adjLocalizationMatch));
+			localizations.try_emplace(tag + "_ADJ", adjLocalizationMatch->toBlock());
 			adjSet = true;
 		}
 	}
@@ -518,7 +639,7 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		auto adjLocalizationMatch = localizationMapper.getLocBlockForKey(alternateAdj);
 		if (adjLocalizationMatch)
 		{
-			localizations.insert(std::pair(tag + "_ADJ", *adjLocalizationMatch));
+			localizations.try_emplace(tag + "_ADJ", adjLocalizationMatch->toBlock());
 			adjSet = true;
 		}
 	}
@@ -533,56 +654,54 @@ void EU4::Country::initializeFromTitle(std::string theTag,
 		newblock.spanish = "Ideas de " + localizations.find(tag + "_ADJ")->second.spanish;
 		newblock.french = "Doctrines " + localizations.find(tag + "_ADJ")->second.french;
 		newblock.german = localizations.find(tag + "_ADJ")->second.german + " Ideen";
-		localizations.insert(std::pair(tag + "_ideas", newblock));
+		localizations.try_emplace(tag + "_ideas", std::move(newblock));
 
 		newblock.english = localizations.find(tag + "_ADJ")->second.english + " Traditions"; // Roman Traditions
 		newblock.spanish = "Tradiciones de " + localizations.find(tag + "_ADJ")->second.spanish;
 		newblock.french = "traditions " + localizations.find(tag + "_ADJ")->second.french;
 		newblock.german = localizations.find(tag + "_ADJ")->second.german + " Traditionen";
-		localizations.insert(std::pair(tag + "_ideas_start", newblock));
+		localizations.try_emplace(tag + "_ideas_start", std::move(newblock));
 
 		newblock.english = localizations.find(tag + "_ADJ")->second.english + " Ambition"; // Roman Ambition
 		newblock.spanish = "Ambición de " + localizations.find(tag + "_ADJ")->second.spanish;
 		newblock.french = "ambitions " + localizations.find(tag + "_ADJ")->second.french;
 		newblock.german = localizations.find(tag + "_ADJ")->second.german + " Ambitionen";
-		localizations.insert(std::pair(tag + "_ideas_bonus", newblock));
+		localizations.try_emplace(tag + "_ideas_bonus", std::move(newblock));
 	}
 
 	// Rulers
 	initializeRulers(religionMapper, cultureMapper, rulerPersonalitiesMapper, startDateOption, theConversionDate);
 }
 
-void EU4::Country::setLocalizations(const mappers::LocBlock& newBlock)
+void EU4::Country::setLocalizations(mappers::LocBlock newBlock)
 {
 	// Setting the name
-	localizations[tag] = newBlock;
+	localizations[tag] = std::move(newBlock);
 }
 
-bool EU4::Country::verifyCapital(const mappers::ProvinceMapper& provinceMapper)
+bool EU4::Country::verifyCapital(const CapitalTable& capitals)
 {
 	// We have set a provisionary capital earlier, but now we can check if it's valid.
 	if (title.first.empty())
 		return false;
 	if (provinces.empty())
 		return false;
-	if (details.capital && provinces.count(details.capital))
+	if (details->capital && provinces.count(details->capital))
 		return false;
 
-	const auto& actualHolder = title.second->getHolder().second;
-	const auto& capitalMatch = provinceMapper.getEU4ProvinceNumbers(actualHolder->getCapitalProvince().first);
-	if (!capitalMatch.empty())
+	if (const auto* capital = capitals.of(title.second->getHolder().first))
 	{
-		for (const auto& provinceID: capitalMatch)
+		for (const auto& provinceID: capital->eu4Provinces)
 		{
 			if (provinces.count(provinceID))
 			{
-				details.capital = provinceID;
+				details.edit().capital = provinceID;
 				return true;
 			}
 		}
 	}
 	// Use any other province.
-	details.capital = provinces.begin()->second->getProvinceID();
+	details.edit().capital = provinces.begin()->second->getProvinceID();
 	return true;
 }
 
@@ -593,7 +712,7 @@ void EU4::Country::initializeAdvisers(const mappers::ReligionMapper& religionMap
 	 const date& theConversionDate)
 {
 	// We're doing this one separate from initial country generation so that country's primary culture and religion may have had time to get
-	// initialized.
+	// initialized. Details are read through -> and only edited for an adviser we add, so countries without any keep sharing theirs.
 	if (title.first.empty() || !title.second->getHolder().first)
 		return; // Vanilla and the dead do not get these.
 	const auto& holder = title.second->getHolder().second;
@@ -608,8 +727,8 @@ void EU4::Country::initializeAdvisers(const mappers::ReligionMapper& religionMap
 		newAdviser.name = adviser.second->getName();
 		if (adviser.second->getDynasty().first)
 			newAdviser.name += " " + adviser.second->getDynasty().second->getName();
-		if (details.capital)
-			newAdviser.location = details.capital;
+		if (details->capital)
+			newAdviser.location = details->capital;
 		if (adviser.second->getJob() == "job_spiritual")
 		{
 			newAdviser.type = "theologian";
@@ -647,7 +766,7 @@ void EU4::Country::initializeAdvisers(const mappers::ReligionMapper& religionMap
 		newAdviser.deathDate.subtractYears(-30); // And they retire at 60, more or less.
 		newAdviser.female = adviser.second->isFemale();
 		if (adviser.second->getReligion().empty())
-			newAdviser.religion = details.monarch.religion; // taking a shortcut.
+			newAdviser.religion = details->monarch.religion; // taking a shortcut.
 		else
 		{
 			const auto& religionMatch = religionMapper.getEu4ReligionForCk2Religion(adviser.second->getReligion());
@@ -657,7 +776,7 @@ void EU4::Country::initializeAdvisers(const mappers::ReligionMapper& religionMap
 		if (newAdviser.religion.empty())
 			continue;
 		if (adviser.second->getCulture().empty())
-			newAdviser.culture = details.monarch.culture; // taking a shortcut.
+			newAdviser.culture = details->monarch.culture; // taking a shortcut.
 		else
 		{
 			const auto& cultureMatch = cultureMapper.cultureMatch(adviser.second->getCulture(), newAdviser.religion, 0, tag);
@@ -668,7 +787,7 @@ void EU4::Country::initializeAdvisers(const mappers::ReligionMapper& religionMap
 			continue;
 		if (newAdviser.religion == "jewish")
 			newAdviser.discount = true; // Tradeoff for not being promotable.
-		details.advisers.emplace_back(newAdviser);
+		details.edit().advisers.emplace_back(newAdviser);
 		adviser.second->setSpent();
 	}
 }
@@ -683,8 +802,9 @@ void EU4::Country::initializeRulers(const mappers::ReligionMapper& religionMappe
 	// Are we the ruler's primary title? (if he has any)
 	// Potential PU's don't get monarchs. (and those apply for monarchies only)
 	if (!(holder->getChangedPrimaryTitle() && title.first == holder->getChangedPrimaryTitle()->first) && !holder->getPrimaryTitle().first.empty() &&
-		 title.first != holder->getPrimaryTitle().second->getTitle().first && details.government == "monarchy")
+		 title.first != holder->getPrimaryTitle().second->getTitle().first && this->details->government == "monarchy")
 		return;
+	auto& details = this->details.edit();
 
 	// Determine regnalness.
 	if (details.government != "republic" && !details.monarchNames.empty() && !holder->getName().empty())
@@ -726,7 +846,7 @@ void EU4::Country::initializeRulers(const mappers::ReligionMapper& religionMappe
 		// What's the first spouse that's still alive?
 		for (const auto& spouse: holder->getSpouses())
 		{
-			if (spouse.second->getDeathDate() != date("1.1.1"))
+			if (!spouse.second->isAlive())
 				continue; // She's dead.
 			details.queen.name = spouse.second->getName();
 			if (spouse.second->getDynasty().first)
@@ -826,7 +946,7 @@ void EU4::Country::initializeRulers(const mappers::ReligionMapper& religionMappe
 
 		details.monarch.name = "(Regency Council)";
 		details.monarch.regency = true;
-		details.monarch.birthDate = date("1.1.1");
+		details.monarch.birthDate = date(1, 1, 1);
 		details.monarch.female = false;
 		details.monarch.dynasty.clear();
 		details.monarch.personalities.clear();
@@ -835,6 +955,7 @@ void EU4::Country::initializeRulers(const mappers::ReligionMapper& religionMappe
 
 void EU4::Country::setPrimaryCulture(const std::string& culture)
 {
+	auto& details = this->details.edit();
 	details.primaryCulture = culture;
 	if (details.monarch.isSet && details.monarch.culture.empty())
 		details.monarch.culture = culture;
@@ -847,29 +968,22 @@ void EU4::Country::setPrimaryCulture(const std::string& culture)
 // All cultures that make up more than 33% of a countries dev will start the game as accepted
 void EU4::Country::setAcceptedCultures()
 {
-	std::map<std::string, int> cultureDevelopment; // culture, development
-	int substantialDev = 0;
-	for (const auto& province: provinces)
+	const auto substantialDev = development / 3;
+	for (const auto& culture: census.getCultures())
 	{
-		substantialDev += province.second->getDev();
-		if (!province.second->getCulture().empty())
-			cultureDevelopment[province.second->getCulture()] += province.second->getDev();
-	}
-	substantialDev /= 3;
-	for (const auto& culture: cultureDevelopment)
-	{
-		if (culture.second >= substantialDev && culture.first != details.primaryCulture)
-			details.acceptedCultures.insert(culture.first);
+		if (culture.second.development >= substantialDev && culture.first != details->primaryCulture)
+			details.edit().acceptedCultures.insert(culture.first);
 	}
 }
 
 void EU4::Country::setMajorityReligion(const std::string& religion)
 {
-	details.majorityReligion = religion;
+	details.edit().majorityReligion = religion;
 }
 
 void EU4::Country::setReligion(const std::string& religion)
 {
+	auto& details = this->details.edit();
 	details.religion = religion;
 	if (details.monarch.isSet && details.monarch.religion.empty())
 		details.monarch.religion = religion;
@@ -879,35 +993,51 @@ void EU4::Country::setReligion(const std::string& religion)
 		details.heir.religion = religion;
 }
 
-int EU4::Country::getDevelopment() const
+void EU4::Country::registerProvince(const std::pair<int, Province*>& theProvince)
+{
+	if (!provinces.insert(theProvince).second)
+		return;
+	theProvince.second->registerDevelopmentOwner(this);
+	development += theProvince.second->getDev();
+	census.add(*theProvince.second);
+}
+
+void EU4::Country::clearProvinces()
 {
-	auto dev = 0;
 	for (const auto& province: provinces)
-		dev += province.second->getDev();
-	return dev;
+		province.second->unregisterDevelopmentOwner(this);
+	provinces.clear();
+	development = 0;
+	census.clear();
 }
 
 void EU4::Country::annexCountry(const std::pair<std::string, std::shared_ptr<Country>>& theCountry)
 {
-	// Provinces
-	const auto& targetProvinces = theCountry.second->getProvinces();
+	// Provinces. Adding cores, not replacing. Unless the special snowflake.
+	const Tag core(tag);
+	const auto replaceCores = tag == "PAP" || tag == "FAP";
+	auto& targetProvinces = theCountry.second->provinces;
 	for (const auto& province: targetProvinces)
 	{
-		// Adding, not replacing. Unless the special snowflake.
-		if (tag == "PAP" || tag == "FAP")
-			province.second->dropCores();
-		province.second->addCore(tag);
-		province.second->setOwner(tag);
-		province.second->setController(tag);
-		provinces.insert(province);
+		province.second->transferTo(tag, core, replaceCores);
+		province.second->registerDevelopmentOwner(this);
+	}
+	// The whole lot moves over at once. Anything we somehow already had stays behind and is dropped with the rest.
+	development += theCountry.second->development;
+	census.merge(theCountry.second->census);
+	provinces.merge(targetProvinces);
+	for (const auto& province: targetProvinces)
+	{
+		development -= province.second->getDev();
+		census.remove(*province.second);
 	}
 	theCountry.second->clearProvinces();
 
 	// relevant flags
 	if (theCountry.second->isHREEmperor())
-		details.holyRomanEmperor = true;
+		details.edit().holyRomanEmperor = true;
 	if (theCountry.second->isHREElector())
-		details.elector = true;
+		details.edit().elector = true;
 
 	// Vassals
 	const auto& targetVassals = theCountry.second->getTitle().second->getGeneratedVassals();
@@ -921,25 +1051,12 @@ void EU4::Country::annexCountry(const std::pair<std::string, std::shared_ptr<Cou
 	// Bricking the title -> eu4tag is not necessary and not desirable. As soon as the country has 0 provinces, it's effectively dead.
 }
 
-void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& regionMapper)
+void EU4::Country::assignReforms(const std::shared_ptr<const mappers::RegionMapper>& regionMapper)
 {
+	auto& details = this->details.edit();
 	// Setting the Primary Religion (The religion most common in the country, not the religion of the country, needed for some reforms)
 	if (details.majorityReligion.empty() || details.majorityReligion == "noreligion")
-	{
-		std::map<std::string, int> religionDevelopment; // religion, development
-		int primeDev = -1;
-		std::string primeReligion;
-		for (const auto& province: provinces)
-		{
-			religionDevelopment[province.second->getReligion()] += province.second->getDev();
-			if (religionDevelopment[province.second->getReligion()] > primeDev)
-			{
-				primeReligion = province.second->getReligion();
-				primeDev = religionDevelopment[province.second->getReligion()];
-			}
-		}
-		setMajorityReligion(primeReligion);
-	}
+		setMajorityReligion(ProvinceCensus::mostDevelopment(census.getReligions()));
 
 	// Set Accepted Cultures
 	setAcceptedCultures();
@@ -958,109 +1075,33 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 		}
 	}
 
-	// RELGIONS
-	//  Muslims
-	std::set<std::string> muslimReligions = {"sunni", "zikri", "yazidi", "ibadi", "kharijite", "shiite", "druze", "hurufi", "qarmatian"};
-	// Mazdans
-	std::set<std::string> mazdanReligions = {"zoroastrian", "mazdaki", "manichean", "khurmazta"};
-	// Buddhists
-	std::set<std::string> buddhistReligions = {"buddhism", "vajrayana", "mahayana"};
-	// Eastern
-	std::set<std::string> easternReligions = {"confucianism", "shinto", "buddhism", "vajrayana", "mahayana"};
-	// Indians (Dharmic + Buddhists)
-	std::set<std::string> indianReligions = {"buddhism", "vajrayana", "mahayana", "hinduism", "jain"};
-	// Protestants
-	std::set<std::string> protestantReligions = {"protestant", "reformed", "hussite", "cathar", "waldensian", "lollard"};
-	// Orthodox
-	std::set<std::string> orthodoxReligions = {"orthodox", "monothelite", "iconoclast", "paulician", "bogomilist"};
-	// Pagan
-	std::set<std::string> paganReligions = {"pagan_religion",
-		 "norse_pagan",
-		 "norse_pagan_reformed",
-		 "tengri_pagan",
-		 "tengri_pagan_reformed",
-		 "baltic_pagan",
-		 "baltic_pagan_reformed",
-		 "finnish_pagan",
-		 "finnish_pagan_reformed",
-		 "slavic_pagan",
-		 "slavic_pagan_reformed",
-		 "shamanism",
-		 "west_african_pagan",
-		 "west_african_pagan_reformed",
-		 "hellenic_pagan",
-		 "hellenic_pagan_reformed",
-		 "zun_pagan",
-		 "zun_pagan_reformed",
-		 "bon",
-		 "bon_reformed",
-		 "animism",
-		 "totemism",
-		 "inti",
-		 "nahuatl",
-		 "mesoamerican_religion"};
-
-	// CULTURES
-	// Chinese Culture Group
-	std::set<std::string> chineseCultures = {"vietnamese_new",
-		 "korean_new",
-		 "tibetan_new",
-		 "altaic_new",
-		 "manchu_new",
-		 "chihan",
-		 "cantonese",
-		 "jin",
-		 "wu",
-		 "chimin",
-		 "hakka",
-		 "gan",
-		 "xiang",
-		 "sichuanese",
-		 "jianghuai",
-		 "xibei",
-		 "hubei",
-		 "zhongyuan",
-		 "shandong_culture"};
-	// Russian Cultures (Not all East Slavic)
-	std::set<std::string> russianCultures = {"ilmenian", "volhynian", "severian", "russian", "russian_culture", "novgorodian", "ryazanian"};
-	// Dravidian Culture Group
-	std::set<std::string> dravidianCultures = {"kannada", "malayalam", "tamil", "telegu"};
-	// Western Aryan Culture Group
-	std::set<std::string> westAryanCultures = {"gujarati", "saurashtri", "marathi", "sindhi", "rajput", "malvi"};
-	// Baltic Culture Group
-	std::set<std::string> balticCultures = {"estonian", "lithuanian", "latvian", "old_prussian"};
-	// Roman Culture Group
-	std::set<std::string> latinCultures = {"lombard",
-		 "tuscan",
-		 "sardinian",
-		 "romagnan",
-		 "ligurian",
-		 "venetian",
-		 "dalmatian ",
-		 "neapolitan",
-		 "piedmontese",
-		 "umbrian",
-		 "sicilian",
-		 "maltese",
-		 "italian"};
+	// Which reform groups our religions and culture belong to.
+	const auto religionGroups = reformGroupsOf(religionReformGroups(), details.religion);
+	const auto majorityReligionGroups = reformGroupsOf(religionReformGroups(), details.majorityReligion);
+	const auto cultureGroups = reformGroupsOf(cultureReformGroups(), details.primaryCulture);
+	// Asked over and over below, so worked out once.
+	const auto slavicFaith = (religionGroups & ORTHODOX) || details.religion == "slavic_pagan" || details.religion == "slavic_pagan_reformed";
+	const auto& holderGovernment = actualHolder->getGovernment();
+	const auto& successionLaw = title.second->getSuccessionLaw();
+
 	// GENERIC REFORMS
-	std::set<std::string> laws = title.second->getLaws();
+	const auto& laws = title.second->getLaws();
 	std::string governmentType = "despotic"; // Despotism will be the default
 	short numberOfLaws = 0;
 	// These are the council laws that give power to the council. The ones that give power to the monarch would end in 0 instead of 1
-	if (title.second->getLaws().count("law_voting_power_1"))
+	if (laws.count("law_voting_power_1"))
 		numberOfLaws++;
-	if (title.second->getLaws().count("banish_voting_power_1"))
+	if (laws.count("banish_voting_power_1"))
 		numberOfLaws++;
-	if (title.second->getLaws().count("execution_voting_power_1"))
+	if (laws.count("execution_voting_power_1"))
 		numberOfLaws++;
-	if (title.second->getLaws().count("revoke_title_voting_power_1"))
+	if (laws.count("revoke_title_voting_power_1"))
 		numberOfLaws++;
-	if (title.second->getLaws().count("grant_title_voting_power_1"))
+	if (laws.count("grant_title_voting_power_1"))
 		numberOfLaws++;
-	if (title.second->getLaws().count("imprison_voting_power_1"))
+	if (laws.count("imprison_voting_power_1"))
 		numberOfLaws++;
-	if (title.second->getLaws().count("war_voting_power_1"))
+	if (laws.count("war_voting_power_1"))
 		numberOfLaws++;
 	if (numberOfLaws >= 6)
 		governmentType = "aristocratic";
@@ -1073,23 +1114,23 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 	if (details.government == "monarchy")
 	{
 		// Electoral
-		if (title.second->getSuccessionLaw() == "feudal_elective" && tag != "ROM" && tag != "HRE" && tag != "BYZ")
+		if (successionLaw == "feudal_elective" && tag != "ROM" && tag != "HRE" && tag != "BYZ")
 		{
 			details.reforms.clear();
 			details.reforms = {"elective_monarchy_reform"};
 		}
 		// Weird Edge Cases
-		else if (title.second->getSuccessionLaw() == "byzantine_elective" && (title.first.find("e_roman_empire") || title.first.find("e_byzantium")))
+		else if (successionLaw == "byzantine_elective" && (title.first.find("e_roman_empire") || title.first.find("e_byzantium")))
 		{
 			details.reforms.clear();
 			details.reforms = {"byzantine_autocracy_reform"};
 		}
-		else if (title.second->getSuccessionLaw() == "byzantine_elective" && !title.first.find("e_"))
+		else if (successionLaw == "byzantine_elective" && title.second->getRank() == CK2::Title::RANK::EMPIRE)
 		{
 			details.reforms.clear();
 			details.reforms = {"autocracy_reform"};
 		}
-		else if (title.second->getSuccessionLaw() == "open_elective") // Should only be applicable to Mercenary Companies
+		else if (successionLaw == "open_elective") // Should only be applicable to Mercenary Companies
 		{
 			details.government.clear();
 			details.government = "republic";
@@ -1098,23 +1139,23 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 			isMerc = true;
 		}
 		// Chinese Warlord
-		else if (chineseCultures.count(details.primaryCulture) &&
-					(governmentType == "absolute" || actualHolder->getGovernment() == "chinese_imperial_government"))
+		else if ((cultureGroups & CHINESE) &&
+					(governmentType == "absolute" || holderGovernment == "chinese_imperial_government"))
 		{
 			details.reforms.clear();
 			details.reforms = {"chinese_warlord"};
 		}
-		else if (actualHolder->getGovernment() == "chinese_imperial_government" && details.religion == "confucianism")
+		else if (holderGovernment == "chinese_imperial_government" && details.religion == "confucianism")
 		{
 			details.reforms.clear();
 			details.reforms = {"confucian_bureaucracy"};
 		}
-		else if (actualHolder->getGovernment() == "roman_imperial_government" || actualHolder->getGovernment() == "chinese_imperial_government")
+		else if (holderGovernment == "roman_imperial_government" || holderGovernment == "chinese_imperial_government")
 		{
 			details.reforms.clear();
 			details.reforms = {"autocracy_reform"};
 		}
-		else if (actualHolder->getGovernment() == "theocratic_feudal_government")
+		else if (holderGovernment == "theocratic_feudal_government")
 		{
 			details.reforms.clear();
 			details.reforms = {"feudal_theocracy"};
@@ -1140,7 +1181,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 			details.reforms = {"musa_rule"};
 		}
 		// Iqta
-		else if (actualHolder->getGovernment() == "muslim_government" && muslimReligions.count(details.religion) &&
+		else if (holderGovernment == "muslim_government" && (religionGroups & MUSLIM) &&
 					(governmentType == "aristocratic" || governmentType == "despotic"))
 		{
 			details.reforms.clear();
@@ -1159,7 +1200,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 			details.reforms = {"english_monarchy"};
 		}
 		// Beylik gov. Ottoman Government (Renamed in converter) is disabled due to decadence being tied to TUR alone.
-		else if (actualHolder->getGovernment() == "muslim_government" && muslimReligions.count(details.religion) && governmentType == "absolute")
+		else if (holderGovernment == "muslim_government" && (religionGroups & MUSLIM) && governmentType == "absolute")
 		{
 			details.reforms.clear();
 			details.reforms = {"beylik_government"};
@@ -1175,12 +1216,12 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 	if (details.government == "republic" && !details.reforms.count("noble_elite_reform"))
 	{
 		// Weird Edge Cases
-		if (actualHolder->getGovernment() == "confucian_bureaucracy")
+		if (holderGovernment == "confucian_bureaucracy")
 		{
 			details.government.clear();
 			details.government = "monarchy";
 			details.reforms.clear();
-			if (chineseCultures.count(details.primaryCulture))
+			if (cultureGroups & CHINESE)
 				details.reforms = {"chinese_warlord"};
 			else if (actualHolder->getReligion() == "confucianism")
 				details.reforms = {"confucian_bureaucracy"};
@@ -1188,14 +1229,14 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 				details.reforms = {"autocracy_reform"};
 		}
 		// Merchant Republic
-		else if (actualHolder->getGovernment() == "merchant_republic_government")
+		else if (holderGovernment == "merchant_republic_government")
 		{
 			details.reforms.clear();
 			details.reforms = {"merchants_reform"};
 			details.mercantilism = 25;
 		}
 		// Oligarchic Republic
-		else if (actualHolder->getGovernment() == "republic_government" && governmentType != "aristocratic")
+		else if (holderGovernment == "republic_government" && governmentType != "aristocratic")
 		{
 			details.reforms.clear();
 			details.reforms = {"oligarchy_reform"};
@@ -1211,7 +1252,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 	if (details.government == "tribal")
 	{
 		// Weird Edge Cases
-		if (details.governmentRank == 3 && actualHolder->getGovernment() != "nomadic_government")
+		if (details.governmentRank == 3 && holderGovernment != "nomadic_government")
 		{
 			details.reforms.clear();
 			details.reforms = {"sacred_kingdom"};
@@ -1222,7 +1263,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 			details.reforms = {"matrilineal_system"};
 		}
 		// Hordes
-		else if (actualHolder->getGovernment() == "nomadic_government")
+		else if (holderGovernment == "nomadic_government")
 		{
 			details.reforms.clear();
 			details.reforms = {"steppe_horde"};
@@ -1235,31 +1276,31 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 			details.reforms = {"siberian_tribe"};
 		}
 		// Tribal Confederacy
-		else if (!title.second->getLaws().count("tribal_organization_3") && !title.second->getLaws().count("tribal_organization_4"))
+		else if (!laws.count("tribal_organization_3") && !laws.count("tribal_organization_4"))
 		{
 			details.reforms.clear();
 			details.reforms = {"tribal_confederacy"};
 		}
 		// Great Man
-		else if (title.second->getLaws().count("tribal_organization_4") && title.second->getSuccessionLaw() != "elective_gavelkind")
+		else if (laws.count("tribal_organization_4") && successionLaw != "elective_gavelkind")
 		{
 			details.reforms.clear();
 			details.reforms = {"great_man"};
 		}
 		// Tribal Kingdoms
-		else if (title.second->getSuccessionLaw() == "gavelkind")
+		else if (successionLaw == "gavelkind")
 		{
 			details.reforms.clear();
 			details.reforms = {"tribal_kingdom"};
 		}
 		// Tribal Federations
-		else if (muslimReligions.count(details.religion))
+		else if (religionGroups & MUSLIM)
 		{
 			details.reforms.clear();
 			details.reforms = {"tribal_federation"};
 		}
 		// Feudal Tribe
-		else if (title.second->getSuccessionLaw() != "elective_gavelkind" && title.second->getSuccessionLaw() != "gavelkind")
+		else if (successionLaw != "elective_gavelkind" && successionLaw != "gavelkind")
 		{
 			details.reforms.clear();
 			details.reforms = {"feudal_tribe"};
@@ -1268,7 +1309,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 		else
 		{
 			// Stateless Society
-			if (provinces.size() == 1 && paganReligions.contains(details.religion) && !details.religion.find("reformed"))
+			if (provinces.size() == 1 && (religionGroups & PAGAN) && !details.religion.find("reformed"))
 			{
 				details.reforms.clear();
 				details.reforms = {"stateless_society"};
@@ -1291,7 +1332,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 			details.reforms = {"papacy_reform"};
 		}
 		// Holy Orders
-		else if (title.second->getSuccessionLaw() == "open_elective")
+		else if (successionLaw == "open_elective")
 		{
 			details.reforms.clear();
 			details.reforms = {"monastic_order_reform"};
@@ -1335,29 +1376,28 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 		details.reforms = {"austrian_archduchy_reform"};
 	}
 	// Prussian Monarchy (Renamed in converter)
-	else if (details.government == "monarchy" && tag == "PRU" && protestantReligions.count(details.religion))
+	else if (details.government == "monarchy" && tag == "PRU" && (religionGroups & PROTESTANT))
 	{
 		details.reforms.clear();
 		details.reforms = {"prussian_monarchy"};
 	}
 	// Tsardom
 	else if (details.government == "monarchy" &&
-				(tag == "UKR" || (tag == "RUS" && (orthodoxReligions.count(details.religion) || details.religion == "slavic_pagan" ||
-																  details.religion == "slavic_pagan_reformed"))))
+				(tag == "UKR" || (tag == "RUS" && slavicFaith)))
 	{
 		details.reforms.clear();
 		details.reforms = {"tsardom"};
 	}
 	// Principality
 	else if (details.government == "monarchy" && details.governmentRank != 3 &&
-				(orthodoxReligions.count(details.religion) || details.religion == "slavic_pagan" || details.religion == "slavic_pagan_reformed") &&
-				russianCultures.count(details.primaryCulture) && tag != "POL" && tag != "PAP" && tag != "HLR")
+				slavicFaith &&
+				(cultureGroups & RUSSIAN) && tag != "POL" && tag != "PAP" && tag != "HLR")
 	{
 		details.reforms.clear();
 		details.reforms = {"principality"};
 	}
 	// Mamluk (Renamed in converter)
-	else if (muslimReligions.count(details.religion) && isMerc &&
+	else if ((religionGroups & MUSLIM) && isMerc &&
 				(regionMapper->provinceIsInRegion(details.capital, "near_east_superregion") ||
 					 regionMapper->provinceIsInRegion(details.capital, "eastern_europe_superregion") ||
 					 regionMapper->provinceIsInRegion(details.capital, "persia_superregion") || regionMapper->provinceIsInRegion(details.capital, "egypt_region") ||
@@ -1374,23 +1414,22 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 	// Indian Sultanate (Renamed in Converter)
 	else if ((details.reforms.count("feudalism_reform") || details.reforms.count("autocracy_reform") || details.reforms.count("iqta") ||
 					 details.reforms.count("ottoman_government")) &&
-				muslimReligions.count(details.religion) && indianReligions.count(details.majorityReligion))
+				(religionGroups & MUSLIM) && (majorityReligionGroups & INDIAN))
 	{
 		details.reforms.clear();
 		details.reforms = {"indian_sultanate_reform"};
 	}
 	// Mandala
 	else if ((details.reforms.count("feudalism_reform") || details.reforms.count("english_monarchy")) && details.technologyGroup == "chinese" &&
-				(paganReligions.count(details.religion) || muslimReligions.count(details.religion) || easternReligions.count(details.religion) ||
-					 indianReligions.count(details.religion)))
+				(religionGroups & (PAGAN | MUSLIM | EASTERN | INDIAN)))
 	{
 		details.reforms.clear();
 		details.reforms = {"mandala_reform"};
 	}
 	// Nayankara
-	else if ((details.reforms.count("feudalism_reform") || details.reforms.count("english_monarchy")) && indianReligions.count(details.religion) &&
+	else if ((details.reforms.count("feudalism_reform") || details.reforms.count("english_monarchy")) && (religionGroups & INDIAN) &&
 				details.technologyGroup == "indian" &&
-				(dravidianCultures.count(details.primaryCulture) || details.primaryCulture == "oriya" || details.primaryCulture == "sinhala"))
+				((cultureGroups & DRAVIDIAN) || details.primaryCulture == "oriya" || details.primaryCulture == "sinhala"))
 	{
 		details.reforms.clear();
 		details.reforms = {"nayankara_reform"};
@@ -1398,7 +1437,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 	// Rajput
 	else if ((details.reforms.count("feudalism_reform") || details.reforms.count("english_monarchy") || details.reforms.count("autocracy_reform")) &&
 				details.technologyGroup == "indian" && details.primaryCulture != "marathi" &&
-				(details.primaryCulture == "vindhyan" || westAryanCultures.count(details.primaryCulture)))
+				(details.primaryCulture == "vindhyan" || (cultureGroups & WEST_ARYAN)))
 	{
 		details.reforms.clear();
 		details.reforms = {"rajput_kingdom"};
@@ -1425,7 +1464,7 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 	else if ((details.reforms.count("feudalism_reform") || details.reforms.count("english_monarchy") || details.reforms.count("autocracy_reform")) &&
 				details.governmentRank == 1 &&
 				(tag == "LUX" || tag == "BAD" || tag == "TUS" || tag == "FIN" || tag == "LIT" || details.primaryCulture == "finnish" ||
-					 balticCultures.count(details.primaryCulture)))
+					 (cultureGroups & BALTIC)))
 	{
 		details.reforms.clear();
 		details.reforms = {"grand_duchy_reform"};
@@ -1449,22 +1488,22 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 
 	// Veche Republic
 	else if (details.government == "republic" && details.governmentRank != 3 &&
-				(orthodoxReligions.count(details.religion) || details.religion == "slavic_pagan" || details.religion == "slavic_pagan_reformed") &&
-				russianCultures.count(details.primaryCulture) && tag != "POL" && tag != "PAP" && tag != "HLR")
+				slavicFaith &&
+				(cultureGroups & RUSSIAN) && tag != "POL" && tag != "PAP" && tag != "HLR")
 	{
 		details.reforms.clear();
 		details.reforms = {"veche_republic"};
 		details.mercantilism = 25;
 	}
 	// Prussian Republic (Renamed in converter)
-	else if (details.government == "republic" && tag == "PRU" && protestantReligions.count(details.religion))
+	else if (details.government == "republic" && tag == "PRU" && (religionGroups & PROTESTANT))
 	{
 		details.reforms.clear();
 		details.reforms = {"prussian_republic_reform"};
 	}
 	// Signoria
 	else if (details.government == "republic" && !details.reforms.count("merchants_reform") && !details.reforms.count("venice_merchants_reform") &&
-				!details.reforms.count("free_city") && latinCultures.count(details.primaryCulture))
+				!details.reforms.count("free_city") && (cultureGroups & LATIN))
 	{
 		details.reforms.clear();
 		details.reforms = {"signoria_reform"};
@@ -1488,6 +1527,13 @@ void EU4::Country::assignReforms(const std::shared_ptr<mappers::RegionMapper>& r
 
 void EU4::Country::correctRoyaltyToBuddhism()
 {
+	const auto vajrayana = [](const Character& character) {
+		return character.religion == "vajrayana";
+	};
+	if (!vajrayana(this->details->monarch) && !vajrayana(this->details->queen) && !vajrayana(this->details->heir) &&
+		 std::ranges::none_of(this->details->advisers, vajrayana))
+		return; // nothing to correct, nor to copy for it
+	auto& details = this->details.edit();
 	if (details.monarch.religion == "vajrayana")
 		details.monarch.religion = "buddhism";
 	if (details.queen.religion == "vajrayana")
@@ -1510,3 +1556,15 @@ date EU4::Country::normalizeDate(const date& incomingDate, Configuration::STARTD
 
 	return date(incomingYear + yearDelta, incomingDate.getMonth(), incomingDate.getDay());
 }
+
+std::size_t EU4::Country::heapBytes() const
+{
+	using CK2::MemoryCensus;
+	auto bytes = MemoryCensus::heapBytes(tag) + MemoryCensus::heapBytes(commonCountryFile) + MemoryCensus::heapBytes(historyCountryFile) +
+					 details->heapBytes() + MemoryCensus::heapBytes(title) + MemoryCensus::heapBytes(provinces);
+	bytes += localizations.size() * (sizeof(decltype(localizations)::value_type) + MemoryCensus::treeNodeBytes);
+	for (const auto& [key, block]: localizations)
+		bytes += MemoryCensus::heapBytes(key) + MemoryCensus::heapBytes(block.english) + MemoryCensus::heapBytes(block.french) +
+					MemoryCensus::heapBytes(block.german) + MemoryCensus::heapBytes(block.spanish);
+	return bytes;
+}
@@ -5,7 +5,9 @@
 #include "../../Configuration/Configuration.h"
 #include "../../Mappers/LocalizationMapper/LocalizationMapper.h"
 #include "../../Mappers/RegionMapper/RegionMapper.h"
+#include "../../Parsing/CopyOnWrite.h"
 #include "CountryDetails.h"
+#include "ProvinceCensus.h"
 #include <memory>
 #include <string>
 
@@ -15,13 +17,14 @@ class GovernmentsMapper;
 class ReligionMapper;
 class CultureMapper;
 class ColorScraper;
-class ProvinceMapper;
 class RulerPersonalitiesMapper;
 } // namespace mappers
 
 namespace EU4
 {
+class CapitalTable;
 class Province;
+class TextBuffer;
 class Country
 {
   public:
@@ -34,7 +37,7 @@ class Country
 		 const mappers::GovernmentsMapper& governmentsMapper,
 		 const mappers::ReligionMapper& religionMapper,
 		 const mappers::CultureMapper& cultureMapper,
-		 const mappers::ProvinceMapper& provinceMapper,
+		 const CapitalTable& capitals,
 		 const mappers::ColorScraper& colorScraper,
 		 const mappers::LocalizationMapper& localizationMapper,
 		 const mappers::RulerPersonalitiesMapper& rulerPersonalitiesMapper,
@@ -50,64 +53,76 @@ class Country
 		 Configuration::STARTDATE startDateOption,
 		 const date& theConversionDate);
 
-	void outputCommons(std::ostream& output) const;
-	void outputAdvisers(std::ostream& output) const;
+	void outputCommons(TextBuffer& output) const;
+	void outputAdvisers(TextBuffer& output) const;
 
 	[[nodiscard]] const auto& getCommonCountryFile() const { return commonCountryFile; }
 	[[nodiscard]] const auto& getHistoryCountryFile() const { return historyCountryFile; }
 	[[nodiscard]] const auto& getLocalizations() const { return localizations; }
-	[[nodiscard]] const auto& getPrimaryCulture() const { return details.primaryCulture; }
-	[[nodiscard]] const auto& getMajorityReligion() const { return details.majorityReligion; }
-	[[nodiscard]] const auto& getReligion() const { return details.religion; }
-	[[nodiscard]] const auto& getTechGroup() const { return details.technologyGroup; }
-	[[nodiscard]] const auto& getGFX() const { return details.graphicalCulture; }
+	[[nodiscard]] const auto& getPrimaryCulture() const { return details->primaryCulture; }
+	[[nodiscard]] const auto& getMajorityReligion() const { return details->majorityReligion; }
+	[[nodiscard]] const auto& getReligion() const { return details->religion; }
+	[[nodiscard]] const auto& getTechGroup() const { return details->technologyGroup; }
+	[[nodiscard]] const auto& getGFX() const { return details->graphicalCulture; }
 	[[nodiscard]] const auto& getProvinces() const { return provinces; }
 	[[nodiscard]] const auto& getTitle() const { return title; }
-	[[nodiscard]] const auto& getGovernment() const { return details.government; }
-	[[nodiscard]] const auto& getGovernmentReforms() const { return details.reforms; }
+	[[nodiscard]] const auto& getGovernment() const { return details->government; }
+	[[nodiscard]] const auto& getGovernmentReforms() const { return details->reforms; }
 	[[nodiscard]] const auto& getTag() const { return tag; }
-	[[nodiscard]] const auto& getAdvisers() const { return details.advisers; }
+	[[nodiscard]] const auto& getAdvisers() const { return details->advisers; }
 	[[nodiscard]] auto getConversionDate() const { return conversionDate; }
-	[[nodiscard]] auto isExcommunicated() const { return details.excommunicated; }
-	[[nodiscard]] auto isHREEmperor() const { return details.holyRomanEmperor; }
-	[[nodiscard]] auto isHREElector() const { return details.elector; }
-	[[nodiscard]] auto isinHRE() const { return details.inHRE; }
-	[[nodiscard]] auto isSunsetCountry() const { return details.isSunsetCountry; }
-	[[nodiscard]] auto getCapitalID() const { return details.capital; }
-	[[nodiscard]] auto getDynastyID() const { return details.dynastyID; }
-	[[nodiscard]] auto getHasDynastyName() const { return details.hasDynastyName; }
+	[[nodiscard]] auto isExcommunicated() const { return details->excommunicated; }
+	[[nodiscard]] auto isHREEmperor() const { return details->holyRomanEmperor; }
+	[[nodiscard]] auto isHREElector() const { return details->elector; }
+	[[nodiscard]] auto isinHRE() const { return details->inHRE; }
+	[[nodiscard]] auto isSunsetCountry() const { return details->isSunsetCountry; }
+	[[nodiscard]] auto getCapitalID() const { return details->capital; }
+	[[nodiscard]] auto getDynastyID() const { return details->dynastyID; }
+	[[nodiscard]] auto getHasDynastyName() const { return details->hasDynastyName; }
 
-	[[nodiscard]] int getDevelopment() const;
+	[[nodiscard]] auto getDevelopment() const { return development; }
+	[[nodiscard]] const auto& getCensus() const { return census; }
 
-	bool verifyCapital(const mappers::ProvinceMapper& provinceMapper);
+	bool verifyCapital(const CapitalTable& capitals);
 
-	void registerProvince(std::pair<int, std::shared_ptr<Province>> theProvince) { provinces.insert(std::move(theProvince)); }
+	void registerProvince(const std::pair<int, Province*>& theProvince);
 	void setPrimaryCulture(const std::string& culture);
-	void addAcceptedCulture(const std::string& culture) { details.acceptedCultures.emplace(culture); };
+	void addAcceptedCulture(const std::string& culture) { details.edit().acceptedCultures.emplace(culture); };
 	void setAcceptedCultures();
 	void setMajorityReligion(const std::string& religion);
 	void setReligion(const std::string& religion);
-	void overrideReforms(const std::string& reform) { details.reforms = {reform}; }
-	void setGovernment(const std::string& government) { details.government = government; }
-	void setSunsetCountry(bool isSunsetCountry) { details.isSunsetCountry = isSunsetCountry; }
-	void setElector() { details.elector = true; }
-	void setTechGroup(const std::string& tech) { details.technologyGroup = tech; }
-	void setGFX(const std::string& gfx) { details.graphicalCulture = gfx; }
-	void clearProvinces() { provinces.clear(); }
+	void overrideReforms(const std::string& reform) { details.edit().reforms = {reform}; }
+	void setGovernment(const std::string& government) { details.edit().government = government; }
+	void setSunsetCountry(bool isSunsetCountry) { details.edit().isSunsetCountry = isSunsetCountry; }
+	void setElector() { details.edit().elector = true; }
+	void setTechGroup(const std::string& tech) { details.edit().technologyGroup = tech; }
+	void setGFX(const std::string& gfx) { details.edit().graphicalCulture = gfx; }
+	void clearProvinces();
 	void annexCountry(const std::pair<std::string, std::shared_ptr<Country>>& theCountry);
-	void setMonarch(const Character& monarch) { details.monarch = monarch; }
-	void clearHistoryLessons() { details.historyLessons.clear(); }
+	void setMonarch(const Character& monarch) { details.edit().monarch = monarch; }
+	void clearHistoryLessons() { details.edit().historyLessons.clear(); }
 	void setConversionDate(date theDate) { conversionDate = theDate; }
-	void clearExcommunicated() { details.excommunicated = false; }
-	void setLocalizations(const mappers::LocBlock& newBlock);
+	void clearExcommunicated() { details.edit().excommunicated = false; }
+	void setLocalizations(mappers::LocBlock newBlock);
 	void correctRoyaltyToBuddhism();
-	void setMercantilism(int mercantilism) { details.mercantilism = mercantilism; }
+	void setMercantilism(int mercantilism) { details.edit().mercantilism = mercantilism; }
 
-	void assignReforms(const std::shared_ptr<mappers::RegionMapper>& regionMapper);
+	void assignReforms(const std::shared_ptr<const mappers::RegionMapper>& regionMapper);
+	[[nodiscard]] std::size_t heapBytes() const; // for CK2::MemoryCensus
 
-	friend std::ostream& operator<<(std::ostream& output, const Country& versionParser);
+	friend TextBuffer& operator<<(TextBuffer& output, const Country& versionParser);
 
   private:
+	friend class VanillaCache;
+	friend class Province; // reports dev and religion changes of provinces we own
+
+	void adjustDevelopment(const Province& province, const int delta)
+	{
+		development += delta;
+		census.adjustDevelopment(province, delta);
+	}
+	void changeReligion(const Province& province, const std::string& religion) { census.changeReligion(province, religion); }
+
 	[[nodiscard]] date normalizeDate(const date& incomingDate,
 		 Configuration::STARTDATE startDateOption,
 		 const date& theConversionDate) const; // Uses bookmark date to shift dates if required.
@@ -116,11 +131,13 @@ class Country
 	std::string commonCountryFile;
 	std::string historyCountryFile;
 	date conversionDate; // for dating the monarchs in history file.
-	CountryDetails details;
+	parsing::CopyOnWrite<CountryDetails> details; // shared with the vanilla image until changed
 
 	std::pair<std::string, std::shared_ptr<CK2::Title>> title;
 	std::map<std::string, mappers::LocBlock> localizations;
-	std::map<int, std::shared_ptr<Province>> provinces;
+	std::map<int, Province*> provinces; // owned by the world's province table
+	int development = 0; // of all provinces above, kept current so rankings by development don't sum them up each time
+	ProvinceCensus census; // of all provinces above, kept current the same way
 };
 } // namespace EU4
 
@@ -1,8 +1,11 @@
 #include "CountryDetails.h"
+#include "../../CK2World/MemoryCensus.h"
+#include "../../Parsing/ItemSkipper.h"
 #include "CommonRegexes.h"
 #include "MonarchNames.h"
 #include "OSCompatibilityLayer.h"
 #include "ParserHelpers.h"
+#include <sstream>
 
 EU4::CountryDetails::CountryDetails(const std::string& filePath)
 {
@@ -64,6 +67,47 @@ void EU4::CountryDetails::registerKeys()
 		const auto& theIdeas = unitsList.getStrings();
 		historicalUnits.insert(theIdeas.begin(), theIdeas.end());
 	});
+	// The name lists are most of a common file, and only countries a title takes over ever look at them.
+	for (const auto* const listKey: {"monarch_names", "leader_names", "ship_names", "army_names", "fleet_names"})
+		registerKeyword(listKey, [this](const std::string& nameList, std::istream& theStream) {
+			pendingNames.append(nameList).append(parsing::ItemSkipper::capture(theStream)).push_back('\n');
+		});
+	registerKeyword("preferred_religion", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString religStr(theStream);
+		preferredReligion = religStr.getString();
+	});
+	registerKeyword("colonial_parent", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString parentStr(theStream);
+		colonialParent = parentStr.getString();
+	});
+	registerKeyword("special_unit_culture", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString unitStr(theStream);
+		specialUnitCulture = unitStr.getString();
+	});
+	registerKeyword("all_your_core_are_belong_to_us", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString synStr(theStream);
+		all_your_core_are_belong_to_us = synStr.getString() == "yes";
+	});
+	registerKeyword("right_to_bear_arms", [this](const std::string& unused, std::istream& theStream) {
+		const commonItems::singleString mayenStr(theStream);
+		rightToBEARArms = mayenStr.getString() == "yes";
+	});
+	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+}
+
+void EU4::CountryDetails::loadNames()
+{
+	if (pendingNames.empty())
+		return;
+	registerNameKeys();
+	std::istringstream names(pendingNames);
+	parseStream(names);
+	clearRegisteredKeywords();
+	pendingNames.clear();
+}
+
+void EU4::CountryDetails::registerNameKeys()
+{
 	registerKeyword("monarch_names", [this](const std::string& unused, std::istream& theStream) {
 		const auto mNames = MonarchNames(theStream);
 		monarchNames = mNames.getMonarchNames();
@@ -88,26 +132,6 @@ void EU4::CountryDetails::registerKeys()
 		const auto& theNames = namesList.getStrings();
 		fleetNames.insert(theNames.begin(), theNames.end());
 	});
-	registerKeyword("preferred_religion", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString religStr(theStream);
-		preferredReligion = religStr.getString();
-	});
-	registerKeyword("colonial_parent", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString parentStr(theStream);
-		colonialParent = parentStr.getString();
-	});
-	registerKeyword("special_unit_culture", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString unitStr(theStream);
-		specialUnitCulture = unitStr.getString();
-	});
-	registerKeyword("all_your_core_are_belong_to_us", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString synStr(theStream);
-		all_your_core_are_belong_to_us = synStr.getString() == "yes";
-	});
-	registerKeyword("right_to_bear_arms", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString mayenStr(theStream);
-		rightToBEARArms = mayenStr.getString() == "yes";
-	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
@@ -211,8 +235,49 @@ void EU4::CountryDetails::registerHistoryKeys()
 		harmonizedReligions.insert(rel3Str.getString());
 	});
 	registerRegex(R"(\d+.\d+.\d+)", [this](const std::string& theDate, std::istream& theStream) {
-		auto historyItem = commonItems::stringOfItem(theStream).getString();
-		historyLessons.emplace_back(std::pair(date(theDate), historyItem));
+		// Only ever written back out, so kept as the file had it rather than lexed.
+		historyLessons.emplace_back(std::pair(date(theDate), parsing::ItemSkipper::capture(theStream)));
 	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
+
+std::size_t EU4::CountryDetails::heapBytes() const
+{
+	using CK2::MemoryCensus;
+	const auto characterBytes = [](const Character& character) {
+		return MemoryCensus::heapBytes(character.name) + MemoryCensus::heapBytes(character.monarchName) + MemoryCensus::heapBytes(character.dynasty) +
+				 MemoryCensus::heapBytes(character.religion) + MemoryCensus::heapBytes(character.culture) + MemoryCensus::heapBytes(character.originCountry) +
+				 MemoryCensus::heapBytes(character.personalities) + MemoryCensus::heapBytes(character.type);
+	};
+	auto bytes = characterBytes(monarch) + characterBytes(queen) + characterBytes(heir) + advisers.capacity() * sizeof(Character);
+	for (const auto& adviser: advisers)
+		bytes += characterBytes(adviser);
+	for (const auto* text: {&primaryCulture,
+			  &majorityReligion,
+			  &religion,
+			  &graphicalCulture,
+			  &government,
+			  &technologyGroup,
+			  &unitType,
+			  &religiousSchool,
+			  &nationalFocus,
+			  &secondaryReligion,
+			  &preferredReligion,
+			  &colonialParent,
+			  &specialUnitCulture,
+			  &pendingNames})
+		bytes += MemoryCensus::heapBytes(*text);
+	for (const auto* names: {&acceptedCultures,
+			  &reforms,
+			  &cults,
+			  &historicalRivals,
+			  &historicalFriends,
+			  &harmonizedReligions,
+			  &historicalUnits,
+			  &leaderNames,
+			  &shipNames,
+			  &armyNames,
+			  &fleetNames})
+		bytes += MemoryCensus::heapBytes(*names);
+	return bytes + MemoryCensus::heapBytes(historicalIdeaGroups) + MemoryCensus::heapBytes(monarchNames) + MemoryCensus::heapBytes(historyLessons);
+}
@@ -32,8 +32,8 @@ typedef struct Character
 	std::set<std::string> personalities;
 	std::string type;
 	date birthDate;
-	date deathDate = date("1.1.1");
-	date appearDate = date("1.1.1");
+	date deathDate = date(1, 1, 1);
+	date appearDate = date(1, 1, 1);
 } Character;
 
 class CountryDetails: commonItems::parser
@@ -45,6 +45,9 @@ class CountryDetails: commonItems::parser
 
 	void parseHistory(const std::string& filePath);
 	void parseHistory(std::istream& theStream);
+	// Parses the name lists read from the common file into the sets below. Until then they sit in pendingNames.
+	void loadNames();
+	[[nodiscard]] std::size_t heapBytes() const; // for CK2::MemoryCensus
 
 	// These values are open to ease management.
 	// This is a storage container for EU4::Country.
@@ -102,6 +105,7 @@ class CountryDetails: commonItems::parser
 	std::set<std::string> armyNames;
 	std::set<std::string> fleetNames;
 	std::map<std::string, std::pair<int, int>> monarchNames;	 // name (without regnal), pair(regnal, chance)
+	std::string pendingNames;											 // name list blocks as the common file had them, until loadNames()
 	std::vector<std::pair<date, std::string>> historyLessons; // this is used to store history entries for countries we're only transcribing.
 
 	Character monarch;
@@ -111,6 +115,7 @@ class CountryDetails: commonItems::parser
 
   private:
 	void registerKeys();
+	void registerNameKeys();
 	void registerHistoryKeys();
 };
 } // namespace EU4
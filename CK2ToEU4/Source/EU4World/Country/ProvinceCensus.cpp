@@ -0,0 +1,81 @@
+#include "ProvinceCensus.h"
+#include "../Province/EU4Province.h"
+
+void EU4::ProvinceCensus::add(const Province& province)
+{
+	tally(province.getCulture(), province.getReligion(), province.getDev(), 1);
+}
+
+void EU4::ProvinceCensus::remove(const Province& province)
+{
+	tally(province.getCulture(), province.getReligion(), province.getDev(), -1);
+}
+
+void EU4::ProvinceCensus::tally(const std::string& culture, const std::string& religion, const int development, const int sign)
+{
+	if (culture.empty() || religion.empty())
+		blanks += sign;
+	if (!culture.empty())
+		tally(cultures, culture, sign, sign * development);
+	if (!religion.empty())
+		tally(religions, religion, sign, sign * development);
+}
+
+void EU4::ProvinceCensus::tally(Shares& shares, const std::string& name, const int provinces, const int development)
+{
+	auto share = shares.find(name);
+	if (share == shares.end())
+		share = shares.emplace(name, Share{}).first;
+	share->second.provinces += provinces;
+	share->second.development += development;
+	if (!share->second.provinces)
+		shares.erase(share);
+}
+
+void EU4::ProvinceCensus::adjustDevelopment(const Province& province, const int delta)
+{
+	if (!province.getCulture().empty())
+		tally(cultures, province.getCulture(), 0, delta);
+	if (!province.getReligion().empty())
+		tally(religions, province.getReligion(), 0, delta);
+}
+
+void EU4::ProvinceCensus::changeReligion(const Province& province, const std::string& religion)
+{
+	remove(province);
+	tally(province.getCulture(), religion, province.getDev(), 1);
+}
+
+void EU4::ProvinceCensus::merge(const ProvinceCensus& other)
+{
+	for (const auto& [culture, share]: other.cultures)
+		tally(cultures, culture, share.provinces, share.development);
+	for (const auto& [religion, share]: other.religions)
+		tally(religions, religion, share.provinces, share.development);
+	blanks += other.blanks;
+}
+
+void EU4::ProvinceCensus::clear()
+{
+	cultures.clear();
+	religions.clear();
+	blanks = 0;
+}
+
+std::string EU4::ProvinceCensus::mostProvinces(const Shares& shares)
+{
+	const Shares::value_type* most = nullptr;
+	for (const auto& share: shares)
+		if (!most || share.second.provinces > most->second.provinces)
+			most = &share;
+	return most ? most->first : std::string();
+}
+
+std::string EU4::ProvinceCensus::mostDevelopment(const Shares& shares)
+{
+	const Shares::value_type* most = nullptr;
+	for (const auto& share: shares)
+		if (!most || share.second.development > most->second.development)
+			most = &share;
+	return most ? most->first : std::string();
+}
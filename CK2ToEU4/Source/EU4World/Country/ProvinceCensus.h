@@ -0,0 +1,51 @@
+#ifndef EU4_PROVINCE_CENSUS_H
+#define EU4_PROVINCE_CENSUS_H
+#include <functional>
+#include <map>
+#include <string>
+
+namespace EU4
+{
+class Province;
+
+// A country's provinces tallied by culture and by religion: how many, and how much development. The country keeps it
+// current the way it keeps its total development, as provinces are registered, annexed, cleared or changed, so the
+// passes after a majority culture or religion read it instead of walking and hashing the provinces again.
+// Provinces without a culture or religion aren't tallied for it, only counted as blanks.
+class ProvinceCensus
+{
+  public:
+	struct Share
+	{
+		int provinces = 0;
+		int development = 0;
+		bool operator==(const Share&) const = default;
+	};
+	using Shares = std::map<std::string, Share, std::less<>>; // by culture or religion, in name order
+
+	void add(const Province& province);
+	void remove(const Province& province);
+	void adjustDevelopment(const Province& province, int delta);
+	void changeReligion(const Province& province, const std::string& religion);
+	void merge(const ProvinceCensus& other);
+	void clear();
+
+	[[nodiscard]] const auto& getCultures() const { return cultures; }
+	[[nodiscard]] const auto& getReligions() const { return religions; }
+	[[nodiscard]] auto getBlanks() const { return blanks; } // provinces missing a culture, a religion or both
+
+	// The share with the most provinces or development, ties going to the first name. Empty if nothing's tallied.
+	[[nodiscard]] static std::string mostProvinces(const Shares& shares);
+	[[nodiscard]] static std::string mostDevelopment(const Shares& shares);
+
+  private:
+	void tally(const std::string& culture, const std::string& religion, int development, int sign);
+	static void tally(Shares& shares, const std::string& name, int provinces, int development);
+
+	Shares cultures;
+	Shares religions;
+	int blanks = 0;
+};
+} // namespace EU4
+
+#endif // EU4_PROVINCE_CENSUS_H
@@ -0,0 +1,29 @@
+#include "Tag.h"
+#include <stdexcept>
+
+EU4::Tag::Tag(const std::string_view text)
+{
+	if (!fits(text))
+		throw std::invalid_argument("Not a country tag: " + std::string(text));
+	packed = pack(text);
+}
+
+std::string EU4::Tag::str() const
+{
+	std::string text;
+	for (auto shift = 24; shift >= 0 && (packed >> shift & 0xFF); shift -= 8)
+		text += static_cast<char>(packed >> shift & 0xFF);
+	return text;
+}
+
+std::uint32_t EU4::Tag::pack(const std::string_view text)
+{
+	std::uint32_t packed = 0;
+	auto shift = 24;
+	for (const auto character: text)
+	{
+		packed |= static_cast<std::uint32_t>(static_cast<unsigned char>(character)) << shift;
+		shift -= 8;
+	}
+	return packed;
+}
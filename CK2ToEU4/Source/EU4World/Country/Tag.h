@@ -0,0 +1,46 @@
+#ifndef EU4_TAG_H
+#define EU4_TAG_H
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace EU4
+{
+// A country tag packed into 32 bits, first character in the high byte. Tags are three characters (four leaves room
+// for the odd mod), so a set of cores or claims is a set of integers and comparing two tags is one compare. The
+// packing keeps the order of the spelling, so anything iterated in tag order prints the same as before.
+class Tag
+{
+  public:
+	Tag() = default;
+	explicit Tag(std::string_view text); // throws std::invalid_argument past four characters
+
+	[[nodiscard]] std::string str() const;
+	[[nodiscard]] bool empty() const { return packed == 0; }
+	operator std::string() const { return str(); }
+
+	[[nodiscard]] static bool fits(std::string_view text) { return text.size() <= 4; }
+
+	friend bool operator==(const Tag& lhs, const Tag& rhs) = default;
+	friend std::strong_ordering operator<=>(const Tag& lhs, const Tag& rhs) = default;
+	friend bool operator==(const Tag& lhs, const std::string_view rhs) { return fits(rhs) && lhs.packed == pack(rhs); }
+	friend std::ostream& operator<<(std::ostream& output, const Tag& tag) { return output << tag.str(); }
+
+  private:
+	friend struct std::hash<Tag>;
+
+	[[nodiscard]] static std::uint32_t pack(std::string_view text);
+
+	std::uint32_t packed = 0;
+};
+} // namespace EU4
+
+template <> struct std::hash<EU4::Tag>
+{
+	std::size_t operator()(const EU4::Tag& tag) const noexcept { return std::hash<std::uint32_t>()(tag.packed); }
+};
+
+#endif // EU4_TAG_H
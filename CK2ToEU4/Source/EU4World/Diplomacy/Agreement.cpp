@@ -2,22 +2,37 @@
 #include "CommonRegexes.h"
 #include "ParserHelpers.h"
 
-EU4::Agreement::Agreement(std::istream& theStream, std::string theType): type(std::move(theType))
+EU4::Agreement::Agreement(std::istream& theStream, std::string theType): type(std::move(theType)), kind(kindOf(type))
 {
 	registerKeys();
 	parseStream(theStream);
 	clearRegisteredKeywords();
 }
 
+EU4::Agreement::KIND EU4::Agreement::kindOf(const std::string_view theType)
+{
+	if (theType == "alliance")
+		return KIND::ALLIANCE;
+	if (theType == "guarantee")
+		return KIND::GUARANTEE;
+	if (theType == "union")
+		return KIND::UNION;
+	if (theType == "vassal")
+		return KIND::VASSAL;
+	if (theType == "dependency")
+		return KIND::DEPENDENCY;
+	return KIND::OTHER;
+}
+
 void EU4::Agreement::registerKeys()
 {
 	registerKeyword("first", [this](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString firstStr(theStream);
-		first = firstStr.getString();
+		first = Tag(firstStr.getString());
 	});
 	registerKeyword("second", [this](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString secondStr(theStream);
-		second = secondStr.getString();
+		second = Tag(secondStr.getString());
 	});
 	registerKeyword("subject_type", [this](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString typeStr(theStream);
@@ -37,7 +52,7 @@ void EU4::Agreement::registerKeys()
 void EU4::Agreement::updateTags(const std::string& oldTag, const std::string& newTag)
 {
 	if (first == oldTag)
-		first = newTag;
+		first = Tag(newTag);
 	if (second == oldTag)
-		second = newTag;
+		second = Tag(newTag);
 }
@@ -1,30 +1,47 @@
 #ifndef AGREEMENT_H
 #define AGREEMENT_H
 
+#include "../Country/Tag.h"
 #include "Date.h"
 #include "Parser.h"
 #include <ostream>
+#include <string_view>
 
 namespace EU4
 {
 class Agreement: commonItems::parser
 {
   public:
+	// The agreement types we write out. Anything else is OTHER and gets skipped with a warning.
+	enum class KIND
+	{
+		ALLIANCE,
+		GUARANTEE,
+		UNION,
+		VASSAL,
+		DEPENDENCY,
+		OTHER
+	};
+
 	Agreement() = default;
 	Agreement(std::istream& theStream, std::string theType);
-	Agreement(std::string _first, std::string _second, std::string _type, const date& _start_date):
-		 type(std::move(_type)), first(std::move(_first)), second(std::move(_second)), startDate(_start_date)
+	Agreement(const std::string& _first, const std::string& _second, std::string _type, const date& _start_date):
+		 type(std::move(_type)), kind(kindOf(type)), first(_first), second(_second), startDate(_start_date)
 	{
 	}
-	Agreement(std::string _first, std::string _second, std::string _type, std::string subject_type, const date& _start_date):
-		 type(std::move(_type)), first(std::move(_first)), second(std::move(_second)), subjectType(std::move(subject_type)), startDate(_start_date)
+	Agreement(const std::string& _first, const std::string& _second, std::string _type, std::string subject_type, const date& _start_date):
+		 type(std::move(_type)), kind(kindOf(type)), first(_first), second(_second), subjectType(std::move(subject_type)), startDate(_start_date)
 	{
 	}
+
+	[[nodiscard]] static KIND kindOf(std::string_view theType);
+
 	void updateTags(const std::string& oldTag, const std::string& newTag);
 
 	[[nodiscard]] const auto& getFirst() const { return first; }
 	[[nodiscard]] const auto& getSecond() const { return second; }
 	[[nodiscard]] const auto& getType() const { return type; }
+	[[nodiscard]] auto getKind() const { return kind; }
 
 	friend std::ostream& operator<<(std::ostream& output, const Agreement& agreement);
 
@@ -32,8 +49,9 @@ class Agreement: commonItems::parser
 	void registerKeys();
 
 	std::string type;
-	std::string first;
-	std::string second;
+	KIND kind = KIND::OTHER; // type, sorted once
+	Tag first;
+	Tag second;
 	std::string subjectType;
 	date startDate;
 	date endDate;
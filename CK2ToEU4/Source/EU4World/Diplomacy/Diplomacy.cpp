@@ -4,33 +4,46 @@
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <algorithm>
 
-EU4::Diplomacy::Diplomacy()
+EU4::Diplomacy::Diplomacy(const std::vector<Agreement>& easternTributaries)
+{
+	for (const auto& tributary: easternTributaries)
+		registerAgreement(std::make_shared<Agreement>(tributary));
+}
+
+std::vector<EU4::Agreement> EU4::Diplomacy::loadEasternTributaries()
 {
 	Log(LogLevel::Info) << "-> Loading Eastern Diplomacy";
-	registerKeys();
-	parseFile("configurables/chinese_tributaries.txt");
-	clearRegisteredKeywords();
-	Log(LogLevel::Info) << ">> " << agreements.size() << " tributaries loaded.";
+	Diplomacy eastern;
+	eastern.registerKeys();
+	eastern.parseFile("configurables/chinese_tributaries.txt");
+	eastern.clearRegisteredKeywords();
+	Log(LogLevel::Info) << ">> " << eastern.agreements.size() << " tributaries loaded.";
+
+	std::vector<Agreement> tributaries;
+	tributaries.reserve(eastern.agreements.size());
+	for (const auto& agreement: eastern.agreements)
+		tributaries.emplace_back(*agreement);
+	return tributaries;
 }
 
 void EU4::Diplomacy::registerKeys()
 {
 	registerKeyword("dependency", [this](const std::string& type, std::istream& theStream) {
-		auto newAgreement = std::make_shared<Agreement>(theStream, type);
-		agreements.emplace_back(newAgreement);
+		registerAgreement(std::make_shared<Agreement>(theStream, type));
 	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-void EU4::Diplomacy::importAgreements(const std::map<std::string, std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate)
+void EU4::Diplomacy::importAgreements(const parsing::NameMap<std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate)
 {
 	Log(LogLevel::Info) << "-> Explaining Diplomacy Like It's Five";
 	importVassals(countries, conversionDate);
 	importTributaries(countries, diplomacy, conversionDate);
 }
 
-void EU4::Diplomacy::importVassals(const std::map<std::string, std::shared_ptr<Country>>& countries, const date& conversionDate)
+void EU4::Diplomacy::importVassals(const parsing::NameMap<std::shared_ptr<Country>>& countries, const date& conversionDate)
 {
 	// Vassalages are our own creation os we're pinging our countries alone.
 	for (const auto& country: countries)
@@ -45,119 +58,134 @@ void EU4::Diplomacy::importVassals(const std::map<std::string, std::shared_ptr<C
 			if (targetTag.second->getProvinces().empty())
 				continue;
 
-			auto newAgreement = std::make_shared<Agreement>(country.first, targetTag.first, "vassal", conversionDate);
-			agreements.push_back(newAgreement);
+			registerAgreement(std::make_shared<Agreement>(country.first, targetTag.first, "vassal", conversionDate));
 		}
 	}
 }
 
-void EU4::Diplomacy::importTributaries(const std::map<std::string, std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate)
+void EU4::Diplomacy::importTributaries(const parsing::NameMap<std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate)
 {
-
-	// Tributaries are a personal matter and we need to map it to country holders.
-	// First make reference maps of all relevant tags, their holders and tributaries.
-
-	std::map<int, std::string> holderTags;						// holderID, Tag
-	std::map<int, std::map<int, bool>> holderTributaries; // holder ID, tributaries/vassals (not necessarily holders that survived).
-
+	// Tributaries are a personal matter and we need to map it to country holders. Personal unions and vassals are
+	// left out, on either side of a pairing.
+	std::map<int, std::string> holderTags; // holderID, Tag
 	for (const auto& country: countries)
 	{
 		if (country.second->getTitle().first.empty())
 			continue;
-		if (!country.second->getTitle().second->getHolder().first)
+		const auto holderID = country.second->getTitle().second->getHolder().first;
+		if (!holderID)
 			continue;
-		// Let's skip personal unions and vassals.
 		if (isCountryVassal(country.first) || isCountryJunior(country.first))
 			continue;
-
-		const auto& holder = country.second->getTitle().second->getHolder();
-		holderTags.insert(std::pair(holder.first, country.first));
-
-		const auto& allRelations = diplomacy.getDiplomacy();
-		const auto& relationsItr = allRelations.find(holder.first);
-		if (relationsItr == allRelations.end())
-			continue; // No relations.
-		const auto& holderRelations = relationsItr->second;
-		for (const auto& relation: holderRelations.getRelations())
-		{
-			if (relation.isFirstOverlord()) // CK2 tributaries are messy. Dual pairings are not guaranteed.
-			{
-				holderTributaries[holder.first].insert(std::pair(relation.getSecond(), relation.getTributaryType() == "autonomous_tributary"));
-			}
-			else if (relation.isSecondOverlord())
-			{
-				holderTributaries[relation.getSecond()].insert(std::pair(relation.getFirst(), relation.getTributaryType() == "autonomous_tributary"));
-			}
-		}
+		holderTags.emplace(holderID, country.first);
 	}
 
-	// Loading is complete, now let's match people with countries.
-
-	for (const auto& holderItr: holderTributaries)
+	// Now match people with countries. Pairings come ordered by overlord, so each overlord is looked up once.
+	const auto& tributaries = diplomacy.getTributaries();
+	for (auto link = tributaries.begin(); link != tributaries.end();)
 	{
-		const auto& first = holderTags[holderItr.first]; // overlord
-		for (const auto& subHolderItr: holderItr.second)
+		const auto overlord = link->overlord;
+		const auto overlordItr = holderTags.find(overlord);
+		for (; link != tributaries.end() && link->overlord == overlord; ++link)
 		{
+			if (overlordItr == holderTags.end())
+				continue;
 			// Does this fellow have a country?
-			if (!holderTags.count(subHolderItr.first))
+			const auto tributaryItr = holderTags.find(link->tributary);
+			if (tributaryItr == holderTags.end())
 				continue;
-			// He does! Excellent!
-			const auto& second = holderTags[subHolderItr.first];
-
-			// Make a tributary/vassal agreement
-			if (subHolderItr.second)
-			{
-				auto newAgreement = std::make_shared<Agreement>(first, second, "vassal", conversionDate);
-				agreements.push_back(newAgreement);
-			}
+
+			if (link->autonomous)
+				registerAgreement(std::make_shared<Agreement>(overlordItr->second, tributaryItr->second, "vassal", conversionDate));
 			else
-			{
-				auto newAgreement = std::make_shared<Agreement>(first, second, "dependency", "tributary_state", conversionDate);
-				agreements.push_back(newAgreement);
-			}
+				registerAgreement(std::make_shared<Agreement>(overlordItr->second, tributaryItr->second, "dependency", "tributary_state", conversionDate));
 		}
 	}
 }
 
-void EU4::Diplomacy::updateTagsInAgreements(const std::string& oldTag, const std::string& newTag)
+void EU4::Diplomacy::registerAgreement(std::shared_ptr<Agreement> agreement)
 {
-	for (const auto& agreement: agreements)
-		agreement->updateTags(oldTag, newTag);
+	indexAgreement(agreement);
+	agreements.push_back(std::move(agreement));
 }
 
-void EU4::Diplomacy::deleteAgreementsWithTag(const std::string& deadTag)
+void EU4::Diplomacy::indexAgreement(const std::shared_ptr<Agreement>& agreement)
 {
-	std::vector<std::shared_ptr<Agreement>> newAgreements;
+	agreementsByTag[agreement->getFirst()].push_back(agreement);
+	if (agreement->getSecond() != agreement->getFirst())
+		agreementsByTag[agreement->getSecond()].push_back(agreement);
+}
+
+void EU4::Diplomacy::reindexAgreements()
+{
+	agreementsByTag.clear();
 	for (const auto& agreement: agreements)
+		indexAgreement(agreement);
+}
+
+void EU4::Diplomacy::updateTagsInAgreements(const std::string& oldTag, const std::string& newTag)
+{
+	if (!Tag::fits(oldTag))
+		return;
+	const auto oldItr = agreementsByTag.find(Tag(oldTag));
+	if (oldItr == agreementsByTag.end())
+		return;
+	const auto renamedAgreements = std::move(oldItr->second);
+	agreementsByTag.erase(oldItr);
+
+	// Agreements between the two tags are already filed under the new one.
+	auto& newTagAgreements = agreementsByTag[Tag(newTag)];
+	for (const auto& agreement: renamedAgreements)
 	{
-		if (agreement->getFirst() == deadTag || agreement->getSecond() == deadTag)
-			continue;
-		newAgreements.emplace_back(agreement);
+		agreement->updateTags(oldTag, newTag);
+		if (std::ranges::find(newTagAgreements, agreement) == newTagAgreements.end())
+			newTagAgreements.push_back(agreement);
 	}
-	agreements.swap(newAgreements);
+}
+
+void EU4::Diplomacy::deleteAgreementsWithTag(const std::string& deadTag)
+{
+	if (!Tag::fits(deadTag))
+		return;
+	const auto deadItr = agreementsByTag.find(Tag(deadTag));
+	if (deadItr == agreementsByTag.end())
+		return;
+	const auto deadAgreements = std::move(deadItr->second);
+	agreementsByTag.erase(deadItr);
+
+	// Unfile them from their other parties, then drop them from the list in one pass.
+	const std::set<std::shared_ptr<Agreement>> doomed(deadAgreements.begin(), deadAgreements.end());
+	for (const auto& agreement: deadAgreements)
+		for (const auto& partyTag: {agreement->getFirst(), agreement->getSecond()})
+			if (const auto partyItr = agreementsByTag.find(partyTag); partyItr != agreementsByTag.end())
+				std::erase(partyItr->second, agreement);
+	std::erase_if(agreements, [&doomed](const auto& agreement) { return doomed.contains(agreement); });
+}
+
+bool EU4::Diplomacy::isCountrySubject(const std::string& tag, const Agreement::KIND kind) const
+{
+	if (!Tag::fits(tag))
+		return false;
+	const auto subject = Tag(tag);
+	const auto tagItr = agreementsByTag.find(subject);
+	if (tagItr == agreementsByTag.end())
+		return false;
+	return std::ranges::any_of(tagItr->second, [&subject, kind](const auto& agreement) {
+		return agreement->getSecond() == subject && agreement->getKind() == kind;
+	});
 }
 
 bool EU4::Diplomacy::isCountryVassal(const std::string& tag) const
 {
-	for (const auto& agreement: agreements)
-	{
-		if (agreement->getSecond() == tag && agreement->getType() == "vassal")
-			return true;
-	}
-	return false;
+	return isCountrySubject(tag, Agreement::KIND::VASSAL);
 }
 
 bool EU4::Diplomacy::isCountryJunior(const std::string& tag) const
 {
-	for (const auto& agreement: agreements)
-	{
-		if (agreement->getSecond() == tag && agreement->getType() == "union")
-			return true;
-	}
-	return false;
+	return isCountrySubject(tag, Agreement::KIND::UNION);
 }
 
-void EU4::Diplomacy::filterDeadRelationships(const std::map<std::string, std::shared_ptr<Country>>& countries, const std::set<std::string>& chinaTags)
+void EU4::Diplomacy::filterDeadRelationships(const parsing::NameMap<std::shared_ptr<Country>>& countries, const std::set<std::string>& chinaTags)
 {
 	std::vector<std::shared_ptr<Agreement>> newAgreements;
 	std::set<std::string> landlessCountries;
@@ -174,4 +202,5 @@ void EU4::Diplomacy::filterDeadRelationships(const std::map<std::string, std::sh
 			newAgreements.emplace_back(agreement);
 
 	agreements.swap(newAgreements);
+	reindexAgreements();
 }
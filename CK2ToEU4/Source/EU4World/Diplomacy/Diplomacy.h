@@ -2,10 +2,12 @@
 #define DIPLOMACY_H
 
 #include "../../CK2World/Relations/AllRelations.h"
+#include "../../Parsing/NameMap.h"
 #include "Agreement.h"
 #include "Parser.h"
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 class Configuration;
@@ -15,15 +17,19 @@ class Country;
 class Diplomacy: commonItems::parser
 {
   public:
-	Diplomacy();
+	Diplomacy() = default;
+	// Starts off with copies of the eastern tributaries, which every conversion of a setup shares.
+	explicit Diplomacy(const std::vector<Agreement>& easternTributaries);
 
-	void addAgreement(std::shared_ptr<Agreement> agreement) { agreements.push_back(std::move(agreement)); }
-	void importAgreements(const std::map<std::string, std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate);
-	void importVassals(const std::map<std::string, std::shared_ptr<Country>>& countries, const date& conversionDate);
-	void importTributaries(const std::map<std::string, std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate);
+	[[nodiscard]] static std::vector<Agreement> loadEasternTributaries();
+
+	void addAgreement(std::shared_ptr<Agreement> agreement) { registerAgreement(std::move(agreement)); }
+	void importAgreements(const parsing::NameMap<std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate);
+	void importVassals(const parsing::NameMap<std::shared_ptr<Country>>& countries, const date& conversionDate);
+	void importTributaries(const parsing::NameMap<std::shared_ptr<Country>>& countries, const CK2::Diplomacy& diplomacy, date conversionDate);
 	void updateTagsInAgreements(const std::string& oldTag, const std::string& newTag);
 	void deleteAgreementsWithTag(const std::string& deadTag);
-	void filterDeadRelationships(const std::map<std::string, std::shared_ptr<Country>>& countries, const std::set<std::string>& chinaTags);
+	void filterDeadRelationships(const parsing::NameMap<std::shared_ptr<Country>>& countries, const std::set<std::string>& chinaTags);
 
 	[[nodiscard]] const auto& getAgreements() const { return agreements; }
 	[[nodiscard]] bool isCountryVassal(const std::string& tag) const;
@@ -31,8 +37,15 @@ class Diplomacy: commonItems::parser
 
   private:
 	void registerKeys();
+	void registerAgreement(std::shared_ptr<Agreement> agreement);
+	void indexAgreement(const std::shared_ptr<Agreement>& agreement);
+	void reindexAgreements();
+	[[nodiscard]] bool isCountrySubject(const std::string& tag, Agreement::KIND kind) const;
 
 	std::vector<std::shared_ptr<Agreement>> agreements;
+	// Every agreement under both of its tags, so subject lookups, renames and deletions only touch the country's own
+	// agreements rather than the whole list.
+	std::unordered_map<Tag, std::vector<std::shared_ptr<Agreement>>> agreementsByTag;
 };
 } // namespace EU4
 
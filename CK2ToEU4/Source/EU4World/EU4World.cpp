@@ -1,118 +1,138 @@
 #include "EU4World.h"
 #include "../CK2World/Characters/Character.h"
 #include "../CK2World/Dynasties/Dynasty.h"
+#include "../CK2World/Metrics.h"
 #include "../CK2World/Offmaps/Offmap.h"
 #include "../CK2World/Provinces/Barony.h"
+#include "../CK2World/TaskGraph.h"
 #include "../CK2World/Titles/Title.h"
 #include "../Configuration/Configuration.h"
 #include "CommonFunctions.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include "VanillaCache.h"
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
 #include <filesystem>
 #include <fstream>
 namespace fs = std::filesystem;
 
-EU4::World::World(const CK2::World& sourceWorld, const Configuration& theConfiguration, const commonItems::ConverterVersion& converterVersion)
+namespace
 {
-	Log(LogLevel::Info) << "*** Hello EU4, let's get painting. ***";
-	// Do we have an override mod?
-	std::string overrideModPath;
-	for (const auto& mod: sourceWorld.getMods())
-		if (mod.name == "CleanSlate")
-		{
-			overrideModPath = "CleanSlate";
-			cleanslate = true;
-		}
-		else if (mod.name == "Tianxia: Silk Road Expansion")
-		{
-			overrideModPath = "Tianxia";
-			tianxia = true;
-		}
-
-	cultureMapper.initCultureMapper(overrideModPath);
-	governmentsMapper.initGovernmentsMapper(overrideModPath);
-	rulerPersonalitiesMapper.initRulerPersonalitiesMapper(overrideModPath);
-	religionMapper.initReligionMapper(overrideModPath);
-	titleTagMapper.initTitleTagMapper(overrideModPath);
+// History and common files are a few hundred bytes each; a slice this size already outweighs the cost of its thread.
+constexpr std::size_t historyFilesPerSlice = 32;
 
-	// Scraping localizations from CK2 so we may know proper names for our countries.
-	localizationMapper.scrapeLocalizations(theConfiguration, sourceWorld.getMods());
+const std::string countriesCachePath = "snapshots/vanilla_countries.cache";
+const std::string provincesCachePath = "snapshots/vanilla_provinces.cache";
 
-	// Scrape Primary Tags for nationalities
-	primaryTagMapper.loadPrimaryTags(theConfiguration);
-	Log(LogLevel::Progress) << "50 %";
-
-	// Ditto for colors - these only apply on non-eu4 countries.
-	scrapeColors(theConfiguration, sourceWorld);
-	Log(LogLevel::Progress) << "51 %";
-
-	// This is our region mapper for eu4 regions, areas and superRegions. It's a pointer because we need
-	// to embed it into every cultureMapper individual mapping. It works faster that way.
-	regionMapper = std::make_shared<mappers::RegionMapper>();
-	regionMapper->loadRegions(theConfiguration);
-	Log(LogLevel::Progress) << "52 %";
+std::string vanillaImageKey(const std::string& what, const std::string& eu4Path, const bool invasion)
+{
+	return what + "|" + eu4Path + "|" + (invasion ? "sunset" : "vanilla");
+}
 
-	// And this is the cultureMapper. It's of vital importance.
-	cultureMapper.loadRegionMapper(regionMapper);
-	Log(LogLevel::Progress) << "53 %";
+void saveVanillaCache(const std::function<void()>& save)
+{
+	// The cache is only ever a shortcut, failing to write it doesn't stop the conversion.
+	try
+	{
+		save();
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not write the vanilla cache: " << e.what();
+	}
+}
+} // namespace
+
+EU4::World::World(const CK2::World& sourceWorld,
+	 const Configuration& theConfiguration,
+	 const commonItems::ConverterVersion& converterVersion,
+	 CK2::PhaseTimings& timings,
+	 StaticData& staticData):
+	 staticMappers(loadMappers(sourceWorld, theConfiguration, timings, staticData)),
+	 regionMapper(staticMappers->regionMapper), colorScraper(staticMappers->colorScraper), provinceMapper(staticMappers->provinceMapper),
+	 titleTagMapper(staticMappers->titleTagRules), religionMapper(staticMappers->religionMapper), cultureMapper(staticMappers->cultureMapper),
+	 governmentsMapper(staticMappers->governmentsMapper), localizationMapper(staticMappers->localizationMapper),
+	 rulerPersonalitiesMapper(staticMappers->rulerPersonalitiesMapper), primaryTagMapper(staticMappers->primaryTagMapper),
+	 devWeightsMapper(staticMappers->devWeightsMapper), africanPassesMapper(staticMappers->africanPassesMapper),
+	 diplomacy(staticMappers->easternTributaries)
+{
+	cleanslate = staticMappers->overrideModPath == "CleanSlate";
+	tianxia = staticMappers->overrideModPath == "Tianxia";
 
-	// This is a valid province scraper. It looks at eu4 map data and notes which eu4 provinces are in fact valid.
-	// ... It's not used at all.
-	provinceMapper = std::make_unique<mappers::ProvinceMapper>(sourceWorld.getMods(), overrideModPath);
-	provinceMapper->determineValidProvinces(theConfiguration);
-	Log(LogLevel::Progress) << "54 %";
+	timings.begin("Importing Vanilla Countries");
+	// Unless the install changed since the last run, the vanilla imports below come straight from the cache.
+	std::string vanillaCacheKey;
+	if (theConfiguration.getSnapshot() != Configuration::SNAPSHOT::DISABLED)
+		vanillaCacheKey = VanillaCache::makeKey(converterVersion.getVersion(), theConfiguration.getEU4Path(), sourceWorld.isInvasion());
 
 	// We start conversion by importing vanilla eu4 countries, history and common sections included.
 	// We'll overwrite some of them with ck2 imports.
-	importVanillaCountries(theConfiguration.getEU4Path(), sourceWorld.isInvasion());
+	shareVanillaCountries(theConfiguration.getEU4Path(), sourceWorld.isInvasion(), vanillaCacheKey, staticData);
 	Log(LogLevel::Progress) << "55 %";
+	timings.count("countries", countries.size());
 
+	timings.begin("Importing CK2 Countries");
 	// Which happens now. Translating incoming titles into EU4 tags, with new tags being added to our countries.
 	importCK2Countries(theConfiguration.getStartDateOption(), sourceWorld);
 	Log(LogLevel::Progress) << "56 %";
+	timings.count("countries", countries.size());
 
+	timings.begin("Importing Vanilla Provinces");
 	// Now we can deal with provinces since we know to whom to assign them. We first import vanilla province data.
 	// Some of it will be overwritten, but not all.
-	importVanillaProvinces(theConfiguration.getEU4Path(), sourceWorld.isInvasion());
+	shareVanillaProvinces(theConfiguration.getEU4Path(), sourceWorld.isInvasion(), vanillaCacheKey, staticData);
 	Log(LogLevel::Progress) << "57 %";
+	timings.count("provinces", provinces.size());
 
-	// We can link provinces to regionMapper's bindings, though this is not used at the moment.
-	regionMapper->linkProvinces(provinces);
+	timings.begin("Linking Regions");
+	// Every province an area names has to exist. The region mapper is shared, so nothing is linked into it.
+	regionMapper->verifyProvinces(provinces);
 	Log(LogLevel::Progress) << "58 %";
 
+	timings.begin("Importing CK2 Provinces");
 	// Next we import ck2 provinces and translate them ontop a significant part of all imported provinces.
 	importCK2Provinces(sourceWorld);
 	Log(LogLevel::Progress) << "59 %";
+	takeCensus(timings);
 
+	timings.begin("Altering Development");
 	// With Ck2 provinces linked to those eu4 provinces they affect, we can adjust eu4 province dev values.
 	if (theConfiguration.getDevelopment() == Configuration::DEVELOPMENT::IMPORT)
 		alterProvinceDevelopment();
 	Log(LogLevel::Progress) << "60 %";
 
+	timings.begin("Linking Provinces To Countries");
 	// We then link them to their respective countries. Those countries that end up with 0 provinces are defacto dead.
 	linkProvincesToCountries();
 	Log(LogLevel::Progress) << "61 %";
 
+	timings.begin("Verifying Capitals");
 	// Country capitals are fuzzy, and need checking if we assigned them to some other country during mapping.
 	verifyCapitals();
 	Log(LogLevel::Progress) << "62 %";
 
+	timings.begin("Verifying Religions and Cultures");
 	// This step is important. CK2 data is sketchy and not every character or province has culture/religion data.
 	// For those, we look at vanilla provinces and override missing bits with vanilla setup. Yeah, a bit more sunni in
 	// hordeland, but it's fine.
-	verifyReligionsAndCultures();
+	verifyReligionsAndCultures(theConfiguration);
 	Log(LogLevel::Progress) << "63 %";
 
+	timings.begin("Importing Advisers");
 	// With all provinces and rulers religion/culture set, only now can we import advisers, which also need religion/culture set.
 	// Those advisers coming without such data use the monarch's religion/culture.
 	importAdvisers(theConfiguration.getStartDateOption(), sourceWorld.getConversionDate());
 	Log(LogLevel::Progress) << "64 %";
 
+	timings.begin("Resolving Personal Unions");
 	// Rulers with multiple crowns either get PU agreements, or just annex the other crowns.
 	resolvePersonalUnions();
 	Log(LogLevel::Progress) << "65 %";
 
+	timings.begin("Distributing HRE Subtitles");
 	// We're onto the finesse part of conversion now. HRE was shattered in CK2 World and now we're assigning electorates, free
 	// cities, and such.
 	distributeHRESubtitles(theConfiguration);
@@ -124,10 +144,12 @@ EU4::World::World(const CK2::World& sourceWorld, const Configuration& theConfigu
 	}
 	Log(LogLevel::Progress) << "66 %";
 
+	timings.begin("Assigning Reforms");
 	// With all religious/cultural matters taken care of, we can now set reforms
 	assignAllCountryReforms();
 	Log(LogLevel::Progress) << "67 %";
 
+	timings.begin("Importing Agreements");
 	// Vassalages and tributaries were also set in ck2 world but we have to transcribe those into EU4 agreements.
 	auto actualConversionDate = sourceWorld.getConversionDate();
 	if (theConfiguration.getStartDateOption() == Configuration::STARTDATE::EU)
@@ -135,6 +157,7 @@ EU4::World::World(const CK2::World& sourceWorld, const Configuration& theConfigu
 	diplomacy.importAgreements(countries, sourceWorld.getDiplomacy(), actualConversionDate);
 	Log(LogLevel::Progress) << "68 %";
 
+	timings.begin("Distributing Claims and Dead Cores");
 	// We're distributing permanent claims according to dejure distribution.
 	distributeClaims(theConfiguration);
 
@@ -143,41 +166,60 @@ EU4::World::World(const CK2::World& sourceWorld, const Configuration& theConfigu
 
 	Log(LogLevel::Progress) << "69 %";
 
+	timings.begin("Distributing Forts");
 	// Now for the final tweaks.
 	distributeForts();
 	Log(LogLevel::Progress) << "70 %";
 
-	// Tengri
-	fixTengri();
-	Log(LogLevel::Progress) << "71 %";
-
-	// China
-	adjustChina(sourceWorld, theConfiguration.getStartDateOption());
-	Log(LogLevel::Progress) << "72 %";
-
-	// Filter dead relationships
-	diplomacy.filterDeadRelationships(countries, titleTagMapper.getAllChinas());
-
-	// Check for duplicate country names and rename accordingly
-	fixDuplicateNames();
-
-	// Siberia
-	siberianQuestion(theConfiguration);
-	Log(LogLevel::Progress) << "73 %";
-
-	// African Passes
-	africaQuestion();
-	Log(LogLevel::Progress) << "74 %";
-
-	// Indian buddhisms
-	indianQuestion();
-	Log(LogLevel::Progress) << "75 %";
-
-	// And finally, the Dump.
-	Log(LogLevel::Info) << "---> The Dump <---";
+	// And finally, the Dump. The last transforms run while the mod template is laid out on disk.
 	modFile.outname = theConfiguration.getOutputName();
 	modFile.version = converterVersion.getMaxTarget();
-	output(converterVersion, theConfiguration, sourceWorld);
+	const auto lastTransforms = [this, &theConfiguration, &sourceWorld, &timings] {
+		timings.begin("Fixing Tengri");
+		// Tengri
+		fixTengri();
+		Log(LogLevel::Progress) << "71 %";
+
+		timings.begin("Adjusting China");
+		// China
+		adjustChina(sourceWorld, theConfiguration.getStartDateOption());
+		Log(LogLevel::Progress) << "72 %";
+
+		timings.begin("Filtering Dead Relationships");
+		// Filter dead relationships
+		diplomacy.filterDeadRelationships(countries, titleTagMapper.getAllChinas());
+
+		timings.begin("Fixing Duplicate Names");
+		// Check for duplicate country names and rename accordingly
+		fixDuplicateNames();
+
+		timings.begin("Siberian Question");
+		// Siberia
+		siberianQuestion(theConfiguration);
+		Log(LogLevel::Progress) << "73 %";
+
+		timings.begin("African Question");
+		// African Passes
+		africaQuestion();
+		Log(LogLevel::Progress) << "74 %";
+
+		timings.begin("Indian Question");
+		// Indian buddhisms
+		indianQuestion();
+		Log(LogLevel::Progress) << "75 %";
+
+		// A low share of cached matches means the culture map's rules could use regrouping.
+		Log(LogLevel::Info) << "<> Culture matches: " << cultureMapper.getCachedMatches() << " remembered, " << cultureMapper.getResolvedMatches() << " resolved.";
+
+		takeCensus(timings);
+		timings.begin("Writing Mod");
+	timings.finish();
+	};
+	// A run profiling up to some phase (see CK2::PhaseTimings::window) writes nothing, wherever it stops.
+	if (timings.stops())
+		lastTransforms();
+	else
+		output(converterVersion, theConfiguration, sourceWorld, lastTransforms);
 	Log(LogLevel::Info) << "*** Farewell EU4, granting you independence. ***";
 }
 
@@ -213,10 +255,10 @@ void EU4::World::indianQuestion()
 				country.second->correctRoyaltyToBuddhism();
 				++countryCounter;
 			}
-			for (const auto& province: country.second->getProvinces())
-				if (province.second->getReligion() == "vajrayana")
+			for (const auto provinceID: provinceOwners.provincesOf(country.first))
+				if (const auto& province = provinces.find(provinceID)->second; province->getReligion() == "vajrayana")
 				{
-					province.second->setReligion("buddhism");
+					province->setReligion("buddhism");
 					++provinceCounter;
 				}
 		}
@@ -225,44 +267,13 @@ void EU4::World::indianQuestion()
 }
 
 
-void EU4::World::scrapeColors(const Configuration& theConfiguration, const CK2::World& sourceWorld)
-{
-	Log(LogLevel::Info) << "-> Soaking Up Colors";
-	auto fileNames = commonItems::GetAllFilesInFolder(theConfiguration.getCK2Path() + "/common/landed_titles/");
-	for (const auto& file: fileNames)
-	{
-		if (file.find(".txt") == std::string::npos)
-			continue;
-		colorScraper.scrapeColors(theConfiguration.getCK2Path() + "/common/landed_titles/" + file);
-	}
-	for (const auto& mod: sourceWorld.getMods())
-	{
-		fileNames = commonItems::GetAllFilesInFolder(mod.path + "/common/landed_titles/");
-		if (!fileNames.empty())
-			Log(LogLevel::Info) << "\t>> Found some colors in [" << mod.name << "]: " << mod.path;
-		for (const auto& file: fileNames)
-		{
-			if (file.find(".txt") == std::string::npos)
-				continue;
-			colorScraper.scrapeColors(mod.path + "/common/landed_titles/" + file);
-		}
-	}
-	Log(LogLevel::Info) << ">> " << colorScraper.getColors().size() << " colors soaked up.";
-}
-
 void EU4::World::distributeDeadCores()
 {
 	Log(LogLevel::Info) << "-- Distributing Dead Cores";
 	auto counter = 0;
 
-	// Make a register of dead country tags we are allowed to use
-	std::set<std::string> deadTags;
-
-	for (const auto& country: countries)
-		if (country.second->getProvinces().empty())
-			deadTags.insert(country.first);
-
-	// Then, for all provinces, see if their culture has a primary nation, and if we're allowed to insert it.
+	// Then, for all provinces, see if their culture has a primary nation, and if we're allowed to insert it. Dead
+	// countries are those left without provinces, which is what we ask the primary nation directly.
 	for (const auto& province: provinces)
 	{
 		// Don't touch ROTW
@@ -275,7 +286,7 @@ void EU4::World::distributeDeadCores()
 		const auto& primaryTag = primaryTagMapper.getPrimaryTagForCulture(province.second->getCulture());
 		if (primaryTag)
 		{
-			if (deadTags.count(*primaryTag))
+			if (const auto& primaryCountry = countries.find(*primaryTag); primaryCountry != countries.end() && primaryCountry->second->getProvinces().empty())
 			{
 				// We're ok to use this.
 				province.second->addCore(*primaryTag);
@@ -296,9 +307,17 @@ void EU4::World::distributeClaims(const Configuration& theConfiguration)
 
 	Log(LogLevel::Info) << "-- Distributing DeJure Claims";
 	auto counter = 0;
-	std::map<int, std::set<std::string>> claimsRegister; // ck2 province, eu4 tag claims
+	// A bit matrix of ck2 province by claimant. Claimants are numbered in tag order, so walking a row's set bits
+	// upwards hands out claims in the same order as a sorted set of tags would.
+	std::vector<Tag> claimants;
+	for (const auto& country: countries)
+		if (!country.second->getTitle().first.empty() && !country.second->getProvinces().empty()) // No claims for dead nations.
+			claimants.emplace_back(country.first);
+	const auto rowWords = (claimants.size() + 63) / 64;
+	std::vector<std::uint64_t> claimsRegister;
 
 	// Mapping all countries with all their claims.
+	std::size_t claimant = 0;
 	for (const auto& country: countries)
 	{
 		if (country.second->getTitle().first.empty())
@@ -307,8 +326,14 @@ void EU4::World::distributeClaims(const Configuration& theConfiguration)
 			continue; // No claims for dead nations.
 		for (const auto& DJprovince: country.second->getTitle().second->getDeJureProvinces())
 		{
-			claimsRegister[DJprovince.first].insert(country.first);
+			if (DJprovince.first < 0)
+				continue;
+			const auto row = static_cast<std::size_t>(DJprovince.first) * rowWords;
+			if (claimsRegister.size() < row + rowWords)
+				claimsRegister.resize(row + rowWords, 0);
+			claimsRegister[row + claimant / 64] |= std::uint64_t{1} << (claimant % 64);
 		}
+		++claimant;
 	}
 
 	// And then rolling through provinces and applying those claims.
@@ -316,17 +341,20 @@ void EU4::World::distributeClaims(const Configuration& theConfiguration)
 	{
 		if (!province.second->getSourceProvince())
 			continue;
-		const auto& claimItr = claimsRegister.find(province.second->getSourceProvince()->getID());
-		if (claimItr == claimsRegister.end())
+		const auto sourceID = province.second->getSourceProvince()->getID();
+		if (sourceID < 0 || claimsRegister.size() < (static_cast<std::size_t>(sourceID) + 1) * rowWords)
 			continue;
-		for (const auto& tag: claimItr->second)
-		{
-			if (tag == province.second->getOwner())
-				continue;
-			// since de jure claims are based on DE JURE land, we're adding it even for PU or vassal land.
-			province.second->addPermanentClaim(tag);
-			counter++;
-		}
+		const auto row = static_cast<std::size_t>(sourceID) * rowWords;
+		for (std::size_t word = 0; word < rowWords; ++word)
+			for (auto bits = claimsRegister[row + word]; bits; bits &= bits - 1)
+			{
+				const auto& tag = claimants[word * 64 + static_cast<std::size_t>(std::countr_zero(bits))];
+				if (tag == province.second->getOwner())
+					continue;
+				// since de jure claims are based on DE JURE land, we're adding it even for PU or vassal land.
+				province.second->addPermanentClaim(tag);
+				counter++;
+			}
 	}
 	Log(LogLevel::Info) << "<> " << counter << " claims have been distributed.";
 }
@@ -336,42 +364,54 @@ void EU4::World::fixDuplicateNames()
 	Log(LogLevel::Info) << "-- Renaming Duplicate Countries";
 	auto counter = 0;
 
-	// Iterate through countries and assign their names as keywords. If a name appears more than once, add it to list of pointers
-	std::map<const std::string, std::vector<std::shared_ptr<Country>>> nameMap;
+	// Iterate through countries and line them up by name, and within a name by development (highest -> lowest). Ties
+	// keep tag order. Countries sharing a name end up next to each other without a map of batches.
+	struct NamedCountry
+	{
+		const std::string* name;
+		std::shared_ptr<Country> country;
+	};
+	std::vector<NamedCountry> namedCountries;
 	for (const auto& country: countries)
 	{
 		if (country.second->getProvinces().empty())
 			continue;
 		const auto& countryLocs = country.second->getLocalizations();
-		if (countryLocs.empty())
+		const auto& nameItr = countryLocs.find(country.first);
+		if (nameItr == countryLocs.end() || nameItr->second.english.empty())
 			continue;
-		if (countryLocs.find(country.first) == countryLocs.end())
-			continue;
-		if (countryLocs.find(country.first)->second.english.empty())
-			continue;
-		nameMap[countryLocs.find(country.first)->second.english].emplace_back(country.second);
+		namedCountries.emplace_back(NamedCountry{&nameItr->second.english, country.second});
 	}
+	std::stable_sort(namedCountries.begin(), namedCountries.end(), [](const NamedCountry& a, const NamedCountry& b) {
+		if (const auto order = a.name->compare(*b.name); order != 0)
+			return order < 0;
+		return a.country->getDevelopment() > b.country->getDevelopment();
+	});
 
-	// Reorder countries in list by development (highest -> lowest)
-	for (auto& countryBatch: nameMap)
+	// Batches of duplicates are cut before anyone is renamed, renaming changes the names they were sorted by.
+	std::vector<std::vector<std::shared_ptr<Country>>> duplicateBatches;
+	for (auto first = namedCountries.begin(); first != namedCountries.end();)
 	{
-		std::sort(countryBatch.second.begin(), countryBatch.second.end(), [](auto a, auto b) {
-			return a->getDevelopment() > b->getDevelopment();
+		const auto last = std::find_if(first, namedCountries.end(), [&first](const NamedCountry& named) {
+			return *named.name != *first->name;
 		});
+		if (last - first > 1)
+		{
+			auto& batch = duplicateBatches.emplace_back();
+			for (auto named = first; named != last; ++named)
+				batch.emplace_back(named->country);
+		}
+		first = last;
 	}
 
 	// Now we iterate through all batches and sort out the names.
-	for (const auto& countryBatch: nameMap)
+	for (const auto& countryBatch: duplicateBatches)
 	{
-		// Bail for singletons
-		if (countryBatch.second.size() <= 1)
-			continue;
-
 		// This is the locblock we're operating on. Should be same for all countries in this batch.
-		auto currentBlock = countryBatch.second[0]->getLocalizations().find(countryBatch.second[0]->getTag())->second;
+		auto currentBlock = countryBatch[0]->getLocalizations().find(countryBatch[0]->getTag())->second;
 
 		// Is this a dynastyname? These will follow a bit different rules.
-		auto dynastyName = countryBatch.second[0]->getHasDynastyName();
+		auto dynastyName = countryBatch[0]->getHasDynastyName();
 
 		// Clear out any "Greater" from name.
 		auto greaterdropped = false;
@@ -397,10 +437,10 @@ void EU4::World::fixDuplicateNames()
 
 		// and now let's get to work.
 
-		for (auto i = 0; i < static_cast<int>(countryBatch.second.size()); i++)
+		for (auto i = 0; i < static_cast<int>(countryBatch.size()); i++)
 		{
 			mappers::LocBlock newBlock;
-			const auto& actualCountry = countryBatch.second[i];
+			const auto& actualCountry = countryBatch[i];
 			const auto& actualTag = actualCountry->getTag();
 			const auto& countryLocs = actualCountry->getLocalizations();
 
@@ -418,7 +458,7 @@ void EU4::World::fixDuplicateNames()
 						newBlock.spanish = currentBlock.spanish + " Secreta";
 						newBlock.french = currentBlock.french + " Secr�te";
 						newBlock.german = "Geheimnis " + currentBlock.german;
-						actualCountry->setLocalizations(newBlock);
+						actualCountry->setLocalizations(std::move(newBlock));
 						break;
 					default:
 						// Otherwise we're trying to fuse TAG_ADJ and a canonical name for the country. (Ottoman Austria)
@@ -432,14 +472,13 @@ void EU4::World::fixDuplicateNames()
 							newBlock.spanish = adjBlock.spanish + " " + canonicalBlock.spanish;
 							newBlock.german = adjBlock.german + " " + canonicalBlock.german;
 							newBlock.french = adjBlock.french + " " + canonicalBlock.french;
-							actualCountry->setLocalizations(newBlock);
+							actualCountry->setLocalizations(std::move(newBlock));
 							break;
 						}
 						// If we at least have canonical, we can bail from dynasty names. (just Austria)
 						if (countryLocs.count("canonical"))
 						{
-							newBlock = countryLocs.find("canonical")->second;
-							actualCountry->setLocalizations(newBlock);
+							actualCountry->setLocalizations(countryLocs.find("canonical")->second);
 							break;
 						}
 						// Else crap. We don't have a canonical name for these fellows. Leave as is.
@@ -467,7 +506,7 @@ void EU4::World::fixDuplicateNames()
 							newBlock.french = currentBlock.french + " Majeur";
 							newBlock.german = currentBlock.german + " Maior";
 						}
-						actualCountry->setLocalizations(newBlock);
+						actualCountry->setLocalizations(std::move(newBlock));
 						break;
 					case 1:
 						// This is Lesser, unless it's Minor.
@@ -485,7 +524,7 @@ void EU4::World::fixDuplicateNames()
 							newBlock.french = currentBlock.french + " Mineur";
 							newBlock.german = currentBlock.german + " Minor";
 						}
-						actualCountry->setLocalizations(newBlock);
+						actualCountry->setLocalizations(std::move(newBlock));
 						break;
 					case 2:
 						// Hello Hither.
@@ -493,7 +532,7 @@ void EU4::World::fixDuplicateNames()
 						newBlock.spanish = "Hither " + currentBlock.english;
 						newBlock.french = "Hither " + currentBlock.english;
 						newBlock.german = "Hither " + currentBlock.english;
-						actualCountry->setLocalizations(newBlock);
+						actualCountry->setLocalizations(std::move(newBlock));
 						break;
 					case 3:
 						// Hello Further.
@@ -501,7 +540,7 @@ void EU4::World::fixDuplicateNames()
 						newBlock.spanish = "Lejos " + currentBlock.spanish;
 						newBlock.french = "Plus " + currentBlock.french;
 						newBlock.german = "Ferner " + currentBlock.german;
-						actualCountry->setLocalizations(newBlock);
+						actualCountry->setLocalizations(std::move(newBlock));
 						break;
 					case 4:
 						// This one's easy.
@@ -509,7 +548,7 @@ void EU4::World::fixDuplicateNames()
 						newBlock.spanish = currentBlock.spanish + " Secreta";
 						newBlock.french = currentBlock.french + " Secr�te";
 						newBlock.german = "Geheimnis " + currentBlock.german;
-						actualCountry->setLocalizations(newBlock);
+						actualCountry->setLocalizations(std::move(newBlock));
 						break;
 					default:
 						// Out of ideas. 6 Polands? Don't care any more.
@@ -542,7 +581,8 @@ void EU4::World::siberianQuestion(const Configuration& theConfiguration)
 	{
 		if (country.second->getGovernment() != "nomad" && country.second->getGovernment() != "tribal")
 			continue;
-		if (country.second->getProvinces().empty())
+		const auto owned = provinceOwners.provincesOf(country.first); // a copy, sterilizing empties it
+		if (owned.empty())
 			continue;
 		if (!country.second->getCapitalID())
 			continue;
@@ -551,17 +591,15 @@ void EU4::World::siberianQuestion(const Configuration& theConfiguration)
 			continue;
 		if (region != "west_siberia_region" && region != "east_siberia_region")
 			continue;
-		if (theConfiguration.getSiberia() == Configuration::SIBERIA::SMALL_SIBERIA && country.second->getProvinces().size() > 5)
+		if (theConfiguration.getSiberia() == Configuration::SIBERIA::SMALL_SIBERIA && owned.size() > 5)
 			continue;
 		if (country.second->getTag() == "CHU" || country.second->getTag() == "HOD" || country.second->getTag() == "CHV" || country.second->getTag() == "KMC")
 			continue;
 
 
 		// All checks done. Let's get deleting.
-		for (const auto& province: country.second->getProvinces())
-		{
-			province.second->sterilize();
-		}
+		for (const auto provinceID: owned)
+			provinces.find(provinceID)->second->sterilize();
 		country.second->clearProvinces();
 		country.second->clearExcommunicated();
 		diplomacy.deleteAgreementsWithTag(country.first);
@@ -667,7 +705,7 @@ void EU4::World::adjustChina(const CK2::World& sourceWorld, const Configuration:
 	if (countries.count("MGE") && !countries.find("MGE")->second->getProvinces().empty() && countries.count("KHA"))
 	{
 		bool isSource = false;
-		for (auto province: countries.find("KHA")->second->getProvinces())
+		for (const auto& province: countries.find("KHA")->second->getProvinces())
 		{
 			if (province.second->getSourceProvince())
 			{
@@ -678,14 +716,13 @@ void EU4::World::adjustChina(const CK2::World& sourceWorld, const Configuration:
 		if (!isSource)
 		{
 			// Move all Mongolia provinces under Mongol Empire, only happens if Mongolia is seperate from the Mongol Empire
-			for (const auto& province: provinces)
+			const auto mongolia = provinceOwners.provincesOf("KHA"); // a copy, the loop empties it
+			for (const auto provinceID: mongolia)
 			{
-				if (province.second->getOwner() == "KHA")
-				{
-					province.second->setOwner("MGE");
-					province.second->setController("MGE");
-					province.second->addCore("MGE");
-				}
+				const auto& province = provinces.find(provinceID)->second;
+				province->setOwner("MGE");
+				province->setController("MGE");
+				province->addCore("MGE");
 			}
 
 			// Add cores for provinces in China/Manchuria
@@ -773,12 +810,14 @@ void EU4::World::adjustChina(const CK2::World& sourceWorld, const Configuration:
 		// Move our diplo to China
 		diplomacy.updateTagsInAgreements(westernTag, ourChinaTag);
 		// Move our provinces to China
-		for (const auto& province: country.second->getProvinces())
+		const auto protectorate = provinceOwners.provincesOf(westernTag); // a copy, the loop empties it
+		for (const auto provinceID: protectorate)
 		{
-			province.second->addDiscoveredBy("chinese");
-			province.second->setOwner(ourChinaTag);
-			province.second->setController(ourChinaTag);
-			province.second->addCore(ourChinaTag);
+			const auto& province = provinces.find(provinceID)->second;
+			province->addDiscoveredBy("chinese");
+			province->setOwner(ourChinaTag);
+			province->setController(ourChinaTag);
+			province->addCore(ourChinaTag);
 		}
 		break;
 	}
@@ -797,7 +836,7 @@ void EU4::World::adjustChina(const CK2::World& sourceWorld, const Configuration:
 		emperor.adm = std::min((holder.second->getSkills().stewardship + holder.second->getSkills().learning) / 3 + 1, 6);
 		emperor.dip = std::min((holder.second->getSkills().diplomacy + holder.second->getSkills().intrigue) / 3 + 1, 6);
 		emperor.mil = std::min((holder.second->getSkills().martial + holder.second->getSkills().learning) / 3 + 1, 6);
-		std::string baseReligion;
+		parsing::Symbol baseReligion;
 		if (!holder.second->getReligion().empty())
 			baseReligion = holder.second->getReligion();
 		if (!baseReligion.empty())
@@ -810,7 +849,7 @@ void EU4::World::adjustChina(const CK2::World& sourceWorld, const Configuration:
 		}
 		else
 			Log(LogLevel::Warning) << "Celestial emperor could not determine base religion!";
-		std::string baseCulture;
+		parsing::Symbol baseCulture;
 		if (!holder.second->getCulture().empty())
 			baseCulture = holder.second->getCulture();
 		if (!baseCulture.empty())
@@ -865,7 +904,7 @@ void EU4::World::adjustChina(const CK2::World& sourceWorld, const Configuration:
 					if (religiousInfluence.second == 0.0)
 						continue;
 					// is this a valid religion?
-					const auto& targetReligion = religionMapper.getEu4ReligionForCk2Religion(religiousInfluence.first);
+					const auto& targetReligion = religionMapper.getEu4ReligionForCk2Religion(parsing::Symbol(religiousInfluence.first));
 					if (!targetReligion)
 					{
 						(*chineseReligions)[religiousInfluence.first] = 0;
@@ -914,21 +953,38 @@ void EU4::World::fixTengri()
 	Log(LogLevel::Info) << ">< Tengri successfully unreformed";
 }
 
+void EU4::World::forEachCountry(const COUNTRY_PASS pass, const std::function<void(const std::pair<const std::string, std::shared_ptr<Country>>& country)>& work)
+{
+	if (pass == COUNTRY_PASS::CROSS_COUNTRY)
+	{
+		for (const auto& country: countries)
+			work(country);
+		return;
+	}
+
+	std::vector<const std::pair<const std::string, std::shared_ptr<Country>>*> claimable;
+	claimable.reserve(countries.size());
+	for (const auto& country: countries)
+		claimable.emplace_back(&country);
+	CK2::forEachClaimed(claimable.size(), [&claimable, &work](const std::size_t index) {
+		work(*claimable[index]);
+	});
+}
+
 void EU4::World::verifyCapitals()
 {
 	Log(LogLevel::Info) << "-- Verifying All countries Have Capitals";
 
-	auto counter = 0;
-	for (const auto& country: countries)
-	{
+	std::atomic counter = 0;
+	forEachCountry(COUNTRY_PASS::PER_COUNTRY, [this, &counter](const auto& country) {
 		// POPE is special. Of course. Skip this for pope because he may end up with a capital in new world or something.
 		if (country.first == "PAP" || country.first == "FAP")
-			continue;
-		if (country.second->verifyCapital(*provinceMapper))
-			counter++;
-	}
+			return;
+		if (country.second->verifyCapital(capitals))
+			++counter;
+	});
 
-	Log(LogLevel::Info) << "<> " << counter << " capitals have been reassigned.";
+	Log(LogLevel::Info) << "<> " << counter.load() << " capitals have been reassigned.";
 }
 
 void EU4::World::distributeForts()
@@ -938,57 +994,60 @@ void EU4::World::distributeForts()
 	// We're doing this only for our new countries. We haven't deleted forts in ROTW.
 	// Countries at 4+ provinces get a capital fort. 8+ countries get one fort per area where they own 3+ provinces.
 
-	auto counterCapital = 0;
-	auto counterOther = 0;
+	std::atomic counterCapital = 0;
+	std::atomic counterOther = 0;
 
-	for (const auto& country: countries)
-	{
+	forEachCountry(COUNTRY_PASS::PER_COUNTRY, [this, &counterCapital, &counterOther](const auto& country) {
 		if (country.second->getTitle().first.empty())
-			continue;
+			return;
 		if (country.second->getProvinces().size() < 4)
-			continue; // To small to afford forts.
+			return; // To small to afford forts.
 		if (!country.second->getCapitalID())
-			continue; // Not dealing with broken countries, thank you.
+			return; // Not dealing with broken countries, thank you.
 		if (!country.second->getProvinces().count(country.second->getCapitalID()))
 		{
 			if (country.first != "PAP")
 				Log(LogLevel::Warning) << country.first << " has capital province set to " << country.second->getCapitalID() << " but doesn't own it?";
-			continue; // this should have been fixed earlier by verifyCapitals! Well... Except for pope.
+			return; // this should have been fixed earlier by verifyCapitals! Well... Except for pope.
 		}
 
-		const auto& capitalAreaName = regionMapper->getParentAreaName(country.second->getCapitalID());
-		if (!capitalAreaName)
-			continue; // uh-huh
+		const auto& capitalArea = regionMapper->getParentAreaID(country.second->getCapitalID());
+		if (!capitalArea)
+		{
+			Log(LogLevel::Warning) << "Province ID " << country.second->getCapitalID() << " has no parent area name!";
+			return; // uh-huh
+		}
 
 		const auto& capitalProvince = country.second->getProvinces().find(country.second->getCapitalID());
 		capitalProvince->second->buildFort();
-		counterCapital++;
+		++counterCapital;
 
 		if (country.second->getProvinces().size() < 8)
-			continue; // Too small for more forts.
-
-		std::set<std::string> builtAreas = {*capitalAreaName};
-		// Now it gets serious. We need a list of areas with 3+ provinces.
-		std::map<std::string, int> elegibleAreas;
-
+			return; // Too small for more forts.
+
+		std::vector<bool> builtAreas(regionMapper->getAreaCount(), false);
+		builtAreas[*capitalArea] = true;
+		// Now it gets serious. We need a list of areas with 3+ provinces, counted in the same pass that finds every
+		// province's area.
+		std::vector<int> elegibleAreas(regionMapper->getAreaCount(), 0);
+		std::vector<std::pair<std::size_t, Province*>> areaProvinces;
+		areaProvinces.reserve(country.second->getProvinces().size());
 		for (const auto& province: country.second->getProvinces())
 		{
-			const auto& areaName = regionMapper->getParentAreaName(province.first);
-			if (!areaName)
+			const auto& areaID = regionMapper->getParentAreaID(province.first);
+			if (!areaID)
 				continue;
-			elegibleAreas[*areaName]++;
+			elegibleAreas[*areaID]++;
+			areaProvinces.emplace_back(*areaID, province.second);
 		}
 
 		// And we put a fort in every third?
 		auto counter = 0;
-		for (const auto& province: country.second->getProvinces())
+		for (const auto& [areaID, province]: areaProvinces)
 		{
-			const auto& areaName = regionMapper->getParentAreaName(province.first);
-			if (!areaName)
+			if (builtAreas[areaID])
 				continue;
-			if (builtAreas.count(*areaName))
-				continue;
-			if (elegibleAreas[*areaName] <= 2)
+			if (elegibleAreas[areaID] <= 2)
 				continue;
 			if (counter < 2)
 			{
@@ -997,13 +1056,13 @@ void EU4::World::distributeForts()
 			}
 			counter = 0;
 
-			province.second->buildFort();
-			counterOther++;
-			builtAreas.insert(*areaName);
+			province->buildFort();
+			++counterOther;
+			builtAreas[areaID] = true;
 		}
-	}
+	});
 
-	Log(LogLevel::Info) << "<> " << counterCapital << " capital forts and " << counterOther << " other forts have been built.";
+	Log(LogLevel::Info) << "<> " << counterCapital.load() << " capital forts and " << counterOther.load() << " other forts have been built.";
 }
 
 void EU4::World::alterProvinceDevelopment()
@@ -1018,62 +1077,63 @@ void EU4::World::alterProvinceDevelopment()
 	//
 	// We're ignoring hospitals at this stage.
 
-	auto totalVanillaDev = 0;
-	auto totalCK2Dev = 0;
-	auto counter = 0;
-
-	for (const auto& province: provinces)
-	{
-		if (!province.second->getSourceProvince())
-			continue;
-		totalVanillaDev += province.second->getDev();
-		auto adm = 0.0;
-		auto dip = 0.0;
-		auto mil = 0.0;
-		const auto& baronies = province.second->getSourceProvince()->getBaronies();
-		for (const auto& barony: baronies)
-		{
-			if (barony.second->getType().empty())
-				continue;
-			const auto buildingNumber = static_cast<double>(barony.second->getBuildingCount());
-			const auto baronyDev = devWeightsMapper.getDevFromBarony() + devWeightsMapper.getDevFromBuilding() * buildingNumber;
-			if (barony.second->getType() == "tribal" || barony.second->getType() == "nomad")
-			{
-				mil += baronyDev;
-			}
-			else if (barony.second->getType() == "city")
-			{
-				dip += baronyDev;
-			}
-			else if (barony.second->getType() == "temple")
-			{
-				adm += baronyDev;
-			}
-			else if (barony.second->getType() == "castle")
-			{
-				adm += baronyDev * 1 / 3; // third to adm
-				mil += baronyDev * 2 / 3; // two thirds to mil
-			}
-		}
-		province.second->setAdm(std::max(static_cast<int>(std::lround(adm)), 1));
-		province.second->setDip(std::max(static_cast<int>(std::lround(dip)), 1));
-		province.second->setMil(std::max(static_cast<int>(std::lround(mil)), 1));
-		counter++;
-		totalCK2Dev += province.second->getDev();
-	}
-
-	Log(LogLevel::Info) << "<> " << counter << " provinces scaled: " << totalCK2Dev << " development imported (vanilla had " << totalVanillaDev << ").";
+	//
+	// The split per holding type comes from devWeightsMapper. Baronies and buildings are tallied per type first, so
+	// each province only weighs as many types as there are. Provinces only write to themselves and go side by side.
+
+	std::atomic totalVanillaDev = 0;
+	std::atomic totalCK2Dev = 0;
+	std::atomic counter = 0;
+
+	CK2::forEachSlice(
+		 provinces.size(),
+		 [this, &totalVanillaDev, &totalCK2Dev, &counter](const std::size_t first, const std::size_t last) {
+			 for (auto index = first; index < last; ++index)
+			 {
+				 const auto& province = *(provinces.begin() + static_cast<std::ptrdiff_t>(index));
+				 if (!province.second->getSourceProvince())
+					 continue;
+				 totalVanillaDev += province.second->getDev();
+
+				 std::array<int, CK2::Barony::holdingCount> baronyCounts{};
+				 std::array<int, CK2::Barony::holdingCount> buildingCounts{};
+				 for (const auto& barony: province.second->getSourceProvince()->getBaronies())
+				 {
+					 const auto holding = static_cast<std::size_t>(barony.second->getHolding());
+					 ++baronyCounts[holding];
+					 buildingCounts[holding] += barony.second->getBuildingCount();
+				 }
+
+				 mappers::DevWeightsMapper::DevSplit dev{};
+				 for (std::size_t holding = 0; holding < CK2::Barony::holdingCount; ++holding)
+				 {
+					 const auto holdingDev = devWeightsMapper.getDevFromBarony() * baronyCounts[holding] + devWeightsMapper.getDevFromBuilding() * buildingCounts[holding];
+					 const auto& split = mappers::DevWeightsMapper::getDevSplit(static_cast<CK2::Barony::HOLDING>(holding));
+					 for (std::size_t category = 0; category < dev.size(); ++category)
+						 dev[category] += holdingDev * split[category];
+				 }
+				 province.second->setAdm(std::max(static_cast<int>(std::lround(dev[0])), 1));
+				 province.second->setDip(std::max(static_cast<int>(std::lround(dev[1])), 1));
+				 province.second->setMil(std::max(static_cast<int>(std::lround(dev[2])), 1));
+				 ++counter;
+				 totalCK2Dev += province.second->getDev();
+			 }
+		 },
+		 256);
+
+	Log(LogLevel::Info) << "<> " << counter.load() << " provinces scaled: " << totalCK2Dev.load() << " development imported (vanilla had " << totalVanillaDev.load() << ").";
 }
 
 void EU4::World::importAdvisers(Configuration::STARTDATE startDateOption, date theConversionDate)
 {
 	Log(LogLevel::Info) << "-> Importing Advisers";
 	auto counter = 0;
-	for (const auto& country: countries)
-	{
+	// Cross-country: a holder without a primary title staffs every country they hold, and an adviser employed by one
+	// is marked spent on the shared CK2 character so the next one passes him over.
+	forEachCountry(COUNTRY_PASS::CROSS_COUNTRY, [this, &counter, startDateOption, &theConversionDate](const auto& country) {
 		country.second->initializeAdvisers(religionMapper, cultureMapper, startDateOption, theConversionDate);
 		counter += static_cast<int>(country.second->getAdvisers().size());
-	}
+	});
 	Log(LogLevel::Info) << "<> Imported " << counter << " advisers.";
 }
 
@@ -1095,9 +1155,13 @@ void EU4::World::resolvePersonalUnions()
 		 "paulician",
 		 "monophysite"};
 
-	std::map<int, std::map<std::string, std::shared_ptr<Country>>> holderTitles;
-	std::map<int, std::pair<std::string, std::shared_ptr<Country>>> holderPrimaryTitle;
-	std::map<int, std::shared_ptr<CK2::Character>> relevantHolders;
+	// Every holder's crowns and the country of their primary title, gathered in one pass over the countries.
+	struct Crowns
+	{
+		std::map<std::string, std::shared_ptr<Country>> titles;
+		std::optional<std::pair<std::string, Country*>> primaryTitle;
+	};
+	std::map<int, Crowns> holderCrowns;
 
 	// We're filling the registry first.
 	for (const auto& country: countries)
@@ -1108,48 +1172,47 @@ void EU4::World::resolvePersonalUnions()
 			continue;
 		// we have a holder.
 		const auto& holder = country.second->getTitle().second->getHolder();
-		holderTitles[holder.first].insert(country);
-		relevantHolders.insert(holder);
+		auto& crowns = holderCrowns[holder.first];
+		crowns.titles.insert(country);
 		// does he have a primary title?
-		if (!holder.second->getPrimaryTitle().first.empty())
+		if (!crowns.primaryTitle && !holder.second->getPrimaryTitle().first.empty())
 		{
-			if (!holder.second->getPrimaryTitle().second->getTitle().second->getEU4Tag().first.empty())
-			{
-				holderPrimaryTitle[holder.first] = holder.second->getPrimaryTitle().second->getTitle().second->getEU4Tag();
-			}
+			const auto& primaryTag = holder.second->getPrimaryTitle().second->getTitle().second->getEU4Tag();
+			if (!primaryTag.first.empty())
+				crowns.primaryTitle = primaryTag;
 		}
 	}
 
 	// Now let's see what we have.
-	for (const auto& holderTitle: holderTitles)
+	for (const auto& [holderID, crowns]: holderCrowns)
 	{
-		if (holderTitle.second.size() <= 1)
+		const auto& holderTitles = crowns.titles;
+		if (holderTitles.size() <= 1)
 			continue;
 
 		// multiple crowns. What's our primary?
-		auto primaryItr = holderPrimaryTitle.find(holderTitle.first);
-		std::pair<std::string, std::shared_ptr<Country>> primaryTitle;
-		if (primaryItr == holderPrimaryTitle.end() || primaryItr->second.second->getProvinces().empty())
+		std::pair<std::string, Country*> primaryTitle;
+		if (!crowns.primaryTitle || crowns.primaryTitle->second->getProvinces().empty())
 		{
 			// We need to find another primary title.
 			auto foundPrimary = false;
 			// First check if we can find PAP or FAP or some special flag
-			for (const auto& title: holderTitle.second)
+			for (const auto& title: holderTitles)
 			{
 				if (title.first == "PAP" || title.first == "FAP" || title.second->isHREEmperor() || title.second->isHREElector())
 				{
-					primaryTitle = std::pair(title.first, title.second);
+					primaryTitle = std::pair(title.first, title.second.get());
 					foundPrimary = true;
 					break;
 				}
 			}
 			// If no popes or specials pick first one.
 			if (!foundPrimary)
-				for (const auto& title: holderTitle.second)
+				for (const auto& title: holderTitles)
 				{
 					if (!title.second->getProvinces().empty())
 					{
-						primaryTitle = std::pair(title.first, title.second);
+						primaryTitle = std::pair(title.first, title.second.get());
 						foundPrimary = true;
 						break;
 					}
@@ -1159,14 +1222,14 @@ void EU4::World::resolvePersonalUnions()
 		}
 		else
 		{
-			primaryTitle = primaryItr->second;
+			primaryTitle = *crowns.primaryTitle;
 
 			// That's lovely, but is this the special snowflake THE POPE? Does he hold PAP/FAP as secondary?
-			for (const auto& title: holderTitle.second)
+			for (const auto& title: holderTitles)
 			{
 				if (title.first == "PAP" || title.first == "FAP")
 				{
-					primaryTitle = std::pair(title.first, title.second);
+					primaryTitle = std::pair(title.first, title.second.get());
 					break;
 				}
 			}
@@ -1182,7 +1245,7 @@ void EU4::World::resolvePersonalUnions()
 		if (!heathen && primaryTitle.second->getGovernment() == "monarchy")
 		{
 			auto unionCount = 0;
-			for (const auto& title: holderTitle.second)
+			for (const auto& title: holderTitles)
 			{
 				if (title.first == primaryTitle.first)
 					continue;
@@ -1206,7 +1269,7 @@ void EU4::World::resolvePersonalUnions()
 		else
 		{
 			// heathens annex straight up.
-			for (const auto& title: holderTitle.second)
+			for (const auto& title: holderTitles)
 			{
 				if (title.first == primaryTitle.first)
 					continue;
@@ -1241,6 +1304,17 @@ void EU4::World::markHRETag(const Configuration& theConfiguration, const std::st
 	Log(LogLevel::Info) << "<> Marked " << actualHRETag << " as HRE tag.";
 }
 
+void EU4::World::takeCensus(CK2::PhaseTimings& timings) const
+{
+	if (!timings.takesCensus())
+		return;
+	CK2::MemoryCensus census;
+	census.addEntities("EU4 Country", countries);
+	census.addEntities("EU4 Province", provinces);
+	census.add("Localisation", sizeof(mappers::LocalizationMapper), localizationMapper.heapBytes());
+	timings.census(census);
+}
+
 void EU4::World::distributeHRESubtitles(const Configuration& theConfiguration)
 {
 	if (theConfiguration.getHRE() == Configuration::I_AM_HRE::NONE)
@@ -1257,14 +1331,29 @@ void EU4::World::distributeHRESubtitles(const Configuration& theConfiguration)
 		}
 	if (!emperorTag.empty())
 	{
-		setFreeCities();
-		setElectors();
+		const auto members = gatherHREMembers();
+		setFreeCities(members);
+		setElectors(members);
 	}
 	else
 		Log(LogLevel::Info) << "<> Emperor could not be found, no HRE mechanics.";
 }
 
-void EU4::World::setElectors()
+EU4::World::HREMembers EU4::World::gatherHREMembers() const
+{
+	HREMembers members;
+	for (const auto& country: countries)
+	{
+		if (!country.second->isinHRE())
+			continue;
+		members.countries.emplace_back(country);
+		members.electorates.push_back(country.second->getTitle().second->isElector());
+		members.juniors.push_back(diplomacy.isCountryJunior(country.first));
+	}
+	return members;
+}
+
+void EU4::World::setElectors(const HREMembers& members)
 {
 	Log(LogLevel::Info) << "-> Setting Electors";
 	std::vector<std::pair<int, std::shared_ptr<Country>>> bishops;	  // piety-tag
@@ -1276,64 +1365,62 @@ void EU4::World::setElectors()
 	int electorDuchies = 0;
 
 	// We need to be careful about papacy and orthodox holders
-	for (const auto& country: countries)
+	for (std::size_t member = 0; member < members.countries.size(); ++member)
 	{
-		if (country.second->isinHRE())
+		const auto& country = members.countries[member];
+		if (country.second->getProvinces().empty())
+			continue;
+		const auto& holder = country.second->getTitle().second->getHolder();
+		if (country.first == "PAP" || holder.second->getPrimaryTitle().first == "k_orthodox")
 		{
-			if (country.second->getProvinces().empty())
-				continue;
-			const auto& holder = country.second->getTitle().second->getHolder();
-			if (country.first == "PAP" || holder.second->getPrimaryTitle().first == "k_orthodox")
+			// override to always be elector
+			electors.emplace_back(country.second);
+			electorBishops++;
+			continue;
+		}
+		// Let's shove all hre members into appropriate categories.
+		if (country.second->getGovernment() == "theocracy")
+		{
+			if (members.electorates[member])
 			{
-				// override to always be elector
-				electors.emplace_back(country.second);
 				electorBishops++;
-				continue;
+				electors.emplace_back(country.second);
 			}
-			// Let's shove all hre members into appropriate categories.
-			if (country.second->getGovernment() == "theocracy")
+			else
 			{
-				if (country.second->getTitle().second->isElector())
-				{
-					electorBishops++;
-					electors.emplace_back(country.second);
-				}
-				else
-				{
-					bishops.emplace_back(std::pair(lround(holder.second->getPiety()), country.second));
-				}
+				bishops.emplace_back(std::pair(lround(holder.second->getPiety()), country.second));
 			}
-			else if (country.second->getGovernment() == "monarchy")
+		}
+		else if (country.second->getGovernment() == "monarchy")
+		{
+			if (members.electorates[member])
 			{
-				if (country.second->getTitle().second->isElector())
-				{
-					electorDuchies++;
-					electors.emplace_back(country.second);
-				}
-				else
-				{
-					// skip juniors.
-					if (diplomacy.isCountryJunior(country.first))
-						continue;
-					duchies.emplace_back(std::pair(country.second->getDevelopment(), country.second));
-				}
+				electorDuchies++;
+				electors.emplace_back(country.second);
 			}
-			else if (country.second->getGovernment() == "republic")
+			else
 			{
-				// No free cities, thank you!
-				if (country.second->getGovernmentReforms().count("free_city"))
+				// skip juniors.
+				if (members.juniors[member])
 					continue;
-				if (country.second->getTitle().second->isElector())
-				{
-					electorRepublics++;
-					electors.emplace_back(country.second);
-				}
-				else
-				{
-					republics.emplace_back(std::pair(country.second->getDevelopment(), country.second));
-				}
-			} // skipping tribal and similar.
+				duchies.emplace_back(std::pair(country.second->getDevelopment(), country.second));
+			}
 		}
+		else if (country.second->getGovernment() == "republic")
+		{
+			// No free cities, thank you!
+			if (country.second->getGovernmentReforms().count("free_city"))
+				continue;
+			if (members.electorates[member])
+			{
+				electorRepublics++;
+				electors.emplace_back(country.second);
+			}
+			else
+			{
+				republics.emplace_back(std::pair(country.second->getDevelopment(), country.second));
+			}
+		} // skipping tribal and similar.
 	}
 
 	std::sort(bishops.rbegin(), bishops.rend());
@@ -1369,15 +1456,16 @@ void EU4::World::setElectors()
 	Log(LogLevel::Info) << "<> There are " << electors.size() << " electors recognized.";
 }
 
-void EU4::World::setFreeCities()
+void EU4::World::setFreeCities(const HREMembers& members)
 {
 	Log(LogLevel::Info) << "-> Setting Free Cities";
 	// How many free cities do we already have?
 	auto freeCityNum = 0;
-	for (const auto& country: countries)
+	for (std::size_t member = 0; member < members.countries.size(); ++member)
 	{
-		if (country.second->isinHRE() && country.second->getGovernment() == "republic" && country.second->getProvinces().size() == 1 &&
-			 country.second->getTitle().second->getGeneratedLiege().first.empty() && !country.second->getTitle().second->isElector() && freeCityNum < 12)
+		const auto& country = members.countries[member];
+		if (country.second->getGovernment() == "republic" && country.second->getProvinces().size() == 1 &&
+			 country.second->getTitle().second->getGeneratedLiege().first.empty() && !members.electorates[member] && freeCityNum < 12)
 		{
 			country.second->overrideReforms("free_city");
 			country.second->setMercantilism(25);
@@ -1387,11 +1475,12 @@ void EU4::World::setFreeCities()
 	// Can we turn some minors into free cities?
 	if (freeCityNum < 12)
 	{
-		for (const auto& country: countries)
+		for (std::size_t member = 0; member < members.countries.size(); ++member)
 		{
-			if (country.second->isinHRE() && country.second->getGovernment() != "republic" && !country.second->isHREEmperor() &&
-				 country.second->getGovernmentReforms().empty() && country.second->getProvinces().size() == 1 && !diplomacy.isCountryJunior(country.first) &&
-				 country.second->getTitle().second->getGeneratedLiege().first.empty() && !country.second->getTitle().second->isElector() && freeCityNum < 12)
+			const auto& country = members.countries[member];
+			if (country.second->getGovernment() != "republic" && !country.second->isHREEmperor() && country.second->getGovernmentReforms().empty() &&
+				 country.second->getProvinces().size() == 1 && !members.juniors[member] && country.second->getTitle().second->getGeneratedLiege().first.empty() &&
+				 !members.electorates[member] && freeCityNum < 12)
 			{
 				if (country.first == "HAB")
 					continue; // For Iohannes who is sensitive about Austria.
@@ -1408,6 +1497,9 @@ void EU4::World::setFreeCities()
 
 void EU4::World::linkProvincesToCountries()
 {
+	// Owners are settled from here on, save for the few the late passes hand around.
+	provinceOwners.rebuild(provinces);
+
 	// Some of the provinces have linked countries, but new world won't. We need to insert links both ways there.
 	for (const auto& province: provinces)
 	{
@@ -1418,9 +1510,9 @@ void EU4::World::linkProvincesToCountries()
 		{
 			// registering owner in province
 			if (province.second->getTagCountry().first.empty())
-				province.second->registerTagCountry(std::pair(countryItr->first, countryItr->second));
+				province.second->registerTagCountry(std::pair(countryItr->first, countryItr->second.get()));
 			// registering province in owner.
-			countryItr->second->registerProvince(std::pair(province.first, province.second));
+			countryItr->second->registerProvince(std::pair(province.first, province.second.get()));
 		}
 		else
 		{
@@ -1438,20 +1530,14 @@ void EU4::World::linkProvincesToCountries()
 	}
 }
 
-template <typename KeyType, typename ValueType> std::pair<KeyType, ValueType> get_max(const std::map<KeyType, ValueType>& x)
-{
-	using pairtype = std::pair<KeyType, ValueType>;
-	return *std::max_element(x.begin(), x.end(), [](const pairtype& p1, const pairtype& p2) {
-		return p1.second < p2.second;
-	});
-}
-
-void EU4::World::verifyReligionsAndCultures()
+void EU4::World::verifyReligionsAndCultures(const Configuration& theConfiguration)
 {
 	// We are checking every country if it lacks primary religion and culture. This is an issue for hordeland mainly.
-	// For those lacking setups, we'll do a provincial census and inherit those values.
-	for (const auto& country: countries)
-	{
+	// For those lacking setups, we'll do a provincial census and inherit those values. Provinces missing either are
+	// only named with full validation, and otherwise counted.
+	const auto validation = theConfiguration.getValidation();
+	std::atomic<int> blankProvinces = 0;
+	forEachCountry(COUNTRY_PASS::PER_COUNTRY, [this, validation, &blankProvinces](const auto& country) {
 		// It's possible to get non-christian countries excommunicated through broken setups. Let's clear those immediately.
 		if (country.second->isExcommunicated())
 		{
@@ -1462,44 +1548,37 @@ void EU4::World::verifyReligionsAndCultures()
 		// And then proceed on checking the missing boxes.
 		if (!country.second->getReligion().empty() && !country.second->getPrimaryCulture().empty() && !country.second->getTechGroup().empty() &&
 			 !country.second->getGFX().empty())
-			continue;
+			return;
 		if (country.second->getProvinces().empty())
-			continue; // No point.
+			return; // No point.
 
-		std::map<std::string, int> religiousCensus;
-		std::map<std::string, int> culturalCensus;
-		for (const auto& province: country.second->getProvinces())
-		{
-			if (province.second->getReligion().empty())
-			{
-				Log(LogLevel::Warning) << "Province " << province.first << " has no religion set!";
-				continue;
-			}
-			if (province.second->getCulture().empty())
+		const auto& census = country.second->getCensus();
+		blankProvinces += census.getBlanks();
+		if (census.getBlanks() && validation == Configuration::VALIDATION::FULL)
+			for (const auto& province: country.second->getProvinces())
 			{
-				Log(LogLevel::Warning) << "Province " << province.first << " has no culture set!";
-				continue;
+				if (province.second->getReligion().empty())
+					Log(LogLevel::Warning) << "Province " << province.first << " has no religion set!";
+				else if (province.second->getCulture().empty())
+					Log(LogLevel::Warning) << "Province " << province.first << " has no culture set!";
 			}
-			religiousCensus[province.second->getReligion()] += 1;
-			culturalCensus[province.second->getCulture()] += 1;
-		}
 		if (country.second->getPrimaryCulture().empty())
 		{
-			auto max = get_max(culturalCensus);
-			Log(LogLevel::Warning) << country.first << " overriding blank culture with: " << max.first;
-			country.second->setPrimaryCulture(max.first);
+			const auto max = ProvinceCensus::mostProvinces(census.getCultures());
+			Log(LogLevel::Warning) << country.first << " overriding blank culture with: " << max;
+			country.second->setPrimaryCulture(max);
 		}
 		if (country.second->getMajorityReligion().empty())
 		{
-			auto max = get_max(religiousCensus);
-			Log(LogLevel::Info) << country.first << "'s majority religion is: " << max.first;
-			country.second->setMajorityReligion(max.first);
+			const auto max = ProvinceCensus::mostProvinces(census.getReligions());
+			Log(LogLevel::Info) << country.first << "'s majority religion is: " << max;
+			country.second->setMajorityReligion(max);
 		}
 		if (country.second->getReligion().empty())
 		{
-			auto max = get_max(religiousCensus);
-			Log(LogLevel::Warning) << country.first << " overriding blank religion with: " << max.first;
-			country.second->setReligion(max.first);
+			const auto max = ProvinceCensus::mostProvinces(census.getReligions());
+			Log(LogLevel::Warning) << country.first << " overriding blank religion with: " << max;
+			country.second->setReligion(max);
 		}
 		if (country.second->getTechGroup().empty())
 		{
@@ -1507,7 +1586,7 @@ void EU4::World::verifyReligionsAndCultures()
 			if (techMatch)
 			{
 				Log(LogLevel::Warning) << country.first << " overriding blank tech group with: " << *techMatch;
-				country.second->setGFX(*techMatch);
+				country.second->setGFX(std::string(*techMatch));
 			}
 			else
 			{
@@ -1521,7 +1600,7 @@ void EU4::World::verifyReligionsAndCultures()
 			if (gfxMatch)
 			{
 				Log(LogLevel::Warning) << country.first << " overriding blank gfx with: " << *gfxMatch;
-				country.second->setTechGroup(*gfxMatch);
+				country.second->setTechGroup(std::string(*gfxMatch));
 			}
 			else
 			{
@@ -1529,99 +1608,236 @@ void EU4::World::verifyReligionsAndCultures()
 				Log(LogLevel::Warning) << country.first << " could not determine GFX, substituting westerngfx!";
 			}
 		}
+	});
+	if (blankProvinces && validation == Configuration::VALIDATION::SUMMARY)
+		Log(LogLevel::Warning) << blankProvinces << " provinces have no religion or culture set! Set validation to full for which.";
+}
+
+std::shared_ptr<const EU4::StaticData::Mappers> EU4::World::loadMappers(const CK2::World& sourceWorld,
+	 const Configuration& theConfiguration,
+	 CK2::PhaseTimings& timings,
+	 StaticData& staticData)
+{
+	Log(LogLevel::Info) << "*** Hello EU4, let's get painting. ***";
+	timings.begin("Loading Mappers");
+	auto loaded = staticData.mappers(theConfiguration, sourceWorld.getMods(), StaticData::overrideModPath(sourceWorld.getMods()));
+	Log(LogLevel::Progress) << "54 %";
+	return loaded;
+}
+
+void EU4::World::prefetchVanilla(const Configuration& theConfiguration, const commonItems::ConverterVersion& converterVersion, StaticData& staticData)
+{
+	const auto& eu4Path = theConfiguration.getEU4Path();
+	std::string cacheKey;
+	if (theConfiguration.getSnapshot() != Configuration::SNAPSHOT::DISABLED)
+		cacheKey = VanillaCache::makeKey(converterVersion.getVersion(), eu4Path, false);
+	staticData.preload("Prefetching the vanilla countries and provinces", [&staticData, eu4Path, cacheKey] {
+		auto countriesImage = staticData.vanillaImage(vanillaImageKey("countries", eu4Path, false), [&eu4Path, &cacheKey] {
+			parsing::NameMap<std::shared_ptr<Country>> countries;
+			std::set<std::string> specialCountryTags;
+			importVanillaCountries(eu4Path, false, cacheKey, countries, specialCountryTags);
+			return VanillaCache::countriesImage(countries, specialCountryTags);
+		});
+		auto provincesImage = staticData.vanillaImage(vanillaImageKey("provinces", eu4Path, false), [&eu4Path, &cacheKey] {
+			ProvinceTable provinces;
+			importVanillaProvinces(eu4Path, false, cacheKey, provinces);
+			return VanillaCache::provincesImage(provinces);
+		});
+	});
+}
+
+void EU4::World::shareVanillaCountries(const std::string& eu4Path, const bool invasion, const std::string& cacheKey, StaticData& staticData)
+{
+	const auto imageKey = vanillaImageKey("countries", eu4Path, invasion);
+	if (!staticData.shared() && !staticData.holdsImage(imageKey))
+	{
+		importVanillaCountries(eu4Path, invasion, cacheKey, countries, specialCountryTags);
+		return;
 	}
+	auto importedHere = false;
+	const auto image = staticData.vanillaImage(imageKey, [this, &eu4Path, invasion, &cacheKey, &importedHere] {
+		importVanillaCountries(eu4Path, invasion, cacheKey, countries, specialCountryTags);
+		importedHere = true;
+		return VanillaCache::countriesImage(countries, specialCountryTags);
+	});
+	++CK2::Metrics::lookups("vanilla_image", !importedHere);
+	if (importedHere)
+		return;
+	VanillaCache::loadCountriesImage(*image, countries, specialCountryTags);
+	Log(LogLevel::Info) << "<> Copied " << countries.size() << " vanilla countries imported by another conversion.";
 }
 
-void EU4::World::importVanillaProvinces(const std::string& eu4Path, bool invasion)
+void EU4::World::shareVanillaProvinces(const std::string& eu4Path, const bool invasion, const std::string& cacheKey, StaticData& staticData)
+{
+	const auto imageKey = vanillaImageKey("provinces", eu4Path, invasion);
+	if (!staticData.shared() && !staticData.holdsImage(imageKey))
+	{
+		importVanillaProvinces(eu4Path, invasion, cacheKey, provinces);
+		return;
+	}
+	auto importedHere = false;
+	const auto image = staticData.vanillaImage(imageKey, [this, &eu4Path, invasion, &cacheKey, &importedHere] {
+		importVanillaProvinces(eu4Path, invasion, cacheKey, provinces);
+		importedHere = true;
+		return VanillaCache::provincesImage(provinces);
+	});
+	++CK2::Metrics::lookups("vanilla_image", !importedHere);
+	if (importedHere)
+		return;
+	VanillaCache::loadProvincesImage(*image, provinces);
+	Log(LogLevel::Info) << "<> Copied " << provinces.size() << " vanilla provinces imported by another conversion.";
+}
+
+void EU4::World::importVanillaProvinces(const std::string& eu4Path, const bool invasion, const std::string& cacheKey, ProvinceTable& provinces)
 {
 	Log(LogLevel::Info) << "-> Importing Vanilla Provinces";
+	if (!cacheKey.empty())
+	{
+		const auto loaded = VanillaCache::loadProvinces(provincesCachePath, cacheKey, provinces);
+		++CK2::Metrics::lookups("vanilla_cache", loaded);
+		if (loaded)
+		{
+			Log(LogLevel::Info) << "<> Loaded " << provinces.size() << " province definitions from " << provincesCachePath;
+			return;
+		}
+		provinces = ProvinceTable();
+	}
+
 	// ---- Loading history/provinces
-	auto fileNames = commonItems::GetAllFilesInFolder(eu4Path + "/history/provinces/");
-	for (const auto& fileName: fileNames)
+	// The files are parsed side by side, then merged in filename order so duplicates warn and override as before.
+	struct VanillaHistory
+	{
+		std::string fileName;
+		int id = 0;
+		std::shared_ptr<Province> province;
+		std::string error;
+	};
+	std::vector<VanillaHistory> histories;
+	for (const auto& fileName: commonItems::GetAllFilesInFolder(eu4Path + "/history/provinces/"))
 	{
 		if (fileName.find(".txt") == std::string::npos)
 			continue;
 		if (fileName.starts_with('~'))
 			continue;
-		try
-		{
-			const auto id = std::stoi(fileName);
-			auto newProvince = std::make_shared<Province>(id, eu4Path + "/history/provinces/" + fileName);
-			if (provinces.count(id))
-			{
-				Log(LogLevel::Warning) << "Vanilla province duplication - " << id << " already loaded! Overwriting.";
-				provinces[id] = newProvince;
-			}
-			else
-				provinces.insert(std::pair(id, newProvince));
-		}
-		catch (std::exception& e)
-		{
-			Log(LogLevel::Warning) << "Invalid province filename: " << eu4Path << "/history/provinces/" << fileName << " : " << e.what();
+		histories.emplace_back(VanillaHistory{fileName});
+	}
+	CK2::forEachSlice(
+		 histories.size(),
+		 [&histories, &eu4Path](const std::size_t first, const std::size_t last) {
+			 for (auto history = histories.begin() + first; history != histories.begin() + last; ++history)
+			 {
+				 try
+				 {
+					 history->id = std::stoi(history->fileName);
+					 history->province = std::make_shared<Province>(history->id, eu4Path + "/history/provinces/" + history->fileName);
+				 }
+				 catch (std::exception& e)
+				 {
+					 history->error = e.what();
+				 }
+			 }
+		 },
+		 historyFilesPerSlice);
+	for (auto& history: histories)
+	{
+		if (!history.province)
+		{
+			Log(LogLevel::Warning) << "Invalid province filename: " << eu4Path << "/history/provinces/" << history.fileName << " : " << history.error;
+			continue;
 		}
+		if (provinces.count(history.id))
+			Log(LogLevel::Warning) << "Vanilla province duplication - " << history.id << " already loaded! Overwriting.";
+		provinces.insert_or_assign(history.id, std::move(history.province));
 	}
 	Log(LogLevel::Info) << ">> Loaded " << provinces.size() << " province definitions.";
 	if (invasion)
 	{
-		fileNames = commonItems::GetAllFilesInFolder("configurables/sunset/history/provinces/");
-		for (const auto& fileName: fileNames)
+		// Overlays for the same province stay on one thread and in filename order.
+		std::vector<std::pair<std::shared_ptr<Province>, std::vector<std::string>>> overlays;
+		std::map<int, std::size_t> overlayPositions;
+		for (const auto& fileName: commonItems::GetAllFilesInFolder("configurables/sunset/history/provinces/"))
 		{
 			if (fileName.find(".txt") == std::string::npos)
 				continue;
 			auto id = std::stoi(fileName);
 			const auto& provinceItr = provinces.find(id);
-			if (provinceItr != provinces.end())
-				provinceItr->second->updateWith("configurables/sunset/history/provinces/" + fileName);
-		}
-	}
+			if (provinceItr == provinces.end())
+				continue;
+			const auto [position, inserted] = overlayPositions.emplace(id, overlays.size());
+			if (inserted)
+				overlays.emplace_back(provinceItr->second, std::vector<std::string>());
+			overlays[position->second].second.emplace_back("configurables/sunset/history/provinces/" + fileName);
+		}
+		CK2::forEachSlice(
+			 overlays.size(),
+			 [&overlays](const std::size_t first, const std::size_t last) {
+				 for (auto overlay = overlays.begin() + first; overlay != overlays.begin() + last; ++overlay)
+					 for (const auto& filePath: overlay->second)
+						 overlay->first->updateWith(filePath);
+			 },
+			 historyFilesPerSlice);
+	}
+
+	if (!cacheKey.empty())
+		saveVanillaCache([&cacheKey, &provinces] {
+			VanillaCache::saveProvinces(provincesCachePath, cacheKey, provinces);
+		});
 }
 
 void EU4::World::importCK2Countries(Configuration::STARTDATE startDateOption, const CK2::World& sourceWorld)
 {
 	Log(LogLevel::Info) << "-> Importing CK2 Countries";
 
+	// Every holder's capital is mapped once, for tags, country setup and later the provinces and capital checks.
+	capitals.build(sourceWorld, *provinceMapper);
+
 	// countries holds all tags imported from EU4. We'll now overwrite some and
-	// add new ones from ck2 titles.
-	for (const auto& title: sourceWorld.getIndepTitles())
-	{
-		if (title.first.find("e_") != 0)
-			continue;
-		importCK2Country(title, startDateOption, sourceWorld);
-	}
-	for (const auto& title: sourceWorld.getIndepTitles())
-	{
-		if (title.first.find("k_") != 0)
-			continue;
-		importCK2Country(title, startDateOption, sourceWorld);
-	}
-	for (const auto& title: sourceWorld.getIndepTitles())
-	{
-		if (title.first.find("d_") != 0)
-			continue;
-		importCK2Country(title, startDateOption, sourceWorld);
-	}
+	// add new ones from ck2 titles, empires first and counties last.
+	std::map<CK2::Title::RANK, std::vector<std::pair<std::string, std::shared_ptr<CK2::Title>>>> titlesByRank;
 	for (const auto& title: sourceWorld.getIndepTitles())
-	{
-		if (title.first.find("c_") != 0)
-			continue;
-		importCK2Country(title, startDateOption, sourceWorld);
-	}
+		titlesByRank[title.second->getRank()].emplace_back(title);
+
+	// The tag mapper hands out tags first come, first served, so tags are assigned one title at a time in rank order.
+	// Setting a country up from its title only reads the mappers and the CK2 world, so that part runs side by side.
+	// A tag several titles map to (the Pope's) takes its titles in order on one thread, as the first one's names and
+	// colors stick.
+	std::vector<CountryImport> imports;
+	std::map<std::string, std::size_t> importPositions;
+	for (const auto rank: {CK2::Title::RANK::EMPIRE, CK2::Title::RANK::KINGDOM, CK2::Title::RANK::DUCHY, CK2::Title::RANK::COUNTY})
+		for (const auto& title: titlesByRank[rank])
+		{
+			auto [tag, country] = assignCK2Country(title);
+			const auto [position, inserted] = importPositions.emplace(tag, imports.size());
+			if (inserted)
+				imports.emplace_back(CountryImport{std::move(tag), std::move(country)});
+			imports[position->second].titles.emplace_back(title.second);
+		}
+
+	CK2::forEachSlice(
+		 imports.size(),
+		 [this, &imports, startDateOption, &sourceWorld](const std::size_t first, const std::size_t last) {
+			 for (auto countryImport = imports.begin() + first; countryImport != imports.begin() + last; ++countryImport)
+				 for (const auto& title: countryImport->titles)
+					 countryImport->country->initializeFromTitle(countryImport->tag,
+						  title,
+						  governmentsMapper,
+						  religionMapper,
+						  cultureMapper,
+						  capitals,
+						  colorScraper,
+						  localizationMapper,
+						  rulerPersonalitiesMapper,
+						  startDateOption,
+						  sourceWorld.getConversionDate());
+		 },
+		 16);
 	Log(LogLevel::Info) << ">> " << countries.size() << " total countries recognized.";
 }
 
-void EU4::World::importCK2Country(const std::pair<std::string, std::shared_ptr<CK2::Title>>& title,
-	 Configuration::STARTDATE startDateOption,
-	 const CK2::World& sourceWorld)
+std::pair<std::string, std::shared_ptr<EU4::Country>> EU4::World::assignCK2Country(const std::pair<std::string, std::shared_ptr<CK2::Title>>& title)
 {
 	// Grabbing the capital, if possible
-	int eu4CapitalID = 0;
-	const auto& ck2CapitalID = title.second->getHolder().second->getCapitalProvince().first;
-	if (ck2CapitalID)
-	{
-		const auto& capitalMatch = provinceMapper->getEU4ProvinceNumbers(ck2CapitalID);
-		if (!capitalMatch.empty())
-			eu4CapitalID = *capitalMatch.begin();
-	}
+	const auto eu4CapitalID = capitals.firstEU4Province(title.second->getHolder().first);
 
 	// Mapping the title to a tag
 	// The Pope is Special! This is land /owned by/ a pope, but might be e_france or k_jerusalem.
@@ -1642,93 +1858,94 @@ void EU4::World::importCK2Country(const std::pair<std::string, std::shared_ptr<C
 	if (!tag)
 		throw std::runtime_error("Title " + title.first + " could not be mapped!");
 
-	// Locating appropriate existing country
-	const auto& countryItr = countries.find(*tag);
-	if (countryItr != countries.end())
-	{
-		countryItr->second->initializeFromTitle(*tag,
-			 title.second,
-			 governmentsMapper,
-			 religionMapper,
-			 cultureMapper,
-			 *provinceMapper,
-			 colorScraper,
-			 localizationMapper,
-			 rulerPersonalitiesMapper,
-			 startDateOption,
-			 sourceWorld.getConversionDate());
-		title.second->registerEU4Tag(std::pair(*tag, countryItr->second));
-	}
-	else
-	{
-		// Otherwise create the country
-		auto newCountry = std::make_shared<Country>();
-		newCountry->initializeFromTitle(*tag,
-			 title.second,
-			 governmentsMapper,
-			 religionMapper,
-			 cultureMapper,
-			 *provinceMapper,
-			 colorScraper,
-			 localizationMapper,
-			 rulerPersonalitiesMapper,
-			 startDateOption,
-			 sourceWorld.getConversionDate());
-		title.second->registerEU4Tag(std::pair(*tag, newCountry));
-		countries.insert(std::pair(*tag, newCountry));
-	}
+	// Locating appropriate existing country, otherwise creating it
+	auto& country = countries[*tag];
+	if (!country)
+		country = std::make_shared<Country>();
+	title.second->registerEU4Tag(std::pair(*tag, country.get()));
+	return std::pair(*tag, country);
 }
 
 void EU4::World::importCK2Provinces(const CK2::World& sourceWorld)
 {
 	Log(LogLevel::Info) << "-> Importing CK2 Provinces";
 
-	auto counter = 0;
-	// CK2 provinces map to a subset of eu4 provinces. We'll only rewrite those we are responsible for.
+	// Every CK2 province is weighed once here, however many EU4 provinces it is offered to.
+	const auto claims = weighCK2Provinces(sourceWorld, capitals);
+
+	std::atomic counter = 0;
+	// CK2 provinces map to a subset of eu4 provinces. We'll only rewrite those we are responsible for. Each eu4 province
+	// only writes to itself, so they go side by side.
+	CK2::forEachSlice(
+		 provinces.size(),
+		 [this, &claims, &counter](const std::size_t first, const std::size_t last) {
+			 for (auto index = first; index < last; ++index)
+			 {
+				 const auto& province = *(provinces.begin() + static_cast<std::ptrdiff_t>(index));
+				 const auto& ck2Provinces = provinceMapper->getCK2ProvinceNumbers(province.first);
+				 // Provinces we're not affecting will not be in this list.
+				 if (ck2Provinces.empty())
+					 continue;
+				 // Next, we find what province to use as its initializing source.
+				 const auto& sourceProvince = determineProvinceSource(ck2Provinces, claims);
+				 if (!sourceProvince)
+				 {
+					 continue; // MISMAP, or simply have mod provinces loaded we're not using.
+				 }
+				 if (sourceProvince->first == -1)
+				 {
+					 province.second->sterilize(); // sterilizing wastelands
+				 }
+				 else
+				 {
+					 province.second->initializeFromCK2(sourceProvince->second, cultureMapper, religionMapper);
+				 }
+				 // And finally, initialize it.
+				 ++counter;
+			 }
+		 },
+		 256);
+
+	// Several eu4 provinces can share a source. Its wonder goes to the first of them, as it always has.
 	for (const auto& province: provinces)
-	{
-		const auto& ck2Provinces = provinceMapper->getCK2ProvinceNumbers(province.first);
-		// Provinces we're not affecting will not be in this list.
-		if (ck2Provinces.empty())
-			continue;
-		// Next, we find what province to use as its initializing source.
-		const auto& sourceProvince = determineProvinceSource(ck2Provinces, sourceWorld);
-		if (!sourceProvince)
-		{
-			continue; // MISMAP, or simply have mod provinces loaded we're not using.
-		}
-		if (sourceProvince->first == -1)
-		{
-			province.second->sterilize(); // sterilizing wastelands
-		}
-		else
-		{
-			province.second->initializeFromCK2(sourceProvince->second, cultureMapper, religionMapper);
-		}
-		// And finally, initialize it.
-		counter++;
-	}
-	Log(LogLevel::Info) << ">> " << sourceWorld.getProvinces().size() << " CK2 provinces imported into " << counter << " EU4 provinces.";
+		province.second->spendSourceWonders();
+	Log(LogLevel::Info) << ">> " << sourceWorld.getProvinces().size() << " CK2 provinces imported into " << counter.load() << " EU4 provinces.";
 }
 
 void EU4::World::assignAllCountryReforms()
 {
-	for (const auto& country: countries)
-	{
+	forEachCountry(COUNTRY_PASS::PER_COUNTRY, [this](const auto& country) {
 		if (country.second->getTitle().first.empty() || !country.second->getGovernmentReforms().empty())
-			continue;
+			return;
 		country.second->assignReforms(regionMapper);
-	}
+	});
 }
 
-void EU4::World::importVanillaCountries(const std::string& eu4Path, bool invasion)
+void EU4::World::importVanillaCountries(const std::string& eu4Path,
+	 const bool invasion,
+	 const std::string& cacheKey,
+	 parsing::NameMap<std::shared_ptr<Country>>& countries,
+	 std::set<std::string>& specialCountryTags)
 {
 	Log(LogLevel::Info) << "-> Importing Vanilla Countries";
+	if (!cacheKey.empty())
+	{
+		const auto loaded = VanillaCache::loadCountries(countriesCachePath, cacheKey, countries, specialCountryTags);
+		++CK2::Metrics::lookups("vanilla_cache", loaded);
+		if (loaded)
+		{
+			Log(LogLevel::Info) << "<> Loaded " << countries.size() << " countries from " << countriesCachePath;
+			return;
+		}
+		countries.clear();
+		specialCountryTags.clear();
+	}
+
 	// ---- Loading common/countries/
 	std::ifstream eu4CountriesFile(fs::u8path(eu4Path + "/common/country_tags/00_countries.txt"));
 	if (!eu4CountriesFile.is_open())
 		throw std::runtime_error("Could not open " + eu4Path + "/common/country_tags/00_countries.txt!");
-	loadCountriesFromSource(eu4CountriesFile, eu4Path, true);
+	loadCountriesFromSource(eu4CountriesFile, eu4Path, true, countries, specialCountryTags);
 	eu4CountriesFile.close();
 	if (commonItems::DoesFolderExist("blankMod/output/common/country_tags/"))
 	{
@@ -1738,7 +1955,7 @@ void EU4::World::importVanillaCountries(const std::string& eu4Path, bool invasio
 			std::ifstream blankCountriesFile(fs::u8path("blankMod/output/common/country_tags/" + file));
 			if (!blankCountriesFile.is_open())
 				throw std::runtime_error("Could not open blankMod/output/common/country_tags/" + file + "!");
-			loadCountriesFromSource(blankCountriesFile, "blankMod/output/", false);
+			loadCountriesFromSource(blankCountriesFile, "blankMod/output/", false, countries, specialCountryTags);
 			blankCountriesFile.close();
 		}
 	}
@@ -1748,7 +1965,7 @@ void EU4::World::importVanillaCountries(const std::string& eu4Path, bool invasio
 		std::ifstream sunset(fs::u8path("configurables/sunset/common/country_tags/zz_countries.txt"));
 		if (!sunset.is_open())
 			throw std::runtime_error("Could not open configurables/sunset/common/country_tags/zz_countries.txt!");
-		loadCountriesFromSource(sunset, "configurables/sunset/", true);
+		loadCountriesFromSource(sunset, "configurables/sunset/", true, countries, specialCountryTags);
 		sunset.close();
 	}
 
@@ -1756,35 +1973,64 @@ void EU4::World::importVanillaCountries(const std::string& eu4Path, bool invasio
 
 	Log(LogLevel::Info) << "-> Importing Vanilla Country History";
 	// ---- Loading history/countries/
+	// Each country replays its files in the usual vanilla -> blankMod -> sunset order on one thread; different
+	// countries load side by side.
+	struct HistoryFile
+	{
+		std::string filePath;
+		bool sunset = false;
+	};
+	std::vector<std::pair<std::shared_ptr<Country>, std::vector<HistoryFile>>> histories;
+	std::map<std::string, std::size_t> historyPositions;
+	const auto queueHistory = [&countries, &histories, &historyPositions](const std::string& tag, HistoryFile historyFile) {
+		const auto [position, inserted] = historyPositions.emplace(tag, histories.size());
+		if (inserted)
+			histories.emplace_back(countries[tag], std::vector<HistoryFile>());
+		histories[position->second].second.emplace_back(std::move(historyFile));
+	};
 	auto fileNames = commonItems::GetAllFilesInFolder(eu4Path + "/history/countries/");
 	for (const auto& fileName: fileNames)
-	{
-		auto tag = fileName.substr(0, 3);
-		countries[tag]->loadHistory(eu4Path + "/history/countries/" + fileName);
-	}
+		queueHistory(fileName.substr(0, 3), {eu4Path + "/history/countries/" + fileName});
 	// Now our special tags.
 	fileNames = commonItems::GetAllFilesInFolder("blankMod/output/history/countries/");
 	for (const auto& fileName: fileNames)
-	{
-		auto tag = fileName.substr(0, 3);
-		countries[tag]->loadHistory("blankMod/output/history/countries/" + fileName);
-	}
+		queueHistory(fileName.substr(0, 3), {"blankMod/output/history/countries/" + fileName});
 	if (invasion)
 	{
 		fileNames = commonItems::GetAllFilesInFolder("configurables/sunset/history/countries/");
 		for (const auto& fileName: fileNames)
-		{
-			auto tag = fileName.substr(0, 3);
-			countries[tag]->setSunsetCountry(true);
-			countries[tag]->clearHistoryLessons();
-			countries[tag]->loadHistory("configurables/sunset/history/countries/" + fileName);
-		}
-	}
+			queueHistory(fileName.substr(0, 3), {"configurables/sunset/history/countries/" + fileName, true});
+	}
+	CK2::forEachSlice(
+		 histories.size(),
+		 [&histories](const std::size_t first, const std::size_t last) {
+			 for (auto history = histories.begin() + first; history != histories.begin() + last; ++history)
+				 for (const auto& historyFile: history->second)
+				 {
+					 if (historyFile.sunset)
+					 {
+						 history->first->setSunsetCountry(true);
+						 history->first->clearHistoryLessons();
+					 }
+					 history->first->loadHistory(historyFile.filePath);
+				 }
+		 },
+		 historyFilesPerSlice);
 	Log(LogLevel::Info) << ">> Loaded " << fileNames.size() << " history files.";
+
+	if (!cacheKey.empty())
+		saveVanillaCache([&cacheKey, &countries, &specialCountryTags] {
+			VanillaCache::saveCountries(countriesCachePath, cacheKey, countries, specialCountryTags);
+		});
 }
 
-void EU4::World::loadCountriesFromSource(std::istream& theStream, const std::string& sourcePath, bool isVanillaSource)
+void EU4::World::loadCountriesFromSource(std::istream& theStream,
+	 const std::string& sourcePath,
+	 const bool isVanillaSource,
+	 parsing::NameMap<std::shared_ptr<Country>>& countries,
+	 std::set<std::string>& specialCountryTags)
 {
+	std::vector<std::pair<std::string, std::string>> definitions; // tag, common file
 	while (!theStream.eof())
 	{
 		std::string line;
@@ -1799,68 +2045,93 @@ void EU4::World::loadCountriesFromSource(std::istream& theStream, const std::str
 		auto countryLine = line.substr(quoteLoc + 1, line.length());
 		quoteLoc = countryLine.find_last_of('\"');
 		countryLine = countryLine.substr(0, quoteLoc);
-		const auto filePath = sourcePath + "/common/" + countryLine;
+		definitions.emplace_back(std::move(tag), sourcePath + "/common/" + countryLine);
+	}
 
+	// The common files parse in parallel; the merge below runs in file order so later lines still win.
+	std::vector<std::shared_ptr<Country>> newCountries(definitions.size());
+	CK2::forEachSlice(
+		 definitions.size(),
+		 [&definitions, &newCountries](const std::size_t first, const std::size_t last) {
+			 for (auto definition = first; definition < last; ++definition)
+				 newCountries[definition] = std::make_shared<Country>(definitions[definition].first, definitions[definition].second);
+		 },
+		 historyFilesPerSlice);
+
+	for (std::size_t definition = 0; definition < definitions.size(); ++definition)
+	{
+		const auto& tag = definitions[definition].first;
 		// We're soaking up all vanilla countries with all current definitions.
-		const auto newCountry = std::make_shared<Country>(tag, filePath);
 		if (countries.count(tag))
-			countries[tag] = newCountry; // Overriding vanilla EU4 with our definitions.
+			countries[tag] = newCountries[definition]; // Overriding vanilla EU4 with our definitions.
 		else
-			countries.insert(std::make_pair(tag, newCountry));
+			countries.insert(std::make_pair(tag, newCountries[definition]));
 		if (!isVanillaSource)
 			specialCountryTags.insert(tag);
 	}
 }
 
-
-std::optional<std::pair<int, std::shared_ptr<CK2::Province>>> EU4::World::determineProvinceSource(const std::vector<int>& ck2ProvinceNumbers,
-	 const CK2::World& sourceWorld) const
+std::unordered_map<int, EU4::World::ProvinceClaim> EU4::World::weighCK2Provinces(const CK2::World& sourceWorld, const CapitalTable& capitals)
 {
-	// determine ownership by province development.
-	std::map<std::string, std::vector<std::shared_ptr<CK2::Province>>> theClaims; // title, offered province sources
-	std::map<std::string, int> theShares;														// title, development
-	std::string winner;
-	auto maxDev = -1;
-
-	for (auto ck2ProvinceID: ck2ProvinceNumbers)
+	std::unordered_map<int, ProvinceClaim> claims;
+	claims.reserve(sourceWorld.getProvinces().size());
+	for (const auto& [ck2ProvinceID, ck2Province]: sourceWorld.getProvinces())
 	{
-		const auto& ck2province = sourceWorld.getProvinces().find(ck2ProvinceID);
-		if (ck2province == sourceWorld.getProvinces().end())
-		{
-			continue; // Broken mapping, or loaded a mod changing provinces without using it.
-		}
-		auto ownerTitle = ck2province->second->getTitle().first;
-		if (ownerTitle.empty())
-		{
-			// This is a wasteland. It means we must blank the eu4 province, no questions asked!
-			return std::pair(-1, nullptr);
-		}
-		theClaims[ownerTitle].push_back(ck2province->second);
-		theShares[ownerTitle] = lround(ck2province->second->getBuildingWeight());
+		auto& claim = claims[ck2ProvinceID];
+		claim.province = ck2Province;
+		claim.title = ck2Province->getTitle().first;
+		if (claim.title.empty())
+			continue; // A wasteland, it blanks whatever eu4 province it maps into.
+		claim.weight = ck2Province->getBuildingWeight();
 
 		// While at it, is this province especially important? Enough so we'd sidestep regular rules?
 		// Check for capital provinces
-		if (ck2province->second->getTitle().second->getHolder().second->getCapitalProvince().first == ck2province->first)
+		const auto& title = ck2Province->getTitle().second;
+		const auto isCapital = capitals.isCapital(title->getHolder().first, ck2ProvinceID);
+		if (isCapital)
 		{
 			// This is the someone's capital, don't assign it away if unnecessary.
-			theShares[ownerTitle] += 200; // Dev can go up to 300+, so yes, assign it away if someone has overbuilt a nearby province.
+			claim.weight += 200; // Dev can go up to 300+, so yes, assign it away if someone has overbuilt a nearby province.
 		}
 		// Check for a wonder. For multiple wonders, sorry, only last one will prevail.
-		if (ck2province->second->getWonder())
+		if (ck2Province->getWonder())
 		{
 			// This is the someone's wonder province.
-			theShares[ownerTitle] += 500;
+			claim.weight += 500;
 		}
 		// Check for HRE emperor
-		if (ck2province->second->getTitle().second->isHREEmperor())
+		if (isCapital && title->isHREEmperor())
 		{
-			const auto& emperor = ck2province->second->getTitle().second->getHolder().second;
-			if (emperor->getCapitalProvince().first == ck2province->first)
-			{
-				// This is the empire capital, never assign it away.
-				theShares[ownerTitle] += 999;
-			}
+			// This is the empire capital, never assign it away.
+			claim.weight += 999;
+		}
+	}
+	return claims;
+}
+
+std::optional<std::pair<int, std::shared_ptr<CK2::Province>>> EU4::World::determineProvinceSource(const std::span<const int> ck2ProvinceNumbers,
+	 const std::unordered_map<int, ProvinceClaim>& claims)
+{
+	// determine ownership by province development.
+	std::map<std::string, std::vector<const ProvinceClaim*>> theClaims; // title, offered province sources
+	std::map<std::string, int> theShares;										 // title, development
+	std::string winner;
+	auto maxDev = -1;
+
+	for (auto ck2ProvinceID: ck2ProvinceNumbers)
+	{
+		const auto& claim = claims.find(ck2ProvinceID);
+		if (claim == claims.end())
+		{
+			continue; // Broken mapping, or loaded a mod changing provinces without using it.
 		}
+		if (claim->second.title.empty())
+		{
+			// This is a wasteland. It means we must blank the eu4 province, no questions asked!
+			return std::pair(-1, nullptr);
+		}
+		theClaims[claim->second.title].push_back(&claim->second);
+		theShares[claim->second.title] = claim->second.weight;
 	}
 	// Let's see who the lucky winner is.
 	for (const auto& share: theShares)
@@ -1880,21 +2151,13 @@ std::optional<std::pair<int, std::shared_ptr<CK2::Province>>> EU4::World::determ
 	maxDev = -1; // We can have winning provinces with weight = 0;
 
 	std::pair<int, std::shared_ptr<CK2::Province>> toReturn;
-	for (const auto& province: theClaims[winner])
+	for (const auto* claim: theClaims[winner])
 	{
-		auto provinceWeight = province->getBuildingWeight();
-		if (province->getWonder())
-			provinceWeight += 500;
-		if (province->getTitle().second->getHolder().second->getCapitalProvince().first == province->getID())
-			provinceWeight += 200;
-		if (province->getTitle().second->isHREEmperor() && province->getTitle().second->getHolder().second->getCapitalProvince().first == province->getID())
-			provinceWeight += 999;
-
-		if (provinceWeight > maxDev)
+		if (claim->weight > maxDev)
 		{
-			toReturn.first = province->getID();
-			toReturn.second = province;
-			maxDev = provinceWeight;
+			toReturn.first = claim->province->getID();
+			toReturn.second = claim->province;
+			maxDev = claim->weight;
 		}
 	}
 	if (!toReturn.first || !toReturn.second)
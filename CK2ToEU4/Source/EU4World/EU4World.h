@@ -1,23 +1,18 @@
 #ifndef EU4_WORLD_H
 #define EU4_WORLD_H
 #include "../CK2World/World.h"
-#include "../Mappers/AfricanPassesMapper/AfricanPassesMapper.h"
-#include "../Mappers/ColorScraper/ColorScraper.h"
-#include "../Mappers/CultureMapper/CultureMapper.h"
-#include "../Mappers/DevWeightsMapper/DevWeightsMapper.h"
-#include "../Mappers/GovernmentsMapper/GovernmentsMapper.h"
-#include "../Mappers/LocalizationMapper/LocalizationMapper.h"
-#include "../Mappers/PrimaryTagMapper/PrimaryTagMapper.h"
-#include "../Mappers/ProvinceMapper/ProvinceMapper.h"
-#include "../Mappers/RegionMapper/RegionMapper.h"
-#include "../Mappers/ReligionMapper/ReligionMapper.h"
-#include "../Mappers/RulerPersonalitiesMapper/RulerPersonalitiesMapper.h"
-#include "../Mappers/TitleTagMapper/TitleTagMapper.h"
+#include "../Parsing/NameMap.h"
 #include "ConverterVersion.h"
+#include "Country/CapitalTable.h"
 #include "Country/Country.h"
 #include "Diplomacy/Diplomacy.h"
 #include "Output/outModFile.h"
 #include "Province/EU4Province.h"
+#include "Province/ProvinceOwners.h"
+#include "Province/ProvinceTable.h"
+#include "StaticData.h"
+#include <functional>
+#include <unordered_map>
 
 class Configuration;
 
@@ -28,47 +23,117 @@ class Province;
 
 namespace EU4
 {
+class OutputSink;
+
 class World
 {
   public:
-	World(const CK2::World& sourceWorld, const Configuration& theConfiguration, const commonItems::ConverterVersion& converterVersion);
+	World(const CK2::World& sourceWorld,
+		 const Configuration& theConfiguration,
+		 const commonItems::ConverterVersion& converterVersion,
+		 CK2::PhaseTimings& timings,
+		 StaticData& staticData);
+
+	// Starts importing the vanilla countries and provinces into staticData's images in the background, as for a save
+	// without Sunset Invasion, so they load while the CK2 world builds. A world whose save has the invasion imports
+	// its own. Serial conversions don't prefetch.
+	static void prefetchVanilla(const Configuration& theConfiguration, const commonItems::ConverterVersion& converterVersion, StaticData& staticData);
 
   private:
+	[[nodiscard]] static std::shared_ptr<const StaticData::Mappers> loadMappers(const CK2::World& sourceWorld,
+		 const Configuration& theConfiguration,
+		 CK2::PhaseTimings& timings,
+		 StaticData& staticData);
 	// void loadRegions(const Configuration& theConfiguration); waiting on geography.
-	void importVanillaCountries(const std::string& eu4Path, bool invasion);
-	void loadCountriesFromSource(std::istream& theStream, const std::string& sourcePath, bool isVanillaSource);
-	void importVanillaProvinces(const std::string& eu4Path, bool invasion);
+	// In a batch the first conversion of an install imports, the rest copy its result out of staticData. A lone
+	// conversion copies it out too if it was prefetched.
+	void shareVanillaCountries(const std::string& eu4Path, bool invasion, const std::string& cacheKey, StaticData& staticData);
+	void shareVanillaProvinces(const std::string& eu4Path, bool invasion, const std::string& cacheKey, StaticData& staticData);
+	// These only fill what they're handed, so a prefetch can run them before there's a world.
+	static void importVanillaCountries(const std::string& eu4Path,
+		 bool invasion,
+		 const std::string& cacheKey,
+		 parsing::NameMap<std::shared_ptr<Country>>& countries,
+		 std::set<std::string>& specialCountryTags);
+	static void loadCountriesFromSource(std::istream& theStream,
+		 const std::string& sourcePath,
+		 bool isVanillaSource,
+		 parsing::NameMap<std::shared_ptr<Country>>& countries,
+		 std::set<std::string>& specialCountryTags);
+	static void importVanillaProvinces(const std::string& eu4Path, bool invasion, const std::string& cacheKey, ProvinceTable& provinces);
 	void importCK2Countries(Configuration::STARTDATE startDateOption, const CK2::World& sourceWorld);
-	void importCK2Country(const std::pair<std::string, std::shared_ptr<CK2::Title>>& title,
-		 Configuration::STARTDATE startDateOption,
-		 const CK2::World& sourceWorld);
+	// A country and the titles it takes, in the order they were assigned.
+	struct CountryImport
+	{
+		std::string tag;
+		std::shared_ptr<Country> country;
+		std::vector<std::shared_ptr<CK2::Title>> titles;
+	};
+	// Maps the title to its tag and the country under it, creating the country if there's none yet. Setting the
+	// country up from the title is left to importCK2Countries.
+	std::pair<std::string, std::shared_ptr<Country>> assignCK2Country(const std::pair<std::string, std::shared_ptr<CK2::Title>>& title);
 	void importCK2Provinces(const CK2::World& sourceWorld);
-	void output(const commonItems::ConverterVersion& converterVersion, const Configuration& theConfiguration, const CK2::World& sourceWorld) const;
-	void createModFile(const Configuration& theConfiguration) const;
-	void outputVersion(const commonItems::ConverterVersion& converterVersion, const Configuration& theConfiguration) const;
-	void outputCommonCountriesFile(const Configuration& theConfiguration) const;
-	void outputHistoryCountries(const Configuration& theConfiguration) const;
-	void outputHistoryProvinces(const Configuration& theConfiguration, const std::set<std::string>& premades, const bool& isLeviathanDLCPresent) const;
+	// Runs pendingTransforms while the mod template is laid out, then writes the mod. With a counting output sink
+	// (see OutputSink) only the generated files are serialised, into the sink, and nothing is laid out or copied.
+	void output(const commonItems::ConverterVersion& converterVersion,
+		 const Configuration& theConfiguration,
+		 const CK2::World& sourceWorld,
+		 const std::function<void()>& pendingTransforms) const;
+	void outputMod(const commonItems::ConverterVersion& converterVersion,
+		 const Configuration& theConfiguration,
+		 const CK2::World& sourceWorld,
+		 OutputSink& sink) const;
+	void createModFile(const Configuration& theConfiguration, OutputSink& sink) const;
+	void outputArchive(const Configuration& theConfiguration) const;
+	void outputManifest(const Configuration& theConfiguration) const;
+	void outputVersion(const commonItems::ConverterVersion& converterVersion, const Configuration& theConfiguration, OutputSink& sink) const;
+	void outputCommonCountriesFile(const Configuration& theConfiguration, OutputSink& sink) const;
+	void outputHistoryCountries(const Configuration& theConfiguration, OutputSink& sink) const;
+	void outputHistoryProvinces(const Configuration& theConfiguration,
+		 const std::set<std::string>& premades,
+		 const bool& isLeviathanDLCPresent,
+		 OutputSink& sink) const;
 	void outputInvasionExtras(const Configuration& theConfiguration, bool invasion) const;
-	void outputCommonCountries(const Configuration& theConfiguration) const;
-	void outputLocalization(const Configuration& theConfiguration, bool invasion, bool greekReformation) const;
-	void verifyReligionsAndCultures();
+	void outputCommonCountries(const Configuration& theConfiguration, OutputSink& sink) const;
+	void outputLocalization(const Configuration& theConfiguration, bool invasion, bool greekReformation, OutputSink& sink) const;
+	// What a pass over the countries may touch. PER_COUNTRY passes read and write nothing but the country they're
+	// handed, the provinces it owns and read-only shared data, so they run across all cores. CROSS_COUNTRY passes reach
+	// into other countries or change the source world, and go one country at a time in tag order.
+	enum class COUNTRY_PASS
+	{
+		PER_COUNTRY,
+		CROSS_COUNTRY
+	};
+	void forEachCountry(COUNTRY_PASS pass, const std::function<void(const std::pair<const std::string, std::shared_ptr<Country>>& country)>& work);
+	void verifyReligionsAndCultures(const Configuration& theConfiguration);
 	void linkProvincesToCountries();
 	void outputFlags(const Configuration& theConfiguration, const CK2::World& sourceWorld) const;
 	void outputBookmark(const Configuration& theConfiguration, date conversionDate) const;
 	void distributeHRESubtitles(const Configuration& theConfiguration);
-	void outputEmperor(const Configuration& theConfiguration, date conversionDate) const;
+	void outputEmperor(const Configuration& theConfiguration, date conversionDate, OutputSink& sink) const;
 	void outputDynamicInstitutions(const Configuration& theConfiguration) const;
-	void setElectors();
-	void setFreeCities();
-	void outputDiplomacy(const Configuration& theConfiguration, const std::vector<std::shared_ptr<Agreement>>& agreements, bool invasion) const;
+	// The HRE's members in tag order, gathered once for the free city and elector passes, with a bit per member for
+	// whether its CK2 title was flagged an electorate and one for whether it's someone's junior partner.
+	struct HREMembers
+	{
+		std::vector<std::pair<std::string, std::shared_ptr<Country>>> countries;
+		std::vector<bool> electorates;
+		std::vector<bool> juniors;
+	};
+	[[nodiscard]] HREMembers gatherHREMembers() const;
+	void setElectors(const HREMembers& members);
+	void setFreeCities(const HREMembers& members);
+	void outputDiplomacy(const Configuration& theConfiguration,
+		 const std::vector<std::shared_ptr<Agreement>>& agreements,
+		 bool invasion,
+		 OutputSink& sink) const;
 	void outputReformedReligions(const Configuration& theConfiguration,
 		 bool noReformation,
 		 const std::vector<mappers::ReformedReligionMapping>&,
 		 const std::vector<mappers::ReformedReligionMapping>&) const;
 	void resolvePersonalUnions();
 	void importAdvisers(Configuration::STARTDATE startDateOption, date theConversionDate);
-	void outputAdvisers(const Configuration& theConfiguration) const;
+	void outputAdvisers(const Configuration& theConfiguration, OutputSink& sink) const;
 	void alterProvinceDevelopment();
 	void distributeForts();
 	void verifyCapitals();
@@ -77,15 +142,24 @@ class World
 	void siberianQuestion(const Configuration& theConfiguration);
 	void distributeClaims(const Configuration& theConfiguration);
 	void distributeDeadCores();
-	void scrapeColors(const Configuration& theConfiguration, const CK2::World& sourceWorld);
 	void assignAllCountryReforms();
 	void africaQuestion();
 	void indianQuestion();
 	void fixDuplicateNames();
 	void markHRETag(const Configuration& theConfiguration, const std::string& hreTitle);
+	void takeCensus(CK2::PhaseTimings& timings) const; // if timings takes one
 
-	[[nodiscard]] std::optional<std::pair<int, std::shared_ptr<CK2::Province>>> determineProvinceSource(const std::vector<int>& ck2ProvinceNumbers,
-		 const CK2::World& sourceWorld) const;
+	// A CK2 province's say in which title gets the EU4 provinces it maps into: building weight plus its capital,
+	// wonder and HRE capital bonuses. An empty title is a wasteland.
+	struct ProvinceClaim
+	{
+		std::string title;
+		int weight = 0;
+		std::shared_ptr<CK2::Province> province;
+	};
+	[[nodiscard]] static std::unordered_map<int, ProvinceClaim> weighCK2Provinces(const CK2::World& sourceWorld, const CapitalTable& capitals);
+	[[nodiscard]] static std::optional<std::pair<int, std::shared_ptr<CK2::Province>>> determineProvinceSource(std::span<const int> ck2ProvinceNumbers,
+		 const std::unordered_map<int, ProvinceClaim>& claims);
 
 	bool tianxia = false;
 	bool cleanslate = false;
@@ -93,22 +167,26 @@ class World
 	std::string emperorTag;
 	std::string celestialEmperorTag;
 	std::string actualHRETag;
-	std::map<std::string, std::shared_ptr<Country>> countries;
-	std::map<int, std::shared_ptr<Province>> provinces;
-	std::shared_ptr<mappers::RegionMapper> regionMapper;
+	parsing::NameMap<std::shared_ptr<Country>> countries;
+	ProvinceTable provinces;
+	ProvinceOwners provinceOwners; // built when provinces are linked to countries, kept current from there on
+	CapitalTable capitals; // built when CK2 countries are imported
 	std::set<std::string> specialCountryTags; // tags we loaded from own sources and must not output into 00_country_tags.txt
 
-	mappers::ColorScraper colorScraper;
-	std::unique_ptr<mappers::ProvinceMapper> provinceMapper;
+	// Shared with every other conversion of the same setup; only the title tag mapper's claimed tags are ours.
+	std::shared_ptr<const StaticData::Mappers> staticMappers;
+	std::shared_ptr<const mappers::RegionMapper> regionMapper;
+	const mappers::ColorScraper& colorScraper;
+	std::shared_ptr<const mappers::ProvinceMapper> provinceMapper;
 	mappers::TitleTagMapper titleTagMapper;
-	mappers::ReligionMapper religionMapper;
-	mappers::CultureMapper cultureMapper;
-	mappers::GovernmentsMapper governmentsMapper;
-	mappers::LocalizationMapper localizationMapper;
-	mappers::RulerPersonalitiesMapper rulerPersonalitiesMapper;
-	mappers::PrimaryTagMapper primaryTagMapper;
-	mappers::DevWeightsMapper devWeightsMapper;
-	mappers::AfricanPassesMapper africanPassesMapper;
+	const mappers::ReligionMapper& religionMapper;
+	const mappers::CultureMapper& cultureMapper;
+	const mappers::GovernmentsMapper& governmentsMapper;
+	const mappers::LocalizationMapper& localizationMapper;
+	const mappers::RulerPersonalitiesMapper& rulerPersonalitiesMapper;
+	const mappers::PrimaryTagMapper& primaryTagMapper;
+	const mappers::DevWeightsMapper& devWeightsMapper;
+	const mappers::AfricanPassesMapper& africanPassesMapper;
 	ModFile modFile;
 	Diplomacy diplomacy;
 };
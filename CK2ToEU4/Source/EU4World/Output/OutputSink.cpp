@@ -0,0 +1,41 @@
+#include "OutputSink.h"
+#include "../../CK2World/CacheStore.h"
+#include "../../CK2World/Contention.h"
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+CK2::Contention::Site digestWaits("output digests");
+} // namespace
+
+void EU4::OutputSink::write(const std::string& path, const std::string_view contents)
+{
+	if (toDisk())
+	{
+		std::ofstream output(path);
+		if (!output.is_open())
+			throw std::runtime_error("Could not create " + path);
+		output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+		output.close();
+	}
+	else if (kind == Configuration::OUTPUT_SINK::HASH)
+	{
+		auto digest = CK2::CacheStore::digest(contents);
+		const auto lock = CK2::lockAt<std::unique_lock<std::mutex>>(digestWaits, digestsMutex);
+		digests[path] = std::move(digest);
+	}
+	++files;
+	bytes += contents.size();
+}
+
+std::string EU4::OutputSink::getDigest() const
+{
+	const std::lock_guard lock(digestsMutex);
+	if (digests.empty())
+		return {};
+	std::string listing;
+	for (const auto& [path, digest]: digests)
+		listing.append(path).append(" ").append(digest).append("\n");
+	return CK2::CacheStore::digest(listing);
+}
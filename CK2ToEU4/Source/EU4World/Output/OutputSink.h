@@ -0,0 +1,40 @@
+#ifndef EU4_OUTPUT_SINK_H
+#define EU4_OUTPUT_SINK_H
+#include "../../Configuration/Configuration.h"
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace EU4
+{
+// Where the dump's generated files go. On disk each one is written to its path. A counting sink takes each file just
+// as the dump would have written it and only counts the files and bytes; a hashing one also keeps a digest of each, so
+// two builds can be checked for the same output. Neither touches the filesystem, which leaves transform and writer
+// throughput to be benchmarked apart from the disk's through the very same serialisation. Safe to write to from the
+// dump's worker threads.
+class OutputSink
+{
+  public:
+	explicit OutputSink(Configuration::OUTPUT_SINK theKind = Configuration::OUTPUT_SINK::DISK): kind(theKind) {}
+
+	void write(const std::string& path, std::string_view contents);
+
+	[[nodiscard]] bool toDisk() const { return kind == Configuration::OUTPUT_SINK::DISK; }
+	[[nodiscard]] std::size_t getFiles() const { return files; }
+	[[nodiscard]] std::size_t getBytes() const { return bytes; }
+	// Of every path and digest in path order, so it doesn't depend on which thread wrote what first. Empty unless hashing.
+	[[nodiscard]] std::string getDigest() const;
+
+  private:
+	Configuration::OUTPUT_SINK kind;
+	std::atomic<std::size_t> files = 0;
+	std::atomic<std::size_t> bytes = 0;
+	mutable std::mutex digestsMutex;
+	std::map<std::string, std::string> digests; // path -> digest of its contents, hashing only
+};
+} // namespace EU4
+
+#endif // EU4_OUTPUT_SINK_H
@@ -0,0 +1,48 @@
+#include "TextBuffer.h"
+#include "../../Parsing/Win1252.h"
+#include "../Country/Tag.h"
+#include "Color.h"
+#include "Date.h"
+#include <sstream>
+
+EU4::TextBuffer& EU4::TextBuffer::operator<<(const double number)
+{
+	// A default stream is %g with a precision of 6.
+	char digits[32];
+	const auto end = std::to_chars(digits, digits + sizeof digits, number, std::chars_format::general, 6).ptr;
+	buffer.append(digits, end);
+	return *this;
+}
+
+EU4::TextBuffer& EU4::TextBuffer::operator<<(const date& theDate)
+{
+	buffer.append(theDate.toString());
+	return *this;
+}
+
+EU4::TextBuffer& EU4::TextBuffer::operator<<(const Tag& tag)
+{
+	buffer.append(tag.str());
+	return *this;
+}
+
+EU4::TextBuffer& EU4::TextBuffer::operator<<(const commonItems::Color& color)
+{
+	// Two per country at most, not worth duplicating commonItems' formatting.
+	std::ostringstream output;
+	output << color;
+	buffer.append(output.str());
+	return *this;
+}
+
+EU4::TextBuffer& EU4::TextBuffer::forThisThread()
+{
+	thread_local TextBuffer threadBuffer;
+	threadBuffer.clear();
+	return threadBuffer;
+}
+
+void EU4::TextBuffer::appendWin1252(const std::string_view text)
+{
+	parsing::appendWin1252AsUTF8(buffer, text);
+}
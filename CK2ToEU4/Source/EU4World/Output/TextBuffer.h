@@ -0,0 +1,63 @@
+#ifndef EU4_TEXT_BUFFER_H
+#define EU4_TEXT_BUFFER_H
+#include <charconv>
+#include <concepts>
+#include <string>
+#include <string_view>
+
+class date;
+namespace commonItems
+{
+class Color;
+}
+
+namespace EU4
+{
+class Tag;
+
+// Builds one history or commons file in a plain string. The writers push hundreds of short fragments per file, and
+// going through std::ostream pays for a sentry and a locale lookup on each of them. Numbers go through to_chars, which
+// prints integers and doubles exactly as a default-formatted stream does, so the files come out byte for byte the same.
+class TextBuffer
+{
+  public:
+	TextBuffer& operator<<(const std::string_view text)
+	{
+		buffer.append(text);
+		return *this;
+	}
+	TextBuffer& operator<<(const char* text) { return *this << std::string_view(text); }
+	TextBuffer& operator<<(const char character)
+	{
+		buffer.push_back(character);
+		return *this;
+	}
+	template <std::integral Number> TextBuffer& operator<<(const Number number)
+	{
+		char digits[24];
+		const auto end = std::to_chars(digits, digits + sizeof digits, number).ptr;
+		buffer.append(digits, end);
+		return *this;
+	}
+	TextBuffer& operator<<(bool) = delete; // a stream prints 0 or 1, which no field wants
+	TextBuffer& operator<<(double number);
+	TextBuffer& operator<<(const date& theDate);
+	TextBuffer& operator<<(const Tag& tag);
+	TextBuffer& operator<<(const commonItems::Color& color);
+	// Save text is Windows-1252; the localisation files are UTF-8.
+	void appendWin1252(std::string_view text);
+
+	[[nodiscard]] const std::string& str() const { return buffer; }
+	void clear() { buffer.clear(); }
+	void reserve(const std::size_t size) { buffer.reserve(size); }
+
+	// One buffer per worker thread, emptied but keeping its capacity, so writing a file allocates nothing once the
+	// largest one so far has been seen.
+	[[nodiscard]] static TextBuffer& forThisThread();
+
+  private:
+	std::string buffer;
+};
+} // namespace EU4
+
+#endif // EU4_TEXT_BUFFER_H
@@ -6,7 +6,8 @@
 
 namespace EU4
 {
-std::ostream& operator<<(std::ostream& output, const Country& country);
-std::ostream& operator<<(std::ostream& output, const Character& character);
+class TextBuffer;
+TextBuffer& operator<<(TextBuffer& output, const Country& country);
+TextBuffer& operator<<(TextBuffer& output, const Character& character);
 } // namespace EU4
 #endif // OUT_COUNTRY_H
\ No newline at end of file
@@ -1,7 +1,73 @@
 #include "outMonument.h"
-#include <fstream>
 
-EU4::outMonument::outMonument(const Configuration& theConfiguration, std::optional<std::pair<int, std::shared_ptr<CK2::Wonder>>> wonder, const int eu4Province)
+EU4::outMonument::outMonument(const Configuration& theConfiguration, const std::set<std::string>& premades)
+{
+	if (premades.contains("wonder_pyramid_giza"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/103_pyramids_of_cheops.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/103_pyramids_of_cheops.txt");
+	if (premades.contains("wonder_pagan_stones_stonehenge"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/104_stonehenge.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/104_stonehenge.txt");
+	if (premades.contains("wonder_mausoleum_halicarnassus"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/105_mausoleum_at_helicarnassus.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/105_mausoleum_at_helicarnassus.txt");
+	if (premades.contains("wonder_lighthouse_alexandria"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/106_lighthouse_of_alexandria.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/106_lighthouse_of_alexandria.txt");
+	if (premades.contains("wonder_temple_hindu_konark"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/107_hindu_konark.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/107_hindu_konark.txt");
+	if (premades.contains("wonder_apostolic_palace"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/108_apostolic_palace.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/108_apostolic_palace.txt");
+	if (premades.contains("wonder_house_of_wisdom"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/109_house_of_wisdom.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/109_house_of_wisdom.txt");
+	if (premades.contains("wonder_underground_city_petra"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/110_petra.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/110_petra.txt");
+	if (premades.contains("wonder_cathedral_hagia_sophia"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/111_hagia_sophia.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/111_hagia_sophia.txt");
+	if (premades.contains("wonder_cathedral_notre_dame"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/112_notre_dames.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/112_notre_dames.txt");
+	// Wonders from Tianxia
+
+	if (premades.contains("wonder_temple_cemetery_confucius"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/113_temple_of_confucius.txt", // I know that these two aren't the same monument, but they
+																																	  // are extremely close and related to one another
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/113_temple_of_confucius.txt");
+	if (premades.contains("wonder_shinto_grand_shrine_ise"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/114_jingu.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/114_jingu.txt");
+	if (premades.contains("wonder_temple_buddhist_seokguram_bulguksa"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/115_bulguksa_temple.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/115_bulguksa_temple.txt");
+	if (premades.contains("wonder_temple_hindu_angkor_wat"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/116_angkor_wat.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/116_angkor_wat.txt");
+	if (premades.contains("wonder_temple_buddhist_borobudur"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/117_borobudur_temple.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/117.txt");
+	if (premades.contains("wonder_temple_buddhist_shwedagon"))
+		commonItems::TryCopyFile("configurables/monuments/great_projects/118_shwedagon_temple.txt",
+			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/118_shwedagon_temple.txt");
+
+
+	// Dynamic monuments are appended to these as provinces are written out.
+	monumentsOutput.open("output/" + theConfiguration.getOutputName() + "/common/great_projects/!00_converted_monuments.txt", std::ios::out | std::ios::app);
+	if (!monumentsOutput.is_open())
+		throw std::runtime_error(
+			 "Could not create monuments file: output/" + theConfiguration.getOutputName() + "/common/great_projects/!00_converted_monuments.txt");
+	gfxOutput.open("output/" + theConfiguration.getOutputName() + "/interface/zzz_converted_monuments.gfx", std::ios::out | std::ios::app);
+	if (!gfxOutput.is_open())
+		throw std::runtime_error("Could not create monuments file: output/" + theConfiguration.getOutputName() + "/interface/zzz_converted_monuments.gfx");
+	for (const auto& fileName: commonItems::GetAllFilesInFolder("configurables/monuments/localisation/"))
+		locOutputs.emplace_back("output/" + theConfiguration.getOutputName() + "/localisation/" + fileName, std::ios::out | std::ios::app);
+}
+
+void EU4::outMonument::outputMonument(const std::optional<std::pair<int, std::shared_ptr<CK2::Wonder>>>& wonder, const int eu4Province)
 {
 	if (!wonder->second)
 	{
@@ -13,11 +79,8 @@ EU4::outMonument::outMonument(const Configuration& theConfiguration, std::option
 													  wonder->second->getCountryModifiers().empty())) // This is a modded monument, probably better to not convert
 		return;
 
-	std::ofstream output("output/" + theConfiguration.getOutputName() + "/common/great_projects/!00_converted_monuments.txt", std::ios::out | std::ios::app);
-	if (!output.is_open())
-		throw std::runtime_error(
-			 "Could not create monuments file: output/" + theConfiguration.getOutputName() + "/common/great_projects/!00_converted_monuments.txt");
-
+	block.str(std::string());
+	auto& output = block;
 	output << "\n#----------- " << wonder->second->getName() << " -----------\n";
 	output << wonder->second->getType() << "_" << wonder->second->getWonderID() << " = {\n\t";
 	// Base
@@ -120,85 +183,31 @@ EU4::outMonument::outMonument(const Configuration& theConfiguration, std::option
 	output << "\n\t\t}";
 	output << "\n\t}";
 	output << "\n}\n\n#-----------------------------\n\n";
-
-	output.close();
+	monumentsOutput << block.view();
 
 	// Now then, let's populate the GFX file
-	std::ofstream gfxOutput("output/" + theConfiguration.getOutputName() + "/interface/zzz_converted_monuments.gfx", std::ios::out | std::ios::app);
-	if (!gfxOutput.is_open())
-		throw std::runtime_error("Could not create monuments file: output/" + theConfiguration.getOutputName() + "/interface/zzz_converted_monuments.gfx");
-
 	gfxOutput << "spriteType = {\n\t\t";
 	gfxOutput << "name = \"GFX_great_project_" << wonder->second->getType() << "_" << wonder->second->getWonderID() << "\"\n\t\t";
 	gfxOutput << "texturefile = \"gfx//interface//great_projects//" << gfxType(wonder->second->getType()) << "\"\n\t";
 	gfxOutput << "}\n\n\t";
-	gfxOutput.close();
 
 	// Finally, let's populate the localisation
-	auto fileNames = commonItems::GetAllFilesInFolder("configurables/monuments/localisation/");
-	for (const auto& fileName: fileNames)
-	{
-		std::ofstream locOutput("output/" + theConfiguration.getOutputName() + "/localisation/" + fileName, std::ios::out | std::ios::app);
+	for (auto& locOutput: locOutputs)
 		locOutput << wonder->second->getType() << "_" << wonder->second->getWonderID() << ":0 \"" << wonder->second->getName() << "\"\n ";
-		locOutput.close();
-	}
 }
 
-EU4::outMonument::outMonument(const Configuration& theConfiguration, const std::set<std::string>& premades)
+void EU4::outMonument::close()
 {
-	if (premades.contains("wonder_pyramid_giza"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/103_pyramids_of_cheops.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/103_pyramids_of_cheops.txt");
-	if (premades.contains("wonder_pagan_stones_stonehenge"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/104_stonehenge.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/104_stonehenge.txt");
-	if (premades.contains("wonder_mausoleum_halicarnassus"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/105_mausoleum_at_helicarnassus.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/105_mausoleum_at_helicarnassus.txt");
-	if (premades.contains("wonder_lighthouse_alexandria"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/106_lighthouse_of_alexandria.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/106_lighthouse_of_alexandria.txt");
-	if (premades.contains("wonder_temple_hindu_konark"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/107_hindu_konark.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/107_hindu_konark.txt");
-	if (premades.contains("wonder_apostolic_palace"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/108_apostolic_palace.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/108_apostolic_palace.txt");
-	if (premades.contains("wonder_house_of_wisdom"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/109_house_of_wisdom.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/109_house_of_wisdom.txt");
-	if (premades.contains("wonder_underground_city_petra"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/110_petra.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/110_petra.txt");
-	if (premades.contains("wonder_cathedral_hagia_sophia"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/111_hagia_sophia.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/111_hagia_sophia.txt");
-	if (premades.contains("wonder_cathedral_notre_dame"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/112_notre_dames.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/112_notre_dames.txt");
-	// Wonders from Tianxia
-
-	if (premades.contains("wonder_temple_cemetery_confucius"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/113_temple_of_confucius.txt", // I know that these two aren't the same monument, but they
-																																	  // are extremely close and related to one another
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/113_temple_of_confucius.txt");
-	if (premades.contains("wonder_shinto_grand_shrine_ise"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/114_jingu.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/114_jingu.txt");
-	if (premades.contains("wonder_temple_buddhist_seokguram_bulguksa"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/115_bulguksa_temple.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/115_bulguksa_temple.txt");
-	if (premades.contains("wonder_temple_hindu_angkor_wat"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/116_angkor_wat.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/116_angkor_wat.txt");
-	if (premades.contains("wonder_temple_buddhist_borobudur"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/117_borobudur_temple.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/117.txt");
-	if (premades.contains("wonder_temple_buddhist_shwedagon"))
-		commonItems::TryCopyFile("configurables/monuments/great_projects/118_shwedagon_temple.txt",
-			 "output/" + theConfiguration.getOutputName() + "/common/great_projects/118_shwedagon_temple.txt");
+	// Final closing brace for the GFX file
+	gfxOutput << "\n}";
+	monumentsOutput.close();
+	gfxOutput.close();
+	for (auto& locOutput: locOutputs)
+		locOutput.close();
 }
 
+
+
 const std::string EU4::outMonument::gfxType(const std::string& base)
 {
 	if (base == "wonder_cathedral")
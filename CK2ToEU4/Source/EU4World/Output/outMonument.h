@@ -5,17 +5,28 @@
 #include "../../CK2World/World.h"
 #include "../EU4World.h"
 #include "OSCompatibilityLayer.h"
+#include <fstream>
+#include <sstream>
 
 namespace EU4
 {
+// Keeps the shared monument outputs (great projects, gfx, localisation) open for the whole dump, so dynamic monuments
+// are appended through one buffered handle each instead of reopening the files per monument.
 class outMonument
 {
   public:
-	outMonument(const Configuration& theConfiguration, std::optional<std::pair<int, std::shared_ptr<CK2::Wonder>>> wonder,
-		 int eu4Province);																							 // Dynamic Monuments
 	outMonument(const Configuration& theConfiguration, const std::set<std::string>& premades); // Premade Monuments
 
+	void outputMonument(const std::optional<std::pair<int, std::shared_ptr<CK2::Wonder>>>& wonder, int eu4Province); // Dynamic Monuments
+	void close(); // Closes the gfx file, has to be last
+
 	const std::string gfxType(const std::string& base); // Decides which wonder gfx the monument will use.
+
+  private:
+	std::ofstream monumentsOutput;
+	std::ofstream gfxOutput;
+	std::vector<std::ofstream> locOutputs;
+	std::ostringstream block; // reused for every monument
 };
 }; // namespace EU4
 
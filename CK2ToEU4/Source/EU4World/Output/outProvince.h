@@ -5,7 +5,8 @@
 
 namespace EU4
 {
-std::ostream& operator<<(std::ostream& output, const Province& province);
+class TextBuffer;
+TextBuffer& operator<<(TextBuffer& output, const Province& province);
 } // namespace EU4
 
 
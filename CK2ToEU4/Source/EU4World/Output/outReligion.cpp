@@ -2,15 +2,15 @@
 #include <fstream>
 
 EU4::outReligion::outReligion(const Configuration& theConfiguration,
-	 std::vector<mappers::ReformedReligionMapping> unreligionReforms,
-	 std::vector<mappers::ReformedReligionMapping> religionReforms)
+	 const std::vector<mappers::ReformedReligionMapping>& unreligionReforms,
+	 const std::vector<mappers::ReformedReligionMapping>& religionReforms)
 {
 	std::ofstream unReformedReligions("configurables/reformation/dynamicPagans/03_converter_unreformed_religions.txt");
 	if (!unReformedReligions.is_open())
 		throw std::runtime_error("Could not create custom unreformed religions file!");
 
 	unReformedReligions << "pagan = {\n\t";
-	for (auto unreligion: unreligionReforms)
+	for (const auto& unreligion: unreligionReforms)
 	{
 		unReformedReligions << unreligion.getName() << " = {\n"
 								  << "\t\ticon = " << unreligion.getIconNumber() << "\n"
@@ -29,7 +29,7 @@ EU4::outReligion::outReligion(const Configuration& theConfiguration,
 		throw std::runtime_error("Could not create custom reformed religions file!");
 
 	reformedReligions << "pagan = {\n\t";
-	for (auto religion: religionReforms)
+	for (const auto& religion: religionReforms)
 	{
 		reformedReligions << religion.getName() << " = {\n"
 								<< "\t\ticon = " << religion.getIconNumber() << "\n"
@@ -10,8 +10,8 @@ class outReligion
 {
   public:
 	outReligion(const Configuration& theConfiguration,
-		 std::vector<mappers::ReformedReligionMapping> unreligionReforms,
-		 std::vector<mappers::ReformedReligionMapping> religionReforms);
+		 const std::vector<mappers::ReformedReligionMapping>& unreligionReforms,
+		 const std::vector<mappers::ReformedReligionMapping>& religionReforms);
 };
 } // namespace EU4
 
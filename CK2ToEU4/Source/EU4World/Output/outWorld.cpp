@@ -1,104 +1,324 @@
+#include "../../CK2World/Concurrency.h"
+#include "../../CK2World/ModArchive.h"
+#include "../../CK2World/ModFiles.h"
+#include "../../CK2World/Progress.h"
+#include "../../CK2World/SaveGame/Snapshot.h"
+#include "../../CK2World/TaskGraph.h"
 #include "../../CK2World/Titles/Title.h"
+#include "../../CK2World/Trace.h"
 #include "../../Configuration/Configuration.h"
 #include "../EU4World.h"
 #include "Log.h"
 #include "ModLoader/ModLoader.h"
 #include "OSCompatibilityLayer.h"
+#include "OutputSink.h"
+#include "TextBuffer.h"
 #include "outCountry.h"
 #include "outMonument.h"
 #include "outReligion.h"
+#include "zip.h"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <sstream>
 namespace fs = std::filesystem;
 
-void EU4::World::output(const commonItems::ConverterVersion& converterVersion, const Configuration& theConfiguration, const CK2::World& sourceWorld) const
+namespace
 {
-	const auto isLeviathanDLCPresent = sourceWorld.isLeviathanDLCPresent();
-	const auto invasion = sourceWorld.isInvasion();
-	const auto dynamicInstitutions = theConfiguration.getDynamicInstitutions() == Configuration::INSTITUTIONS::DYNAMIC;
-	const date conversionDate = sourceWorld.getConversionDate();
-	Log(LogLevel::Info) << "<- Creating Output Folder";
+// Each file is serialised into its thread's TextBuffer and written in one go. The files don't share anything, so they are
+// spread over forEachSlice slices; a slice this size keeps a thread busy long enough to be worth starting.
+constexpr std::size_t filesPerSlice = 32;
+
+void writeFiles(EU4::OutputSink& sink,
+	 const std::vector<std::string>& filePaths,
+	 const std::string& fileKind,
+	 const std::function<void(std::size_t, EU4::TextBuffer&)>& serialise,
+	 const std::size_t slice = filesPerSlice)
+{
+	CK2::Progress::expect(filePaths.size());
+	CK2::forEachSlice(
+		 filePaths.size(),
+		 [&sink, &filePaths, &fileKind, &serialise](const std::size_t first, const std::size_t last) {
+			 const CK2::TraceSpan span("Writing " + fileKind);
+			 for (auto file = first; file < last; ++file)
+			 {
+				 auto& buffer = EU4::TextBuffer::forThisThread();
+				 serialise(file, buffer);
+				 sink.write(filePaths[file], buffer.str());
+				 CK2::Progress::advance();
+			 }
+		 },
+		 slice);
+}
+
+// Hard links each source to its target where the filesystem allows it and copies otherwise, across forEachSlice slices.
+// Existing targets are removed first rather than written through, they may be links themselves. Sources in a mod
+// archive are inflated into their targets.
+void linkOrCopyFiles(const std::vector<std::pair<std::string, std::string>>& plan)
+{
+	std::vector<std::string> failures(plan.size());
+	CK2::forEachSlice(
+		 plan.size(),
+		 [&plan, &failures](const std::size_t first, const std::size_t last) {
+			 for (auto file = first; file < last; ++file)
+			 {
+				 const auto source = fs::u8path(plan[file].first);
+				 const auto target = fs::u8path(plan[file].second);
+				 std::error_code error;
+				 fs::remove(target, error);
+				 error.clear();
+				 if (CK2::ModArchive::locate(plan[file].first))
+				 {
+					 const auto contents = CK2::readModFile(plan[file].first);
+					 std::ofstream output(target, std::ios::binary);
+					 if (!contents)
+						 failures[file] = "not in the archive";
+					 else if (!output.write(contents->data(), static_cast<std::streamsize>(contents->size())))
+						 failures[file] = "could not write it";
+					 continue;
+				 }
+				 fs::create_hard_link(source, target, error);
+				 if (error)
+				 {
+					 error.clear();
+					 fs::copy_file(source, target, fs::copy_options::overwrite_existing, error);
+				 }
+				 if (error)
+					 failures[file] = error.message();
+			 }
+		 },
+		 filesPerSlice);
+
+	for (std::size_t file = 0; file < plan.size(); ++file)
+		if (!failures[file].empty())
+			Log(LogLevel::Warning) << "Could not copy " << plan[file].first << " to " << plan[file].second << ": " << failures[file];
+}
+
+// Template folders the dump writes into, appends to or overwrites. Their files get copies of their own; an open
+// for writing on a hard link would go straight through to blankMod.
+const std::vector<std::string> convertedTemplateFolders = {"common/bookmarks/",
+	 "common/countries/",
+	 "common/country_tags/",
+	 "common/cultures/",
+	 "common/defines/",
+	 "common/great_projects/",
+	 "common/ideas/",
+	 "common/institutions/",
+	 "common/landed_titles/",
+	 "common/religions/",
+	 "decisions/",
+	 "events/",
+	 "gfx/flags/",
+	 "history/advisors/",
+	 "history/countries/",
+	 "history/diplomacy/",
+	 "history/provinces/",
+	 "interface/",
+	 "localisation/"};
+
+// Every other template file is only ever read by the game, so it is hard linked into the mod instead of copied,
+// falling back to a copy where links aren't possible (another volume, FAT, permissions).
+void layOutModTemplate(const std::string& templatePath, const std::string& modPath)
+{
+	const auto templateRoot = fs::u8path(templatePath);
+	const auto modRoot = fs::u8path(modPath);
+	fs::create_directories(modRoot);
+	for (const auto& entry: fs::recursive_directory_iterator(templateRoot))
+	{
+		const auto relativePath = fs::relative(entry.path(), templateRoot);
+		const auto target = modRoot / relativePath;
+		if (entry.is_directory())
+		{
+			fs::create_directories(target);
+			continue;
+		}
+
+		const auto name = relativePath.generic_string();
+		const auto converted = std::any_of(convertedTemplateFolders.begin(), convertedTemplateFolders.end(), [&name](const std::string& folder) {
+			return name.starts_with(folder);
+		});
+		std::error_code linkError;
+		if (!converted)
+			fs::create_hard_link(entry.path(), target, linkError);
+		if (converted || linkError)
+			fs::copy_file(entry.path(), target, fs::copy_options::overwrite_existing);
+	}
+}
 
+// Clears out the previous mod and lays the template down with the folders every writer expects.
+void layOutMod(const std::string& outputName)
+{
 	commonItems::TryCreateFolder("output");
-	if (commonItems::DoesFolderExist("output/" + theConfiguration.getOutputName()))
+	if (commonItems::DoesFolderExist("output/" + outputName))
+		commonItems::DeleteFolder("output/" + outputName);
+	layOutModTemplate("blankMod/output", "output/" + outputName);
+	for (const auto& folder: {"/history/",
+			  "/history/countries/",
+			  "/history/advisors/",
+			  "/history/provinces/",
+			  "/history/diplomacy/",
+			  "/common/",
+			  "/common/countries/",
+			  "/common/country_tags/",
+			  "/localisation/"})
+		commonItems::TryCreateFolder("output/" + outputName + folder);
+}
+
+// Swaps a fully written staging mod in for the published one. Renames within output/ don't move any data, so the old
+// mod stays whole until the very end; the .mod file is replaced in one rename.
+void publishStagedMod(const std::string& stagedName, const std::string& outputName)
+{
+	const auto modFolder = fs::u8path("output/" + outputName);
+	const auto retiredFolder = fs::u8path("output/" + outputName + ".retired");
+	fs::remove_all(retiredFolder);
+	if (fs::exists(modFolder))
+		fs::rename(modFolder, retiredFolder);
+	fs::rename(fs::u8path("output/" + stagedName), modFolder);
+	fs::rename(fs::u8path("output/" + stagedName + ".mod"), fs::u8path("output/" + outputName + ".mod"));
+	fs::remove_all(retiredFolder);
+}
+
+void discardStagedMod(const std::string& stagedName)
+{
+	std::error_code error;
+	fs::remove_all(fs::u8path("output/" + stagedName), error);
+	fs::remove(fs::u8path("output/" + stagedName + ".mod"), error);
+}
+} // namespace
+
+void EU4::World::output(const commonItems::ConverterVersion& converterVersion,
+	 const Configuration& theConfiguration,
+	 const CK2::World& sourceWorld,
+	 const std::function<void()>& pendingTransforms) const
+{
+	OutputSink sink(theConfiguration.getOutputSink());
+	if (!sink.toDisk())
+	{
+		// Only what the dump generates goes through a counting sink: no template, nothing copied, nothing to publish.
+		pendingTransforms();
+		Log(LogLevel::Info) << "---> The Dump, counted but not written <---";
+		outputMod(converterVersion, theConfiguration, sourceWorld, sink);
+		const auto digest = sink.getDigest();
+		Log(LogLevel::Info) << "<> Output sink took " << sink.getFiles() << " files, " << sink.getBytes() / 1024 << " KB"
+								  << (digest.empty() ? "" : ", digest " + digest) << ".";
+		return;
+	}
+
+	// With staging everything is written under <name>.staging, so a failure halfway leaves the previous mod as it was.
+	const auto staging = theConfiguration.getStaging() == Configuration::STAGING::ENABLED;
+	const auto stagedName = theConfiguration.getOutputName() + ".staging";
+	const auto modConfiguration = staging ? theConfiguration.withOutputName(stagedName) : theConfiguration;
+	try
+	{
+		// Laying out the template only reads blankMod, so it goes to disk on its own thread while the pending transforms
+		// finish. It doesn't log; anything it throws comes out of get().
+		Log(LogLevel::Info) << "<- Laying Out Mod Template >> " << modConfiguration.getOutputName();
+		auto layout = std::async(CK2::Concurrency::launchPolicy(), CK2::Concurrency::carry([&modConfiguration] {
+			const CK2::TraceSpan span("Laying Out Mod Template");
+			layOutMod(modConfiguration.getOutputName());
+		}));
+		pendingTransforms();
+		layout.get();
+		Log(LogLevel::Progress) << "83 %";
+
+		Log(LogLevel::Info) << "---> The Dump <---";
+		outputMod(converterVersion, modConfiguration, sourceWorld, sink);
+	}
+	catch (...)
+	{
+		if (staging)
+			discardStagedMod(stagedName);
+		throw;
+	}
+	if (staging)
+	{
+		Log(LogLevel::Info) << "<- Publishing Staged Mod";
+		publishStagedMod(stagedName, theConfiguration.getOutputName());
+	}
+
+	if (theConfiguration.getArchive() == Configuration::ARCHIVE::ZIP)
+	{
+		Log(LogLevel::Info) << "<- Packing Mod Archive";
+		outputArchive(theConfiguration);
+		Log(LogLevel::Progress) << "97 %";
+	}
+	else if (theConfiguration.getIncremental() == Configuration::INCREMENTAL::ENABLED)
 	{
-		Log(LogLevel::Info) << "<< Deleting existing mod folder.";
-		commonItems::DeleteFolder("output/" + theConfiguration.getOutputName());
+		Log(LogLevel::Info) << "<- Comparing With Previous Output";
+		outputManifest(theConfiguration);
+		Log(LogLevel::Progress) << "97 %";
 	}
-	Log(LogLevel::Progress) << "80 %";
-
-	Log(LogLevel::Info) << "<- Copying Mod Template";
-	commonItems::CopyFolder("blankMod/output", "output/output");
-	Log(LogLevel::Progress) << "81 %";
-
-	Log(LogLevel::Info) << "<- Moving Mod Template >> " << theConfiguration.getOutputName();
-	commonItems::RenameFolder("output/output", "output/" + theConfiguration.getOutputName());
-	Log(LogLevel::Progress) << "82 %";
-
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/history/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/history/countries/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/history/advisors/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/history/provinces/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/history/diplomacy/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/common/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/common/countries/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/common/country_tags/");
-	commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/localisation/");
-	Log(LogLevel::Progress) << "83 %";
+}
+
+void EU4::World::outputMod(const commonItems::ConverterVersion& converterVersion,
+	 const Configuration& theConfiguration,
+	 const CK2::World& sourceWorld,
+	 OutputSink& sink) const
+{
+	const auto isLeviathanDLCPresent = sourceWorld.isLeviathanDLCPresent();
+	const auto invasion = sourceWorld.isInvasion();
+	const auto dynamicInstitutions = theConfiguration.getDynamicInstitutions() == Configuration::INSTITUTIONS::DYNAMIC;
+	const date conversionDate = sourceWorld.getConversionDate();
 
 	Log(LogLevel::Info) << "<- Crafting .mod File";
-	createModFile(theConfiguration);
+	createModFile(theConfiguration, sink);
 	Log(LogLevel::Progress) << "84 %";
 
 	// Record converter version
 	Log(LogLevel::Info) << "<- Writing version";
-	outputVersion(converterVersion, theConfiguration);
+	outputVersion(converterVersion, theConfiguration, sink);
 	Log(LogLevel::Progress) << "85 %";
 
 	// Output common\countries.txt
 	Log(LogLevel::Info) << "<- Creating countries.txt";
-	outputCommonCountriesFile(theConfiguration);
+	outputCommonCountriesFile(theConfiguration, sink);
 	Log(LogLevel::Progress) << "86 %";
 
 	Log(LogLevel::Info) << "<- Writing Country Commons";
-	outputCommonCountries(theConfiguration);
+	outputCommonCountries(theConfiguration, sink);
 	Log(LogLevel::Progress) << "87 %";
 
 	Log(LogLevel::Info) << "<- Writing Country Histories";
-	outputHistoryCountries(theConfiguration);
+	outputHistoryCountries(theConfiguration, sink);
 	Log(LogLevel::Progress) << "88 %";
 
-	if (invasion)
+	// Extras and dynamic institutions are only ever copied over.
+	if (invasion && sink.toDisk())
 	{
 		Log(LogLevel::Info) << "<- Writing Sunset Invasion Files";
 		outputInvasionExtras(theConfiguration, invasion);
 	}
-	if (dynamicInstitutions)
+	if (dynamicInstitutions && sink.toDisk())
 	{
 		Log(LogLevel::Info) << "<- Writing Dynamic Institution Files";
 		outputDynamicInstitutions(theConfiguration);
 	}
 
 	Log(LogLevel::Info) << "<- Writing Advisers";
-	outputAdvisers(theConfiguration);
+	outputAdvisers(theConfiguration, sink);
 	Log(LogLevel::Progress) << "89 %";
 
 	Log(LogLevel::Info) << "<- Writing Provinces";
-	outputHistoryProvinces(theConfiguration, sourceWorld.getExistentPremadeMonuments(), isLeviathanDLCPresent);
+	outputHistoryProvinces(theConfiguration, sourceWorld.getExistentPremadeMonuments(), isLeviathanDLCPresent, sink);
 	Log(LogLevel::Progress) << "90 %";
 
 	Log(LogLevel::Info) << "<- Writing Localization";
-	outputLocalization(theConfiguration, invasion, sourceWorld.isGreekReformation());
+	outputLocalization(theConfiguration, invasion, sourceWorld.isGreekReformation(), sink);
 	Log(LogLevel::Progress) << "91 %";
 
 	Log(LogLevel::Info) << "<- Writing Emperor";
-	outputEmperor(theConfiguration, conversionDate);
+	outputEmperor(theConfiguration, conversionDate, sink);
 	Log(LogLevel::Progress) << "92 %";
 
 	Log(LogLevel::Info) << "<- Writing Diplomacy";
-	outputDiplomacy(theConfiguration, diplomacy.getAgreements(), invasion);
+	outputDiplomacy(theConfiguration, diplomacy.getAgreements(), invasion, sink);
 	Log(LogLevel::Progress) << "93 %";
 
+	// The rest copies files or edits the template's.
+	if (!sink.toDisk())
+		return;
+
 	Log(LogLevel::Info) << "<- Moving Flags";
 	outputFlags(theConfiguration, sourceWorld);
 	Log(LogLevel::Progress) << "94 %";
@@ -112,16 +332,14 @@ void EU4::World::output(const commonItems::ConverterVersion& converterVersion, c
 	Log(LogLevel::Progress) << "96 %";
 }
 
-void EU4::World::outputAdvisers(const Configuration& theConfiguration) const
+void EU4::World::outputAdvisers(const Configuration& theConfiguration, OutputSink& sink) const
 {
-	std::ofstream output("output/" + theConfiguration.getOutputName() + "/history/advisors/00_converter_advisors.txt");
-	if (!output.is_open())
-		throw std::runtime_error("Could not create " + theConfiguration.getOutputName() + "/history/advisors/00_converter_advisors.txt");
+	auto& buffer = TextBuffer::forThisThread();
 	for (const auto& country: countries)
 	{
-		country.second->outputAdvisers(output);
+		country.second->outputAdvisers(buffer);
 	}
-	output.close();
+	sink.write("output/" + theConfiguration.getOutputName() + "/history/advisors/00_converter_advisors.txt", buffer.str());
 }
 
 void EU4::World::outputBookmark(const Configuration& theConfiguration, date conversionDate) const
@@ -170,37 +388,29 @@ void EU4::World::outputFlags(const Configuration& theConfiguration, const CK2::W
 	const auto invasion = sourceWorld.isInvasion();
 	// Make a flag source registry
 	std::map<std::string, std::set<std::string>> sourceFlagSources; // filename/fullpath
+	for (auto& file: CK2::gatherModFiles(theConfiguration.getCK2Path(), sourceWorld.getMods(), "gfx/flags", ".tga", "flags"))
+		sourceFlagSources[file.name].insert(std::move(file.path));
 
-	auto fileNames = commonItems::GetAllFilesInFolder(theConfiguration.getCK2Path() + "/gfx/flags/");
-	for (const auto& file: fileNames)
-		sourceFlagSources[file].insert(theConfiguration.getCK2Path() + "/gfx/flags/" + file);
-
-	for (const auto& mod: sourceWorld.getMods())
-	{
-		if (commonItems::DoesFolderExist(mod.path + "/gfx/flags/"))
-		{
-			Log(LogLevel::Info) << "\t>> Found some flags over in [" << mod.name << "]: " << mod.path << "/gfx/flags/";
-			fileNames = commonItems::GetAllFilesInFolder(mod.path + "/gfx/flags/");
-			for (const auto& file: fileNames)
-				sourceFlagSources[file].insert(mod.path + "/gfx/flags/" + file);
-		}
-	}
+	// One listing per folder instead of probing for every country.
+	const auto flagsPath = "output/" + theConfiguration.getOutputName() + "/gfx/flags/";
+	const auto dynastyFlags = commonItems::GetAllFilesInFolder("configurables/dynastyflags/");
+	const auto vanillaFlags = commonItems::GetAllFilesInFolder(theConfiguration.getEU4Path() + "/gfx/flags/");
+	const auto templateFlags = commonItems::GetAllFilesInFolder(flagsPath);
 
+	std::vector<std::pair<std::string, std::string>> flagPlan; // source, target
 	for (const auto& country: countries)
 	{
 		// first check is for dynasty and override flags.
-		if (country.second->getHasDynastyName() && country.second->getDynastyID() &&
-			 commonItems::DoesFileExist("configurables/dynastyflags/" + std::to_string(country.second->getDynastyID()) + ".tga"))
+		if (country.second->getHasDynastyName() && country.second->getDynastyID() && dynastyFlags.contains(std::to_string(country.second->getDynastyID()) + ".tga"))
 		{
-			commonItems::TryCopyFile("configurables/dynastyflags/" + std::to_string(country.second->getDynastyID()) + ".tga",
-				 "output/" + theConfiguration.getOutputName() + "/gfx/flags/" + country.first + ".tga");
+			flagPlan.emplace_back("configurables/dynastyflags/" + std::to_string(country.second->getDynastyID()) + ".tga", flagsPath + country.first + ".tga");
 			continue;
 		}
 
 		// Otherwise, do we need a flag at all?
-		if (commonItems::DoesFileExist(theConfiguration.getEU4Path() + "/gfx/flags/" + country.first + ".tga"))
+		if (vanillaFlags.contains(country.first + ".tga"))
 			continue;
-		if (commonItems::DoesFileExist("output/" + theConfiguration.getOutputName() + "/gfx/flags/" + country.first + ".tga"))
+		if (templateFlags.contains(country.first + ".tga"))
 			continue;
 		// We do.
 		if (country.second->getTitle().first.empty())
@@ -214,9 +424,9 @@ void EU4::World::outputFlags(const Configuration& theConfiguration, const CK2::W
 			titleName = country.second->getTitle().second->getBaseTitle().first;
 			if (sourceFlagSources.count(titleName + ".tga")) // we have some sources for base title
 				fileName = *sourceFlagSources[titleName + ".tga"].begin();
-			if (fileName.empty() && !country.second->getTitle().second->getBaseTitle().second->getBaseTitle().first.empty())
+			if (fileName.empty() && !country.second->getTitle().second->getBaseTitleBase().empty())
 			{
-				titleName = country.second->getTitle().second->getBaseTitle().second->getBaseTitle().first;
+				titleName = country.second->getTitle().second->getBaseTitleBase();
 				if (sourceFlagSources.count(titleName + ".tga")) // we have some sources for base title base title
 					fileName = *sourceFlagSources[titleName + ".tga"].begin();
 			}
@@ -224,65 +434,133 @@ void EU4::World::outputFlags(const Configuration& theConfiguration, const CK2::W
 		if (fileName.empty())
 			Log(LogLevel::Warning) << "failed to locate flag for " << country.first << ": " << country.second->getTitle().first;
 		else
-			commonItems::TryCopyFile(fileName, "output/" + theConfiguration.getOutputName() + "/gfx/flags/" + country.first + ".tga");
+			flagPlan.emplace_back(fileName, flagsPath + country.first + ".tga");
 	}
+	linkOrCopyFiles(flagPlan);
 	if (invasion)
 		commonItems::TryCopyFile("configurables/sunset/gfx/flags/SDM.tga", "output/" + theConfiguration.getOutputName() + "/gfx/flags/SDM.tga");
 }
 
-void EU4::World::createModFile(const Configuration& theConfiguration) const
+void EU4::World::outputArchive(const Configuration& theConfiguration) const
+{
+	// Bookmarks, localisation and monuments rewrite files written earlier in the dump, so the mod is still assembled on
+	// disk first. Packing it here leaves a single file to ship instead of the loose folder.
+	const auto& outputName = theConfiguration.getOutputName();
+	const auto archivePath = "output/" + outputName + ".zip";
+	if (commonItems::DoesFileExist(archivePath))
+		fs::remove(fs::u8path(archivePath));
+
+	auto* archive = zip_open(archivePath.c_str(), ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+	if (!archive)
+		throw std::runtime_error("Could not create mod archive: " + archivePath);
+	const auto pack = [archive, &archivePath](const std::string& entryName, const std::string& filePath) {
+		if (zip_entry_open(archive, entryName.c_str()) || zip_entry_fwrite(archive, filePath.c_str()) || zip_entry_close(archive))
+		{
+			zip_close(archive);
+			throw std::runtime_error("Could not pack " + filePath + " into " + archivePath);
+		}
+	};
+	pack(outputName + ".mod", "output/" + outputName + ".mod");
+	for (const auto& file: commonItems::GetAllFilesInFolderRecursive("output/" + outputName + "/"))
+		pack(outputName + "/" + file, "output/" + outputName + "/" + file);
+	zip_close(archive);
+
+	commonItems::DeleteFolder("output/" + outputName);
+	fs::remove(fs::u8path("output/" + outputName + ".mod"));
+}
+
+void EU4::World::outputManifest(const Configuration& theConfiguration) const
+{
+	// The dump always regenerates the whole mod, so "unchanged" can only be told afterwards: any file whose contents
+	// hash the same as last run gets last run's modification time back. Size-and-mtime syncs (rsync, the launcher)
+	// then skip it, and files that are no longer generated are already gone with the old folder.
+	const auto modPath = "output/" + theConfiguration.getOutputName() + "/";
+	const auto manifestPath = "output/" + theConfiguration.getOutputName() + ".manifest";
+
+	std::map<std::string, std::pair<std::string, fs::file_time_type::rep>> previousFiles; // path, (hash, mtime)
+	std::ifstream previousManifest(fs::u8path(manifestPath));
+	std::string line;
+	while (std::getline(previousManifest, line))
+	{
+		std::istringstream entry(line);
+		std::string hash;
+		fs::file_time_type::rep modified = 0;
+		if (!(entry >> hash >> modified))
+			continue;
+		entry.get(); // the space before the path
+		std::string path;
+		std::getline(entry, path);
+		previousFiles.emplace(std::move(path), std::pair(std::move(hash), modified));
+	}
+	previousManifest.close();
+
+	std::ofstream manifest(fs::u8path(manifestPath), std::ios::trunc);
+	if (!manifest.is_open())
+		throw std::runtime_error("Could not create output manifest: " + manifestPath);
+	auto unchanged = 0;
+	const auto files = commonItems::GetAllFilesInFolderRecursive(modPath);
+	for (const auto& file: files)
+	{
+		const auto filePath = fs::u8path(modPath + file);
+		const auto hash = CK2::Snapshot::hashFile(modPath + file);
+		auto modified = fs::last_write_time(filePath).time_since_epoch().count();
+		if (const auto& previous = previousFiles.find(file); previous != previousFiles.end() && previous->second.first == hash)
+		{
+			modified = previous->second.second;
+			fs::last_write_time(filePath, fs::file_time_type(fs::file_time_type::duration(modified)));
+			++unchanged;
+		}
+		manifest << hash << " " << modified << " " << file << "\n";
+	}
+	manifest.close();
+	Log(LogLevel::Info) << ">> " << unchanged << " of " << files.size() << " output files unchanged since the last run.";
+}
+
+void EU4::World::createModFile(const Configuration& theConfiguration, OutputSink& sink) const
 {
-	std::ofstream output("output/" + theConfiguration.getOutputName() + ".mod");
-	if (!output.is_open())
-		throw std::runtime_error("Could not create " + theConfiguration.getOutputName() + ".mod");
+	std::ostringstream output;
+	output << modFile;
+
 	Log(LogLevel::Info) << "<< Writing to: "
 							  << "output/" + theConfiguration.getOutputName() + ".mod";
-	output << modFile;
-	output.close();
+	sink.write("output/" + theConfiguration.getOutputName() + ".mod", output.str());
 
-	std::ofstream output2("output/" + theConfiguration.getOutputName() + "/descriptor.mod");
-	if (!output2.is_open())
-		throw std::runtime_error("Could not create " + theConfiguration.getOutputName() + "/descriptor.mod");
 	Log(LogLevel::Info) << "<< Writing to: "
 							  << "output/" + theConfiguration.getOutputName() + "/descriptor.mod";
-	output2 << modFile;
-	output2.close();
+	sink.write("output/" + theConfiguration.getOutputName() + "/descriptor.mod", output.str());
 }
 
 
-void EU4::World::outputLocalization(const Configuration& theConfiguration, bool invasion, bool greekReformation) const
+void EU4::World::outputLocalization(const Configuration& theConfiguration, bool invasion, bool greekReformation, OutputSink& sink) const
 {
-	std::ofstream english("output/" + theConfiguration.getOutputName() + "/localisation/replace/converter_l_english.yml");
-	std::ofstream french("output/" + theConfiguration.getOutputName() + "/localisation/replace/converter_l_french.yml");
-	std::ofstream spanish("output/" + theConfiguration.getOutputName() + "/localisation/replace/converter_l_spanish.yml");
-	std::ofstream german("output/" + theConfiguration.getOutputName() + "/localisation/replace/converter_l_german.yml");
-	if (!english.is_open())
-		throw std::runtime_error("Error writing localisation file! Is the output folder writable?");
-	if (!french.is_open())
-		throw std::runtime_error("Error writing localisation file! Is the output folder writable?");
-	if (!spanish.is_open())
-		throw std::runtime_error("Error writing localisation file! Is the output folder writable?");
-	if (!german.is_open())
-		throw std::runtime_error("Error writing localisation file! Is the output folder writable?");
-	english << "\xEF\xBB\xBFl_english:\n"; // write BOM
-	french << "\xEF\xBB\xBFl_french:\n";	// write BOM
-	spanish << "\xEF\xBB\xBFl_spanish:\n"; // write BOM
-	german << "\xEF\xBB\xBFl_german:\n";	// write BOM
-
-	for (const auto& country: countries)
-	{
-		for (const auto& locblock: country.second->getLocalizations())
-		{
-			english << " " << locblock.first << ": \"" << commonItems::convertWin1252ToUTF8(locblock.second.english) << "\"\n";
-			french << " " << locblock.first << ": \"" << commonItems::convertWin1252ToUTF8(locblock.second.french) << "\"\n";
-			spanish << " " << locblock.first << ": \"" << commonItems::convertWin1252ToUTF8(locblock.second.spanish) << "\"\n";
-			german << " " << locblock.first << ": \"" << commonItems::convertWin1252ToUTF8(locblock.second.german) << "\"\n";
-		}
-	}
-	english.close();
-	french.close();
-	spanish.close();
-	german.close();
+	// The four languages share nothing but the country walk, so each one is its own file and its own thread.
+	static const std::vector<std::pair<std::string, std::string mappers::LocBlock::*>> languages = {
+		 {"english", &mappers::LocBlock::english},
+		 {"french", &mappers::LocBlock::french},
+		 {"spanish", &mappers::LocBlock::spanish},
+		 {"german", &mappers::LocBlock::german}};
+	std::vector<std::string> filePaths;
+	for (const auto& language: languages)
+		filePaths.emplace_back("output/" + theConfiguration.getOutputName() + "/localisation/replace/converter_l_" + language.first + ".yml");
+	writeFiles(
+		 sink,
+		 filePaths,
+		 "localisation",
+		 [this](const std::size_t file, TextBuffer& output) {
+			 const auto& [language, text] = languages[file];
+			 // The entries go together in 1252 as they came from the save, then into UTF-8 in one pass.
+			 thread_local std::string entries;
+			 entries.clear();
+			 for (const auto& country: countries)
+				 for (const auto& locblock: country.second->getLocalizations())
+					 entries.append(" ").append(locblock.first).append(": \"").append(locblock.second.*text).append("\"\n");
+			 output.reserve(entries.size() + entries.size() / 8 + 32);
+			 output << "\xEF\xBB\xBFl_" << language << ":\n"; // write BOM
+			 output.appendWin1252(entries);
+		 },
+		 1);
+	if (!sink.toDisk())
+		return;
 
 	if (invasion)
 	{
@@ -305,20 +583,16 @@ void EU4::World::outputLocalization(const Configuration& theConfiguration, bool
 	}
 }
 
-void EU4::World::outputVersion(const commonItems::ConverterVersion& converterVersion, const Configuration& theConfiguration) const
+void EU4::World::outputVersion(const commonItems::ConverterVersion& converterVersion, const Configuration& theConfiguration, OutputSink& sink) const
 {
-	std::ofstream output("output/" + theConfiguration.getOutputName() + "/ck2toeu4_version.txt");
-	if (!output.is_open())
-		throw std::runtime_error("Error writing version file! Is the output folder writable?");
+	std::ostringstream output;
 	output << converterVersion;
-	output.close();
+	sink.write("output/" + theConfiguration.getOutputName() + "/ck2toeu4_version.txt", output.str());
 }
 
-void EU4::World::outputCommonCountriesFile(const Configuration& theConfiguration) const
+void EU4::World::outputCommonCountriesFile(const Configuration& theConfiguration, OutputSink& sink) const
 {
-	std::ofstream output("output/" + theConfiguration.getOutputName() + "/common/country_tags/00_countries.txt");
-	if (!output.is_open())
-		throw std::runtime_error("Could not create countries file!");
+	std::ostringstream output;
 	output << "REB = \"countries/Rebels.txt\"\n\n"; // opening with rebels manually.
 
 	for (const auto& country: countries)
@@ -329,12 +603,17 @@ void EU4::World::outputCommonCountriesFile(const Configuration& theConfiguration
 			output << country.first << " = \"" << country.second->getCommonCountryFile() << "\"\n";
 	}
 	output << "\n";
-	output.close();
+	sink.write("output/" + theConfiguration.getOutputName() + "/common/country_tags/00_countries.txt", output.str());
 }
 
-void EU4::World::outputHistoryProvinces(const Configuration& theConfiguration, const std::set<std::string>& premades, const bool& isLeviathanDLCPresent) const
+void EU4::World::outputHistoryProvinces(const Configuration& theConfiguration,
+	 const std::set<std::string>& premades,
+	 const bool& isLeviathanDLCPresent,
+	 OutputSink& sink) const
 {
-	if (isLeviathanDLCPresent)
+	// Monuments append to the template's files, so they're only written to disk.
+	std::optional<outMonument> monuments;
+	if (isLeviathanDLCPresent && sink.toDisk())
 	{
 		commonItems::TryCreateFolder("output/" + theConfiguration.getOutputName() + "/common/great_projects/");
 		commonItems::TryCopyFile("configurables/monuments/gfx/zzz_converted_monuments.gfx",
@@ -343,55 +622,51 @@ void EU4::World::outputHistoryProvinces(const Configuration& theConfiguration, c
 		for (const auto& fileName: fileNames)
 			commonItems::TryCopyFile("configurables/monuments/localisation/" + fileName,
 				 "output/" + theConfiguration.getOutputName() + "/localisation/" + fileName);
-		outMonument(theConfiguration, premades); // Outputs Premade files
+		monuments.emplace(theConfiguration, premades); // Outputs Premade files
 	}
+	std::vector<std::string> filePaths;
 	for (const auto& province: provinces)
+		filePaths.emplace_back("output/" + theConfiguration.getOutputName() + "/" + province.second->getHistoryCountryFile());
+	writeFiles(sink, filePaths, "country history", [this](const std::size_t file, EU4::TextBuffer& output) {
+		output << *(provinces.begin() + file)->second;
+	});
+
+	// Monuments append to shared files, so they go out one after another in province order.
+	if (monuments)
 	{
-		std::ofstream output("output/" + theConfiguration.getOutputName() + "/" + province.second->getHistoryCountryFile());
-		if (!output.is_open())
-			throw std::runtime_error(
-				 "Could not create country history file: output/" + theConfiguration.getOutputName() + "/" + province.second->getHistoryCountryFile());
-		output << *province.second;
-		output.close();
-
-		if (province.second->getHasMonument() && !premades.contains(province.second->getSourceProvince()->getMonument()->second->getType()))
-			outMonument(theConfiguration, province.second->getSourceProvince()->getMonument(), province.first);
-	}
-	if (isLeviathanDLCPresent) // This has to be last
-	{
-		// Final closing brace for the GFX file
-		std::ofstream gfxOutput("output/" + theConfiguration.getOutputName() + "/interface/zzz_converted_monuments.gfx", std::ios::out | std::ios::app);
-		if (!gfxOutput.is_open())
-			throw std::runtime_error("Could not create monuments file: output/" + theConfiguration.getOutputName() + "/interface/zzz_converted_monuments.gfx");
-		gfxOutput << "\n}";
-		gfxOutput.close();
+		for (const auto& province: provinces)
+			if (province.second->getHasMonument() && !premades.contains(province.second->getSourceProvince()->getMonument()->second->getType()))
+				monuments->outputMonument(province.second->getSourceProvince()->getMonument(), province.first);
+		monuments->close(); // This has to be last
 	}
 }
 
-void EU4::World::outputHistoryCountries(const Configuration& theConfiguration) const
+void EU4::World::outputHistoryCountries(const Configuration& theConfiguration, OutputSink& sink) const
 {
+	std::vector<std::shared_ptr<Country>> countryList;
+	std::vector<std::string> filePaths;
 	for (const auto& country: countries)
 	{
-		std::ofstream output("output/" + theConfiguration.getOutputName() + "/" + country.second->getHistoryCountryFile());
-		if (!output.is_open())
-			throw std::runtime_error(
-				 "Could not create country history file: output/" + theConfiguration.getOutputName() + "/" + country.second->getHistoryCountryFile());
-		output << *country.second;
-		output.close();
+		countryList.emplace_back(country.second);
+		filePaths.emplace_back("output/" + theConfiguration.getOutputName() + "/" + country.second->getHistoryCountryFile());
 	}
+	writeFiles(sink, filePaths, "country history", [&countryList](const std::size_t file, EU4::TextBuffer& output) {
+		output << *countryList[file];
+	});
 }
 
-void EU4::World::outputCommonCountries(const Configuration& theConfiguration) const
+void EU4::World::outputCommonCountries(const Configuration& theConfiguration, OutputSink& sink) const
 {
+	std::vector<std::shared_ptr<Country>> countryList;
+	std::vector<std::string> filePaths;
 	for (const auto& country: countries)
 	{
-		std::ofstream output("output/" + theConfiguration.getOutputName() + "/common/" + country.second->getCommonCountryFile());
-		if (!output.is_open())
-			throw std::runtime_error(
-				 "Could not create country common file: output/" + theConfiguration.getOutputName() + "/common/" + country.second->getCommonCountryFile());
-		country.second->outputCommons(output);
-		output.close();
+		countryList.emplace_back(country.second);
+		filePaths.emplace_back("output/" + theConfiguration.getOutputName() + "/common/" + country.second->getCommonCountryFile());
 	}
+	writeFiles(sink, filePaths, "country common", [&countryList](const std::size_t file, EU4::TextBuffer& output) {
+		countryList[file]->outputCommons(output);
+	});
 }
 
 void EU4::World::outputInvasionExtras(const Configuration& theConfiguration, bool invasion) const
@@ -427,36 +702,29 @@ void EU4::World::outputDynamicInstitutions(const Configuration& theConfiguration
 		commonItems::TryCopyFile("configurables/dynamicInstitutions/ideas/" + file, "output/" + theConfiguration.getOutputName() + "/common/ideas/" + file);
 }
 
-void EU4::World::outputEmperor(const Configuration& theConfiguration, date conversionDate) const
+void EU4::World::outputEmperor(const Configuration& theConfiguration, date conversionDate, OutputSink& sink) const
 {
 	auto actualConversionDate = conversionDate;
 	if (theConfiguration.getStartDateOption() == Configuration::STARTDATE::EU)
 		actualConversionDate = date(1444, 11, 11);
 
-	std::ofstream output("output/" + theConfiguration.getOutputName() + "/history/diplomacy/hre.txt");
-	if (!output.is_open())
-		throw std::runtime_error("Could not create hre diplomacy file: output/" + theConfiguration.getOutputName() + "/history/diplomacy/hre.txt!");
+	std::ostringstream hre;
 	if (emperorTag.empty())
-		output << actualConversionDate << " = { emperor = --- }\n";
+		hre << actualConversionDate << " = { emperor = --- }\n";
 	else
-		output << actualConversionDate << " = { emperor = " << emperorTag << " }\n";
-	output.close();
+		hre << actualConversionDate << " = { emperor = " << emperorTag << " }\n";
+	sink.write("output/" + theConfiguration.getOutputName() + "/history/diplomacy/hre.txt", hre.str());
 
-	output.open("output/" + theConfiguration.getOutputName() + "/history/diplomacy/celestial_empire.txt");
-	if (!output.is_open())
-		throw std::runtime_error(
-			 "Could not create celestial empire diplomacy file: output/" + theConfiguration.getOutputName() + "/history/diplomacy/celestial_empire.txt!");
+	std::ostringstream celestialEmpire;
 	if (celestialEmperorTag.empty())
-		output << actualConversionDate << " = { celestial_emperor = --- }\n";
+		celestialEmpire << actualConversionDate << " = { celestial_emperor = --- }\n";
 	else
-		output << actualConversionDate << " = { celestial_emperor = " << celestialEmperorTag << " }\n";
-	output.close();
+		celestialEmpire << actualConversionDate << " = { celestial_emperor = " << celestialEmperorTag << " }\n";
+	sink.write("output/" + theConfiguration.getOutputName() + "/history/diplomacy/celestial_empire.txt", celestialEmpire.str());
 
 	if (!actualHRETag.empty())
 	{
-		output.open("output/" + theConfiguration.getOutputName() + "/i_am_hre.txt");
-		output << actualHRETag;
-		output.close();
+		sink.write("output/" + theConfiguration.getOutputName() + "/i_am_hre.txt", actualHRETag);
 
 		if (actualHRETag != "HRE")
 		{
@@ -472,70 +740,58 @@ void EU4::World::outputEmperor(const Configuration& theConfiguration, date conve
 				auto eventFileString = inStream.str();
 				input.close();
 				eventFileString = std::regex_replace(eventFileString, std::regex("HLR"), actualHRETag);
-				output.open("output/" + theConfiguration.getOutputName() + "/events/HolyRomanEmpire.txt");
-				output << eventFileString;
-				output.close();
+				sink.write("output/" + theConfiguration.getOutputName() + "/events/HolyRomanEmpire.txt", eventFileString);
 			}
 		}
 	}
 }
 
-void EU4::World::outputDiplomacy(const Configuration& theConfiguration, const std::vector<std::shared_ptr<Agreement>>& agreements, bool invasion) const
+void EU4::World::outputDiplomacy(const Configuration& theConfiguration,
+	 const std::vector<std::shared_ptr<Agreement>>& agreements,
+	 bool invasion,
+	 OutputSink& sink) const
 {
-	std::ofstream alliances("output/" + theConfiguration.getOutputName() + "/history/diplomacy/converter_alliances.txt");
-	if (!alliances.is_open())
-		throw std::runtime_error("Could not create alliances history file!");
-
-	std::ofstream guarantees("output/" + theConfiguration.getOutputName() + "/history/diplomacy/converter_guarantees.txt");
-	if (!guarantees.is_open())
-		throw std::runtime_error("Could not create guarantees history file!");
-
-	std::ofstream puppetStates("output/" + theConfiguration.getOutputName() + "/history/diplomacy/converter_puppetstates.txt");
-	if (!puppetStates.is_open())
-		throw std::runtime_error("Could not create puppet states history file!");
-
-	std::ofstream unions("output/" + theConfiguration.getOutputName() + "/history/diplomacy/converter_unions.txt");
-	if (!unions.is_open())
-		throw std::runtime_error("Could not create unions history file!");
+	std::ostringstream alliances;
+	std::ostringstream guarantees;
+	std::ostringstream puppetStates;
+	std::ostringstream unions;
 
 	for (const auto& agreement: agreements)
 	{
-		if (agreement->getType() == "guarantee")
-		{
-			guarantees << *agreement;
-		}
-		else if (agreement->getType() == "union")
-		{
-			unions << *agreement;
-		}
-		else if (agreement->getType() == "vassal" || agreement->getType() == "dependency")
-		{
-			puppetStates << *agreement;
-		}
-		else if (agreement->getType() == "alliance")
-		{
-			alliances << *agreement;
-		}
-		else
+		switch (agreement->getKind())
 		{
-			Log(LogLevel::Warning) << "Cannot output diplomatic agreement type " << agreement->getType() << "!";
+			case Agreement::KIND::GUARANTEE:
+				guarantees << *agreement;
+				break;
+			case Agreement::KIND::UNION:
+				unions << *agreement;
+				break;
+			case Agreement::KIND::VASSAL:
+			case Agreement::KIND::DEPENDENCY:
+				puppetStates << *agreement;
+				break;
+			case Agreement::KIND::ALLIANCE:
+				alliances << *agreement;
+				break;
+			default:
+				Log(LogLevel::Warning) << "Cannot output diplomatic agreement type " << agreement->getType() << "!";
 		}
 	}
 
-	alliances.close();
-	guarantees.close();
-	puppetStates.close();
-	unions.close();
+	const auto diplomacyPath = "output/" + theConfiguration.getOutputName() + "/history/diplomacy/";
+	sink.write(diplomacyPath + "converter_alliances.txt", alliances.str());
+	sink.write(diplomacyPath + "converter_guarantees.txt", guarantees.str());
+	sink.write(diplomacyPath + "converter_puppetstates.txt", puppetStates.str());
+	sink.write(diplomacyPath + "converter_unions.txt", unions.str());
 
 	if (invasion)
 	{
 		// Blank american diplomacy
-		std::ofstream diplo("output/" + theConfiguration.getOutputName() + "/history/diplomacy/American_alliances.txt");
-		diplo << "\n";
-		diplo.close();
+		sink.write(diplomacyPath + "American_alliances.txt", "\n");
 		// and move over our alliances.
-		commonItems::TryCopyFile("configurables/sunset/history/diplomacy/SunsetInvasion.txt",
-			 "output/" + theConfiguration.getOutputName() + "/history/diplomacy/SunsetInvasion.txt");
+		if (sink.toDisk())
+			commonItems::TryCopyFile("configurables/sunset/history/diplomacy/SunsetInvasion.txt",
+				 "output/" + theConfiguration.getOutputName() + "/history/diplomacy/SunsetInvasion.txt");
 	}
 }
 
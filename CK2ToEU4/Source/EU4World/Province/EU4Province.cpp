@@ -1,24 +1,36 @@
 #include "EU4Province.h"
 #include "../../CK2World/Characters/Character.h"
+#include "../../CK2World/MemoryCensus.h"
 #include "../../CK2World/Provinces/Province.h"
 #include "../../CK2World/Titles/Title.h"
 #include "../../CK2World/Wonders/Wonder.h"
 #include "../../Mappers/CultureMapper/CultureMapper.h"
 #include "../../Mappers/ReligionMapper/ReligionMapper.h"
 #include "../Country/Country.h"
+#include "ProvinceOwners.h"
 
-EU4::Province::Province(int id, const std::string& filePath): provID(id)
+namespace
+{
+// Hardcoding for now. Every imported province is discovered by the same groups, so they all share this one list.
+const parsing::CopyOnWrite<std::set<std::string>>& discoveredByAll()
+{
+	static const parsing::CopyOnWrite<std::set<std::string>> groups(
+		 std::set<std::string>{"eastern", "western", "muslim", "ottoman", "indian", "nomad_group", "east_african", "sub_saharan", "chinese", "MGE"});
+	return groups;
+}
+} // namespace
+
+EU4::Province::Province(int id, const std::string& filePath): provID(id), details(ProvinceDetails(filePath))
 {
 	// Load from a country file, if one exists. Otherwise rely on defaults.
 	const auto startPos = filePath.find("/history");
 	historyProvincesFile = filePath.substr(startPos + 1, filePath.length() - startPos);
-	details = ProvinceDetails(filePath);
 }
 
 void EU4::Province::updateWith(const std::string& filePath)
 {
 	// We're doing this for special reason and from a specific source.
-	details.updateWith(filePath);
+	details.edit().updateWith(filePath);
 }
 
 void EU4::Province::initializeFromCK2(std::shared_ptr<CK2::Province> origProvince,
@@ -26,7 +38,8 @@ void EU4::Province::initializeFromCK2(std::shared_ptr<CK2::Province> origProvinc
 	 const mappers::ReligionMapper& religionMapper)
 {
 	srcProvince = std::move(origProvince);
-	details.discoveredBy = {"eastern", "western", "muslim", "ottoman", "indian", "nomad_group", "east_african", "sub_saharan", "chinese", "MGE"}; // hardcoding for now.
+	auto& details = this->details.edit(); // every imported province is rewritten below
+	details.discoveredBy = discoveredByAll();
 
 	// If we're initializing this from CK2 provinces, then having an owner or being a wasteland/sea is a given -
 	// there are no uncolonized provinces in CK2.
@@ -111,19 +124,36 @@ void EU4::Province::initializeFromCK2(std::shared_ptr<CK2::Province> origProvinc
 	// not touching centers of trade
 
 	details.cores.clear();
-	details.cores.insert(tagCountry.first); // Only owner for now, dejures come later.
+	details.cores.emplace(tagCountry.first); // Only owner for now, dejures come later.
 	details.claims.clear();						 // dejures come later.
 
 	details.estate.clear(); // setting later.
 
 	details.localAutonomy = 0; // let the game handle this.
 	// not touching native_size/ferocity/hostileness.
-	// not touching existing permanent modifiers. These mostly relate to new world anyway. Wonders do need to be added.
+	// not touching existing permanent modifiers. These mostly relate to new world anyway. Wonders are added by spendSourceWonders.
+
+	details.shipyard = false; // we'll distribute these later.
+	// not touching province_triggered_modifiers. Rome is rome.
+	details.revoltRisk = 0;				 // we can adjust this later.
+	details.unrest = 0;					 // ditto
+	details.nationalism = 0;			 // later, if ever.
+	details.seatInParliament = false; // no.
+	details.jainsBurghers = false;	 // nope.
+	details.rajputsNobles = false;	 // nono.
+	details.brahminsChurch = false;	 // Still no.
+	details.vaisyasBurghers = false;	 // No.
+}
+
+void EU4::Province::spendSourceWonders()
+{
+	if (!srcProvince || srcProvince->getTitle().first.empty())
+		return;
 	if (srcProvince->getWonder() && srcProvince->getWonder()->second && !srcProvince->getWonder()->second->isSpent()) // For non-Leviathan DLC Owners
 	{
 		ProvinceModifier newModifier;
 		newModifier.name = srcProvince->getWonder()->second->getType();
-		details.provinceModifiers.emplace_back(newModifier);
+		details.edit().provinceModifiers.emplace_back(newModifier);
 		srcProvince->getWonder()->second->setSpent(); // We must spend it to avoid mapping it into multiple eu4 provinces.
 	}
 	if (srcProvince->getMonument() && srcProvince->getMonument()->second && !srcProvince->getMonument()->second->isSpent()) // For Leviathan DLC owners
@@ -131,22 +161,56 @@ void EU4::Province::initializeFromCK2(std::shared_ptr<CK2::Province> origProvinc
 		hasMonument = true;
 		srcProvince->getMonument()->second->setSpent(); // We must spend it to avoid mapping it into multiple eu4 provinces.
 	}
+}
 
-	details.shipyard = false; // we'll distribute these later.
-	// not touching province_triggered_modifiers. Rome is rome.
-	details.revoltRisk = 0;				 // we can adjust this later.
-	details.unrest = 0;					 // ditto
-	details.nationalism = 0;			 // later, if ever.
-	details.seatInParliament = false; // no.
-	details.jainsBurghers = false;	 // nope.
-	details.rajputsNobles = false;	 // nono.
-	details.brahminsChurch = false;	 // Still no.
-	details.vaisyasBurghers = false;	 // No.
+void EU4::Province::setAdm(const int adm)
+{
+	if (developmentOwner)
+		developmentOwner->adjustDevelopment(*this, adm - details->baseTax);
+	details.edit().baseTax = adm;
+}
+
+void EU4::Province::setDip(const int dip)
+{
+	if (developmentOwner)
+		developmentOwner->adjustDevelopment(*this, dip - details->baseProduction);
+	details.edit().baseProduction = dip;
+}
+
+void EU4::Province::setMil(const int mil)
+{
+	if (developmentOwner)
+		developmentOwner->adjustDevelopment(*this, mil - details->baseManpower);
+	details.edit().baseManpower = mil;
+}
+
+void EU4::Province::setReligion(const std::string& religion)
+{
+	if (developmentOwner)
+		developmentOwner->changeReligion(*this, religion);
+	details.edit().religion = religion;
+}
+
+void EU4::Province::setOwner(const std::string& tag)
+{
+	if (ownerIndex)
+		ownerIndex->moved(provID, details->owner, tag);
+	details.edit().owner = tag;
+}
+
+void EU4::Province::transferTo(const std::string& tag, const Tag& core, const bool replaceCores)
+{
+	if (replaceCores)
+		details.edit().cores.clear();
+	details.edit().cores.insert(core);
+	setOwner(tag);
+	details.edit().controller = tag;
 }
 
 void EU4::Province::sterilize()
 {
-	details.owner.clear();
+	setOwner("");
+	auto& details = this->details.edit();
 	details.controller.clear();
 	details.cores.clear();
 	details.claims.clear();
@@ -166,3 +230,8 @@ void EU4::Province::sterilize()
 	// not clearing province modifiers! We're leaving great wonders right there.
 	// not touching dev, CoTs and similar!
 }
+
+std::size_t EU4::Province::heapBytes() const
+{
+	return CK2::MemoryCensus::heapBytes(historyProvincesFile) + details->heapBytes() + CK2::MemoryCensus::heapBytes(tagCountry);
+}
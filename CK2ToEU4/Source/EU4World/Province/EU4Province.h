@@ -1,6 +1,7 @@
 #ifndef EU4_PROVINCE_H
 #define EU4_PROVINCE_H
 
+#include "../../Parsing/CopyOnWrite.h"
 #include "ProvinceDetails.h"
 #include <memory>
 #include <string>
@@ -18,6 +19,8 @@ class ReligionMapper;
 namespace EU4
 {
 class Country;
+class ProvinceOwners;
+class TextBuffer;
 class Province
 {
   public:
@@ -29,46 +32,66 @@ class Province
 	void initializeFromCK2(std::shared_ptr<CK2::Province> origProvince,
 		 const mappers::CultureMapper& cultureMapper,
 		 const mappers::ReligionMapper& religionMapper);
+	// Takes the source province's wonder or monument unless another EU4 province already took it. Provinces are
+	// initialized side by side, this runs afterwards one at a time and in province order.
+	void spendSourceWonders();
 
 	[[nodiscard]] const auto& getHistoryCountryFile() const { return historyProvincesFile; }
 	[[nodiscard]] const auto& getTagCountry() const { return tagCountry; }
-	[[nodiscard]] const auto& getOwner() const { return details.owner; }
-	[[nodiscard]] const auto& getReligion() const { return details.religion; }
-	[[nodiscard]] const auto& getCulture() const { return details.culture; }
+	[[nodiscard]] const auto& getOwner() const { return details->owner; }
+	[[nodiscard]] const auto& getReligion() const { return details->religion; }
+	[[nodiscard]] const auto& getCulture() const { return details->culture; }
 	[[nodiscard]] const auto& getSourceProvince() const { return srcProvince; }
-	[[nodiscard]] const auto& getCenterOfTradeLevel() const { return details.centerOfTrade; }
-	[[nodiscard]] auto getDev() const { return details.baseTax + details.baseProduction + details.baseManpower; }
-	[[nodiscard]] auto getAdm() const { return details.baseTax; }
-	[[nodiscard]] auto getMil() const { return details.baseManpower; }
-	[[nodiscard]] auto getDip() const { return details.baseProduction; }
+	[[nodiscard]] const auto& getCenterOfTradeLevel() const { return details->centerOfTrade; }
+	[[nodiscard]] auto getDev() const { return details->baseTax + details->baseProduction + details->baseManpower; }
+	[[nodiscard]] auto getAdm() const { return details->baseTax; }
+	[[nodiscard]] auto getMil() const { return details->baseManpower; }
+	[[nodiscard]] auto getDip() const { return details->baseProduction; }
 	[[nodiscard]] auto getProvinceID() const { return provID; }
 	[[nodiscard]] auto getHasMonument() const { return hasMonument; }
 
 
-	void registerTagCountry(const std::pair<std::string, std::shared_ptr<Country>>& theCountry) { tagCountry = theCountry; }
-	void addCore(const std::string& tag) { details.cores.insert(tag); }
-	void dropCores() { details.cores.clear(); }
-	void addClaim(const std::string& tag) { details.claims.insert(tag); }
-	void addPermanentClaim(const std::string& tag) { details.permanentClaims.insert(tag); }
-	void setOwner(const std::string& tag) { details.owner = tag; }
-	void setController(const std::string& tag) { details.controller = tag; }
-	void setReligion(const std::string& religion) { details.religion = religion; }
-	void setAdm(int adm) { details.baseTax = adm; }
-	void setDip(int dip) { details.baseProduction = dip; }
-	void setMil(int mil) { details.baseManpower = mil; }
-	void buildFort() { details.fort = true; }
-	void addDiscoveredBy(const std::string& bywhom) { details.discoveredBy.insert(bywhom); }
+	void registerTagCountry(const std::pair<std::string, Country*>& theCountry) { tagCountry = theCountry; }
+	void addCore(const std::string& tag) { details.edit().cores.emplace(tag); }
+	void dropCores() { details.edit().cores.clear(); }
+	void addClaim(const std::string& tag) { details.edit().claims.emplace(tag); }
+	void addPermanentClaim(const std::string& tag) { details.edit().permanentClaims.emplace(tag); }
+	void addPermanentClaim(const Tag& tag) { details.edit().permanentClaims.insert(tag); }
+	void setOwner(const std::string& tag);
+	void setController(const std::string& tag) { details.edit().controller = tag; }
+	void setReligion(const std::string& religion);
+	void setAdm(int adm);
+	void setDip(int dip);
+	void setMil(int mil);
+	void buildFort() { details.edit().fort = true; }
+	void addDiscoveredBy(const std::string& bywhom) { details.edit().discoveredBy.edit().insert(bywhom); }
 	void sterilize();
+	// Hands the province to an annexing country: owner, controller and a core, or the only core if replaceCores.
+	void transferTo(const std::string& tag, const Tag& core, bool replaceCores);
+	// The country whose development and census count ours, told of every change to either. Set when a country registers us.
+	void registerDevelopmentOwner(Country* country) { developmentOwner = country; }
+	void unregisterDevelopmentOwner(const Country* country)
+	{
+		if (developmentOwner == country)
+			developmentOwner = nullptr;
+	}
+	// The owner index told of every change of owner from here on.
+	void registerOwnerIndex(ProvinceOwners* index) { ownerIndex = index; }
+	[[nodiscard]] std::size_t heapBytes() const; // for CK2::MemoryCensus
 
-	friend std::ostream& operator<<(std::ostream& output, const Province& versionParser);
+	friend TextBuffer& operator<<(TextBuffer& output, const Province& versionParser);
 
   private:
+	friend class VanillaCache;
+
 	int provID = 0;
 	bool hasMonument = false; // For Leviathan DLC owners only
 	std::string historyProvincesFile;
 	std::shared_ptr<CK2::Province> srcProvince;
-	ProvinceDetails details;
-	std::pair<std::string, std::shared_ptr<Country>> tagCountry;
+	parsing::CopyOnWrite<ProvinceDetails> details; // shared with the vanilla image until changed
+	std::pair<std::string, Country*> tagCountry; // owned by the world
+	Country* developmentOwner = nullptr;
+	ProvinceOwners* ownerIndex = nullptr;
 };
 } // namespace EU4
 
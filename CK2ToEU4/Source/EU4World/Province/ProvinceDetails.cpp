@@ -1,190 +1,174 @@
 #include "ProvinceDetails.h"
-#include "CommonRegexes.h"
+#include "../../CK2World/MemoryCensus.h"
+#include "../../Parsing/TokenTable.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
-#include "ParserHelpers.h"
 
-EU4::ProvinceDetails::ProvinceDetails(const std::string& filePath)
+namespace
+{
+void insertTag(std::set<EU4::Tag>& tags, const std::string_view text)
 {
-	registerKeys();
+	if (EU4::Tag::fits(text))
+		tags.emplace(text);
+	else
+		Log(LogLevel::Warning) << "Ignoring malformed country tag in province history: " << text;
+}
+} // namespace
 
-	if (commonItems::DoesFileExist(filePath))
-	{
-		parseFile(filePath);
-	}
-	clearRegisteredKeywords();
+EU4::ProvinceDetails::ProvinceDetails(const std::string& filePath)
+{
+	updateWith(filePath);
 }
 
 void EU4::ProvinceDetails::updateWith(const std::string& filePath)
 {
-	registerKeys();
+	static const auto tokenTable = registerKeys();
 	if (commonItems::DoesFileExist(filePath))
 	{
-		parseFile(filePath);
+		tokenTable.parseFile(*this, filePath);
 	}
-	clearRegisteredKeywords();
 }
 
 EU4::ProvinceDetails::ProvinceDetails(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto tokenTable = registerKeys();
+	const auto contents = parsing::readStream(theStream);
+	parsing::Tokenizer tokens(contents);
+	tokenTable.parse(*this, tokens);
 }
 
-void EU4::ProvinceDetails::registerKeys()
+parsing::TokenTable<EU4::ProvinceDetails> EU4::ProvinceDetails::registerKeys()
 {
-	registerKeyword("owner", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString ownerStr(theStream);
-		owner = ownerStr.getString();
-	});
-	registerKeyword("controller", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString contStr(theStream);
-		controller = contStr.getString();
-	});
-	registerKeyword("capital", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString capStr(theStream);
-		capital = capStr.getString();
-	});
-	registerKeyword("is_city", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString cityStr(theStream);
-		isCity = cityStr.getString() == "yes";
-	});
-	registerKeyword("culture", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString cultureStr(theStream);
-		culture = cultureStr.getString();
-	});
-	registerKeyword("religion", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString religStr(theStream);
-		religion = religStr.getString();
-	});
-	registerKeyword("trade_goods", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString goodsStr(theStream);
-		tradeGoods = goodsStr.getString();
-	});
-	registerKeyword("fort_15th", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString fortStr(theStream);
-		fort = fortStr.getString() == "yes";
-	});
-	registerKeyword("hre", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString hreStr(theStream);
-		inHre = hreStr.getString() == "yes";
-	});
-	registerKeyword("base_tax", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt taxInt(theStream);
-		baseTax = taxInt.getInt();
-	});
-	registerKeyword("base_production", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt prodInt(theStream);
-		baseProduction = prodInt.getInt();
+	parsing::TokenTable<ProvinceDetails> tokenTable;
+	tokenTable.registerKeyword("owner", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.owner = tokens.getString();
+	});
+	tokenTable.registerKeyword("controller", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.controller = tokens.getString();
+	});
+	tokenTable.registerKeyword("capital", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.capital = tokens.getString();
+	});
+	tokenTable.registerKeyword("is_city", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.isCity = tokens.getString() == "yes";
 	});
-	registerKeyword("base_manpower", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt manInt(theStream);
-		baseManpower = manInt.getInt();
+	tokenTable.registerKeyword("culture", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.culture = tokens.getString();
 	});
-	registerKeyword("extra_cost", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt costInt(theStream);
-		extraCost = costInt.getInt();
+	tokenTable.registerKeyword("religion", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.religion = tokens.getString();
 	});
-	registerKeyword("center_of_trade", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt cotInt(theStream);
-		centerOfTrade = cotInt.getInt();
+	tokenTable.registerKeyword("trade_goods", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.tradeGoods = tokens.getString();
 	});
-	registerKeyword("add_core", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString coreStr(theStream);
-		cores.insert(coreStr.getString());
+	tokenTable.registerKeyword("fort_15th", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.fort = tokens.getString() == "yes";
 	});
-	registerKeyword("add_claim", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString claimStr(theStream);
-		claims.insert(claimStr.getString());
+	tokenTable.registerKeyword("hre", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.inHre = tokens.getString() == "yes";
 	});
-	registerKeyword("add_permanent_claim", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString claimStr(theStream);
-		permanentClaims.insert(claimStr.getString());
+	tokenTable.registerKeyword("base_tax", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.baseTax = tokens.getInt();
 	});
-	registerKeyword("discovered_by", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString discoveredStr(theStream);
-		discoveredBy.insert(discoveredStr.getString());
+	tokenTable.registerKeyword("base_production", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.baseProduction = tokens.getInt();
 	});
-	registerKeyword("add_local_autonomy", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt autoInt(theStream);
-		localAutonomy = autoInt.getInt();
+	tokenTable.registerKeyword("base_manpower", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.baseManpower = tokens.getInt();
 	});
-	registerKeyword("native_size", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt sizeInt(theStream);
-		nativeSize = sizeInt.getInt();
+	tokenTable.registerKeyword("extra_cost", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.extraCost = tokens.getInt();
 	});
-	registerKeyword("native_ferocity", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt ferocityInt(theStream);
-		nativeFerocity = ferocityInt.getInt();
+	tokenTable.registerKeyword("center_of_trade", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.centerOfTrade = tokens.getInt();
 	});
-	registerKeyword("native_hostileness", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt hostInt(theStream);
-		nativeHostileness = hostInt.getInt();
+	tokenTable.registerKeyword("add_core", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		insertTag(details.cores, tokens.getString());
 	});
-	registerKeyword("add_permanent_province_modifier", [this](const std::string& unused, std::istream& theStream) {
-		const auto newModifier = ProvinceModifier(theStream);
-		provinceModifiers.emplace_back(newModifier);
+	tokenTable.registerKeyword("add_claim", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		insertTag(details.claims, tokens.getString());
 	});
-	registerKeyword("estate", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString estateStr(theStream);
-		estate = estateStr.getString();
+	tokenTable.registerKeyword("add_permanent_claim", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		insertTag(details.permanentClaims, tokens.getString());
 	});
-	registerKeyword("latent_trade_goods", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::stringList theList(theStream);
-		auto theGoods = theList.getStrings();
-		latentGoods.insert(theGoods.begin(), theGoods.end());
+	tokenTable.registerKeyword("discovered_by", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.discoveredBy.edit().emplace(tokens.getString());
 	});
-	registerKeyword("shipyard", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString shipStr(theStream);
-		shipyard = shipStr.getString() == "yes";
+	tokenTable.registerKeyword("add_local_autonomy", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.localAutonomy = tokens.getInt();
 	});
-	registerKeyword("add_province_triggered_modifier", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString modStr(theStream);
-		provinceTriggeredModifiers.insert(modStr.getString());
+	tokenTable.registerKeyword("native_size", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.nativeSize = tokens.getInt();
 	});
-	registerKeyword("revolt_risk", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt revoltInt(theStream);
-		revoltRisk = revoltInt.getInt();
+	tokenTable.registerKeyword("native_ferocity", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.nativeFerocity = tokens.getInt();
 	});
-	registerKeyword("unrest", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt unrestInt(theStream);
-		unrest = unrestInt.getInt();
+	tokenTable.registerKeyword("native_hostileness", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.nativeHostileness = tokens.getInt();
 	});
-	registerKeyword("add_nationalism", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt nationalismInt(theStream);
-		nationalism = nationalismInt.getInt();
+	tokenTable.registerKeyword("add_permanent_province_modifier", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.provinceModifiers.emplace_back(tokens);
 	});
-	registerKeyword("seat_in_parliament", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString seatStr(theStream);
-		seatInParliament = seatStr.getString() == "yes";
+	tokenTable.registerKeyword("estate", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.estate = tokens.getString();
 	});
-	registerKeyword("add_jains_or_burghers_effect", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString effectStr(theStream);
-		jainsBurghers = effectStr.getString() == "yes";
+	tokenTable.registerKeyword("latent_trade_goods", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		for (const auto& good: tokens.getStrings())
+			details.latentGoods.emplace(good);
 	});
-	registerKeyword("add_rajputs_or_marathas_or_nobles_effect", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString effectStr(theStream);
-		rajputsNobles = effectStr.getString() == "yes";
+	tokenTable.registerKeyword("shipyard", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.shipyard = tokens.getString() == "yes";
 	});
-	registerKeyword("add_brahmins_or_church_effect", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString effectStr(theStream);
-		brahminsChurch = effectStr.getString() == "yes";
+	tokenTable.registerKeyword("add_province_triggered_modifier", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.provinceTriggeredModifiers.emplace(tokens.getString());
 	});
-	registerKeyword("add_vaisyas_or_burghers_effect", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString effectStr(theStream);
-		vaisyasBurghers = effectStr.getString() == "yes";
+	tokenTable.registerKeyword("revolt_risk", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.revoltRisk = tokens.getInt();
+	});
+	tokenTable.registerKeyword("unrest", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.unrest = tokens.getInt();
+	});
+	tokenTable.registerKeyword("add_nationalism", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.nationalism = tokens.getInt();
+	});
+	tokenTable.registerKeyword("seat_in_parliament", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.seatInParliament = tokens.getString() == "yes";
+	});
+	tokenTable.registerKeyword("add_jains_or_burghers_effect", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.jainsBurghers = tokens.getString() == "yes";
+	});
+	tokenTable.registerKeyword("add_rajputs_or_marathas_or_nobles_effect", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.rajputsNobles = tokens.getString() == "yes";
+	});
+	tokenTable.registerKeyword("add_brahmins_or_church_effect", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.brahminsChurch = tokens.getString() == "yes";
+	});
+	tokenTable.registerKeyword("add_vaisyas_or_burghers_effect", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.vaisyasBurghers = tokens.getString() == "yes";
 	});
 	// These two hard overrides are necessary for Palembang and similar countries outside CK scope that are assigned ownership in a 1444 history block instead
 	// directly. Without us replicating the 1441/1444 block they'd remain uncolonized in any conversion.
-	registerKeyword("1441.1.1", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString effectStr(theStream);
-		datedInfo = effectStr.getString();
+	tokenTable.registerKeyword("1441.1.1", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.datedInfo = tokens.getString();
 	});
-	registerKeyword("1444.1.1", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString effectStr(theStream);
-		datedInfo = effectStr.getString();
+	tokenTable.registerKeyword("1444.1.1", [](ProvinceDetails& details, std::string_view unused, parsing::Tokenizer& tokens) {
+		details.datedInfo = tokens.getString();
 	});
-	registerRegex(R"(\d+.\d+.\d+)", commonItems::ignoreItem);
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	tokenTable.ignoreUnregistered();
+	return tokenTable;
+}
+
+std::size_t EU4::ProvinceDetails::heapBytes() const
+{
+	using CK2::MemoryCensus;
+	auto bytes = provinceModifiers.capacity() * sizeof(ProvinceModifier);
+	for (const auto& modifier: provinceModifiers)
+		bytes += MemoryCensus::heapBytes(modifier.name);
+	for (const auto* text: {&owner, &controller, &capital, &culture, &religion, &tradeGoods, &estate, &datedInfo})
+		bytes += MemoryCensus::heapBytes(*text);
+	for (const auto* tags: {&cores, &claims, &permanentClaims})
+		bytes += MemoryCensus::heapBytes(*tags);
+	for (const auto* names: {&*discoveredBy, &latentGoods, &provinceTriggeredModifiers})
+		bytes += MemoryCensus::heapBytes(*names);
+	return bytes;
 }
@@ -1,19 +1,29 @@
 #ifndef EU4_PROVINCE_DETAILS_H
 #define EU4_PROVINCE_DETAILS_H
 
-#include "Parser.h"
+#include "../../Parsing/CopyOnWrite.h"
+#include "../Country/Tag.h"
 #include "ProvinceModifier.h"
+#include <istream>
 #include <set>
+#include <string>
+#include <vector>
+
+namespace parsing
+{
+template <typename Entity> class TokenTable;
+}
 
 namespace EU4
 {
-class ProvinceDetails: commonItems::parser
+class ProvinceDetails
 {
   public:
 	ProvinceDetails() = default;
 	explicit ProvinceDetails(const std::string& filePath);
 	explicit ProvinceDetails(std::istream& theStream);
 	void updateWith(const std::string& filePath);
+	[[nodiscard]] std::size_t heapBytes() const; // for CK2::MemoryCensus
 
 	// These values are open to ease management.
 	// This is a storage container for EU4::Province.
@@ -47,16 +57,16 @@ class ProvinceDetails: commonItems::parser
 	std::string tradeGoods;
 	std::string estate;
 	std::string datedInfo; // For things set with 1444.1.1
-	std::set<std::string> cores;
-	std::set<std::string> discoveredBy;
+	std::set<Tag> cores;
+	parsing::CopyOnWrite<std::set<std::string>> discoveredBy; // imported provinces all share one list
 	std::set<std::string> latentGoods;
 	std::set<std::string> provinceTriggeredModifiers;
-	std::set<std::string> claims;
-	std::set<std::string> permanentClaims;
+	std::set<Tag> claims;
+	std::set<Tag> permanentClaims;
 	std::vector<ProvinceModifier> provinceModifiers;
 
   private:
-	void registerKeys();
+	static parsing::TokenTable<ProvinceDetails> registerKeys();
 };
 } // namespace EU4
 
@@ -1,23 +1,21 @@
 #include "ProvinceModifier.h"
-#include "CommonRegexes.h"
-#include "ParserHelpers.h"
+#include "../../Parsing/TokenTable.h"
 
-EU4::ProvinceModifier::ProvinceModifier(std::istream& theStream)
+EU4::ProvinceModifier::ProvinceModifier(parsing::Tokenizer& tokens)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	static const auto tokenTable = registerKeys();
+	tokenTable.parse(*this, tokens);
 }
 
-void EU4::ProvinceModifier::registerKeys()
+parsing::TokenTable<EU4::ProvinceModifier> EU4::ProvinceModifier::registerKeys()
 {
-	registerKeyword("name", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString nameStr(theStream);
-		name = nameStr.getString();
+	parsing::TokenTable<ProvinceModifier> tokenTable;
+	tokenTable.registerKeyword("name", [](ProvinceModifier& modifier, std::string_view unused, parsing::Tokenizer& tokens) {
+		modifier.name = tokens.getString();
 	});
-	registerKeyword("duration", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleInt durInt(theStream);
-		duration = durInt.getInt();
+	tokenTable.registerKeyword("duration", [](ProvinceModifier& modifier, std::string_view unused, parsing::Tokenizer& tokens) {
+		modifier.duration = tokens.getInt();
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	tokenTable.ignoreUnregistered();
+	return tokenTable;
 }
@@ -1,15 +1,21 @@
 #ifndef EU4_PROVINCE_MODIFIER_H
 #define EU4_PROVINCE_MODIFIER_H
 
-#include "Parser.h"
+#include <string>
+
+namespace parsing
+{
+class Tokenizer;
+template <typename Entity> class TokenTable;
+}
 
 namespace EU4
 {
-class ProvinceModifier: commonItems::parser
+class ProvinceModifier
 {
   public:
 	ProvinceModifier() = default;
-	explicit ProvinceModifier(std::istream& theStream);
+	explicit ProvinceModifier(parsing::Tokenizer& tokens);
 
 	// These values are open to ease management.
 	// This is a storage container for EU4::ProvinceDetails.
@@ -17,7 +23,7 @@ class ProvinceModifier: commonItems::parser
 	int duration = -1;
 
   private:
-	void registerKeys();
+	static parsing::TokenTable<ProvinceModifier> registerKeys();
 };
 } // namespace EU4
 
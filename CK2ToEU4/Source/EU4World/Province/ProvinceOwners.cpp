@@ -0,0 +1,37 @@
+#include "ProvinceOwners.h"
+#include "EU4Province.h"
+#include "ProvinceTable.h"
+
+void EU4::ProvinceOwners::rebuild(const ProvinceTable& provinces)
+{
+	byOwner.clear();
+	for (const auto& [provinceID, province]: provinces)
+	{
+		if (!province)
+			continue;
+		province->registerOwnerIndex(this);
+		if (!province->getOwner().empty())
+			byOwner[province->getOwner()].insert(provinceID);
+	}
+}
+
+const std::set<int>& EU4::ProvinceOwners::provincesOf(const std::string& tag) const
+{
+	static const std::set<int> none;
+	const auto ownerItr = byOwner.find(tag);
+	return ownerItr != byOwner.end() ? ownerItr->second : none;
+}
+
+void EU4::ProvinceOwners::moved(const int provinceID, const std::string& from, const std::string& to)
+{
+	if (from == to)
+		return;
+	if (const auto ownerItr = byOwner.find(from); ownerItr != byOwner.end())
+	{
+		ownerItr->second.erase(provinceID);
+		if (ownerItr->second.empty())
+			byOwner.erase(ownerItr);
+	}
+	if (!to.empty())
+		byOwner[to].insert(provinceID);
+}
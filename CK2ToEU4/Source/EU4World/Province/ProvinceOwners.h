@@ -0,0 +1,36 @@
+#ifndef EU4_PROVINCE_OWNERS_H
+#define EU4_PROVINCE_OWNERS_H
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
+namespace EU4
+{
+class Province;
+class ProvinceTable;
+
+// Province IDs by owner tag. The late passes (China, Siberia, India) want one tag's provinces, and the countries'
+// own province maps go stale as soon as those passes start handing provinces around. Provinces registered here
+// report every owner change they go through (setOwner, transferTo, sterilize), so the index stays current without
+// anyone sweeping the whole map again.
+//
+// Owners set before the index is built, side by side during province import, are picked up by rebuild().
+class ProvinceOwners
+{
+  public:
+	// Indexes every province and registers the index in each.
+	void rebuild(const ProvinceTable& provinces);
+
+	// Empty for tags that own nothing. Copy it before changing owners while walking it.
+	[[nodiscard]] const std::set<int>& provincesOf(const std::string& tag) const;
+
+  private:
+	friend class Province;
+	void moved(int provinceID, const std::string& from, const std::string& to);
+
+	std::map<std::string, std::set<int>, std::less<>> byOwner; // uncolonized and sterilized provinces aren't kept
+};
+} // namespace EU4
+
+#endif // EU4_PROVINCE_OWNERS_H
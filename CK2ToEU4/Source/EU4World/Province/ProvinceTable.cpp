@@ -0,0 +1,75 @@
+#include "ProvinceTable.h"
+#include <algorithm>
+
+namespace
+{
+// Vanilla stops below 5000. Leaves mods plenty of room without letting a stray filename size the index.
+constexpr std::size_t indexLimit = 64 * 1024;
+
+bool lessByID(const EU4::ProvinceTable::value_type& entry, const int ID)
+{
+	return entry.first < ID;
+}
+} // namespace
+
+bool EU4::ProvinceTable::insert(value_type entry)
+{
+	const auto position = std::lower_bound(entries.begin(), entries.end(), entry.first, lessByID);
+	if (position != entries.end() && position->first == entry.first)
+		return false;
+	const auto atEnd = position == entries.end();
+	const auto ID = entry.first;
+	entries.insert(position, std::move(entry));
+
+	// An append only needs its own slot. Anything else shifted the run; at a few thousand provinces reindexing is cheap.
+	if (atEnd && ID >= 0 && static_cast<std::size_t>(ID) < indexLimit)
+	{
+		if (positions.size() <= static_cast<std::size_t>(ID))
+			positions.resize(static_cast<std::size_t>(ID) + 1, 0);
+		positions[ID] = static_cast<std::uint32_t>(entries.size());
+	}
+	else if (!atEnd)
+		reindex();
+	return true;
+}
+
+void EU4::ProvinceTable::insert_or_assign(const int ID, std::shared_ptr<Province> province)
+{
+	const auto position = std::lower_bound(entries.begin(), entries.end(), ID, lessByID);
+	if (position != entries.end() && position->first == ID)
+		position->second = std::move(province);
+	else
+		insert(std::pair(ID, std::move(province)));
+}
+
+EU4::ProvinceTable::const_iterator EU4::ProvinceTable::find(const int ID) const
+{
+	if (ID >= 0 && static_cast<std::size_t>(ID) < indexLimit)
+	{
+		if (static_cast<std::size_t>(ID) >= positions.size())
+			return entries.end();
+		const auto position = positions[ID];
+		return position ? entries.begin() + (position - 1) : entries.end();
+	}
+
+	const auto position = std::lower_bound(entries.begin(), entries.end(), ID, lessByID);
+	if (position != entries.end() && position->first == ID)
+		return position;
+	return entries.end();
+}
+
+void EU4::ProvinceTable::reindex()
+{
+	positions.clear();
+	for (std::size_t position = 0; position < entries.size(); ++position)
+	{
+		const auto ID = entries[position].first;
+		if (ID < 0)
+			continue;
+		if (static_cast<std::size_t>(ID) >= indexLimit)
+			break;
+		if (positions.size() <= static_cast<std::size_t>(ID))
+			positions.resize(static_cast<std::size_t>(ID) + 1, 0);
+		positions[ID] = static_cast<std::uint32_t>(position + 1);
+	}
+}
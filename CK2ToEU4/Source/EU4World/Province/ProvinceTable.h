@@ -0,0 +1,47 @@
+#ifndef EU4_PROVINCE_TABLE_H
+#define EU4_PROVINCE_TABLE_H
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace EU4
+{
+class Province;
+
+// EU4 provinces by ID. The IDs come from history/provinces and run densely from 1 to a few thousand, so the
+// provinces sit in one run sorted by ID with an ID -> position index next to it, the same layout CK2::CharacterTable
+// uses. The world-wide passes (development, cores, claims, forts) become a straight sweep over that run instead of
+// a red-black tree walk, and lookups by ID are a bounds check and two loads.
+class ProvinceTable
+{
+  public:
+	using value_type = std::pair<int, std::shared_ptr<Province>>;
+	using const_iterator = std::vector<value_type>::const_iterator;
+
+	ProvinceTable() = default;
+
+	// Same contract as map::insert, false if the ID is already taken.
+	bool insert(value_type entry);
+	// Same contract as map::insert_or_assign.
+	void insert_or_assign(int ID, std::shared_ptr<Province> province);
+
+	[[nodiscard]] const_iterator find(int ID) const;
+	[[nodiscard]] std::size_t count(const int ID) const { return find(ID) != end() ? 1 : 0; }
+
+	[[nodiscard]] const_iterator begin() const { return entries.begin(); }
+	[[nodiscard]] const_iterator end() const { return entries.end(); }
+	[[nodiscard]] std::size_t size() const { return entries.size(); }
+	[[nodiscard]] bool empty() const { return entries.empty(); }
+	[[nodiscard]] std::size_t heapBytes() const { return entries.capacity() * sizeof(value_type) + positions.capacity() * sizeof(std::uint32_t); }
+
+  private:
+	void reindex();
+
+	std::vector<value_type> entries;
+	// positions[ID] is the entry's position + 1, 0 if there is no such province. A mod numbering provinces in the
+	// millions gets those binary searched instead.
+	std::vector<std::uint32_t> positions;
+};
+} // namespace EU4
+
+#endif // EU4_PROVINCE_TABLE_H
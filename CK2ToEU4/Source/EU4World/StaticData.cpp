@@ -0,0 +1,214 @@
+#include "StaticData.h"
+#include "../CK2World/Concurrency.h"
+#include "../CK2World/Contention.h"
+#include "../CK2World/TaskGraph.h"
+#include "../CK2World/Trace.h"
+#include "../Configuration/Configuration.h"
+#include "Diplomacy/Diplomacy.h"
+#include "Log.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace
+{
+CK2::Contention::Site loadWaits("shared static data loads");
+
+std::string setupKey(const Configuration& theConfiguration, const Mods& mods, const std::string& overrideModPath)
+{
+	auto key = overrideModPath + "|" + theConfiguration.getCK2Path() + "|" + theConfiguration.getEU4Path();
+	for (const auto& mod: mods)
+		key += "|" + mod.name + "=" + mod.path;
+
+	// A server keeps its mappers for as long as it runs; editing a mapping file between jobs should still take.
+	std::filesystem::file_time_type newest{};
+	std::size_t files = 0;
+	std::error_code error;
+	for (std::filesystem::recursive_directory_iterator entry("configurables", error), end; !error && entry != end; entry.increment(error))
+		if (entry->is_regular_file(error))
+		{
+			newest = std::max(newest, entry->last_write_time(error));
+			++files;
+		}
+	key += "|" + std::to_string(files) + "@" + std::to_string(newest.time_since_epoch().count());
+	return key;
+}
+} // namespace
+
+template <typename Item>
+std::shared_ptr<const Item> EU4::StaticData::once(Loads<Item>& loads, const std::string& key, const std::function<std::shared_ptr<const Item>()>& load)
+{
+	std::promise<std::shared_ptr<const Item>> loading;
+	std::shared_future<std::shared_ptr<const Item>> loaded;
+	{
+		const std::lock_guard lock(loadsMutex);
+		const auto [existing, inserted] = loads.emplace(key, loading.get_future().share());
+		if (!inserted)
+			loaded = existing->second;
+	}
+	// Somebody else got here first; a load that fails for them fails for us too.
+	if (loaded.valid())
+	{
+		if (CK2::Contention::enabled() && loaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			const auto start = CK2::Contention::Clock::now();
+			loaded.wait();
+			loadWaits.waited(start, CK2::Contention::Clock::now());
+		}
+		return loaded.get();
+	}
+
+	try
+	{
+		auto item = load();
+		loading.set_value(item);
+		return item;
+	}
+	catch (...)
+	{
+		// Whoever is waiting fails with us, but a server's later jobs get to try again.
+		loading.set_exception(std::current_exception());
+		{
+			const std::lock_guard lock(loadsMutex);
+			loads.erase(key);
+		}
+		throw;
+	}
+}
+
+std::shared_ptr<const CK2::InstallData> EU4::StaticData::ck2Install(const Configuration& theConfiguration, const Mods& mods)
+{
+	auto key = theConfiguration.getCK2Path();
+	for (const auto& mod: mods)
+		key += "|" + mod.name + "=" + mod.path;
+	return once<CK2::InstallData>(loadedInstalls, key, [&] {
+		return CK2::InstallData::load(theConfiguration, mods, true);
+	});
+}
+
+CK2::InstallSource EU4::StaticData::ck2InstallSource()
+{
+	return [this](const Configuration& theConfiguration, const Mods& mods, const bool withDynasties) {
+		preloadMappers(theConfiguration, mods);
+		if (!sharedByConversions)
+			return CK2::InstallData::load(theConfiguration, mods, withDynasties);
+		return ck2Install(theConfiguration, mods);
+	};
+}
+
+std::string EU4::StaticData::overrideModPath(const Mods& mods)
+{
+	std::string overrideModPath;
+	for (const auto& mod: mods)
+		if (mod.name == "CleanSlate")
+			overrideModPath = "CleanSlate";
+		else if (mod.name == "Tianxia: Silk Road Expansion")
+			overrideModPath = "Tianxia";
+	return overrideModPath;
+}
+
+void EU4::StaticData::preloadMappers(const Configuration& theConfiguration, const Mods& mods)
+{
+	// Copies, as the conversion may fail and take its configuration with it while this is still loading.
+	preload("Preloading the mappers", [this, theConfiguration, mods] {
+		auto loaded = mappers(theConfiguration, mods, overrideModPath(mods));
+	});
+}
+
+void EU4::StaticData::preload(const std::string& what, std::function<void()> load)
+{
+	// Deferred work would only run once somebody waited on it, here in the destructor.
+	if (CK2::Concurrency::serial())
+		return;
+	const std::lock_guard lock(preloadsMutex);
+	std::erase_if(preloads, [](const std::future<void>& preload) {
+		return preload.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+	preloads.emplace_back(std::async(std::launch::async, CK2::Concurrency::carry([what, load = std::move(load)] {
+		try
+		{
+			load();
+		}
+		catch (const std::exception& e)
+		{
+			Log(LogLevel::Warning) << what << " failed: " << e.what();
+		}
+	})));
+}
+
+std::shared_ptr<const EU4::StaticData::Mappers> EU4::StaticData::mappers(const Configuration& theConfiguration,
+	 const Mods& mods,
+	 const std::string& overrideModPath)
+{
+	return once<Mappers>(loadedMappers, setupKey(theConfiguration, mods, overrideModPath), [&]() -> std::shared_ptr<const Mappers> {
+		auto loaded = std::make_shared<Mappers>();
+		loaded->overrideModPath = overrideModPath;
+
+		// Each loader reads its own files into its own mapper, so they all load side by side. The only join is the
+		// culture mapper, whose rules resolve their regions into provinces once the region mapper is in.
+		const CK2::TraceSpan span("Loading Mapper Files");
+		std::shared_ptr<mappers::RegionMapper> regionMapper;
+		CK2::TaskGraph loading;
+		loading.addTask("Culture Mapper", {}, [&] {
+			loaded->cultureMapper.initCultureMapper(overrideModPath);
+		});
+		loading.addTask("Governments Mapper", {}, [&] {
+			loaded->governmentsMapper.initGovernmentsMapper(overrideModPath);
+		});
+		loading.addTask("Ruler Personalities Mapper", {}, [&] {
+			loaded->rulerPersonalitiesMapper.initRulerPersonalitiesMapper(overrideModPath);
+		});
+		loading.addTask("Religion Mapper", {}, [&] {
+			loaded->religionMapper.initReligionMapper(overrideModPath);
+		});
+		loading.addTask("Title Tag Mapper", {}, [&] {
+			loaded->titleTagRules = std::make_shared<const mappers::TitleTagRules>(overrideModPath);
+		});
+		loading.addTask("Localizations", {}, [&] {
+			// Scraping localizations from CK2 so we may know proper names for our countries.
+			loaded->localizationMapper.scrapeLocalizations(theConfiguration, mods);
+		});
+		loading.addTask("Primary Tags", {}, [&] {
+			// Scrape Primary Tags for nationalities
+			loaded->primaryTagMapper.loadPrimaryTags(theConfiguration);
+		});
+		loading.addTask("Colors", {}, [&] {
+			// Ditto for colors - these only apply on non-eu4 countries.
+			loaded->colorScraper.scrapeColors(theConfiguration, mods);
+		});
+		loading.addTask("Regions", {}, [&] {
+			// This is our region mapper for eu4 regions, areas and superRegions. It's a pointer because we need
+			// to embed it into every cultureMapper individual mapping. It works faster that way.
+			regionMapper = std::make_shared<mappers::RegionMapper>();
+			regionMapper->loadRegions(theConfiguration);
+		});
+		loading.addTask("Culture Regions", {"Culture Mapper", "Regions"}, [&] {
+			// And this is the cultureMapper. It's of vital importance.
+			loaded->cultureMapper.loadRegionMapper(regionMapper);
+		});
+		loading.addTask("Eastern Diplomacy", {}, [&] {
+			loaded->easternTributaries = Diplomacy::loadEasternTributaries();
+		});
+		loading.addTask("Province Mappings", {}, [&] {
+			// The valid province scraper looks at eu4 map data and notes which eu4 provinces are in fact valid. It's not
+			// used at all, so the map data is only read if somebody ever asks.
+			auto provinceMapper = std::make_shared<mappers::ProvinceMapper>(mods, overrideModPath);
+			provinceMapper->determineValidProvinces(theConfiguration);
+			loaded->provinceMapper = provinceMapper;
+		});
+		loading.run();
+		loaded->regionMapper = regionMapper;
+		return loaded;
+	});
+}
+
+std::shared_ptr<const EU4::VanillaImage> EU4::StaticData::vanillaImage(const std::string& key,
+	 const std::function<std::shared_ptr<const VanillaImage>()>& load)
+{
+	return once<VanillaImage>(loadedImages, key, load);
+}
+
+bool EU4::StaticData::holdsImage(const std::string& key)
+{
+	const std::lock_guard lock(loadsMutex);
+	return loadedImages.contains(key);
+}
@@ -0,0 +1,103 @@
+#ifndef EU4_STATIC_DATA_H
+#define EU4_STATIC_DATA_H
+#include "../CK2World/InstallData.h"
+#include "../Mappers/AfricanPassesMapper/AfricanPassesMapper.h"
+#include "../Mappers/ColorScraper/ColorScraper.h"
+#include "../Mappers/CultureMapper/CultureMapper.h"
+#include "../Mappers/DevWeightsMapper/DevWeightsMapper.h"
+#include "../Mappers/GovernmentsMapper/GovernmentsMapper.h"
+#include "../Mappers/LocalizationMapper/LocalizationMapper.h"
+#include "../Mappers/PrimaryTagMapper/PrimaryTagMapper.h"
+#include "../Mappers/ProvinceMapper/ProvinceMapper.h"
+#include "../Mappers/RegionMapper/RegionMapper.h"
+#include "../Mappers/ReligionMapper/ReligionMapper.h"
+#include "../Mappers/RulerPersonalitiesMapper/RulerPersonalitiesMapper.h"
+#include "../Mappers/TitleTagMapper/TitleTagMapper.h"
+#include "Diplomacy/Agreement.h"
+#include "ModLoader/ModLoader.h"
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Configuration;
+
+namespace EU4
+{
+struct VanillaImage;
+
+// What a conversion reads from the installs and configurables and never changes afterwards: the CK2 install data, the
+// mappers, and the vanilla countries and provinces as they stand before CK2 touches them. A batch shares one StaticData between all
+// its conversions, so each distinct setup (installs, override mod, mod list) is loaded once however many saves go
+// through it; a lone conversion simply has its own. The first conversion to ask for a setup loads it, the others
+// asking meanwhile wait for it.
+class StaticData
+{
+  public:
+	// A lone conversion's StaticData doesn't bother keeping images of the vanilla state for anyone else.
+	explicit StaticData(bool shared = false): sharedByConversions(shared) {}
+
+	struct Mappers
+	{
+		std::string overrideModPath; // CleanSlate, Tianxia or empty
+		mappers::ColorScraper colorScraper;
+		std::shared_ptr<const mappers::RegionMapper> regionMapper;
+		std::shared_ptr<const mappers::ProvinceMapper> provinceMapper;
+		std::shared_ptr<const mappers::TitleTagRules> titleTagRules; // every conversion claims its tags in a TitleTagMapper of its own
+		mappers::ReligionMapper religionMapper;
+		mappers::CultureMapper cultureMapper;
+		mappers::GovernmentsMapper governmentsMapper;
+		mappers::LocalizationMapper localizationMapper;
+		mappers::RulerPersonalitiesMapper rulerPersonalitiesMapper;
+		mappers::PrimaryTagMapper primaryTagMapper;
+		mappers::DevWeightsMapper devWeightsMapper;
+		mappers::AfricanPassesMapper africanPassesMapper;
+		std::vector<Agreement> easternTributaries; // each conversion's Diplomacy starts from copies of these
+	};
+
+	[[nodiscard]] bool shared() const { return sharedByConversions; }
+
+	// The CK2 install data of a setup, dynasties included.
+	[[nodiscard]] std::shared_ptr<const CK2::InstallData> ck2Install(const Configuration& theConfiguration, const Mods& mods);
+	// For CK2::World: ck2Install() when shared, a plain InstallData::load() otherwise. Either way asking also starts
+	// preloadMappers(), as that's the moment the mod list is known.
+	[[nodiscard]] CK2::InstallSource ck2InstallSource();
+
+	// CleanSlate, Tianxia or empty.
+	[[nodiscard]] static std::string overrideModPath(const Mods& mods);
+	// Starts loading the mappers of this setup in the background, so they load while the save is being read. The
+	// world that then asks for them waits for whatever is left, and loads them itself if this failed. Serial
+	// conversions don't preload.
+	void preloadMappers(const Configuration& theConfiguration, const Mods& mods);
+	// Runs load in the background, joined when this goes away at the latest. A failure is only logged, under what;
+	// whoever then asks for what it loads tries again. Serial conversions don't preload.
+	void preload(const std::string& what, std::function<void()> load);
+
+	// A world's "Loading Mappers" phase is either this load or the wait for a preload of it.
+	[[nodiscard]] std::shared_ptr<const Mappers> mappers(const Configuration& theConfiguration, const Mods& mods, const std::string& overrideModPath);
+
+	// A VanillaCache image of the vanilla countries or provinces. The first conversion to ask imports them itself and
+	// returns their image from load(); the others copy theirs out of that image.
+	[[nodiscard]] std::shared_ptr<const VanillaImage> vanillaImage(const std::string& key, const std::function<std::shared_ptr<const VanillaImage>()>& load);
+	// Whether somebody has already imported, or is importing, the image under key.
+	[[nodiscard]] bool holdsImage(const std::string& key);
+
+  private:
+	template <typename Item> using Loads = std::map<std::string, std::shared_future<std::shared_ptr<const Item>>>;
+	template <typename Item>
+	[[nodiscard]] std::shared_ptr<const Item> once(Loads<Item>& loads, const std::string& key, const std::function<std::shared_ptr<const Item>()>& load);
+
+	bool sharedByConversions = false;
+	std::mutex loadsMutex;
+	Loads<CK2::InstallData> loadedInstalls;
+	Loads<Mappers> loadedMappers;
+	Loads<VanillaImage> loadedImages;
+	std::mutex preloadsMutex;
+	std::vector<std::future<void>> preloads; // last, so they're joined before anything they load into goes away
+};
+} // namespace EU4
+
+#endif // EU4_STATIC_DATA_H
@@ -0,0 +1,688 @@
+#include "VanillaCache.h"
+#include "../CK2World/CacheStore.h"
+#include "../Parsing/DateScan.h"
+#include "Country/Country.h"
+#include "Log.h"
+#include "Province/EU4Province.h"
+#include "Province/ProvinceTable.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+namespace fs = std::filesystem;
+
+namespace
+{
+const std::string cacheMagic = "CK2ToEU4 vanilla cache";
+// Bump whenever anything below writes a field more, less or differently.
+constexpr std::uint32_t formatVersion = 2;
+} // namespace
+
+// Values go out as-is, containers as a count followed by their elements, everything else through VanillaCache::write.
+class EU4::VanillaCache::Writer
+{
+  public:
+	explicit Writer(std::ostream& theStream): stream(theStream) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> void put(const T value) { stream.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+	void put(const std::string& value)
+	{
+		put(static_cast<std::uint64_t>(value.size()));
+		stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+	}
+	void put(const Tag& value) { put(value.str()); }
+	void put(const date& value) { put(value.toString()); }
+	void put(const commonItems::Color& value)
+	{
+		for (const auto component: value.getRgbComponents())
+			put(component);
+	}
+	template <typename T> requires std::is_class_v<T> void put(const T& entity) { write(*this, entity); }
+	template <typename T> void put(const std::shared_ptr<T>& value)
+	{
+		put(value != nullptr);
+		if (value)
+			put(*value);
+	}
+	template <typename T> void put(const std::optional<T>& value)
+	{
+		put(value.has_value());
+		if (value)
+			put(*value);
+	}
+	template <typename First, typename Second> void put(const std::pair<First, Second>& value)
+	{
+		put(value.first);
+		put(value.second);
+	}
+	template <typename T> void put(const std::vector<T>& values) { putRange(values); }
+	template <typename T> void put(const std::set<T>& values) { putRange(values); }
+	template <typename Key, typename Value> void put(const std::map<Key, Value>& values) { putRange(values); }
+	template <typename Value> void put(const parsing::NameMap<Value>& values) { putRange(values); }
+	void put(const ProvinceTable& values) { putRange(values); }
+
+  private:
+	template <typename Range> void putRange(const Range& values)
+	{
+		put(static_cast<std::uint64_t>(values.size()));
+		for (const auto& value: values)
+			put(value);
+	}
+
+	std::ostream& stream;
+};
+
+// Mirror of Writer. Running off the end of the data throws, load() turns that into "no usable cache".
+class EU4::VanillaCache::Reader
+{
+  public:
+	Reader(const char* theData, const std::size_t theSize): data(theData), size(theSize) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> void get(T& value) { std::memcpy(&value, take(sizeof(T)), sizeof(T)); }
+	void get(std::string& value)
+	{
+		const auto length = getCount();
+		value.assign(take(length), length);
+	}
+	void get(Tag& value)
+	{
+		std::string tagString;
+		get(tagString);
+		value = Tag(tagString);
+	}
+	void get(date& value)
+	{
+		std::string dateString;
+		get(dateString);
+		value = parsing::parseDate(dateString);
+	}
+	void get(commonItems::Color& value)
+	{
+		std::array<int, 3> components{};
+		for (auto& component: components)
+			get(component);
+		value = commonItems::Color(components);
+	}
+	template <typename T> requires std::is_class_v<T> void get(T& entity) { read(*this, entity); }
+	template <typename T> void get(std::shared_ptr<T>& value)
+	{
+		value.reset();
+		if (getFlag())
+		{
+			value = std::make_shared<T>();
+			get(*value);
+		}
+	}
+	template <typename T> void get(std::optional<T>& value)
+	{
+		value.reset();
+		if (getFlag())
+		{
+			T newValue{};
+			get(newValue);
+			value = std::move(newValue);
+		}
+	}
+	template <typename First, typename Second> void get(std::pair<First, Second>& value)
+	{
+		get(value.first);
+		get(value.second);
+	}
+	template <typename T> void get(std::vector<T>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+			get(values.emplace_back());
+	}
+	template <typename T> void get(std::set<T>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			T value{};
+			get(value);
+			values.insert(values.end(), std::move(value));
+		}
+	}
+	template <typename Key, typename Value> void get(std::map<Key, Value>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			std::pair<Key, Value> value;
+			get(value);
+			values.insert(values.end(), std::move(value));
+		}
+	}
+	template <typename Value> void get(parsing::NameMap<Value>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			std::pair<std::string, Value> value;
+			get(value);
+			values.emplace_hint(values.end(), std::move(value));
+		}
+	}
+	void get(ProvinceTable& values)
+	{
+		values = ProvinceTable();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			ProvinceTable::value_type entry;
+			get(entry);
+			values.insert(std::move(entry));
+		}
+	}
+
+	[[nodiscard]] bool getFlag()
+	{
+		auto flag = false;
+		get(flag);
+		return flag;
+	}
+	[[nodiscard]] std::size_t getCount()
+	{
+		std::uint64_t count = 0;
+		get(count);
+		// Every element takes at least a byte, anything larger than what's left is a corrupted count.
+		if (count > size - position)
+			throw std::runtime_error("Vanilla cache is truncated.");
+		return static_cast<std::size_t>(count);
+	}
+	[[nodiscard]] bool atEnd() const { return position == size; }
+
+  private:
+	const char* take(const std::size_t length)
+	{
+		if (length > size - position)
+			throw std::runtime_error("Vanilla cache is truncated.");
+		const auto* taken = data + position;
+		position += length;
+		return taken;
+	}
+
+	const char* data;
+	std::size_t size;
+	std::size_t position = 0;
+};
+
+std::string EU4::VanillaCache::fingerprint(const std::vector<std::string>& folders)
+{
+	// 64-bit FNV-1a over "path size mtime" lines, in path order so the walk order of the filesystem doesn't matter.
+	std::uint64_t hash = 14695981039346656037ull;
+	const auto feed = [&hash](const std::string& text) {
+		for (const auto character: text)
+		{
+			hash ^= static_cast<unsigned char>(character);
+			hash *= 1099511628211ull;
+		}
+	};
+
+	for (const auto& folder: folders)
+	{
+		std::vector<std::string> lines;
+		std::error_code error;
+		for (fs::recursive_directory_iterator entry(fs::u8path(folder), error), end; !error && entry != end; entry.increment(error))
+		{
+			if (!entry->is_regular_file(error))
+				continue;
+			const auto fileSize = entry->file_size(error);
+			const auto modified = entry->last_write_time(error).time_since_epoch().count();
+			lines.emplace_back(entry->path().generic_string() + " " + std::to_string(fileSize) + " " + std::to_string(modified) + "\n");
+		}
+		std::sort(lines.begin(), lines.end());
+		feed(folder + "\n");
+		for (const auto& line: lines)
+			feed(line);
+	}
+
+	std::stringstream digest;
+	digest << std::hex << std::setw(16) << std::setfill('0') << hash;
+	return digest.str();
+}
+
+std::string EU4::VanillaCache::makeKey(const std::string& converterVersion, const std::string& eu4Path, const bool invasion)
+{
+	// Everything importVanillaCountries and importVanillaProvinces read.
+	const auto installPrint = fingerprint({eu4Path + "/common/country_tags/",
+		 eu4Path + "/common/countries/",
+		 eu4Path + "/history/countries/",
+		 eu4Path + "/history/provinces/",
+		 "blankMod/output/common/",
+		 "blankMod/output/history/",
+		 "configurables/sunset/"});
+	return converterVersion + "|" + eu4Path + "|" + (invasion ? "sunset" : "vanilla") + "|" + installPrint;
+}
+
+void EU4::VanillaCache::saveCountries(const std::string& cachePath,
+	 const std::string& key,
+	 const parsing::NameMap<std::shared_ptr<Country>>& countries,
+	 const std::set<std::string>& specialCountryTags)
+{
+	save(cachePath, key, [&countries, &specialCountryTags](Writer& writer) {
+		writer.put(countries);
+		writer.put(specialCountryTags);
+	});
+}
+
+bool EU4::VanillaCache::loadCountries(const std::string& cachePath,
+	 const std::string& key,
+	 parsing::NameMap<std::shared_ptr<Country>>& countries,
+	 std::set<std::string>& specialCountryTags)
+{
+	return load(cachePath, key, [&countries, &specialCountryTags](Reader& reader) {
+		reader.get(countries);
+		reader.get(specialCountryTags);
+	});
+}
+
+void EU4::VanillaCache::saveProvinces(const std::string& cachePath, const std::string& key, const ProvinceTable& provinces)
+{
+	save(cachePath, key, [&provinces](Writer& writer) {
+		writer.put(provinces);
+	});
+}
+
+bool EU4::VanillaCache::loadProvinces(const std::string& cachePath, const std::string& key, ProvinceTable& provinces)
+{
+	return load(cachePath, key, [&provinces](Reader& reader) {
+		reader.get(provinces);
+	});
+}
+
+std::shared_ptr<const EU4::VanillaImage> EU4::VanillaCache::countriesImage(const parsing::NameMap<std::shared_ptr<Country>>& countries,
+	 const std::set<std::string>& specialCountryTags)
+{
+	auto image = std::make_shared<VanillaImage>();
+	for (const auto& [tag, country]: countries)
+		image->countries.emplace(tag, std::make_shared<const Country>(*country));
+	image->specialCountryTags = specialCountryTags;
+	return image;
+}
+
+void EU4::VanillaCache::loadCountriesImage(const VanillaImage& image,
+	 parsing::NameMap<std::shared_ptr<Country>>& countries,
+	 std::set<std::string>& specialCountryTags)
+{
+	countries.clear();
+	for (const auto& [tag, country]: image.countries)
+		countries.emplace_hint(countries.end(), tag, std::make_shared<Country>(*country));
+	specialCountryTags = image.specialCountryTags;
+}
+
+std::shared_ptr<const EU4::VanillaImage> EU4::VanillaCache::provincesImage(const ProvinceTable& provinces)
+{
+	auto image = std::make_shared<VanillaImage>();
+	image->provinces.reserve(provinces.size());
+	for (const auto& [provinceID, province]: provinces)
+		image->provinces.emplace_back(provinceID, std::make_shared<const Province>(*province));
+	return image;
+}
+
+void EU4::VanillaCache::loadProvincesImage(const VanillaImage& image, ProvinceTable& provinces)
+{
+	provinces = ProvinceTable();
+	for (const auto& [provinceID, province]: image.provinces)
+		provinces.insert({provinceID, std::make_shared<Province>(*province)});
+}
+
+void EU4::VanillaCache::save(const std::string& cachePath, const std::string& key, const std::function<void(Writer&)>& body)
+{
+	// On disk the image is a store entry under the same key, so the store's checks come on top of the image's own.
+	CK2::CacheStore::save(cachePath, key, [&key, &body](std::ostream& output) {
+		writeImage(output, key, body);
+	}, CK2::CacheStore::SHARING::FARM);
+}
+
+bool EU4::VanillaCache::load(const std::string& cachePath, const std::string& key, const std::function<void(Reader&)>& body)
+{
+	const auto entry = CK2::CacheStore::load(cachePath, key, CK2::CacheStore::SHARING::FARM);
+	return entry && readImage(entry->data(), entry->size(), cachePath, key, body);
+}
+
+void EU4::VanillaCache::writeImage(std::ostream& output, const std::string& key, const std::function<void(Writer&)>& body)
+{
+	Writer writer(output);
+	writer.put(cacheMagic);
+	writer.put(formatVersion);
+	writer.put(key);
+	body(writer);
+}
+
+bool EU4::VanillaCache::readImage(const char* data,
+	 const std::size_t size,
+	 const std::string& source,
+	 const std::string& key,
+	 const std::function<void(Reader&)>& body)
+{
+	try
+	{
+		Reader reader(data, size);
+
+		std::string magic;
+		reader.get(magic);
+		std::uint32_t version = 0;
+		reader.get(version);
+		std::string cacheKey;
+		if (magic == cacheMagic && version == formatVersion)
+			reader.get(cacheKey);
+		if (cacheKey != key)
+		{
+			Log(LogLevel::Info) << "<> Vanilla cache " << source << " is out of date, ignoring it.";
+			return false;
+		}
+
+		body(reader);
+		if (!reader.atEnd())
+			throw std::runtime_error("Trailing data after the vanilla cache.");
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Vanilla cache " << source << " is unusable: " << e.what();
+		return false;
+	}
+	return true;
+}
+
+void EU4::VanillaCache::write(Writer& writer, const Character& character)
+{
+	writer.put(character.isSet);
+	writer.put(character.regency);
+	writer.put(character.discount);
+	writer.put(character.female);
+	writer.put(character.regent);
+	writer.put(character.adm);
+	writer.put(character.dip);
+	writer.put(character.mil);
+	writer.put(character.claim);
+	writer.put(character.id);
+	writer.put(character.location);
+	writer.put(character.skill);
+	writer.put(character.name);
+	writer.put(character.monarchName);
+	writer.put(character.dynasty);
+	writer.put(character.religion);
+	writer.put(character.culture);
+	writer.put(character.originCountry);
+	writer.put(character.personalities);
+	writer.put(character.type);
+	writer.put(character.birthDate);
+	writer.put(character.deathDate);
+	writer.put(character.appearDate);
+}
+
+void EU4::VanillaCache::read(Reader& reader, Character& character)
+{
+	reader.get(character.isSet);
+	reader.get(character.regency);
+	reader.get(character.discount);
+	reader.get(character.female);
+	reader.get(character.regent);
+	reader.get(character.adm);
+	reader.get(character.dip);
+	reader.get(character.mil);
+	reader.get(character.claim);
+	reader.get(character.id);
+	reader.get(character.location);
+	reader.get(character.skill);
+	reader.get(character.name);
+	reader.get(character.monarchName);
+	reader.get(character.dynasty);
+	reader.get(character.religion);
+	reader.get(character.culture);
+	reader.get(character.originCountry);
+	reader.get(character.personalities);
+	reader.get(character.type);
+	reader.get(character.birthDate);
+	reader.get(character.deathDate);
+	reader.get(character.appearDate);
+}
+
+void EU4::VanillaCache::write(Writer& writer, const Country& country)
+{
+	// Only what the vanilla imports set; the CK2 side of a country is filled in later.
+	writer.put(country.tag);
+	writer.put(country.commonCountryFile);
+	writer.put(country.historyCountryFile);
+	writer.put(*country.details);
+}
+
+void EU4::VanillaCache::read(Reader& reader, Country& country)
+{
+	reader.get(country.tag);
+	reader.get(country.commonCountryFile);
+	reader.get(country.historyCountryFile);
+	reader.get(country.details.edit());
+}
+
+void EU4::VanillaCache::write(Writer& writer, const CountryDetails& details)
+{
+	writer.put(details.inHRE);
+	writer.put(details.holyRomanEmperor);
+	writer.put(details.celestialEmperor);
+	writer.put(details.fixedCapital);
+	writer.put(details.elector);
+	writer.put(details.randomChance);
+	writer.put(details.all_your_core_are_belong_to_us);
+	writer.put(details.rightToBEARArms);
+	writer.put(details.loan);
+	writer.put(details.excommunicated);
+	writer.put(details.hasDynastyName);
+	writer.put(details.isSunsetCountry);
+	writer.put(details.addTreasury);
+	writer.put(details.addPrestige);
+	writer.put(details.dynastyID);
+	writer.put(details.capital);
+	writer.put(details.governmentRank);
+	writer.put(details.mercantilism);
+	writer.put(details.historicalScore);
+	writer.put(details.addedAdminTech);
+	writer.put(details.addedDipTech);
+	writer.put(details.addedMilTech);
+	writer.put(details.armyProfessionalism);
+	writer.put(details.piety);
+	writer.put(details.color);
+	writer.put(details.revolutionaryColor);
+	writer.put(details.primaryCulture);
+	writer.put(details.majorityReligion);
+	writer.put(details.religion);
+	writer.put(details.graphicalCulture);
+	writer.put(details.government);
+	writer.put(details.technologyGroup);
+	writer.put(details.unitType);
+	writer.put(details.religiousSchool);
+	writer.put(details.nationalFocus);
+	writer.put(details.secondaryReligion);
+	writer.put(details.preferredReligion);
+	writer.put(details.colonialParent);
+	writer.put(details.specialUnitCulture);
+	writer.put(details.acceptedCultures);
+	writer.put(details.reforms);
+	writer.put(details.cults);
+	writer.put(details.historicalRivals);
+	writer.put(details.historicalFriends);
+	writer.put(details.harmonizedReligions);
+	writer.put(details.historicalIdeaGroups);
+	writer.put(details.historicalUnits);
+	writer.put(details.leaderNames);
+	writer.put(details.shipNames);
+	writer.put(details.armyNames);
+	writer.put(details.fleetNames);
+	writer.put(details.monarchNames);
+	writer.put(details.pendingNames);
+	writer.put(details.historyLessons);
+	writer.put(details.monarch);
+	writer.put(details.queen);
+	writer.put(details.heir);
+	writer.put(details.advisers);
+}
+
+void EU4::VanillaCache::read(Reader& reader, CountryDetails& details)
+{
+	reader.get(details.inHRE);
+	reader.get(details.holyRomanEmperor);
+	reader.get(details.celestialEmperor);
+	reader.get(details.fixedCapital);
+	reader.get(details.elector);
+	reader.get(details.randomChance);
+	reader.get(details.all_your_core_are_belong_to_us);
+	reader.get(details.rightToBEARArms);
+	reader.get(details.loan);
+	reader.get(details.excommunicated);
+	reader.get(details.hasDynastyName);
+	reader.get(details.isSunsetCountry);
+	reader.get(details.addTreasury);
+	reader.get(details.addPrestige);
+	reader.get(details.dynastyID);
+	reader.get(details.capital);
+	reader.get(details.governmentRank);
+	reader.get(details.mercantilism);
+	reader.get(details.historicalScore);
+	reader.get(details.addedAdminTech);
+	reader.get(details.addedDipTech);
+	reader.get(details.addedMilTech);
+	reader.get(details.armyProfessionalism);
+	reader.get(details.piety);
+	reader.get(details.color);
+	reader.get(details.revolutionaryColor);
+	reader.get(details.primaryCulture);
+	reader.get(details.majorityReligion);
+	reader.get(details.religion);
+	reader.get(details.graphicalCulture);
+	reader.get(details.government);
+	reader.get(details.technologyGroup);
+	reader.get(details.unitType);
+	reader.get(details.religiousSchool);
+	reader.get(details.nationalFocus);
+	reader.get(details.secondaryReligion);
+	reader.get(details.preferredReligion);
+	reader.get(details.colonialParent);
+	reader.get(details.specialUnitCulture);
+	reader.get(details.acceptedCultures);
+	reader.get(details.reforms);
+	reader.get(details.cults);
+	reader.get(details.historicalRivals);
+	reader.get(details.historicalFriends);
+	reader.get(details.harmonizedReligions);
+	reader.get(details.historicalIdeaGroups);
+	reader.get(details.historicalUnits);
+	reader.get(details.leaderNames);
+	reader.get(details.shipNames);
+	reader.get(details.armyNames);
+	reader.get(details.fleetNames);
+	reader.get(details.monarchNames);
+	reader.get(details.pendingNames);
+	reader.get(details.historyLessons);
+	reader.get(details.monarch);
+	reader.get(details.queen);
+	reader.get(details.heir);
+	reader.get(details.advisers);
+}
+
+void EU4::VanillaCache::write(Writer& writer, const Province& province)
+{
+	writer.put(province.provID);
+	writer.put(province.historyProvincesFile);
+	writer.put(*province.details);
+}
+
+void EU4::VanillaCache::read(Reader& reader, Province& province)
+{
+	reader.get(province.provID);
+	reader.get(province.historyProvincesFile);
+	reader.get(province.details.edit());
+}
+
+void EU4::VanillaCache::write(Writer& writer, const ProvinceDetails& details)
+{
+	writer.put(details.isCity);
+	writer.put(details.inHre);
+	writer.put(details.fort);
+	writer.put(details.shipyard);
+	writer.put(details.seatInParliament);
+	writer.put(details.jainsBurghers);
+	writer.put(details.vaisyasBurghers);
+	writer.put(details.rajputsNobles);
+	writer.put(details.brahminsChurch);
+	writer.put(details.nationalism);
+	writer.put(details.revoltRisk);
+	writer.put(details.unrest);
+	writer.put(details.baseTax);
+	writer.put(details.baseProduction);
+	writer.put(details.baseManpower);
+	writer.put(details.extraCost);
+	writer.put(details.centerOfTrade);
+	writer.put(details.localAutonomy);
+	writer.put(details.nativeSize);
+	writer.put(details.nativeFerocity);
+	writer.put(details.nativeHostileness);
+	writer.put(details.owner);
+	writer.put(details.controller);
+	writer.put(details.capital);
+	writer.put(details.culture);
+	writer.put(details.religion);
+	writer.put(details.tradeGoods);
+	writer.put(details.estate);
+	writer.put(details.datedInfo);
+	writer.put(details.cores);
+	writer.put(*details.discoveredBy);
+	writer.put(details.latentGoods);
+	writer.put(details.provinceTriggeredModifiers);
+	writer.put(details.claims);
+	writer.put(details.permanentClaims);
+	writer.put(details.provinceModifiers);
+}
+
+void EU4::VanillaCache::read(Reader& reader, ProvinceDetails& details)
+{
+	reader.get(details.isCity);
+	reader.get(details.inHre);
+	reader.get(details.fort);
+	reader.get(details.shipyard);
+	reader.get(details.seatInParliament);
+	reader.get(details.jainsBurghers);
+	reader.get(details.vaisyasBurghers);
+	reader.get(details.rajputsNobles);
+	reader.get(details.brahminsChurch);
+	reader.get(details.nationalism);
+	reader.get(details.revoltRisk);
+	reader.get(details.unrest);
+	reader.get(details.baseTax);
+	reader.get(details.baseProduction);
+	reader.get(details.baseManpower);
+	reader.get(details.extraCost);
+	reader.get(details.centerOfTrade);
+	reader.get(details.localAutonomy);
+	reader.get(details.nativeSize);
+	reader.get(details.nativeFerocity);
+	reader.get(details.nativeHostileness);
+	reader.get(details.owner);
+	reader.get(details.controller);
+	reader.get(details.capital);
+	reader.get(details.culture);
+	reader.get(details.religion);
+	reader.get(details.tradeGoods);
+	reader.get(details.estate);
+	reader.get(details.datedInfo);
+	reader.get(details.cores);
+	reader.get(details.discoveredBy.edit());
+	reader.get(details.latentGoods);
+	reader.get(details.provinceTriggeredModifiers);
+	reader.get(details.claims);
+	reader.get(details.permanentClaims);
+	reader.get(details.provinceModifiers);
+}
+
+void EU4::VanillaCache::write(Writer& writer, const ProvinceModifier& modifier)
+{
+	writer.put(modifier.name);
+	writer.put(modifier.duration);
+}
+
+void EU4::VanillaCache::read(Reader& reader, ProvinceModifier& modifier)
+{
+	reader.get(modifier.name);
+	reader.get(modifier.duration);
+}
@@ -0,0 +1,99 @@
+#ifndef EU4_VANILLA_CACHE_H
+#define EU4_VANILLA_CACHE_H
+#include "../Parsing/NameMap.h"
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace EU4
+{
+class Country;
+class CountryDetails;
+class Province;
+class ProvinceDetails;
+class ProvinceModifier;
+class ProvinceTable;
+struct Character;
+
+// The vanilla countries or provinces of one install as a conversion sharing the process imported them. Never
+// changed once made.
+struct VanillaImage
+{
+	std::map<std::string, std::shared_ptr<const Country>> countries;
+	std::set<std::string> specialCountryTags;
+	std::vector<std::pair<int, std::shared_ptr<const Province>>> provinces;
+};
+
+// Binary image of the vanilla countries and provinces as they stand after the EU4 install, blankMod and sunset
+// files are read and before anything from CK2 touches them. The install rarely changes between conversions, so
+// the key carries a fingerprint (paths, sizes, modification times) of every file those imports read, and a
+// touched file anywhere in there sends us back to parsing.
+//
+// Same ground rules as CK2::Snapshot: a CK2::CacheStore entry on disk, native layout, only read back by the build that
+// wrote it. Being built from the install alone, it's also shared through the farm cache if there is one.
+class VanillaCache
+{
+  public:
+	// Sizes and modification times of every file below the folders. Missing folders count as empty.
+	[[nodiscard]] static std::string fingerprint(const std::vector<std::string>& folders);
+	[[nodiscard]] static std::string makeKey(const std::string& converterVersion, const std::string& eu4Path, bool invasion);
+
+	static void saveCountries(const std::string& cachePath,
+		 const std::string& key,
+		 const parsing::NameMap<std::shared_ptr<Country>>& countries,
+		 const std::set<std::string>& specialCountryTags);
+	// False if there is no usable cache for this key. The containers may be left half-filled, the caller resets them.
+	[[nodiscard]] static bool loadCountries(const std::string& cachePath,
+		 const std::string& key,
+		 parsing::NameMap<std::shared_ptr<Country>>& countries,
+		 std::set<std::string>& specialCountryTags);
+
+	static void saveProvinces(const std::string& cachePath, const std::string& key, const ProvinceTable& provinces);
+	[[nodiscard]] static bool loadProvinces(const std::string& cachePath, const std::string& key, ProvinceTable& provinces);
+
+	// The same state kept in memory, for conversions sharing a process. The image holds frozen copies of the vanilla
+	// entries; each conversion copies its own back out, and those share their details with the image's until they
+	// change them, so nothing is decoded, and nothing a conversion leaves alone is duplicated, past the first one.
+	[[nodiscard]] static std::shared_ptr<const VanillaImage> countriesImage(const parsing::NameMap<std::shared_ptr<Country>>& countries,
+		 const std::set<std::string>& specialCountryTags);
+	static void loadCountriesImage(const VanillaImage& image,
+		 parsing::NameMap<std::shared_ptr<Country>>& countries,
+		 std::set<std::string>& specialCountryTags);
+	[[nodiscard]] static std::shared_ptr<const VanillaImage> provincesImage(const ProvinceTable& provinces);
+	static void loadProvincesImage(const VanillaImage& image, ProvinceTable& provinces);
+
+  private:
+	class Writer;
+	class Reader;
+
+	static void save(const std::string& cachePath, const std::string& key, const std::function<void(Writer&)>& body);
+	[[nodiscard]] static bool load(const std::string& cachePath, const std::string& key, const std::function<void(Reader&)>& body);
+	static void writeImage(std::ostream& output, const std::string& key, const std::function<void(Writer&)>& body);
+	// source names the image in the log.
+	[[nodiscard]] static bool readImage(const char* data,
+		 std::size_t size,
+		 const std::string& source,
+		 const std::string& key,
+		 const std::function<void(Reader&)>& body);
+
+	static void write(Writer& writer, const Character& character);
+	static void write(Writer& writer, const Country& country);
+	static void write(Writer& writer, const CountryDetails& details);
+	static void write(Writer& writer, const Province& province);
+	static void write(Writer& writer, const ProvinceDetails& details);
+	static void write(Writer& writer, const ProvinceModifier& modifier);
+
+	static void read(Reader& reader, Character& character);
+	static void read(Reader& reader, Country& country);
+	static void read(Reader& reader, CountryDetails& details);
+	static void read(Reader& reader, Province& province);
+	static void read(Reader& reader, ProvinceDetails& details);
+	static void read(Reader& reader, ProvinceModifier& modifier);
+};
+} // namespace EU4
+
+#endif // EU4_VANILLA_CACHE_H
@@ -1,43 +1,131 @@
 #include "ColorScraper.h"
-#include "CommonRegexes.h"
+#include "../../CK2World/CacheStore.h"
+#include "../../CK2World/Concurrency.h"
+#include "../../CK2World/ModFiles.h"
+#include "../../Configuration/Configuration.h"
+#include "../../Parsing/TokenMatcher.h"
+#include "../../Parsing/Tokenizer.h"
+#include "../CompiledConfigurables/CompiledConfigurables.h"
 #include "Log.h"
-#include "ParserHelpers.h"
+#include "OSCompatibilityLayer.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <sstream>
 
-void mappers::ColorScraper::scrapeColors(const std::string& filePath)
+namespace
 {
-	registerKeys();
-	parseFile(filePath);
-	clearRegisteredKeywords();
+// Bump whenever the cache writes anything differently.
+const std::string cacheFormat = "title colors 1";
+} // namespace
+
+void mappers::ColorScraper::scrapeColors(const Configuration& theConfiguration, const Mods& mods)
+{
+	Log(LogLevel::Info) << "-> Soaking Up Colors";
+
+	// Files are parsed concurrently but merged in this order, so mod titles still override vanilla ones.
+	std::vector<std::string> paths;
+	for (auto& file: CK2::gatherModFiles(theConfiguration.getCK2Path(), mods, "common/landed_titles", ".txt", "colors"))
+		paths.emplace_back(std::move(file.path));
+
+	const auto key = cacheFormat + CompiledConfigurables::fingerprint(paths);
+	const auto cacheName = CK2::CacheStore::pathFor("title_colors", key);
+	if (CompiledConfigurables::loadKeyed(cacheName, key, [this](CompiledConfigurables::Reader& reader) {
+			 reader.get(titleColors);
+		 }))
+	{
+		Log(LogLevel::Info) << ">> " << titleColors.size() << " colors soaked up from " << cacheName;
+		return;
+	}
+	titleColors.clear();
+
+	std::vector<ScrapedColors> scraped(paths.size());
+	std::atomic<std::size_t> nextPath = 0;
+	std::vector<std::future<void>> readers;
+	const auto readerCount = std::min<std::size_t>(CK2::Concurrency::threads(), paths.size());
+	for (std::size_t reader = 0; reader < readerCount; ++reader)
+		readers.emplace_back(std::async(CK2::Concurrency::launchPolicy(), CK2::Concurrency::carry([&paths, &scraped, &nextPath] {
+			for (auto path = nextPath++; path < paths.size(); path = nextPath++)
+				if (auto contents = CK2::readModFile(paths[path]))
+				{
+					if (contents->starts_with("\xEF\xBB\xBF"))
+						contents->erase(0, 3);
+					scrapeBuffer(*contents, scraped[path]);
+				}
+				else
+					Log(LogLevel::Error) << "Could not open " << paths[path] << " for parsing.";
+		})));
+	for (auto& reader: readers)
+		reader.get();
+
+	for (const auto& colors: scraped)
+		mergeColors(colors);
+	CompiledConfigurables::saveKeyed(cacheName, key, [this](CompiledConfigurables::Writer& writer) {
+		writer.put(titleColors);
+	});
+	Log(LogLevel::Info) << ">> " << titleColors.size() << " colors soaked up.";
 }
 
-void mappers::ColorScraper::scrapeColors(std::istream& theStream, std::string theName)
+void mappers::ColorScraper::scrapeStream(std::istream& theStream)
 {
-	name = std::move(theName);
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
-	titleColors.insert(std::pair(name, color));
+	ScrapedColors colors;
+	scrapeBuffer(parsing::readStream(theStream), colors);
+	mergeColors(colors);
 }
 
-void mappers::ColorScraper::registerKeys()
+void mappers::ColorScraper::scrapeBuffer(const std::string_view buffer, ScrapedColors& colors)
 {
-	registerRegex(R"((e|k|d|c)_[A-Za-z0-9_\-]+)", [this](const std::string& titleName, std::istream& theStream) {
-		ColorScraper newScraper;
-		newScraper.scrapeColors(theStream, titleName);
-		auto foundColors = newScraper.getColors();
-		for (const auto& foundColor: foundColors)
+	using TokenType = parsing::Tokenizer::TokenType;
+	static const auto isTitle = parsing::TokenMatcher::prefixed({"e_", "k_", "d_", "c_"});
+
+	// One walk over the file with the titles it is inside of on a stack. Any other block is skipped whole, so every
+	// closing brace the walk sees closes the innermost title.
+	struct OpenTitle
+	{
+		std::string_view name;
+		std::optional<commonItems::Color> color;
+	};
+	std::vector<OpenTitle> openTitles;
+	parsing::Tokenizer tokens(buffer);
+	for (auto token = tokens.next(); token.type != TokenType::END; token = tokens.next())
+	{
+		if (token.type == TokenType::CLOSE && !openTitles.empty())
 		{
-			if (!foundColor.second)
-				continue;
-			titleColors[foundColor.first] = foundColor.second; // Overwriting for mod sources
+			if (const auto& title = openTitles.back(); title.color)
+				colors.emplace_back(title.name, *title.color);
+			openTitles.pop_back();
 		}
-	});
+		if (token.type != TokenType::WORD && token.type != TokenType::QUOTED)
+			continue;
 
-	registerKeyword("color", [this](const std::string& unused, std::istream& theStream) {
-		color = commonItems::Color::Factory{}.getColor(theStream);
-	});
+		if (isTitle.matches(token.text))
+		{
+			if (tokens.peek().type != TokenType::EQUALS)
+				continue;
+			tokens.next();
+			if (tokens.peek().type == TokenType::OPEN)
+			{
+				tokens.next();
+				openTitles.emplace_back(OpenTitle{token.text});
+			}
+			else
+				tokens.next(); // a title with a plain value holds no colors
+		}
+		else if (token.text == "color" && !openTitles.empty())
+		{
+			// One per title, not worth a second color parser; the factory knows every rgb/hsv/hex spelling.
+			std::istringstream colorStream{std::string(tokens.getItem())};
+			openTitles.back().color = commonItems::Color::Factory{}.getColor(colorStream);
+		}
+		else
+			tokens.skipItem();
+	}
+}
 
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+void mappers::ColorScraper::mergeColors(const ScrapedColors& colors)
+{
+	for (const auto& [title, color]: colors)
+		titleColors.insert_or_assign(title, color); // Overwriting for mod sources
 }
 
 std::optional<commonItems::Color> mappers::ColorScraper::getColorForTitle(const std::string& titleName) const
@@ -46,4 +134,4 @@ std::optional<commonItems::Color> mappers::ColorScraper::getColorForTitle(const
 	if (titleItr != titleColors.end())
 		return titleItr->second;
 	return std::nullopt;
-}
\ No newline at end of file
+}
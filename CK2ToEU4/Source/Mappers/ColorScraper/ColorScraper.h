@@ -2,27 +2,39 @@
 #define COLOR_SCRAPER
 
 #include "Color.h"
-#include "Parser.h"
+#include "ModLoader/ModLoader.h"
+#include <istream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Configuration;
 
 namespace mappers
 {
-class ColorScraper: commonItems::parser
+class ColorScraper
 {
   public:
 	ColorScraper() = default;
-	void scrapeColors(std::istream& theStream, std::string theName);
-	void scrapeColors(const std::string& filePath);
+	// Vanilla and mod landed_titles, later files overriding earlier ones. Cached under snapshots/title_colors/ for as
+	// long as none of those files changes.
+	void scrapeColors(const Configuration& theConfiguration, const Mods& mods);
+	void scrapeStream(std::istream& theStream); // testing
 
 	[[nodiscard]] const auto& getColors() const { return titleColors; }
 	[[nodiscard]] std::optional<commonItems::Color> getColorForTitle(const std::string& titleName) const;
 
   private:
-	void registerKeys();
+	using ScrapedColors = std::vector<std::pair<std::string, commonItems::Color>>;
+
+	static void scrapeBuffer(std::string_view buffer, ScrapedColors& colors);
+	void mergeColors(const ScrapedColors& colors);
 
-	std::map<std::string, std::optional<commonItems::Color>> titleColors;
-	std::string name;
-	std::optional<commonItems::Color> color;
+	std::map<std::string, commonItems::Color> titleColors;
 };
 } // namespace mappers
 
-#endif // COLOR_SCRAPER
\ No newline at end of file
+#endif // COLOR_SCRAPER
@@ -0,0 +1,94 @@
+#include "CompiledConfigurables.h"
+#include "../../CK2World/CacheStore.h"
+#include "../../CK2World/ModArchive.h"
+#include "../../CK2World/SaveGame/Snapshot.h"
+#include "Log.h"
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace
+{
+const std::string compiledMagic = "CK2ToEU4 compiled configurable";
+} // namespace
+
+std::string mappers::CompiledConfigurables::compiledPath(const std::string& sourcePath, const std::string& folder)
+{
+	auto name = fs::u8path(sourcePath).generic_string();
+	for (auto& character: name)
+		if (character == '/' || character == '\\' || character == ':')
+			character = '_';
+	return folder + "/" + name + ".bin";
+}
+
+std::string mappers::CompiledConfigurables::makeKey(const std::vector<std::string>& sourcePaths, const std::string& format)
+{
+	auto key = compiledMagic + "|" + format;
+	for (const auto& sourcePath: sourcePaths)
+		key += "|" + sourcePath + "=" + (fs::exists(fs::u8path(sourcePath)) ? CK2::Snapshot::hashFile(sourcePath) : "missing");
+	return key;
+}
+
+std::string mappers::CompiledConfigurables::fingerprint(const std::vector<std::string>& sourcePaths)
+{
+	std::string stamps;
+	for (const auto& sourcePath: sourcePaths)
+	{
+		std::error_code error;
+		// A file in a mod archive goes by the archive's stamp.
+		const auto inArchive = CK2::ModArchive::locate(sourcePath);
+		const auto file = fs::u8path(inArchive ? inArchive->first : sourcePath);
+		const auto size = fs::file_size(file, error);
+		const auto written = fs::last_write_time(file, error).time_since_epoch().count();
+		stamps += "|" + sourcePath + ":" + std::to_string(size) + ":" + std::to_string(written);
+	}
+	return stamps;
+}
+
+bool mappers::CompiledConfigurables::load(const std::vector<std::string>& sourcePaths, const std::string& format, const std::function<void(Reader&)>& read)
+{
+	const auto path = compiledPath(sourcePaths.front());
+	if (!fs::exists(fs::u8path(path)))
+		return false;
+	return loadKeyed(path, makeKey(sourcePaths, format), read);
+}
+
+void mappers::CompiledConfigurables::save(const std::vector<std::string>& sourcePaths, const std::string& format, const std::function<void(Writer&)>& write)
+{
+	saveKeyed(compiledPath(sourcePaths.front()), makeKey(sourcePaths, format), write);
+}
+
+bool mappers::CompiledConfigurables::loadKeyed(const std::string& path, const std::string& key, const std::function<void(Reader&)>& read)
+{
+	const auto entry = CK2::CacheStore::load(path, key, CK2::CacheStore::SHARING::FARM);
+	if (!entry)
+		return false;
+
+	try
+	{
+		Reader reader(entry->data(), entry->size());
+		read(reader);
+		if (!reader.atEnd())
+			throw std::runtime_error("Trailing data after the compiled configurable.");
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Compiled configurable " << path << " is unusable: " << e.what();
+		return false;
+	}
+	return true;
+}
+
+void mappers::CompiledConfigurables::saveKeyed(const std::string& path, const std::string& key, const std::function<void(Writer&)>& write)
+{
+	try
+	{
+		CK2::CacheStore::save(path, key, [&write](std::ostream& output) {
+			Writer writer(output);
+			write(writer);
+		}, CK2::CacheStore::SHARING::FARM);
+	}
+	catch (std::exception& e)
+	{
+		Log(LogLevel::Warning) << "Could not write " << path << ": " << e.what();
+	}
+}
@@ -0,0 +1,175 @@
+#ifndef COMPILED_CONFIGURABLES_H
+#define COMPILED_CONFIGURABLES_H
+#include "Color.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace mappers
+{
+// What a mapper builds out of its configurables files, indices included, written to snapshots/configurables/ the
+// first time and mapped back in on every run after that. The binary is keyed on a hash of every source file's
+// contents, so editing a mapping file sends its mapper back to parsing the text, and it recompiles.
+//
+// Same ground rules as the vanilla cache: a CK2::CacheStore entry shared through the farm cache if there is one, native
+// layout, only read back by the build that wrote it. A mapper's format names its layout; change what it writes and
+// bump the number in it.
+class CompiledConfigurables
+{
+  public:
+	class Writer;
+	class Reader;
+
+	// False if there's no binary for the sources as they stand. read may have half-filled the mapper by then.
+	[[nodiscard]] static bool load(const std::vector<std::string>& sourcePaths, const std::string& format, const std::function<void(Reader&)>& read);
+	// Failing to write is only logged: the mapper is loaded either way.
+	static void save(const std::vector<std::string>& sourcePaths, const std::string& format, const std::function<void(Writer&)>& write);
+
+	// For data whose staleness is told by something other than the contents of its sources, under a key of its own.
+	[[nodiscard]] static bool loadKeyed(const std::string& path, const std::string& key, const std::function<void(Reader&)>& read);
+	static void saveKeyed(const std::string& path, const std::string& key, const std::function<void(Writer&)>& write);
+
+	[[nodiscard]] static std::string compiledPath(const std::string& sourcePath, const std::string& folder = "snapshots/configurables");
+	[[nodiscard]] static std::string makeKey(const std::vector<std::string>& sourcePaths, const std::string& format);
+	// Size and modification time of each file, for keys over more files than are worth hashing each run.
+	[[nodiscard]] static std::string fingerprint(const std::vector<std::string>& sourcePaths);
+};
+
+// Values go out as-is, containers as a count followed by their elements, classes through their writeCompiled().
+class CompiledConfigurables::Writer
+{
+  public:
+	explicit Writer(std::ostream& theStream): stream(theStream) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> void put(const T value) { stream.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+	void put(const std::string& value)
+	{
+		put(static_cast<std::uint64_t>(value.size()));
+		stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+	}
+	void put(const commonItems::Color& value)
+	{
+		for (const auto component: value.getRgbComponents())
+			put(component);
+	}
+	template <typename T> requires std::is_class_v<T> void put(const T& item) { item.writeCompiled(*this); }
+	template <typename First, typename Second> void put(const std::pair<First, Second>& value)
+	{
+		put(value.first);
+		put(value.second);
+	}
+	template <typename T> void put(const std::vector<T>& values) { putRange(values); }
+	template <typename T, typename Compare> void put(const std::set<T, Compare>& values) { putRange(values); }
+	template <typename Key, typename Value> void put(const std::map<Key, Value>& values) { putRange(values); }
+	template <typename Key, typename Value, typename Hash> void put(const std::unordered_map<Key, Value, Hash>& values) { putRange(values); }
+
+  private:
+	template <typename Range> void putRange(const Range& values)
+	{
+		put(static_cast<std::uint64_t>(values.size()));
+		for (const auto& value: values)
+			put(value);
+	}
+
+	std::ostream& stream;
+};
+
+// Mirror of Writer. Running off the end of the data throws, load() turns that into "parse the text".
+class CompiledConfigurables::Reader
+{
+  public:
+	Reader(const char* theData, const std::size_t theSize): data(theData), size(theSize) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> void get(T& value) { std::memcpy(&value, take(sizeof(T)), sizeof(T)); }
+	void get(std::string& value)
+	{
+		const auto length = getCount();
+		value.assign(take(length), length);
+	}
+	void get(commonItems::Color& value)
+	{
+		std::array<int, 3> components{};
+		for (auto& component: components)
+			get(component);
+		value = commonItems::Color(components);
+	}
+	template <typename T> requires std::is_class_v<T> void get(T& item) { item.readCompiled(*this); }
+	template <typename First, typename Second> void get(std::pair<First, Second>& value)
+	{
+		get(value.first);
+		get(value.second);
+	}
+	template <typename T> void get(std::vector<T>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+			get(values.emplace_back());
+	}
+	template <typename T, typename Compare> void get(std::set<T, Compare>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			T value{};
+			get(value);
+			values.insert(values.end(), std::move(value));
+		}
+	}
+	template <typename Key, typename Value> void get(std::map<Key, Value>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			std::pair<Key, Value> value;
+			get(value);
+			values.insert(values.end(), std::move(value));
+		}
+	}
+	template <typename Key, typename Value, typename Hash> void get(std::unordered_map<Key, Value, Hash>& values)
+	{
+		values.clear();
+		for (auto count = getCount(); count > 0; --count)
+		{
+			std::pair<Key, Value> value;
+			get(value);
+			values.insert(std::move(value));
+		}
+	}
+
+	[[nodiscard]] std::size_t getCount()
+	{
+		std::uint64_t count = 0;
+		get(count);
+		// Every element takes at least a byte, anything larger than what's left is a corrupted count.
+		if (count > size - position)
+			throw std::runtime_error("Compiled configurable is truncated.");
+		return static_cast<std::size_t>(count);
+	}
+	[[nodiscard]] bool atEnd() const { return position == size; }
+
+  private:
+	const char* take(const std::size_t length)
+	{
+		if (length > size - position)
+			throw std::runtime_error("Compiled configurable is truncated.");
+		const auto* taken = data + position;
+		position += length;
+		return taken;
+	}
+
+	const char* data;
+	std::size_t size;
+	std::size_t position = 0;
+};
+} // namespace mappers
+
+#endif // COMPILED_CONFIGURABLES_H
@@ -1,10 +1,15 @@
 #include "CultureMapper.h"
+#include "../../CK2World/Contention.h"
+#include "../../CK2World/Metrics.h"
+#include "../LookupRecorder/LookupRecorder.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <mutex>
 
 void mappers::CultureMapper::initCultureMapper(std::istream& theStream)
 {
+	clearMatchCache();
 	registerKeys();
 	parseStream(theStream);
 	clearRegisteredKeywords();
@@ -13,6 +18,7 @@ void mappers::CultureMapper::initCultureMapper(std::istream& theStream)
 void mappers::CultureMapper::initCultureMapper(const std::string& path)
 {
 	Log(LogLevel::Info) << "-> Parsing culture mappings.";
+	clearMatchCache();
 	registerKeys();
 	std::string dirPath = "configurables";
 	if (!path.empty())
@@ -25,8 +31,9 @@ void mappers::CultureMapper::initCultureMapper(const std::string& path)
 	Log(LogLevel::Info) << "<> Loaded " << cultureMapRules.size() << " cultural links.";
 }
 
-void mappers::CultureMapper::loadRegionMapper(std::shared_ptr<RegionMapper> theRegionMapper)
+void mappers::CultureMapper::loadRegionMapper(std::shared_ptr<const RegionMapper> theRegionMapper)
 {
+	clearMatchCache();
 	for (auto& rule: cultureMapRules)
 		rule.insertRegionMapper(theRegionMapper);
 }
@@ -35,65 +42,146 @@ void mappers::CultureMapper::registerKeys()
 {
 	registerKeyword("link", [this](const std::string& unused, std::istream& theStream) {
 		const CultureMappingRule rule(theStream);
+		for (const auto& culture: rule.getCK2Cultures())
+			rulesByCulture[culture].emplace_back(cultureMapRules.size());
+		if (!rule.getTechGroupField().empty())
+			techGroups.emplace(rule.getEU4Culture(), rule.getTechGroupField());
+		if (!rule.getGFXField().empty())
+			gfxes.emplace(rule.getEU4Culture(), rule.getGFXField());
 		cultureMapRules.push_back(rule);
 	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-std::optional<std::string> mappers::CultureMapper::cultureMatch(const std::string& ck2culture,
+const std::vector<std::size_t>& mappers::CultureMapper::candidateRules(const parsing::Symbol& ck2culture) const
+{
+	static const std::vector<std::size_t> noRules;
+	const auto& rulesItr = rulesByCulture.find(ck2culture);
+	if (rulesItr == rulesByCulture.end())
+		return noRules;
+	return rulesItr->second;
+}
+
+std::optional<std::string> mappers::CultureMapper::cultureMatch(const parsing::Symbol& ck2culture,
 	 const std::string& eu4religion,
 	 int eu4Province,
 	 const std::string& eu4ownerTag) const
 {
-	for (const auto& cultureMappingRule: cultureMapRules)
-	{
-		const auto& possibleMatch = cultureMappingRule.cultureMatch(ck2culture, eu4religion, eu4Province, eu4ownerTag);
-		if (possibleMatch)
-			return *possibleMatch;
-	}
-	return std::nullopt;
+	return recordedMatch(MatchQuery{MATCH::ANY, ck2culture, eu4religion, eu4Province, eu4ownerTag});
 }
 
-std::optional<std::string> mappers::CultureMapper::cultureRegionalMatch(const std::string& ck2culture,
+std::optional<std::string> mappers::CultureMapper::cultureRegionalMatch(const parsing::Symbol& ck2culture,
 	 const std::string& eu4religion,
 	 int eu4Province,
 	 const std::string& eu4ownerTag) const
 {
-	for (const auto& cultureMappingRule: cultureMapRules)
-	{
-		const auto& possibleMatch = cultureMappingRule.cultureRegionalMatch(ck2culture, eu4religion, eu4Province, eu4ownerTag);
-		if (possibleMatch)
-			return *possibleMatch;
-	}
-	return std::nullopt;
+	return recordedMatch(MatchQuery{MATCH::REGIONAL, ck2culture, eu4religion, eu4Province, eu4ownerTag});
 }
 
-std::optional<std::string> mappers::CultureMapper::cultureNonRegionalNonReligiousMatch(const std::string& ck2culture,
+std::optional<std::string> mappers::CultureMapper::cultureNonRegionalNonReligiousMatch(const parsing::Symbol& ck2culture,
 	 const std::string& eu4religion,
 	 int eu4Province,
 	 const std::string& eu4ownerTag) const
 {
-	for (const auto& cultureMappingRule: cultureMapRules)
+	return recordedMatch(MatchQuery{MATCH::NONREGIONAL_NONRELIGIOUS, ck2culture, eu4religion, eu4Province, eu4ownerTag});
+}
+
+std::optional<std::string> mappers::CultureMapper::recordedMatch(MatchQuery query) const
+{
+	if (!LookupRecorder::recording())
+		return memoizedMatch(std::move(query));
+
+	auto match = memoizedMatch(query);
+	auto call = LookupRecorder::CALL::CULTURE;
+	if (query.match == MATCH::REGIONAL)
+		call = LookupRecorder::CALL::CULTURE_REGIONAL;
+	else if (query.match == MATCH::NONREGIONAL_NONRELIGIOUS)
+		call = LookupRecorder::CALL::CULTURE_NONREGIONAL_NONRELIGIOUS;
+	LookupRecorder::record(call,
+		 {query.ck2culture.str(), query.eu4religion, static_cast<long long>(query.eu4Province), query.eu4ownerTag},
+		 {LookupRecorder::value(match)});
+	return match;
+}
+
+std::optional<std::string> mappers::CultureMapper::memoizedMatch(MatchQuery query) const
+{
+	// Looked up once; this runs for every province of every conversion.
+	static auto& memoHits = CK2::Metrics::lookups("culture_match", true);
+	static auto& memoMisses = CK2::Metrics::lookups("culture_match", false);
+	static CK2::Contention::Site memoWaits("culture match cache");
 	{
-		const auto& possibleMatch = cultureMappingRule.cultureNonRegionalNonReligiousMatch(ck2culture, eu4religion, eu4Province, eu4ownerTag);
+		const auto lock = CK2::lockAt<std::shared_lock<std::shared_mutex>>(memoWaits, matchCacheMutex);
+		if (const auto& cacheItr = matchCache.find(query); cacheItr != matchCache.end())
+		{
+			++cachedMatches;
+			memoHits.fetch_add(1, std::memory_order_relaxed);
+			return cacheItr->second;
+		}
+	}
+
+	// Resolved outside the lock. Two threads asking the same question both resolve it to the same answer, which is
+	// cheaper than making everyone else wait. Throws aren't cached, they'll throw again next time.
+	auto match = resolveMatch(query);
+	++resolvedMatches;
+	memoMisses.fetch_add(1, std::memory_order_relaxed);
+	const auto lock = CK2::lockAt<std::unique_lock<std::shared_mutex>>(memoWaits, matchCacheMutex);
+	matchCache.emplace(std::move(query), match);
+	return match;
+}
+
+std::optional<std::string> mappers::CultureMapper::resolveMatch(const MatchQuery& query) const
+{
+	for (const auto rule: candidateRules(query.ck2culture))
+	{
+		const auto& cultureMappingRule = cultureMapRules[rule];
+		std::optional<std::string> possibleMatch;
+		switch (query.match)
+		{
+			case MATCH::ANY:
+				possibleMatch = cultureMappingRule.cultureMatch(query.ck2culture, query.eu4religion, query.eu4Province, query.eu4ownerTag);
+				break;
+			case MATCH::REGIONAL:
+				possibleMatch = cultureMappingRule.cultureRegionalMatch(query.ck2culture, query.eu4religion, query.eu4Province, query.eu4ownerTag);
+				break;
+			case MATCH::NONREGIONAL_NONRELIGIOUS:
+				possibleMatch = cultureMappingRule.cultureNonRegionalNonReligiousMatch(query.ck2culture, query.eu4religion, query.eu4Province, query.eu4ownerTag);
+				break;
+		}
 		if (possibleMatch)
-			return *possibleMatch;
+			return possibleMatch;
 	}
 	return std::nullopt;
 }
 
-std::optional<std::string> mappers::CultureMapper::getTechGroup(const std::string& incEU4Culture) const
+void mappers::CultureMapper::clearMatchCache()
+{
+	const std::unique_lock lock(matchCacheMutex);
+	matchCache.clear();
+}
+
+std::size_t mappers::CultureMapper::MatchQueryHash::operator()(const MatchQuery& query) const noexcept
+{
+	auto hash = std::hash<parsing::Symbol>()(query.ck2culture);
+	const auto mix = [&hash](const std::size_t value) {
+		hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	};
+	mix(static_cast<std::size_t>(query.match));
+	mix(std::hash<std::string>()(query.eu4religion));
+	mix(std::hash<int>()(query.eu4Province));
+	mix(std::hash<std::string>()(query.eu4ownerTag));
+	return hash;
+}
+
+std::optional<std::string_view> mappers::CultureMapper::getTechGroup(const std::string_view incEU4Culture) const
 {
-	for (const auto& mapping: cultureMapRules)
-		if (mapping.getTechGroup(incEU4Culture))
-			return mapping.getTechGroup(incEU4Culture);
+	if (const auto techGroup = techGroups.find(incEU4Culture); techGroup != techGroups.end())
+		return techGroup->second;
 	return std::nullopt;
 }
 
-std::optional<std::string> mappers::CultureMapper::getGFX(const std::string& incEU4Culture) const
+std::optional<std::string_view> mappers::CultureMapper::getGFX(const std::string_view incEU4Culture) const
 {
-	for (const auto& mapping: cultureMapRules)
-		if (mapping.getGFX(incEU4Culture))
-			return mapping.getGFX(incEU4Culture);
+	if (const auto gfx = gfxes.find(incEU4Culture); gfx != gfxes.end())
+		return gfx->second;
 	return std::nullopt;
 }
\ No newline at end of file
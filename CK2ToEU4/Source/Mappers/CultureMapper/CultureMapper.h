@@ -1,11 +1,18 @@
 #ifndef CULTURE_MAPPER_H
 #define CULTURE_MAPPER_H
 
+#include "../../Parsing/NameMap.h"
 #include "../RegionMapper/RegionMapper.h"
 #include "CultureMappingRule.h"
 #include "Parser.h"
+#include <atomic>
+#include <cstdint>
 #include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace mappers
 {
@@ -16,30 +23,72 @@ class CultureMapper: commonItems::parser
 	void initCultureMapper(const std::string& path);
 	void initCultureMapper(std::istream& theStream);
 
-	void loadRegionMapper(std::shared_ptr<RegionMapper> theRegionMapper);
+	void loadRegionMapper(std::shared_ptr<const RegionMapper> theRegionMapper);
 
-	[[nodiscard]] std::optional<std::string> cultureMatch(const std::string& ck2culture,
+	[[nodiscard]] std::optional<std::string> cultureMatch(const parsing::Symbol& ck2culture,
 		 const std::string& eu4religion,
 		 int eu4Province,
 		 const std::string& eu4ownerTag) const;
 
-	[[nodiscard]] std::optional<std::string> cultureRegionalMatch(const std::string& ck2culture,
+	[[nodiscard]] std::optional<std::string> cultureRegionalMatch(const parsing::Symbol& ck2culture,
 		 const std::string& eu4religion,
 		 int eu4Province,
 		 const std::string& eu4ownerTag) const;
 
-	[[nodiscard]] std::optional<std::string> cultureNonRegionalNonReligiousMatch(const std::string& ck2culture,
+	[[nodiscard]] std::optional<std::string> cultureNonRegionalNonReligiousMatch(const parsing::Symbol& ck2culture,
 		 const std::string& eu4religion,
 		 int eu4Province,
 		 const std::string& eu4ownerTag) const;
 
-	[[nodiscard]] std::optional<std::string> getTechGroup(const std::string& incEU4Culture) const;
-	[[nodiscard]] std::optional<std::string> getGFX(const std::string& incEU4Culture) const;
+	// Good for as long as the mapper, like its rules.
+	[[nodiscard]] std::optional<std::string_view> getTechGroup(std::string_view incEU4Culture) const;
+	[[nodiscard]] std::optional<std::string_view> getGFX(std::string_view incEU4Culture) const;
+
+	[[nodiscard]] auto getCachedMatches() const { return cachedMatches.load(); }
+	[[nodiscard]] auto getResolvedMatches() const { return resolvedMatches.load(); }
 
   private:
+	enum class MATCH
+	{
+		ANY,
+		REGIONAL,
+		NONREGIONAL_NONRELIGIOUS
+	};
+	struct MatchQuery
+	{
+		MATCH match = MATCH::ANY;
+		parsing::Symbol ck2culture;
+		std::string eu4religion;
+		int eu4Province = 0;
+		std::string eu4ownerTag;
+
+		bool operator==(const MatchQuery& rhs) const = default;
+	};
+	struct MatchQueryHash
+	{
+		std::size_t operator()(const MatchQuery& query) const noexcept;
+	};
+
 	void registerKeys();
+	[[nodiscard]] const std::vector<std::size_t>& candidateRules(const parsing::Symbol& ck2culture) const;
+	[[nodiscard]] std::optional<std::string> recordedMatch(MatchQuery query) const;
+	[[nodiscard]] std::optional<std::string> memoizedMatch(MatchQuery query) const;
+	[[nodiscard]] std::optional<std::string> resolveMatch(const MatchQuery& query) const;
+	void clearMatchCache();
 
 	std::vector<CultureMappingRule> cultureMapRules;
+	// Positions in cultureMapRules of every rule listing a CK2 culture, in file order so the first match still wins.
+	std::unordered_map<parsing::Symbol, std::vector<std::size_t>> rulesByCulture;
+	// The tech group and gfx of the first rule mapping to each EU4 culture that names one.
+	parsing::NameMap<std::string> techGroups;
+	parsing::NameMap<std::string> gfxes;
+
+	// Provinces in one culture block, and every courtier of a ruler, ask the same question over and over. Answers
+	// depend only on the rules and the region mapper, so they're kept until either changes.
+	mutable std::shared_mutex matchCacheMutex;
+	mutable std::unordered_map<MatchQuery, std::optional<std::string>, MatchQueryHash> matchCache;
+	mutable std::atomic<std::uint64_t> cachedMatches = 0;
+	mutable std::atomic<std::uint64_t> resolvedMatches = 0;
 };
 } // namespace mappers
 
@@ -43,7 +43,7 @@ mappers::CultureMappingRule::CultureMappingRule(std::istream& theStream)
 	});
 	registerKeyword("ck2", [this](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString ck2Str(theStream);
-		cultures.insert(ck2Str.getString());
+		cultures.insert(parsing::Symbol(ck2Str.getString()));
 	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 
@@ -51,7 +51,27 @@ mappers::CultureMappingRule::CultureMappingRule(std::istream& theStream)
 	clearRegisteredKeywords();
 }
 
-std::optional<std::string> mappers::CultureMappingRule::cultureMatch(const std::string& ck2culture,
+void mappers::CultureMappingRule::insertRegionMapper(std::shared_ptr<const RegionMapper> theRegionMapper)
+{
+	regionMapper = std::move(theRegionMapper);
+	regionProvinces.clear();
+	if (!regionMapper)
+		return;
+	for (const auto& region: regions)
+	{
+		if (!regionMapper->regionNameIsValid(region))
+		{
+			Log(LogLevel::Warning) << "Mapping for culture " << destinationCulture << " is inside invalid region: " << region << "! Fix the mapping rules!";
+			// We could say this was a match, and thus pretend this region entry doesn't exist, but it's better
+			// for the converter to explode across the logs with invalid names. So, continue.
+			continue;
+		}
+		const auto& provincesInRegion = regionMapper->getProvincesInRegion(region);
+		regionProvinces.insert(provincesInRegion.begin(), provincesInRegion.end());
+	}
+}
+
+std::optional<std::string> mappers::CultureMappingRule::cultureMatch(const parsing::Symbol& ck2culture,
 	 const std::string& eu4religion,
 	 int eu4Province,
 	 const std::string& eu4ownerTag) const
@@ -81,29 +101,14 @@ std::optional<std::string> mappers::CultureMappingRule::cultureMatch(const std::
 	{
 		if (!regionMapper)
 			throw std::runtime_error("Culture Mapper: Region Mapper is unloaded!");
-		auto regionMatch = false;
-		for (const auto& region: regions)
-		{
-			if (!regionMapper->regionNameIsValid(region))
-			{
-				Log(LogLevel::Warning) << "Checking for culture " << ck2culture << " inside invalid region: " << region << "! Fix the mapping rules!";
-				// We could say this was a match, and thus pretend this region entry doesn't exist, but it's better
-				// for the converter to explode across the logs with invalid names. So, continue.
-				continue;
-			}
-			if (regionMapper->provinceIsInRegion(eu4Province, region))
-				regionMatch = true;
-		}
 		// This is an override if we have a province outside the regions specified.
-		if (!provinces.empty() && provinces.count(eu4Province))
-			regionMatch = true;
-		if (!regionMatch)
+		if (!regionProvinces.count(eu4Province) && !provinces.count(eu4Province))
 			return std::nullopt;
 	}
 	return destinationCulture;
 }
 
-std::optional<std::string> mappers::CultureMappingRule::cultureRegionalMatch(const std::string& ck2culture,
+std::optional<std::string> mappers::CultureMappingRule::cultureRegionalMatch(const parsing::Symbol& ck2culture,
 	 const std::string& eu4religion,
 	 int eu4Province,
 	 const std::string& eu4ownerTag) const
@@ -117,7 +122,7 @@ std::optional<std::string> mappers::CultureMappingRule::cultureRegionalMatch(con
 	return cultureMatch(ck2culture, eu4religion, eu4Province, eu4ownerTag);
 }
 
-std::optional<std::string> mappers::CultureMappingRule::cultureNonRegionalNonReligiousMatch(const std::string& ck2culture,
+std::optional<std::string> mappers::CultureMappingRule::cultureNonRegionalNonReligiousMatch(const parsing::Symbol& ck2culture,
 	 const std::string& eu4religion,
 	 int eu4Province,
 	 const std::string& eu4ownerTag) const
@@ -1,6 +1,7 @@
 #ifndef CULTURE_MAPPING_RULE_H
 #define CULTURE_MAPPING_RULE_H
 
+#include "../../Parsing/Symbol.h"
 #include "Parser.h"
 #include <set>
 
@@ -13,17 +14,17 @@ class CultureMappingRule: commonItems::parser
 	CultureMappingRule() = default;
 	explicit CultureMappingRule(std::istream& theStream);
 
-	[[nodiscard]] std::optional<std::string> cultureMatch(const std::string& ck2culture,
+	[[nodiscard]] std::optional<std::string> cultureMatch(const parsing::Symbol& ck2culture,
 		 const std::string& eu4religion,
 		 int eu4Province,
 		 const std::string& eu4ownerTag) const;
 
-	[[nodiscard]] std::optional<std::string> cultureRegionalMatch(const std::string& ck2culture,
+	[[nodiscard]] std::optional<std::string> cultureRegionalMatch(const parsing::Symbol& ck2culture,
 		 const std::string& eu4religion,
 		 int eu4Province,
 		 const std::string& eu4ownerTag) const;
 
-	[[nodiscard]] std::optional<std::string> cultureNonRegionalNonReligiousMatch(const std::string& ck2culture,
+	[[nodiscard]] std::optional<std::string> cultureNonRegionalNonReligiousMatch(const parsing::Symbol& ck2culture,
 		 const std::string& eu4religion,
 		 int eu4Province,
 		 const std::string& eu4ownerTag) const;
@@ -31,28 +32,29 @@ class CultureMappingRule: commonItems::parser
 	[[nodiscard]] std::optional<std::string> getTechGroup(const std::string& incEU4Culture) const;
 	[[nodiscard]] std::optional<std::string> getGFX(const std::string& incEU4Culture) const;
 
-	void insertRegionMapper(std::shared_ptr<RegionMapper> theRegionMapper) { regionMapper = std::move(theRegionMapper); }
+	void insertRegionMapper(std::shared_ptr<const RegionMapper> theRegionMapper); // also resolves our regions into provinces
 
-	[[nodiscard]] const auto& getEU4Culture() const { return destinationCulture; } // for testing
+	[[nodiscard]] const auto& getEU4Culture() const { return destinationCulture; }
 	[[nodiscard]] const auto& getCK2Cultures() const { return cultures; }			 // for testing
 	[[nodiscard]] const auto& getReligions() const { return religions; }				 // for testing
 	[[nodiscard]] const auto& getRegions() const { return regions; }					 // for testing
 	[[nodiscard]] const auto& getOwners() const { return owners; }						 // for testing
 	[[nodiscard]] const auto& getProvinces() const { return provinces; }				 // for testing
-	[[nodiscard]] const auto& getTechGroupField() const { return techGroup; }		 // for testing
-	[[nodiscard]] const auto& getGFXField() const { return gfx; }						 // for testing
+	[[nodiscard]] const auto& getTechGroupField() const { return techGroup; }
+	[[nodiscard]] const auto& getGFXField() const { return gfx; }
 
   private:
 	std::string destinationCulture;
 	std::string techGroup;
 	std::string gfx;
-	std::set<std::string> cultures;
+	std::set<parsing::Symbol, std::less<>> cultures;
 	std::set<std::string> religions;
 	std::set<std::string> regions;
 	std::set<std::string> owners;
 	std::set<int> provinces;
 
-	std::shared_ptr<RegionMapper> regionMapper;
+	std::shared_ptr<const RegionMapper> regionMapper;
+	std::set<int> regionProvinces; // every province inside any of our valid regions
 };
 } // namespace mappers
 
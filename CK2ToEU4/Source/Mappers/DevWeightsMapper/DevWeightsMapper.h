@@ -1,7 +1,9 @@
 #ifndef DEV_WEIGHTS_MAPPER
 #define DEV_WEIGHTS_MAPPER
 
+#include "../../CK2World/Provinces/Barony.h"
 #include "Parser.h"
+#include <array>
 
 namespace mappers
 {
@@ -14,11 +16,25 @@ class DevWeightsMapper: commonItems::parser
 	[[nodiscard]] const auto& getDevFromBuilding() const { return devFromBuilding; }
 	[[nodiscard]] const auto& getDevFromBarony() const { return devFromBarony; }
 
+	// How a holding's development is shared out, as adm, dip and mil fractions.
+	using DevSplit = std::array<double, 3>;
+	[[nodiscard]] static const DevSplit& getDevSplit(CK2::Barony::HOLDING holding) { return devSplits[static_cast<std::size_t>(holding)]; }
+
   private:
 	void registerKeys();
 
 	double devFromBuilding = 0.1; // Default, unless overridden
 	double devFromBarony = 0.3;	// Default, unless overridden
+
+	static constexpr std::array<DevSplit, CK2::Barony::holdingCount> devSplits{{
+		 {0.0, 0.0, 0.0},				 // NONE
+		 {0.0, 0.0, 1.0},				 // TRIBAL
+		 {0.0, 0.0, 1.0},				 // NOMAD
+		 {0.0, 1.0, 0.0},				 // CITY
+		 {1.0, 0.0, 0.0},				 // TEMPLE
+		 {1.0 / 3, 0.0, 2.0 / 3}, // CASTLE
+		 {0.0, 0.0, 0.0}				 // OTHER
+	}};
 };
 } // namespace mappers
 
@@ -1,4 +1,5 @@
 #include "GovernmentsMapper.h"
+#include "../LookupRecorder/LookupRecorder.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
@@ -16,6 +17,7 @@ void mappers::GovernmentsMapper::initGovernmentsMapper(const std::string& path)
 	parseFile(dirPath + "/culture_map.txt");
 	parseFile(dirPath + "/government_map.txt");
 	clearRegisteredKeywords();
+	indexMappings();
 	Log(LogLevel::Info) << "<> Loaded " << govMappings.size() << " governmental links.";
 }
 
@@ -24,6 +26,7 @@ void mappers::GovernmentsMapper::initGovernmentsMapper(std::istream& theStream)
 	registerKeys();
 	parseStream(theStream);
 	clearRegisteredKeywords();
+	indexMappings();
 }
 
 void mappers::GovernmentsMapper::registerKeys()
@@ -35,31 +38,53 @@ void mappers::GovernmentsMapper::registerKeys()
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-std::optional<std::pair<std::string, std::string>> mappers::GovernmentsMapper::matchGovernment(const std::string& ck2Government,
-	 const std::string& ck2Title) const
+void mappers::GovernmentsMapper::indexMappings()
 {
-	std::pair<std::string, std::string> toReturn;
-
-	// first iterate over those that have a ck2title field, they take priority.
-	for (const auto& mapping: govMappings)
+	// Earlier links win, so only the first one for each key is kept.
+	titleLinks.clear();
+	governmentLinks.clear();
+	for (std::size_t index = 0; index < govMappings.size(); ++index)
 	{
-		if (mapping.getCK2Title().empty())
-			continue;
-		if (mapping.matchGovernment(ck2Government, ck2Title))
+		const auto& mapping = govMappings[index];
+		if (!mapping.getCK2Title().empty())
 		{
-			toReturn.first = mapping.getGovernment();
-			toReturn.second = mapping.getReform();
-			return toReturn;
+			titleLinks.emplace(mapping.getCK2Title(), index);
+			continue; // reserved for that title, whatever its government.
 		}
+		for (const auto& ck2Government: mapping.getCK2Governments())
+			governmentLinks.emplace(ck2Government, index);
 	}
+}
 
-	// Then might as well retry.
-	for (const auto& mapping: govMappings)
-		if (mapping.matchGovernment(ck2Government, ck2Title))
-		{
-			toReturn.first = mapping.getGovernment();
-			toReturn.second = mapping.getReform();
-			return toReturn;
-		}
+std::optional<std::pair<std::string, std::string>> mappers::GovernmentsMapper::matchGovernment(const parsing::Symbol& ck2Government,
+	 const std::string& ck2Title) const
+{
+	const auto& match = resolveGovernment(ck2Government, ck2Title);
+	if (LookupRecorder::recording())
+	{
+		std::vector<LookupRecorder::Value> results;
+		if (match)
+			results = {match->first, match->second};
+		LookupRecorder::record(LookupRecorder::CALL::GOVERNMENT, {ck2Government.str(), ck2Title}, std::move(results));
+	}
+	return match;
+}
+
+std::optional<std::pair<std::string, std::string>> mappers::GovernmentsMapper::resolveGovernment(const parsing::Symbol& ck2Government,
+	 const std::string& ck2Title) const
+{
+	// Links for a specific ck2title take priority over any government link.
+	const auto titleLink = titleLinks.find(ck2Title);
+	if (titleLink != titleLinks.end())
+	{
+		const auto& mapping = govMappings[titleLink->second];
+		return std::pair(mapping.getGovernment(), mapping.getReform());
+	}
+	const auto governmentLink = governmentLinks.find(ck2Government);
+	if (governmentLink != governmentLinks.end())
+	{
+		const auto& mapping = govMappings[governmentLink->second];
+		return std::pair(mapping.getGovernment(), mapping.getReform());
+	}
 	return std::nullopt;
 }
@@ -3,6 +3,7 @@
 
 #include "GovernmentsMapping.h"
 #include "Parser.h"
+#include <unordered_map>
 
 namespace mappers
 {
@@ -13,11 +14,16 @@ class GovernmentsMapper: commonItems::parser
 	void initGovernmentsMapper(const std::string& path);
 	void initGovernmentsMapper(std::istream& theStream);
 
-	[[nodiscard]] std::optional<std::pair<std::string, std::string>> matchGovernment(const std::string& ck2Government, const std::string& ck2Title) const;
+	[[nodiscard]] std::optional<std::pair<std::string, std::string>> matchGovernment(const parsing::Symbol& ck2Government, const std::string& ck2Title) const;
 
   private:
 	void registerKeys();
+	void indexMappings();
+	[[nodiscard]] std::optional<std::pair<std::string, std::string>> resolveGovernment(const parsing::Symbol& ck2Government, const std::string& ck2Title) const;
 	std::vector<GovernmentsMapping> govMappings;
+	// Positions in govMappings of the first link for each ck2title, and of the first untitled link for each ck2gov.
+	std::unordered_map<std::string, std::size_t> titleLinks;
+	std::unordered_map<parsing::Symbol, std::size_t> governmentLinks;
 };
 } // namespace mappers
 
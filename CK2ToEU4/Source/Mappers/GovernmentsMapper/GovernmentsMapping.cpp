@@ -26,12 +26,12 @@ void mappers::GovernmentsMapping::registerKeys()
 	});
 	registerKeyword("ck2gov", [this](const std::string& unused, std::istream& theStream) {
 		const commonItems::singleString ck2govStr(theStream);
-		ck2governments.insert(ck2govStr.getString());
+		ck2governments.insert(parsing::Symbol(ck2govStr.getString()));
 	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-bool mappers::GovernmentsMapping::matchGovernment(const std::string& ck2Government, const std::string& incTitle) const
+bool mappers::GovernmentsMapping::matchGovernment(const parsing::Symbol& ck2Government, const std::string& incTitle) const
 {
 	if (!ck2title.empty() && ck2title != incTitle)
 		return false; // these are reserved for their recipients only.
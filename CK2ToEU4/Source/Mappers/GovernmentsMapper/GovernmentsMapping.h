@@ -1,6 +1,7 @@
 #ifndef GOVERNMENTS_MAPPING
 #define GOVERNMENTS_MAPPING
 
+#include "../../Parsing/Symbol.h"
 #include "Parser.h"
 #include <set>
 
@@ -17,7 +18,7 @@ class GovernmentsMapping: commonItems::parser
 	[[nodiscard]] const auto& getReform() const { return reform; }
 	[[nodiscard]] const auto& getCK2Title() const { return ck2title; }
 
-	[[nodiscard]] bool matchGovernment(const std::string& ck2Government, const std::string& incTitle) const;
+	[[nodiscard]] bool matchGovernment(const parsing::Symbol& ck2Government, const std::string& incTitle) const;
 
   private:
 	void registerKeys();
@@ -25,7 +26,7 @@ class GovernmentsMapping: commonItems::parser
 	std::string government;
 	std::string reform;
 	std::string ck2title;
-	std::set<std::string> ck2governments;
+	std::set<parsing::Symbol, std::less<>> ck2governments;
 };
 } // namespace mappers
 
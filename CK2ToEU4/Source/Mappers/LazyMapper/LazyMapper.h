@@ -0,0 +1,43 @@
+#ifndef LAZY_MAPPER_H
+#define LAZY_MAPPER_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace mappers
+{
+// A mapper that reads its input the first time it's queried rather than when its owner is built, for the ones only
+// some configurations ever ask (custom shattering, a custom HRE, vassal splitting). Runs with those off never touch
+// the files. By default the mapper's own default constructor does the loading; tests and callers with the data in
+// hand pass a load of their own. Loads once however many threads ask at the same time; if the load throws, the
+// next query tries again.
+template <typename Mapper> class LazyMapper
+{
+  public:
+	LazyMapper(): load([] {
+		return std::make_unique<Mapper>();
+	})
+	{
+	}
+	explicit LazyMapper(std::function<std::unique_ptr<Mapper>()> theLoad): load(std::move(theLoad)) {}
+
+	[[nodiscard]] const Mapper& operator*() const { return get(); }
+	[[nodiscard]] const Mapper* operator->() const { return &get(); }
+
+  private:
+	const Mapper& get() const
+	{
+		std::call_once(*once, [this] {
+			loaded = load();
+		});
+		return *loaded;
+	}
+
+	std::function<std::unique_ptr<Mapper>()> load;
+	mutable std::unique_ptr<std::once_flag> once = std::make_unique<std::once_flag>();
+	mutable std::unique_ptr<Mapper> loaded;
+};
+} // namespace mappers
+
+#endif // LAZY_MAPPER_H
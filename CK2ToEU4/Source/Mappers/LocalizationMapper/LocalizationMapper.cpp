@@ -1,116 +1,129 @@
 #include "LocalizationMapper.h"
+#include "../../CK2World/Concurrency.h"
+#include "../../CK2World/MemoryCensus.h"
+#include "../../CK2World/ModFiles.h"
 #include "../../Configuration/Configuration.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
-#include <fstream>
-#include <set>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iterator>
 
 void mappers::LocalizationMapper::scrapeLocalizations(const Configuration& theConfiguration, const Mods& mods)
 {
 	Log(LogLevel::Info) << "-> Reading Words";
-	auto filenames = commonItems::GetAllFilesInFolder(theConfiguration.getCK2Path() + "/localisation/");
-	for (const auto& file: filenames)
-	{
-		std::ifstream theFile(theConfiguration.getCK2Path() + "/localisation/" + file);
-		scrapeStream(theFile);
-		theFile.close();
-	}
-	for (const auto& mod: mods)
-	{
-		if (commonItems::DoesFolderExist(mod.path + "/localisation/"))
-		{
-			Log(LogLevel::Info) << "\t>> Found some words in [" << mod.name << "]: " << mod.path + "/localization/";
-			filenames = commonItems::GetAllFilesInFolder(mod.path + "/localisation/");
-			for (const auto& file: filenames)
-			{
-				if (file.find(".csv") == std::string::npos)
-					continue;
-				std::ifstream theFile(mod.path + "/localisation/" + file);
-				scrapeStream(theFile);
-				theFile.close();
-			}
-		}
-	}
+
+	// Files are read concurrently but merged in this order, so later files still override earlier ones.
+	std::vector<std::string> paths;
+	for (auto& file: CK2::gatherModFiles(theConfiguration.getCK2Path(), mods, "localisation", ".csv", "words"))
+		paths.emplace_back(std::move(file.path));
 
 	// Override with our keys
 	if (commonItems::DoesFileExist("configurables/ck2_localization_override.csv"))
+		paths.emplace_back("configurables/ck2_localization_override.csv");
+
+	std::vector<std::shared_ptr<const std::string>> scrapedBuffers(paths.size());
+	std::vector<LocEntries> scraped(paths.size());
+	std::atomic<std::size_t> nextPath = 0;
+	std::vector<std::future<void>> readers;
+	const auto readerCount = std::min<std::size_t>(CK2::Concurrency::threads(), paths.size());
+	for (std::size_t reader = 0; reader < readerCount; ++reader)
+		readers.emplace_back(std::async(CK2::Concurrency::launchPolicy(), CK2::Concurrency::carry([&paths, &scrapedBuffers, &scraped, &nextPath] {
+			for (auto path = nextPath++; path < paths.size(); path = nextPath++)
+			{
+				scrapedBuffers[path] = std::make_shared<const std::string>(CK2::readModFile(paths[path]).value_or(std::string()));
+				scrapeBuffer(*scrapedBuffers[path], scraped[path]);
+			}
+		})));
+	for (auto& reader: readers)
+		reader.get();
+
+	for (std::size_t path = 0; path < paths.size(); ++path)
 	{
-		std::ifstream theFile("configurables/ck2_localization_override.csv");
-		scrapeStream(theFile);
-		theFile.close();
+		buffers.emplace_back(std::move(scrapedBuffers[path]));
+		mergeEntries(scraped[path]);
 	}
 	Log(LogLevel::Info) << ">> " << localizations.size() << " words read.";
 }
 
 void mappers::LocalizationMapper::scrapeStream(std::istream& theStream)
 {
-	while (!theStream.eof())
+	const auto& buffer = buffers.emplace_back(std::make_shared<const std::string>(std::istreambuf_iterator<char>(theStream), std::istreambuf_iterator<char>()));
+	LocEntries entries;
+	scrapeBuffer(*buffer, entries);
+	mergeEntries(entries);
+}
+
+void mappers::LocalizationMapper::scrapeBuffer(std::string_view buffer, LocEntries& entries)
+{
+	while (!buffer.empty())
 	{
-		std::string line;
-		getline(theStream, line);
+		const auto lineEnd = buffer.find('\n');
+		const auto line = buffer.substr(0, lineEnd);
+		buffer.remove_prefix(lineEnd == std::string_view::npos ? buffer.size() : lineEnd + 1);
 
 		if (line.length() < 4 || line[0] == '#' || line[1] == '#')
 			continue;
 
-		auto sepLoc = line.find_first_of(';');
-		if (sepLoc == std::string::npos)
-			continue;
-		auto key = line.substr(0, sepLoc);
-		auto newLine = line.substr(sepLoc + 1, line.length());
-		sepLoc = newLine.find_first_of(';');
-		if (sepLoc == std::string::npos)
-			continue;
-		auto english = newLine.substr(0, sepLoc);
-		newLine = newLine.substr(sepLoc + 1, newLine.length());
-		sepLoc = newLine.find_first_of(';');
-		if (sepLoc == std::string::npos)
-			continue;
-		auto french = newLine.substr(0, sepLoc);
-		newLine = newLine.substr(sepLoc + 1, newLine.length());
-		sepLoc = newLine.find_first_of(';');
-		if (sepLoc == std::string::npos)
-			continue;
-		auto german = newLine.substr(0, sepLoc);
-		newLine = newLine.substr(sepLoc + 1, newLine.length());
-		sepLoc = newLine.find_first_of(';');
-		if (sepLoc == std::string::npos)
-			continue;
-		newLine = newLine.substr(sepLoc + 1, newLine.length());
-		sepLoc = newLine.find_first_of(';');
-		if (sepLoc == std::string::npos)
+		// key;english;french;german;;spanish;... - a line without all six separators is dropped.
+		auto separators = 0;
+		auto sepLoc = std::string_view::npos;
+		for (auto position = line.find(';'); position != std::string_view::npos && separators < 6; position = line.find(';', position + 1))
+		{
+			if (!separators)
+				sepLoc = position;
+			++separators;
+		}
+		if (separators < 6)
 			continue;
-		auto spanish = newLine.substr(0, sepLoc);
 
-		LocBlock newBlock;
-		newBlock.english = english;
-		newBlock.french = french;
-		newBlock.german = german;
-		newBlock.spanish = spanish;
-		if (localizations.contains(key))
-			localizations[key] = newBlock;
-		else
-			localizations.insert(std::pair(key, newBlock));
+		entries.emplace_back(line.substr(0, sepLoc), line.substr(sepLoc + 1));
 	}
 }
 
+void mappers::LocalizationMapper::mergeEntries(const LocEntries& entries)
+{
+	for (const auto& [key, line]: entries)
+		localizations.insert_or_assign(key, line);
+}
 
-std::optional<mappers::LocBlock> mappers::LocalizationMapper::getLocBlockForKey(const std::string& key) const
+mappers::LocView mappers::LocalizationMapper::decodeLine(std::string_view line)
+{
+	std::string_view fields[5];
+	for (auto& field: fields)
+	{
+		const auto sepLoc = line.find(';');
+		field = line.substr(0, sepLoc);
+		line.remove_prefix(sepLoc + 1);
+	}
+	return LocView{fields[0], fields[1], fields[2], fields[4]};
+}
+
+std::optional<mappers::LocView> mappers::LocalizationMapper::getLocBlockForKey(const std::string_view key) const
 {
 	const auto& keyItr = localizations.find(key);
 	if (keyItr == localizations.end())
 		return std::nullopt;
 
-	if (!keyItr->second.english.empty() && (keyItr->second.spanish.empty() || keyItr->second.german.empty() || keyItr->second.french.empty()))
+	auto newBlock = decodeLine(keyItr->second);
+	// If we're missing english there's nothing to fill the rest with.
+	if (!newBlock.english.empty())
 	{
-		auto newBlock = keyItr->second;
 		if (newBlock.spanish.empty())
 			newBlock.spanish = newBlock.english;
 		if (newBlock.german.empty())
 			newBlock.german = newBlock.english;
 		if (newBlock.french.empty())
 			newBlock.french = newBlock.english;
-		return std::move(newBlock);
 	}
-	// either all is well, or we're missing english. Can't do anything about the latter.
-	return keyItr->second;
-}
\ No newline at end of file
+	return newBlock;
+}
+
+std::size_t mappers::LocalizationMapper::heapBytes() const
+{
+	auto bytes = buffers.capacity() * sizeof(decltype(buffers)::value_type) + CK2::MemoryCensus::heapBytes(localizations);
+	for (const auto& buffer: buffers)
+		bytes += sizeof(std::string) + CK2::MemoryCensus::controlBlockBytes + CK2::MemoryCensus::heapBytes(*buffer);
+	return bytes;
+}
@@ -1,9 +1,13 @@
 #ifndef LOCALIZATION_MAPPER
 #define LOCALIZATION_MAPPER
 #include "ModLoader/ModLoader.h"
-#include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class Configuration;
 namespace mappers
@@ -16,6 +20,18 @@ typedef struct
 	std::string spanish;
 } LocBlock;
 
+// A LocBlock still inside the mapper's file buffers, good for as long as the mapper is. Lookups hand these out
+// without allocating, and the languages a line leaves empty point at its english; callers copy out only what they keep.
+struct LocView
+{
+	std::string_view english;
+	std::string_view french;
+	std::string_view german;
+	std::string_view spanish;
+
+	[[nodiscard]] LocBlock toBlock() const { return LocBlock{std::string(english), std::string(french), std::string(german), std::string(spanish)}; }
+};
+
 class LocalizationMapper
 {
   public:
@@ -23,10 +39,21 @@ class LocalizationMapper
 	void scrapeLocalizations(const Configuration& theConfiguration, const Mods& mods);
 	void scrapeStream(std::istream& theStream);
 
-	[[nodiscard]] std::optional<LocBlock> getLocBlockForKey(const std::string& key) const;
+	[[nodiscard]] std::optional<LocView> getLocBlockForKey(std::string_view key) const;
+	// The retained files and their index, for CK2::MemoryCensus.
+	[[nodiscard]] std::size_t heapBytes() const;
 
   private:
-	std::map<std::string, LocBlock> localizations;
+	// key -> the rest of its line, both views into one of the retained file buffers.
+	using LocEntries = std::vector<std::pair<std::string_view, std::string_view>>;
+
+	// Indexes a whole csv buffer in one pass. Language columns are only split out when a key is asked for.
+	static void scrapeBuffer(std::string_view buffer, LocEntries& entries);
+	[[nodiscard]] static LocView decodeLine(std::string_view line);
+	void mergeEntries(const LocEntries& entries);
+
+	std::vector<std::shared_ptr<const std::string>> buffers;
+	std::unordered_map<std::string_view, std::string_view> localizations;
 };
 } // namespace mappers
 
@@ -0,0 +1,184 @@
+#include "LookupRecorder.h"
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+std::atomic<bool> mappers::LookupRecorder::on = false;
+
+// The file is a magic header and then one record per call: the call byte, the argument and result counts, and the
+// values. A value is a tag byte and then nothing, a zigzag varint, or a string. A string is spelled out the first time
+// it is written and referred to by its number after that; culture, tag and region names repeat endlessly.
+namespace
+{
+enum class TAG: std::uint8_t
+{
+	NONE = 0,
+	NUMBER = 1,
+	NEW_STRING = 2,
+	STRING = 3
+};
+
+std::mutex recorderMutex;
+std::ofstream output;
+std::unordered_map<std::string, std::uint64_t> stringNumbers;
+
+void writeVarint(std::uint64_t number)
+{
+	while (number >= 0x80)
+	{
+		output.put(static_cast<char>((number & 0x7f) | 0x80));
+		number >>= 7;
+	}
+	output.put(static_cast<char>(number));
+}
+
+void writeValue(const mappers::LookupRecorder::Value& value)
+{
+	if (const auto* number = std::get_if<long long>(&value))
+	{
+		output.put(static_cast<char>(TAG::NUMBER));
+		writeVarint((static_cast<std::uint64_t>(*number) << 1) ^ static_cast<std::uint64_t>(*number >> 63));
+	}
+	else if (const auto* text = std::get_if<std::string>(&value))
+	{
+		if (const auto& numberItr = stringNumbers.find(*text); numberItr != stringNumbers.end())
+		{
+			output.put(static_cast<char>(TAG::STRING));
+			writeVarint(numberItr->second);
+		}
+		else
+		{
+			stringNumbers.emplace(*text, stringNumbers.size());
+			output.put(static_cast<char>(TAG::NEW_STRING));
+			writeVarint(text->size());
+			output.write(text->data(), static_cast<std::streamsize>(text->size()));
+		}
+	}
+	else
+	{
+		output.put(static_cast<char>(TAG::NONE));
+	}
+}
+
+std::uint8_t readByte(std::istream& theStream)
+{
+	const auto byte = theStream.get();
+	if (byte == std::char_traits<char>::eof())
+		throw std::runtime_error("Lookup trace is truncated.");
+	return static_cast<std::uint8_t>(byte);
+}
+
+std::uint64_t readVarint(std::istream& theStream)
+{
+	std::uint64_t number = 0;
+	for (auto shift = 0; shift < 64; shift += 7)
+	{
+		const auto byte = readByte(theStream);
+		number |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return number;
+	}
+	throw std::runtime_error("Lookup trace holds a malformed number.");
+}
+
+mappers::LookupRecorder::Value readValue(std::istream& theStream, std::vector<std::string>& strings)
+{
+	switch (TAG(readByte(theStream)))
+	{
+		case TAG::NONE:
+			return {};
+		case TAG::NUMBER:
+		{
+			const auto zigzag = readVarint(theStream);
+			return static_cast<long long>((zigzag >> 1) ^ (0 - (zigzag & 1)));
+		}
+		case TAG::NEW_STRING:
+		{
+			std::string text(readVarint(theStream), '\0');
+			if (!theStream.read(text.data(), static_cast<std::streamsize>(text.size())))
+				throw std::runtime_error("Lookup trace is truncated.");
+			strings.emplace_back(text);
+			return text;
+		}
+		case TAG::STRING:
+		{
+			const auto number = readVarint(theStream);
+			if (number >= strings.size())
+				throw std::runtime_error("Lookup trace refers to a string it never wrote.");
+			return strings[number];
+		}
+	}
+	throw std::runtime_error("Lookup trace holds an unknown value.");
+}
+} // namespace
+
+void mappers::LookupRecorder::start(const std::string& filePath)
+{
+	const std::lock_guard lock(recorderMutex);
+	if (on)
+		return;
+	output.open(filePath, std::ios::binary | std::ios::trunc);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + filePath);
+	output.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+	stringNumbers.clear();
+	on = true;
+}
+
+void mappers::LookupRecorder::record(const CALL call, std::vector<Value> arguments, std::vector<Value> results)
+{
+	if (!recording())
+		return;
+	const std::lock_guard lock(recorderMutex);
+	if (!on)
+		return;
+	output.put(static_cast<char>(call));
+	writeVarint(arguments.size());
+	writeVarint(results.size());
+	for (const auto& argument: arguments)
+		writeValue(argument);
+	for (const auto& result: results)
+		writeValue(result);
+}
+
+void mappers::LookupRecorder::stop()
+{
+	const std::lock_guard lock(recorderMutex);
+	if (!on)
+		return;
+	on = false;
+	output.close();
+	stringNumbers.clear();
+}
+
+std::vector<mappers::LookupRecorder::Call> mappers::LookupRecorder::read(const std::string& filePath)
+{
+	std::ifstream input(filePath, std::ios::binary);
+	if (!input.is_open())
+		throw std::runtime_error("Could not open " + filePath);
+	return read(input);
+}
+
+std::vector<mappers::LookupRecorder::Call> mappers::LookupRecorder::read(std::istream& theStream)
+{
+	std::string header(magic.size(), '\0');
+	if (!theStream.read(header.data(), static_cast<std::streamsize>(header.size())) || header != magic)
+		throw std::runtime_error("Not a lookup trace.");
+
+	std::vector<Call> calls;
+	std::vector<std::string> strings;
+	for (auto call = theStream.get(); call != std::char_traits<char>::eof(); call = theStream.get())
+	{
+		if (call < static_cast<int>(CALL::CULTURE) || call > static_cast<int>(CALL::PROVINCE))
+			throw std::runtime_error("Lookup trace holds an unknown call.");
+		auto& newCall = calls.emplace_back(Call{CALL(call), {}, {}});
+		const auto argumentCount = readVarint(theStream);
+		const auto resultCount = readVarint(theStream);
+		for (std::uint64_t index = 0; index < argumentCount; ++index)
+			newCall.arguments.emplace_back(readValue(theStream, strings));
+		for (std::uint64_t index = 0; index < resultCount; ++index)
+			newCall.results.emplace_back(readValue(theStream, strings));
+	}
+	return calls;
+}
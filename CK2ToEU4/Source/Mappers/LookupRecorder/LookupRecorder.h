@@ -0,0 +1,64 @@
+#ifndef LOOKUP_RECORDER_H
+#define LOOKUP_RECORDER_H
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace mappers
+{
+// Every culture, religion, government, region, tag and province lookup of a conversion, with its arguments and its
+// answer, as compact binary records. Off unless started, and while off a lookup pays one relaxed load for it.
+// Calls land in the file in the order they returned; the tag mapper is stateful, so its registrations are recorded too
+// and a replay must feed them back in that same order.
+class LookupRecorder
+{
+  public:
+	enum class CALL: std::uint8_t
+	{
+		CULTURE = 1,
+		CULTURE_REGIONAL = 2,
+		CULTURE_NONREGIONAL_NONRELIGIOUS = 3,
+		RELIGION = 4,
+		GOVERNMENT = 5,
+		REGION = 6,
+		TAG = 7,
+		TAG_REGISTRATION = 8,
+		PROVINCE = 9
+	};
+
+	// Every recording opens with this.
+	static constexpr std::string_view magic = "CK2LKUP1";
+
+	// No value, a number (bools and provinces included), or a string.
+	using Value = std::variant<std::monostate, long long, std::string>;
+
+	struct Call
+	{
+		CALL call = CALL::CULTURE;
+		std::vector<Value> arguments;
+		std::vector<Value> results;
+		bool operator==(const Call& rhs) const = default;
+	};
+
+	static void start(const std::string& filePath);
+	[[nodiscard]] static bool recording() { return on.load(std::memory_order_relaxed); }
+	static void record(CALL call, std::vector<Value> arguments, std::vector<Value> results);
+	// Flushes and closes the file and turns recording back off.
+	static void stop();
+
+	[[nodiscard]] static std::vector<Call> read(const std::string& filePath);
+	[[nodiscard]] static std::vector<Call> read(std::istream& theStream);
+
+	[[nodiscard]] static Value value(const std::optional<std::string>& text) { return text ? Value(*text) : Value(); }
+
+  private:
+	static std::atomic<bool> on;
+};
+} // namespace mappers
+
+#endif // LOOKUP_RECORDER_H
@@ -28,3 +28,10 @@ void mappers::MonumentsMapper::registerKeys()
 		wonders.emplace(std::pair(type, newMapping));
 	});
 }
+
+const mappers::MonumentsMapping* mappers::MonumentsMapper::getMapping(const std::string& type) const
+{
+	if (const auto& mappingItr = wonders.find(type); mappingItr != wonders.end())
+		return &mappingItr->second;
+	return nullptr;
+}
@@ -12,6 +12,7 @@ class MonumentsMapper: commonItems::parser
 	MonumentsMapper(std::istream& theStream);
 
 	[[nodiscard]] const auto& getWonders() const { return wonders; }
+	[[nodiscard]] const MonumentsMapping* getMapping(const std::string& type) const;
 
   private:
 	void registerKeys();
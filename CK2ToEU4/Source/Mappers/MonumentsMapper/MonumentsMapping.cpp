@@ -18,6 +18,12 @@ void mappers::MonumentsMapping::registerKeys()
 		auto movedStr = commonItems::stringOfItem(theStream).getString();
 		canBeMoved = movedStr.find("can_be_moved = yes") != std::string::npos;
 	});
+	registerKeyword("premade", [this](std::istream& theStream) {
+		premade = commonItems::singleString(theStream).getString() == "yes";
+	});
+	registerKeyword("upgrade_padding", [this](std::istream& theStream) {
+		upgradePadding = commonItems::stringList(theStream).getStrings();
+	});
 	registerKeyword("build_trigger", [this](std::istream& theStream) {
 		const BuildTriggerBuilder builder(theStream);
 		if (builder.getBuildTrigger().size() > 8)
@@ -15,14 +15,16 @@ class MonumentsMapping: commonItems::parser
 	void AddCountrySet(std::istream& theStream);
 
 	[[nodiscard]] auto getIsBase() const { return isBase; }
-	[[nodiscard]] auto getProvinceModifiers() const { return provinceModifiers; }
-	[[nodiscard]] auto getAreaModifiers() const { return areaModifiers; }
-	[[nodiscard]] auto getCountryModifiers() const { return countryModifiers; }
-	[[nodiscard]] auto getOnUpgraded() const { return onUpgraded; }
+	[[nodiscard]] const auto& getProvinceModifiers() const { return provinceModifiers; }
+	[[nodiscard]] const auto& getAreaModifiers() const { return areaModifiers; }
+	[[nodiscard]] const auto& getCountryModifiers() const { return countryModifiers; }
+	[[nodiscard]] const auto& getOnUpgraded() const { return onUpgraded; }
 	[[nodiscard]] auto isOfBuilderCulture() const { return cultural; }
 	[[nodiscard]] auto isOfBuilderReligion() const { return religious; }
-	[[nodiscard]] auto getBuildTrigger() const { return buildTrigger; }
+	[[nodiscard]] const auto& getBuildTrigger() const { return buildTrigger; }
 	[[nodiscard]] auto getCanBeMoved() const { return canBeMoved; }
+	[[nodiscard]] auto isPremade() const { return premade; }
+	[[nodiscard]] const auto& getUpgradePadding() const { return upgradePadding; }
 
 
   private:
@@ -32,6 +34,9 @@ class MonumentsMapping: commonItems::parser
 	bool canBeMoved = false;
 	bool cultural = false;
 	bool religious = false;
+	bool premade = false; // already defined in EU4, left as it is
+
+	std::vector<std::string> upgradePadding; // generic upgrades for monuments short of tier 3, in order
 
 	// Modifier, { tier0, tier1, tier2, tier3 }
 	std::map<std::string, std::vector<double>> provinceModifiers;
@@ -1,48 +1,72 @@
 #include "PersonalityScraper.h"
 #include "../../Configuration/Configuration.h"
-#include "CommonRegexes.h"
+#include "../../Parsing/TokenMatcher.h"
+#include "../../Parsing/Tokenizer.h"
+#include "../CompiledConfigurables/CompiledConfigurables.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
-#include "ParserHelpers.h"
-#include <set>
+
+namespace
+{
+// Bump whenever the cache writes anything differently.
+const std::string cacheFormat = "traits 1";
+} // namespace
 
 void mappers::PersonalityScraper::scrapePersonalities(const Configuration& theConfiguration)
 {
 	Log(LogLevel::Info) << "-> Examiming Personalities";
-	registerKeys();
-	auto fileNames = commonItems::GetAllFilesInFolder(theConfiguration.getCK2Path() + "/common/traits/");
-	for (const auto& fileName: fileNames)
+	const auto traitsPath = theConfiguration.getCK2Path() + "/common/traits";
+	std::vector<std::string> paths;
+	for (const auto& fileName: commonItems::GetAllFilesInFolder(traitsPath + "/"))
+		if (fileName.find("txt") != std::string::npos)
+			paths.emplace_back(traitsPath + "/" + fileName);
+
+	const auto key = cacheFormat + CompiledConfigurables::fingerprint(paths);
+	const auto cachePath = CompiledConfigurables::compiledPath(traitsPath, "snapshots/traits");
+	if (CompiledConfigurables::loadKeyed(cachePath, key, [this](CompiledConfigurables::Reader& reader) {
+			 reader.get(personalities);
+		 }))
 	{
-		if (fileName.find("txt") == std::string::npos)
-			continue;
-		parseFile(theConfiguration.getCK2Path() + "/common/traits/" + fileName);
+		Log(LogLevel::Info) << ">> " << personalities.size() << " personalities scrutinized from " << cachePath;
+		return;
 	}
-	clearRegisteredKeywords();
+
+	personalities.clear();
+	for (const auto& path: paths)
+		if (const auto contents = parsing::readFile(path))
+			scrapeBuffer(*contents);
+		else
+			Log(LogLevel::Error) << "Could not open " << path << " for parsing.";
+	CompiledConfigurables::saveKeyed(cachePath, key, [this](CompiledConfigurables::Writer& writer) {
+		writer.put(personalities);
+	});
 	Log(LogLevel::Info) << ">> " << personalities.size() << " personalities scrutinized.";
 }
 
 void mappers::PersonalityScraper::scrapePersonalities(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	scrapeBuffer(parsing::readStream(theStream));
 }
 
-void mappers::PersonalityScraper::registerKeys()
+void mappers::PersonalityScraper::scrapeBuffer(const std::string_view buffer)
 {
-	registerRegex("[A-Za-z0-9_-]+", [this](const std::string& personalityName, std::istream& theStream) {
-		commonItems::ignoreItem(personalityName, theStream);
-		personalities.insert(std::pair(counter, personalityName));
-		++counter;
-	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	// Only the top-level keys matter, each trait's body is skipped without being lexed.
+	using TokenType = parsing::Tokenizer::TokenType;
+	static const auto isTrait = parsing::TokenMatcher::characters(parsing::TokenMatcher::identifierCharacters);
+	parsing::Tokenizer tokens(buffer);
+	for (auto token = tokens.next(); token.type != TokenType::END; token = tokens.next())
+	{
+		if (token.type != TokenType::WORD && token.type != TokenType::QUOTED)
+			continue;
+		tokens.skipItem();
+		if (isTrait.matches(token.text))
+			personalities.emplace_back(token.text);
+	}
 }
 
-
-std::optional<std::string> mappers::PersonalityScraper::getPersonalityForID(int ID) const
+std::optional<std::string> mappers::PersonalityScraper::getPersonalityForID(const int ID) const
 {
-	const auto& personItr = personalities.find(ID);
-	if (personItr != personalities.end())
-		return personItr->second;
-	return std::nullopt;
+	if (ID < 1 || static_cast<std::size_t>(ID) > personalities.size())
+		return std::nullopt;
+	return personalities[ID - 1];
 }
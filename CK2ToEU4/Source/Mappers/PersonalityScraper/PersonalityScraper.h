@@ -1,28 +1,34 @@
 #ifndef PERSONALITY_SCRAPER
 #define PERSONALITY_SCRAPER
 
-#include "Parser.h"
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 class Configuration;
+
 namespace mappers
 {
-class PersonalityScraper: commonItems::parser
+class PersonalityScraper
 {
   public:
 	PersonalityScraper() = default;
 	void scrapePersonalities(std::istream& theStream);
+	// Cached under snapshots/traits/ for as long as no trait file of the install changes.
 	void scrapePersonalities(const Configuration& theConfiguration);
 
+	// Trait names by ID - 1, saves number traits from 1 in file order.
 	[[nodiscard]] const auto& getPersonalities() const { return personalities; }
 
 	[[nodiscard]] std::optional<std::string> getPersonalityForID(int ID) const;
 
   private:
-	void registerKeys();
+	void scrapeBuffer(std::string_view buffer);
 
-	int counter = 1; // Yes, 1.
-	std::map<int, std::string> personalities;
+	std::vector<std::string> personalities;
 };
 } // namespace mappers
 
-#endif // PERSONALITY_SCRAPER
\ No newline at end of file
+#endif // PERSONALITY_SCRAPER
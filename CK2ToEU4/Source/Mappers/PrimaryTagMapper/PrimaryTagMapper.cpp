@@ -1,44 +1,133 @@
 #include "PrimaryTagMapper.h"
-#include "CommonRegexes.h"
+#include "../../CK2World/CacheStore.h"
+#include "../../Parsing/Tokenizer.h"
+#include "../CompiledConfigurables/CompiledConfigurables.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
-#include "ParserHelpers.h"
-#include "PrimaryTagCultureGroup.h"
+#include <algorithm>
+#include <ranges>
+#include <set>
+
+namespace
+{
+// Bump whenever the cache writes anything differently.
+const std::string cacheFormat = "primary tags 1";
+
+// Culture group fields that hold no cultures.
+const std::set<std::string_view> groupFields = {"graphical_culture", "second_graphical_culture", "male_names", "female_names", "dynasty_names"};
+
+std::optional<std::string_view> primaryTagOf(const std::string_view culture)
+{
+	using TokenType = parsing::Tokenizer::TokenType;
+	parsing::Tokenizer tokens(culture);
+	if (tokens.peek().type == TokenType::EQUALS)
+		tokens.next();
+	if (tokens.next().type != TokenType::OPEN)
+		return std::nullopt;
+	for (auto token = tokens.next(); token.type != TokenType::END && token.type != TokenType::CLOSE; token = tokens.next())
+	{
+		if (token.type != TokenType::WORD)
+			continue;
+		if (token.text == "primary")
+			return tokens.getString();
+		tokens.skipItem();
+	}
+	return std::nullopt;
+}
+} // namespace
 
 void mappers::PrimaryTagMapper::loadPrimaryTags(const Configuration& theConfiguration)
 {
 	Log(LogLevel::Info) << "-> Sifting Through EU4 Cultures";
-	registerKeys();
 
-	for (const auto& filename: commonItems::GetAllFilesInFolder("blankMod/output/common/cultures/"))
-		parseFile("blankMod/output/common/cultures/" + filename);
-	for (const auto& filename: commonItems::GetAllFilesInFolder(theConfiguration.getEU4Path() + "/common/cultures/"))
-		parseFile(theConfiguration.getEU4Path() + "/common/cultures/" + filename);
+	std::vector<std::string> paths;
+	for (const auto& folder: {std::string("blankMod/output/common/cultures/"), theConfiguration.getEU4Path() + "/common/cultures/"})
+		for (const auto& filename: commonItems::GetAllFilesInFolder(folder))
+			paths.emplace_back(folder + filename);
 
-	clearRegisteredKeywords();
-	Log(LogLevel::Info) << "<> " << cultureTags.size() << " culture tags located.";
+	const auto key = cacheFormat + CompiledConfigurables::fingerprint(paths);
+	const auto cacheName = CK2::CacheStore::pathFor("primary_tags", key);
+	if (CompiledConfigurables::loadKeyed(cacheName, key, [this](CompiledConfigurables::Reader& reader) {
+			 reader.get(cultures);
+			 reader.get(tags);
+			 reader.get(primaryTags);
+		 }))
+	{
+		Log(LogLevel::Info) << "<> " << primaryTags.size() << " culture tags located in " << cacheName;
+		return;
+	}
+
+	std::map<std::string, std::string> cultureTags;
+	for (const auto& path: paths)
+		if (const auto contents = parsing::readFile(path))
+			scrapeBuffer(*contents, cultureTags);
+		else
+			Log(LogLevel::Error) << "Could not open " << path << " for parsing.";
+	compact(cultureTags);
+	CompiledConfigurables::saveKeyed(cacheName, key, [this](CompiledConfigurables::Writer& writer) {
+		writer.put(cultures);
+		writer.put(tags);
+		writer.put(primaryTags);
+	});
+	Log(LogLevel::Info) << "<> " << primaryTags.size() << " culture tags located.";
 }
 
 mappers::PrimaryTagMapper::PrimaryTagMapper(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	std::map<std::string, std::string> cultureTags;
+	scrapeBuffer(parsing::readStream(theStream), cultureTags);
+	compact(cultureTags);
 }
 
-void mappers::PrimaryTagMapper::registerKeys()
+void mappers::PrimaryTagMapper::scrapeBuffer(const std::string_view buffer, std::map<std::string, std::string>& cultureTags)
 {
-	registerRegex(commonItems::catchallRegex, [this](const std::string& unused, std::istream& theStream) {
-		const PrimaryTagCultureGroup theGroup(theStream);
-		const auto& collectedTags = theGroup.getCollectedTags();
-		cultureTags.insert(collectedTags.begin(), collectedTags.end());
-	});
+	using TokenType = parsing::Tokenizer::TokenType;
+	parsing::Tokenizer tokens(buffer);
+	while (!tokens.atEnd())
+	{
+		// group = { culture = { ... } culture = { ... } field = ... }
+		if (tokens.next().type != TokenType::WORD)
+			continue;
+		if (tokens.peek().type == TokenType::EQUALS)
+			tokens.next();
+		if (tokens.peek().type != TokenType::OPEN)
+		{
+			tokens.skipItem();
+			continue;
+		}
+		tokens.next();
+		for (auto culture = tokens.next(); culture.type != TokenType::END && culture.type != TokenType::CLOSE; culture = tokens.next())
+		{
+			if (culture.type != TokenType::WORD)
+				continue;
+			const auto item = tokens.getItem();
+			if (groupFields.contains(culture.text))
+				continue;
+			if (const auto tag = primaryTagOf(item))
+				cultureTags.emplace(culture.text, *tag);
+		}
+	}
+}
+
+void mappers::PrimaryTagMapper::compact(const std::map<std::string, std::string>& cultureTags)
+{
+	cultures.clear();
+	std::set<std::string> distinctTags;
+	for (const auto& [culture, tag]: cultureTags)
+	{
+		cultures.emplace_back(culture);
+		distinctTags.emplace(tag);
+	}
+	tags.assign(distinctTags.begin(), distinctTags.end());
+	primaryTags.clear();
+	for (const auto& tag: cultureTags | std::views::values)
+		primaryTags.emplace_back(static_cast<std::uint16_t>(std::ranges::lower_bound(tags, tag) - tags.begin()));
 }
 
 std::optional<std::string> mappers::PrimaryTagMapper::getPrimaryTagForCulture(const std::string& culture) const
 {
-	const auto& cultureItr = cultureTags.find(culture);
-	if (cultureItr != cultureTags.end())
-		return cultureItr->second;
-	return std::nullopt;
+	const auto cultureItr = std::ranges::lower_bound(cultures, culture);
+	if (cultureItr == cultures.end() || *cultureItr != culture)
+		return std::nullopt;
+	return tags[primaryTags[static_cast<std::size_t>(cultureItr - cultures.begin())]];
 }
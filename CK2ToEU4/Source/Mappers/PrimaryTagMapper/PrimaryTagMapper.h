@@ -2,7 +2,13 @@
 #define PRIMARY_TAG_MAPPER_H
 
 #include "../../Configuration/Configuration.h"
-#include "Parser.h"
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace CK2
 {
@@ -11,22 +17,31 @@ class Character;
 
 namespace mappers
 {
-class PrimaryTagMapper: commonItems::parser
+class PrimaryTagMapper
 {
   public:
 	PrimaryTagMapper() = default;
 	explicit PrimaryTagMapper(std::istream& theStream);
 
+	// The converter's own cultures, then EU4's, earlier files winning. Cached under snapshots/primary_tags/ for as
+	// long as none of those files changes.
 	void loadPrimaryTags(const Configuration& theConfiguration);
 	[[nodiscard]] std::optional<std::string> getPrimaryTagForCulture(const std::string& culture) const;
 
-	[[nodiscard]] const auto& getCultureTags() const { return cultureTags; } // for testing
+	[[nodiscard]] const auto& getCultureTags() const { return primaryTags; } // for testing
 
   private:
-	void registerKeys();
-
-	std::map<std::string, std::string> cultureTags;
+	// Only "primary" is wanted out of whole culture files, so they're walked two levels deep with the tokenizer
+	// rather than parsed; names and graphics are skipped unread. Cultures already found keep their tag.
+	static void scrapeBuffer(std::string_view buffer, std::map<std::string, std::string>& cultureTags);
+	void compact(const std::map<std::string, std::string>& cultureTags);
+
+	// Cultures and tags are numbered by their position in these sorted lists, and each culture's primary tag is
+	// looked up by number.
+	std::vector<std::string> cultures;
+	std::vector<std::string> tags;
+	std::vector<std::uint16_t> primaryTags; // culture ID -> tag ID
 };
 } // namespace mappers
 
-#endif // PRIMARY_TAG_MAPPER_H
\ No newline at end of file
+#endif // PRIMARY_TAG_MAPPER_H
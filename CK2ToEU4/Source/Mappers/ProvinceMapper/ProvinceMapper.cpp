@@ -1,43 +1,63 @@
 #include "ProvinceMapper.h"
 #include "../../Configuration/Configuration.h"
+#include "../CompiledConfigurables/CompiledConfigurables.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
 #include "ParserHelpers.h"
 #include "ProvinceMapping.h"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <stdexcept>
 namespace fs = std::filesystem;
 
+namespace
+{
+// Bump whenever ProvinceLinks writes anything differently.
+const std::string compiledFormat = "province mappings 1";
+} // namespace
+
 mappers::ProvinceMapper::ProvinceMapper(const Mods& mods, const std::string& overrideMod)
 {
 	Log(LogLevel::Info) << "-> Parsing province mappings";
-	registerKeys();
-
+	std::string mappingsPath = "configurables/province_mappings.txt";
 	if (overrideMod.empty())
 	{
-		auto loadedProvinces = false;
 		for (const auto& mod: mods)
 			if (commonItems::DoesFileExist("configurables/" + mod.name + "_province_mappings.txt"))
 			{
 				Log(LogLevel::Info) << ">> Loading Province Mappings for " << mod.name;
-				parseFile("configurables/" + mod.name + "_province_mappings.txt");
-				loadedProvinces = true;
+				mappingsPath = "configurables/" + mod.name + "_province_mappings.txt";
 				break;
 			}
-		if (!loadedProvinces)
-			parseFile("configurables/province_mappings.txt");
 	}
 	else
 	{
 		Log(LogLevel::Info) << ">> Loading Province Mappings for " << overrideMod;
-		parseFile("configurables/" + overrideMod + "/province_mappings.txt");
+		mappingsPath = "configurables/" + overrideMod + "/province_mappings.txt";
 	}
 
-	clearRegisteredKeywords();
-	createMappings();
-	Log(LogLevel::Info) << "<> " << theMappings.getMappings().size() << " mappings loaded.";
+	const std::vector sourcePaths{mappingsPath};
+	if (CompiledConfigurables::load(sourcePaths, compiledFormat, [this](CompiledConfigurables::Reader& reader) {
+			 reader.get(CK2ToEU4ProvinceMap);
+			 reader.get(EU4ToCK2ProvinceMap);
+		 }))
+	{
+		Log(LogLevel::Info) << "<> Province mappings loaded from " << CompiledConfigurables::compiledPath(mappingsPath);
+	}
+	else
+	{
+		registerKeys();
+		parseFile(mappingsPath);
+		clearRegisteredKeywords();
+		createMappings();
+		Log(LogLevel::Info) << "<> " << theMappings.getMappings().size() << " mappings loaded.";
+		CompiledConfigurables::save(sourcePaths, compiledFormat, [this](CompiledConfigurables::Writer& writer) {
+			writer.put(CK2ToEU4ProvinceMap);
+			writer.put(EU4ToCK2ProvinceMap);
+		});
+	}
 	loadOffmapChineseProvinces();
 }
 
@@ -71,6 +91,8 @@ void mappers::ProvinceMapper::registerOffmapKeys()
 
 void mappers::ProvinceMapper::createMappings()
 {
+	std::map<int, std::vector<int>> CK2ToEU4Links;
+	std::map<int, std::vector<int>> EU4ToCK2Links;
 	for (const auto& mapping: theMappings.getMappings())
 	{
 		// fix deliberate errors where we leave mappings without keys (asian wasteland comes to mind):
@@ -82,53 +104,92 @@ void mappers::ProvinceMapper::createMappings()
 		for (const auto& ck2Number: mapping.getCK2Provinces())
 		{
 			if (ck2Number)
-				CK2ToEU4ProvinceMap.insert(std::make_pair(ck2Number, mapping.getEU4Provinces()));
+				CK2ToEU4Links.insert(std::make_pair(ck2Number, mapping.getEU4Provinces()));
 		}
 		for (const auto& eu4Number: mapping.getEU4Provinces())
 		{
 			if (eu4Number)
-				EU4ToCK2ProvinceMap.insert(std::make_pair(eu4Number, mapping.getCK2Provinces()));
+				EU4ToCK2Links.insert(std::make_pair(eu4Number, mapping.getCK2Provinces()));
 		}
 	}
+	CK2ToEU4ProvinceMap.build(CK2ToEU4Links);
+	EU4ToCK2ProvinceMap.build(EU4ToCK2Links);
+}
+
+void mappers::ProvinceMapper::recordProvinceLookup(const int ck2ProvinceNumber, const std::span<const int> eu4ProvinceNumbers)
+{
+	std::vector<LookupRecorder::Value> results;
+	for (const auto eu4ProvinceNumber: eu4ProvinceNumbers)
+		results.emplace_back(static_cast<long long>(eu4ProvinceNumber));
+	LookupRecorder::record(LookupRecorder::CALL::PROVINCE, {static_cast<long long>(ck2ProvinceNumber)}, std::move(results));
+}
+
+void mappers::ProvinceMapper::ProvinceLinks::build(const std::map<int, std::vector<int>>& links)
+{
+	offsets.clear();
+	targets.clear();
+	// Negative province numbers don't exist in either game; they stay unmapped.
+	if (links.empty() || links.rbegin()->first < 0)
+		return;
+
+	offsets.reserve(static_cast<std::size_t>(links.rbegin()->first) + 2);
+	offsets.emplace_back(0);
+	for (const auto& [provinceNumber, provinceTargets]: links)
+	{
+		if (provinceNumber < 0)
+			continue;
+		offsets.resize(static_cast<std::size_t>(provinceNumber) + 1, targets.size()); // provinces without a mapping
+		targets.insert(targets.end(), provinceTargets.begin(), provinceTargets.end());
+		offsets.emplace_back(targets.size());
+	}
 }
 
-std::vector<int> mappers::ProvinceMapper::getCK2ProvinceNumbers(const int eu4ProvinceNumber) const
+void mappers::ProvinceMapper::ProvinceLinks::writeCompiled(CompiledConfigurables::Writer& writer) const
 {
-	const auto& mapping = EU4ToCK2ProvinceMap.find(eu4ProvinceNumber);
-	if (mapping != EU4ToCK2ProvinceMap.end())
-		return mapping->second;
-	return std::vector<int>();
+	writer.put(offsets);
+	writer.put(targets);
 }
 
-std::vector<int> mappers::ProvinceMapper::getEU4ProvinceNumbers(int ck2ProvinceNumber) const
+void mappers::ProvinceMapper::ProvinceLinks::readCompiled(CompiledConfigurables::Reader& reader)
 {
-	const auto& mapping = CK2ToEU4ProvinceMap.find(ck2ProvinceNumber);
-	if (mapping != CK2ToEU4ProvinceMap.end())
-		return mapping->second;
-	return std::vector<int>();
+	reader.get(offsets);
+	reader.get(targets);
+	if (!offsets.empty() && (offsets.front() != 0 || offsets.back() != targets.size() || !std::is_sorted(offsets.begin(), offsets.end())))
+		throw std::runtime_error("Province links don't add up.");
+}
+
+std::span<const int> mappers::ProvinceMapper::ProvinceLinks::find(const int provinceNumber) const
+{
+	if (provinceNumber < 0 || static_cast<std::size_t>(provinceNumber) + 1 >= offsets.size())
+		return {};
+	return std::span(targets).subspan(offsets[provinceNumber], offsets[provinceNumber + 1] - offsets[provinceNumber]);
 }
 
 void mappers::ProvinceMapper::determineValidProvinces(const Configuration& theConfiguration)
 {
-	Log(LogLevel::Info) << "-> Loading Valid Provinces";
-	std::ifstream definitionFile(fs::u8path(theConfiguration.getEU4Path() + "/map/definition.csv"));
-	if (!definitionFile.is_open())
-		throw std::runtime_error("Could not open <eu4>/map/definition.csv");
+	validEU4Provinces = LazyMapper<std::set<int>>([definitionsPath = theConfiguration.getEU4Path() + "/map/definition.csv"] {
+		Log(LogLevel::Info) << "-> Loading Valid Provinces";
+		std::ifstream definitionFile(fs::u8path(definitionsPath));
+		if (!definitionFile.is_open())
+			throw std::runtime_error("Could not open <eu4>/map/definition.csv");
 
-	char input[256];
-	while (!definitionFile.eof())
-	{
-		definitionFile.getline(input, 255);
-		std::string inputStr(input);
-		if (inputStr.substr(0, 8) == "province" || inputStr.substr(inputStr.find_last_of(';') + 1, 6) == "Unused" ||
-			 inputStr.substr(inputStr.find_last_of(';') + 1, 3) == "RNW" || inputStr.size() < 2)
+		auto validProvinces = std::make_unique<std::set<int>>();
+		char input[256];
+		while (!definitionFile.eof())
 		{
-			continue;
+			definitionFile.getline(input, 255);
+			std::string inputStr(input);
+			if (inputStr.substr(0, 8) == "province" || inputStr.substr(inputStr.find_last_of(';') + 1, 6) == "Unused" ||
+				 inputStr.substr(inputStr.find_last_of(';') + 1, 3) == "RNW" || inputStr.size() < 2)
+			{
+				continue;
+			}
+			auto provNum = std::stoi(inputStr.substr(0, inputStr.find_first_of(';')));
+			validProvinces->insert(provNum);
 		}
-		auto provNum = std::stoi(inputStr.substr(0, inputStr.find_first_of(';')));
-		validEU4Provinces.insert(provNum);
-	}
-	Log(LogLevel::Info) << "<> " << validEU4Provinces.size() << " valid provinces located.";
+		Log(LogLevel::Info) << "<> " << validProvinces->size() << " valid provinces located.";
+		return validProvinces;
+	});
 }
 
 void mappers::ProvinceMapper::loadOffmapChineseProvinces()
@@ -1,11 +1,16 @@
 #ifndef PROVINCE_MAPPER_H
 #define PROVINCE_MAPPER_H
 
+#include "../CompiledConfigurables/CompiledConfigurables.h"
+#include "../LazyMapper/LazyMapper.h"
+#include "../LookupRecorder/LookupRecorder.h"
 #include "ModLoader/ModLoader.h"
 #include "Parser.h"
 #include "ProvinceMappingsVersion.h"
 #include <map>
 #include <set>
+#include <span>
+#include <vector>
 
 class Configuration;
 
@@ -17,11 +22,18 @@ class ProvinceMapper: commonItems::parser
 	explicit ProvinceMapper(const Mods& mods, const std::string& overrideMod);
 	explicit ProvinceMapper(std::istream& theStream);
 
-	[[nodiscard]] std::vector<int> getCK2ProvinceNumbers(int eu4ProvinceNumber) const;
-	[[nodiscard]] std::vector<int> getEU4ProvinceNumbers(int ck2ProvinceNumber) const;
+	[[nodiscard]] std::span<const int> getCK2ProvinceNumbers(int eu4ProvinceNumber) const { return EU4ToCK2ProvinceMap.find(eu4ProvinceNumber); }
+	[[nodiscard]] std::span<const int> getEU4ProvinceNumbers(int ck2ProvinceNumber) const
+	{
+		const auto eu4ProvinceNumbers = CK2ToEU4ProvinceMap.find(ck2ProvinceNumber);
+		if (LookupRecorder::recording())
+			recordProvinceLookup(ck2ProvinceNumber, eu4ProvinceNumbers);
+		return eu4ProvinceNumbers;
+	}
 	[[nodiscard]] const auto& getOffmapChineseProvinces() const { return offmapChineseProvinces; }
-	[[nodiscard]] auto isValidEU4Province(const int eu4Province) const { return validEU4Provinces.count(eu4Province) > 0; }
+	[[nodiscard]] auto isValidEU4Province(const int eu4Province) const { return validEU4Provinces->count(eu4Province) > 0; }
 
+	// Where the valid provinces are to be found. They're only read off the map definitions on the first query.
 	void determineValidProvinces(const Configuration& theConfiguration);
 	void loadOffmapChineseProvinces();
 	void loadOffmapChineseProvinces(std::istream& theStream); // testing
@@ -30,10 +42,28 @@ class ProvinceMapper: commonItems::parser
 	void registerKeys();
 	void registerOffmapKeys();
 	void createMappings();
+	static void recordProvinceLookup(int ck2ProvinceNumber, std::span<const int> eu4ProvinceNumbers);
 
-	std::map<int, std::vector<int>> CK2ToEU4ProvinceMap;
-	std::map<int, std::vector<int>> EU4ToCK2ProvinceMap;
-	std::set<int> validEU4Provinces;
+	// Province number -> the province numbers it maps to, for every province number at once: the targets of province
+	// n are targets[offsets[n]] up to targets[offsets[n + 1]]. Both games number provinces densely from 1, so this
+	// is two short arrays and a lookup is two loads, with nothing to allocate on the way out.
+	class ProvinceLinks
+	{
+	  public:
+		void build(const std::map<int, std::vector<int>>& links);
+		[[nodiscard]] std::span<const int> find(int provinceNumber) const;
+
+		void writeCompiled(CompiledConfigurables::Writer& writer) const;
+		void readCompiled(CompiledConfigurables::Reader& reader);
+
+	  private:
+		std::vector<std::size_t> offsets;
+		std::vector<int> targets;
+	};
+
+	ProvinceLinks CK2ToEU4ProvinceMap;
+	ProvinceLinks EU4ToCK2ProvinceMap;
+	LazyMapper<std::set<int>> validEU4Provinces;
 	std::set<int> offmapChineseProvinces;
 	ProvinceMappingsVersion theMappings;
 };
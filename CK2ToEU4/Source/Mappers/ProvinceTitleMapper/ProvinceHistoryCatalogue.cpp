@@ -0,0 +1,56 @@
+#include "ProvinceHistoryCatalogue.h"
+#include "../../CK2World/ModFiles.h"
+#include "../../CK2World/TaskGraph.h"
+#include "../CompiledConfigurables/CompiledConfigurables.h"
+#include "CommonFunctions.h"
+#include "Log.h"
+#include "OSCompatibilityLayer.h"
+#include "ProvinceTitleGrabber.h"
+
+namespace
+{
+// Bump whenever the catalogue writes anything differently.
+const std::string catalogueFormat = "province history 2";
+constexpr std::size_t filesPerSlice = 32;
+} // namespace
+
+mappers::ProvinceHistoryCatalogue::ProvinceHistoryCatalogue(const std::string& folder)
+{
+	std::vector<std::string> paths;
+	for (const auto& fileName: CK2::listModFolder(folder))
+		if (getExtension(fileName) == "txt")
+			paths.emplace_back(folder + "/" + fileName);
+	fileCount = paths.size();
+	if (paths.empty())
+		return;
+
+	// Stat rather than hash: reading every file to tell whether to read every file would save little.
+	const auto key = catalogueFormat + CompiledConfigurables::fingerprint(paths);
+
+	const auto cachePath = CompiledConfigurables::compiledPath(folder, "snapshots/province_history");
+	if (CompiledConfigurables::loadKeyed(cachePath, key, [this](CompiledConfigurables::Reader& reader) {
+			 reader.get(entries);
+		 }))
+		return;
+
+	// A cold catalogue is thousands of small files, each mostly open and read latency, so they're scanned side by side
+	// and kept in filename order afterwards.
+	std::vector<std::pair<int, std::string>> scanned(paths.size());
+	CK2::forEachSlice(
+		 paths.size(),
+		 [&paths, &scanned](const std::size_t first, const std::size_t last) {
+			 for (auto index = first; index < last; ++index)
+			 {
+				 const ProvinceTitleGrabber newProvince(paths[index]);
+				 scanned[index] = std::pair(newProvince.getID(), newProvince.getTitle());
+			 }
+		 },
+		 filesPerSlice);
+	entries.clear();
+	for (auto& entry: scanned)
+		if (entry.first)
+			entries.emplace_back(std::move(entry));
+	CompiledConfigurables::saveKeyed(cachePath, key, [this](CompiledConfigurables::Writer& writer) {
+		writer.put(entries);
+	});
+}
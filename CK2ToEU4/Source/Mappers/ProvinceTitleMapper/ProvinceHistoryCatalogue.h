@@ -0,0 +1,27 @@
+#ifndef PROVINCE_HISTORY_CATALOGUE
+#define PROVINCE_HISTORY_CATALOGUE
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mappers
+{
+// The province ID and title of every file in one history/provinces folder, in filename order. Scanning a folder means
+// parsing each of its files; the result is kept under snapshots/province_history/ and reused for as long as no file in
+// the folder is added, removed, resized or touched.
+class ProvinceHistoryCatalogue
+{
+  public:
+	explicit ProvinceHistoryCatalogue(const std::string& folder);
+
+	[[nodiscard]] const auto& getEntries() const { return entries; }
+	[[nodiscard]] auto getFileCount() const { return fileCount; }
+
+  private:
+	std::vector<std::pair<int, std::string>> entries; // files without a valid ID are left out.
+	std::size_t fileCount = 0;
+};
+} // namespace mappers
+
+#endif // PROVINCE_HISTORY_CATALOGUE
@@ -1,16 +1,37 @@
 #include "ProvinceTitleGrabber.h"
+#include "../../CK2World/ModArchive.h"
+#include "../../CK2World/ModFiles.h"
+#include "../../CK2World/SaveGame/MappedFile.h"
+#include "../../Parsing/Tokenizer.h"
 #include "CommonFunctions.h"
-#include "CommonRegexes.h"
 #include "OSCompatibilityLayer.h"
-#include "ParserHelpers.h"
+
+namespace
+{
+// History entries are keyed by date ("867.1.1 = { ... }"), settings by name.
+bool isDate(const std::string_view key)
+{
+	return !key.empty() && key.front() >= '0' && key.front() <= '9' && key.find('.') != std::string_view::npos;
+}
+} // namespace
 
 mappers::ProvinceTitleGrabber::ProvinceTitleGrabber(const std::string& provincePath)
 {
-	if (!commonItems::DoesFileExist(provincePath))
-		throw std::runtime_error(provincePath + " does not exist?");
-	registerKeys();
-	parseFile(provincePath);
-	clearRegisteredKeywords();
+	if (CK2::ModArchive::locate(provincePath))
+	{
+		const auto contents = CK2::readModFile(provincePath);
+		if (!contents)
+			throw std::runtime_error(provincePath + " does not exist?");
+		scan(*contents);
+	}
+	else
+	{
+		if (!commonItems::DoesFileExist(provincePath))
+			throw std::runtime_error(provincePath + " does not exist?");
+		// Mapped rather than read, so the pages past the header are never faulted in.
+		const CK2::MappedFile file(provincePath);
+		scan(std::string_view(file.data(), file.size()));
+	}
 
 	const auto path = trimPath(provincePath);
 	try
@@ -23,12 +44,28 @@ mappers::ProvinceTitleGrabber::ProvinceTitleGrabber(const std::string& provinceP
 	}
 }
 
-void mappers::ProvinceTitleGrabber::registerKeys()
+mappers::ProvinceTitleGrabber::ProvinceTitleGrabber(std::istream& theStream)
+{
+	scan(parsing::readStream(theStream));
+}
+
+void mappers::ProvinceTitleGrabber::scan(std::string_view contents)
 {
-	registerKeyword("title", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::singleString titleStr(theStream);
-		title = titleStr.getString();
-	});
+	if (contents.starts_with("\xEF\xBB\xBF"))
+		contents.remove_prefix(3);
 
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
-}
\ No newline at end of file
+	using TokenType = parsing::Tokenizer::TokenType;
+	parsing::Tokenizer tokens(contents);
+	for (auto token = tokens.next(); token.type != TokenType::END; token = tokens.next())
+	{
+		if (token.type != TokenType::WORD && token.type != TokenType::QUOTED)
+			continue;
+		if (token.text == "title")
+			title = tokens.getString();
+		else if (isDate(token.text) && !title.empty())
+			// Settings head the file, so no title can follow once history has begun.
+			return;
+		else
+			tokens.skipItem();
+	}
+}
@@ -1,24 +1,29 @@
 #ifndef PROVINCE_TITLE_GRABBER
 #define PROVINCE_TITLE_GRABBER
 
-#include "Parser.h"
+#include <istream>
+#include <string>
+#include <string_view>
 
 namespace mappers
 {
-class ProvinceTitleGrabber: commonItems::parser
+// Reads the title of a history/provinces file, its ID coming from the filename. Only the settings heading the file
+// are read: once the title is known, the first dated entry ends the scan, and the history below it is never looked at.
+class ProvinceTitleGrabber
 {
   public:
 	explicit ProvinceTitleGrabber(const std::string& provincePath);
+	explicit ProvinceTitleGrabber(std::istream& theStream); // testing
 
 	[[nodiscard]] auto getID() const { return provID; }
 	[[nodiscard]] const auto& getTitle() const { return title; }
 
   private:
-	void registerKeys();
+	void scan(std::string_view contents);
 
 	int provID = 0;
 	std::string title;
 };
 } // namespace mappers
 
-#endif // PROVINCE_TITLE_GRABBER
\ No newline at end of file
+#endif // PROVINCE_TITLE_GRABBER
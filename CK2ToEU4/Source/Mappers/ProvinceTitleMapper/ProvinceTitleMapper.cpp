@@ -4,56 +4,64 @@
 #include "CommonFunctions.h"
 #include "OSCompatibilityLayer.h"
 #include "ParserHelpers.h"
-#include "ProvinceTitleGrabber.h"
+#include "ProvinceHistoryCatalogue.h"
 #include <set>
 
 void mappers::ProvinceTitleMapper::loadProvinces(const std::string& CK2Path)
 {
 	// Goal of this mapper is to determine what c_title maps to what provinceID. It's not as trivial as it sounds.
 
-	auto provinceFilenames = commonItems::GetAllFilesInFolder(CK2Path + "/history/provinces");
-	if (provinceFilenames.empty())
+	const ProvinceHistoryCatalogue catalogue(CK2Path + "/history/provinces");
+	if (!catalogue.getFileCount())
 		throw std::runtime_error(CK2Path + "/history/provinces is empty?");
-	for (const auto& provinceFilename: provinceFilenames)
+	for (const auto& [id, title]: catalogue.getEntries())
 	{
-		if (provinceFilename.find(".txt") == std::string::npos)
-			continue;
-		auto newProvince = ProvinceTitleGrabber(CK2Path + "/history/provinces/" + provinceFilename);
-		if (!newProvince.getID())
-			continue;
-
 		// At this stage, single provinceID can point to multiple c_titles, as well as a single
 		// c_title can point to multiple provinceIDs. We must filter this before we can use it!
-		origProvinceTitles.insert(std::make_pair(newProvince.getID(), newProvince.getTitle()));
+		origProvinceTitles.emplace(id, title);
 	}
 	Log(LogLevel::Info) << ">> Loaded: " << origProvinceTitles.size() << " provinces from history.";
 }
 
 void mappers::ProvinceTitleMapper::updateProvinces(const std::string& path)
 {
-	for (const auto& provinceFilename: commonItems::GetAllFilesInFolder(path + "/history/provinces"))
+	// A mod's province replaces every mapping of its ID and every mapping of its title. Both are looked up by key,
+	// which needs the IDs each title is mapped from.
+	std::map<std::string, std::set<int>> idsByTitle;
+	for (const auto& [id, title]: origProvinceTitles)
+		idsByTitle[title].insert(id);
+
+	const ProvinceHistoryCatalogue catalogue(path + "/history/provinces");
+	for (const auto& [newID, newTitle]: catalogue.getEntries())
 	{
-		if (getExtension(provinceFilename) != "txt")
-			continue;
-		auto newProvince = ProvinceTitleGrabber(path + "/history/provinces/" + provinceFilename);
-		if (!newProvince.getID() || newProvince.getTitle().empty())
+		if (newTitle.empty())
 			continue;
 
-		std::multimap<int, std::string> replacementTitles;
-		for (const auto& [id, title]: origProvinceTitles)
-			if (id != newProvince.getID() && title != newProvince.getTitle())
-				replacementTitles.insert(std::pair(id, title));
-		replacementTitles.insert(std::make_pair(newProvince.getID(), newProvince.getTitle()));
-		origProvinceTitles = std::move(replacementTitles);
+		const auto [idBegin, idEnd] = origProvinceTitles.equal_range(newID);
+		for (auto mapping = idBegin; mapping != idEnd; ++mapping)
+			idsByTitle[mapping->second].erase(newID);
+		origProvinceTitles.erase(idBegin, idEnd);
+		if (const auto titleIDs = idsByTitle.find(newTitle); titleIDs != idsByTitle.end())
+		{
+			for (const auto id: titleIDs->second)
+			{
+				auto [mapping, end] = origProvinceTitles.equal_range(id);
+				while (mapping != end)
+					mapping = mapping->second == newTitle ? origProvinceTitles.erase(mapping) : std::next(mapping);
+			}
+			idsByTitle.erase(titleIDs);
+		}
+
+		origProvinceTitles.emplace(newID, newTitle);
+		idsByTitle[newTitle].insert(newID);
 	}
 	Log(LogLevel::Info) << ">> Loaded: " << origProvinceTitles.size() << " provinces from history.";
 }
 
 std::optional<int> mappers::ProvinceTitleMapper::getIDForTitle(const std::string& title) const
 {
-	for (const auto& province: provinceTitles)
-		if (province.second == title)
-			return province.first;
+	if (const auto provinceID = titleProvinceIDs.find(title); provinceID != titleProvinceIDs.end())
+		return provinceID->second;
 	return std::nullopt;
 }
 
@@ -68,33 +76,24 @@ std::optional<std::string> mappers::ProvinceTitleMapper::getTitleForID(int provI
 void mappers::ProvinceTitleMapper::filterSelf(const CK2::Provinces& theProvinces, const CK2::Titles& theTitles)
 {
 	// This function's purpose is to filter out invalid provinceID-title mappings from /history/provinces.
+	// The first mapping of each ID and of each title wins; the two filtered maps double as the record of what's taken.
 
-	std::set<int> knownProvinceIDs;
-	std::set<std::string> knownTitles;
-
-	for (const auto& province: theProvinces.getProvinces())
-	{
-		knownProvinceIDs.insert(province.first);
-	}
-	for (const auto& title: theTitles.getTitles())
-	{
-		knownTitles.insert(title.first);
-	}
+	const auto& knownProvinces = theProvinces.getProvinces();
+	const auto& knownTitles = theTitles.getTitles();
 
 	std::map<int, std::string> newProvinceTitles;
-	std::set<int> newProvinceIDs;
-	std::set<std::string> newTitles;
+	std::unordered_map<std::string, int> newTitleProvinceIDs;
+	newTitleProvinceIDs.reserve(origProvinceTitles.size());
 
-	for (const auto& provinceTitle: origProvinceTitles)
+	for (const auto& [provinceID, title]: origProvinceTitles)
 	{
-		if (knownTitles.contains(provinceTitle.second) && knownProvinceIDs.contains(provinceTitle.first) && !newProvinceIDs.contains(provinceTitle.first) &&
-			 !newTitles.contains(provinceTitle.second))
-		{
-			newProvinceTitles.insert(std::pair(provinceTitle.first, provinceTitle.second));
-			newProvinceIDs.insert(provinceTitle.first);
-			newTitles.insert(provinceTitle.second);
-		}
+		if (!knownTitles.contains(title) || !knownProvinces.contains(provinceID) || newProvinceTitles.contains(provinceID) ||
+			 newTitleProvinceIDs.contains(title))
+			continue;
+		newProvinceTitles.emplace_hint(newProvinceTitles.end(), provinceID, title);
+		newTitleProvinceIDs.emplace(title, provinceID);
 	}
 	Log(LogLevel::Info) << "<> Dropped " << origProvinceTitles.size() - newProvinceTitles.size() << " invalid mappings.";
 	provinceTitles.swap(newProvinceTitles);
+	titleProvinceIDs.swap(newTitleProvinceIDs);
 }
@@ -2,6 +2,7 @@
 #define PROVINCE_TITLE_MAPPER
 
 #include "Parser.h"
+#include <unordered_map>
 
 namespace CK2
 {
@@ -28,6 +29,7 @@ class ProvinceTitleMapper
   private:
 	std::multimap<int, std::string> origProvinceTitles; // c_title can have multiple IDs, and IDs can have multiple c_titles, thanx paradox.
 	std::map<int, std::string> provinceTitles;			 // filtered list.
+	std::unordered_map<std::string, int> titleProvinceIDs; // the filtered list the other way round.
 };
 } // namespace mappers
 
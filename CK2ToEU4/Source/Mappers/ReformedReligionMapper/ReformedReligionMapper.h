@@ -12,7 +12,7 @@ class ReformedReligionMapper: commonItems::parser
 	void initReformedReligionMapper(std::istream& theStream);
 	void initReformedReligionMapper(const std::string& path);
 
-	std::map<std::string, ReformedReligionMapping> getReligionEntries() { return religionEntries; };
+	[[nodiscard]] const auto& getReligionEntries() const { return religionEntries; }
 
   private:
 	void registerKeys();
@@ -46,23 +46,23 @@ void mappers::ReformedReligionMapping::registerKeys()
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-void mappers::ReformedReligionMapping::addCountryModifiers(std::string mod)
+void mappers::ReformedReligionMapping::addCountryModifiers(const std::string& mod)
 {
 	if (countryModifiers.find(mod) == std::string::npos && mod.length()) // Prevents duplicates
-		countryModifiers = countryModifiers + "\n" + mod;
+		countryModifiers += "\n" + mod;
 }
-void mappers::ReformedReligionMapping::addProvinceModifiers(std::string mod)
+void mappers::ReformedReligionMapping::addProvinceModifiers(const std::string& mod)
 {
 	if (provinceModifiers.find(mod) == std::string::npos && mod.length()) // Prevents duplicates
-		provinceModifiers = provinceModifiers + "\n" + mod;
+		provinceModifiers += "\n" + mod;
 }
-void mappers::ReformedReligionMapping::addSecondary(std::string mod)
+void mappers::ReformedReligionMapping::addSecondary(const std::string& mod)
 {
 	if (secondary.find(mod) == std::string::npos && mod.length()) // Prevents duplicates
-		secondary = secondary + "\n" + mod;
+		secondary += "\n" + mod;
 }
-void mappers::ReformedReligionMapping::addNonUniqueMechanics(std::string mod)
+void mappers::ReformedReligionMapping::addNonUniqueMechanics(const std::string& mod)
 {
 	if (nonUniqueMechanics.find(mod) == std::string::npos && mod.length()) // Prevents duplicates
-		nonUniqueMechanics = nonUniqueMechanics + "\n" + mod;
+		nonUniqueMechanics += "\n" + mod;
 }
\ No newline at end of file
@@ -14,30 +14,30 @@ class ReformedReligionMapping: commonItems::parser
 	ReformedReligionMapping() = default;
 	ReformedReligionMapping(std::istream& theStream);
 
-	[[nodiscard]] const auto& getName() { return name; }
-	void setName(std::string mod) { name = mod; }
-	[[nodiscard]] short getIconNumber() { return iconNumber; }
+	[[nodiscard]] const auto& getName() const { return name; }
+	void setName(std::string mod) { name = std::move(mod); }
+	[[nodiscard]] short getIconNumber() const { return iconNumber; }
 	void setIconNumber(int mod) { iconNumber = mod; }
-	[[nodiscard]] std::optional<commonItems::Color> getColor() { return color; }
-	void setColor(std::optional<commonItems::Color> mod) { color = mod; }
-
-	[[nodiscard]] const auto& getCountryModifiers() { return countryModifiers; }
-	void setCountryModifiers(std::string mod) { countryModifiers = mod; }
-	void addCountryModifiers(std::string mod);
-	[[nodiscard]] const auto& getProvinceModifiers() { return provinceModifiers; }
-	void setProvinceModifiers(std::string mod) { provinceModifiers = mod; }
-	void addProvinceModifiers(std::string mod);
-	[[nodiscard]] const auto& getSecondary() { return secondary; }
-	void setSecondary(std::string mod) { secondary = mod; }
-	void addSecondary(std::string mod);
-	[[nodiscard]] const auto& getUniqueMechanics() { return uniqueMechanics; }
-	void setUniqueMechanics(std::string mod) { uniqueMechanics = mod; }
-	[[nodiscard]] const auto& getNonUniqueMechanics() { return nonUniqueMechanics; }
-	void setNonUniqueMechanics(std::string mod) { nonUniqueMechanics = mod; }
-	void addNonUniqueMechanics(std::string mod);
-
-	[[nodiscard]] const auto& getHereticStrings() { return hereticStrings; }
-	void setHereticStrings(std::string mod) { hereticStrings = mod; }
+	[[nodiscard]] const auto& getColor() const { return color; }
+	void setColor(std::optional<commonItems::Color> mod) { color = std::move(mod); }
+
+	[[nodiscard]] const auto& getCountryModifiers() const { return countryModifiers; }
+	void setCountryModifiers(std::string mod) { countryModifiers = std::move(mod); }
+	void addCountryModifiers(const std::string& mod);
+	[[nodiscard]] const auto& getProvinceModifiers() const { return provinceModifiers; }
+	void setProvinceModifiers(std::string mod) { provinceModifiers = std::move(mod); }
+	void addProvinceModifiers(const std::string& mod);
+	[[nodiscard]] const auto& getSecondary() const { return secondary; }
+	void setSecondary(std::string mod) { secondary = std::move(mod); }
+	void addSecondary(const std::string& mod);
+	[[nodiscard]] const auto& getUniqueMechanics() const { return uniqueMechanics; }
+	void setUniqueMechanics(std::string mod) { uniqueMechanics = std::move(mod); }
+	[[nodiscard]] const auto& getNonUniqueMechanics() const { return nonUniqueMechanics; }
+	void setNonUniqueMechanics(std::string mod) { nonUniqueMechanics = std::move(mod); }
+	void addNonUniqueMechanics(const std::string& mod);
+
+	[[nodiscard]] const auto& getHereticStrings() const { return hereticStrings; }
+	void setHereticStrings(std::string mod) { hereticStrings = std::move(mod); }
 
   private:
 	void registerKeys();
@@ -1,20 +1,31 @@
 #include "Area.h"
-#include "ParserHelpers.h"
+#include "../../Parsing/TokenTable.h"
 
 mappers::Area::Area(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	const auto contents = parsing::readStream(theStream);
+	parsing::Tokenizer tokens(contents);
+	static const auto tokenTable = registerKeys();
+	tokenTable.parse(*this, tokens);
 }
 
-void mappers::Area::registerKeys()
+mappers::Area::Area(parsing::Tokenizer& tokens)
 {
-	registerKeyword("color", commonItems::ignoreItem);
-	registerRegex("[0-9]+", [this](const std::string& number, std::istream& theStream) {
+	static const auto tokenTable = registerKeys();
+	tokenTable.parse(*this, tokens);
+}
+
+parsing::TokenTable<mappers::Area> mappers::Area::registerKeys()
+{
+	parsing::TokenTable<Area> tokenTable;
+	tokenTable.registerKeyword("color", [](Area& theArea, std::string_view unused, parsing::Tokenizer& tokens) {
+		tokens.skipItem();
+	});
+	tokenTable.registerMatcher(parsing::TokenMatcher::digits(), [](Area& theArea, const std::string_view number, parsing::Tokenizer& tokens) {
 		// This is a peculiar file format where we pull free-floating numbers from thin air
-		provinces.insert(std::pair(std::stoi(number), nullptr));
+		theArea.provinces.insert(std::pair(std::stoi(std::string(number)), nullptr));
 	});
+	return tokenTable;
 }
 
 
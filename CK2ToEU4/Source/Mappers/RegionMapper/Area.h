@@ -1,7 +1,7 @@
 #ifndef EU4_AREA_H
 #define EU4_AREA_H
 
-#include "Parser.h"
+#include <istream>
 #include <map>
 #include <memory>
 
@@ -9,12 +9,18 @@ namespace EU4
 {
 class Province;
 }
+namespace parsing
+{
+class Tokenizer;
+template <typename Entity> class TokenTable;
+}
 namespace mappers
 {
-class Area: commonItems::parser
+class Area
 {
   public:
 	explicit Area(std::istream& theStream);
+	explicit Area(parsing::Tokenizer& tokens);
 
 	[[nodiscard]] const auto& getProvinces() const { return provinces; }
 	[[nodiscard]] bool areaContainsProvince(int province) const;
@@ -22,7 +28,7 @@ class Area: commonItems::parser
 	void linkProvince(const std::pair<int, std::shared_ptr<EU4::Province>>& theProvince) { provinces[theProvince.first] = theProvince.second; }
 
   private:
-	void registerKeys();
+	static parsing::TokenTable<Area> registerKeys();
 	std::map<int, std::shared_ptr<EU4::Province>> provinces;
 };
 } // namespace mappers
@@ -1,23 +1,30 @@
 #include "Region.h"
+#include "../../Parsing/TokenTable.h"
 #include "Area.h"
-#include "CommonRegexes.h"
-#include "ParserHelpers.h"
 
 mappers::Region::Region(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	const auto contents = parsing::readStream(theStream);
+	parsing::Tokenizer tokens(contents);
+	static const auto tokenTable = registerKeys();
+	tokenTable.parse(*this, tokens);
 }
 
-void mappers::Region::registerKeys()
+mappers::Region::Region(parsing::Tokenizer& tokens)
 {
-	registerKeyword("areas", [this](const std::string& unused, std::istream& theStream) {
-		const commonItems::stringList names(theStream);
-		for (const auto& name: names.getStrings())
-			areas.insert(std::pair(name, nullptr));
+	static const auto tokenTable = registerKeys();
+	tokenTable.parse(*this, tokens);
+}
+
+parsing::TokenTable<mappers::Region> mappers::Region::registerKeys()
+{
+	parsing::TokenTable<Region> tokenTable;
+	tokenTable.registerKeyword("areas", [](Region& theRegion, std::string_view unused, parsing::Tokenizer& tokens) {
+		for (const auto& name: tokens.getStrings())
+			theRegion.areas.insert(std::pair(std::string(name), nullptr));
 	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	tokenTable.ignoreUnregistered();
+	return tokenTable;
 }
 
 bool mappers::Region::regionContainsProvince(int province) const
@@ -1,15 +1,24 @@
 #ifndef EU4_REGION_H
 #define EU4_REGION_H
 
-#include "Parser.h"
+#include <istream>
+#include <map>
+#include <memory>
+#include <string>
 
+namespace parsing
+{
+class Tokenizer;
+template <typename Entity> class TokenTable;
+}
 namespace mappers
 {
 class Area;
-class Region: commonItems::parser
+class Region
 {
   public:
 	explicit Region(std::istream& theStream);
+	explicit Region(parsing::Tokenizer& tokens);
 
 	[[nodiscard]] const auto& getAreas() const { return areas; }
 	[[nodiscard]] bool regionContainsProvince(int province) const;
@@ -17,7 +26,7 @@ class Region: commonItems::parser
 	void linkArea(const std::pair<std::string, std::shared_ptr<Area>>& theArea) { areas[theArea.first] = theArea.second; }
 
   private:
-	void registerKeys();
+	static parsing::TokenTable<Region> registerKeys();
 	std::map<std::string, std::shared_ptr<Area>> areas;
 };
 } // namespace mappers
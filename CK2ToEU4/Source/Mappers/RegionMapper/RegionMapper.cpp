@@ -1,167 +1,142 @@
 #include "RegionMapper.h"
 #include "../../Configuration/Configuration.h"
+#include "../../EU4World/Province/ProvinceTable.h"
+#include "../../Parsing/TokenTable.h"
+#include "../LookupRecorder/LookupRecorder.h"
 #include "Log.h"
-#include "OSCompatibilityLayer.h"
-#include "ParserHelpers.h"
-#include <filesystem>
-namespace fs = std::filesystem;
-#include <fstream>
 
 void mappers::RegionMapper::loadRegions(const Configuration& theConfiguration)
 {
 	Log(LogLevel::Info) << "-> Initializing Geography";
-	auto areaFilename = theConfiguration.getEU4Path() + "/map/area.txt";
-	auto regionFilename = theConfiguration.getEU4Path() + "/map/region.txt";
-	auto superRegionFilename = theConfiguration.getEU4Path() + "/map/superregion.txt";
-
-	std::ifstream areaStream(fs::u8path(areaFilename));
-	if (!areaStream.is_open())
+	const auto areaFile = parsing::readFile(theConfiguration.getEU4Path() + "/map/area.txt");
+	if (!areaFile)
 		throw std::runtime_error("Could not open map/area.txt!");
-	registerAreaKeys();
-	parseStream(areaStream);
-	clearRegisteredKeywords();
-	areaStream.close();
-
-	std::ifstream superRegionStream(fs::u8path(superRegionFilename));
-	if (!superRegionStream.is_open())
+	const auto superRegionFile = parsing::readFile(theConfiguration.getEU4Path() + "/map/superregion.txt");
+	if (!superRegionFile)
 		throw std::runtime_error("Could not open map/superregion.txt!");
-	registerSuperRegionKeys();
-	parseStream(superRegionStream);
-	clearRegisteredKeywords();
-	superRegionStream.close();
-
-	std::ifstream regionStream(fs::u8path(regionFilename));
-	if (!regionStream.is_open())
+	const auto regionFile = parsing::readFile(theConfiguration.getEU4Path() + "/map/region.txt");
+	if (!regionFile)
 		throw std::runtime_error("Could not open map/region.txt!");
-	registerRegionKeys();
-	parseStream(regionStream);
-	clearRegisteredKeywords();
-	regionStream.close();
 
-	linkSuperRegions();
-	linkRegions();
+	parseRegions(*areaFile, *regionFile, *superRegionFile);
 }
 
 void mappers::RegionMapper::loadRegions(std::istream& areaStream, std::istream& regionStream, std::istream& superRegionStream)
 {
-	registerAreaKeys();
-	parseStream(areaStream);
-	clearRegisteredKeywords();
+	parseRegions(parsing::readStream(areaStream), parsing::readStream(regionStream), parsing::readStream(superRegionStream));
+}
 
-	registerSuperRegionKeys();
-	parseStream(superRegionStream);
-	clearRegisteredKeywords();
+void mappers::RegionMapper::parseRegions(const std::string_view areaText, const std::string_view regionText, const std::string_view superRegionText)
+{
+	static const auto areaTable = registerAreaKeys();
+	static const auto superRegionTable = registerSuperRegionKeys();
+	static const auto regionTable = registerRegionKeys();
 
-	registerRegionKeys();
-	parseStream(regionStream);
-	clearRegisteredKeywords();
+	parsing::Tokenizer areaTokens(areaText);
+	areaTable.parse(*this, areaTokens);
+	parsing::Tokenizer superRegionTokens(superRegionText);
+	superRegionTable.parse(*this, superRegionTokens);
+	parsing::Tokenizer regionTokens(regionText);
+	regionTable.parse(*this, regionTokens);
 
 	linkSuperRegions();
 	linkRegions();
+	indexProvinces();
 }
 
-void mappers::RegionMapper::registerAreaKeys()
+parsing::TokenTable<mappers::RegionMapper> mappers::RegionMapper::registerAreaKeys()
 {
-	registerRegex("[\\w_]+", [this](const std::string& areaName, std::istream& theStream) {
-		auto newArea = std::make_shared<Area>(theStream);
-		areas.insert(std::make_pair(areaName, newArea));
+	parsing::TokenTable<RegionMapper> tokenTable;
+	tokenTable.registerMatcher(parsing::TokenMatcher::characters(parsing::TokenMatcher::identifierCharacters), [](RegionMapper& theMapper, const std::string_view areaName, parsing::Tokenizer& tokens) {
+		auto newArea = std::make_shared<Area>(tokens);
+		theMapper.areas.insert(std::make_pair(std::string(areaName), newArea));
 	});
+	return tokenTable;
 }
 
-void mappers::RegionMapper::registerSuperRegionKeys()
+parsing::TokenTable<mappers::RegionMapper> mappers::RegionMapper::registerSuperRegionKeys()
 {
-	registerRegex("[\\w_]+", [this](const std::string& sregionName, std::istream& theStream) {
-		const commonItems::stringList theList(theStream);
+	parsing::TokenTable<RegionMapper> tokenTable;
+	tokenTable.registerMatcher(parsing::TokenMatcher::characters(parsing::TokenMatcher::identifierCharacters), [](RegionMapper& theMapper, const std::string_view sregionName, parsing::Tokenizer& tokens) {
 		std::vector<std::string> regions;
-		for (const auto& region: theList.getStrings())
+		for (const auto& region: tokens.getStrings())
 		{
 			if (region == "restrict_charter")
 				continue;
 			regions.emplace_back(region);
 		}
 		auto newSRegion = std::make_shared<SuperRegion>(regions);
-		superRegions.insert(std::make_pair(sregionName, newSRegion));
+		theMapper.superRegions.insert(std::make_pair(std::string(sregionName), newSRegion));
 	});
+	return tokenTable;
 }
 
-void mappers::RegionMapper::registerRegionKeys()
+parsing::TokenTable<mappers::RegionMapper> mappers::RegionMapper::registerRegionKeys()
 {
-	registerRegex("[\\w_]+", [this](const std::string& regionName, std::istream& theStream) {
-		auto newRegion = std::make_shared<Region>(theStream);
-		regions.insert(std::pair(regionName, newRegion));
+	parsing::TokenTable<RegionMapper> tokenTable;
+	tokenTable.registerMatcher(parsing::TokenMatcher::characters(parsing::TokenMatcher::identifierCharacters), [](RegionMapper& theMapper, const std::string_view regionName, parsing::Tokenizer& tokens) {
+		auto newRegion = std::make_shared<Region>(tokens);
+		theMapper.regions.insert(std::pair(std::string(regionName), newRegion));
 	});
+	return tokenTable;
 }
 
 
 bool mappers::RegionMapper::provinceIsInRegion(int province, const std::string& regionName) const
 {
-	const auto& regionItr = regions.find(regionName);
-	if (regionItr != regions.end())
-		return regionItr->second->regionContainsProvince(province);
-
-	// "Regions" are such a fluid term.
-	const auto& superRegionItr = superRegions.find(regionName);
-	if (superRegionItr != superRegions.end())
-		return superRegionItr->second->superRegionContainsProvince(province);
-
-	// And sometimes they don't mean what people think they mean at all.
-	const auto& areaItr = areas.find(regionName);
-	if (areaItr != areas.end())
-		return areaItr->second->areaContainsProvince(province);
-
-	return false;
+	const auto& regionItr = regionProvinces.find(regionName);
+	const auto inRegion = regionItr != regionProvinces.end() && province >= 0 && static_cast<std::size_t>(province) < regionItr->second.size() &&
+								 regionItr->second[province];
+	if (LookupRecorder::recording())
+		LookupRecorder::record(LookupRecorder::CALL::REGION, {static_cast<long long>(province), regionName}, {static_cast<long long>(inRegion)});
+	return inRegion;
 }
 
 std::optional<std::string> mappers::RegionMapper::getParentAreaName(const int provinceID) const
 {
-	for (const auto& area: areas)
-	{
-		if (area.second->areaContainsProvince(provinceID))
-			return area.first;
-	}
+	if (const auto& parentsItr = provinceParents.find(provinceID); parentsItr != provinceParents.end() && !parentsItr->second.area.empty())
+		return parentsItr->second.area;
 	Log(LogLevel::Warning) << "Province ID " << provinceID << " has no parent area name!";
 	return std::nullopt;
 }
 
+std::optional<std::size_t> mappers::RegionMapper::getParentAreaID(const int provinceID) const
+{
+	if (const auto& parentsItr = provinceParents.find(provinceID); parentsItr != provinceParents.end())
+		return parentsItr->second.areaID;
+	return std::nullopt;
+}
+
 std::optional<std::string> mappers::RegionMapper::getParentRegionName(const int provinceID) const
 {
-	for (const auto& region: regions)
-	{
-		if (region.second->regionContainsProvince(provinceID))
-			return region.first;
-	}
+	if (const auto& parentsItr = provinceParents.find(provinceID); parentsItr != provinceParents.end() && !parentsItr->second.region.empty())
+		return parentsItr->second.region;
 	Log(LogLevel::Warning) << "Province ID " << provinceID << " has no parent region name!";
 	return std::nullopt;
 }
 
 std::optional<std::string> mappers::RegionMapper::getParentSuperRegionName(const int provinceID) const
 {
-	for (const auto& superRegion: superRegions)
-	{
-		if (superRegion.second->superRegionContainsProvince(provinceID))
-			return superRegion.first;
-	}
+	if (const auto& parentsItr = provinceParents.find(provinceID); parentsItr != provinceParents.end() && !parentsItr->second.superRegion.empty())
+		return parentsItr->second.superRegion;
 	Log(LogLevel::Warning) << "Province ID " << provinceID << " has no parent superregion name!";
 	return std::nullopt;
 }
 
-bool mappers::RegionMapper::regionNameIsValid(const std::string& regionName) const
+std::set<int> mappers::RegionMapper::getProvincesInRegion(const std::string& regionName) const
 {
-	const auto& regionItr = regions.find(regionName);
-	if (regionItr != regions.end())
-		return true;
-
-	// Who knows what the mapper needs. All kinds of stuff.
-	const auto& superRegionItr = superRegions.find(regionName);
-	if (superRegionItr != superRegions.end())
-		return true;
-
-	// And more stuff, what's the worst that could happen?
-	const auto& areaItr = areas.find(regionName);
-	if (areaItr != areas.end())
-		return true;
+	std::set<int> provinces;
+	if (const auto& regionItr = regionProvinces.find(regionName); regionItr != regionProvinces.end())
+		for (std::size_t province = 0; province < regionItr->second.size(); ++province)
+			if (regionItr->second[province])
+				provinces.insert(static_cast<int>(province));
+	return provinces;
+}
 
-	return false;
+bool mappers::RegionMapper::regionNameIsValid(const std::string& regionName) const
+{
+	// Regions, superregions, areas, who knows what the mapper needs. All kinds of stuff.
+	return regionProvinces.contains(regionName);
 }
 
 void mappers::RegionMapper::linkSuperRegions()
@@ -204,22 +179,65 @@ void mappers::RegionMapper::linkRegions()
 	}
 }
 
-void mappers::RegionMapper::linkProvinces(const std::map<int, std::shared_ptr<EU4::Province>>& theProvinces)
+void mappers::RegionMapper::indexProvinces()
 {
-	for (const auto& area: areas)
-	{
-		const auto& rprovinces = area.second->getProvinces();
-		for (const auto& requiredProvince: rprovinces)
+	provinceParents.clear();
+	regionProvinces.clear();
+
+	const auto listProvinces = [](const Area& area, std::vector<bool>& members) {
+		for (const auto& province: area.getProvinces())
 		{
-			const auto& provinceItr = theProvinces.find(requiredProvince.first);
-			if (provinceItr != theProvinces.end())
-			{
-				area.second->linkProvince(std::pair(provinceItr->first, provinceItr->second));
-			}
-			else
-			{
-				throw std::runtime_error("Area's " + area.first + " area " + std::to_string(requiredProvince.first) + " does not exist!");
-			}
+			if (province.first < 0)
+				continue;
+			if (members.size() <= static_cast<std::size_t>(province.first))
+				members.resize(static_cast<std::size_t>(province.first) + 1, false);
+			members[province.first] = true;
 		}
+	};
+	const auto listRegionProvinces = [&listProvinces](const Region& region, std::vector<bool>& members) {
+		for (const auto& area: region.getAreas())
+			listProvinces(*area.second, members);
+	};
+	const auto adopt = [this](const std::vector<bool>& members, const std::string& parentName, std::string ProvinceParents::*parent) {
+		for (std::size_t province = 0; province < members.size(); ++province)
+			if (members[province] && (provinceParents[static_cast<int>(province)].*parent).empty())
+				provinceParents[static_cast<int>(province)].*parent = parentName;
+	};
+
+	// Lowest precedence first, so a region overwrites a like-named superregion or area.
+	std::size_t areaID = 0;
+	for (const auto& area: areas)
+	{
+		std::vector<bool> members;
+		listProvinces(*area.second, members);
+		adopt(members, area.first, &ProvinceParents::area);
+		for (std::size_t province = 0; province < members.size(); ++province)
+			if (members[province] && provinceParents[static_cast<int>(province)].area == area.first)
+				provinceParents[static_cast<int>(province)].areaID = areaID;
+		++areaID;
+		regionProvinces.insert_or_assign(area.first, std::move(members));
 	}
+	for (const auto& superRegion: superRegions)
+	{
+		std::vector<bool> members;
+		for (const auto& region: superRegion.second->getRegions())
+			listRegionProvinces(*region.second, members);
+		adopt(members, superRegion.first, &ProvinceParents::superRegion);
+		regionProvinces.insert_or_assign(superRegion.first, std::move(members));
+	}
+	for (const auto& region: regions)
+	{
+		std::vector<bool> members;
+		listRegionProvinces(*region.second, members);
+		adopt(members, region.first, &ProvinceParents::region);
+		regionProvinces.insert_or_assign(region.first, std::move(members));
+	}
+}
+
+void mappers::RegionMapper::verifyProvinces(const EU4::ProvinceTable& theProvinces) const
+{
+	for (const auto& area: areas)
+		for (const auto& requiredProvince: area.second->getProvinces())
+			if (theProvinces.find(requiredProvince.first) == theProvinces.end())
+				throw std::runtime_error("Area's " + area.first + " area " + std::to_string(requiredProvince.first) + " does not exist!");
 }
@@ -2,15 +2,27 @@
 #define EU4_REGIONS_H
 
 #include "Area.h"
-#include "Parser.h"
 #include "Region.h"
 #include "SuperRegion.h"
 #include <map>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 class Configuration;
+namespace EU4
+{
+class ProvinceTable;
+}
+namespace parsing
+{
+template <typename Entity> class TokenTable;
+}
 namespace mappers
 {
-class RegionMapper: commonItems::parser
+class RegionMapper
 {
   public:
 	RegionMapper() = default;
@@ -25,23 +37,44 @@ class RegionMapper: commonItems::parser
 
 	[[nodiscard]] bool provinceIsInRegion(int province, const std::string& regionName) const;
 	[[nodiscard]] bool regionNameIsValid(const std::string& regionName) const;
+	[[nodiscard]] std::set<int> getProvincesInRegion(const std::string& regionName) const; // same lookup as provinceIsInRegion
 
 	[[nodiscard]] std::optional<std::string> getParentAreaName(int provinceID) const;
 	[[nodiscard]] std::optional<std::string> getParentRegionName(int provinceID) const;
 	[[nodiscard]] std::optional<std::string> getParentSuperRegionName(int provinceID) const;
+	// Areas numbered 0 to getAreaCount() - 1 in name order, for passes that count provinces by area. Unlike the names
+	// above, a province outside every area is not worth a warning here.
+	[[nodiscard]] std::optional<std::size_t> getParentAreaID(int provinceID) const;
+	[[nodiscard]] auto getAreaCount() const { return areas.size(); }
 
-	void linkProvinces(const std::map<int, std::shared_ptr<EU4::Province>>& theProvinces);
+	// Throws if an area names a province that doesn't exist. Nothing is linked: one mapper serves many conversions.
+	void verifyProvinces(const EU4::ProvinceTable& theProvinces) const;
 
   private:
-	void registerAreaKeys();
-	void registerSuperRegionKeys();
-	void registerRegionKeys();
+	void parseRegions(std::string_view areaText, std::string_view regionText, std::string_view superRegionText);
+	static parsing::TokenTable<RegionMapper> registerAreaKeys();
+	static parsing::TokenTable<RegionMapper> registerSuperRegionKeys();
+	static parsing::TokenTable<RegionMapper> registerRegionKeys();
 	void linkSuperRegions();
 	void linkRegions();
+	void indexProvinces();
 
 	std::map<std::string, std::shared_ptr<Region>> regions;
 	std::map<std::string, std::shared_ptr<SuperRegion>> superRegions;
 	std::map<std::string, std::shared_ptr<Area>> areas;
+
+	// Built once the above are linked; the geography doesn't change afterwards.
+	struct ProvinceParents
+	{
+		std::string area;
+		std::string region;
+		std::string superRegion;
+		std::optional<std::size_t> areaID;
+	};
+	std::unordered_map<int, ProvinceParents> provinceParents; // first parent by name, if a file lists a province twice
+	// Every area, region and superregion name, with a province ID bitset. Where names collide a region wins over a
+	// superregion and a superregion over an area, same order provinceIsInRegion always looked in.
+	std::unordered_map<std::string, std::vector<bool>> regionProvinces;
 };
 } // namespace mappers
 
@@ -1,4 +1,5 @@
 #include "ReligionMapper.h"
+#include "../LookupRecorder/LookupRecorder.h"
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
@@ -32,16 +33,18 @@ void mappers::ReligionMapper::registerKeys()
 		const ReligionMapping theMapping(theStream);
 		for (const auto& ck2Religion: theMapping.getCK2Religions())
 		{
-			ck2ToEu4ReligionMap.insert(std::make_pair(ck2Religion, theMapping.getEU4Religion()));
+			ck2ToEu4ReligionMap.insert(std::make_pair(parsing::Symbol(ck2Religion), theMapping.getEU4Religion()));
 		}
 	});
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-std::optional<std::string> mappers::ReligionMapper::getEu4ReligionForCk2Religion(const std::string& ck2Religion) const
+std::optional<std::string> mappers::ReligionMapper::getEu4ReligionForCk2Religion(const parsing::Symbol& ck2Religion) const
 {
-	const auto& mapping = ck2ToEu4ReligionMap.find(ck2Religion);
-	if (mapping != ck2ToEu4ReligionMap.end())
-		return mapping->second;
-	return std::nullopt;
+	std::optional<std::string> eu4Religion;
+	if (const auto& mapping = ck2ToEu4ReligionMap.find(ck2Religion); mapping != ck2ToEu4ReligionMap.end())
+		eu4Religion = mapping->second;
+	if (LookupRecorder::recording())
+		LookupRecorder::record(LookupRecorder::CALL::RELIGION, {ck2Religion.str()}, {LookupRecorder::value(eu4Religion)});
+	return eu4Religion;
 }
\ No newline at end of file
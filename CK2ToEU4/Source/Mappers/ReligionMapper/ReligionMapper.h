@@ -1,10 +1,11 @@
 #ifndef RELIGION_MAPPER_H
 #define RELIGION_MAPPER_H
 
+#include "../../Parsing/Symbol.h"
 #include "Parser.h"
-#include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace mappers
 {
@@ -15,12 +16,12 @@ class ReligionMapper: commonItems::parser
 	void initReligionMapper(std::istream& theStream);
 	void initReligionMapper(const std::string& path);
 
-	[[nodiscard]] std::optional<std::string> getEu4ReligionForCk2Religion(const std::string& ck2Religion) const;
+	[[nodiscard]] std::optional<std::string> getEu4ReligionForCk2Religion(const parsing::Symbol& ck2Religion) const;
 
   private:
 	void registerKeys();
 
-	std::map<std::string, std::string> ck2ToEu4ReligionMap;
+	std::unordered_map<parsing::Symbol, std::string> ck2ToEu4ReligionMap;
 };
 } // namespace mappers
 
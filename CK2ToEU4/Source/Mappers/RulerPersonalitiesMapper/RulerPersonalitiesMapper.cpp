@@ -3,6 +3,7 @@
 #include "CommonRegexes.h"
 #include "Log.h"
 #include "ParserHelpers.h"
+#include <algorithm>
 
 void mappers::RulerPersonalitiesMapper::initRulerPersonalitiesMapper(const std::string& path)
 {
@@ -16,6 +17,7 @@ void mappers::RulerPersonalitiesMapper::initRulerPersonalitiesMapper(const std::
 	}
 	parseFile(dirPath + "/ruler_personalities.txt");
 	clearRegisteredKeywords();
+	indexTraits();
 	Log(LogLevel::Info) << "<> " << theMappings.size() << " personalities loaded.";
 }
 
@@ -24,6 +26,7 @@ void mappers::RulerPersonalitiesMapper::initRulerPersonalitiesMapper(std::istrea
 	registerKeys();
 	parseStream(theStream);
 	clearRegisteredKeywords();
+	indexTraits();
 }
 
 void mappers::RulerPersonalitiesMapper::registerKeys()
@@ -35,28 +38,51 @@ void mappers::RulerPersonalitiesMapper::registerKeys()
 	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
 }
 
-std::set<std::string> mappers::RulerPersonalitiesMapper::evaluatePersonalities(const std::pair<int, std::shared_ptr<CK2::Character>>& theCharacter) const
+void mappers::RulerPersonalitiesMapper::indexTraits()
 {
-	// In CK2 they are traits. In EU4 they are personalities.
-	const auto& incTraits = theCharacter.second->getTraits();
-	std::set<std::string> ck2Traits;
-	for (const auto& trait: incTraits)
-		ck2Traits.insert(trait.second);
-
-	std::vector<std::pair<int, std::string>> scoreBoard; // personalityscore, personality
-	std::set<std::string> toReturn;
-
-	for (const auto& mapping: theMappings)
+	personalities.clear();
+	traitWeights.clear();
+	for (const auto& [personality, mapping]: theMappings)
 	{
-		auto score = mapping.second.evaluatePersonality(ck2Traits);
-		scoreBoard.emplace_back(std::pair(score, mapping.first));
+		for (const auto& [trait, weight]: mapping.getTraits())
+			traitWeights[trait].emplace_back(personalities.size(), weight);
+		personalities.emplace_back(personality);
 	}
-	std::sort(scoreBoard.rbegin(), scoreBoard.rend());
+}
 
-	// send back first two. EU4 should deal with excess.
-	for (auto i = 0; i < std::min(2, static_cast<int>(theMappings.size())); i++)
+std::set<std::string> mappers::RulerPersonalitiesMapper::evaluatePersonalities(const std::pair<int, std::shared_ptr<CK2::Character>>& theCharacter) const
+{
+	// In CK2 they are traits. In EU4 they are personalities. Only the personalities our traits weigh into are touched,
+	// everyone else stays at 0.
+	std::vector<int> scores(personalities.size(), 0);
+	std::vector<const std::vector<std::pair<std::size_t, int>>*> counted; // a trait counts once, however often it's listed
+	theCharacter.second->getTraits().forEachName([this, &scores, &counted](const std::string_view trait) {
+		const auto weights = traitWeights.find(trait);
+		if (weights == traitWeights.end() || std::ranges::find(counted, &weights->second) != counted.end())
+			return;
+		counted.emplace_back(&weights->second);
+		for (const auto& [personality, weight]: weights->second)
+			scores[personality] += weight;
+	});
+
+	// Send back the top two, EU4 should deal with excess. Ties go to the personality sorting last, as they always have.
+	std::set<std::string> toReturn;
+	std::optional<std::size_t> first;
+	std::optional<std::size_t> second;
+	for (std::size_t personality = 0; personality < scores.size(); ++personality)
 	{
-		toReturn.insert(scoreBoard[i].second);
+		if (!first || scores[personality] >= scores[*first])
+		{
+			second = first;
+			first = personality;
+		}
+		else if (!second || scores[personality] >= scores[*second])
+		{
+			second = personality;
+		}
 	}
+	for (const auto& pick: {first, second})
+		if (pick)
+			toReturn.insert(personalities[*pick]);
 	return toReturn;
 }
@@ -3,6 +3,7 @@
 
 #include "Parser.h"
 #include "RulerPersonalitiesMapping.h"
+#include <map>
 #include <set>
 
 namespace CK2
@@ -24,8 +25,12 @@ class RulerPersonalitiesMapper: commonItems::parser
 
   private:
 	void registerKeys();
+	void indexTraits();
 
 	std::map<std::string, RulerPersonalitiesMapping> theMappings;
+	// Every ck2 trait with the personalities it weighs into, by their position in theMappings.
+	std::vector<std::string> personalities;
+	std::map<std::string, std::vector<std::pair<std::size_t, int>>, std::less<>> traitWeights;
 };
 } // namespace mappers
 
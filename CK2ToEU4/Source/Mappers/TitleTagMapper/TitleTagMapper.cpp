@@ -1,66 +1,33 @@
 #include "TitleTagMapper.h"
-#include "CommonRegexes.h"
-#include "Log.h"
-#include "ParserHelpers.h"
+#include "../LookupRecorder/LookupRecorder.h"
 #include <iomanip>
 
 void mappers::TitleTagMapper::initTitleTagMapper(const std::string& path)
 {
-	Log(LogLevel::Info) << "-> Parsing Tag mappings";
-	registerKeys();
-	std::string dirPath = "configurables";
-	if (!path.empty())
-	{
-		Log(LogLevel::Info) << "Tag Mapper override: " << path;
-		dirPath += "/" + path;
-	}
-	parseFile(dirPath + "/tag_mappings.txt");
-	clearRegisteredKeywords();
-
-	// not overriding chinese mappings as those are out of scope.
-	registerChineseKeys();
-	parseFile("configurables/chinese_tag_mappings.txt");
-	clearRegisteredKeywords();
-	Log(LogLevel::Info) << "<> " << theMappings.size() << " mappings and " << chineseMappings.size() << " Chinas loaded.";
+	rules = std::make_shared<const TitleTagRules>(path);
 }
 
 void mappers::TitleTagMapper::initTitleTagMapper(std::istream& theStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
+	rules = std::make_shared<const TitleTagRules>(theStream);
 }
 
 void mappers::TitleTagMapper::initTitleTagMapper(std::istream& theStream, std::istream& chineseStream)
 {
-	registerKeys();
-	parseStream(theStream);
-	clearRegisteredKeywords();
-	registerChineseKeys();
-	parseStream(chineseStream);
-	clearRegisteredKeywords();
-}
-
-void mappers::TitleTagMapper::registerKeys()
-{
-	registerKeyword("link", [this](const std::string& unused, std::istream& theStream) {
-		theMappings.emplace_back(TitleTagMapping(theStream));
-	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	rules = std::make_shared<const TitleTagRules>(theStream, chineseStream);
 }
 
-void mappers::TitleTagMapper::registerChineseKeys()
+void mappers::TitleTagMapper::registerTitle(const std::string& ck2title, const std::string& eu4tag)
 {
-	registerKeyword("link", [this](const std::string& unused, std::istream& theStream) {
-		chineseMappings.emplace_back(TitleTagMapping(theStream));
-	});
-	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+	if (LookupRecorder::recording())
+		LookupRecorder::record(LookupRecorder::CALL::TAG_REGISTRATION, {ck2title, eu4tag}, {});
+	claimTitle(ck2title, eu4tag);
 }
 
-void mappers::TitleTagMapper::registerTitle(const std::string& ck2title, const std::string& eu4tag)
+void mappers::TitleTagMapper::claimTitle(const std::string& ck2title, const std::string& eu4tag)
 {
 	registeredTitleTags.insert(std::pair(ck2title, eu4tag));
-	usedTags.insert(eu4tag);
+	usedTags.emplace(eu4tag);
 }
 
 std::optional<std::string> mappers::TitleTagMapper::getTagForTitle(const std::string& ck2Title)
@@ -74,6 +41,14 @@ std::optional<std::string> mappers::TitleTagMapper::getTagForTitle(const std::st
 }
 
 std::optional<std::string> mappers::TitleTagMapper::getTagForTitle(const std::string& ck2Title, const std::string& ck2BaseTitle, int eu4Capital)
+{
+	auto tag = resolveTagForTitle(ck2Title, ck2BaseTitle, eu4Capital);
+	if (LookupRecorder::recording())
+		LookupRecorder::record(LookupRecorder::CALL::TAG, {ck2Title, ck2BaseTitle, static_cast<long long>(eu4Capital)}, {LookupRecorder::value(tag)});
+	return tag;
+}
+
+std::optional<std::string> mappers::TitleTagMapper::resolveTagForTitle(const std::string& ck2Title, const std::string& ck2BaseTitle, int eu4Capital)
 {
 	// the only case where we fail is on invalid invocation. Otherwise, failure is
 	// not an option!
@@ -83,29 +58,29 @@ std::optional<std::string> mappers::TitleTagMapper::getTagForTitle(const std::st
 	// The popes don't use proper titles and aren't registered.
 	if (ck2Title == "The Pope")
 	{
-		if (!usedTags.count("PAP"))
+		if (!usedTags.count(EU4::Tag("PAP")))
 		{
-			usedTags.insert("PAP");
+			usedTags.emplace("PAP");
 			return "PAP";
 		}
 		else
 		{
 			auto generatedTag = generateNewTag();
-			usedTags.insert(generatedTag);
+			usedTags.emplace(generatedTag);
 			return generatedTag;
 		}
 	}
 	else if (ck2Title == "The Fraticelli Pope")
 	{
-		if (!usedTags.count("FAP"))
+		if (!usedTags.count(EU4::Tag("FAP")))
 		{
-			usedTags.insert("FAP");
+			usedTags.emplace("FAP");
 			return "FAP";
 		}
 		else
 		{
 			auto generatedTag = generateNewTag();
-			usedTags.insert(generatedTag);
+			usedTags.emplace(generatedTag);
 			return generatedTag;
 		}
 	}
@@ -117,55 +92,37 @@ std::optional<std::string> mappers::TitleTagMapper::getTagForTitle(const std::st
 
 	// Attempt a capital match.
 	if (eu4Capital)
-	{
-		for (const auto& mapping: theMappings)
-		{
-			const auto& match = mapping.capitalMatch(eu4Capital);
-			if (match)
-			{
-				if (usedTags.count(*match))
-					continue;
-				registerTitle(ck2Title, *match);
-				return *match;
-			}
-		}
-	}
+		if (const auto& match = claimFirstFreeTag(rules->getCandidatesForCapital(eu4Capital), ck2Title))
+			return match;
 
 	// Attempt a title match
-	for (const auto& mapping: theMappings)
-	{
-		const auto& match = mapping.titleMatch(ck2Title);
-		if (match)
-		{
-			if (usedTags.count(*match))
-				continue;
-			registerTitle(ck2Title, *match);
-			return *match;
-		}
-	}
+	if (const auto& match = claimFirstFreeTag(rules->getCandidatesForTitle(ck2Title), ck2Title))
+		return match;
 
 	// Attempt a base title match (useful for custom empires)
 	if (!ck2BaseTitle.empty())
-	{
-		for (const auto& mapping: theMappings)
-		{
-			const auto& match = mapping.titleMatch(ck2BaseTitle);
-			if (match)
-			{
-				if (usedTags.count(*match))
-					continue;
-				registerTitle(ck2Title, *match);
-				return *match;
-			}
-		}
-	}
+		if (const auto& match = claimFirstFreeTag(rules->getCandidatesForTitle(ck2BaseTitle), ck2Title))
+			return match;
 
 	// Generate a new tag
 	auto generatedTag = generateNewTag();
-	registerTitle(ck2Title, generatedTag);
+	claimTitle(ck2Title, generatedTag);
 	return generatedTag;
 }
 
+std::optional<std::string> mappers::TitleTagMapper::claimFirstFreeTag(const std::vector<std::size_t>& candidates, const std::string& ck2Title)
+{
+	for (const auto candidate: candidates)
+	{
+		const auto& match = rules->getMappings()[candidate].getEU4Tag();
+		if (usedTags.count(EU4::Tag(match)))
+			continue;
+		claimTitle(ck2Title, match);
+		return match;
+	}
+	return std::nullopt;
+}
+
 std::string mappers::TitleTagMapper::generateNewTag()
 {
 	std::ostringstream generatedEU4TagStream;
@@ -184,37 +141,3 @@ std::string mappers::TitleTagMapper::generateNewTag()
 
 	return eu4Tag;
 }
-
-std::optional<std::string> mappers::TitleTagMapper::getChinaForTitle(const std::string& ck2Title)
-{
-	// Try regular maps.
-	for (const auto& mapping: chineseMappings)
-	{
-		const auto& match = mapping.titleMatch(ck2Title);
-		if (match)
-		{
-			return *match;
-		}
-	}
-
-	// Try for fallback
-	for (const auto& mapping: chineseMappings)
-	{
-		const auto match = mapping.fallbackMatch();
-		if (match)
-		{
-			return mapping.getEU4Tag();
-		}
-	}
-
-	// No china?
-	return std::nullopt;
-}
-
-std::set<std::string> mappers::TitleTagMapper::getAllChinas() const
-{
-	std::set<std::string> toReturn;
-	for (const auto& mapping: chineseMappings)
-		toReturn.insert(mapping.getEU4Tag());
-	return toReturn;
-}
@@ -1,15 +1,19 @@
 #ifndef TITLE_TAG_MAPPER_H
 #define TITLE_TAG_MAPPER_H
 
-#include "Parser.h"
-#include "TitleTagMapping.h"
+#include "../../EU4World/Country/Tag.h"
+#include "TitleTagRules.h"
+#include <map>
+#include <memory>
 
 namespace mappers
 {
-class TitleTagMapper: commonItems::parser
+// One conversion's tag bookkeeping over shared TitleTagRules: the titles it has mapped and the tags it has claimed.
+class TitleTagMapper
 {
   public:
 	TitleTagMapper() = default;
+	explicit TitleTagMapper(std::shared_ptr<const TitleTagRules> theRules): rules(std::move(theRules)) {}
 	void initTitleTagMapper(const std::string& path);
 	void initTitleTagMapper(std::istream& theStream);										 // testing
 	void initTitleTagMapper(std::istream& theStream, std::istream& chineseStream); // testing
@@ -18,21 +22,21 @@ class TitleTagMapper: commonItems::parser
 	std::optional<std::string> getTagForTitle(const std::string& ck2Title, const std::string& ck2BaseTitle, int eu4Capital);
 	std::optional<std::string> getTagForTitle(const std::string& ck2Title, int eu4Capital);
 	std::optional<std::string> getTagForTitle(const std::string& ck2Title);
-	std::optional<std::string> getChinaForTitle(const std::string& ck2Title);
-	std::set<std::string> getAllChinas() const;
+	[[nodiscard]] std::optional<std::string> getChinaForTitle(const std::string& ck2Title) const { return rules->getChinaForTitle(ck2Title); }
+	[[nodiscard]] std::set<std::string> getAllChinas() const { return rules->getAllChinas(); }
 
-	[[nodiscard]] const auto& getMappings() const { return theMappings; }						  // used for testing
+	[[nodiscard]] const auto& getMappings() const { return rules->getMappings(); }				  // used for testing
 	[[nodiscard]] const auto& getRegisteredTitleTags() const { return registeredTitleTags; } // used for testing
 
   private:
-	void registerKeys();
-	void registerChineseKeys();
+	void claimTitle(const std::string& ck2title, const std::string& eu4tag);
+	[[nodiscard]] std::optional<std::string> resolveTagForTitle(const std::string& ck2Title, const std::string& ck2BaseTitle, int eu4Capital);
 	std::string generateNewTag();
+	[[nodiscard]] std::optional<std::string> claimFirstFreeTag(const std::vector<std::size_t>& candidates, const std::string& ck2Title);
 
-	std::vector<TitleTagMapping> theMappings;
-	std::vector<TitleTagMapping> chineseMappings;
+	std::shared_ptr<const TitleTagRules> rules = std::make_shared<const TitleTagRules>();
 	std::map<std::string, std::string> registeredTitleTags; // We store already mapped countries here.
-	std::set<std::string> usedTags;
+	std::set<EU4::Tag> usedTags;
 
 	char generatedEU4TagPrefix = 'Z';
 	int generatedEU4TagSuffix = 0;
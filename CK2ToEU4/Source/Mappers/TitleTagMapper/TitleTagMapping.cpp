@@ -51,3 +51,19 @@ bool mappers::TitleTagMapping::fallbackMatch() const
 		return false;
 	return fallback;
 }
+
+void mappers::TitleTagMapping::writeCompiled(CompiledConfigurables::Writer& writer) const
+{
+	writer.put(eu4Tag);
+	writer.put(ck2Title);
+	writer.put(capitals);
+	writer.put(fallback);
+}
+
+void mappers::TitleTagMapping::readCompiled(CompiledConfigurables::Reader& reader)
+{
+	reader.get(eu4Tag);
+	reader.get(ck2Title);
+	reader.get(capitals);
+	reader.get(fallback);
+}
@@ -1,6 +1,7 @@
 #ifndef TITLE_TAG_MAPPING_H
 #define TITLE_TAG_MAPPING_H
 
+#include "../CompiledConfigurables/CompiledConfigurables.h"
 #include "Parser.h"
 #include <set>
 
@@ -21,6 +22,9 @@ class TitleTagMapping: commonItems::parser
 	[[nodiscard]] const auto& getCapitals() const { return capitals; } // used for testing
 	[[nodiscard]] auto getFallback() const { return fallback; }			 // used for testing
 
+	void writeCompiled(CompiledConfigurables::Writer& writer) const;
+	void readCompiled(CompiledConfigurables::Reader& reader);
+
   private:
 	void registerKeys();
 
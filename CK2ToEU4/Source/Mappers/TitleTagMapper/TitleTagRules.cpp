@@ -0,0 +1,138 @@
+#include "TitleTagRules.h"
+#include "../CompiledConfigurables/CompiledConfigurables.h"
+#include "CommonRegexes.h"
+#include "Log.h"
+#include "ParserHelpers.h"
+
+namespace
+{
+// Bump whenever TitleTagRules or TitleTagMapping write anything differently.
+const std::string compiledFormat = "tag mappings 1";
+} // namespace
+
+mappers::TitleTagRules::TitleTagRules(const std::string& path)
+{
+	Log(LogLevel::Info) << "-> Parsing Tag mappings";
+	std::string dirPath = "configurables";
+	if (!path.empty())
+	{
+		Log(LogLevel::Info) << "Tag Mapper override: " << path;
+		dirPath += "/" + path;
+	}
+	// not overriding chinese mappings as those are out of scope.
+	const std::vector<std::string> sourcePaths{dirPath + "/tag_mappings.txt", "configurables/chinese_tag_mappings.txt"};
+	if (CompiledConfigurables::load(sourcePaths, compiledFormat, [this](CompiledConfigurables::Reader& reader) {
+			 reader.get(theMappings);
+			 reader.get(mappingsByCapital);
+			 reader.get(mappingsByTitle);
+			 reader.get(chineseMappings);
+		 }))
+	{
+		Log(LogLevel::Info) << "<> " << theMappings.size() << " mappings and " << chineseMappings.size() << " Chinas loaded from "
+								  << CompiledConfigurables::compiledPath(sourcePaths.front());
+		return;
+	}
+	theMappings.clear();
+	mappingsByCapital.clear();
+	mappingsByTitle.clear();
+	chineseMappings.clear();
+
+	registerKeys();
+	parseFile(sourcePaths[0]);
+	clearRegisteredKeywords();
+	registerChineseKeys();
+	parseFile(sourcePaths[1]);
+	clearRegisteredKeywords();
+	CompiledConfigurables::save(sourcePaths, compiledFormat, [this](CompiledConfigurables::Writer& writer) {
+		writer.put(theMappings);
+		writer.put(mappingsByCapital);
+		writer.put(mappingsByTitle);
+		writer.put(chineseMappings);
+	});
+	Log(LogLevel::Info) << "<> " << theMappings.size() << " mappings and " << chineseMappings.size() << " Chinas loaded.";
+}
+
+mappers::TitleTagRules::TitleTagRules(std::istream& theStream)
+{
+	registerKeys();
+	parseStream(theStream);
+	clearRegisteredKeywords();
+}
+
+mappers::TitleTagRules::TitleTagRules(std::istream& theStream, std::istream& chineseStream)
+{
+	registerKeys();
+	parseStream(theStream);
+	clearRegisteredKeywords();
+	registerChineseKeys();
+	parseStream(chineseStream);
+	clearRegisteredKeywords();
+}
+
+void mappers::TitleTagRules::registerKeys()
+{
+	registerKeyword("link", [this](const std::string& unused, std::istream& theStream) {
+		const TitleTagMapping mapping(theStream);
+		for (const auto capital: mapping.getCapitals())
+			mappingsByCapital[capital].emplace_back(theMappings.size());
+		mappingsByTitle[mapping.getCK2Title()].emplace_back(theMappings.size());
+		theMappings.emplace_back(mapping);
+	});
+	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+}
+
+void mappers::TitleTagRules::registerChineseKeys()
+{
+	registerKeyword("link", [this](const std::string& unused, std::istream& theStream) {
+		chineseMappings.emplace_back(TitleTagMapping(theStream));
+	});
+	registerRegex(commonItems::catchallRegex, commonItems::ignoreItem);
+}
+
+const std::vector<std::size_t>& mappers::TitleTagRules::getCandidatesForCapital(const int eu4Capital) const
+{
+	static const std::vector<std::size_t> none;
+	const auto& candidatesItr = mappingsByCapital.find(eu4Capital);
+	return candidatesItr != mappingsByCapital.end() ? candidatesItr->second : none;
+}
+
+const std::vector<std::size_t>& mappers::TitleTagRules::getCandidatesForTitle(const std::string& ck2Title) const
+{
+	static const std::vector<std::size_t> none;
+	const auto& candidatesItr = mappingsByTitle.find(ck2Title);
+	return candidatesItr != mappingsByTitle.end() ? candidatesItr->second : none;
+}
+
+std::optional<std::string> mappers::TitleTagRules::getChinaForTitle(const std::string& ck2Title) const
+{
+	// Try regular maps.
+	for (const auto& mapping: chineseMappings)
+	{
+		const auto& match = mapping.titleMatch(ck2Title);
+		if (match)
+		{
+			return *match;
+		}
+	}
+
+	// Try for fallback
+	for (const auto& mapping: chineseMappings)
+	{
+		const auto match = mapping.fallbackMatch();
+		if (match)
+		{
+			return mapping.getEU4Tag();
+		}
+	}
+
+	// No china?
+	return std::nullopt;
+}
+
+std::set<std::string> mappers::TitleTagRules::getAllChinas() const
+{
+	std::set<std::string> toReturn;
+	for (const auto& mapping: chineseMappings)
+		toReturn.insert(mapping.getEU4Tag());
+	return toReturn;
+}
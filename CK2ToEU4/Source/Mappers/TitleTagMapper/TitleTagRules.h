@@ -0,0 +1,42 @@
+#ifndef TITLE_TAG_RULES_H
+#define TITLE_TAG_RULES_H
+
+#include "Parser.h"
+#include "TitleTagMapping.h"
+#include <unordered_map>
+#include <vector>
+
+namespace mappers
+{
+// The tag mapping files as loaded. Nothing here changes afterwards, so any number of conversions share one set of
+// rules; the tags each of them claims are kept by its own TitleTagMapper.
+class TitleTagRules: commonItems::parser
+{
+  public:
+	TitleTagRules() = default;
+	explicit TitleTagRules(const std::string& path);
+	explicit TitleTagRules(std::istream& theStream);								  // testing
+	TitleTagRules(std::istream& theStream, std::istream& chineseStream); // testing
+
+	[[nodiscard]] const auto& getMappings() const { return theMappings; }
+	// Positions in getMappings(), in file order.
+	[[nodiscard]] const std::vector<std::size_t>& getCandidatesForCapital(int eu4Capital) const;
+	[[nodiscard]] const std::vector<std::size_t>& getCandidatesForTitle(const std::string& ck2Title) const;
+
+	[[nodiscard]] std::optional<std::string> getChinaForTitle(const std::string& ck2Title) const;
+	[[nodiscard]] std::set<std::string> getAllChinas() const;
+
+  private:
+	void registerKeys();
+	void registerChineseKeys();
+
+	std::vector<TitleTagMapping> theMappings;
+	// Positions in theMappings by capital and by CK2 title, in file order, so the first free tag is still the one
+	// the file lists first.
+	std::unordered_map<int, std::vector<std::size_t>> mappingsByCapital;
+	std::unordered_map<std::string, std::vector<std::size_t>> mappingsByTitle;
+	std::vector<TitleTagMapping> chineseMappings;
+};
+} // namespace mappers
+
+#endif // TITLE_TAG_RULES_H
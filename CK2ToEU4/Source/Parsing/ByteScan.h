@@ -0,0 +1,103 @@
+#ifndef PARSING_BYTE_SCAN_H
+#define PARSING_BYTE_SCAN_H
+#include <bit>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARSING_BYTE_SCAN_SSE2
+#endif
+
+// Byte classification shared by the tokenizer and the item skipper. Each search looks at 16 bytes per step
+// where SSE2 is available (every x64 target) and falls back to a plain loop for the tail and elsewhere.
+// Whitespace is anything up to and including ' ', same as the control characters the lexer skips.
+namespace parsing::scan
+{
+inline bool isSpace(const char c)
+{
+	return static_cast<unsigned char>(c) <= ' ';
+}
+
+inline bool isBlockSpecial(const char c)
+{
+	return c == '{' || c == '}' || c == '"' || c == '#';
+}
+
+inline bool endsWord(const char c)
+{
+	return isSpace(c) || c == '=' || isBlockSpecial(c);
+}
+
+#ifdef PARSING_BYTE_SCAN_SSE2
+inline unsigned spaceMask(const __m128i chunk)
+{
+	const auto space = _mm_set1_epi8(' ');
+	return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space)));
+}
+
+inline unsigned blockSpecialMask(const __m128i chunk)
+{
+	const auto braces = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')));
+	const auto others = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('#')));
+	return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(braces, others)));
+}
+
+inline __m128i load(const char* position)
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+}
+#endif
+
+// First non-whitespace byte in [position, end), or end.
+inline const char* skipSpaces(const char* position, const char* const end)
+{
+#ifdef PARSING_BYTE_SCAN_SSE2
+	for (; end - position >= 16; position += 16)
+		if (const auto mask = ~spaceMask(load(position)) & 0xFFFFu; mask != 0)
+			return position + std::countr_zero(mask);
+#endif
+	while (position < end && isSpace(*position))
+		++position;
+	return position;
+}
+
+// First byte that can't be part of an unquoted word: whitespace, = { } " or #.
+inline const char* findWordEnd(const char* position, const char* const end)
+{
+#ifdef PARSING_BYTE_SCAN_SSE2
+	for (; end - position >= 16; position += 16)
+	{
+		const auto chunk = load(position);
+		const auto equals = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('='))));
+		if (const auto mask = spaceMask(chunk) | blockSpecialMask(chunk) | equals; mask != 0)
+			return position + std::countr_zero(mask);
+	}
+#endif
+	while (position < end && !endsWord(*position))
+		++position;
+	return position;
+}
+
+// First of { } " # in [position, end), or end.
+inline const char* findBlockSpecial(const char* position, const char* const end)
+{
+#ifdef PARSING_BYTE_SCAN_SSE2
+	for (; end - position >= 16; position += 16)
+		if (const auto mask = blockSpecialMask(load(position)); mask != 0)
+			return position + std::countr_zero(mask);
+#endif
+	while (position < end && !isBlockSpecial(*position))
+		++position;
+	return position;
+}
+
+// First c in [position, end), or end. memchr is already vectorized by every libc we build against.
+inline const char* find(const char* position, const char* const end, const char c)
+{
+	if (position >= end)
+		return end;
+	const auto* found = static_cast<const char*>(std::memchr(position, c, static_cast<std::size_t>(end - position)));
+	return found ? found : end;
+}
+} // namespace parsing::scan
+
+#endif // PARSING_BYTE_SCAN_H
@@ -0,0 +1,42 @@
+#ifndef PARSING_COPY_ON_WRITE_H
+#define PARSING_COPY_ON_WRITE_H
+#include <memory>
+#include <utility>
+
+namespace parsing
+{
+// A value shared between copies until one of them changes it. Copying shares the value; reading goes through * and
+// ->, writing through edit(), which first clones the value if anything else still shares it:
+//
+//	copy.edit().owner = "FRA"; // the copied-from keeps its own owner
+//
+// The EU4 details of vanilla provinces and countries sit behind these, so that every conversion sharing a process
+// copies its vanilla state out of one image without duplicating the parts it never touches, and the lists every
+// imported province carries the same of stay one list. A reference from edit() is only good until this is copied.
+//
+// Not safe to edit() from two threads at once; sharing alone is, as the count is atomic.
+template <typename T> class CopyOnWrite
+{
+  public:
+	CopyOnWrite(): value(std::make_shared<T>()) {}
+	explicit CopyOnWrite(T theValue): value(std::make_shared<T>(std::move(theValue))) {}
+	explicit CopyOnWrite(std::shared_ptr<const T> theValue): value(std::const_pointer_cast<T>(std::move(theValue))) {}
+
+	[[nodiscard]] const T& operator*() const { return *value; }
+	[[nodiscard]] const T* operator->() const { return value.get(); }
+
+	[[nodiscard]] T& edit()
+	{
+		if (value.use_count() > 1)
+			value = std::make_shared<T>(*value);
+		return *value;
+	}
+
+	[[nodiscard]] bool sharesWith(const CopyOnWrite& other) const { return value == other.value; }
+
+  private:
+	std::shared_ptr<T> value; // never changed in place while use_count() > 1
+};
+} // namespace parsing
+
+#endif // PARSING_COPY_ON_WRITE_H
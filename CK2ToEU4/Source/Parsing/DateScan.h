@@ -0,0 +1,37 @@
+#ifndef PARSING_DATE_SCAN_H
+#define PARSING_DATE_SCAN_H
+#include "Date.h"
+#include <charconv>
+#include <string>
+#include <string_view>
+
+namespace parsing
+{
+// Reads a plain "y.m.d" straight into date's fields. Every character carries a birth date and most a death date,
+// and date's string constructor goes through a copy and a split on each of them. Anything that isn't three
+// dot-separated integers is left to that constructor, so odd inputs behave exactly as before.
+inline date parseDate(const std::string_view text)
+{
+	int fields[3] = {};
+	const auto* position = text.data();
+	const auto* const end = text.data() + text.size();
+	for (auto field = 0; field < 3; ++field)
+	{
+		const auto [next, error] = std::from_chars(position, end, fields[field]);
+		if (error != std::errc{})
+			return date(std::string(text));
+		position = next;
+		if (field < 2)
+		{
+			if (position == end || *position != '.')
+				return date(std::string(text));
+			++position;
+		}
+	}
+	if (position != end)
+		return date(std::string(text));
+	return date(fields[0], fields[1], fields[2]);
+}
+} // namespace parsing
+
+#endif // PARSING_DATE_SCAN_H
@@ -0,0 +1,87 @@
+#ifndef PARSING_FLAT_SET_H
+#define PARSING_FLAT_SET_H
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace parsing
+{
+// A set kept as a sorted vector, for the handful of laws, electors or buildings an entity carries. Those rarely
+// pass ten entries, and there are hundreds of thousands of them in a late save, so a node per element (and the
+// pointer chase on every count()) costs more than shifting a few elements on insert. Iterates in the same order
+// std::set would. Compare may be transparent (std::less<>), in which case lookups take anything it compares.
+//
+// Insertion invalidates iterators, as with any vector; entities fill these while parsing and only read them after.
+template <typename Key, typename Compare = std::less<Key>> class FlatSet
+{
+  public:
+	using value_type = Key;
+	using key_type = Key;
+	using size_type = typename std::vector<Key>::size_type;
+	using const_iterator = typename std::vector<Key>::const_iterator;
+	using iterator = const_iterator;
+	using const_reverse_iterator = typename std::vector<Key>::const_reverse_iterator;
+
+	FlatSet() = default;
+	FlatSet(std::initializer_list<Key> keys) { insert(keys.begin(), keys.end()); }
+
+	[[nodiscard]] const_iterator begin() const { return keys.begin(); }
+	[[nodiscard]] const_iterator end() const { return keys.end(); }
+	[[nodiscard]] const_reverse_iterator rbegin() const { return keys.rbegin(); }
+	[[nodiscard]] const_reverse_iterator rend() const { return keys.rend(); }
+	[[nodiscard]] size_type size() const { return keys.size(); }
+	[[nodiscard]] bool empty() const { return keys.empty(); }
+
+	template <typename Lookup> [[nodiscard]] const_iterator find(const Lookup& key) const
+	{
+		const auto position = lowerBound(key);
+		if (position != keys.end() && !Compare{}(key, *position))
+			return position;
+		return keys.end();
+	}
+	template <typename Lookup> [[nodiscard]] size_type count(const Lookup& key) const { return find(key) != keys.end() ? 1 : 0; }
+	template <typename Lookup> [[nodiscard]] bool contains(const Lookup& key) const { return find(key) != keys.end(); }
+
+	std::pair<const_iterator, bool> insert(const Key& key)
+	{
+		const auto position = lowerBound(key);
+		if (position != keys.end() && !Compare{}(key, *position))
+			return {position, false};
+		return {keys.insert(position, key), true};
+	}
+	template <typename... Args> std::pair<const_iterator, bool> emplace(Args&&... args) { return insert(Key(std::forward<Args>(args)...)); }
+	template <typename Iterator> void insert(Iterator first, Iterator last)
+	{
+		// Append, then sort and drop duplicates once, rather than shifting the tail for every element.
+		keys.insert(keys.end(), first, last);
+		std::sort(keys.begin(), keys.end(), Compare{});
+		keys.erase(std::unique(keys.begin(), keys.end(), [](const Key& lhs, const Key& rhs) { return !Compare{}(lhs, rhs) && !Compare{}(rhs, lhs); }),
+			 keys.end());
+	}
+
+	template <typename Lookup> size_type erase(const Lookup& key)
+	{
+		const auto position = find(key);
+		if (position == keys.end())
+			return 0;
+		keys.erase(position);
+		return 1;
+	}
+	void clear() { keys.clear(); }
+	void reserve(const size_type capacity) { keys.reserve(capacity); }
+
+	friend bool operator==(const FlatSet& lhs, const FlatSet& rhs) { return lhs.keys == rhs.keys; }
+
+  private:
+	template <typename Lookup> [[nodiscard]] const_iterator lowerBound(const Lookup& key) const
+	{
+		return std::lower_bound(keys.begin(), keys.end(), key, Compare{});
+	}
+
+	std::vector<Key> keys;
+};
+} // namespace parsing
+
+#endif // PARSING_FLAT_SET_H
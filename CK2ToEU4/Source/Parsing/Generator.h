@@ -0,0 +1,107 @@
+#ifndef PARSING_GENERATOR_H
+#define PARSING_GENERATOR_H
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace parsing
+{
+// A coroutine that hands out values one at a time as the consumer asks for them, for walking save text pull-style:
+//
+//	for (const auto& [key, item]: BlockLoader::entriesOf(shard))
+//		if (done(key))
+//			break; // nothing past this entry is scanned
+//
+// Nothing runs until the first value is asked for, and each value is produced only once the previous one has been
+// consumed, so a consumer that stops early stops the scan with it and nothing is buffered in between. Values are
+// yielded by reference and live until the coroutine resumes; copy them to keep them. An exception thrown inside
+// reaches the consumer at the ++ (or begin()) that resumed it. Single-pass and move-only, like std::generator.
+template <typename T> class Generator
+{
+  public:
+	struct promise_type
+	{
+		const T* current = nullptr;
+		std::exception_ptr exception;
+
+		Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		std::suspend_always yield_value(const T& value) noexcept
+		{
+			current = std::addressof(value);
+			return {};
+		}
+		void return_void() noexcept {}
+		void unhandled_exception() { exception = std::current_exception(); }
+		template <typename U> std::suspend_never await_transform(U&&) = delete; // generators don't await
+	};
+
+	struct Sentinel
+	{
+	};
+
+	class Iterator
+	{
+	  public:
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+
+		Iterator() = default;
+		explicit Iterator(std::coroutine_handle<promise_type> theCoroutine): coroutine(theCoroutine) {}
+
+		const T& operator*() const { return *coroutine.promise().current; }
+		const T* operator->() const { return coroutine.promise().current; }
+		Iterator& operator++()
+		{
+			advance(coroutine);
+			return *this;
+		}
+		void operator++(int) { ++*this; }
+		bool operator==(Sentinel) const { return coroutine.done(); }
+
+	  private:
+		std::coroutine_handle<promise_type> coroutine;
+	};
+
+	Generator(Generator&& other) noexcept: coroutine(std::exchange(other.coroutine, {})) {}
+	Generator& operator=(Generator&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (coroutine)
+				coroutine.destroy();
+			coroutine = std::exchange(other.coroutine, {});
+		}
+		return *this;
+	}
+	~Generator()
+	{
+		if (coroutine)
+			coroutine.destroy();
+	}
+
+	Iterator begin()
+	{
+		advance(coroutine);
+		return Iterator(coroutine);
+	}
+	Sentinel end() const { return {}; }
+
+  private:
+	explicit Generator(std::coroutine_handle<promise_type> theCoroutine): coroutine(theCoroutine) {}
+
+	static void advance(std::coroutine_handle<promise_type> coroutine)
+	{
+		coroutine.resume();
+		if (coroutine.promise().exception)
+			std::rethrow_exception(std::exchange(coroutine.promise().exception, {}));
+	}
+
+	std::coroutine_handle<promise_type> coroutine;
+};
+} // namespace parsing
+
+#endif // PARSING_GENERATOR_H
@@ -0,0 +1,193 @@
+#include "ItemSkipper.h"
+#include "ByteScan.h"
+#include "ScannableBuffer.h"
+
+std::size_t parsing::ItemSkipper::scan(const std::string_view data)
+{
+	const auto* const begin = data.data();
+	const auto* const end = begin + data.size();
+	const auto* position = begin;
+
+	while (position < end && stage != Stage::DONE)
+	{
+		const auto c = *position;
+		switch (stage)
+		{
+			case Stage::BEFORE_EQUALS:
+			case Stage::BEFORE_VALUE:
+			case Stage::BEFORE_COLOR:
+				if (parsing::scan::isSpace(c))
+				{
+					++position;
+				}
+				else if (c == '#')
+				{
+					afterComment = stage;
+					stage = Stage::COMMENT;
+					++position;
+				}
+				else if (stage == Stage::BEFORE_EQUALS)
+				{
+					// The = is optional, "key { ... }" is skipped the same as "key = { ... }".
+					if (c == '=')
+						++position;
+					stage = Stage::BEFORE_VALUE;
+				}
+				else if (c == '{')
+				{
+					depth = 1;
+					stage = Stage::BLOCK;
+					++position;
+				}
+				else if (stage == Stage::BEFORE_COLOR)
+				{
+					// "rgb" or "hsv" was the value itself.
+					stage = Stage::DONE;
+				}
+				else if (c == '"')
+				{
+					stage = Stage::QUOTED_VALUE;
+					++position;
+				}
+				else if (c == '}')
+				{
+					// Nothing to skip, the brace closes whatever block the caller is parsing.
+					stage = Stage::DONE;
+				}
+				else
+				{
+					stage = Stage::BARE_VALUE;
+				}
+				break;
+			case Stage::BARE_VALUE:
+				if (parsing::scan::endsWord(c))
+				{
+					endBareValue();
+				}
+				else
+				{
+					if (bareValue.size() < 4)
+						bareValue.push_back(c);
+					++position;
+				}
+				break;
+			case Stage::QUOTED_VALUE:
+				position = parsing::scan::find(position, end, '"');
+				if (position < end)
+				{
+					stage = Stage::DONE;
+					++position;
+				}
+				break;
+			case Stage::BLOCK:
+				position = parsing::scan::findBlockSpecial(position, end);
+				if (position == end)
+					break;
+				if (*position == '{')
+					++depth;
+				else if (*position == '}' && --depth == 0)
+					stage = Stage::DONE;
+				else if (*position == '"')
+					stage = Stage::QUOTE_IN_BLOCK;
+				else if (*position == '#')
+				{
+					afterComment = Stage::BLOCK;
+					stage = Stage::COMMENT;
+				}
+				++position;
+				break;
+			case Stage::QUOTE_IN_BLOCK:
+				position = parsing::scan::find(position, end, '"');
+				if (position < end)
+				{
+					stage = Stage::BLOCK;
+					++position;
+				}
+				break;
+			case Stage::COMMENT:
+				position = parsing::scan::find(position, end, '\n');
+				if (position < end)
+				{
+					stage = afterComment;
+					++position;
+				}
+				break;
+			case Stage::DONE:
+				break;
+		}
+	}
+	return static_cast<std::size_t>(position - begin);
+}
+
+void parsing::ItemSkipper::endBareValue()
+{
+	stage = bareValue == "rgb" || bareValue == "hsv" ? Stage::BEFORE_COLOR : Stage::DONE;
+	bareValue.clear();
+}
+
+std::size_t parsing::ItemSkipper::measure(const std::string_view data)
+{
+	ItemSkipper skipper;
+	return skipper.scan(data);
+}
+
+void parsing::ItemSkipper::skip(std::istream& theStream)
+{
+	pass(theStream, nullptr);
+}
+
+std::string parsing::ItemSkipper::capture(std::istream& theStream)
+{
+	std::string copy;
+	pass(theStream, &copy);
+	return copy;
+}
+
+void parsing::ItemSkipper::pass(std::istream& theStream, std::string* const copy)
+{
+	using traits = std::char_traits<char>;
+	auto* buffer = theStream.rdbuf();
+	ItemSkipper skipper;
+
+	if (auto* scannable = dynamic_cast<ScannableBuffer*>(buffer))
+	{
+		while (!skipper.done())
+		{
+			const auto unread = scannable->unread();
+			if (unread.empty())
+			{
+				// Let the buffer refill (next chunk), or tell us we're out.
+				if (traits::eq_int_type(buffer->sgetc(), traits::eof()))
+					break;
+				continue;
+			}
+			const auto scanned = skipper.scan(unread);
+			if (copy)
+				copy->append(unread.substr(0, scanned));
+			scannable->consume(scanned);
+		}
+	}
+	else
+	{
+		while (!skipper.done())
+		{
+			const auto ch = buffer->sgetc();
+			if (traits::eq_int_type(ch, traits::eof()))
+				break;
+			const auto c = traits::to_char_type(ch);
+			if (skipper.scan(std::string_view(&c, 1)) == 0)
+				break;
+			if (copy)
+				copy->push_back(c);
+			buffer->sbumpc();
+		}
+	}
+
+	if (!skipper.done() && traits::eq_int_type(buffer->sgetc(), traits::eof()))
+		theStream.setstate(std::ios_base::eofbit);
+}
+
+void parsing::ignoreItem(const std::string& unused, std::istream& theStream)
+{
+	ItemSkipper::skip(theStream);
+}
@@ -0,0 +1,55 @@
+#ifndef PARSING_ITEM_SKIPPER_H
+#define PARSING_ITEM_SKIPPER_H
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace parsing
+{
+// Skips past an item we don't care about ("= value", "= { ... }", "= rgb { ... }") without lexing it.
+// commonItems::ignoreItem pulls every token of an ignored block through getNextLexeme; inside a block
+// only braces, quotes and comments matter, so we scan for those 16 bytes at a time and jump over the rest.
+// Wars, history and event blocks are a large share of a late-game save and all of it goes through here.
+//
+// The scan is resumable: feed it consecutive runs of bytes until done().
+class ItemSkipper
+{
+  public:
+	// Returns how many bytes of data belong to the item. Anything short of data.size() means the item ended there.
+	[[nodiscard]] std::size_t scan(std::string_view data);
+	[[nodiscard]] bool done() const { return stage == Stage::DONE; }
+
+	// How many bytes the item at the start of data spans, or all of them if it runs off the end.
+	[[nodiscard]] static std::size_t measure(std::string_view data);
+	static void skip(std::istream& theStream);
+	// skip() that hands back what it went past, for items we keep as the file had them.
+	[[nodiscard]] static std::string capture(std::istream& theStream);
+
+  private:
+	enum class Stage
+	{
+		BEFORE_EQUALS,
+		BEFORE_VALUE,
+		BARE_VALUE,
+		QUOTED_VALUE,
+		BEFORE_COLOR,
+		BLOCK,
+		QUOTE_IN_BLOCK,
+		COMMENT,
+		DONE
+	};
+
+	void endBareValue();
+	static void pass(std::istream& theStream, std::string* copy);
+
+	Stage stage = Stage::BEFORE_EQUALS;
+	Stage afterComment = Stage::BEFORE_EQUALS;
+	std::size_t depth = 0;
+	std::string bareValue; // only kept long enough to tell "rgb" and "hsv" apart from other values
+};
+
+// Drop-in replacement for commonItems::ignoreItem in registerRegex(commonItems::catchallRegex, ...).
+void ignoreItem(const std::string& unused, std::istream& theStream);
+} // namespace parsing
+
+#endif // PARSING_ITEM_SKIPPER_H
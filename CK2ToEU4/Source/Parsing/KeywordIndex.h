@@ -0,0 +1,97 @@
+#ifndef PARSING_KEYWORD_INDEX_H
+#define PARSING_KEYWORD_INDEX_H
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace parsing
+{
+// The keyword -> handler lookup behind KeywordTable and TokenTable. An entity's keywords are fixed once its table is
+// registered, so instead of a general hash map we pick a seed under which every keyword lands in a slot of its own.
+// A lookup is then one multiply per 8 bytes of the token (one for nearly every key in a save), a slot load and a
+// single comparison; a token that isn't a keyword usually fails on the empty slot or the length without touching the
+// keyword at all. The seed is searched again whenever a keyword is added, which only happens while the table is
+// registered.
+//
+// Like unordered_map::emplace, the first value registered for a keyword stays.
+template <typename Value> class KeywordIndex
+{
+  public:
+	void insert(std::string keyword, Value value)
+	{
+		if (find(keyword))
+			return;
+		entries.emplace_back(std::move(keyword), std::move(value));
+		reseed();
+	}
+
+	[[nodiscard]] const Value* find(const std::string_view keyword) const
+	{
+		if (slots.empty())
+			return nullptr;
+		const auto slot = slots[hash(keyword, seed) & (slots.size() - 1)];
+		if (!slot)
+			return nullptr;
+		const auto& [candidate, value] = entries[slot - 1];
+		return candidate == keyword ? &value : nullptr;
+	}
+
+	[[nodiscard]] std::size_t size() const { return entries.size(); }
+
+  private:
+	[[nodiscard]] static std::uint64_t hash(const std::string_view keyword, const std::uint64_t seed)
+	{
+		auto result = seed ^ keyword.size();
+		for (std::size_t position = 0; position < keyword.size(); position += 8)
+		{
+			std::uint64_t chunk = 0;
+			std::memcpy(&chunk, keyword.data() + position, std::min<std::size_t>(8, keyword.size() - position));
+			result = (result ^ chunk) * 0x9E3779B97F4A7C15ULL;
+			result ^= result >> 29;
+		}
+		return result;
+	}
+
+	// Tries seeds at twice the keywords' count in slots, doubling the slots every so often. A few dozen keywords
+	// settle within a handful of tries.
+	void reseed()
+	{
+		auto slotCount = std::size_t{2};
+		while (slotCount < entries.size() * 2)
+			slotCount *= 2;
+		for (std::uint64_t candidate = 1;; ++candidate)
+		{
+			if (candidate % 64 == 0)
+				slotCount *= 2;
+			if (tryPlacing(candidate, slotCount))
+			{
+				seed = candidate;
+				return;
+			}
+		}
+	}
+
+	[[nodiscard]] bool tryPlacing(const std::uint64_t candidate, const std::size_t slotCount)
+	{
+		slots.assign(slotCount, 0);
+		for (std::size_t entry = 0; entry < entries.size(); ++entry)
+		{
+			auto& slot = slots[hash(entries[entry].first, candidate) & (slotCount - 1)];
+			if (slot)
+				return false;
+			slot = static_cast<std::uint32_t>(entry + 1);
+		}
+		return true;
+	}
+
+	std::vector<std::pair<std::string, Value>> entries;
+	std::vector<std::uint32_t> slots; // entry + 1, 0 for none; a power of two in size
+	std::uint64_t seed = 0;
+};
+} // namespace parsing
+
+#endif // PARSING_KEYWORD_INDEX_H
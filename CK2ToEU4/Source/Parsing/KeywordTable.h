@@ -0,0 +1,128 @@
+#ifndef PARSING_KEYWORD_TABLE_H
+#define PARSING_KEYWORD_TABLE_H
+#include "ItemSkipper.h"
+#include "KeywordIndex.h"
+#include "Log.h"
+#include "OSCompatibilityLayer.h"
+#include "Parser.h"
+#include "ParserHelpers.h"
+#include "TokenMatcher.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+// A built-once keyword -> handler table for entities we construct by the hundred thousand.
+// commonItems::parser registers (and compiles regexes for) every keyword on every instance; this
+// table is filled once per entity type and reused, so building an entity costs only the parse itself.
+// Dispatch mirrors commonItems::parser: exact keyword, then unquoted keyword, then matchers in order.
+//
+// Usage: static const auto keywordTable = registerKeys(); keywordTable.parseStream(*this, theStream);
+template <typename Entity> class KeywordTable
+{
+  public:
+	using Handler = void (*)(Entity& entity, const std::string& keyword, std::istream& theStream);
+
+	void registerKeyword(const std::string& keyword, Handler handler) { keywords.insert(keyword, handler); }
+	void registerMatcher(TokenMatcher matcher, Handler handler) { matchers.emplace_back(std::move(matcher), handler); }
+	// Prefer registerMatcher, this is for shapes TokenMatcher can't express.
+	void registerRegex(const std::string& pattern, Handler handler) { matchers.emplace_back(TokenMatcher::regex(pattern), handler); }
+	// Equivalent of registerRegex(commonItems::catchallRegex, parsing::ignoreItem), without running a regex on every leftover key.
+	void ignoreUnregistered() { ignoreLeftovers = true; }
+
+	void parseStream(Entity& entity, std::istream& theStream) const;
+	void parseFile(Entity& entity, const std::string& filename) const;
+
+  private:
+	[[nodiscard]] bool dispatch(Entity& entity, const std::string& lexeme, std::istream& theStream) const;
+
+	KeywordIndex<Handler> keywords;
+	std::vector<std::pair<TokenMatcher, Handler>> matchers;
+	bool ignoreLeftovers = false;
+};
+
+template <typename Entity> void KeywordTable<Entity>::parseStream(Entity& entity, std::istream& theStream) const
+{
+	theStream >> std::noskipws;
+	auto braceDepth = 0;
+	auto value = false;
+	while (true)
+	{
+		if (theStream.eof())
+			return;
+		const auto lexeme = commonItems::getNextLexeme(theStream);
+		if (lexeme.empty())
+			return;
+		if (dispatch(entity, lexeme, theStream))
+			continue;
+
+		if (lexeme == "=")
+		{
+			// Only the leading = of "= { ... }" is expected, a second one means broken syntax in the save.
+			if (value)
+				return;
+			value = true;
+		}
+		else if (lexeme == "{")
+		{
+			++braceDepth;
+		}
+		else if (lexeme == "}")
+		{
+			--braceDepth;
+			if (braceDepth == 0)
+				return;
+		}
+	}
+}
+
+template <typename Entity> void KeywordTable<Entity>::parseFile(Entity& entity, const std::string& filename) const
+{
+	std::ifstream theFile(std::filesystem::u8path(filename));
+	if (!theFile.is_open())
+	{
+		Log(LogLevel::Error) << "Could not open " << filename << " for parsing.";
+		return;
+	}
+	commonItems::absorbBOM(theFile);
+	parseStream(entity, theFile);
+	theFile.close();
+}
+
+template <typename Entity> bool KeywordTable<Entity>::dispatch(Entity& entity, const std::string& lexeme, std::istream& theStream) const
+{
+	if (const auto* handler = keywords.find(lexeme))
+	{
+		(*handler)(entity, lexeme, theStream);
+		return true;
+	}
+
+	const auto quoted = lexeme.size() > 2 && lexeme.front() == '"' && lexeme.back() == '"';
+	const auto stripped = quoted ? std::string_view(lexeme).substr(1, lexeme.size() - 2) : std::string_view();
+	if (quoted)
+		if (const auto* handler = keywords.find(stripped))
+		{
+			(*handler)(entity, lexeme, theStream);
+			return true;
+		}
+
+	for (const auto& [matcher, handler]: matchers)
+		if (matcher.matches(lexeme) || (quoted && matcher.matches(stripped)))
+		{
+			handler(entity, lexeme, theStream);
+			return true;
+		}
+
+	if (ignoreLeftovers && lexeme != "=" && lexeme != "{" && lexeme != "}")
+	{
+		ItemSkipper::skip(theStream);
+		return true;
+	}
+	return false;
+}
+} // namespace parsing
+
+#endif // PARSING_KEYWORD_TABLE_H
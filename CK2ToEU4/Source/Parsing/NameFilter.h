@@ -0,0 +1,43 @@
+#ifndef PARSING_NAME_FILTER_H
+#define PARSING_NAME_FILTER_H
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+// The keys of an open-ended block (global flags, global variables) that the converter actually reads, by exact name
+// or by prefix. Such blocks grow by thousands of entries over a long campaign and we query a handful, so the parsers
+// keep what a filter admits and send everything else through the item skipper unlexed.
+//
+// A default-constructed filter admits everything, which is what tests and tools that list a whole block want.
+class NameFilter
+{
+  public:
+	NameFilter() = default;
+	NameFilter(std::initializer_list<std::string> theNames, std::initializer_list<std::string> thePrefixes = {}):
+		 everything(false), names(theNames), prefixes(thePrefixes)
+	{
+		std::ranges::sort(names);
+	}
+
+	[[nodiscard]] bool admits(const std::string_view name) const
+	{
+		if (everything || std::ranges::binary_search(names, name, std::less<>{}))
+			return true;
+		return std::ranges::any_of(prefixes, [name](const std::string& prefix) {
+			return name.starts_with(prefix);
+		});
+	}
+
+  private:
+	bool everything = true;
+	std::vector<std::string> names; // sorted
+	std::vector<std::string> prefixes;
+};
+} // namespace parsing
+
+#endif // PARSING_NAME_FILTER_H
@@ -0,0 +1,143 @@
+#ifndef PARSING_NAME_MAP_H
+#define PARSING_NAME_MAP_H
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace parsing
+{
+// A map from names that iterates in name order like std::map but looks names up by hash, taking a string_view or a
+// literal without building a std::string first. CK2 titles and EU4 countries sit in these: tens of thousands of
+// entries that every linking pass looks up by name, and that get written out in name order.
+//
+// The entries live in a std::map, which stays the ordered view; the index hashes views of that map's own keys, which
+// stay put for as long as their entry does. So references and iterators survive inserts, as with std::map.
+template <typename Value> class NameMap
+{
+	using Entries = std::map<std::string, Value, std::less<>>;
+
+  public:
+	using key_type = std::string;
+	using mapped_type = Value;
+	using value_type = typename Entries::value_type;
+	using size_type = typename Entries::size_type;
+	using iterator = typename Entries::iterator;
+	using const_iterator = typename Entries::const_iterator;
+
+	NameMap() = default;
+	NameMap(std::initializer_list<value_type> values): entries(values) { reindex(); }
+	NameMap(const NameMap& other): entries(other.entries) { reindex(); }
+	NameMap(NameMap&&) noexcept = default; // moving a std::map moves no nodes, so the index still points into it
+	NameMap& operator=(const NameMap& other)
+	{
+		if (this != &other)
+		{
+			entries = other.entries;
+			reindex();
+		}
+		return *this;
+	}
+	NameMap& operator=(NameMap&&) noexcept = default;
+
+	[[nodiscard]] iterator begin() { return entries.begin(); }
+	[[nodiscard]] iterator end() { return entries.end(); }
+	[[nodiscard]] const_iterator begin() const { return entries.begin(); }
+	[[nodiscard]] const_iterator end() const { return entries.end(); }
+	[[nodiscard]] size_type size() const { return entries.size(); }
+	[[nodiscard]] bool empty() const { return entries.empty(); }
+
+	[[nodiscard]] iterator find(const std::string_view name)
+	{
+		const auto found = index.find(name);
+		return found != index.end() ? found->second : entries.end();
+	}
+	[[nodiscard]] const_iterator find(const std::string_view name) const
+	{
+		const auto found = index.find(name);
+		return found != index.end() ? const_iterator(found->second) : entries.end();
+	}
+	[[nodiscard]] size_type count(const std::string_view name) const { return index.count(name); }
+	[[nodiscard]] bool contains(const std::string_view name) const { return index.contains(name); }
+	[[nodiscard]] const Value& at(const std::string_view name) const
+	{
+		const auto found = find(name);
+		if (found == entries.end())
+			throw std::out_of_range("No entry named " + std::string(name));
+		return found->second;
+	}
+
+	Value& operator[](const std::string_view name)
+	{
+		if (const auto found = find(name); found != entries.end())
+			return found->second;
+		return emplace(std::string(name), Value{}).first->second;
+	}
+	template <typename... Args> std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		const auto [entry, inserted] = entries.emplace(std::forward<Args>(args)...);
+		if (inserted)
+			index.emplace(entry->first, entry);
+		return {entry, inserted};
+	}
+	std::pair<iterator, bool> insert(value_type value) { return emplace(std::move(value)); }
+	template <typename... Args> iterator emplace_hint(const const_iterator hint, Args&&... args)
+	{
+		const auto before = entries.size();
+		const auto entry = entries.emplace_hint(hint, std::forward<Args>(args)...);
+		if (entries.size() != before)
+			index.emplace(entry->first, entry);
+		return entry;
+	}
+	std::pair<iterator, bool> insert_or_assign(const std::string_view name, Value value)
+	{
+		if (const auto found = find(name); found != entries.end())
+		{
+			found->second = std::move(value);
+			return {found, false};
+		}
+		return emplace(std::string(name), std::move(value));
+	}
+
+	size_type erase(const std::string_view name)
+	{
+		const auto found = index.find(name);
+		if (found == index.end())
+			return 0;
+		const auto entry = found->second;
+		index.erase(found); // the view dies with the entry, so it goes first
+		entries.erase(entry);
+		return 1;
+	}
+	iterator erase(const const_iterator entry)
+	{
+		index.erase(entry->first);
+		return entries.erase(entry);
+	}
+	void clear()
+	{
+		index.clear();
+		entries.clear();
+	}
+
+	friend bool operator==(const NameMap& lhs, const NameMap& rhs) { return lhs.entries == rhs.entries; }
+
+  private:
+	void reindex()
+	{
+		index.clear();
+		index.reserve(entries.size());
+		for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+			index.emplace(entry->first, entry);
+	}
+
+	Entries entries;
+	std::unordered_map<std::string_view, iterator> index; // keys view entries' own keys
+};
+} // namespace parsing
+
+#endif // PARSING_NAME_MAP_H
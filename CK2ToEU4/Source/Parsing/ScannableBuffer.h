@@ -0,0 +1,25 @@
+#ifndef PARSING_SCANNABLE_BUFFER_H
+#define PARSING_SCANNABLE_BUFFER_H
+#include <climits>
+#include <streambuf>
+#include <string_view>
+
+namespace parsing
+{
+// A stream buffer that lets scanners look at its buffered bytes directly instead of pulling them out one sgetc() at a time.
+// Buffers over memory (SaveBuffer) expose everything that's left, chunked ones the rest of the current chunk.
+class ScannableBuffer: public std::streambuf
+{
+  public:
+	[[nodiscard]] std::string_view unread() const { return {gptr(), static_cast<std::size_t>(egptr() - gptr())}; }
+	void consume(std::size_t count)
+	{
+		// gbump takes an int, and a single ignored item can be bigger than that in principle.
+		for (; count > INT_MAX; count -= INT_MAX)
+			gbump(INT_MAX);
+		gbump(static_cast<int>(count));
+	}
+};
+} // namespace parsing
+
+#endif // PARSING_SCANNABLE_BUFFER_H
@@ -0,0 +1,125 @@
+#include "Symbol.h"
+#include "../CK2World/Contention.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+const parsing::Symbol::Entry emptySymbol("", 0);
+CK2::Contention::Site symbolTableWaits("symbol table");
+
+// IDs carry their shard in the low bits and their position in it above them, counting from 1 so that 0 stays the
+// empty symbol's.
+constexpr std::uint32_t shardBits = 4;
+constexpr std::uint32_t shardCount = 1U << shardBits;
+
+class SymbolShard
+{
+  public:
+	const parsing::Symbol::Entry* intern(const std::string_view text, const std::uint32_t shard)
+	{
+		{
+			const auto lock = CK2::lockAt<std::shared_lock<std::shared_mutex>>(symbolTableWaits, mutex);
+			if (const auto entry = index.find(text); entry != index.end())
+				return entry->second;
+		}
+		const auto lock = CK2::lockAt<std::unique_lock<std::shared_mutex>>(symbolTableWaits, mutex);
+		if (const auto entry = index.find(text); entry != index.end()) // someone else may have won the race
+			return entry->second;
+		const auto position = static_cast<std::uint32_t>(entries.size()) + 1;
+		if (position >= 1U << (32 - shardBits))
+			throw std::length_error("Out of symbol IDs.");
+		const auto& stored = entries.emplace_back(text, position << shardBits | shard);
+		index.emplace(stored.text, &stored);
+		return &stored;
+	}
+
+	[[nodiscard]] const parsing::Symbol::Entry* at(const std::uint32_t position)
+	{
+		const auto lock = CK2::lockAt<std::shared_lock<std::shared_mutex>>(symbolTableWaits, mutex);
+		if (position == 0 || position > entries.size())
+			return nullptr;
+		return &entries[position - 1];
+	}
+
+	std::shared_mutex mutex;
+	std::deque<parsing::Symbol::Entry> entries; // never moves its elements, the Symbols point straight into it
+	std::unordered_map<std::string_view, const parsing::Symbol::Entry*> index;
+};
+
+class SymbolTable
+{
+  public:
+	const parsing::Symbol::Entry* intern(const std::string_view text)
+	{
+		if (text.empty())
+			return &emptySymbol;
+		// The top bits, as the shards' own maps bucket by the low ones.
+		const auto hash = std::hash<std::string_view>()(text);
+		const auto shard = static_cast<std::uint32_t>(hash >> (sizeof(hash) * 8 - shardBits));
+		return shards[shard].intern(text, shard);
+	}
+
+	[[nodiscard]] const parsing::Symbol::Entry* at(const std::uint32_t id)
+	{
+		if (id == 0)
+			return &emptySymbol;
+		return shards[id & (shardCount - 1)].at(id >> shardBits);
+	}
+
+	void renumber()
+	{
+		if (renumbered.exchange(true))
+			return;
+		std::vector<std::unique_lock<std::shared_mutex>> locks;
+		std::vector<parsing::Symbol::Entry*> all;
+		for (auto& shard: shards)
+		{
+			locks.emplace_back(CK2::lockAt<std::unique_lock<std::shared_mutex>>(symbolTableWaits, shard.mutex));
+			for (auto& entry: shard.entries)
+				all.emplace_back(&entry);
+		}
+		std::ranges::sort(all, {}, &parsing::Symbol::Entry::text);
+		std::uint32_t ordinal = 0;
+		for (auto* entry: all)
+			entry->ordinal.store(++ordinal, std::memory_order_relaxed);
+	}
+
+  private:
+	std::array<SymbolShard, shardCount> shards;
+	std::atomic<bool> renumbered = false;
+};
+
+SymbolTable& symbolTable()
+{
+	static SymbolTable table;
+	return table;
+}
+} // namespace
+
+parsing::Symbol::Symbol(): entry(&emptySymbol)
+{
+}
+
+parsing::Symbol::Symbol(const std::string_view text): entry(symbolTable().intern(text))
+{
+}
+
+parsing::Symbol parsing::Symbol::fromID(const std::uint32_t id)
+{
+	const auto* found = symbolTable().at(id);
+	if (!found)
+		throw std::out_of_range("No symbol has ID " + std::to_string(id));
+	return Symbol(found);
+}
+
+void parsing::Symbol::renumber()
+{
+	symbolTable().renumber();
+}
@@ -0,0 +1,87 @@
+#ifndef PARSING_SYMBOL_H
+#define PARSING_SYMBOL_H
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace parsing
+{
+// An interned identifier: culture, religion, government, law, building... A save repeats a few hundred of these
+// across millions of fields, so each distinct spelling is stored once in a process-wide table and a Symbol is just
+// a pointer to it. Two Symbols are equal exactly when they point at the same entry, which turns the usual
+// law == "primogeniture" into a pointer compare when both sides are Symbols.
+//
+// Symbols never die; the table only grows. It is split into shards by hash, each with a lock of its own, so the
+// parsing threads interning side by side seldom wait on each other, and looking a spelling up allocates nothing.
+class Symbol
+{
+  public:
+	// The table's record of one spelling. Never moves once interned.
+	struct Entry
+	{
+		Entry(const std::string_view theText, const std::uint32_t theID): text(theText), id(theID) {}
+
+		const std::string text;
+		const std::uint32_t id;
+		std::atomic<std::uint32_t> ordinal = 0; // by spelling, 0 until renumber()
+	};
+
+	Symbol();
+	explicit Symbol(std::string_view text);
+
+	// The symbol whose id() this is, the empty one for 0. Throws std::out_of_range for IDs never handed out.
+	[[nodiscard]] static Symbol fromID(std::uint32_t id);
+	// Numbers every symbol interned so far in spelling order, so that comparing two of them compares two numbers.
+	// Meant for when the parsing is done. Only the first call numbers anything: an ordinal never changes once given,
+	// so comparisons on other threads meanwhile stay consistent, and symbols interned later compare by spelling.
+	static void renumber();
+
+	[[nodiscard]] const std::string& str() const { return entry->text; }
+	[[nodiscard]] std::string_view view() const { return entry->text; }
+	[[nodiscard]] bool empty() const { return entry->text.empty(); }
+	// Stable for as long as the process runs, but handed out in interning order, which the threads' interleaving
+	// decides. Good for lookups and compact tables, never for ordering anything that gets written out.
+	[[nodiscard]] std::uint32_t id() const { return entry->id; }
+	// Where renumber() put the symbol in spelling order, counting from 1. 0 before it has run and for symbols interned
+	// since, which is what sends comparisons back to the spelling.
+	[[nodiscard]] std::uint32_t ordinal() const { return entry->ordinal.load(std::memory_order_relaxed); }
+	operator const std::string&() const { return entry->text; }
+
+	// The same spelling, interned or not. Ordering is by spelling so sets and maps of Symbols iterate the same way
+	// every run.
+	friend bool operator==(const Symbol& lhs, const Symbol& rhs) { return lhs.entry == rhs.entry; }
+	friend bool operator==(const Symbol& lhs, const std::string_view rhs) { return lhs.entry->text == rhs; }
+	friend bool operator==(const Symbol& lhs, const std::string& rhs) { return lhs.entry->text == rhs; }
+	friend bool operator==(const Symbol& lhs, const char* rhs) { return lhs.entry->text == rhs; }
+	friend std::strong_ordering operator<=>(const Symbol& lhs, const Symbol& rhs)
+	{
+		if (lhs.entry == rhs.entry)
+			return std::strong_ordering::equal;
+		const auto lhsOrdinal = lhs.entry->ordinal.load(std::memory_order_relaxed);
+		const auto rhsOrdinal = rhs.entry->ordinal.load(std::memory_order_relaxed);
+		if (lhsOrdinal && rhsOrdinal)
+			return lhsOrdinal <=> rhsOrdinal;
+		return lhs.entry->text <=> rhs.entry->text;
+	}
+	friend std::strong_ordering operator<=>(const Symbol& lhs, const std::string_view rhs) { return std::string_view(lhs.entry->text) <=> rhs; }
+	friend std::ostream& operator<<(std::ostream& output, const Symbol& symbol) { return output << symbol.entry->text; }
+
+  private:
+	friend struct std::hash<Symbol>;
+
+	explicit Symbol(const Entry* theEntry): entry(theEntry) {}
+
+	const Entry* entry;
+};
+} // namespace parsing
+
+template <> struct std::hash<parsing::Symbol>
+{
+	std::size_t operator()(const parsing::Symbol& symbol) const noexcept { return std::hash<const parsing::Symbol::Entry*>()(symbol.entry); }
+};
+
+#endif // PARSING_SYMBOL_H
@@ -0,0 +1,56 @@
+#include "TokenMatcher.h"
+
+parsing::TokenMatcher parsing::TokenMatcher::digits()
+{
+	return characters("0123456789");
+}
+
+parsing::TokenMatcher parsing::TokenMatcher::characters(const std::string_view allowed)
+{
+	return prefixed({}, allowed);
+}
+
+parsing::TokenMatcher parsing::TokenMatcher::prefixed(const std::vector<std::string>& prefixes, const std::string_view allowed)
+{
+	TokenMatcher matcher;
+	matcher.prefixes = prefixes;
+	for (const auto character: allowed)
+		matcher.tail.set(static_cast<unsigned char>(character));
+	return matcher;
+}
+
+parsing::TokenMatcher parsing::TokenMatcher::regex(const std::string& pattern)
+{
+	TokenMatcher matcher;
+	matcher.fallback = std::regex(pattern);
+	return matcher;
+}
+
+bool parsing::TokenMatcher::matches(const std::string_view token) const
+{
+	if (fallback)
+		return std::regex_match(token.begin(), token.end(), *fallback);
+
+	std::size_t position = 0;
+	if (!prefixes.empty())
+	{
+		auto found = false;
+		for (const auto& prefix: prefixes)
+			if (token.starts_with(prefix))
+			{
+				position = prefix.size();
+				found = true;
+				break;
+			}
+		if (!found)
+			return false;
+	}
+
+	// Tail needs at least one character, same as the + in the regexes we replace.
+	if (position >= token.size())
+		return false;
+	for (; position < token.size(); ++position)
+		if (!tail.test(static_cast<unsigned char>(token[position])))
+			return false;
+	return true;
+}
@@ -0,0 +1,41 @@
+#ifndef PARSING_TOKEN_MATCHER_H
+#define PARSING_TOKEN_MATCHER_H
+#include <bitset>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+// Classifies keys by shape with plain character checks: "all digits", "prefix followed by identifier
+// characters", "only these characters". Saves are millions of keys like 12345 or b_london; running
+// std::regex_match on each of those is a visible slice of parse time. Anything more involved can still
+// fall back to a regex.
+class TokenMatcher
+{
+  public:
+	// [A-Za-z0-9_-], the usual tail of title, barony and building keys.
+	static constexpr std::string_view identifierCharacters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-";
+
+	// \d+
+	[[nodiscard]] static TokenMatcher digits();
+	// [allowed]+
+	[[nodiscard]] static TokenMatcher characters(std::string_view allowed);
+	// (prefix1|prefix2|...)[allowed]+
+	[[nodiscard]] static TokenMatcher prefixed(const std::vector<std::string>& prefixes, std::string_view allowed = identifierCharacters);
+	[[nodiscard]] static TokenMatcher regex(const std::string& pattern);
+
+	[[nodiscard]] bool matches(std::string_view token) const;
+
+  private:
+	TokenMatcher() = default;
+
+	std::vector<std::string> prefixes;
+	std::bitset<256> tail;
+	std::optional<std::regex> fallback;
+};
+} // namespace parsing
+
+#endif // PARSING_TOKEN_MATCHER_H
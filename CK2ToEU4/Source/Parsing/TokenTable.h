@@ -0,0 +1,103 @@
+#ifndef PARSING_TOKEN_TABLE_H
+#define PARSING_TOKEN_TABLE_H
+#include "KeywordIndex.h"
+#include "Log.h"
+#include "TokenMatcher.h"
+#include "Tokenizer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+// KeywordTable's counterpart for input that's already in memory: handlers get a Tokenizer instead of an istream
+// and read their values as views. Used for game and mod files, which are small enough to read whole and numerous
+// enough that the stream lexer's per-character overhead shows.
+//
+// Usage: static const auto tokenTable = registerKeys(); tokenTable.parse(*this, tokens);
+template <typename Entity> class TokenTable
+{
+  public:
+	using Handler = void (*)(Entity& entity, std::string_view keyword, Tokenizer& tokens);
+
+	void registerKeyword(const std::string& keyword, Handler handler) { keywords.insert(keyword, handler); }
+	void registerMatcher(TokenMatcher matcher, Handler handler) { matchers.emplace_back(std::move(matcher), handler); }
+	void ignoreUnregistered() { ignoreLeftovers = true; }
+
+	// Parses a block ("= { ... }" or "{ ... }") or, at top level, everything up to the end of the buffer.
+	void parse(Entity& entity, Tokenizer& tokens) const;
+	void parseFile(Entity& entity, const std::string& filename) const;
+
+  private:
+	[[nodiscard]] bool dispatch(Entity& entity, std::string_view keyword, Tokenizer& tokens) const;
+
+	KeywordIndex<Handler> keywords;
+	std::vector<std::pair<TokenMatcher, Handler>> matchers;
+	bool ignoreLeftovers = false;
+};
+
+template <typename Entity> void TokenTable<Entity>::parse(Entity& entity, Tokenizer& tokens) const
+{
+	using TokenType = Tokenizer::TokenType;
+	auto braceDepth = 0;
+	auto value = false;
+	while (true)
+	{
+		const auto token = tokens.next();
+		switch (token.type)
+		{
+			case TokenType::END:
+				return;
+			case TokenType::EQUALS:
+				// Only the leading = of "= { ... }" is expected, same as KeywordTable.
+				if (value)
+					return;
+				value = true;
+				break;
+			case TokenType::OPEN:
+				++braceDepth;
+				break;
+			case TokenType::CLOSE:
+				--braceDepth;
+				if (braceDepth == 0)
+					return;
+				break;
+			case TokenType::WORD:
+			case TokenType::QUOTED:
+				if (!dispatch(entity, token.text, tokens) && ignoreLeftovers)
+					tokens.skipItem();
+				break;
+		}
+	}
+}
+
+template <typename Entity> void TokenTable<Entity>::parseFile(Entity& entity, const std::string& filename) const
+{
+	const auto contents = readFile(filename);
+	if (!contents)
+	{
+		Log(LogLevel::Error) << "Could not open " << filename << " for parsing.";
+		return;
+	}
+	Tokenizer tokens(*contents);
+	parse(entity, tokens);
+}
+
+template <typename Entity> bool TokenTable<Entity>::dispatch(Entity& entity, const std::string_view keyword, Tokenizer& tokens) const
+{
+	if (const auto* handler = keywords.find(keyword))
+	{
+		(*handler)(entity, keyword, tokens);
+		return true;
+	}
+	for (const auto& [matcher, handler]: matchers)
+		if (matcher.matches(keyword))
+		{
+			handler(entity, keyword, tokens);
+			return true;
+		}
+	return false;
+}
+} // namespace parsing
+
+#endif // PARSING_TOKEN_TABLE_H
@@ -0,0 +1,156 @@
+#include "Tokenizer.h"
+#include "ByteScan.h"
+#include "ItemSkipper.h"
+#include "Log.h"
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+parsing::Tokenizer::Token parsing::Tokenizer::peek() const
+{
+	auto at = position;
+	return read(at);
+}
+
+parsing::Tokenizer::Token parsing::Tokenizer::read(std::size_t& at) const
+{
+	const auto* const begin = buffer.data();
+	const auto* const end = begin + buffer.size();
+	const auto* current = begin + at;
+
+	while (true)
+	{
+		current = scan::skipSpaces(current, end);
+		if (current == end || *current != '#')
+			break;
+		current = scan::find(current, end, '\n');
+	}
+	if (current == end)
+	{
+		at = buffer.size();
+		return {};
+	}
+
+	Token token;
+	const auto* tokenEnd = current + 1;
+	switch (*current)
+	{
+		case '=':
+			token.type = TokenType::EQUALS;
+			token.text = std::string_view(current, 1);
+			break;
+		case '{':
+			token.type = TokenType::OPEN;
+			token.text = std::string_view(current, 1);
+			break;
+		case '}':
+			token.type = TokenType::CLOSE;
+			token.text = std::string_view(current, 1);
+			break;
+		case '"':
+		{
+			const auto* closingQuote = scan::find(current + 1, end, '"');
+			token.type = TokenType::QUOTED;
+			token.text = std::string_view(current + 1, static_cast<std::size_t>(closingQuote - current - 1));
+			tokenEnd = closingQuote < end ? closingQuote + 1 : end;
+			break;
+		}
+		default:
+			tokenEnd = scan::findWordEnd(current, end);
+			token.type = TokenType::WORD;
+			token.text = std::string_view(current, static_cast<std::size_t>(tokenEnd - current));
+	}
+	at = static_cast<std::size_t>(tokenEnd - begin);
+	return token;
+}
+
+std::string_view parsing::Tokenizer::getString()
+{
+	// Same as singleString: whatever token follows the =, even a brace.
+	auto token = next();
+	if (token.type == TokenType::EQUALS)
+		token = next();
+	return token.text;
+}
+
+int parsing::Tokenizer::getInt()
+{
+	const auto value = getString();
+	// from_chars won't take the leading + that stoi accepts.
+	const auto digits = value.starts_with('+') ? value.substr(1) : value;
+	auto result = 0;
+	if (const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), result); error != std::errc())
+	{
+		Log(LogLevel::Warning) << "Expected an int, but instead got " << value;
+		return 0;
+	}
+	return result;
+}
+
+std::vector<std::string_view> parsing::Tokenizer::getStrings()
+{
+	std::vector<std::string_view> strings;
+	if (peek().type == TokenType::EQUALS)
+		next();
+	if (peek().type != TokenType::OPEN)
+	{
+		if (const auto value = getString(); !value.empty())
+			strings.emplace_back(value);
+		return strings;
+	}
+
+	next();
+	while (true)
+	{
+		switch (peek().type)
+		{
+			case TokenType::WORD:
+			case TokenType::QUOTED:
+				strings.emplace_back(next().text);
+				break;
+			case TokenType::OPEN:
+				skipItem();
+				break;
+			case TokenType::EQUALS:
+				next();
+				break;
+			case TokenType::CLOSE:
+				next();
+				return strings;
+			case TokenType::END:
+				return strings;
+		}
+	}
+}
+
+std::string_view parsing::Tokenizer::getItem()
+{
+	const auto start = position;
+	skipItem();
+	return buffer.substr(start, position - start);
+}
+
+void parsing::Tokenizer::skipItem()
+{
+	position += ItemSkipper::measure(buffer.substr(position));
+}
+
+std::optional<std::string> parsing::readFile(const std::string& filename)
+{
+	std::ifstream theFile(std::filesystem::u8path(filename), std::ios::binary);
+	if (!theFile.is_open())
+		return std::nullopt;
+	std::ostringstream contents;
+	contents << theFile.rdbuf();
+	auto text = std::move(contents).str();
+	if (text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+		text.erase(0, 3);
+	return text;
+}
+
+std::string parsing::readStream(std::istream& theStream)
+{
+	return {std::istreambuf_iterator<char>(theStream), std::istreambuf_iterator<char>()};
+}
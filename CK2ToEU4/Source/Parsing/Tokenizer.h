@@ -0,0 +1,61 @@
+#ifndef PARSING_TOKENIZER_H
+#define PARSING_TOKENIZER_H
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parsing
+{
+// Lexer for the Clausewitz text format working over a buffer we already hold in memory.
+// commonItems::getNextLexeme reads an istream one character at a time and hands out fresh strings;
+// this one finds token boundaries with the byte scans in ByteScan.h and hands out views into the buffer.
+// Views stay valid as long as the buffer does, handlers that keep a value copy it.
+class Tokenizer
+{
+  public:
+	enum class TokenType
+	{
+		END,
+		EQUALS,
+		OPEN,
+		CLOSE,
+		WORD,
+		QUOTED // text excludes the quotes
+	};
+	struct Token
+	{
+		TokenType type = TokenType::END;
+		std::string_view text;
+	};
+
+	explicit Tokenizer(std::string_view theBuffer): buffer(theBuffer) {}
+
+	Token next() { return read(position); }
+	[[nodiscard]] Token peek() const;
+
+	// Helpers mirroring commonItems::singleString, singleInt and stringList, each reading one "= value" item.
+	[[nodiscard]] std::string_view getString();
+	[[nodiscard]] int getInt();
+	[[nodiscard]] std::vector<std::string_view> getStrings();
+	// Raw text of the next item, for handing it to a stream-based parser.
+	[[nodiscard]] std::string_view getItem();
+	void skipItem();
+
+	[[nodiscard]] bool atEnd() const { return peek().type == TokenType::END; }
+
+  private:
+	[[nodiscard]] Token read(std::size_t& at) const;
+
+	std::string_view buffer;
+	std::size_t position = 0;
+};
+
+// Whole file contents with any UTF-8 BOM dropped, nullopt if it can't be opened.
+[[nodiscard]] std::optional<std::string> readFile(const std::string& filename);
+// Everything left in the stream, for the istream entry points kept around for tests.
+[[nodiscard]] std::string readStream(std::istream& theStream);
+} // namespace parsing
+
+#endif // PARSING_TOKENIZER_H
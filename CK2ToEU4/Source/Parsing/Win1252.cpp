@@ -0,0 +1,81 @@
+#include "Win1252.h"
+#include "ByteScan.h"
+#include <array>
+
+namespace
+{
+// Where 0x80-0x9F land in 1252; 0xA0-0xFF are Latin-1 and land on themselves.
+constexpr std::array<char16_t, 32> specials = {
+	 0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	 0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178};
+
+struct Encoded
+{
+	char bytes[3];
+	unsigned char length;
+};
+
+constexpr std::array<Encoded, 128> encodeHighBytes()
+{
+	std::array<Encoded, 128> table{};
+	for (unsigned byte = 0x80; byte <= 0xFF; ++byte)
+	{
+		const char16_t codePoint = byte < 0xA0 ? specials[byte - 0x80] : static_cast<char16_t>(byte);
+		auto& encoded = table[byte - 0x80];
+		if (codePoint < 0x800)
+		{
+			encoded.bytes[0] = static_cast<char>(0xC0 | codePoint >> 6);
+			encoded.bytes[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			encoded.length = 2;
+		}
+		else
+		{
+			encoded.bytes[0] = static_cast<char>(0xE0 | codePoint >> 12);
+			encoded.bytes[1] = static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+			encoded.bytes[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			encoded.length = 3;
+		}
+	}
+	return table;
+}
+constexpr auto highBytes = encodeHighBytes();
+
+// First byte at or above 0x80 in [position, end), or end.
+const char* findHighByte(const char* position, const char* const end)
+{
+#ifdef PARSING_BYTE_SCAN_SSE2
+	for (; end - position >= 16; position += 16)
+		if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(parsing::scan::load(position))); mask != 0)
+			return position + std::countr_zero(mask);
+#endif
+	while (position < end && static_cast<unsigned char>(*position) < 0x80)
+		++position;
+	return position;
+}
+} // namespace
+
+void parsing::appendWin1252AsUTF8(std::string& output, const std::string_view text)
+{
+	output.reserve(output.size() + text.size());
+	const auto* position = text.data();
+	const auto* const end = text.data() + text.size();
+	while (position < end)
+	{
+		const auto* const high = findHighByte(position, end);
+		output.append(position, high);
+		if (high == end)
+			break;
+		const auto& encoded = highBytes[static_cast<unsigned char>(*high) - 0x80];
+		output.append(encoded.bytes, encoded.length);
+		position = high + 1;
+	}
+}
+
+std::string parsing::win1252ToUTF8(const std::string_view text)
+{
+	std::string output;
+	appendWin1252AsUTF8(output, text);
+	return output;
+}
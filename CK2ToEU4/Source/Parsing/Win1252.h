@@ -0,0 +1,20 @@
+#ifndef PARSING_WIN1252_H
+#define PARSING_WIN1252_H
+#include <string>
+#include <string_view>
+
+namespace parsing
+{
+// Windows-1252 to UTF-8 for everything the converter writes out of save text. commonItems::convertWin1252ToUTF8
+// goes through the platform (iconv or MultiByteToWideChar and back) and allocates on every call, which the
+// localisation writer used to pay once per entry per language. Here a whole buffer goes through at once: runs of
+// ASCII, which is nearly all of it, are found 16 bytes at a time and copied as they are, and the rest is looked up
+// in a table of the 128 high bytes already encoded.
+//
+// The five bytes 1252 leaves undefined (0x81, 0x8D, 0x8F, 0x90, 0x9D) come out as the C1 controls of the same
+// value, as they do on Windows.
+void appendWin1252AsUTF8(std::string& output, std::string_view text);
+[[nodiscard]] std::string win1252ToUTF8(std::string_view text);
+} // namespace parsing
+
+#endif // PARSING_WIN1252_H
@@ -1,19 +1,77 @@
 #include "CK2ToEU4Converter.h"
 #include "Log.h"
 #include <fstream>
+#include <stdexcept>
 
 int main(const int argc, const char* argv[])
 {
 	try
 	{
-		std::ofstream clearLog("log.txt");
-		clearLog.close();
+		// A save prepared in the background logs along with whoever started it.
+		const auto preparingSave = argc == 3 && std::string(argv[1]) == "--prepare-save";
+		if (!preparingSave)
+		{
+			std::ofstream clearLog("log.txt");
+			clearLog.close();
+		}
 		commonItems::ConverterVersion converterVersion;
 		converterVersion.loadVersion("configurables/version.txt");
 		Log(LogLevel::Info) << converterVersion;
+		if (preparingSave)
+		{
+			prepareSave(converterVersion, argv[2]);
+			return 0;
+		}
+		if (argc == 3 && std::string(argv[1]) == "--prepare")
+		{
+			prepareSaves(argv[0], argv[2]);
+			return 0;
+		}
+		if (argc == 3 && std::string(argv[1]) == "--batch")
+		{
+			convertBatch(converterVersion, argv[2]);
+			return 0;
+		}
+		if (argc >= 3 && argc <= 6 && std::string(argv[1]) == "--watch")
+		{
+			std::optional<std::uint16_t> metricsPort;
+			std::optional<std::string> savesFolder;
+			auto argument = 3;
+			if (argument < argc && std::string(argv[argument]) != "--prepare")
+			{
+				const auto port = std::stoi(argv[argument]);
+				if (port < 1 || port > 65535)
+					throw std::runtime_error(std::string("No such port: ") + argv[argument]);
+				metricsPort = static_cast<std::uint16_t>(port);
+				++argument;
+			}
+			if (argument + 2 == argc && std::string(argv[argument]) == "--prepare")
+				savesFolder = argv[argument + 1];
+			else if (argument != argc)
+				throw std::runtime_error("--watch takes <jobs folder> [metrics port] [--prepare <saves folder>].");
+			serveConversions(converterVersion, argv[2], metricsPort, argv[0], savesFolder);
+			return 0;
+		}
+		if (argc == 3 && std::string(argv[1]) == "--inspect")
+		{
+			describeSave(argv[2]);
+			return 0;
+		}
+		if (argc == 5 && std::string(argv[1]) == "--query")
+		{
+			querySave(argv[2], argv[3], argv[4]);
+			return 0;
+		}
+		if ((argc == 3 || (argc == 5 && std::string(argv[3]) == "--from")) && std::string(argv[1]) == "--stop-after")
+		{
+			convertCK2ToEU4(converterVersion, argc == 5 ? argv[4] : "", argv[2]);
+			return 0;
+		}
 		if (argc >= 2)
 		{
-			Log(LogLevel::Info) << "CK2ToEU4 takes no parameters.";
+			Log(LogLevel::Info) << "CK2ToEU4 takes no parameters but --batch <jobs file>, --watch <jobs folder> [metrics port] [--prepare <saves folder>],";
+			Log(LogLevel::Info) << "--prepare <saves folder>, --inspect <save>, --query <save> character|title|province <key>";
+			Log(LogLevel::Info) << "or --stop-after <phase> [--from <phase>].";
 			Log(LogLevel::Info) << "It uses configuration.txt, configured manually or by the frontend.";
 		}
 		convertCK2ToEU4(converterVersion);
@@ -0,0 +1,87 @@
+#include "../CK2ToEU4/Source/CK2World/Characters/Character.h"
+#include "../CK2ToEU4/Source/CK2World/Characters/Characters.h"
+#include "../CK2ToEU4/Source/CK2World/Provinces/Province.h"
+#include "../CK2ToEU4/Source/CK2World/Titles/Title.h"
+#include "../CK2ToEU4/Source/CK2World/Titles/Titles.h"
+#include "Fixtures.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+
+namespace
+{
+// Parses the same entity over and over; bytes are the entity's own text, so MB/s compares across entity kinds.
+template <typename Entity, typename Key> void parseEntity(benchmark::State& state, const std::string& text, const Key& key)
+{
+	for (auto _: state)
+	{
+		std::istringstream input(text);
+		const Entity entity(input, key);
+		benchmark::DoNotOptimize(&entity);
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+void BM_Character(benchmark::State& state)
+{
+	parseEntity<CK2::Character>(state, fixtures::character(42), 42);
+}
+BENCHMARK(BM_Character);
+
+void BM_Title(benchmark::State& state)
+{
+	parseEntity<CK2::Title>(state, fixtures::title(42), std::string("c_test42"));
+}
+BENCHMARK(BM_Title);
+
+void BM_Province(benchmark::State& state)
+{
+	parseEntity<CK2::Province>(state, fixtures::province(42), 42);
+}
+BENCHMARK(BM_Province);
+
+void BM_Characters(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto block = fixtures::characters(count);
+	for (auto _: state)
+	{
+		std::istringstream input(block);
+		const CK2::Characters characters(input);
+		benchmark::DoNotOptimize(characters.getCharacters().size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(block.size()));
+}
+BENCHMARK(BM_Characters)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+// The save loader's path: the block is carved into shards and parsed in place, details decoding on demand.
+void BM_CharactersSharded(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto block = fixtures::characters(count);
+	for (auto _: state)
+	{
+		const CK2::Characters characters(block, static_cast<std::size_t>(state.range(1)));
+		benchmark::DoNotOptimize(characters.getCharacters().size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(block.size()));
+}
+BENCHMARK(BM_CharactersSharded)->Args({20000, 1})->Args({20000, 8})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_Titles(benchmark::State& state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	const auto block = fixtures::titles(count);
+	for (auto _: state)
+	{
+		std::istringstream input(block);
+		const CK2::Titles titles(input);
+		benchmark::DoNotOptimize(titles.getTitles().size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(block.size()));
+}
+BENCHMARK(BM_Titles)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+} // namespace
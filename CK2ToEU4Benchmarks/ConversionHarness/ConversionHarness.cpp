@@ -0,0 +1,445 @@
+#include "ConversionHarness.h"
+#include "../SaveGenerator/SaveGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+std::vector<fs::path> gatherCorpus(const harness::Settings& settings)
+{
+	std::vector<fs::path> saves;
+	if (!settings.corpusFolder.empty())
+	{
+		for (const auto& entry: fs::directory_iterator(fs::u8path(settings.corpusFolder)))
+			if (entry.is_regular_file() && entry.path().extension() == ".ck2" && entry.path().stem().string().rfind("synthetic_", 0) != 0)
+				saves.emplace_back(entry.path());
+		std::sort(saves.begin(), saves.end());
+	}
+
+	// Synthetic saves are regenerated every run, so a generator change can't leave a stale one behind.
+	const auto syntheticFolder = settings.corpusFolder.empty() ? fs::temp_directory_path() : fs::u8path(settings.corpusFolder);
+	for (const auto scale: settings.syntheticScales)
+	{
+		const auto path = syntheticFolder / ("synthetic_x" + std::to_string(scale) + ".ck2");
+		std::ofstream output(path, std::ios::binary);
+		if (!output.is_open())
+			throw std::runtime_error("Could not create " + path.string());
+		generator::writeGamestate(generator::Scale().times(scale), output);
+		saves.emplace_back(path);
+	}
+	return saves;
+}
+
+std::string readFile(const fs::path& path)
+{
+	std::ifstream input(path, std::ios::binary);
+	if (!input.is_open())
+		throw std::runtime_error("Could not open " + path.string());
+	std::stringstream contents;
+	contents << input.rdbuf();
+	return contents.str();
+}
+
+// Later keys win in configuration.txt, so the overrides simply go after the base configuration.
+void writeConfiguration(const fs::path& target,
+	 const std::string& baseConfiguration,
+	 const fs::path& save,
+	 const std::string& snapshot,
+	 const std::optional<std::size_t> threads)
+{
+	std::ofstream output(target, std::ios::binary);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + target.string());
+	output << baseConfiguration << "\n";
+	output << "SaveGame = \"" << fs::absolute(save).string() << "\"\n";
+	output << "snapshot = \"" << snapshot << "\"\n";
+	output << "timings = \"2\"\n";
+	if (threads)
+		output << "threads = \"" << *threads << "\"\n";
+	output << "output_name = \"perf_" << save.stem().string() << "\"\n";
+}
+
+// snapshot is the configuration's value: 1 to use and keep one, 2 to parse the save whatever there is.
+nlohmann::json convert(const harness::Settings& settings,
+	 const std::string& baseConfiguration,
+	 const fs::path& save,
+	 const std::string& snapshot,
+	 const std::optional<std::size_t> threads)
+{
+	const auto converterFolder = fs::u8path(settings.converterFolder);
+	const auto timingsPath = converterFolder / "timings.json";
+	fs::remove(timingsPath);
+	writeConfiguration(converterFolder / "configuration.txt", baseConfiguration, save, snapshot, threads);
+
+	std::cout << "Converting " << save.filename().string();
+	if (threads)
+		std::cout << " on " << *threads << " threads";
+	std::cout << std::endl;
+#ifdef _WIN32
+	const auto command = "cd /d \"" + converterFolder.string() + "\" && CK2ToEU4Converter.exe > NUL";
+#else
+	const auto command = "cd \"" + converterFolder.string() + "\" && ./CK2ToEU4Converter > /dev/null";
+#endif
+	if (std::system(command.c_str()) != 0 || !fs::exists(timingsPath))
+		throw std::runtime_error("Converting " + save.string() + " failed, see " + (converterFolder / "log.txt").string());
+
+	const auto timings = nlohmann::json::parse(readFile(timingsPath));
+	nlohmann::json run;
+	run["peakResidentKB"] = timings.at("peakResidentKB");
+	run["phases"] = nlohmann::json::object();
+	auto totalSeconds = 0.0;
+	std::optional<double> timeToFirstParse;
+	for (const auto& phase: timings.at("phases"))
+	{
+		totalSeconds += phase.at("wallSeconds").get<double>();
+		if (!timeToFirstParse && phase.at("name") == "Importing Save")
+			timeToFirstParse = totalSeconds;
+
+		// A phase can repeat (the EU4 side has conditional ones); its runs add up.
+		auto& recorded = run["phases"][phase.at("name").get<std::string>()];
+		if (recorded.is_null())
+			recorded = {{"wallSeconds", 0.0}, {"cpuSeconds", 0.0}};
+		recorded["wallSeconds"] = recorded["wallSeconds"].get<double>() + phase.at("wallSeconds").get<double>();
+		recorded["cpuSeconds"] = recorded["cpuSeconds"].get<double>() + phase.at("cpuSeconds").get<double>();
+	}
+	run["timeToFirstParseSeconds"] = timeToFirstParse.value_or(totalSeconds);
+	run["totalSeconds"] = totalSeconds;
+	return run;
+}
+
+// Whatever the converter has cached, and where the platform lets us, whatever the OS has of the files it reads.
+void startCold(const fs::path& converterFolder)
+{
+	fs::remove_all(converterFolder / "snapshots");
+#ifdef __linux__
+	static auto warned = false;
+	std::ofstream dropCaches("/proc/sys/vm/drop_caches");
+	if (std::system("sync") == 0 && dropCaches.is_open() && (dropCaches << "1" << std::flush))
+		return;
+	if (!warned)
+		std::cout << "Can't drop the page cache without root, cold runs only start without the converter's caches" << std::endl;
+	warned = true;
+#endif
+}
+
+std::string describe(const nlohmann::json& run)
+{
+	std::ostringstream text;
+	text.precision(2);
+	text << std::fixed << run.at("timeToFirstParseSeconds").get<double>() << " s to first parse, " << run.at("totalSeconds").get<double>() << " s in all, "
+		  << run.at("peakResidentKB").get<std::size_t>() / 1024 << " MB peak";
+	return text.str();
+}
+
+// "synthetic_x4" and "synthetic_x4 (warm)" are scale 4, in the default and the warm scenario.
+std::optional<std::pair<std::size_t, std::string>> syntheticScale(const std::string& save)
+{
+	const std::string prefix = "synthetic_x";
+	if (save.rfind(prefix, 0) != 0)
+		return std::nullopt;
+	std::size_t digits = 0;
+	const auto scale = std::stoull(save.substr(prefix.size()), &digits);
+	return std::pair(static_cast<std::size_t>(scale), save.substr(prefix.size() + digits));
+}
+
+// Least-squares slope of log y against log x.
+double logLogSlope(const std::vector<std::pair<double, double>>& points)
+{
+	auto meanX = 0.0;
+	auto meanY = 0.0;
+	for (const auto& [x, y]: points)
+	{
+		meanX += std::log(x);
+		meanY += std::log(y);
+	}
+	meanX /= static_cast<double>(points.size());
+	meanY /= static_cast<double>(points.size());
+	auto covariance = 0.0;
+	auto variance = 0.0;
+	for (const auto& [x, y]: points)
+	{
+		covariance += (std::log(x) - meanX) * (std::log(y) - meanY);
+		variance += (std::log(x) - meanX) * (std::log(x) - meanX);
+	}
+	return variance > 0 ? covariance / variance : 0;
+}
+
+std::string percent(const double before, const double after)
+{
+	std::ostringstream text;
+	text.precision(1);
+	text << std::fixed << (after / before - 1) * 100 << "%";
+	return text.str();
+}
+} // namespace
+
+nlohmann::json harness::runCorpus(const Settings& settings)
+{
+	const auto converterFolder = fs::u8path(settings.converterFolder);
+	const auto configurationPath = converterFolder / "configuration.txt";
+	const auto baseConfiguration = readFile(fs::u8path(settings.baseConfiguration));
+
+	// The converter only reads configuration.txt, so whatever was there goes back once the corpus is done.
+	std::optional<std::string> previousConfiguration;
+	if (fs::exists(configurationPath))
+		previousConfiguration = readFile(configurationPath);
+	const auto restoreConfiguration = [&configurationPath, &previousConfiguration] {
+		if (previousConfiguration)
+			std::ofstream(configurationPath, std::ios::binary) << *previousConfiguration;
+		else
+			fs::remove(configurationPath);
+	};
+
+	nlohmann::json results;
+	results["saves"] = nlohmann::json::object();
+	try
+	{
+		// No scenario and no thread count stand for a single run as the base configuration has it.
+		std::vector<std::optional<std::string>> scenarios(settings.scenarios.begin(), settings.scenarios.end());
+		if (scenarios.empty())
+			scenarios.emplace_back();
+		std::vector<std::optional<std::size_t>> threadCounts(settings.threadCounts.begin(), settings.threadCounts.end());
+		if (threadCounts.empty())
+			threadCounts.emplace_back();
+
+		for (const auto& save: gatherCorpus(settings))
+			for (const auto& scenario: scenarios)
+				for (const auto& threads: threadCounts)
+				{
+					if (scenario == "cold")
+						startCold(converterFolder);
+					auto run = convert(settings, baseConfiguration, save, scenario && scenario != "warm" ? "1" : "2", threads);
+					auto name = save.stem().string();
+					if (scenario)
+					{
+						std::cout << "  " << *scenario << ": " << describe(run) << std::endl;
+						name += " (" + *scenario + ")";
+					}
+					if (threads)
+					{
+						run["threads"] = *threads;
+						run["series"] = name;
+						name = save.stem().string() + " (" + (scenario ? *scenario + ", " : "") + std::to_string(*threads) + " threads)";
+					}
+					results["saves"][name] = std::move(run);
+				}
+	}
+	catch (...)
+	{
+		restoreConfiguration();
+		throw;
+	}
+	restoreConfiguration();
+	return results;
+}
+
+std::vector<std::string> harness::findRegressions(const nlohmann::json& baseline,
+	 const nlohmann::json& results,
+	 const double thresholdPercent,
+	 const double noiseFloorSeconds)
+{
+	std::vector<std::string> regressions;
+	const auto limit = 1 + thresholdPercent / 100;
+	if (!baseline.contains("saves") || !results.contains("saves"))
+		return regressions;
+
+	for (const auto& [save, run]: results.at("saves").items())
+	{
+		if (!baseline.at("saves").contains(save))
+			continue;
+		const auto& before = baseline.at("saves").at(save);
+
+		const auto peakBefore = before.value("peakResidentKB", 0.0);
+		const auto peakAfter = run.value("peakResidentKB", 0.0);
+		if (peakBefore > 0 && peakAfter > peakBefore * limit)
+			regressions.emplace_back(save + ": peak memory " + std::to_string(static_cast<std::size_t>(peakBefore) / 1024) + " MB -> " +
+											 std::to_string(static_cast<std::size_t>(peakAfter) / 1024) + " MB (+" + percent(peakBefore, peakAfter) + ")");
+
+		for (const auto* const time: {"timeToFirstParseSeconds", "totalSeconds"})
+		{
+			const auto secondsBefore = before.value(time, 0.0);
+			const auto secondsAfter = run.value(time, 0.0);
+			if (std::max(secondsBefore, secondsAfter) >= noiseFloorSeconds && secondsBefore > 0 && secondsAfter > secondsBefore * limit)
+				regressions.emplace_back(save + ": " + time + " " + std::to_string(secondsBefore) + " s -> " + std::to_string(secondsAfter) + " s (+" +
+												 percent(secondsBefore, secondsAfter) + ")");
+		}
+
+		if (!before.contains("phases") || !run.contains("phases"))
+			continue;
+		for (const auto& [phase, timing]: run.at("phases").items())
+		{
+			if (!before.at("phases").contains(phase))
+				continue;
+			const auto wallBefore = before.at("phases").at(phase).value("wallSeconds", 0.0);
+			const auto wallAfter = timing.value("wallSeconds", 0.0);
+			if (std::max(wallBefore, wallAfter) < noiseFloorSeconds || wallBefore <= 0)
+				continue;
+			if (wallAfter > wallBefore * limit)
+				regressions.emplace_back(save + ": " + phase + " " + std::to_string(wallBefore) + " s -> " + std::to_string(wallAfter) + " s (+" +
+												 percent(wallBefore, wallAfter) + ")");
+		}
+	}
+	return regressions;
+}
+
+nlohmann::json harness::fitGrowth(const nlohmann::json& results, const double noiseFloorSeconds, const double tolerance)
+{
+	// Seconds by scale, per phase and scenario.
+	std::map<std::string, std::map<std::size_t, double>> phaseSeconds;
+	if (results.contains("saves"))
+		for (const auto& [save, run]: results.at("saves").items())
+		{
+			const auto scale = syntheticScale(save);
+			if (!scale || !run.contains("phases"))
+				continue;
+			for (const auto& [phase, timing]: run.at("phases").items())
+				phaseSeconds[phase + scale->second][scale->first] = timing.value("wallSeconds", 0.0);
+		}
+
+	const auto characters = static_cast<double>(generator::Scale().characters);
+	auto growth = nlohmann::json::object();
+	for (const auto& [phase, seconds]: phaseSeconds)
+	{
+		if (seconds.size() < 2 || seconds.rbegin()->second < noiseFloorSeconds)
+			continue;
+		std::vector<std::pair<double, double>> measured;
+		std::vector<std::pair<double, double>> nLogN;
+		for (const auto& [scale, wallSeconds]: seconds)
+		{
+			const auto n = characters * static_cast<double>(scale);
+			nLogN.emplace_back(static_cast<double>(scale), n * std::log(n));
+			if (wallSeconds > 0)
+				measured.emplace_back(static_cast<double>(scale), wallSeconds);
+		}
+		if (measured.size() < 2)
+			continue;
+		const auto exponent = logLogSlope(measured);
+		const auto nLogNExponent = logLogSlope(nLogN);
+		auto& fit = growth[phase];
+		fit["exponent"] = exponent;
+		fit["nLogNExponent"] = nLogNExponent;
+		fit["superlinear"] = exponent > nLogNExponent + tolerance;
+		for (const auto& [scale, wallSeconds]: seconds)
+			fit["seconds"][std::to_string(scale)] = wallSeconds;
+	}
+	return growth;
+}
+
+std::vector<std::string> harness::findSuperlinearPhases(const nlohmann::json& growth)
+{
+	std::vector<std::pair<double, std::string>> steepest;
+	for (const auto& [phase, fit]: growth.items())
+		if (fit.value("superlinear", false))
+		{
+			std::ostringstream text;
+			text.precision(2);
+			text << std::fixed << phase << ": grows as n^" << fit.at("exponent").get<double>() << " against n log n's n^" << fit.at("nLogNExponent").get<double>()
+				  << " (";
+			auto first = true;
+			for (const auto& [scale, seconds]: fit.at("seconds").items())
+			{
+				text << (first ? "" : ", ") << "x" << scale << " " << seconds.get<double>() << " s";
+				first = false;
+			}
+			text << ")";
+			steepest.emplace_back(fit.at("exponent").get<double>(), text.str());
+		}
+	std::ranges::sort(steepest, std::greater<>());
+	std::vector<std::string> phases;
+	for (auto& phase: steepest | std::views::values)
+		phases.emplace_back(std::move(phase));
+	return phases;
+}
+
+nlohmann::json harness::fitThreadScaling(const nlohmann::json& results, const double noiseFloorSeconds)
+{
+	// Seconds by thread count, per phase of each series.
+	std::map<std::string, std::map<std::string, std::map<std::size_t, double>>> phaseSeconds;
+	if (results.contains("saves"))
+		for (const auto& run: results.at("saves"))
+		{
+			if (!run.contains("threads") || !run.contains("series") || !run.contains("phases"))
+				continue;
+			auto& series = phaseSeconds[run.at("series").get<std::string>()];
+			for (const auto& [phase, timing]: run.at("phases").items())
+				series[phase][run.at("threads").get<std::size_t>()] = timing.value("wallSeconds", 0.0);
+		}
+
+	auto scaling = nlohmann::json::object();
+	for (const auto& [series, phases]: phaseSeconds)
+		for (const auto& [phase, seconds]: phases)
+		{
+			const auto& [fewest, baseSeconds] = *seconds.begin();
+			if (seconds.size() < 2 || baseSeconds < noiseFloorSeconds)
+				continue;
+
+			// seconds = serial + parallel * (1 / threads), a straight line in 1 / threads.
+			auto meanX = 0.0;
+			auto meanY = 0.0;
+			for (const auto& [threads, wallSeconds]: seconds)
+			{
+				meanX += 1.0 / static_cast<double>(threads);
+				meanY += wallSeconds;
+			}
+			meanX /= static_cast<double>(seconds.size());
+			meanY /= static_cast<double>(seconds.size());
+			auto covariance = 0.0;
+			auto variance = 0.0;
+			for (const auto& [threads, wallSeconds]: seconds)
+			{
+				const auto x = 1.0 / static_cast<double>(threads) - meanX;
+				covariance += x * (wallSeconds - meanY);
+				variance += x * x;
+			}
+			const auto parallel = std::max(0.0, variance > 0 ? covariance / variance : 0);
+			const auto serial = std::max(0.0, meanY - parallel * meanX);
+
+			auto& fit = scaling[series][phase];
+			for (const auto& [threads, wallSeconds]: seconds)
+			{
+				fit["seconds"][std::to_string(threads)] = wallSeconds;
+				fit["speedup"][std::to_string(threads)] = wallSeconds > 0 ? baseSeconds / wallSeconds : 0;
+			}
+			fit["serialFraction"] = serial + parallel > 0 ? serial / (serial + parallel) : 1.0;
+			fit["serialSeconds"] = serial;
+		}
+	return scaling;
+}
+
+std::vector<std::string> harness::describeThreadScaling(const nlohmann::json& scaling)
+{
+	std::vector<std::pair<double, std::string>> bySerialTime;
+	for (const auto& [series, phases]: scaling.items())
+		for (const auto& [phase, fit]: phases.items())
+		{
+			// Thread counts in numeric order, the JSON object has them as text.
+			std::map<std::size_t, double> speedups;
+			for (const auto& [threads, speedup]: fit.at("speedup").items())
+				speedups.emplace(std::stoull(threads), speedup.get<double>());
+
+			std::ostringstream text;
+			text.precision(2);
+			text << std::fixed << series << ": " << phase << ": speedup";
+			for (const auto& [threads, speedup]: speedups)
+				text << " " << threads << "t " << speedup << "x";
+			text.precision(1);
+			text << ", " << fit.at("serialFraction").get<double>() * 100 << "% serial (" << fit.at("serialSeconds").get<double>() << " s)";
+			bySerialTime.emplace_back(fit.at("serialSeconds").get<double>(), text.str());
+		}
+	std::ranges::sort(bySerialTime, std::greater<>());
+	std::vector<std::string> lines;
+	for (auto& line: bySerialTime | std::views::values)
+		lines.emplace_back(std::move(line));
+	return lines;
+}
@@ -0,0 +1,72 @@
+#ifndef CK2TOEU4_CONVERSION_HARNESS_H
+#define CK2TOEU4_CONVERSION_HARNESS_H
+#include "nlohmann/json.hpp"
+#include <string>
+#include <vector>
+
+// Runs the converter over a corpus of saves and holds each run's phase timings and peak memory against a baseline.
+namespace harness
+{
+struct Settings
+{
+	std::string converterFolder;	// where CK2ToEU4Converter and its configurables live
+	std::string baseConfiguration; // a working configuration.txt; only the save, timings, snapshot and output name are overridden
+	std::string corpusFolder;		 // every .ck2 in here is converted
+	std::vector<std::size_t> syntheticScales = {1}; // CK2SaveGenerator saves added to the corpus, as multiples of a real save
+	// Cache conditions to convert every save under, as "cold", "warm" and "checkpointed"; each run is then recorded as
+	// "<save> (<scenario>)". None converts each save once as the caches happen to be, without a snapshot.
+	std::vector<std::string> scenarios;
+	// Worker thread counts to convert every save (and scenario) with; each run is then recorded as "<save> (<n> threads)"
+	// or "<save> (<scenario>, <n> threads)". None leaves the count to the base configuration.
+	std::vector<std::size_t> threadCounts;
+	std::string resultsPath = "conversion-results.json";
+	std::string baselinePath;
+	double thresholdPercent = 10;
+	// Phases shorter than this are left out of the comparison, their timings are mostly scheduling noise.
+	double noiseFloorSeconds = 0.1;
+	bool updateBaseline = false;
+	// Fit how each phase grows over the synthetic saves, and report those growing faster than n log n.
+	bool fitGrowth = false;
+	// How far past n log n a fitted exponent may go before the phase is reported; timings at small scales are noisy.
+	double growthTolerance = 0.15;
+};
+
+// Converts every save in the corpus, one converter process each so peak memory is per save. Returns
+// {"saves": {"<save>": {"peakResidentKB": n, "timeToFirstParseSeconds": s, "totalSeconds": s,
+//                       "phases": {"<phase>": {"wallSeconds": s, "cpuSeconds": s}}}}},
+// the time to first parse running until the save is in memory, whether imported or loaded from a snapshot. Runs with a
+// thread count also hold it as "threads", and the name of the run without it as "series".
+//
+// Scenarios run per save in the order given. Cold starts from an empty snapshots/ folder, and on Linux with the rights
+// to, an emptied page cache; it leaves every cache and the save's snapshot behind. Warm keeps the caches but parses
+// the save again, checkpointed also starts from the snapshot. So cold, warm, checkpointed measures every cache.
+// Throws std::runtime_error when a conversion fails or leaves no timings behind.
+[[nodiscard]] nlohmann::json runCorpus(const Settings& settings);
+
+// Every phase, and every save's peak memory, time to first parse and total time, that grew past the threshold; saves or
+// phases missing on either side are skipped. A cache that stops paying off shows up as its scenario's times growing.
+[[nodiscard]] std::vector<std::string> findRegressions(const nlohmann::json& baseline, const nlohmann::json& results, double thresholdPercent, double noiseFloorSeconds);
+
+// How each phase's wall time grows with the synthetic saves' scale: the least-squares slope of log time against log
+// scale, per scenario. Phases below the noise floor at the largest scale are left out, as are scenarios with fewer than
+// two scales. n log n over the same scales, n being the synthetic save's characters, fits to a little over 1; a phase
+// that fits past that by more than the tolerance is marked superlinear. Returns
+// {"<phase>[ (<scenario>)]": {"exponent": e, "nLogNExponent": e, "seconds": {"<scale>": s}, "superlinear": b}}.
+[[nodiscard]] nlohmann::json fitGrowth(const nlohmann::json& results, double noiseFloorSeconds, double tolerance);
+
+// The phases fitGrowth marked superlinear, steepest first: the candidates for indexing work.
+[[nodiscard]] std::vector<std::string> findSuperlinearPhases(const nlohmann::json& growth);
+
+// How each phase of each series speeds up with the thread count, against its run on the fewest threads. The serial
+// fraction is Amdahl's: time is fitted by least squares as serial + parallel / threads, and the fraction is
+// serial / (serial + parallel), extrapolated to one thread when the fewest measured is more. Series with fewer than two
+// thread counts are left out, as are phases below the noise floor on the fewest threads. Returns
+// {"<series>": {"<phase>": {"seconds": {"<threads>": s}, "speedup": {"<threads>": x}, "serialFraction": f, "serialSeconds": s}}}.
+[[nodiscard]] nlohmann::json fitThreadScaling(const nlohmann::json& results, double noiseFloorSeconds);
+
+// One line per phase of fitThreadScaling with its speedup curve and serial fraction, the phases with the most serial
+// time first: those are the ones worth parallelising next.
+[[nodiscard]] std::vector<std::string> describeThreadScaling(const nlohmann::json& scaling);
+} // namespace harness
+
+#endif // CK2TOEU4_CONVERSION_HARNESS_H
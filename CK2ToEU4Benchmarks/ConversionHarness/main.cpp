@@ -0,0 +1,155 @@
+#include "ConversionHarness.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// CK2ToEU4ConversionHarness --converter <folder> --configuration <configuration.txt> [--corpus <folder>]
+//                           [--synthetic N[,N...]] [--scenarios cold,warm,checkpointed] [--results <file>] [--baseline <file>] [--threshold <percent>]
+//                           [--noise-floor <seconds>] [--update-baseline] [--growth [--growth-tolerance <exponent>]]
+//                           [--thread-scaling] [--threads N[,N...]]
+// Exits 1 when anything regressed past the threshold against the baseline, 2 when the corpus couldn't be converted.
+// --growth fits each phase's growth over the synthetic saves, at 1, 2, 4 and 8 times unless --synthetic says otherwise,
+// adds it to the results as "growth" and lists the phases growing faster than n log n. Those don't fail the run.
+// --thread-scaling converts every save on 1, 2, 4, 8, 16 and 32 worker threads unless --threads says otherwise, adds
+// each phase's speedup and serial fraction to the results as "threadScaling" and lists them, most serial time first.
+namespace
+{
+std::vector<std::string> parseScenarios(const std::string& list)
+{
+	std::vector<std::string> scenarios;
+	std::stringstream stream(list);
+	std::string scenario;
+	while (std::getline(stream, scenario, ','))
+		if (scenario == "cold" || scenario == "warm" || scenario == "checkpointed")
+			scenarios.emplace_back(scenario);
+		else if (!scenario.empty())
+			throw std::invalid_argument("Unknown scenario " + scenario + ", expected cold, warm or checkpointed");
+	return scenarios;
+}
+
+std::vector<std::size_t> parseCounts(const std::string& list)
+{
+	std::vector<std::size_t> scales;
+	std::stringstream stream(list);
+	std::string scale;
+	while (std::getline(stream, scale, ','))
+		if (!scale.empty())
+			scales.emplace_back(std::stoull(scale));
+	return scales;
+}
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+	harness::Settings settings;
+	auto syntheticGiven = false;
+	auto threadScaling = false;
+	try
+	{
+		for (auto arg = 1; arg < argc; ++arg)
+		{
+			const std::string option = argv[arg];
+			if (option == "--update-baseline")
+			{
+				settings.updateBaseline = true;
+				continue;
+			}
+			if (option == "--growth")
+			{
+				settings.fitGrowth = true;
+				continue;
+			}
+			if (option == "--thread-scaling")
+			{
+				threadScaling = true;
+				continue;
+			}
+			if (arg + 1 >= argc)
+				throw std::invalid_argument(option + " needs a value");
+			const std::string value = argv[++arg];
+			if (option == "--converter")
+				settings.converterFolder = value;
+			else if (option == "--configuration")
+				settings.baseConfiguration = value;
+			else if (option == "--corpus")
+				settings.corpusFolder = value;
+			else if (option == "--synthetic")
+			{
+				settings.syntheticScales = parseCounts(value);
+				syntheticGiven = true;
+			}
+			else if (option == "--scenarios")
+				settings.scenarios = parseScenarios(value);
+			else if (option == "--results")
+				settings.resultsPath = value;
+			else if (option == "--baseline")
+				settings.baselinePath = value;
+			else if (option == "--threshold")
+				settings.thresholdPercent = std::stod(value);
+			else if (option == "--noise-floor")
+				settings.noiseFloorSeconds = std::stod(value);
+			else if (option == "--growth-tolerance")
+				settings.growthTolerance = std::stod(value);
+			else if (option == "--threads")
+				settings.threadCounts = parseCounts(value);
+			else
+				throw std::invalid_argument("Unknown option " + option);
+		}
+		if (settings.converterFolder.empty() || settings.baseConfiguration.empty())
+			throw std::invalid_argument("--converter and --configuration are required");
+		if (settings.fitGrowth && !syntheticGiven)
+			settings.syntheticScales = {1, 2, 4, 8};
+		if (threadScaling && settings.threadCounts.empty())
+			settings.threadCounts = {1, 2, 4, 8, 16, 32};
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		return 2;
+	}
+
+	nlohmann::json results;
+	try
+	{
+		results = harness::runCorpus(settings);
+		if (settings.fitGrowth)
+		{
+			results["growth"] = harness::fitGrowth(results, settings.noiseFloorSeconds, settings.growthTolerance);
+			for (const auto& phase: harness::findSuperlinearPhases(results["growth"]))
+				std::cout << "SUPERLINEAR " << phase << "\n";
+		}
+		if (threadScaling)
+		{
+			results["threadScaling"] = harness::fitThreadScaling(results, settings.noiseFloorSeconds);
+			for (const auto& phase: harness::describeThreadScaling(results["threadScaling"]))
+				std::cout << "THREADS " << phase << "\n";
+		}
+		std::ofstream(settings.resultsPath) << results.dump(1, '\t') << "\n";
+		std::cout << "Wrote " << settings.resultsPath << "\n";
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		return 2;
+	}
+
+	if (settings.baselinePath.empty())
+		return 0;
+	if (settings.updateBaseline || !std::filesystem::exists(settings.baselinePath))
+	{
+		std::ofstream(settings.baselinePath) << results.dump(1, '\t') << "\n";
+		std::cout << "Stored " << settings.baselinePath << " as the new baseline\n";
+		return 0;
+	}
+
+	std::ifstream baselineFile(settings.baselinePath);
+	const auto baseline = nlohmann::json::parse(baselineFile);
+	const auto regressions = harness::findRegressions(baseline, results, settings.thresholdPercent, settings.noiseFloorSeconds);
+	for (const auto& regression: regressions)
+		std::cout << "REGRESSION " << regression << "\n";
+	if (!regressions.empty())
+		return 1;
+	std::cout << "No phase regressed more than " << settings.thresholdPercent << "% against " << settings.baselinePath << "\n";
+	return 0;
+}
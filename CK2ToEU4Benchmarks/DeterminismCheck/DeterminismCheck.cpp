@@ -0,0 +1,168 @@
+#include "DeterminismCheck.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+std::string readFile(const fs::path& path)
+{
+	std::ifstream input(path, std::ios::binary);
+	if (!input.is_open())
+		throw std::runtime_error("Could not open " + path.string());
+	std::stringstream contents;
+	contents << input.rdbuf();
+	return contents.str();
+}
+
+// Later keys win in configuration.txt, so the overrides simply go after the base configuration. Everything that could
+// make two runs differ for reasons other than scheduling is pinned: the save is always parsed afresh, the mod is
+// written straight out as a loose folder, and every run uses the same output name.
+void writeConfiguration(const fs::path& target,
+	 const std::string& baseConfiguration,
+	 const determinism::Settings& settings,
+	 const std::size_t threads,
+	 const std::uint32_t seed)
+{
+	std::ofstream output(target, std::ios::binary);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + target.string());
+	output << baseConfiguration << "\n";
+	output << "SaveGame = \"" << fs::absolute(fs::u8path(settings.save)).string() << "\"\n";
+	output << "snapshot = \"2\"\n";
+	output << "archive = \"1\"\n";
+	output << "incremental = \"1\"\n";
+	output << "staging = \"1\"\n";
+	output << "threads = \"" << threads << "\"\n";
+	output << "task_order_seed = \"" << seed << "\"\n";
+	output << "output_name = \"" << settings.outputName << "\"\n";
+}
+
+determinism::Run convert(const determinism::Settings& settings,
+	 const std::string& baseConfiguration,
+	 const std::string& name,
+	 const std::size_t threads,
+	 const std::uint32_t seed)
+{
+	const auto converterFolder = fs::u8path(settings.converterFolder);
+	const auto outputFolder = converterFolder / "output";
+	const auto modFolder = outputFolder / fs::u8path(settings.outputName);
+	const auto modFile = outputFolder / fs::u8path(settings.outputName + ".mod");
+	fs::remove_all(modFolder);
+	fs::remove(modFile);
+	writeConfiguration(converterFolder / "configuration.txt", baseConfiguration, settings, threads, seed);
+
+	std::cout << "Converting " << name << std::endl;
+#ifdef _WIN32
+	const auto command = "cd /d \"" + converterFolder.string() + "\" && CK2ToEU4Converter.exe > NUL";
+#else
+	const auto command = "cd \"" + converterFolder.string() + "\" && ./CK2ToEU4Converter > /dev/null";
+#endif
+	if (std::system(command.c_str()) != 0 || !fs::exists(modFolder))
+		throw std::runtime_error("Converting " + name + " failed, see " + (converterFolder / "log.txt").string());
+
+	// The .mod file goes along with the folder so it is compared too.
+	auto variant = name;
+	std::replace(variant.begin(), variant.end(), ' ', '_');
+	const auto aside = outputFolder / fs::u8path(settings.outputName + "." + variant);
+	fs::remove_all(aside);
+	fs::rename(modFolder, aside);
+	if (fs::exists(modFile))
+		fs::rename(modFile, aside / fs::u8path(settings.outputName + ".mod"));
+	return {name, aside};
+}
+
+std::set<fs::path> listFiles(const fs::path& root)
+{
+	std::set<fs::path> files;
+	for (const auto& entry: fs::recursive_directory_iterator(root))
+		if (entry.is_regular_file())
+			files.insert(fs::relative(entry.path(), root));
+	return files;
+}
+
+// Both files differ somewhere; finds the first line where they do. A difference only in the final newline counts
+// against the line after the last one.
+determinism::Divergence firstDifferentLine(const std::string& file, const std::string& expected, const std::string& actual)
+{
+	determinism::Divergence divergence{file, 1, "", ""};
+	std::istringstream expectedLines(expected);
+	std::istringstream actualLines(actual);
+	while (true)
+	{
+		const auto expectedMore = static_cast<bool>(std::getline(expectedLines, divergence.expected));
+		const auto actualMore = static_cast<bool>(std::getline(actualLines, divergence.actual));
+		if (!expectedMore)
+			divergence.expected = "<end of file>";
+		if (!actualMore)
+			divergence.actual = "<end of file>";
+		if (!expectedMore || !actualMore || divergence.expected != divergence.actual)
+			return divergence;
+		++divergence.line;
+	}
+}
+} // namespace
+
+std::vector<determinism::Run> determinism::convertAllWays(const Settings& settings)
+{
+	const auto converterFolder = fs::u8path(settings.converterFolder);
+	const auto configurationPath = converterFolder / "configuration.txt";
+	const auto baseConfiguration = readFile(fs::u8path(settings.baseConfiguration));
+
+	// The converter only reads configuration.txt, so whatever was there goes back once the runs are done.
+	std::optional<std::string> previousConfiguration;
+	if (fs::exists(configurationPath))
+		previousConfiguration = readFile(configurationPath);
+	const auto restoreConfiguration = [&configurationPath, &previousConfiguration] {
+		if (previousConfiguration)
+			std::ofstream(configurationPath, std::ios::binary) << *previousConfiguration;
+		else
+			fs::remove(configurationPath);
+	};
+
+	std::vector<Run> runs;
+	try
+	{
+		runs.emplace_back(convert(settings, baseConfiguration, "serial", 1, 0));
+		runs.emplace_back(convert(settings, baseConfiguration, "parallel", settings.threads, 0));
+		for (const auto seed: settings.seeds)
+			runs.emplace_back(convert(settings, baseConfiguration, "seed " + std::to_string(seed), 1, seed));
+	}
+	catch (...)
+	{
+		restoreConfiguration();
+		throw;
+	}
+	restoreConfiguration();
+	return runs;
+}
+
+std::optional<determinism::Divergence> determinism::compareTrees(const fs::path& expected, const fs::path& actual)
+{
+	const auto expectedFiles = listFiles(expected);
+	const auto actualFiles = listFiles(actual);
+
+	auto expectedFile = expectedFiles.begin();
+	auto actualFile = actualFiles.begin();
+	while (expectedFile != expectedFiles.end() || actualFile != actualFiles.end())
+	{
+		if (actualFile == actualFiles.end() || (expectedFile != expectedFiles.end() && *expectedFile < *actualFile))
+			return Divergence{expectedFile->generic_string(), 0, "<file>", "<missing>"};
+		if (expectedFile == expectedFiles.end() || *actualFile < *expectedFile)
+			return Divergence{actualFile->generic_string(), 0, "<missing>", "<file>"};
+
+		const auto expectedContents = readFile(expected / *expectedFile);
+		const auto actualContents = readFile(actual / *actualFile);
+		if (expectedContents != actualContents)
+			return firstDifferentLine(expectedFile->generic_string(), expectedContents, actualContents);
+		++expectedFile;
+		++actualFile;
+	}
+	return std::nullopt;
+}
@@ -0,0 +1,45 @@
+#ifndef CK2TOEU4_DETERMINISM_CHECK_H
+#define CK2TOEU4_DETERMINISM_CHECK_H
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Converts one save several ways (one thread, every thread, one thread in seeded random step orders) and holds the
+// output trees against each other byte for byte. Any difference means the output depends on scheduling.
+namespace determinism
+{
+struct Settings
+{
+	std::string converterFolder;	// where CK2ToEU4Converter and its configurables live
+	std::string baseConfiguration; // a working configuration.txt; the save, threads, seed and output name are overridden
+	std::string save;
+	std::size_t threads = 0; // for the parallel run; 0 is one per core
+	std::vector<std::uint32_t> seeds = {1, 2};
+	std::string outputName = "determinism";
+};
+
+struct Run
+{
+	std::string name; // "serial", "parallel", "seed 1"...
+	std::filesystem::path output;
+};
+
+// The serial run comes first, it's the reference. Each run's mod is moved aside to output/<outputName>.<run> so every
+// run writes under the same name. Throws std::runtime_error when a conversion fails.
+[[nodiscard]] std::vector<Run> convertAllWays(const Settings& settings);
+
+struct Divergence
+{
+	std::string file; // relative to the trees
+	std::size_t line = 0; // 1-based; 0 when the file is missing on one side
+	std::string expected;
+	std::string actual;
+};
+
+// The first difference in path order, if any.
+[[nodiscard]] std::optional<Divergence> compareTrees(const std::filesystem::path& expected, const std::filesystem::path& actual);
+} // namespace determinism
+
+#endif // CK2TOEU4_DETERMINISM_CHECK_H
@@ -0,0 +1,90 @@
+#include "DeterminismCheck.h"
+#include <iostream>
+#include <sstream>
+
+// CK2ToEU4DeterminismCheck --converter <folder> --configuration <configuration.txt> --save <save.ck2>
+//                          [--threads N] [--seeds S[,S...]] [--output-name <name>]
+// Exits 1 when any run's output differs from the serial run's, 2 when a run couldn't be converted.
+namespace
+{
+std::vector<std::uint32_t> parseSeeds(const std::string& list)
+{
+	std::vector<std::uint32_t> seeds;
+	std::stringstream stream(list);
+	std::string seed;
+	while (std::getline(stream, seed, ','))
+		if (!seed.empty())
+		{
+			seeds.emplace_back(static_cast<std::uint32_t>(std::stoul(seed)));
+			if (!seeds.back())
+				throw std::invalid_argument("Seed 0 is the plain launch order; pick another");
+		}
+	return seeds;
+}
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+	determinism::Settings settings;
+	try
+	{
+		for (auto arg = 1; arg < argc; ++arg)
+		{
+			const std::string option = argv[arg];
+			if (arg + 1 >= argc)
+				throw std::invalid_argument(option + " needs a value");
+			const std::string value = argv[++arg];
+			if (option == "--converter")
+				settings.converterFolder = value;
+			else if (option == "--configuration")
+				settings.baseConfiguration = value;
+			else if (option == "--save")
+				settings.save = value;
+			else if (option == "--threads")
+				settings.threads = std::stoull(value);
+			else if (option == "--seeds")
+				settings.seeds = parseSeeds(value);
+			else if (option == "--output-name")
+				settings.outputName = value;
+			else
+				throw std::invalid_argument("Unknown option " + option);
+		}
+		if (settings.converterFolder.empty() || settings.baseConfiguration.empty() || settings.save.empty())
+			throw std::invalid_argument("--converter, --configuration and --save are required");
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		return 2;
+	}
+
+	std::vector<determinism::Run> runs;
+	try
+	{
+		runs = determinism::convertAllWays(settings);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		return 2;
+	}
+
+	auto diverged = false;
+	const auto& reference = runs.front();
+	for (auto run = std::next(runs.begin()); run != runs.end(); ++run)
+	{
+		const auto divergence = determinism::compareTrees(reference.output, run->output);
+		if (!divergence)
+		{
+			std::cout << run->name << ": identical to " << reference.name << "\n";
+			continue;
+		}
+		diverged = true;
+		std::cout << "DIVERGED " << run->name << ": " << divergence->file;
+		if (divergence->line)
+			std::cout << " line " << divergence->line;
+		std::cout << "\n\t" << reference.name << ": " << divergence->expected << "\n\t" << run->name << ": " << divergence->actual << "\n";
+	}
+	std::cout << "Outputs are in " << reference.output.parent_path().string() << "\n";
+	return diverged ? 1 : 0;
+}
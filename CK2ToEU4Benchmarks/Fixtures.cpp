@@ -0,0 +1,225 @@
+#include "Fixtures.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+fs::path scratchFolder()
+{
+	static const auto folder = [] {
+		auto path = fs::temp_directory_path() / "CK2ToEU4Benchmarks";
+		fs::create_directories(path);
+		return path;
+	}();
+	return folder;
+}
+
+std::string writeScratchFile(const std::string& name, const std::string& contents)
+{
+	const auto path = scratchFolder() / name;
+	std::ofstream output(path, std::ios::binary);
+	if (!output.is_open())
+		throw std::runtime_error("Could not create " + path.string());
+	output << contents;
+	return path.string();
+}
+} // namespace
+
+std::string fixtures::character(const std::size_t index)
+{
+	const auto id = std::to_string(index);
+	return "=\n{\n"
+			 "\tbn=\"Character " +
+			 id +
+			 "\"\n"
+			 "\tb_d=\"1012.3.14\"\n"
+			 "\tfem=yes\n"
+			 "\tdnt=" +
+			 std::to_string(1000 + index % 500) +
+			 "\n"
+			 "\tfat=" +
+			 std::to_string(index + 1) +
+			 "\n"
+			 "\tmot=" +
+			 std::to_string(index + 2) +
+			 "\n"
+			 "\tspouse=" +
+			 std::to_string(index + 3) +
+			 "\n"
+			 "\tcul=\"norse\"\n"
+			 "\trel=\"catholic\"\n"
+			 "\tgov=\"feudal_government\"\n"
+			 "\tatt={ 7 12 5 9 4 }\n"
+			 "\ttr={ 3 17 28 42 }\n"
+			 "\tmd={ modifier=\"borrowed_from_jews\" date=\"1060.1.1\" }\n"
+			 "\tpiety=17.430\n"
+			 "\twealth=250.125\n"
+			 "\tprs=310.500\n"
+			 "\tlge=" +
+			 std::to_string(index / 10) +
+			 "\n"
+			 "\thost=" +
+			 std::to_string(index / 10) +
+			 "\n"
+			 "\tdmn={ capital=\"b_test" +
+			 id +
+			 "\" primary={ title=\"c_test" +
+			 id +
+			 "\" base_title=\"k_test\" } }\n"
+			 "\tjob=\"job_chancellor\"\n"
+			 "\temi=1\n"
+			 "\teyi=2\n"
+			 "\tlhi=3\n"
+			 "\tact={ 0=1 1=4 }\n"
+			 "}";
+}
+
+std::string fixtures::title(const std::size_t index)
+{
+	return "=\n{\n"
+			 "\tholder=" +
+			 std::to_string(index) +
+			 "\n"
+			 "\tname=\"Title " +
+			 std::to_string(index) +
+			 "\"\n"
+			 "\tlaw=\"revoke_title_voting_power_0\"\n"
+			 "\tlaw=\"out_of_realm_inheritance_law_1\"\n"
+			 "\tlaw=\"centralization_4\"\n"
+			 "\tsuccession=\"primogeniture\"\n"
+			 "\tgender=\"agnatic\"\n"
+			 "\tprevious={ 1 2 3 " +
+			 std::to_string(index) +
+			 " }\n"
+			 "\tsuccession_electors={ 4 5 6 }\n"
+			 "\tliege={ title=\"d_test\" base_title=\"k_test\" is_custom=no }\n"
+			 "\tde_jure_liege=\"d_test\"\n"
+			 "\tcolor={ 120 34 56 }\n"
+			 "\thistory={ 1066.1.1={ holder=12 } 1080.5.3={ holder=13 } }\n"
+			 "}";
+}
+
+std::string fixtures::province(const std::size_t index)
+{
+	const auto id = std::to_string(index);
+	return "=\n{\n"
+			 "\tname=\"Province " +
+			 id +
+			 "\"\n"
+			 "\tculture=\"norse\"\n"
+			 "\treligion=\"catholic\"\n"
+			 "\tmax_settlements=5\n"
+			 "\tprimary_settlement=\"b_test" +
+			 id +
+			 "_1\"\n"
+			 "\tb_test" +
+			 id +
+			 "_1={ type=castle building_a=yes building_b=yes levy=1.5 }\n"
+			 "\tb_test" +
+			 id +
+			 "_2={ type=city building_c=yes levy=0.5 }\n"
+			 "\tb_test" +
+			 id +
+			 "_3={ type=temple building_d=yes levy=0.75 }\n"
+			 "\tmodifier={ modifier=\"epidemic\" date=\"1066.1.1\" }\n"
+			 "}";
+}
+
+std::string fixtures::characters(const std::size_t count)
+{
+	std::string block = "=\n{\n";
+	for (std::size_t index = 1; index <= count; ++index)
+		block += std::to_string(index) + character(index) + "\n";
+	block += "}";
+	return block;
+}
+
+std::string fixtures::titles(const std::size_t count)
+{
+	std::string block = "=\n{\n";
+	for (std::size_t index = 1; index <= count; ++index)
+	{
+		// The save's own mix: mostly baronies and counties, a thinner layer of everything above.
+		static const char* const tiers[] = {"b_", "b_", "b_", "c_", "c_", "d_", "k_", "e_"};
+		block += tiers[index % 8] + std::string("test") + std::to_string(index) + title(index) + "\n";
+	}
+	block += "}";
+	return block;
+}
+
+std::string fixtures::provinceHistoryFile(const std::size_t provinceID)
+{
+	return writeScratchFile(std::to_string(provinceID) + " - Benchmark.txt",
+		 "# County Title\n"
+		 "title = c_benchmark\n\n"
+		 "# Settlements\n"
+		 "max_settlements = 5\n"
+		 "b_benchmark_1 = castle\n"
+		 "b_benchmark_2 = city\n"
+		 "b_benchmark_3 = temple\n\n"
+		 "# Misc\n"
+		 "culture = norse\n"
+		 "religion = catholic\n"
+		 "terrain = plains\n\n"
+		 "# History\n"
+		 "1066.1.1 = { b_benchmark_4 = castle }\n"
+		 "1100.1.1 = { culture = swedish }\n");
+}
+
+std::string fixtures::landedTitlesFile(const std::size_t duchies)
+{
+	std::string contents = "e_benchmark = {\n\tcolor = { 120 34 56 }\n\tcolor2 = { 255 255 255 }\n\tcapital = 1\n";
+	contents += "\tk_benchmark = {\n\t\tcolor = { 20 134 56 }\n\t\tculture = norse\n";
+	for (std::size_t duchy = 0; duchy < duchies; ++duchy)
+	{
+		const auto name = std::to_string(duchy);
+		contents += "\t\td_benchmark" + name + " = {\n\t\t\tcolor = { 40 " + std::to_string(duchy % 256) + " 90 }\n";
+		for (auto county = 0; county < 4; ++county)
+		{
+			const auto countyName = name + "_" + std::to_string(county);
+			contents += "\t\t\tc_benchmark" + countyName + " = {\n\t\t\t\tcolor = { 60 90 120 }\n";
+			for (auto barony = 0; barony < 3; ++barony)
+				contents += "\t\t\t\tb_benchmark" + countyName + "_" + std::to_string(barony) + " = {\n\t\t\t\t\tcatholic = 200\n\t\t\t\t}\n";
+			contents += "\t\t\t}\n";
+		}
+		contents += "\t\t}\n";
+	}
+	contents += "\t}\n}\n";
+	return writeScratchFile("landed_titles_" + std::to_string(duchies) + ".txt", contents);
+}
+
+std::string fixtures::eu4ProvinceHistoryFile()
+{
+	return writeScratchFile("1 - Benchmark.txt",
+		 "# No previous file for Benchmark\n"
+		 "owner = SWE\n"
+		 "controller = SWE\n"
+		 "add_core = SWE\n"
+		 "add_core = NOR\n"
+		 "add_claim = DAN\n"
+		 "culture = swedish\n"
+		 "religion = catholic\n"
+		 "hre = no\n"
+		 "base_tax = 5\n"
+		 "base_production = 5\n"
+		 "trade_goods = grain\n"
+		 "base_manpower = 3\n"
+		 "fort_15th = yes\n"
+		 "capital = \"Stockholm\"\n"
+		 "is_city = yes\n"
+		 "center_of_trade = 2\n"
+		 "extra_cost = 16\n"
+		 "discovered_by = eastern\n"
+		 "discovered_by = western\n"
+		 "discovered_by = muslim\n"
+		 "discovered_by = ottoman\n"
+		 "add_permanent_province_modifier = {\n"
+		 "\tname = skanemarket_modifier\n"
+		 "\tduration = -1\n"
+		 "}\n"
+		 "1521.1.1 = { owner = SWE controller = SWE }\n"
+		 "1527.6.1 = { religion = protestant }\n");
+}
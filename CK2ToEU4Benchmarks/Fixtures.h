@@ -0,0 +1,25 @@
+#ifndef CK2TOEU4_BENCHMARK_FIXTURES_H
+#define CK2TOEU4_BENCHMARK_FIXTURES_H
+#include <cstddef>
+#include <string>
+
+// Representative input for the parsing benchmarks, in the same shape the unit tests feed the parsers, only repeated
+// until it weighs something. Entities are numbered so every one has a distinct key.
+namespace fixtures
+{
+// "={ ... }" bodies, as the save hands them to a single entity.
+std::string character(std::size_t index);
+std::string title(std::size_t index);
+std::string province(std::size_t index);
+
+// "={ key={...} key={...} }" blocks of count entities, as the save hands them to Characters and Titles.
+std::string characters(std::size_t count);
+std::string titles(std::size_t count);
+
+// Files the mappers read from disk, written under a scratch folder that lives as long as the benchmark process.
+std::string provinceHistoryFile(std::size_t provinceID);
+std::string landedTitlesFile(std::size_t duchies);
+std::string eu4ProvinceHistoryFile();
+} // namespace fixtures
+
+#endif // CK2TOEU4_BENCHMARK_FIXTURES_H
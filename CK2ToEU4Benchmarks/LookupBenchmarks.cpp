@@ -0,0 +1,120 @@
+#include "../CK2ToEU4/Source/Mappers/CultureMapper/CultureMapper.h"
+#include "../CK2ToEU4/Source/Mappers/ProvinceMapper/ProvinceMapper.h"
+#include "../CK2ToEU4/Source/Mappers/RegionMapper/RegionMapper.h"
+#include "../CK2ToEU4/Source/Mappers/ReligionMapper/ReligionMapper.h"
+#include "../CK2ToEU4/Source/Mappers/TitleTagMapper/TitleTagMapper.h"
+#include "LookupTrace.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <sstream>
+
+// Each benchmark loads its mapper from the shipped configurables once and replays the whole lookup trace per iteration,
+// so items/s is lookups per second over a realistic mix of hits, misses and repeats.
+namespace
+{
+std::shared_ptr<mappers::RegionMapper> loadRegionMapper()
+{
+	const auto& files = lookups::regionFiles();
+	std::istringstream areas(files.areas);
+	std::istringstream regions(files.regions);
+	std::istringstream superRegions(files.superRegions);
+	auto regionMapper = std::make_shared<mappers::RegionMapper>();
+	regionMapper->loadRegions(areas, regions, superRegions);
+	return regionMapper;
+}
+
+void BM_CultureMatch(benchmark::State& state)
+{
+	lookups::enterDataFiles();
+	const auto& trace = lookups::trace().cultures;
+	std::vector<parsing::Symbol> cultures;
+	for (const auto& lookup: trace)
+		cultures.emplace_back(lookup.ck2Culture);
+	mappers::CultureMapper cultureMapper;
+	cultureMapper.initCultureMapper("");
+	cultureMapper.loadRegionMapper(loadRegionMapper());
+
+	for (auto _: state)
+		for (std::size_t lookup = 0; lookup < trace.size(); ++lookup)
+			benchmark::DoNotOptimize(cultureMapper.cultureMatch(cultures[lookup], trace[lookup].eu4Religion, trace[lookup].eu4Province, trace[lookup].eu4Owner));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+}
+BENCHMARK(BM_CultureMatch);
+
+void BM_ReligionMatch(benchmark::State& state)
+{
+	lookups::enterDataFiles();
+	std::vector<parsing::Symbol> religions;
+	for (const auto& religion: lookups::trace().religions)
+		religions.emplace_back(religion);
+	mappers::ReligionMapper religionMapper;
+	religionMapper.initReligionMapper("");
+
+	for (auto _: state)
+		for (const auto& religion: religions)
+			benchmark::DoNotOptimize(religionMapper.getEu4ReligionForCk2Religion(religion));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(religions.size()));
+}
+BENCHMARK(BM_ReligionMatch);
+
+void BM_ProvinceIsInRegion(benchmark::State& state)
+{
+	lookups::enterDataFiles();
+	const auto& trace = lookups::trace().regions;
+	const auto regionMapper = loadRegionMapper();
+
+	for (auto _: state)
+		for (const auto& lookup: trace)
+			benchmark::DoNotOptimize(regionMapper->provinceIsInRegion(lookup.eu4Province, lookup.region));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+}
+BENCHMARK(BM_ProvinceIsInRegion);
+
+// getTagForTitle registers what it hands out, so only the first pass over the trace sees unregistered titles; that one
+// is timed on its own, the rest are the repeat lookups of a conversion.
+void BM_TagForTitleFirstPass(benchmark::State& state)
+{
+	lookups::enterDataFiles();
+	const auto& trace = lookups::trace().tags;
+	const auto rules = std::make_shared<const mappers::TitleTagRules>("");
+	for (auto _: state)
+	{
+		state.PauseTiming();
+		mappers::TitleTagMapper titleTagMapper(rules);
+		state.ResumeTiming();
+		for (const auto& lookup: trace)
+			benchmark::DoNotOptimize(titleTagMapper.getTagForTitle(lookup.ck2Title, lookup.ck2BaseTitle, lookup.eu4Capital));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+}
+BENCHMARK(BM_TagForTitleFirstPass)->Unit(benchmark::kMillisecond);
+
+void BM_TagForTitleRepeat(benchmark::State& state)
+{
+	lookups::enterDataFiles();
+	const auto& trace = lookups::trace().tags;
+	mappers::TitleTagMapper titleTagMapper;
+	titleTagMapper.initTitleTagMapper("");
+	for (const auto& lookup: trace)
+		benchmark::DoNotOptimize(titleTagMapper.getTagForTitle(lookup.ck2Title, lookup.ck2BaseTitle, lookup.eu4Capital));
+
+	for (auto _: state)
+		for (const auto& lookup: trace)
+			benchmark::DoNotOptimize(titleTagMapper.getTagForTitle(lookup.ck2Title, lookup.ck2BaseTitle, lookup.eu4Capital));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+}
+BENCHMARK(BM_TagForTitleRepeat);
+
+void BM_EU4ProvinceNumbers(benchmark::State& state)
+{
+	lookups::enterDataFiles();
+	const auto& trace = lookups::trace().provinces;
+	const mappers::ProvinceMapper provinceMapper(Mods(), "");
+
+	for (auto _: state)
+		for (const auto province: trace)
+			benchmark::DoNotOptimize(provinceMapper.getEU4ProvinceNumbers(province).size());
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+}
+BENCHMARK(BM_EU4ProvinceNumbers);
+} // namespace
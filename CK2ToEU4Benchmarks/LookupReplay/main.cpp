@@ -0,0 +1,220 @@
+#include "../../CK2ToEU4/Source/Configuration/Configuration.h"
+#include "../../CK2ToEU4/Source/Mappers/CultureMapper/CultureMapper.h"
+#include "../../CK2ToEU4/Source/Mappers/GovernmentsMapper/GovernmentsMapper.h"
+#include "../../CK2ToEU4/Source/Mappers/LookupRecorder/LookupRecorder.h"
+#include "../../CK2ToEU4/Source/Mappers/ProvinceMapper/ProvinceMapper.h"
+#include "../../CK2ToEU4/Source/Mappers/RegionMapper/RegionMapper.h"
+#include "../../CK2ToEU4/Source/Mappers/ReligionMapper/ReligionMapper.h"
+#include "../../CK2ToEU4/Source/Mappers/TitleTagMapper/TitleTagMapper.h"
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+
+// CK2ToEU4LookupReplay <lookups.bin> [--override CleanSlate|Tianxia] [--show N]
+// Run from the converter's folder, beside configuration.txt and configurables/. Feeds every call of a lookup_trace
+// recording to freshly loaded mappers, in the recorded order, and compares the answers. Exits 1 when any answer
+// differs, 2 when the replay couldn't run.
+namespace
+{
+using CALL = mappers::LookupRecorder::CALL;
+using Value = mappers::LookupRecorder::Value;
+
+std::string textOf(const Value& value)
+{
+	const auto* text = std::get_if<std::string>(&value);
+	return text ? *text : std::string();
+}
+
+int numberOf(const Value& value)
+{
+	const auto* number = std::get_if<long long>(&value);
+	return number ? static_cast<int>(*number) : 0;
+}
+
+std::string describe(const std::vector<Value>& values)
+{
+	std::string description;
+	for (const auto& value: values)
+	{
+		if (!description.empty())
+			description += ' ';
+		if (const auto* number = std::get_if<long long>(&value))
+			description += std::to_string(*number);
+		else if (const auto* text = std::get_if<std::string>(&value))
+			description += '"' + *text + '"';
+		else
+			description += "-";
+	}
+	return description;
+}
+
+std::string nameOf(const CALL call)
+{
+	switch (call)
+	{
+		case CALL::CULTURE:
+			return "culture";
+		case CALL::CULTURE_REGIONAL:
+			return "culture (regional)";
+		case CALL::CULTURE_NONREGIONAL_NONRELIGIOUS:
+			return "culture (non-regional, non-religious)";
+		case CALL::RELIGION:
+			return "religion";
+		case CALL::GOVERNMENT:
+			return "government";
+		case CALL::REGION:
+			return "region";
+		case CALL::TAG:
+			return "tag";
+		case CALL::TAG_REGISTRATION:
+			return "tag registration";
+		case CALL::PROVINCE:
+			return "province";
+	}
+	return "unknown";
+}
+
+// The mappers the way EU4::World sets them up, less the save: the region mapper reads EU4's map files, so
+// configuration.txt has to point at the same EU4 install the recording was made with.
+class Mappers
+{
+  public:
+	Mappers(const Configuration& theConfiguration, const std::string& overrideModPath)
+	{
+		cultureMapper.initCultureMapper(overrideModPath);
+		governmentsMapper.initGovernmentsMapper(overrideModPath);
+		religionMapper.initReligionMapper(overrideModPath);
+		titleTagMapper.initTitleTagMapper(overrideModPath);
+		regionMapper = std::make_shared<mappers::RegionMapper>();
+		regionMapper->loadRegions(theConfiguration);
+		cultureMapper.loadRegionMapper(regionMapper);
+		provinceMapper = std::make_unique<mappers::ProvinceMapper>(theConfiguration.getMods(), overrideModPath);
+	}
+
+	// The answer the mappers give now, shaped the way the recorder wrote it.
+	std::vector<Value> replay(const mappers::LookupRecorder::Call& call)
+	{
+		const auto& arguments = call.arguments;
+		switch (call.call)
+		{
+			case CALL::CULTURE:
+				return {mappers::LookupRecorder::value(
+					 cultureMapper.cultureMatch(parsing::Symbol(textOf(arguments[0])), textOf(arguments[1]), numberOf(arguments[2]), textOf(arguments[3])))};
+			case CALL::CULTURE_REGIONAL:
+				return {mappers::LookupRecorder::value(
+					 cultureMapper.cultureRegionalMatch(parsing::Symbol(textOf(arguments[0])), textOf(arguments[1]), numberOf(arguments[2]), textOf(arguments[3])))};
+			case CALL::CULTURE_NONREGIONAL_NONRELIGIOUS:
+				return {mappers::LookupRecorder::value(cultureMapper.cultureNonRegionalNonReligiousMatch(parsing::Symbol(textOf(arguments[0])),
+					 textOf(arguments[1]),
+					 numberOf(arguments[2]),
+					 textOf(arguments[3])))};
+			case CALL::RELIGION:
+				return {mappers::LookupRecorder::value(religionMapper.getEu4ReligionForCk2Religion(parsing::Symbol(textOf(arguments[0]))))};
+			case CALL::GOVERNMENT:
+				if (const auto& match = governmentsMapper.matchGovernment(parsing::Symbol(textOf(arguments[0])), textOf(arguments[1])))
+					return {match->first, match->second};
+				return {};
+			case CALL::REGION:
+				return {static_cast<long long>(regionMapper->provinceIsInRegion(numberOf(arguments[0]), textOf(arguments[1])))};
+			case CALL::TAG:
+				return {mappers::LookupRecorder::value(titleTagMapper.getTagForTitle(textOf(arguments[0]), textOf(arguments[1]), numberOf(arguments[2])))};
+			case CALL::TAG_REGISTRATION:
+				titleTagMapper.registerTitle(textOf(arguments[0]), textOf(arguments[1]));
+				return {};
+			case CALL::PROVINCE:
+			{
+				std::vector<Value> provinces;
+				for (const auto province: provinceMapper->getEU4ProvinceNumbers(numberOf(arguments[0])))
+					provinces.emplace_back(static_cast<long long>(province));
+				return provinces;
+			}
+		}
+		return {};
+	}
+
+  private:
+	mappers::CultureMapper cultureMapper;
+	mappers::GovernmentsMapper governmentsMapper;
+	mappers::ReligionMapper religionMapper;
+	mappers::TitleTagMapper titleTagMapper;
+	std::shared_ptr<mappers::RegionMapper> regionMapper;
+	std::unique_ptr<mappers::ProvinceMapper> provinceMapper;
+};
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+	std::string recordingPath;
+	std::string overrideModPath;
+	std::size_t shown = 20;
+	try
+	{
+		for (auto arg = 1; arg < argc; ++arg)
+		{
+			const std::string option = argv[arg];
+			if (option.rfind("--", 0) != 0)
+			{
+				recordingPath = option;
+				continue;
+			}
+			if (arg + 1 >= argc)
+				throw std::invalid_argument(option + " needs a value");
+			const std::string value = argv[++arg];
+			if (option == "--override")
+				overrideModPath = value;
+			else if (option == "--show")
+				shown = std::stoull(value);
+			else
+				throw std::invalid_argument("Unknown option " + option);
+		}
+		if (recordingPath.empty())
+			throw std::invalid_argument("Which recording?");
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		std::cerr << "Usage: CK2ToEU4LookupReplay <lookups.bin> [--override CleanSlate|Tianxia] [--show N]\n";
+		return 2;
+	}
+
+	try
+	{
+		const auto& calls = mappers::LookupRecorder::read(recordingPath);
+		std::ifstream configurationFile("configuration.txt");
+		if (!configurationFile.is_open())
+			throw std::runtime_error("No configuration.txt here.");
+		const Configuration theConfiguration(configurationFile);
+		Mappers theMappers(theConfiguration, overrideModPath);
+
+		std::map<CALL, std::pair<std::size_t, std::size_t>> tally; // calls, mismatches
+		std::size_t mismatches = 0;
+		for (const auto& call: calls)
+		{
+			auto& [callCount, mismatchCount] = tally[call.call];
+			++callCount;
+			const auto& answer = theMappers.replay(call);
+			if (answer == call.results)
+				continue;
+			++mismatchCount;
+			if (mismatches++ < shown)
+				std::cout << nameOf(call.call) << " (" << describe(call.arguments) << "): recorded " << describe(call.results) << ", now "
+							 << describe(answer) << "\n";
+		}
+
+		for (const auto& [call, counts]: tally)
+			std::cout << nameOf(call) << ": " << counts.first << " calls, " << counts.second << " mismatched\n";
+		if (mismatches)
+		{
+			std::cout << mismatches << " of " << calls.size() << " answers changed.\n";
+			return 1;
+		}
+		std::cout << "All " << calls.size() << " answers match.\n";
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Replay failed: " << e.what() << "\n";
+		return 2;
+	}
+}
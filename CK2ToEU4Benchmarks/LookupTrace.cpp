@@ -0,0 +1,329 @@
+#include "LookupTrace.h"
+#include "../CK2ToEU4/Source/Mappers/LookupRecorder/LookupRecorder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr std::size_t cultureLookups = 20000;
+constexpr std::size_t religionLookups = 20000;
+constexpr std::size_t regionLookups = 20000;
+constexpr std::size_t tagLookups = 5000;
+constexpr std::size_t provinceLookups = 20000;
+
+// The file without its comments, the usage notes at the top of each mapping file spell out example keys.
+std::string readFile(const std::string& path)
+{
+	std::ifstream input(path, std::ios::binary);
+	if (!input.is_open())
+		throw std::runtime_error("Could not open " + path);
+	std::string contents;
+	std::string line;
+	while (std::getline(input, line))
+		contents += line.substr(0, line.find('#')) + "\n";
+	return contents;
+}
+
+// Every distinct value after "<key> =" in the file, in order of first appearance.
+std::vector<std::string> valuesOf(const std::string& text, const std::string& key)
+{
+	const std::regex pattern("(?:^|[\\s{])" + key + "\\s*=\\s*([^\\s{}#]+)");
+	std::vector<std::string> values;
+	std::set<std::string> seen;
+	for (auto match = std::sregex_iterator(text.begin(), text.end(), pattern); match != std::sregex_iterator(); ++match)
+		if (seen.insert((*match)[1]).second)
+			values.emplace_back((*match)[1]);
+	return values;
+}
+
+std::vector<int> numbersOf(const std::string& text, const std::string& key)
+{
+	std::vector<int> numbers;
+	for (const auto& value: valuesOf(text, key))
+		if (!value.empty() && std::all_of(value.begin(), value.end(), ::isdigit))
+			numbers.emplace_back(std::stoi(value));
+	std::sort(numbers.begin(), numbers.end());
+	return numbers;
+}
+
+// Picks from keys with probability falling off as 1/rank, after a fixed shuffle so the favourites aren't just the
+// first lines of the file.
+template <typename Key> class Skewed
+{
+  public:
+	Skewed(std::vector<Key> theKeys, std::mt19937& theRandom): keys(std::move(theKeys)), random(theRandom)
+	{
+		if (keys.empty())
+			throw std::runtime_error("Nothing to build a lookup trace from");
+		std::shuffle(keys.begin(), keys.end(), random);
+		std::vector<double> weights;
+		for (std::size_t rank = 1; rank <= keys.size(); ++rank)
+			weights.emplace_back(1.0 / static_cast<double>(rank));
+		distribution = std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+	}
+	const Key& operator()() { return keys[distribution(random)]; }
+
+  private:
+	std::vector<Key> keys;
+	std::mt19937& random;
+	std::discrete_distribution<std::size_t> distribution;
+};
+
+std::string orEmpty(const std::string& field)
+{
+	return field == "-" ? std::string() : field;
+}
+
+std::string textOf(const mappers::LookupRecorder::Value& value)
+{
+	const auto* text = std::get_if<std::string>(&value);
+	return text ? *text : std::string();
+}
+
+int numberOf(const mappers::LookupRecorder::Value& value)
+{
+	const auto* number = std::get_if<long long>(&value);
+	return number ? static_cast<int>(*number) : 0;
+}
+
+// A lookup_trace recording. Only the arguments are kept, the answers are the replay tool's business.
+lookups::Trace readRecording(const std::string& path)
+{
+	using CALL = mappers::LookupRecorder::CALL;
+	lookups::Trace trace;
+	for (const auto& call: mappers::LookupRecorder::read(path))
+	{
+		const auto& arguments = call.arguments;
+		switch (call.call)
+		{
+			case CALL::CULTURE:
+			case CALL::CULTURE_REGIONAL:
+			case CALL::CULTURE_NONREGIONAL_NONRELIGIOUS:
+				trace.cultures.emplace_back(lookups::CultureLookup{textOf(arguments[0]), textOf(arguments[1]), numberOf(arguments[2]), textOf(arguments[3])});
+				break;
+			case CALL::RELIGION:
+				trace.religions.emplace_back(textOf(arguments[0]));
+				break;
+			case CALL::REGION:
+				trace.regions.emplace_back(lookups::RegionLookup{numberOf(arguments[0]), textOf(arguments[1])});
+				break;
+			case CALL::TAG:
+				trace.tags.emplace_back(lookups::TagLookup{textOf(arguments[0]), textOf(arguments[1]), numberOf(arguments[2])});
+				break;
+			case CALL::PROVINCE:
+				trace.provinces.emplace_back(numberOf(arguments[0]));
+				break;
+			default:
+				break;
+		}
+	}
+	return trace;
+}
+
+lookups::Trace readTrace(const std::string& path)
+{
+	lookups::Trace trace;
+	std::ifstream input(path);
+	if (!input.is_open())
+		throw std::runtime_error("Could not open lookup trace " + path);
+	std::string header(mappers::LookupRecorder::magic.size(), '\0');
+	if (input.read(header.data(), static_cast<std::streamsize>(header.size())) && header == mappers::LookupRecorder::magic)
+		return readRecording(path);
+	input.clear();
+	input.seekg(0);
+	std::string line;
+	while (std::getline(input, line))
+	{
+		std::istringstream fields(line);
+		std::string kind;
+		fields >> kind;
+		if (kind == "culture")
+		{
+			lookups::CultureLookup lookup;
+			fields >> lookup.ck2Culture >> lookup.eu4Religion >> lookup.eu4Province >> lookup.eu4Owner;
+			lookup.eu4Religion = orEmpty(lookup.eu4Religion);
+			lookup.eu4Owner = orEmpty(lookup.eu4Owner);
+			trace.cultures.emplace_back(std::move(lookup));
+		}
+		else if (kind == "religion")
+		{
+			std::string religion;
+			fields >> religion;
+			trace.religions.emplace_back(std::move(religion));
+		}
+		else if (kind == "region")
+		{
+			lookups::RegionLookup lookup;
+			fields >> lookup.eu4Province >> lookup.region;
+			trace.regions.emplace_back(std::move(lookup));
+		}
+		else if (kind == "tag")
+		{
+			lookups::TagLookup lookup;
+			fields >> lookup.ck2Title >> lookup.ck2BaseTitle >> lookup.eu4Capital;
+			lookup.ck2BaseTitle = orEmpty(lookup.ck2BaseTitle);
+			trace.tags.emplace_back(std::move(lookup));
+		}
+		else if (kind == "province")
+		{
+			int province = 0;
+			fields >> province;
+			trace.provinces.emplace_back(province);
+		}
+	}
+	return trace;
+}
+
+std::vector<std::string> regionNames(const std::string& suffixFilter, const bool wanted)
+{
+	std::vector<std::string> names;
+	for (const auto& region: valuesOf(readFile("configurables/culture_map.txt"), "region"))
+	{
+		const auto matches = region.size() > suffixFilter.size() && region.compare(region.size() - suffixFilter.size(), suffixFilter.size(), suffixFilter) == 0;
+		if (matches == wanted)
+			names.emplace_back(region);
+	}
+	return names;
+}
+
+lookups::Trace synthesiseTrace()
+{
+	const auto cultureMap = readFile("configurables/culture_map.txt");
+	const auto religionMap = readFile("configurables/religion_map.txt");
+	const auto tagMappings = readFile("configurables/tag_mappings.txt");
+	const auto provinceMappings = readFile("configurables/province_mappings.txt");
+	const auto eu4Provinces = numbersOf(provinceMappings, "eu4");
+
+	std::vector<std::string> regions;
+	for (const auto& region: valuesOf(cultureMap, "region"))
+		regions.emplace_back(region);
+	// Titles the mappings don't know fall through every rule; a real save has plenty.
+	auto titles = valuesOf(tagMappings, "ck2");
+	for (std::size_t unmapped = 0; unmapped < titles.size() / 4; ++unmapped)
+		titles.emplace_back("d_unmapped_" + std::to_string(unmapped));
+
+	std::mt19937 random(1066);
+	Skewed cultures(valuesOf(cultureMap, "ck2"), random);
+	Skewed eu4Religions(valuesOf(religionMap, "eu4"), random);
+	Skewed ck2Religions(valuesOf(religionMap, "ck2"), random);
+	Skewed owners(valuesOf(tagMappings, "eu4"), random);
+	Skewed provinces(eu4Provinces, random);
+	Skewed regionPicker(regions, random);
+	Skewed titlePicker(titles, random);
+	Skewed ck2Provinces(numbersOf(provinceMappings, "ck2"), random);
+
+	lookups::Trace trace;
+	for (std::size_t lookup = 0; lookup < cultureLookups; ++lookup)
+		// Advisers, heirs and spouses ask without a province; province cultures ask with one.
+		trace.cultures.emplace_back(lookups::CultureLookup{cultures(), eu4Religions(), lookup % 3 ? provinces() : 0, owners()});
+	for (std::size_t lookup = 0; lookup < religionLookups; ++lookup)
+		trace.religions.emplace_back(ck2Religions());
+	for (std::size_t lookup = 0; lookup < regionLookups; ++lookup)
+		trace.regions.emplace_back(lookups::RegionLookup{provinces(), regionPicker()});
+	for (std::size_t lookup = 0; lookup < tagLookups; ++lookup)
+	{
+		const auto& title = titlePicker();
+		trace.tags.emplace_back(lookups::TagLookup{title, title, provinces()});
+	}
+	for (std::size_t lookup = 0; lookup < provinceLookups; ++lookup)
+		trace.provinces.emplace_back(ck2Provinces());
+	return trace;
+}
+
+// Hands out names in order, then numbered fillers once the named ones run out.
+class Names
+{
+  public:
+	Names(std::vector<std::string> theNames, std::string theFiller): names(std::move(theNames)), filler(std::move(theFiller)) {}
+	std::string next()
+	{
+		if (used < names.size())
+			return names[used++];
+		return filler + std::to_string(used++ - names.size());
+	}
+	[[nodiscard]] bool exhausted() const { return used >= names.size(); }
+
+  private:
+	std::vector<std::string> names;
+	std::string filler;
+	std::size_t used = 0;
+};
+
+lookups::RegionFiles buildRegionFiles()
+{
+	constexpr std::size_t provincesPerArea = 6;
+	constexpr std::size_t areasPerRegion = 5;
+	constexpr std::size_t regionsPerSuperRegion = 6;
+	const auto provinces = numbersOf(readFile("configurables/province_mappings.txt"), "eu4");
+
+	Names areaNames(regionNames("_area", true), "filler_area_");
+	std::vector<std::string> regionLike;
+	for (const auto& name: regionNames("_area", false))
+		if (name.size() < 12 || name.compare(name.size() - 12, 12, "_superregion") != 0)
+			regionLike.emplace_back(name);
+	Names regionNamer(regionLike, "filler_region_");
+	Names superRegionNamer(regionNames("_superregion", true), "filler_superregion_");
+
+	lookups::RegionFiles files;
+	std::vector<std::string> areas;
+	for (std::size_t first = 0; first < provinces.size() || !areaNames.exhausted(); first += provincesPerArea)
+	{
+		areas.emplace_back(areaNames.next());
+		files.areas += areas.back() + " = {";
+		for (auto province = first; province < std::min(first + provincesPerArea, provinces.size()); ++province)
+			files.areas += " " + std::to_string(provinces[province]);
+		files.areas += " }\n";
+	}
+	std::vector<std::string> regions;
+	for (std::size_t first = 0; first < areas.size() || !regionNamer.exhausted(); first += areasPerRegion)
+	{
+		regions.emplace_back(regionNamer.next());
+		files.regions += regions.back() + " = { areas = {";
+		for (auto area = first; area < std::min(first + areasPerRegion, areas.size()); ++area)
+			files.regions += " " + areas[area];
+		files.regions += " } }\n";
+	}
+	for (std::size_t first = 0; first < regions.size() || !superRegionNamer.exhausted(); first += regionsPerSuperRegion)
+	{
+		files.superRegions += superRegionNamer.next() + " = {";
+		for (auto region = first; region < std::min(first + regionsPerSuperRegion, regions.size()); ++region)
+			files.superRegions += " " + regions[region];
+		files.superRegions += " }\n";
+	}
+	return files;
+}
+} // namespace
+
+const lookups::Trace& lookups::trace()
+{
+	static const auto theTrace = [] {
+		if (const auto* path = std::getenv("CK2TOEU4_LOOKUP_TRACE"); path && *path)
+			return readTrace(path);
+		return synthesiseTrace();
+	}();
+	return theTrace;
+}
+
+const lookups::RegionFiles& lookups::regionFiles()
+{
+	static const auto files = buildRegionFiles();
+	return files;
+}
+
+void lookups::enterDataFiles()
+{
+	static const auto entered = [] {
+		fs::current_path(fs::u8path(CK2TOEU4_DATA_FILES));
+		return true;
+	}();
+	(void)entered;
+}
@@ -0,0 +1,63 @@
+#ifndef CK2TOEU4_LOOKUP_TRACE_H
+#define CK2TOEU4_LOOKUP_TRACE_H
+#include <string>
+#include <vector>
+
+// The mapper lookups a conversion makes, in the order it makes them. A trace is read from the file named by
+// CK2TOEU4_LOOKUP_TRACE when that is set, one lookup per line ("-" for an empty argument):
+//   culture <ck2 culture> <eu4 religion> <eu4 province> <eu4 owner tag>
+//   religion <ck2 religion>
+//   region <eu4 province> <region>
+//   tag <ck2 title> <ck2 base title> <eu4 capital>
+//   province <ck2 province>
+// or, with the same variable, from a recording the converter made with lookup_trace = 2.
+// Otherwise one is synthesised from the keys in configurables/, skewed the way a conversion is: a few cultures,
+// religions and regions take most of the lookups, and most titles are asked about once or twice.
+namespace lookups
+{
+struct CultureLookup
+{
+	std::string ck2Culture;
+	std::string eu4Religion;
+	int eu4Province = 0;
+	std::string eu4Owner;
+};
+struct RegionLookup
+{
+	int eu4Province = 0;
+	std::string region;
+};
+struct TagLookup
+{
+	std::string ck2Title;
+	std::string ck2BaseTitle;
+	int eu4Capital = 0;
+};
+
+struct Trace
+{
+	std::vector<CultureLookup> cultures;
+	std::vector<std::string> religions;
+	std::vector<RegionLookup> regions;
+	std::vector<TagLookup> tags;
+	std::vector<int> provinces;
+};
+
+// Loaded or synthesised once; expects the working directory to be Data_Files (see enterDataFiles()).
+const Trace& trace();
+
+// The region mapper normally reads EU4's map files, which aren't ours to ship. These are stand-ins: every eu4 province
+// in province_mappings.txt, grouped into every area, region and superregion culture_map.txt names, plus fillers.
+struct RegionFiles
+{
+	std::string areas;
+	std::string regions;
+	std::string superRegions;
+};
+const RegionFiles& regionFiles();
+
+// Moves into the converter's Data_Files, where the mappers look for configurables/.
+void enterDataFiles();
+} // namespace lookups
+
+#endif // CK2TOEU4_LOOKUP_TRACE_H
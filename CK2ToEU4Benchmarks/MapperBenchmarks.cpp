@@ -0,0 +1,55 @@
+#include "../CK2ToEU4/Source/EU4World/Province/ProvinceDetails.h"
+#include "../CK2ToEU4/Source/Mappers/ColorScraper/ColorScraper.h"
+#include "../CK2ToEU4/Source/Mappers/ProvinceTitleMapper/ProvinceTitleGrabber.h"
+#include "Fixtures.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+
+// These all read from disk, so the numbers include opening the file; the OS cache keeps it off the actual drive.
+namespace
+{
+void BM_ProvinceTitleGrabber(benchmark::State& state)
+{
+	const auto path = fixtures::provinceHistoryFile(42);
+	const auto size = static_cast<int64_t>(std::filesystem::file_size(path));
+	for (auto _: state)
+	{
+		const mappers::ProvinceTitleGrabber grabber(path);
+		benchmark::DoNotOptimize(grabber.getTitle().size());
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ProvinceTitleGrabber);
+
+void BM_ColorScraper(benchmark::State& state)
+{
+	const auto path = fixtures::landedTitlesFile(static_cast<std::size_t>(state.range(0)));
+	const auto size = static_cast<int64_t>(std::filesystem::file_size(path));
+	std::size_t titles = 0;
+	for (auto _: state)
+	{
+		mappers::ColorScraper scraper;
+		scraper.scrapeColors(path);
+		titles = scraper.getColors().size();
+		benchmark::DoNotOptimize(titles);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(titles));
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ColorScraper)->Arg(10)->Arg(500);
+
+void BM_ProvinceDetails(benchmark::State& state)
+{
+	const auto path = fixtures::eu4ProvinceHistoryFile();
+	const auto size = static_cast<int64_t>(std::filesystem::file_size(path));
+	for (auto _: state)
+	{
+		const EU4::ProvinceDetails details(path);
+		benchmark::DoNotOptimize(details.baseTax);
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ProvinceDetails);
+} // namespace
@@ -0,0 +1,291 @@
+#include "SaveGenerator.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+constexpr std::size_t baroniesPerProvince = 3;
+constexpr std::size_t fanOut = 4; // counties per duchy, duchies per kingdom, kingdoms per empire
+constexpr std::size_t firstDynasty = 1000;
+
+const char* const cultures[] = {"norse", "swedish", "english", "frankish", "greek", "arabic", "persian", "mongol"};
+const char* const religions[] = {"catholic", "orthodox", "norse_pagan", "sunni", "shiite", "zoroastrian", "tengri_pagan", "jewish"};
+const char* const governments[] = {"feudal_government", "iqta_government", "tribal_government", "republic_government"};
+
+const char* culture(const std::size_t index)
+{
+	return cultures[index % std::size(cultures)];
+}
+
+const char* religion(const std::size_t index)
+{
+	return religions[index % std::size(religions)];
+}
+
+std::size_t tierCount(const std::size_t below)
+{
+	return std::max<std::size_t>(1, (below + fanOut - 1) / fanOut);
+}
+
+// Landed titles are numbered per tier; the county of province N is c_gen<N>, its liege d_gen<N / fanOut>, and so on.
+struct Hierarchy
+{
+	explicit Hierarchy(const generator::Scale& scale):
+		 counties(std::max<std::size_t>(1, scale.provinces)), duchies(tierCount(counties)), kingdoms(tierCount(duchies)), empires(tierCount(kingdoms)),
+		 landed(counties * (baroniesPerProvince + 1) + duchies + kingdoms + empires), titular(scale.titles > landed ? scale.titles - landed : 0)
+	{
+	}
+	std::size_t counties;
+	std::size_t duchies;
+	std::size_t kingdoms;
+	std::size_t empires;
+	std::size_t landed;
+	std::size_t titular;
+};
+
+std::string barony(const std::size_t province, const std::size_t index)
+{
+	return "b_gen" + std::to_string(province) + "_" + std::to_string(index);
+}
+
+std::size_t holderOf(const std::size_t titleNumber, const generator::Scale& scale)
+{
+	return titleNumber % std::max<std::size_t>(1, scale.characters) + 1;
+}
+
+// The title this character holds as primary, if any: the first characters rule the top tiers, the rest counties.
+std::string primaryTitleOf(const std::size_t character, const Hierarchy& hierarchy)
+{
+	auto index = character - 1;
+	if (index < hierarchy.empires)
+		return "e_gen" + std::to_string(index);
+	index -= hierarchy.empires;
+	if (index < hierarchy.kingdoms)
+		return "k_gen" + std::to_string(index);
+	index -= hierarchy.kingdoms;
+	if (index < hierarchy.duchies)
+		return "d_gen" + std::to_string(index);
+	index -= hierarchy.duchies;
+	if (index < hierarchy.counties)
+		return "c_gen" + std::to_string(index + 1);
+	return std::string();
+}
+
+void writeTitle(std::ostream& output, const std::string& name, const std::size_t holder, const std::string& liege, const std::size_t seed)
+{
+	output << "\t" << name << "=\n\t{\n";
+	output << "\t\tholder=" << holder << "\n";
+	output << "\t\tlaw=\"succ_" << (seed % 2 ? "primogeniture" : "gavelkind") << "\"\n";
+	output << "\t\tlaw=\"centralization_" << seed % 5 << "\"\n";
+	output << "\t\tlaw=\"revoke_title_voting_power_0\"\n";
+	output << "\t\tsuccession=\"" << (seed % 2 ? "primogeniture" : "gavelkind") << "\"\n";
+	output << "\t\tgender=\"agnatic\"\n";
+	output << "\t\tprevious={ " << holder << " " << holder + 1 << " }\n";
+	if (!liege.empty())
+	{
+		output << "\t\tliege=\n\t\t{\n\t\t\ttitle=\"" << liege << "\"\n\t\t\tbase_title=\"" << liege << "\"\n\t\t\tis_custom=no\n\t\t\tis_dynamic=no\n\t\t}\n";
+		output << "\t\tde_jure_liege=\"" << liege << "\"\n";
+	}
+	output << "\t\thistory={ 1066.9.15={ holder=" << holder << " } }\n";
+	output << "\t}\n";
+}
+} // namespace
+
+generator::Scale generator::Scale::times(const std::size_t factor) const
+{
+	auto scaled = *this;
+	for (auto* count: {&scaled.characters, &scaled.provinces, &scaled.titles, &scaled.dynasties, &scaled.relations, &scaled.wonders, &scaled.offmaps})
+		*count *= factor;
+	return scaled;
+}
+
+void generator::writeGamestate(const Scale& scale, std::ostream& output)
+{
+	output << "CK2txt\n";
+	output << "version=\"3.3.3.0\"\n";
+	output << "date=\"1444.11.11\"\n";
+	output << "start_date=\"1066.9.15\"\n";
+	output << "flags=\n{\n\tgenerated_save=1066.9.15\n}\n";
+	output << "dynasties";
+	writeDynasties(scale, output);
+	output << "\ncharacter";
+	writeCharacters(scale, output);
+	output << "\nreligion=\n{\n";
+	for (const auto* name: religions)
+		output << "\t" << name << "=\n\t{\n\t\tfeatures={ religion_feature_generated }\n\t}\n";
+	output << "}\n";
+	output << "provinces";
+	writeProvinces(scale, output);
+	output << "\ntitle";
+	writeTitles(scale, output);
+	output << "\nrelation";
+	writeRelations(scale, output);
+	output << "\nwonder";
+	writeWonders(scale, output);
+	output << "\noffmap_powers";
+	writeOffmaps(scale, output);
+	output << "\nvars=\n{\n\tgenerated_save_counter=1.000\n}\n";
+}
+
+void generator::writeCharacters(const Scale& scale, std::ostream& output)
+{
+	const Hierarchy hierarchy(scale);
+	output << "=\n{\n";
+	for (std::size_t character = 1; character <= scale.characters; ++character)
+	{
+		output << "\t" << character << "=\n\t{\n";
+		output << "\t\tbn=\"Generated " << character << "\"\n";
+		output << "\t\tb_d=\"" << 1000 + character % 60 << "." << 1 + character % 12 << "." << 1 + character % 28 << "\"\n";
+		if (character % 3 == 0)
+			output << "\t\td_d=\"" << 1100 + character % 300 << ".1.1\"\n";
+		if (character % 2 == 0)
+			output << "\t\tfem=yes\n";
+		if (scale.dynasties)
+			output << "\t\tdnt=" << firstDynasty + character % scale.dynasties << "\n";
+		if (character > 2)
+			output << "\t\tfat=" << character - 2 << "\n\t\tmot=" << character - 1 << "\n";
+		if (character + 1 <= scale.characters)
+			output << "\t\tspouse=" << character + 1 << "\n";
+		output << "\t\tcul=\"" << culture(character) << "\"\n";
+		output << "\t\trel=\"" << religion(character) << "\"\n";
+		output << "\t\tgov=\"" << governments[character % std::size(governments)] << "\"\n";
+		output << "\t\tatt={ " << character % 20 << " " << character % 17 << " " << character % 13 << " " << character % 11 << " " << character % 7 << " }\n";
+		output << "\t\ttr={ " << 1 + character % 90 << " " << 1 + character % 70 << " " << 1 + character % 50 << " }\n";
+		output << "\t\tpiety=" << character % 500 << ".250\n";
+		output << "\t\twealth=" << character % 1000 << ".500\n";
+		output << "\t\tprs=" << character % 2000 << ".125\n";
+		if (character > 1)
+			output << "\t\tlge=" << (character - 1) / fanOut + 1 << "\n\t\thost=" << (character - 1) / fanOut + 1 << "\n";
+		if (const auto primary = primaryTitleOf(character, hierarchy); !primary.empty())
+		{
+			const auto capitalProvince = (character - 1) % hierarchy.counties + 1;
+			output << "\t\tdmn=\n\t\t{\n\t\t\tcapital=\"" << barony(capitalProvince, 0) << "\"\n";
+			output << "\t\t\tprimary=\n\t\t\t{\n\t\t\t\ttitle=\"" << primary << "\"\n\t\t\t\tbase_title=\"" << primary << "\"\n\t\t\t\tis_custom=no\n\t\t\t}\n\t\t}\n";
+		}
+		if (character % 10 == 0)
+			output << "\t\tjob=\"job_chancellor\"\n";
+		if (character % 25 == 0)
+			output << "\t\tmd={ modifier=\"borrowed_from_jews\" date=\"1300.1.1\" }\n";
+		output << "\t\tact={ 0=" << character % 5 << " 1=" << character % 9 << " }\n";
+		output << "\t\temi=" << character % 3 << "\n";
+		output << "\t}\n";
+	}
+	output << "}";
+}
+
+void generator::writeTitles(const Scale& scale, std::ostream& output)
+{
+	const Hierarchy hierarchy(scale);
+	output << "=\n{\n";
+	std::size_t titleNumber = 0;
+	for (std::size_t empire = 0; empire < hierarchy.empires; ++empire, ++titleNumber)
+		writeTitle(output, "e_gen" + std::to_string(empire), empire + 1, "", titleNumber);
+	for (std::size_t kingdom = 0; kingdom < hierarchy.kingdoms; ++kingdom, ++titleNumber)
+		writeTitle(output, "k_gen" + std::to_string(kingdom), hierarchy.empires + kingdom + 1, "e_gen" + std::to_string(kingdom / fanOut), titleNumber);
+	for (std::size_t duchy = 0; duchy < hierarchy.duchies; ++duchy, ++titleNumber)
+		writeTitle(output, "d_gen" + std::to_string(duchy), hierarchy.empires + hierarchy.kingdoms + duchy + 1, "k_gen" + std::to_string(duchy / fanOut), titleNumber);
+	for (std::size_t county = 0; county < hierarchy.counties; ++county, ++titleNumber)
+	{
+		const auto province = county + 1;
+		const auto countyName = "c_gen" + std::to_string(province);
+		writeTitle(output, countyName, holderOf(hierarchy.empires + hierarchy.kingdoms + hierarchy.duchies + county, scale), "d_gen" + std::to_string(county / fanOut), titleNumber);
+		for (std::size_t index = 0; index < baroniesPerProvince; ++index, ++titleNumber)
+			writeTitle(output, barony(province, index), holderOf(titleNumber, scale), countyName, titleNumber);
+	}
+	for (std::size_t titular = 0; titular < hierarchy.titular; ++titular, ++titleNumber)
+		writeTitle(output, "d_titular_gen" + std::to_string(titular), holderOf(titleNumber, scale), "", titleNumber);
+	output << "}";
+}
+
+void generator::writeProvinces(const Scale& scale, std::ostream& output)
+{
+	output << "=\n{\n";
+	for (std::size_t province = 1; province <= scale.provinces; ++province)
+	{
+		output << "\t" << province << "=\n\t{\n";
+		output << "\t\tname=\"Generated " << province << "\"\n";
+		output << "\t\tculture=\"" << culture(province) << "\"\n";
+		output << "\t\treligion=\"" << religion(province) << "\"\n";
+		output << "\t\tmax_settlements=" << baroniesPerProvince + 2 << "\n";
+		output << "\t\tprimary_settlement=\"" << barony(province, 0) << "\"\n";
+		static const char* const holdings[] = {"castle", "city", "temple"};
+		for (std::size_t index = 0; index < baroniesPerProvince; ++index)
+			output << "\t\t" << barony(province, index) << "=\n\t\t{\n\t\t\ttype=" << holdings[index % std::size(holdings)]
+					 << "\n\t\t\tca_wall_1=yes\n\t\t\tca_keep_1=yes\n\t\t\tlevy=" << index + 1 << ".500\n\t\t}\n";
+		output << "\t\tmodifier={ modifier=\"generated_modifier\" date=\"1066.9.15\" }\n";
+		output << "\t}\n";
+	}
+	output << "}";
+}
+
+void generator::writeDynasties(const Scale& scale, std::ostream& output)
+{
+	output << "=\n{\n";
+	for (std::size_t dynasty = 0; dynasty < scale.dynasties; ++dynasty)
+	{
+		output << "\t" << firstDynasty + dynasty << "=\n\t{\n";
+		output << "\t\tname=\"Generated " << dynasty << "\"\n";
+		output << "\t\tculture=\"" << culture(dynasty) << "\"\n";
+		output << "\t\treligion=\"" << religion(dynasty) << "\"\n";
+		output << "\t\tcoat_of_arms=\n\t\t{\n\t\t\tdata={ 0 0 " << dynasty % 30 << " 0 " << dynasty % 12 << " 0 0 }\n\t\t\treligion=\"" << religion(dynasty)
+				 << "\"\n\t\t}\n";
+		output << "\t}\n";
+	}
+	output << "}";
+}
+
+void generator::writeRelations(const Scale& scale, std::ostream& output)
+{
+	// One diplo_ entry per relation, every fourth of them a tributary arrangement.
+	output << "=\n{\n";
+	const auto characters = std::max<std::size_t>(1, scale.characters);
+	for (std::size_t relation = 0; relation < scale.relations; ++relation)
+	{
+		const auto first = relation % characters + 1;
+		const auto second = (relation * 7 + 3) % characters + 1;
+		output << "\tdiplo_" << first << "=\n\t{\n\t\t" << second << "=\n\t\t{\n";
+		if (relation % 4 == 0)
+			output << "\t\t\ttributary=\n\t\t\t{\n\t\t\t\ttributary_type=default\n\t\t\t\ttributary=" << second << "\n\t\t\t}\n";
+		output << "\t\t\tlast_send_gift=\"1400.1.1\"\n\t\t}\n\t}\n";
+	}
+	output << "}";
+}
+
+void generator::writeWonders(const Scale& scale, std::ostream& output)
+{
+	static const char* const types[] = {"wonder_pagan_stones_stonehenge", "wonder_cathedral", "wonder_mosque", "wonder_lighthouse"};
+	output << "=\n{\n";
+	const auto provinces = std::max<std::size_t>(1, scale.provinces);
+	for (std::size_t wonder = 1; wonder <= scale.wonders; ++wonder)
+	{
+		output << "\t" << wonder << "=\n\t{\n";
+		output << "\t\ttype=\"" << types[wonder % std::size(types)] << "\"\n";
+		output << "\t\tname=\"Generated Wonder " << wonder << "\"\n";
+		output << "\t\tdesc=\"generated_wonder_desc\"\n";
+		output << "\t\tprovince=" << (wonder * 13) % provinces + 1 << "\n";
+		output << "\t\tstage=" << wonder % 4 << "\n";
+		output << "\t\tactive=" << (wonder % 5 ? "yes" : "no") << "\n";
+		output << "\t\tconstruction_history=\n\t\t{\n";
+		for (std::size_t step = 0; step < 2; ++step)
+			output << "\t\t\t{\n\t\t\t\twonder_historical_event_date=\"" << 1100 + step * 50 << ".1.1\"\n\t\t\t\twonder_historical_event_character="
+					 << holderOf(wonder + step, scale) << "\n\t\t\t\twonder_upgrade=\"upgrade_generated_" << step << "\"\n\t\t\t}\n";
+		output << "\t\t}\n";
+		output << "\t}\n";
+	}
+	output << "}";
+}
+
+void generator::writeOffmaps(const Scale& scale, std::ostream& output)
+{
+	static const char* const types[] = {"offmap_china", "offmap_india", "offmap_byzantium", "offmap_persia"};
+	output << "=\n{\n";
+	for (std::size_t offmap = 1; offmap <= scale.offmaps; ++offmap)
+	{
+		output << "\t" << offmap << "=\n\t{\n";
+		output << "\t\ttype=\"" << types[offmap % std::size(types)] << "\"\n";
+		output << "\t\tholder=" << holderOf(offmap, scale) << "\n";
+		output << "\t\tnames={ \"Generated Empire\" \"Generated Dynasty " << offmap << "\" }\n";
+		output << "\t}\n";
+	}
+	output << "}";
+}
@@ -0,0 +1,39 @@
+#ifndef CK2TOEU4_SAVE_GENERATOR_H
+#define CK2TOEU4_SAVE_GENERATOR_H
+#include <cstddef>
+#include <ostream>
+
+// Writes structurally valid CK2 gamestates of any size, in the key layout CK2::World and its blocks parse. Nothing in
+// them comes from a real save; names are numbered and every cross-reference (holders, lieges, dynasties, baronies,
+// tributaries) points at something the same save defines, so linking does its full amount of work.
+namespace generator
+{
+struct Scale
+{
+	// Roughly a late-game vanilla save. Landed titles follow from provinces: three baronies and a county per province,
+	// a duchy per four counties, and so on up to empires. Titles past that are titular duchies.
+	std::size_t characters = 200000;
+	std::size_t provinces = 1300;
+	std::size_t titles = 8000;
+	std::size_t dynasties = 40000;
+	std::size_t relations = 20000;
+	std::size_t wonders = 30;
+	std::size_t offmaps = 4;
+
+	[[nodiscard]] Scale times(std::size_t factor) const;
+};
+
+// The whole uncompressed gamestate, "CK2txt" header to closing brace.
+void writeGamestate(const Scale& scale, std::ostream& output);
+
+// The blocks on their own, each as "={ ... }" the way the save hands it to the matching CK2World class.
+void writeCharacters(const Scale& scale, std::ostream& output);
+void writeTitles(const Scale& scale, std::ostream& output);
+void writeProvinces(const Scale& scale, std::ostream& output);
+void writeDynasties(const Scale& scale, std::ostream& output);
+void writeRelations(const Scale& scale, std::ostream& output);
+void writeWonders(const Scale& scale, std::ostream& output);
+void writeOffmaps(const Scale& scale, std::ostream& output);
+} // namespace generator
+
+#endif // CK2TOEU4_SAVE_GENERATOR_H
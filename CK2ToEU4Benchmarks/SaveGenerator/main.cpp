@@ -0,0 +1,56 @@
+#include "SaveGenerator.h"
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+// CK2SaveGenerator <output.ck2> [--scale N] [--characters N] [--provinces N] [--titles N] [--dynasties N]
+//                  [--relations N] [--wonders N] [--offmaps N]
+// --scale multiplies the default (or earlier) counts; counts given after it are taken as they are.
+int main(const int argc, const char* argv[])
+{
+	if (argc < 2 || argc % 2 != 0)
+	{
+		std::cerr << "Usage: CK2SaveGenerator <output.ck2> [--scale N] [--characters N] [--provinces N] [--titles N] [--dynasties N] "
+						 "[--relations N] [--wonders N] [--offmaps N]\n";
+		return -1;
+	}
+
+	generator::Scale scale;
+	const std::map<std::string, std::size_t generator::Scale::*> counts = {{"--characters", &generator::Scale::characters},
+		 {"--provinces", &generator::Scale::provinces},
+		 {"--titles", &generator::Scale::titles},
+		 {"--dynasties", &generator::Scale::dynasties},
+		 {"--relations", &generator::Scale::relations},
+		 {"--wonders", &generator::Scale::wonders},
+		 {"--offmaps", &generator::Scale::offmaps}};
+	try
+	{
+		for (auto arg = 2; arg < argc; arg += 2)
+		{
+			const std::string option = argv[arg];
+			const auto value = static_cast<std::size_t>(std::stoull(argv[arg + 1]));
+			if (option == "--scale")
+				scale = scale.times(value);
+			else if (const auto& count = counts.find(option); count != counts.end())
+				scale.*(count->second) = value;
+			else
+				throw std::invalid_argument("Unknown option " + option);
+		}
+
+		std::ofstream output(argv[1], std::ios::binary);
+		if (!output.is_open())
+			throw std::runtime_error("Could not create " + std::string(argv[1]));
+		generator::writeGamestate(scale, output);
+		output.close();
+		std::cout << "Wrote " << argv[1] << ": " << scale.characters << " characters, " << scale.provinces << " provinces, " << scale.titles
+					 << " titles, " << scale.dynasties << " dynasties, " << scale.relations << " relations, " << scale.wonders << " wonders, "
+					 << scale.offmaps << " offmaps.\n";
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+		return -1;
+	}
+}
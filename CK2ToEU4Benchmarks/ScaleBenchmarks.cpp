@@ -0,0 +1,135 @@
+#include "../CK2ToEU4/Source/CK2World/Characters/Characters.h"
+#include "../CK2ToEU4/Source/CK2World/Dynasties/Dynasties.h"
+#include "../CK2ToEU4/Source/CK2World/Offmaps/Offmaps.h"
+#include "../CK2ToEU4/Source/CK2World/Provinces/Provinces.h"
+#include "../CK2ToEU4/Source/CK2World/Relations/AllRelations.h"
+#include "../CK2ToEU4/Source/CK2World/Titles/Titles.h"
+#include "../CK2ToEU4/Source/CK2World/Wonders/Wonders.h"
+#include "SaveGenerator/SaveGenerator.h"
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <sstream>
+
+// Every block of a generated save at a tenth of a real one and at its full size, so a parse or link step whose time
+// grows faster than its input shows up as a widening gap between the two. CK2SaveGenerator writes the 10x and 100x
+// saves for whole-conversion runs; those don't fit comfortably in a benchmark's memory.
+namespace
+{
+generator::Scale tenthOfASave()
+{
+	generator::Scale scale;
+	scale.characters /= 10;
+	scale.provinces /= 10;
+	scale.titles /= 10;
+	scale.dynasties /= 10;
+	scale.relations /= 10;
+	scale.wonders /= 10;
+	scale.offmaps = 4;
+	return scale;
+}
+
+std::string generate(void (*writer)(const generator::Scale&, std::ostream&), const generator::Scale& scale)
+{
+	std::ostringstream block;
+	writer(scale, block);
+	return block.str();
+}
+
+void parseBlock(benchmark::State& state, void (*writer)(const generator::Scale&, std::ostream&), const std::function<std::size_t(std::istream&)>& parse)
+{
+	const auto block = generate(writer, tenthOfASave().times(static_cast<std::size_t>(state.range(0))));
+	std::size_t entities = 0;
+	for (auto _: state)
+	{
+		std::istringstream input(block);
+		entities = parse(input);
+		benchmark::DoNotOptimize(entities);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(entities));
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(block.size()));
+}
+
+void BM_ScaleCharacters(benchmark::State& state)
+{
+	parseBlock(state, generator::writeCharacters, [](std::istream& input) {
+		return CK2::Characters(input).getCharacters().size();
+	});
+}
+BENCHMARK(BM_ScaleCharacters)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+void BM_ScaleTitles(benchmark::State& state)
+{
+	parseBlock(state, generator::writeTitles, [](std::istream& input) {
+		return CK2::Titles(input).getTitles().size();
+	});
+}
+BENCHMARK(BM_ScaleTitles)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+void BM_ScaleProvinces(benchmark::State& state)
+{
+	parseBlock(state, generator::writeProvinces, [](std::istream& input) {
+		return CK2::Provinces(input).getProvinces().size();
+	});
+}
+BENCHMARK(BM_ScaleProvinces)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+void BM_ScaleDynasties(benchmark::State& state)
+{
+	parseBlock(state, generator::writeDynasties, [](std::istream& input) {
+		return CK2::Dynasties(input).getDynasties().size();
+	});
+}
+BENCHMARK(BM_ScaleDynasties)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+void BM_ScaleRelations(benchmark::State& state)
+{
+	parseBlock(state, generator::writeRelations, [](std::istream& input) {
+		return CK2::Diplomacy(input).getDiplomacy().size();
+	});
+}
+BENCHMARK(BM_ScaleRelations)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+void BM_ScaleWonders(benchmark::State& state)
+{
+	parseBlock(state, generator::writeWonders, [](std::istream& input) {
+		return CK2::Wonders(input).getWonders().size();
+	});
+}
+BENCHMARK(BM_ScaleWonders)->Arg(1)->Arg(10);
+
+void BM_ScaleOffmaps(benchmark::State& state)
+{
+	parseBlock(state, generator::writeOffmaps, [](std::istream& input) {
+		return CK2::Offmaps(input).getOffmaps().size();
+	});
+}
+BENCHMARK(BM_ScaleOffmaps)->Arg(1)->Arg(10);
+
+// The link passes that walk one table against another, over freshly parsed blocks each time.
+void BM_ScaleLinking(benchmark::State& state)
+{
+	const auto scale = tenthOfASave().times(static_cast<std::size_t>(state.range(0)));
+	const auto characterBlock = generate(generator::writeCharacters, scale);
+	const auto titleBlock = generate(generator::writeTitles, scale);
+	for (auto _: state)
+	{
+		state.PauseTiming();
+		std::istringstream characterInput(characterBlock);
+		CK2::Characters characters(characterInput);
+		std::istringstream titleInput(titleBlock);
+		CK2::Titles titles(titleInput);
+		state.ResumeTiming();
+
+		characters.linkLiegesAndSpouses();
+		characters.linkMothersAndFathers();
+		characters.linkPrimaryTitles(titles);
+		titles.linkHolders(characters);
+		titles.linkPreviousHolders(characters);
+		titles.linkLiegePrimaryTitles();
+		titles.linkVassals();
+		titles.linkBaseTitles();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(scale.characters + scale.titles));
+}
+BENCHMARK(BM_ScaleLinking)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,131 @@
+#include "../CK2ToEU4/Source/Configuration/BatchJobs.h"
+#include "../CK2ToEU4/Source/Configuration/Configuration.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+TEST(CK2ToEU4_BatchJobsTests, BatchDefaultsToOneConversionAtATime)
+{
+	std::stringstream input("");
+	const BatchJobs batch(input);
+
+	EXPECT_TRUE(batch.getJobs().empty());
+	EXPECT_EQ(1u, batch.getConversions());
+	EXPECT_EQ(0u, batch.getThreads());
+	EXPECT_EQ(0u, batch.getMemoryBudgetMB());
+	EXPECT_EQ(0u, batch.getCacheLimitMB());
+}
+
+TEST(CK2ToEU4_BatchJobsTests, JobsCanBeListed)
+{
+	std::stringstream input;
+	input << "conversions = \"3\"\n";
+	input << "threads = \"8\"\n";
+	input << "job = { save = \"saves/a.ck2\" configuration = \"a.txt\" output_name = \"first\" }\n";
+	input << "job = { save = \"saves/b.ck2\" }\n";
+	const BatchJobs batch(input);
+
+	EXPECT_EQ(3u, batch.getConversions());
+	EXPECT_EQ(8u, batch.getThreads());
+	ASSERT_EQ(2u, batch.getJobs().size());
+	EXPECT_EQ("saves/a.ck2", batch.getJobs()[0].save);
+	EXPECT_EQ("a.txt", batch.getJobs()[0].configuration);
+	EXPECT_EQ("first", batch.getJobs()[0].outputName);
+	EXPECT_EQ("saves/b.ck2", batch.getJobs()[1].save);
+	EXPECT_EQ("configuration.txt", batch.getJobs()[1].configuration);
+	EXPECT_TRUE(batch.getJobs()[1].outputName.empty());
+}
+
+TEST(CK2ToEU4_BatchJobsTests, JobsCanBePrioritizedAndCapped)
+{
+	std::stringstream input;
+	input << "memory_budget = \"16384\"\n";
+	input << "cache_limit = \"8192\"\n";
+	input << "job = { save = \"saves/a.ck2\" priority = interactive threads = \"2\" }\n";
+	input << "job = { save = \"saves/b.ck2\" priority = urgent }\n";
+	const BatchJobs batch(input);
+
+	EXPECT_EQ(16384u, batch.getMemoryBudgetMB());
+	EXPECT_EQ(8192u, batch.getCacheLimitMB());
+	ASSERT_EQ(2u, batch.getJobs().size());
+	EXPECT_EQ(BatchJobs::PRIORITY::INTERACTIVE, batch.getJobs()[0].priority);
+	EXPECT_EQ(2u, batch.getJobs()[0].threads);
+	EXPECT_EQ(BatchJobs::PRIORITY::BULK, batch.getJobs()[1].priority);
+	EXPECT_EQ(0u, batch.getJobs()[1].threads);
+}
+
+TEST(CK2ToEU4_BatchJobsTests, JobsWithoutASaveAreSkipped)
+{
+	std::stringstream input;
+	input << "job = { output_name = \"nothing\" }\n";
+	const BatchJobs batch(input);
+
+	EXPECT_TRUE(batch.getJobs().empty());
+}
+
+TEST(CK2ToEU4_BatchJobsTests, JobSettingsOverrideTheirConfiguration)
+{
+	std::ofstream("batchJobConfiguration.txt") << "SaveGame = \"other.ck2\"\noutput_name = \"other\"\nstart_date = \"2\"\n";
+	const BatchJobs::Job named{"saves/first save.ck2", "batchJobConfiguration.txt", "first"};
+	const BatchJobs::Job unnamed{"saves/second save.ck2", "batchJobConfiguration.txt", ""};
+
+	std::stringstream namedSettings(BatchJobs::settingsFor(named));
+	std::stringstream unnamedSettings(BatchJobs::settingsFor(unnamed));
+	const Configuration namedConfiguration(namedSettings);
+	const Configuration unnamedConfiguration(unnamedSettings);
+	std::filesystem::remove("batchJobConfiguration.txt");
+
+	EXPECT_EQ("saves/first save.ck2", namedConfiguration.getSaveGamePath());
+	EXPECT_EQ("first", namedConfiguration.getOutputName());
+	EXPECT_EQ(Configuration::STARTDATE::CK, namedConfiguration.getStartDateOption());
+	EXPECT_EQ("saves/second save.ck2", unnamedConfiguration.getSaveGamePath());
+	EXPECT_EQ("second_save", unnamedConfiguration.getOutputName());
+}
+
+TEST(CK2ToEU4_BatchJobsTests, MissingConfigurationThrows)
+{
+	const BatchJobs::Job job{"a.ck2", "nonexistentConfiguration.txt", ""};
+
+	EXPECT_THROW(auto settings = BatchJobs::settingsFor(job), std::runtime_error);
+}
+
+TEST(CK2ToEU4_BatchJobsTests, SweepsBecomeAJobPerCombination)
+{
+	std::stringstream input;
+	input << "sweep = { save = \"saves/a save.ck2\" priority = interactive dejure = { \"1\" \"2\" } shatter_empires = { \"1\" \"3\" } start_date = { } }\n";
+	const BatchJobs batch(input);
+
+	ASSERT_EQ(4u, batch.getJobs().size());
+	EXPECT_EQ("a save_shatter_empires1_dejure1", batch.getJobs()[0].outputName);
+	EXPECT_EQ("a save_shatter_empires1_dejure2", batch.getJobs()[1].outputName);
+	EXPECT_EQ("a save_shatter_empires3_dejure1", batch.getJobs()[2].outputName);
+	EXPECT_EQ("a save_shatter_empires3_dejure2", batch.getJobs()[3].outputName);
+	for (const auto& job: batch.getJobs())
+	{
+		EXPECT_EQ("saves/a save.ck2", job.save);
+		EXPECT_EQ(BatchJobs::PRIORITY::INTERACTIVE, job.priority);
+	}
+
+	std::ofstream("batchSweepConfiguration.txt") << "dejure = \"1\"\nreuse_ck2_world = \"1\"\n";
+	auto job = batch.getJobs()[3];
+	job.configuration = "batchSweepConfiguration.txt";
+	std::stringstream settings(BatchJobs::settingsFor(job));
+	const Configuration configuration(settings);
+	std::filesystem::remove("batchSweepConfiguration.txt");
+
+	EXPECT_EQ("a_save_shatter_empires3_dejure2", configuration.getOutputName());
+	EXPECT_EQ(Configuration::SHATTER_EMPIRES(3), configuration.getShatterEmpires());
+	EXPECT_EQ(Configuration::DEJURE(2), configuration.getDejure());
+	EXPECT_EQ(Configuration::REUSE_WORLD::ENABLED, configuration.getReuseWorld());
+}
+
+TEST(CK2ToEU4_BatchJobsTests, SweepsWithoutOptionsAreASingleJob)
+{
+	std::stringstream input;
+	input << "sweep = { save = \"saves/a.ck2\" output_name = \"base\" }\n";
+	input << "sweep = { dejure = { \"1\" \"2\" } }\n";
+	const BatchJobs batch(input);
+
+	ASSERT_EQ(1u, batch.getJobs().size());
+	EXPECT_EQ("base", batch.getJobs()[0].outputName);
+}
@@ -0,0 +1,107 @@
+#include "../../CK2ToEU4/Source/CK2World/CacheStore.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+void writeEntry(const std::string& path, const std::string& key, const std::string& payload)
+{
+	CK2::CacheStore::save(path, key, [&payload](std::ostream& output) {
+		output << payload;
+	});
+}
+
+std::uintmax_t storeBytes()
+{
+	std::uintmax_t bytes = 0;
+	for (const auto& item: std::filesystem::recursive_directory_iterator(std::string(CK2::CacheStore::root)))
+		if (item.is_regular_file())
+			bytes += item.file_size();
+	return bytes;
+}
+} // namespace
+
+TEST(CK2World_CacheStoreTests, entrySurvivesARoundTrip)
+{
+	CK2::CacheStore::configure("build", 0);
+	const auto path = CK2::CacheStore::pathFor("cacheStoreTest", "roundTrip");
+	writeEntry(path, "roundTrip", "payload");
+
+	const auto entry = CK2::CacheStore::load(path, "roundTrip");
+	ASSERT_TRUE(entry);
+	EXPECT_EQ("payload", std::string(entry->data(), entry->size()));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_CacheStoreTests, pathsFollowTheKey)
+{
+	EXPECT_EQ(CK2::CacheStore::pathFor("folder", "key"), CK2::CacheStore::pathFor("folder", "key"));
+	EXPECT_NE(CK2::CacheStore::pathFor("folder", "key"), CK2::CacheStore::pathFor("folder", "other key"));
+	EXPECT_EQ(0u, CK2::CacheStore::pathFor("folder", "key").find("snapshots/folder/"));
+}
+
+TEST(CK2World_CacheStoreTests, entryForAnotherKeyIsNotLoaded)
+{
+	CK2::CacheStore::configure("build", 0);
+	const std::string path = "cacheStoreOtherKey.bin";
+	writeEntry(path, "key", "payload");
+
+	EXPECT_FALSE(CK2::CacheStore::load(path, "another key"));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_CacheStoreTests, entryFromAnotherBuildIsNotLoaded)
+{
+	CK2::CacheStore::configure("old build", 0);
+	const std::string path = "cacheStoreOtherBuild.bin";
+	writeEntry(path, "key", "payload");
+
+	CK2::CacheStore::configure("new build", 0);
+	EXPECT_FALSE(CK2::CacheStore::load(path, "key"));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_CacheStoreTests, damagedEntryIsNotLoaded)
+{
+	CK2::CacheStore::configure("build", 0);
+	const std::string path = "cacheStoreDamaged.bin";
+	writeEntry(path, "key", "payload");
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(-20, std::ios::end);
+		file.put('X');
+	}
+
+	EXPECT_FALSE(CK2::CacheStore::load(path, "key"));
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+	EXPECT_FALSE(CK2::CacheStore::load(path, "key"));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_CacheStoreTests, leastRecentlyUsedEntriesAreEvicted)
+{
+	CK2::CacheStore::configure("build", 0);
+	const auto oldest = CK2::CacheStore::pathFor("cacheStoreTest", "oldest");
+	const auto older = CK2::CacheStore::pathFor("cacheStoreTest", "older");
+	const auto recent = CK2::CacheStore::pathFor("cacheStoreTest", "recent");
+	writeEntry(oldest, "oldest", std::string(1024, 'a'));
+	writeEntry(older, "older", std::string(1024, 'b'));
+	writeEntry(recent, "recent", std::string(1024, 'c'));
+	const auto now = std::filesystem::file_time_type::clock::now();
+	std::filesystem::last_write_time(oldest, now - std::chrono::hours(48));
+	std::filesystem::last_write_time(older, now - std::chrono::hours(24));
+	// Loading counts as a use, so the older entry is now the most recent of them.
+	ASSERT_TRUE(CK2::CacheStore::load(older, "older"));
+
+	CK2::CacheStore::configure("build", static_cast<std::size_t>(storeBytes() - 1));
+	CK2::CacheStore::evict();
+	CK2::CacheStore::configure("build", 0);
+
+	EXPECT_FALSE(std::filesystem::exists(oldest));
+	EXPECT_TRUE(std::filesystem::exists(older));
+	EXPECT_TRUE(std::filesystem::exists(recent));
+	std::filesystem::remove(older);
+	std::filesystem::remove(recent);
+}
@@ -0,0 +1,77 @@
+#include "../../CK2ToEU4/Source/CK2World/Characters/Character.h"
+#include "../../CK2ToEU4/Source/CK2World/Characters/CharacterTable.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+CK2::CharacterTable::value_type entry(const int ID)
+{
+	return {ID, std::make_shared<CK2::Character>()};
+}
+} // namespace
+
+TEST(CK2World_CharacterTableTests, emptyTableFindsNothing)
+{
+	const CK2::CharacterTable table;
+
+	ASSERT_TRUE(table.empty());
+	ASSERT_EQ(table.end(), table.find(1));
+	ASSERT_EQ(0, table.count(-1));
+	ASSERT_THROW(static_cast<void>(table.at(1)), std::out_of_range);
+}
+
+TEST(CK2World_CharacterTableTests, insertedCharactersCanBeFound)
+{
+	CK2::CharacterTable table;
+	const auto first = entry(3);
+	const auto second = entry(7);
+
+	ASSERT_TRUE(table.insert(first));
+	ASSERT_TRUE(table.insert(second));
+	ASSERT_FALSE(table.insert(entry(3)));
+
+	ASSERT_EQ(2, table.size());
+	ASSERT_EQ(first.second, table.at(3));
+	ASSERT_EQ(second.second, table.find(7)->second);
+	ASSERT_EQ(table.end(), table.find(5));
+	ASSERT_EQ(table.end(), table.find(8));
+}
+
+TEST(CK2World_CharacterTableTests, iterationIsInIDOrder)
+{
+	CK2::CharacterTable table(std::vector{entry(9), entry(2), entry(5)});
+	table.insert(entry(4));
+	table.insert(entry(12));
+
+	std::vector<int> IDs;
+	for (const auto& character: table)
+		IDs.emplace_back(character.first);
+
+	ASSERT_EQ((std::vector{2, 4, 5, 9, 12}), IDs);
+	ASSERT_EQ(4, table.find(4)->first);
+	ASSERT_EQ(9, table.find(9)->first);
+}
+
+TEST(CK2World_CharacterTableTests, duplicateIDsKeepTheFirstCharacter)
+{
+	const auto first = entry(6);
+	const CK2::CharacterTable table(std::vector{first, entry(6)});
+
+	ASSERT_EQ(1, table.size());
+	ASSERT_EQ(first.second, table.at(6));
+}
+
+TEST(CK2World_CharacterTableTests, outlyingIDsAreStillFound)
+{
+	CK2::CharacterTable table;
+	table.insert(entry(-4));
+	table.insert(entry(1));
+	table.insert(entry(2000000000));
+	table.insert(entry(2000000001));
+
+	ASSERT_EQ(-4, table.find(-4)->first);
+	ASSERT_EQ(1, table.find(1)->first);
+	ASSERT_EQ(2000000000, table.find(2000000000)->first);
+	ASSERT_NE(nullptr, table.at(2000000001));
+	ASSERT_EQ(table.end(), table.find(1999999999));
+}
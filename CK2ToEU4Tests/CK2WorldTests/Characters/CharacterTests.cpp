@@ -2,6 +2,7 @@
 #include "../CK2ToEU4/Source/CK2World/Titles/Liege.h"
 #include "gtest/gtest.h"
 #include <sstream>
+#include <thread>
 
 TEST(CK2World_CharacterTests, IDCanBeSet)
 {
@@ -240,9 +241,9 @@ TEST(CK2World_CharacterTests, traitsCanBeSet)
 	const CK2::Character theCharacter(input, 42);
 
 	ASSERT_EQ(theCharacter.getTraits().size(), 3);
-	ASSERT_EQ(theCharacter.getTraits().count(1), 1);
-	ASSERT_EQ(theCharacter.getTraits().count(2), 1);
-	ASSERT_EQ(theCharacter.getTraits().count(3), 1);
+	ASSERT_TRUE(theCharacter.getTraits().contains(1));
+	ASSERT_TRUE(theCharacter.getTraits().contains(2));
+	ASSERT_TRUE(theCharacter.getTraits().contains(3));
 }
 
 TEST(CK2World_CharacterTests, femaleCanBeSet)
@@ -395,6 +396,25 @@ TEST(CK2World_CharacterTests, deathDateDefaultstoDefault)
 	ASSERT_EQ(theCharacter.getDeathDate(), date("1.1.1"));
 }
 
+TEST(CK2World_CharacterTests, characterWithoutDeathDateIsAlive)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "}";
+	std::stringstream input2;
+	input2 << "=\n";
+	input2 << "{\n";
+	input2 << "\td_d=\"2.2.2\"";
+	input2 << "}";
+
+	const CK2::Character theCharacter(input, 42);
+	const CK2::Character theDeadCharacter(input2, 43);
+
+	ASSERT_TRUE(theCharacter.isAlive());
+	ASSERT_FALSE(theDeadCharacter.isAlive());
+}
+
 TEST(CK2World_CharacterTests, liegeCanBeSet)
 {
 	std::stringstream input;
@@ -573,3 +593,72 @@ TEST(CK2World_CharacterTests, skillsCanBeSet)
 	ASSERT_EQ(theCharacter.getSkills().intrigue, 4);
 	ASSERT_EQ(theCharacter.getSkills().learning, 5);
 }
+
+TEST(CK2World_CharacterTests, deferredCharacterReadsLinksUpFront)
+{
+	const auto source = std::make_shared<const std::string>("=\n{\n\tbn=\"Carolus\"\n\tlge=7\n\thost=8\n\tspouse=9\n\tdnt=10\n\tjob=job_chancellor\n\ttr={ 3 }\n\td_d=\"814.1.28\"\n}");
+
+	const CK2::Character theCharacter(*source, 42, source);
+
+	ASSERT_EQ(42, theCharacter.getID());
+	ASSERT_EQ(7, theCharacter.getLiege().first);
+	ASSERT_EQ(8, theCharacter.getHost());
+	ASSERT_EQ(1, theCharacter.getSpouses().count(9));
+	ASSERT_EQ(10, theCharacter.getDynasty().first);
+	ASSERT_EQ("job_chancellor", theCharacter.getJob());
+	ASSERT_TRUE(theCharacter.getTraits().contains(3));
+	ASSERT_EQ(date("814.1.28"), theCharacter.getDeathDate());
+	ASSERT_FALSE(theCharacter.isAlive());
+}
+
+TEST(CK2World_CharacterTests, deferredCharacterDecodesDetailsOnDemand)
+{
+	const auto source = std::make_shared<const std::string>(
+		 "=\n{\n\tbn=\"Carolus\"\n\tcul=frankish\n\tfem=yes\n\tpiety=17.5\n\tb_d=\"742.4.2\"\n\tatt={ 1 2 3 4 5 }\n\tmd={ { modifier=borrowed_from_jews } }\n}");
+
+	CK2::Character theCharacter(*source, 42, source);
+
+	ASSERT_EQ("Carolus", theCharacter.getName());
+	ASSERT_EQ("frankish", theCharacter.getCulture());
+	ASSERT_TRUE(theCharacter.isFemale());
+	ASSERT_DOUBLE_EQ(17.5, theCharacter.getPiety());
+	ASSERT_EQ(5, theCharacter.getSkills().learning);
+	ASSERT_TRUE(theCharacter.hasLoan());
+	theCharacter.addYears(2);
+	ASSERT_EQ(date("740.4.2"), theCharacter.getBirthDate());
+}
+
+TEST(CK2World_CharacterTests, deferredCharacterTakesNoDetailsUntilDecoded)
+{
+	const auto source = std::make_shared<const std::string>("=\n{\n\tbn=\"Carolus\"\n\tlge=7\n\tb_d=\"742.4.2\"\n}");
+
+	const CK2::Character theCharacter(*source, 42, source);
+	const auto undecodedBytes = theCharacter.heapBytes();
+	ASSERT_TRUE(theCharacter.getTraits().empty());
+	ASSERT_EQ(undecodedBytes, theCharacter.heapBytes());
+
+	ASSERT_EQ("Carolus", theCharacter.getName());
+	ASSERT_LT(undecodedBytes, theCharacter.heapBytes());
+}
+
+TEST(CK2World_CharacterTests, firstWritesFromTwoThreadsShareOneRecord)
+{
+	for (auto round = 0; round < 100; ++round)
+	{
+		std::stringstream input("=\n{\n}");
+		CK2::Character theCharacter(input, 42);
+		const auto adviser = std::make_shared<CK2::Character>();
+
+		std::thread courtiers([&theCharacter] {
+			theCharacter.setCourtierNames({std::pair(parsing::Symbol("Carolus"), true)});
+		});
+		std::thread advisers([&theCharacter, &adviser] {
+			theCharacter.setAdvisers({std::pair(7, adviser)});
+		});
+		courtiers.join();
+		advisers.join();
+
+		ASSERT_EQ(1, theCharacter.getCourtierNames().size());
+		ASSERT_EQ(1, theCharacter.getAdvisers().size());
+	}
+}
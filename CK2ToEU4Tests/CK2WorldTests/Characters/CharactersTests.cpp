@@ -41,6 +41,41 @@ TEST(CK2World_CharactersTests, charactersCanBeLoaded)
 	ASSERT_EQ(characterItr2->second->getID(), 43);
 }
 
+TEST(CK2World_CharactersTests, charactersCanBeLoadedInShards)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	for (auto i = 1; i <= 22000; ++i)
+		input << "\t" << i << "=\n\t{\n\t\tbn=\"Name " << i << "\"\n\t\tatt={ 1 2 3 4 5 }\n\t}\n";
+	input << "}";
+	const auto block = input.str();
+
+	const CK2::Characters characters(block, 7);
+
+	ASSERT_EQ(22000, characters.getCharacters().size());
+	ASSERT_EQ("Name 1", characters.getCharacters().find(1)->second->getName());
+	ASSERT_EQ("Name 22000", characters.getCharacters().find(22000)->second->getName());
+}
+
+TEST(CK2World_CharactersTests, spilledCharactersDecodeFromTheSpill)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	for (auto i = 1; i <= 300; ++i)
+		input << "\t" << i << "=\n\t{\n\t\tbn=\"Name " << i << "\"\n\t\tatt={ 1 2 3 4 5 }\n\t}\n";
+	input << "}";
+	auto block = input.str();
+
+	const CK2::Characters characters(block, 3, CK2::Characters::DETAILS::SPILLED);
+	block.assign(block.size(), ' '); // the spill is a copy of its own
+
+	ASSERT_EQ(300, characters.getCharacters().size());
+	ASSERT_EQ("Name 1", characters.getCharacters().find(1)->second->getName());
+	ASSERT_EQ("Name 300", characters.getCharacters().find(300)->second->getName());
+}
+
 TEST(CK2World_CharactersTests, charactersDynastyLinkDefaultsToNull)
 {
 	std::stringstream input;
@@ -545,6 +580,64 @@ TEST(CK2World_CharactersTests, charactersChildrenLinksCanBeSet)
 	const auto& children = characterItr->second->getChildren();
 
 	ASSERT_EQ(children.size(), 2);
-	ASSERT_EQ(children.find(42)->second->getID(), 42);
-	ASSERT_EQ(children.find(43)->second->getID(), 43);
+	ASSERT_EQ(children[0].first, 42);
+	ASSERT_EQ(children[0].second->getID(), 42);
+	ASSERT_EQ(children[1].first, 43);
+	ASSERT_EQ(children[1].second->getID(), 43);
+}
+
+TEST(CK2World_CharactersTests, prunedCharactersLetGoOfTheirRelatives)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "42={mot=20}\n";
+	input << "43={mot=20}\n";
+	input << "20={}\n";
+	input << "\t}\n";
+	input << "}\n";
+	CK2::Characters characters(input);
+	characters.linkMothersAndFathers();
+	const auto mother = characters.getCharacters().find(20)->second;
+	const std::weak_ptr<CK2::Character> prunedChild = characters.getCharacters().find(43)->second;
+
+	std::vector<bool> kept(43);
+	kept[42] = true;
+	characters.prune(kept);
+
+	ASSERT_EQ(1, characters.getCharacters().size());
+	ASSERT_EQ(42, characters.getCharacters().begin()->first);
+	ASSERT_EQ(20, characters.getCharacters().begin()->second->getMother().first);
+	ASSERT_EQ(mother, characters.getCharacters().begin()->second->getMother().second);
+	ASSERT_TRUE(mother->getChildren().empty());
+	ASSERT_TRUE(prunedChild.expired());
+}
+
+TEST(CK2World_CharactersTests, charactersChildrenAreKeptInIDOrderOncePerParent)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "45={mot=20 fat=21}\n";
+	input << "42={mot=20 fat=21}\n";
+	input << "44={fat=21}\n";
+	input << "43={mot=20 fat=20}\n";
+	input << "20={}\n";
+	input << "21={}\n";
+	input << "\t}\n";
+	input << "}\n";
+	CK2::Characters characters(input);
+
+	characters.linkMothersAndFathers();
+	const auto& mothersChildren = characters.getCharacters().find(20)->second->getChildren();
+	const auto& fathersChildren = characters.getCharacters().find(21)->second->getChildren();
+
+	ASSERT_EQ(3, mothersChildren.size());
+	ASSERT_EQ(42, mothersChildren[0].first);
+	ASSERT_EQ(43, mothersChildren[1].first);
+	ASSERT_EQ(45, mothersChildren[2].first);
+	ASSERT_EQ(3, fathersChildren.size());
+	ASSERT_EQ(42, fathersChildren[0].first);
+	ASSERT_EQ(44, fathersChildren[1].first);
+	ASSERT_EQ(45, fathersChildren[2].first);
 }
@@ -0,0 +1,48 @@
+#include "../../CK2ToEU4/Source/CK2World/Characters/TraitSet.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+TEST(CK2World_TraitSetTests, traitsAreFoundByIDOnEitherSideOfTheWidth)
+{
+	CK2::TraitSet traits;
+	traits.insert(3);
+	traits.insert(CK2::TraitSet::width + 7);
+	traits.insert(3);
+
+	ASSERT_EQ(2, traits.size());
+	ASSERT_TRUE(traits.contains(3));
+	ASSERT_TRUE(traits.contains(static_cast<int>(CK2::TraitSet::width) + 7));
+	ASSERT_FALSE(traits.contains(4));
+	ASSERT_EQ((std::vector<int>{3, static_cast<int>(CK2::TraitSet::width) + 7}), traits.getIDs());
+}
+
+TEST(CK2World_TraitSetTests, namingDropsTraitsWithoutANameAndResolvesTheRest)
+{
+	const std::vector<std::string> traitNames{"brave", "craven", "excommunicated"};
+	CK2::TraitSet traits;
+	traits.insert(0);
+	traits.insert(3);
+	traits.insert(4);
+	traits.insert(CK2::TraitSet::width + 1);
+	traits.name(traitNames);
+
+	ASSERT_EQ(1, traits.size());
+	ASSERT_TRUE(traits.contains("excommunicated"));
+	ASSERT_FALSE(traits.contains("brave"));
+	ASSERT_EQ("excommunicated", traits.nameOf(3));
+	ASSERT_TRUE(traits.nameOf(1).empty());
+}
+
+TEST(CK2World_TraitSetTests, namesAreVisitedInIDOrder)
+{
+	const std::vector<std::string> traitNames{"brave", "craven", "brave"};
+	const CK2::TraitSet traits({3, 1, 2}, traitNames);
+
+	std::vector<std::string> visited;
+	traits.forEachName([&visited](const std::string_view name) {
+		visited.emplace_back(name);
+	});
+
+	ASSERT_EQ((std::vector<std::string>{"brave", "craven", "brave"}), visited);
+}
@@ -0,0 +1,81 @@
+#include "../../CK2ToEU4/Source/CK2World/Contention.h"
+#include "../../CK2ToEU4/Source/CK2World/PhaseTimings.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+CK2::Contention::Site testWaits("contention test");
+
+std::uint64_t waitsAtTestSite()
+{
+	const auto totals = CK2::Contention::totals();
+	const auto wait = std::ranges::find(totals, "contention test", &CK2::Contention::Wait::site);
+	return wait != totals.end() ? wait->waits : 0;
+}
+
+// Holds mutex on another thread long enough for lockAt to have to wait for it.
+void waitBehindAnotherThread(std::mutex& mutex)
+{
+	std::unique_lock held(mutex);
+	std::thread waiter([&mutex] {
+		const auto lock = CK2::lockAt<std::unique_lock<std::mutex>>(testWaits, mutex);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	held.unlock();
+	waiter.join();
+}
+} // namespace
+
+TEST(CK2World_ContentionTests, waitsAreNotCountedWhileDisabled)
+{
+	CK2::Contention::reset();
+	std::mutex mutex;
+
+	waitBehindAnotherThread(mutex);
+
+	EXPECT_EQ(0, waitsAtTestSite());
+}
+
+TEST(CK2World_ContentionTests, onlyHeldLocksCountAsWaits)
+{
+	CK2::Contention::reset();
+	CK2::Contention::enable();
+	std::mutex mutex;
+
+	{
+		const auto lock = CK2::lockAt<std::unique_lock<std::mutex>>(testWaits, mutex);
+		EXPECT_TRUE(lock.owns_lock());
+	}
+	EXPECT_EQ(0, waitsAtTestSite());
+
+	waitBehindAnotherThread(mutex);
+	EXPECT_EQ(1, waitsAtTestSite());
+	CK2::Contention::reset();
+}
+
+TEST(CK2World_ContentionTests, phasesNoteTheirWaitsAndThreads)
+{
+	CK2::Contention::reset();
+	CK2::PhaseTimings timings;
+	timings.enableContention();
+	std::mutex mutex;
+
+	timings.begin("quiet");
+	timings.begin("contended");
+	waitBehindAnotherThread(mutex);
+	timings.finish();
+	CK2::Contention::reset();
+
+	const auto& phases = timings.getPhases();
+	ASSERT_EQ(2, phases.size());
+	EXPECT_LT(0, phases[0].threads);
+	EXPECT_TRUE(std::ranges::find(phases[0].waits, "contention test", &CK2::Contention::Wait::site) == phases[0].waits.end());
+	const auto wait = std::ranges::find(phases[1].waits, "contention test", &CK2::Contention::Wait::site);
+	ASSERT_NE(wait, phases[1].waits.end());
+	EXPECT_EQ(1, wait->waits);
+	EXPECT_LT(0, wait->nanoseconds);
+}
@@ -1,6 +1,8 @@
 #include "../../CK2ToEU4/Source/CK2World/Dynasties/Dynasties.h"
 #include "../../CK2ToEU4/Source/CK2World/Dynasties/Dynasty.h"
 #include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 TEST(CK2World_DynastiesTests, DynastiesDefaultToEmpty)
@@ -33,3 +35,94 @@ TEST(CK2World_DynastiesTests, dynastiesCanBeLoaded)
 	ASSERT_EQ(characterItr2->first, 43);
 	ASSERT_EQ(characterItr2->second->getID(), 43);
 }
+
+TEST(CK2World_DynastiesTests, copiesAreUpdatedOnTheirOwn)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "42={ name=\"Install\" }\n";
+	input << "}";
+	const auto dynasties = std::make_shared<const CK2::Dynasties>(input);
+
+	CK2::Dynasties copy(dynasties);
+	std::stringstream saveInput;
+	saveInput << "=\n";
+	saveInput << "{\n";
+	saveInput << "42={ name=\"Save\" }\n";
+	saveInput << "43={}\n";
+	saveInput << "}";
+	copy.loadDynasties(saveInput);
+
+	ASSERT_EQ(1u, dynasties->getDynasties().size());
+	EXPECT_EQ("Install", dynasties->getDynasties().at(42)->getName());
+	ASSERT_EQ(2u, copy.getDynasties().size());
+	EXPECT_EQ("Save", copy.getDynasties().at(42)->getName());
+}
+
+TEST(CK2World_DynastiesTests, untouchedBaseDynastiesAreSharedNotCopied)
+{
+	std::stringstream input;
+	input << "42={ name=\"Install\" culture=\"greek\" }\n";
+	input << "43={ name=\"Untouched\" }\n";
+	const auto dynasties = std::make_shared<const CK2::Dynasties>(input);
+
+	CK2::Dynasties overlay(dynasties);
+	std::stringstream saveInput;
+	saveInput << "=\n";
+	saveInput << "{\n";
+	saveInput << "42={ name=\"Save\" }\n";
+	saveInput << "44={ name=\"New\" }\n";
+	saveInput << "}";
+	overlay.loadDynasties(saveInput);
+
+	ASSERT_EQ(2u, overlay.getDynasties().size());
+	EXPECT_EQ(3u, overlay.size());
+	EXPECT_EQ("Save", overlay.find(42)->getName());
+	EXPECT_EQ("greek", overlay.find(42)->getCulture().str());
+	EXPECT_EQ(dynasties->find(43), overlay.find(43));
+	EXPECT_EQ("New", overlay.find(44)->getName());
+	EXPECT_EQ(nullptr, overlay.find(45));
+}
+
+TEST(CK2World_DynastiesTests, laterFilesOverrideOnlyWhatTheySet)
+{
+	const std::string vanillaPath = "dynastiesVanilla.txt";
+	const std::string modPath = "dynastiesMod.txt";
+	std::ofstream(vanillaPath) << "42={ name=\"Vanilla\" culture=\"greek\" }\n43={ name=\"Kept\" }\n";
+	std::ofstream(modPath) << "42={ culture=\"italian\" }\n44={ name=\"Added\" }\n";
+
+	CK2::Dynasties dynasties;
+	dynasties.loadDynasties(std::vector<std::string>{vanillaPath, modPath});
+	std::filesystem::remove(vanillaPath);
+	std::filesystem::remove(modPath);
+
+	ASSERT_EQ(3u, dynasties.getDynasties().size());
+	EXPECT_EQ("Vanilla", dynasties.getDynasties().at(42)->getName());
+	EXPECT_EQ("italian", dynasties.getDynasties().at(42)->getCulture().str());
+	EXPECT_EQ("Kept", dynasties.getDynasties().at(43)->getName());
+	EXPECT_EQ("Added", dynasties.getDynasties().at(44)->getName());
+}
+
+TEST(CK2World_DynastiesTests, compiledDynastiesReadBackTheSame)
+{
+	std::stringstream input;
+	input << "42={ name=\"Komnenos\" culture=\"greek\" religion=\"orthodox\" coat_of_arms={ religion=\"catholic\" } }\n";
+	const CK2::Dynasties dynasties(input);
+
+	std::stringstream compiled;
+	mappers::CompiledConfigurables::Writer writer(compiled);
+	writer.put(dynasties);
+	const auto image = compiled.str();
+	mappers::CompiledConfigurables::Reader reader(image.data(), image.size());
+	CK2::Dynasties readBack;
+	reader.get(readBack);
+
+	ASSERT_TRUE(reader.atEnd());
+	ASSERT_EQ(1u, readBack.getDynasties().size());
+	const auto& dynasty = readBack.getDynasties().at(42);
+	EXPECT_EQ(42, dynasty->getID());
+	EXPECT_EQ("Komnenos", dynasty->getName());
+	EXPECT_EQ("greek", dynasty->getCulture().str());
+	EXPECT_EQ("catholic", dynasty->getReligion().str());
+}
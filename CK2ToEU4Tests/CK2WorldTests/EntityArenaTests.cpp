@@ -0,0 +1,64 @@
+#include "../../CK2ToEU4/Source/CK2World/Concurrency.h"
+#include "../../CK2ToEU4/Source/CK2World/EntityArena.h"
+#include "../../CK2ToEU4/Source/CK2World/Titles/Liege.h"
+#include "gtest/gtest.h"
+#include <future>
+#include <sstream>
+
+TEST(CK2World_EntityArenaTests, entitiesAreConstructedInTheArena)
+{
+	std::stringstream input;
+	input << "title = \"k_france\"";
+
+	const auto liege = CK2::makeEntity<CK2::Liege>(input);
+
+	ASSERT_EQ("k_france", liege->getTitle().first);
+	ASSERT_EQ(1, liege.use_count());
+}
+
+TEST(CK2World_EntityArenaTests, allocationsAreAlignedAndDistinct)
+{
+	CK2::EntityArena arena;
+
+	auto* first = arena.allocate(3, 1);
+	auto* second = arena.allocate(sizeof(double), alignof(double));
+	arena.deallocate(first, 3, 1);
+	auto* third = arena.allocate(64, 64);
+
+	ASSERT_NE(first, second);
+	ASSERT_NE(first, third);
+	ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(second) % alignof(double));
+	ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(third) % 64);
+}
+
+TEST(CK2World_EntityArenaTests, entitiesGoToTheArenaInScope)
+{
+	CK2::EntityArena arena;
+	const auto before = CK2::EntityArena::process().bytesTaken();
+	{
+		const CK2::EntityArena::Scope entities(arena);
+		std::stringstream input;
+		const auto liege = CK2::makeEntity<CK2::Liege>(input);
+		ASSERT_EQ(&arena, &CK2::EntityArena::current());
+	}
+
+	ASSERT_LT(0, arena.bytesTaken());
+	ASSERT_EQ(before, CK2::EntityArena::process().bytesTaken());
+	ASSERT_EQ(&CK2::EntityArena::process(), &CK2::EntityArena::current());
+}
+
+TEST(CK2World_EntityArenaTests, carriedWorkBuildsIntoTheCallersArena)
+{
+	CK2::EntityArena arena;
+	const CK2::EntityArena::Scope entities(arena);
+
+	auto carried = std::async(std::launch::async, CK2::Concurrency::carry([] {
+		return &CK2::EntityArena::current();
+	}));
+	auto uncarried = std::async(std::launch::async, [] {
+		return &CK2::EntityArena::current();
+	});
+
+	ASSERT_EQ(&arena, carried.get());
+	ASSERT_EQ(&CK2::EntityArena::process(), uncarried.get());
+}
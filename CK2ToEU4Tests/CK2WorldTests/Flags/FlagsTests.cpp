@@ -57,4 +57,19 @@ TEST(CK2World_FlagsTests, doesItFillThings)
 	std::set<std::string> tester = {"zun_pagan_reformed", "bon_reformed", "west_african_pagan_reformed"};
 
 	ASSERT_EQ(tester, test);
-}
\ No newline at end of file
+}
+TEST(CK2World_FlagsTests, onlyQueriedFlagsAreKept)
+{
+	std::stringstream input;
+	input << "zun_reformation=769.1.12\n";
+	input << "aztec_explorers=yes\n";
+	input << "some_event_fired=yes\n";
+	input << "another_flag = { x = y }";
+
+	CK2::Flags theMapper(input, CK2::Flags::queriedFlags());
+
+	std::set<std::string> tester = {"zun_reformation", "aztec_explorers"};
+
+	ASSERT_EQ(tester, theMapper.getFlags());
+	ASSERT_TRUE(theMapper.getInvasion());
+}
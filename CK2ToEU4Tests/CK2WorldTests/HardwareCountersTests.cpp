@@ -0,0 +1,26 @@
+#include "../../CK2ToEU4/Source/CK2World/HardwareCounters.h"
+#include "gtest/gtest.h"
+
+TEST(CK2World_HardwareCountersTests, countersOnlyGrow)
+{
+	const CK2::HardwareCounters counters;
+	const auto before = counters.read();
+	volatile auto sum = 0;
+	for (auto number = 0; number < 100000; ++number)
+		sum = sum + number;
+	const auto after = counters.read();
+
+	ASSERT_EQ(before.size(), after.size());
+	for (std::size_t index = 0; index < before.size(); ++index)
+	{
+		EXPECT_EQ(before[index].first, after[index].first);
+		EXPECT_GE(after[index].second, before[index].second);
+	}
+}
+
+TEST(CK2World_HardwareCountersTests, eachOpenCounterIsRead)
+{
+	const CK2::HardwareCounters counters;
+
+	EXPECT_EQ(counters.empty(), counters.read().empty());
+}
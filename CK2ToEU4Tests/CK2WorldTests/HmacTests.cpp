@@ -0,0 +1,45 @@
+#include "../../CK2ToEU4/Source/CK2World/Hmac.h"
+#include "gtest/gtest.h"
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string hex(const CK2::Sha256Digest& digest)
+{
+	std::stringstream text;
+	for (const auto byte: digest)
+		text << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+	return text.str();
+}
+} // namespace
+
+TEST(CK2World_HmacTests, sha256MatchesTheStandardVectors)
+{
+	EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", hex(CK2::sha256("")));
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", hex(CK2::sha256("abc")));
+	// 56 bytes: the length no longer fits the last block.
+	EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", hex(CK2::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")));
+	EXPECT_EQ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", hex(CK2::sha256(std::string(1000000, 'a'))));
+}
+
+TEST(CK2World_HmacTests, hmacMatchesRfc4231)
+{
+	EXPECT_EQ("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", hex(CK2::hmacSha256(std::string(20, '\x0b'), "Hi There")));
+	EXPECT_EQ("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", hex(CK2::hmacSha256("Jefe", "what do ya want for nothing?")));
+	// A key longer than a block is hashed first.
+	EXPECT_EQ("60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+		 hex(CK2::hmacSha256(std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First")));
+}
+
+TEST(CK2World_HmacTests, digestsCompareWholly)
+{
+	const auto digest = CK2::sha256("abc");
+	std::string bytes(reinterpret_cast<const char*>(digest.data()), digest.size());
+
+	EXPECT_TRUE(CK2::sameDigest(digest, bytes));
+	EXPECT_FALSE(CK2::sameDigest(digest, bytes.substr(1)));
+	bytes.back() ^= 1;
+	EXPECT_FALSE(CK2::sameDigest(digest, bytes));
+}
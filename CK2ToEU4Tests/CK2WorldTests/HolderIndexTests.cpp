@@ -0,0 +1,56 @@
+#include "../../CK2ToEU4/Source/CK2World/Characters/Character.h"
+#include "../../CK2ToEU4/Source/CK2World/Characters/Characters.h"
+#include "../../CK2ToEU4/Source/CK2World/HolderIndex.h"
+#include "../../CK2ToEU4/Source/CK2World/Titles/Titles.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(CK2World_HolderIndexTests, emptyIndexReturnsNothing)
+{
+	const CK2::HolderIndex holderIndex;
+
+	ASSERT_TRUE(holderIndex.getCourtiers(1).empty());
+	ASSERT_TRUE(holderIndex.getAdvisers(1).empty());
+	ASSERT_TRUE(holderIndex.getTitles(1).empty());
+}
+
+TEST(CK2World_HolderIndexTests, courtiersAdvisersAndTitlesAreIndexedByHolder)
+{
+	std::stringstream characterInput;
+	characterInput << "=\n";
+	characterInput << "{\n";
+	characterInput << "1={bn=\"Liege\"}\n";
+	characterInput << "2={bn=\"Courtier\" host=1}\n";
+	characterInput << "3={bn=\"Chancellor\" host=1 job=\"job_chancellor\"}\n";
+	characterInput << "4={bn=\"Stranger\" host=5}\n";
+	characterInput << "}";
+	const CK2::Characters characters(characterInput);
+
+	std::stringstream titleInput;
+	titleInput << "=\n";
+	titleInput << "{\n";
+	titleInput << "c_one={holder=1}\n";
+	titleInput << "d_two={holder=1}\n";
+	titleInput << "c_three={holder=4}\n";
+	titleInput << "c_four={}\n";
+	titleInput << "}";
+	const CK2::Titles titles(titleInput);
+
+	const CK2::HolderIndex holderIndex(characters, titles);
+
+	const auto& courtiers = holderIndex.getCourtiers(1);
+	ASSERT_EQ(2, courtiers.size());
+	ASSERT_EQ("Courtier", courtiers.at(2)->getName());
+	ASSERT_EQ("Chancellor", courtiers.at(3)->getName());
+	ASSERT_EQ(1, holderIndex.getAdvisers(1).size());
+	ASSERT_EQ(1, holderIndex.getAdvisers(1).count(3));
+	ASSERT_EQ(1, holderIndex.getCourtiers(5).size());
+	ASSERT_TRUE(holderIndex.getAdvisers(5).empty());
+
+	const auto& ownedTitles = holderIndex.getTitles(1);
+	ASSERT_EQ(2, ownedTitles.size());
+	ASSERT_EQ(1, ownedTitles.count("c_one"));
+	ASSERT_EQ(1, ownedTitles.count("d_two"));
+	ASSERT_EQ(1, holderIndex.getTitles(4).count("c_three"));
+	ASSERT_TRUE(holderIndex.getTitles(0).empty());
+}
@@ -0,0 +1,65 @@
+#include "../../CK2ToEU4/Source/CK2World/MemoryCensus.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+
+namespace
+{
+struct Entity
+{
+	std::size_t owned = 0;
+	[[nodiscard]] std::size_t heapBytes() const { return owned; }
+};
+} // namespace
+
+TEST(CK2World_MemoryCensusTests, shortStringsOwnNothing)
+{
+	EXPECT_EQ(0, CK2::MemoryCensus::heapBytes(std::string("k_england")));
+	const std::string longName(100, 'x');
+	EXPECT_EQ(longName.capacity() + 1, CK2::MemoryCensus::heapBytes(longName));
+}
+
+TEST(CK2World_MemoryCensusTests, vectorsCountTheirCapacity)
+{
+	std::vector<int> numbers;
+	numbers.reserve(10);
+	numbers.push_back(1);
+
+	EXPECT_EQ(10 * sizeof(int), CK2::MemoryCensus::heapBytes(numbers));
+}
+
+TEST(CK2World_MemoryCensusTests, nodesAndWhatTheyHoldAreCounted)
+{
+	const std::string longName(100, 'x');
+	const std::map<int, std::string> names = {{1, longName}, {2, "short"}};
+
+	EXPECT_EQ(2 * (sizeof(std::pair<const int, std::string>) + CK2::MemoryCensus::treeNodeBytes) + longName.capacity() + 1,
+		 CK2::MemoryCensus::heapBytes(names));
+}
+
+TEST(CK2World_MemoryCensusTests, linksOwnNothing)
+{
+	const auto linked = std::make_shared<Entity>(Entity{1000});
+	const std::optional<std::pair<int, std::shared_ptr<Entity>>> link = std::pair(1, linked);
+
+	EXPECT_EQ(0, CK2::MemoryCensus::heapBytes(link));
+}
+
+TEST(CK2World_MemoryCensusTests, entitiesAndTheirTablesAddUpPerType)
+{
+	const std::map<int, std::shared_ptr<Entity>> table = {{1, std::make_shared<Entity>(Entity{100})}, {2, std::make_shared<Entity>(Entity{50})}, {3, nullptr}};
+	CK2::MemoryCensus census;
+	census.addEntities("Entity", table);
+	census.add("Block", 0, 4096);
+
+	ASSERT_EQ(2, census.getRows().size());
+	const auto& entities = census.getRows()[0];
+	EXPECT_EQ("Entity", entities.type);
+	EXPECT_EQ(2, entities.objects);
+	EXPECT_EQ(2 * (sizeof(Entity) + CK2::MemoryCensus::controlBlockBytes), entities.shallowBytes);
+	EXPECT_EQ(entities.shallowBytes + 150 + CK2::MemoryCensus::heapBytes(table), entities.deepBytes);
+	EXPECT_EQ("Block", census.getRows()[1].type);
+	EXPECT_EQ(4096, census.getRows()[1].deepBytes);
+}
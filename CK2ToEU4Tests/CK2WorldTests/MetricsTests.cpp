@@ -0,0 +1,124 @@
+#include "../../CK2ToEU4/Source/CK2World/Metrics.h"
+#include "../../CK2ToEU4/Source/CK2World/PhaseTimings.h"
+#include "gtest/gtest.h"
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+TEST(CK2World_MetricsTests, everyFamilyIsDescribed)
+{
+	CK2::Metrics::reset();
+
+	const auto text = CK2::Metrics::render();
+
+	EXPECT_NE(std::string::npos, text.find("# HELP ck2toeu4_jobs_total "));
+	EXPECT_NE(std::string::npos, text.find("# TYPE ck2toeu4_jobs_total counter\n"));
+	EXPECT_NE(std::string::npos, text.find("# TYPE ck2toeu4_queued_jobs gauge\n"));
+	EXPECT_NE(std::string::npos, text.find("# TYPE ck2toeu4_phase_seconds histogram\n"));
+	EXPECT_NE(std::string::npos, text.find("# TYPE ck2toeu4_cache_lookups_total counter\n"));
+}
+
+TEST(CK2World_MetricsTests, countersAreSharedByNameAndLabels)
+{
+	CK2::Metrics::reset();
+
+	++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "converted"}});
+	++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "converted"}});
+	++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "failed"}});
+	++CK2::Metrics::lookups("snapshot", true);
+	CK2::Metrics::gauge("ck2toeu4_queued_jobs", {{"queue", "folder"}}).store(1.5);
+	const auto text = CK2::Metrics::render();
+
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_jobs_total{result=\"converted\"} 2\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_jobs_total{result=\"failed\"} 1\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_cache_lookups_total{cache=\"snapshot\",result=\"hit\"} 1\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_queued_jobs{queue=\"folder\"} 1.5\n"));
+}
+
+TEST(CK2World_MetricsTests, histogramBucketsAreCumulative)
+{
+	CK2::Metrics::reset();
+
+	CK2::Metrics::observe("ck2toeu4_job_seconds", {}, 0.3);
+	CK2::Metrics::observe("ck2toeu4_job_seconds", {}, 4);
+	CK2::Metrics::observe("ck2toeu4_job_seconds", {}, 1000);
+	const auto text = CK2::Metrics::render();
+
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_bucket{le=\"0.25\"} 0\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_bucket{le=\"0.5\"} 1\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_bucket{le=\"5\"} 2\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_bucket{le=\"300\"} 2\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_bucket{le=\"+Inf\"} 3\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_sum 1004.3\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_count 3\n"));
+}
+
+TEST(CK2World_MetricsTests, labelValuesAreEscaped)
+{
+	CK2::Metrics::reset();
+
+	CK2::Metrics::observe("ck2toeu4_phase_seconds", {{"phase", "Say \"hi\"\\bye"}}, 1);
+	const auto text = CK2::Metrics::render();
+
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_phase_seconds_count{phase=\"Say \\\"hi\\\"\\\\bye\"} 1\n"));
+}
+
+TEST(CK2World_MetricsTests, unknownFamiliesThrow)
+{
+	ASSERT_THROW(auto& counter = CK2::Metrics::counter("ck2toeu4_nonsense_total"), std::invalid_argument);
+	ASSERT_THROW(auto& gauge = CK2::Metrics::gauge("ck2toeu4_jobs_total"), std::invalid_argument);
+}
+
+TEST(CK2World_MetricsTests, conversionsFeedPhaseAndJobLatencies)
+{
+	CK2::Metrics::reset();
+	CK2::PhaseTimings timings;
+	timings.begin("Importing Save");
+	timings.begin("Writing Mod");
+	timings.finish();
+
+	CK2::Metrics::observeConversion(timings);
+	const auto text = CK2::Metrics::render();
+
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_phase_seconds_count{phase=\"Importing Save\"} 1\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_phase_seconds_count{phase=\"Writing Mod\"} 1\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_seconds_count 1\n"));
+	EXPECT_NE(std::string::npos, text.find("ck2toeu4_job_peak_growth_bytes_count 1\n"));
+}
+
+#ifndef _WIN32
+TEST(CK2World_MetricsTests, serverAnswersScrapes)
+{
+	CK2::Metrics::reset();
+	++CK2::Metrics::counter("ck2toeu4_jobs_total", {{"result", "converted"}});
+	const CK2::MetricsServer server(0);
+
+	const auto scrape = [&server](const std::string& request) {
+		const auto client = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(server.getPort());
+		std::string response;
+		if (!connect(client, reinterpret_cast<sockaddr*>(&address), sizeof address))
+		{
+			send(client, request.data(), request.size(), 0);
+			char buffer[4096];
+			for (auto received = recv(client, buffer, sizeof buffer, 0); received > 0; received = recv(client, buffer, sizeof buffer, 0))
+				response.append(buffer, static_cast<std::size_t>(received));
+		}
+		close(client);
+		return response;
+	};
+
+	const auto metrics = scrape("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	const auto elsewhere = scrape("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+	EXPECT_TRUE(metrics.starts_with("HTTP/1.1 200 OK\r\n"));
+	EXPECT_NE(std::string::npos, metrics.find("ck2toeu4_jobs_total{result=\"converted\"} 1\n"));
+	EXPECT_TRUE(elsewhere.starts_with("HTTP/1.1 404 Not Found\r\n"));
+}
+#endif
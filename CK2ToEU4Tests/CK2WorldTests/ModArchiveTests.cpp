@@ -0,0 +1,58 @@
+#include "../../CK2ToEU4/Source/CK2World/ModArchive.h"
+#include "gtest/gtest.h"
+#include "zip.h"
+#include <filesystem>
+
+namespace
+{
+void writeArchive(const std::string& path, const std::vector<std::pair<std::string, std::string>>& files)
+{
+	auto* archive = zip_open(path.c_str(), ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+	for (const auto& [name, contents]: files)
+	{
+		zip_entry_open(archive, name.c_str());
+		zip_entry_write(archive, contents.data(), contents.size());
+		zip_entry_close(archive);
+	}
+	zip_close(archive);
+}
+} // namespace
+
+TEST(CK2World_ModArchiveTests, filesAreListedOneFolderAtATime)
+{
+	writeArchive("modArchiveList.zip",
+		 {{"common/dynasties/00_dynasties.txt", "1 = { name = Capet }"},
+			  {"common/dynasties/old/01_dynasties.txt", ""},
+			  {"common/landed_titles/titles.txt", ""},
+			  {"descriptor.mod", ""}});
+	const CK2::ModArchive archive("modArchiveList.zip");
+
+	EXPECT_EQ(std::set<std::string>{"00_dynasties.txt"}, archive.filesIn("common/dynasties"));
+	EXPECT_EQ(std::set<std::string>{"00_dynasties.txt"}, archive.filesIn("common/dynasties/"));
+	EXPECT_EQ(std::set<std::string>{"descriptor.mod"}, archive.filesIn(""));
+	EXPECT_TRUE(archive.filesIn("history/provinces").empty());
+	std::filesystem::remove("modArchiveList.zip");
+}
+
+TEST(CK2World_ModArchiveTests, filesInflateWhenRead)
+{
+	const std::string dynasties(100000, 'x');
+	writeArchive("modArchiveRead.zip", {{"common/dynasties/00_dynasties.txt", dynasties}, {"common/empty.txt", ""}});
+	const CK2::ModArchive archive("modArchiveRead.zip");
+
+	EXPECT_EQ(dynasties, archive.read("common/dynasties/00_dynasties.txt"));
+	EXPECT_EQ(std::string(), archive.read("common/empty.txt"));
+	EXPECT_FALSE(archive.read("common/dynasties/missing.txt"));
+	std::filesystem::remove("modArchiveRead.zip");
+}
+
+TEST(CK2World_ModArchiveTests, pathsIntoArchivesAreTold)
+{
+	const auto located = CK2::ModArchive::locate("mod/Tianxia.zip/common/dynasties/00_dynasties.txt");
+	ASSERT_TRUE(located);
+	EXPECT_EQ("mod/Tianxia.zip", located->first);
+	EXPECT_EQ("common/dynasties/00_dynasties.txt", located->second);
+	EXPECT_FALSE(CK2::ModArchive::locate("mod/Tianxia/common/dynasties/00_dynasties.txt"));
+	EXPECT_TRUE(CK2::ModArchive::isArchive("mod/Tianxia.zip"));
+	EXPECT_FALSE(CK2::ModArchive::isArchive("mod/Tianxia"));
+}
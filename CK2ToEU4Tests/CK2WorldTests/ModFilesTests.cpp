@@ -0,0 +1,54 @@
+#include "../../CK2ToEU4/Source/CK2World/ModFiles.h"
+#include "gtest/gtest.h"
+#include "zip.h"
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+void touch(const std::string& path)
+{
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+	std::ofstream file(path);
+}
+} // namespace
+
+TEST(CK2World_ModFilesTests, installFilesComeBeforeModFilesInModOrder)
+{
+	touch("modFilesTest/install/common/landed_titles/00_landed_titles.txt");
+	touch("modFilesTest/install/common/landed_titles/readme.md");
+	touch("modFilesTest/modB/common/landed_titles/00_landed_titles.txt");
+	touch("modFilesTest/modA/common/landed_titles/extra_titles.txt");
+	const Mods mods = {{"Mod B", "modFilesTest/modB"}, {"Mod C", "modFilesTest/modC"}, {"Mod A", "modFilesTest/modA"}};
+
+	const auto files = CK2::gatherModFiles("modFilesTest/install", mods, "common/landed_titles", ".txt", "colors");
+	std::filesystem::remove_all("modFilesTest");
+
+	ASSERT_EQ(3, files.size());
+	EXPECT_EQ("00_landed_titles.txt", files[0].name);
+	EXPECT_EQ("modFilesTest/install/common/landed_titles/00_landed_titles.txt", files[0].path);
+	EXPECT_EQ("modFilesTest/modB/common/landed_titles/00_landed_titles.txt", files[1].path);
+	EXPECT_EQ("extra_titles.txt", files[2].name);
+	EXPECT_EQ("modFilesTest/modA/common/landed_titles/extra_titles.txt", files[2].path);
+}
+
+TEST(CK2World_ModFilesTests, zippedModsAreReadInPlace)
+{
+	touch("modFilesTest/install/common/dynasties/00_dynasties.txt");
+	auto* archive = zip_open("modFilesTest/modA.zip", ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+	zip_entry_open(archive, "common/dynasties/extra_dynasties.txt");
+	zip_entry_write(archive, "1 = { name = Capet }", 20);
+	zip_entry_close(archive);
+	zip_close(archive);
+	const Mods mods = {{"Mod A", "modFilesTest/modA.zip"}};
+
+	const auto files = CK2::gatherModFiles("modFilesTest/install", mods, "common/dynasties", ".txt", "dynasties");
+
+	ASSERT_EQ(2, files.size());
+	EXPECT_EQ("modFilesTest/modA.zip/common/dynasties/extra_dynasties.txt", files[1].path);
+	EXPECT_EQ("1 = { name = Capet }", CK2::readModFile(files[1].path));
+	EXPECT_EQ(std::string(), CK2::readModFile(files[0].path));
+	EXPECT_EQ(std::set<std::string>{"extra_dynasties.txt"}, CK2::listModFolder("modFilesTest/modA.zip/common/dynasties"));
+	EXPECT_FALSE(std::filesystem::exists("modFilesTest/modA"));
+	std::filesystem::remove_all("modFilesTest");
+}
@@ -0,0 +1,193 @@
+#include "../../CK2ToEU4/Source/CK2World/PhaseTimings.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+TEST(CK2World_PhaseTimingsTests, eachBeginClosesThePreviousPhase)
+{
+	CK2::PhaseTimings timings;
+	timings.begin("loading");
+	timings.count("characters", 12);
+	timings.begin("linking");
+	timings.finish();
+	timings.finish();
+
+	ASSERT_EQ(2, timings.getPhases().size());
+	EXPECT_EQ("loading", timings.getPhases()[0].name);
+	EXPECT_EQ("linking", timings.getPhases()[1].name);
+	ASSERT_EQ(1, timings.getPhases()[0].counts.size());
+	EXPECT_EQ("characters", timings.getPhases()[0].counts[0].first);
+	EXPECT_EQ(12, timings.getPhases()[0].counts[0].second);
+	EXPECT_TRUE(timings.getPhases()[1].counts.empty());
+	EXPECT_GE(timings.getPhases()[0].wallSeconds, 0);
+}
+
+TEST(CK2World_PhaseTimingsTests, countsOutsideAPhaseAreDropped)
+{
+	CK2::PhaseTimings timings;
+	timings.count("provinces", 3);
+	timings.finish();
+
+	EXPECT_TRUE(timings.getPhases().empty());
+}
+
+TEST(CK2World_PhaseTimingsTests, jsonListsPhasesInOrder)
+{
+	CK2::PhaseTimings timings;
+	timings.begin("Importing \"Save\"");
+	timings.count("titles", 4);
+	timings.begin("Linking");
+	timings.finish();
+	timings.writeJSON("phaseTimingsTest.json");
+
+	std::ifstream input("phaseTimingsTest.json");
+	std::stringstream json;
+	json << input.rdbuf();
+	input.close();
+	std::filesystem::remove("phaseTimingsTest.json");
+
+	const auto text = json.str();
+	const auto save = text.find("\"name\": \"Importing \\\"Save\\\"\"");
+	const auto linking = text.find("\"name\": \"Linking\"");
+	ASSERT_NE(std::string::npos, save);
+	ASSERT_NE(std::string::npos, linking);
+	EXPECT_LT(save, linking);
+	EXPECT_NE(std::string::npos, text.find("\"counts\": {\"titles\": 4}"));
+	EXPECT_NE(std::string::npos, text.find("\"counts\": {}"));
+}
+
+TEST(CK2World_PhaseTimingsTests, processCountersAreReadable)
+{
+	EXPECT_GE(CK2::PhaseTimings::processCPUSeconds(), 0);
+	EXPECT_GT(CK2::PhaseTimings::peakResidentKB(), 0);
+}
+
+TEST(CK2World_PhaseTimingsTests, allocationsAreCountedOnlyInProfilingBuilds)
+{
+	CK2::PhaseTimings timings;
+	timings.begin("allocating");
+	auto numbers = std::make_unique<std::vector<int>>(1000);
+	timings.finish();
+
+	const auto& phase = timings.getPhases()[0];
+	if (CK2::AllocationProfile::enabled())
+	{
+		EXPECT_GE(phase.allocations, 2);
+		EXPECT_GE(phase.allocatedBytes, 1000 * sizeof(int));
+	}
+	else
+	{
+		EXPECT_EQ(0, phase.allocations);
+		EXPECT_EQ(0, phase.allocatedBytes);
+	}
+}
+
+TEST(CK2World_PhaseTimingsTests, hardwareCountsNeedToBeEnabled)
+{
+	CK2::PhaseTimings timings;
+	timings.begin("counting");
+	timings.finish();
+
+	EXPECT_TRUE(timings.getPhases()[0].hardwareCounts.empty());
+}
+
+TEST(CK2World_PhaseTimingsTests, enabledHardwareCountsAreNamedPerPhase)
+{
+	CK2::PhaseTimings timings;
+	timings.enableHardwareCounters();
+	timings.begin("counting");
+	volatile auto sum = 0;
+	for (auto number = 0; number < 100000; ++number)
+		sum = sum + number;
+	timings.finish();
+
+	// Whatever the kernel allows here, which may be nothing at all.
+	for (const auto& [event, number]: timings.getPhases()[0].hardwareCounts)
+		EXPECT_TRUE(event == "instructions" || event == "cycles" || event == "cacheMisses" || event == "branchMisses" || event == "pageFaults");
+}
+
+TEST(CK2World_PhaseTimingsTests, censusIsNotedAgainstTheOpenPhase)
+{
+	CK2::PhaseTimings timings;
+	EXPECT_FALSE(timings.takesCensus());
+	timings.enableMemoryCensus();
+	EXPECT_TRUE(timings.takesCensus());
+
+	CK2::MemoryCensus census;
+	census.add("Title", 100, 20);
+	timings.census(census);
+	timings.begin("linking");
+	timings.census(census);
+	timings.finish();
+	timings.writeJSON("phaseCensusTest.json");
+
+	std::ifstream input("phaseCensusTest.json");
+	std::stringstream json;
+	json << input.rdbuf();
+	input.close();
+	std::filesystem::remove("phaseCensusTest.json");
+
+	ASSERT_EQ(1, timings.getPhases()[0].census.size());
+	EXPECT_EQ(120, timings.getPhases()[0].census[0].deepBytes);
+	EXPECT_NE(std::string::npos, json.str().find("\"census\": [{\"type\": \"Title\", \"objects\": 1, \"shallowBytes\": 100, \"deepBytes\": 120}]"));
+}
+
+TEST(CK2World_PhaseTimingsTests, cancelledConversionsStopAtTheNextPhase)
+{
+	CK2::PhaseTimings timings;
+	std::atomic<bool> cancelled = false;
+	timings.cancelWith(cancelled);
+	timings.begin("loading");
+
+	cancelled = true;
+
+	ASSERT_THROW(timings.begin("linking"), std::runtime_error);
+	ASSERT_EQ(1, timings.getPhases().size());
+	EXPECT_EQ("loading", timings.getPhases()[0].name);
+}
+
+TEST(CK2World_PhaseTimingsTests, phasesBeforeTheWindowRunUntimed)
+{
+	CK2::PhaseTimings timings;
+	timings.window("linking", "");
+	timings.begin("loading");
+	timings.count("characters", 10);
+	timings.begin("linking");
+	timings.begin("importing");
+	timings.finish();
+
+	ASSERT_EQ(2, timings.getPhases().size());
+	EXPECT_EQ("linking", timings.getPhases()[0].name);
+	EXPECT_EQ("importing", timings.getPhases()[1].name);
+	EXPECT_FALSE(timings.stops());
+}
+
+TEST(CK2World_PhaseTimingsTests, windowStopsAtTheBeginAfterItsLastPhase)
+{
+	CK2::PhaseTimings timings;
+	timings.window("", "linking");
+	timings.begin("loading");
+	timings.begin("linking");
+
+	ASSERT_TRUE(timings.stops());
+	ASSERT_FALSE(timings.stopped());
+	ASSERT_THROW(timings.begin("importing"), CK2::PhaseTimings::Stopped);
+	ASSERT_TRUE(timings.stopped());
+	ASSERT_EQ(2, timings.getPhases().size());
+	EXPECT_EQ("linking", timings.getPhases()[1].name);
+}
+
+TEST(CK2World_PhaseTimingsTests, windowEndingOnTheLastPhaseDoesNotThrow)
+{
+	CK2::PhaseTimings timings;
+	timings.window("", "writing");
+	timings.begin("loading");
+	timings.begin("writing");
+	timings.finish();
+
+	ASSERT_TRUE(timings.stopped());
+	ASSERT_EQ(2, timings.getPhases().size());
+}
@@ -0,0 +1,61 @@
+#include "../../CK2ToEU4/Source/CK2World/PhaseTimings.h"
+#include "../../CK2ToEU4/Source/CK2World/Progress.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> readLines()
+{
+	std::vector<std::string> lines;
+	std::ifstream input("progressTest.jsonl");
+	for (std::string line; std::getline(input, line);)
+		lines.emplace_back(line);
+	input.close();
+	std::filesystem::remove("progressTest.jsonl");
+	return lines;
+}
+} // namespace
+
+TEST(CK2World_ProgressTests, nothingIsWrittenWhileClosed)
+{
+	CK2::Progress::phase("ignored");
+	CK2::Progress::expect(3);
+	CK2::Progress::advance();
+
+	EXPECT_FALSE(CK2::Progress::isOpen());
+	EXPECT_FALSE(std::filesystem::exists("progressTest.jsonl"));
+}
+
+TEST(CK2World_ProgressTests, phasesStartLinesOfTheirOwn)
+{
+	CK2::Progress::open("progressTest.jsonl");
+	CK2::PhaseTimings timings;
+	timings.begin("Loading \"Save\"");
+	timings.begin("Linking");
+	timings.finish();
+	CK2::Progress::close();
+
+	const auto& lines = readLines();
+	ASSERT_EQ(3, lines.size());
+	EXPECT_NE(std::string::npos, lines[0].find("\"phase\": \"Loading \\\"Save\\\"\", \"done\": 0, \"total\": 0, \"etaSeconds\": null"));
+	EXPECT_NE(std::string::npos, lines[1].find("\"phase\": \"Linking\""));
+	EXPECT_NE(std::string::npos, lines[2].find("\"finished\": true"));
+}
+
+TEST(CK2World_ProgressTests, finishingTheExpectedWorkAlwaysWritesALine)
+{
+	CK2::Progress::open("progressTest.jsonl");
+	CK2::Progress::phase("Writing");
+	CK2::Progress::expect(2);
+	CK2::Progress::expect(2);
+	CK2::Progress::advance(4);
+	CK2::Progress::close();
+
+	const auto& lines = readLines();
+	ASSERT_EQ(3, lines.size());
+	EXPECT_NE(std::string::npos, lines[1].find("\"phase\": \"Writing\", \"done\": 4, \"total\": 4, \"etaSeconds\": 0"));
+}
@@ -39,6 +39,21 @@ TEST(CK2World_BaronyTests, typeDefaultsToBlank)
 	ASSERT_TRUE(theBarony.getType().empty());
 }
 
+TEST(CK2World_BaronyTests, holdingIsSortedFromType)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "\ttype=\"nomad\"";
+	input << "}";
+
+	const CK2::Barony theBarony(input, "b_test");
+
+	ASSERT_EQ(theBarony.getHolding(), CK2::Barony::HOLDING::NOMAD);
+	ASSERT_EQ(CK2::Barony::holdingOf(parsing::Symbol()), CK2::Barony::HOLDING::NONE);
+	ASSERT_EQ(CK2::Barony::holdingOf(parsing::Symbol("trade_post")), CK2::Barony::HOLDING::OTHER);
+}
+
 TEST(CK2World_BaronyTests, castleBuildingsAreRecognized)
 {
 	std::stringstream input;
@@ -34,6 +34,27 @@ TEST(CK2World_ProvincesTests, provinceCanBeLoaded)
 	ASSERT_EQ(provinceItr->second->getID(), 42);
 }
 
+TEST(CK2World_ProvincesTests, baroniesCanBeFoundAcrossProvinces)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "42={ b_first={} b_shared={} }\n";
+	input << "43={ b_second={} b_shared={} }\n";
+	input << "}";
+
+	const CK2::Provinces provinces(input);
+	const auto* second = provinces.findBarony("b_second");
+	const auto* shared = provinces.findBarony("b_shared");
+
+	ASSERT_TRUE(second);
+	EXPECT_EQ("b_second", second->barony->getName());
+	EXPECT_EQ(43, second->province->getID());
+	ASSERT_TRUE(shared);
+	EXPECT_EQ(42, shared->province->getID());
+	EXPECT_FALSE(provinces.findBarony("b_missing"));
+}
+
 TEST(CK2World_ProvincesTests, invalidPrimarySettlementIsBlanked)
 {
 	std::stringstream input;
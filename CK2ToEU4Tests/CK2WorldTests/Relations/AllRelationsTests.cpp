@@ -30,3 +30,24 @@ TEST(CK2World_DiplomacyTests, DiplomacyCanBeLoaded)
 	ASSERT_EQ(diplomacy.getDiplomacy().size(), 2);
 	ASSERT_EQ(diplo7->second.getRelations().size(), 3);
 }
+
+TEST(CK2World_DiplomacyTests, TributariesAreGatheredOncePerPairingByOverlord)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "diplo_7 = { 3 = { tributary = { tributary_type = default tributary = 7 } } 8 = { tributary = { tributary_type = autonomous_tributary tributary = 8 } } 11 = {} }\n";
+	input << "diplo_8 = { 7 = { tributary = { tributary_type = autonomous_tributary tributary = 8 } } }\n";
+	input << "}";
+
+	const CK2::Diplomacy diplomacy(input);
+	const auto& tributaries = diplomacy.getTributaries();
+
+	ASSERT_EQ(2, tributaries.size());
+	ASSERT_EQ(3, tributaries[0].overlord);
+	ASSERT_EQ(7, tributaries[0].tributary);
+	ASSERT_FALSE(tributaries[0].autonomous);
+	ASSERT_EQ(7, tributaries[1].overlord);
+	ASSERT_EQ(8, tributaries[1].tributary);
+	ASSERT_TRUE(tributaries[1].autonomous);
+}
@@ -0,0 +1,217 @@
+#include "../../CK2ToEU4/Source/CK2World/CacheStore.h"
+#include "../../CK2ToEU4/Source/CK2World/RemoteCache.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <map>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const std::string farmKey = "the farm's own key";
+} // namespace
+
+TEST(CK2World_RemoteCacheTests, onlyHttpUrlsAreTaken)
+{
+	EXPECT_THROW(CK2::RemoteCache("https://cache.farm/ck2toeu4", farmKey), std::invalid_argument);
+	EXPECT_THROW(CK2::RemoteCache("http:///ck2toeu4", farmKey), std::invalid_argument);
+	EXPECT_NO_THROW(CK2::RemoteCache("http://cache.farm:8080/ck2toeu4/", farmKey));
+}
+
+TEST(CK2World_RemoteCacheTests, storesAreOnlyUsedWithAKey)
+{
+	EXPECT_THROW(CK2::RemoteCache("http://cache.farm:8080/ck2toeu4", ""), std::invalid_argument);
+	EXPECT_THROW(CK2::RemoteCache("http://cache.farm:8080/ck2toeu4", "short"), std::invalid_argument);
+	EXPECT_THROW(CK2::CacheStore::configure("build", 0, "http://cache.farm:8080/ck2toeu4"), std::invalid_argument);
+}
+
+#ifndef _WIN32
+namespace
+{
+// Just enough of an object store: GET and PUT of whole objects, one request per connection.
+class FakeStore
+{
+  public:
+	FakeStore()
+	{
+		listener = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t addressSize = sizeof address;
+		bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof address);
+		listen(listener, 8);
+		getsockname(listener, reinterpret_cast<sockaddr*>(&address), &addressSize);
+		port = ntohs(address.sin_port);
+		server = std::thread([this] {
+			serve();
+		});
+	}
+	~FakeStore()
+	{
+		shutdown(listener, SHUT_RDWR);
+		close(listener);
+		server.join();
+	}
+
+	[[nodiscard]] std::string url() const { return "http://127.0.0.1:" + std::to_string(port) + "/farm"; }
+	[[nodiscard]] std::size_t countObjects()
+	{
+		const std::lock_guard lock(objectsMutex);
+		return objects.size();
+	}
+	// What anyone with write access to the store, or on the path to it, could do.
+	void overwrite(const std::string& name, const std::string& bytes)
+	{
+		const std::lock_guard lock(objectsMutex);
+		objects["/farm/" + name] = bytes;
+	}
+	void copy(const std::string& from, const std::string& to)
+	{
+		const std::lock_guard lock(objectsMutex);
+		objects["/farm/" + to] = objects["/farm/" + from];
+	}
+	void flipLastByte(const std::string& name)
+	{
+		const std::lock_guard lock(objectsMutex);
+		objects["/farm/" + name].back() ^= 1;
+	}
+
+  private:
+	void serve()
+	{
+		for (auto client = accept(listener, nullptr, nullptr); client >= 0; client = accept(listener, nullptr, nullptr))
+		{
+			std::string request;
+			char buffer[4096];
+			while (request.find("\r\n\r\n") == std::string::npos)
+			{
+				const auto received = recv(client, buffer, sizeof buffer, 0);
+				if (received <= 0)
+					break;
+				request.append(buffer, static_cast<std::size_t>(received));
+			}
+			const auto headEnd = request.find("\r\n\r\n") + 4;
+			const auto target = request.substr(request.find(' ') + 1, request.find(" HTTP/") - request.find(' ') - 1);
+			std::string response;
+			if (request.starts_with("PUT "))
+			{
+				const auto length = std::stoull(request.substr(request.find("Content-Length: ") + 16));
+				while (request.size() - headEnd < length)
+				{
+					const auto received = recv(client, buffer, sizeof buffer, 0);
+					if (received <= 0)
+						break;
+					request.append(buffer, static_cast<std::size_t>(received));
+				}
+				const std::lock_guard lock(objectsMutex);
+				objects[target] = request.substr(headEnd, length);
+				response = "HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n";
+			}
+			else
+			{
+				const std::lock_guard lock(objectsMutex);
+				if (const auto object = objects.find(target); object != objects.end())
+					response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(object->second.size()) + "\r\n\r\n" + object->second;
+				else
+					response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+			}
+			send(client, response.data(), response.size(), 0);
+			close(client);
+		}
+	}
+
+	int listener = -1;
+	std::uint16_t port = 0;
+	std::thread server;
+	std::mutex objectsMutex;
+	std::map<std::string, std::string> objects;
+};
+} // namespace
+
+TEST(CK2World_RemoteCacheTests, objectsComeBackAsTheyWentUp)
+{
+	FakeStore store;
+	const CK2::RemoteCache remote(store.url(), farmKey);
+
+	EXPECT_FALSE(remote.get("object.bin"));
+	ASSERT_TRUE(remote.put("object.bin", std::string("bytes\0with a zero", 17)));
+	EXPECT_EQ(std::string("bytes\0with a zero", 17), remote.get("object.bin"));
+}
+
+TEST(CK2World_RemoteCacheTests, objectsNotSignedWithTheFarmKeyReadAsMisses)
+{
+	FakeStore store;
+	const CK2::RemoteCache remote(store.url(), farmKey);
+	const CK2::RemoteCache stranger(store.url(), "somebody else's key");
+
+	ASSERT_TRUE(remote.put("tampered.bin", "install data"));
+	store.flipLastByte("tampered.bin");
+	EXPECT_FALSE(remote.get("tampered.bin"));
+
+	ASSERT_TRUE(stranger.put("foreign.bin", "install data"));
+	EXPECT_FALSE(remote.get("foreign.bin"));
+
+	store.overwrite("unsigned.bin", "install data");
+	EXPECT_FALSE(remote.get("unsigned.bin"));
+
+	// A good entry served up under another name.
+	ASSERT_TRUE(remote.put("genuine.bin", "install data"));
+	store.copy("genuine.bin", "swapped.bin");
+	EXPECT_TRUE(remote.get("genuine.bin"));
+	EXPECT_FALSE(remote.get("swapped.bin"));
+}
+
+TEST(CK2World_RemoteCacheTests, unreachableStoresReadAsMisses)
+{
+	std::string url;
+	{
+		const FakeStore gone;
+		url = gone.url();
+	}
+	const CK2::RemoteCache remote(url, farmKey);
+
+	EXPECT_FALSE(remote.put("object.bin", "bytes"));
+	EXPECT_FALSE(remote.get("object.bin"));
+}
+
+TEST(CK2World_RemoteCacheTests, farmEntriesServeOtherMachines)
+{
+	FakeStore store;
+	CK2::CacheStore::configure("build", 0, store.url(), farmKey);
+	const auto shared = CK2::CacheStore::pathFor("remoteCacheTest", "shared");
+	const auto local = CK2::CacheStore::pathFor("remoteCacheTest", "local");
+	CK2::CacheStore::save(
+		 shared,
+		 "shared",
+		 [](std::ostream& output) {
+			 output << "install data";
+		 },
+		 CK2::CacheStore::SHARING::FARM);
+	CK2::CacheStore::save(local, "local", [](std::ostream& output) {
+		output << "save data";
+	});
+	EXPECT_EQ(1u, store.countObjects());
+
+	// Another machine: nothing on disk, the same farm.
+	std::filesystem::remove(shared);
+	std::filesystem::remove(local);
+	const auto entry = CK2::CacheStore::load(shared, "shared", CK2::CacheStore::SHARING::FARM);
+	ASSERT_TRUE(entry);
+	EXPECT_EQ("install data", std::string(entry->data(), entry->size()));
+	EXPECT_TRUE(std::filesystem::exists(shared));
+	EXPECT_FALSE(CK2::CacheStore::load(local, "local", CK2::CacheStore::SHARING::FARM));
+
+	// Another build doesn't see it.
+	CK2::CacheStore::configure("other build", 0, store.url(), farmKey);
+	std::filesystem::remove(shared);
+	EXPECT_FALSE(CK2::CacheStore::load(shared, "shared", CK2::CacheStore::SHARING::FARM));
+	CK2::CacheStore::configure("build", 0);
+}
+#endif
@@ -0,0 +1,186 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/BinarySave.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+class BinaryWriter
+{
+  public:
+	BinaryWriter& token(const std::uint16_t ID) { return put(ID); }
+	template <typename Value> BinaryWriter& value(const std::uint16_t ID, const Value value)
+	{
+		put(ID);
+		return put(value);
+	}
+	BinaryWriter& string(const std::uint16_t ID, const std::string& text)
+	{
+		put(ID);
+		put(static_cast<std::uint16_t>(text.size()));
+		data += text;
+		return *this;
+	}
+
+	std::string data = "CK2bin";
+
+  private:
+	template <typename Value> BinaryWriter& put(const Value value)
+	{
+		char bytes[sizeof(Value)];
+		std::memcpy(bytes, &value, sizeof(Value));
+		data.append(bytes, sizeof(Value));
+		return *this;
+	}
+};
+
+CK2::BinaryTokens someTokens()
+{
+	std::stringstream input;
+	input << "# comment\n";
+	input << "0x2c00 = version\n";
+	input << "11265 = date # decimal\n";
+	input << "0x2c02 = character\n";
+	input << "0x2c03 = wealth\n";
+	input << "0x2c04 = ironman\n";
+	input << "0x2c05 = last_raid date\n";
+	return CK2::BinaryTokens(input);
+}
+} // namespace
+
+TEST(CK2World_BinarySaveTests, tokenTableReadsDecimalAndHexIDs)
+{
+	const auto tokens = someTokens();
+
+	ASSERT_EQ(6, tokens.size());
+	ASSERT_EQ("version", *tokens.find(0x2c00));
+	ASSERT_EQ("date", *tokens.find(0x2c01));
+	ASSERT_EQ("last_raid", *tokens.find(0x2c05));
+	ASSERT_EQ(nullptr, tokens.find(0x2c06));
+}
+
+TEST(CK2World_BinarySaveTests, tokenTableKnowsWhichFieldsHoldDates)
+{
+	const auto tokens = someTokens();
+
+	ASSERT_TRUE(tokens.holdsDates(0x2c01));	 // one our parsers read
+	ASSERT_TRUE(tokens.holdsDates(0x2c05));	 // marked
+	ASSERT_FALSE(tokens.holdsDates(0x2c02)); // neither
+}
+
+TEST(CK2World_BinarySaveTests, tokenTableSkipsMalformedLines)
+{
+	std::stringstream input;
+	input << "no equals here\n";
+	input << "0x10000 = tooBig\n";
+	input << "banana = notAnID\n";
+	input << "= nothing\n";
+	input << "0x2c00 = version\n";
+	const CK2::BinaryTokens tokens(input);
+
+	ASSERT_EQ(1, tokens.size());
+}
+
+TEST(CK2World_BinarySaveTests, onlyCK2binIsBinary)
+{
+	ASSERT_TRUE(CK2::isBinaryGamestate("CK2bin\x01\x00"));
+	ASSERT_FALSE(CK2::isBinaryGamestate("CK2txt\nversion=\"2.8.3.2\""));
+	ASSERT_FALSE(CK2::isBinaryGamestate("CK2"));
+}
+
+TEST(CK2World_BinarySaveTests, valuesDecodeToText)
+{
+	BinaryWriter save;
+	save.token(0x2c00).token(0x0001).string(0x000F, "2.8.3.2");
+	save.token(0x2c01).token(0x0001).value<std::int32_t>(0x000C, (5000 + 1066) * 365 * 24 + 257 * 24);
+	save.token(0x2c02).token(0x0001).token(0x0003);
+	save.value<std::int32_t>(0x000C, 140).token(0x0001).token(0x0003);
+	save.token(0x2c03).token(0x0001).value<std::int32_t>(0x000D, -12345);
+	save.token(0x2c04).token(0x0001).value<std::uint8_t>(0x000E, 1);
+	save.token(0x0004).token(0x0004);
+
+	const auto text = CK2::decodeBinaryGamestate(save.data, someTokens());
+
+	ASSERT_EQ("CK2txt\nversion=\"2.8.3.2\"\ndate=1066.9.15\ncharacter={\n140={\nwealth=-12.345\nironman=yes\n}\n}\n", text);
+}
+
+TEST(CK2World_BinarySaveTests, wideNumbersDecodeToText)
+{
+	BinaryWriter save;
+	save.token(0x2c03).token(0x0001).value<std::int64_t>(0x0167, 3 * 32768 + 16384);
+	save.token(0x2c03).token(0x0001).value<std::uint32_t>(0x0014, 4000000000u);
+	save.token(0x2c03).token(0x0001).value<std::int64_t>(0x0317, -5);
+	save.token(0x2c03).token(0x0001).string(0x0017, "k_england");
+
+	const auto text = CK2::decodeBinaryGamestate(save.data, someTokens());
+
+	ASSERT_EQ("CK2txt\nwealth=3.50000\nwealth=4000000000\nwealth=-5\nwealth=k_england\n", text);
+}
+
+TEST(CK2World_BinarySaveTests, onlyDateFieldsDecodeToDates)
+{
+	constexpr std::int32_t dateHours = (5000 + 1066) * 365 * 24 + 257 * 24;
+	BinaryWriter save;
+	save.token(0x2c05).token(0x0001).value<std::int32_t>(0x000C, dateHours);
+	save.token(0x2c03).token(0x0001).value<std::int32_t>(0x000C, dateHours);
+	save.token(0x2c02).token(0x0001).token(0x0003);
+	save.value<std::int32_t>(0x000C, dateHours).token(0x0001).token(0x0003).token(0x0004);
+	save.value<std::int32_t>(0x000C, dateHours).token(0x0004);
+
+	const auto text = CK2::decodeBinaryGamestate(save.data, someTokens());
+
+	ASSERT_EQ("CK2txt\nlast_raid=1066.9.15\nwealth=53144328\ncharacter={\n53144328={\n}\n53144328\n}\n", text);
+}
+
+TEST(CK2World_BinarySaveTests, ironmanGamestateOpeningDecodesToText)
+{
+	// The opening of an ironman gamestate as the game lays it out, under token IDs of our own: the real list is the
+	// game's and isn't ours to ship.
+	std::stringstream input;
+	input << "0x2c00 = version\n0x2c01 = date\n0x2c02 = character\n0x2c03 = wealth\n0x2c06 = player\n0x2c07 = id\n";
+	input << "0x2c08 = type\n0x2c09 = player_realm\n0x2c0a = bn\n0x2c0b = b_d\n0x2c0c = dnt\n0x2c0d = fem\n";
+	const CK2::BinaryTokens tokens(input);
+	BinaryWriter save;
+	save.token(0x2c00).token(0x0001).string(0x000F, "2.8.3.2");
+	save.token(0x2c01).token(0x0001).value<std::int32_t>(0x000C, (5000 + 1066) * 365 * 24 + 257 * 24);
+	save.token(0x2c06).token(0x0001).token(0x0003);
+	save.token(0x2c07).token(0x0001).value<std::int32_t>(0x000C, 140);
+	save.token(0x2c08).token(0x0001).value<std::int32_t>(0x000C, 45);
+	save.token(0x0004);
+	save.token(0x2c09).token(0x0001).string(0x000F, "k_france");
+	save.token(0x2c02).token(0x0001).token(0x0003);
+	save.value<std::int32_t>(0x000C, 140).token(0x0001).token(0x0003);
+	save.token(0x2c0a).token(0x0001).string(0x000F, "Robert");
+	save.token(0x2c0b).token(0x0001).value<std::int32_t>(0x000C, (5000 + 1031) * 365 * 24);
+	save.token(0x2c0c).token(0x0001).value<std::int32_t>(0x000C, 57000000); // a big dynasty ID, not a date
+	save.token(0x2c0d).token(0x0001).value<std::uint8_t>(0x000E, 0);
+	save.token(0x2c03).token(0x0001).value<std::int64_t>(0x0167, 125 * 32768 / 2);
+	save.token(0x0004).token(0x0004);
+
+	const auto text = CK2::decodeBinaryGamestate(save.data, tokens);
+
+	ASSERT_EQ(
+		 "CK2txt\nversion=\"2.8.3.2\"\ndate=1066.9.15\nplayer={\nid=140\ntype=45\n}\nplayer_realm=\"k_france\"\ncharacter={\n140={\n"
+		 "bn=\"Robert\"\nb_d=1031.1.1\ndnt=57000000\nfem=no\nwealth=62.50000\n}\n}\n",
+		 text);
+}
+
+TEST(CK2World_BinarySaveTests, unknownTokensBecomeSkippableKeys)
+{
+	BinaryWriter save;
+	save.token(0x7abc).token(0x0001).value<std::int32_t>(0x000C, 3);
+
+	const auto text = CK2::decodeBinaryGamestate(save.data, someTokens());
+
+	ASSERT_EQ("CK2txt\nunknown_0x7abc=3\n", text);
+}
+
+TEST(CK2World_BinarySaveTests, truncatedSavesThrow)
+{
+	BinaryWriter save;
+	save.token(0x2c00).token(0x0001).string(0x000F, "2.8.3.2");
+	save.data.pop_back();
+
+	ASSERT_THROW(auto text = CK2::decodeBinaryGamestate(save.data, someTokens()), std::runtime_error);
+	ASSERT_THROW(auto text = CK2::decodeBinaryGamestate("CK2txt\n", someTokens()), std::runtime_error);
+}
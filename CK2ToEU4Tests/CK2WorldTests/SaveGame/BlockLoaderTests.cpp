@@ -0,0 +1,205 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/BlockLoader.h"
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveBuffer.h"
+#include "../../CK2ToEU4/Source/CK2World/Vars/Vars.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(CK2World_BlockLoaderTests, measureItemMatchesBraces)
+{
+	const std::string input = " = { a = { b = c } d = \"}\" } next = 1";
+
+	const auto length = CK2::BlockLoader::measureItem(input.data(), input.size());
+
+	ASSERT_EQ(" = { a = { b = c } d = \"}\" }", input.substr(0, length));
+}
+
+TEST(CK2World_BlockLoaderTests, measureItemHandlesSimpleValues)
+{
+	const std::string input = "= 1066.9.15 next = 1";
+	const std::string quoted = "= \"some thing\" next = 1";
+
+	ASSERT_EQ("= 1066.9.15", input.substr(0, CK2::BlockLoader::measureItem(input.data(), input.size())));
+	ASSERT_EQ("= \"some thing\"", quoted.substr(0, CK2::BlockLoader::measureItem(quoted.data(), quoted.size())));
+}
+
+TEST(CK2World_BlockLoaderTests, readItemCopiesSameRangeAsMeasureItem)
+{
+	std::stringstream input;
+	input << "={\n\ta={ b=c }\n\td=\"{\"\n}\nnext = 1";
+
+	const auto item = CK2::BlockLoader::readItem(input);
+	std::string rest;
+	std::getline(input, rest);
+	std::getline(input, rest);
+
+	ASSERT_EQ("={\n\ta={ b=c }\n\td=\"{\"\n}", item);
+	ASSERT_EQ("next = 1", rest);
+}
+
+TEST(CK2World_BlockLoaderTests, streamedBlocksAreParsedOnWait)
+{
+	std::stringstream input;
+	input << "= { first = 1.000 second = 2.000 } trailing";
+	CK2::Vars vars;
+	CK2::BlockLoader blockLoader;
+
+	blockLoader.defer("vars", input, [&vars](std::istream& blockStream) {
+		vars = CK2::Vars(blockStream);
+	});
+	std::string trailing;
+	input >> trailing;
+	blockLoader.wait();
+
+	ASSERT_EQ("trailing", trailing);
+	ASSERT_EQ(2, vars.getVars().size());
+	ASSERT_NEAR(2.0, vars.getVars().find("second")->second, 0.001);
+}
+
+TEST(CK2World_BlockLoaderTests, inMemoryBlocksAreParsedInPlace)
+{
+	const std::string input = "vars = { first = 1.000 } flags = { second = 2.000 } trailing";
+	CK2::SaveBuffer buffer(input.data(), input.size());
+	std::istream theStream(&buffer);
+	CK2::Vars first;
+	CK2::Vars second;
+	CK2::BlockLoader blockLoader;
+	blockLoader.setSource(input.data(), input.size());
+
+	std::string key;
+	theStream >> key;
+	blockLoader.defer("vars", theStream, [&first](std::istream& blockStream) {
+		first = CK2::Vars(blockStream);
+	});
+	theStream >> key;
+	blockLoader.defer("flags", theStream, [&second](std::istream& blockStream) {
+		second = CK2::Vars(blockStream);
+	});
+	std::string trailing;
+	theStream >> trailing;
+	blockLoader.wait();
+
+	ASSERT_EQ("trailing", trailing);
+	ASSERT_NEAR(1.0, first.getVars().find("first")->second, 0.001);
+	ASSERT_NEAR(2.0, second.getVars().find("second")->second, 0.001);
+}
+
+TEST(CK2World_BlockLoaderTests, loaderFailuresSurfaceOnWait)
+{
+	std::stringstream input;
+	input << "= { }";
+	CK2::BlockLoader blockLoader;
+
+	blockLoader.defer("broken", input, [](std::istream& blockStream) {
+		throw std::runtime_error("broken block");
+	});
+
+	ASSERT_THROW(blockLoader.wait(), std::runtime_error);
+}
+
+TEST(CK2World_BlockLoaderTests, unchangedBlocksAreLeftAlone)
+{
+	std::map<std::string, std::string> previous;
+	{
+		std::stringstream input;
+		input << "= { first = 1.000 } = { second = 2.000 }";
+		CK2::BlockLoader blockLoader;
+		blockLoader.reuseUnchanged({});
+		blockLoader.defer("vars", input, [](std::istream& blockStream) {
+			CK2::Vars skipped(blockStream);
+		});
+		blockLoader.defer("flags", input, [](std::istream& blockStream) {
+			CK2::Vars skipped(blockStream);
+		});
+		blockLoader.wait();
+		previous = blockLoader.getDigests();
+		EXPECT_TRUE(blockLoader.getReused().empty());
+	}
+
+	std::stringstream input;
+	input << "= { first = 1.000 } = { second = 3.000 }";
+	auto varsParsed = false;
+	auto flagsParsed = false;
+	CK2::BlockLoader blockLoader;
+	blockLoader.reuseUnchanged(previous);
+	blockLoader.defer("vars", input, [&varsParsed](std::istream& blockStream) {
+		varsParsed = true;
+	});
+	blockLoader.defer("flags", input, [&flagsParsed](std::istream& blockStream) {
+		flagsParsed = true;
+	});
+	blockLoader.wait();
+
+	EXPECT_FALSE(varsParsed);
+	EXPECT_TRUE(flagsParsed);
+	EXPECT_EQ(std::set<std::string>{"vars"}, blockLoader.getReused());
+	EXPECT_EQ(previous.at("vars"), blockLoader.getDigests().at("vars"));
+	EXPECT_NE(previous.at("flags"), blockLoader.getDigests().at("flags"));
+}
+
+TEST(CK2World_BlockLoaderTests, repeatedBlocksAreAlwaysParsed)
+{
+	std::map<std::string, std::string> previous;
+	{
+		std::stringstream input;
+		input << "= { first = 1.000 }";
+		CK2::BlockLoader blockLoader;
+		blockLoader.reuseUnchanged({});
+		blockLoader.defer("vars", input, [](std::istream& blockStream) {
+		});
+		blockLoader.wait();
+		previous = blockLoader.getDigests();
+	}
+
+	// The first is the same as last time and skipped, the second is parsed regardless.
+	std::stringstream input;
+	input << "= { first = 1.000 } = { first = 1.000 }";
+	auto parsed = 0;
+	CK2::BlockLoader blockLoader;
+	blockLoader.reuseUnchanged(previous);
+	for (auto block = 0; block < 2; ++block)
+		blockLoader.defer("vars", input, [&parsed](std::istream& blockStream) {
+			++parsed;
+		});
+	blockLoader.wait();
+
+	EXPECT_EQ(1, parsed);
+	EXPECT_TRUE(blockLoader.getReused().empty());
+}
+
+TEST(CK2World_BlockLoaderTests, splitEntriesCutsAtEntryBoundaries)
+{
+	const std::string input = "=\n{\n1={ a = { b } }\n2={ c }\n3=\"}\"\n4={}\n}\n";
+
+	const auto shards = CK2::BlockLoader::splitEntries(input, 2);
+
+	ASSERT_EQ(2, shards.size());
+	ASSERT_EQ("\n1={ a = { b } }\n2={ c }", shards[0]);
+	ASSERT_EQ("\n3=\"}\"\n4={}", shards[1]);
+}
+
+TEST(CK2World_BlockLoaderTests, splitEntriesNeverExceedsShardCount)
+{
+	const std::string input = "={ 1={} 2={} 3={} 4={} 5={} }";
+
+	ASSERT_EQ(1, CK2::BlockLoader::splitEntries(input, 1).size());
+	ASSERT_EQ(3, CK2::BlockLoader::splitEntries(input, 3).size());
+	ASSERT_EQ(5, CK2::BlockLoader::splitEntries(input, 16).size());
+	ASSERT_TRUE(CK2::BlockLoader::splitEntries("= none", 4).empty());
+}
+
+TEST(CK2World_BlockLoaderTests, entriesOfListsKeysAndItems)
+{
+	const std::string input = "\n1={ a = { b } }\n2 = \"}\"\nname=value\n}";
+	std::vector<std::pair<std::string, std::string>> entries;
+
+	for (const auto& [key, item]: CK2::BlockLoader::entriesOf(input))
+		entries.emplace_back(key, item);
+
+	ASSERT_EQ(3, entries.size());
+	ASSERT_EQ("1", entries[0].first);
+	ASSERT_EQ("={ a = { b } }", entries[0].second);
+	ASSERT_EQ("2", entries[1].first);
+	ASSERT_EQ(" = \"}\"", entries[1].second);
+	ASSERT_EQ("name", entries[2].first);
+	ASSERT_EQ("=value", entries[2].second);
+}
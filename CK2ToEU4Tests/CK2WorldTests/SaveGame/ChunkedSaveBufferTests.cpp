@@ -0,0 +1,74 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/ChunkedSaveBuffer.h"
+#include "../../CK2ToEU4/Source/CK2World/Vars/Vars.h"
+#include "gtest/gtest.h"
+#include <istream>
+#include <thread>
+
+TEST(CK2World_ChunkedSaveBufferTests, chunksCanBeReadAcrossBoundaries)
+{
+	CK2::ChunkedSaveBuffer buffer;
+	std::thread producer([&buffer] {
+		buffer.push("=\n{\nglobal_chi", 14);
+		buffer.push("nese_taoist_ = 3.0", 18);
+		buffer.push("00\n}", 4);
+		buffer.finish();
+	});
+
+	std::istream theStream(&buffer);
+	const CK2::Vars vars(theStream);
+	producer.join();
+
+	ASSERT_EQ(1, vars.getVars().size());
+	ASSERT_NEAR(3.0, vars.getVars().find("global_chinese_taoist_")->second, 0.001);
+}
+
+TEST(CK2World_ChunkedSaveBufferTests, putbackSurvivesChunkBoundary)
+{
+	CK2::ChunkedSaveBuffer buffer(1);
+	std::thread producer([&buffer] {
+		buffer.push("ab", 2);
+		buffer.push("cd", 2);
+		buffer.finish();
+	});
+
+	std::istream theStream(&buffer);
+	ASSERT_EQ('a', theStream.get());
+	ASSERT_EQ('b', theStream.get());
+	ASSERT_EQ('c', theStream.get());
+	theStream.putback('c');
+	theStream.putback('b');
+	ASSERT_EQ('b', theStream.get());
+	ASSERT_EQ('c', theStream.get());
+	ASSERT_EQ('d', theStream.get());
+	ASSERT_EQ(std::char_traits<char>::eof(), theStream.get());
+	producer.join();
+}
+
+TEST(CK2World_ChunkedSaveBufferTests, abandonReleasesBlockedProducer)
+{
+	CK2::ChunkedSaveBuffer buffer(1);
+	auto pushed = true;
+	std::thread producer([&buffer, &pushed] {
+		buffer.push("a", 1);
+		pushed = buffer.push("b", 1); // blocks on full queue until abandoned.
+	});
+
+	buffer.abandon();
+	producer.join();
+
+	ASSERT_FALSE(pushed);
+}
+
+TEST(CK2World_ChunkedSaveBufferTests, producerFailureIsRethrown)
+{
+	CK2::ChunkedSaveBuffer buffer;
+	buffer.push("abc", 3);
+	buffer.fail(std::make_exception_ptr(std::runtime_error("broken zip")));
+
+	std::istream theStream(&buffer);
+	std::string contents;
+	theStream >> contents;
+
+	ASSERT_EQ("abc", contents);
+	ASSERT_THROW(buffer.rethrowIfFailed(), std::runtime_error);
+}
@@ -0,0 +1,65 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/EntityQuery.h"
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveIndex.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+const std::string gamestate =
+	 "CK2txt\n"
+	 "version=\"2.8.3.2\"\n"
+	 "character=\n{\n"
+	 "\t140=\n\t{\n\t\tbn=\"Harold\"\n\t\tb_d=\"1022.1.1\"\n\t\tdnt=2\n\t\tfat=7\n\t\tspouse=9\n\t\tdmn=\n\t\t{\n\t\t\tprimary=\n\t\t\t{\n\t\t\t\ttitle=\"k_england\"\n\t\t\t}\n\t\t}\n\t}\n"
+	 "\t7=\n\t{\n\t\tbn=\"Godwin\"\n\t\tb_d=\"1001.1.1\"\n\t\td_d=\"1053.4.15\"\n\t}\n"
+	 "}\n"
+	 "provinces=\n{\n\t24=\n\t{\n\t\tname=\"Wessex\"\n\t\tprimary_settlement=\"b_winchester\"\n\t\tmax_settlements=4\n\t\tb_winchester=\n\t\t{\n\t\t\ttype=castle\n\t\t}\n\t}\n}\n"
+	 "title=\n{\n"
+	 "\tk_england=\n\t{\n\t\tholder=140\n\t\tliege=\"e_britannia\"\n\t}\n"
+	 "\tb_winchester=\n\t{\n\t\tholder=140\n\t}\n"
+	 "}\n"
+	 "}\n";
+} // namespace
+
+TEST(CK2World_EntityQueryTests, characterIsDecodedWithItsLinks)
+{
+	const auto index = CK2::SaveIndex::build(gamestate);
+
+	const auto lines = CK2::queryEntity(gamestate, index, "character", "140");
+
+	ASSERT_EQ(4, lines.size());
+	EXPECT_EQ("character 140: Harold, born 1022.1.1, dynasty 2, holds k_england", lines[0]);
+	EXPECT_EQ("\tfather: character 7: Godwin, born 1001.1.1, died 1053.4.15", lines[1]);
+	EXPECT_EQ("\tspouse: 9 (not in the save)", lines[2]);
+	EXPECT_EQ("\tprimary title: title k_england, held by 140, liege e_britannia", lines[3]);
+}
+
+TEST(CK2World_EntityQueryTests, titleIsDecodedWithItsHolderAndLiege)
+{
+	const auto index = CK2::SaveIndex::build(gamestate);
+
+	const auto lines = CK2::queryEntity(gamestate, index, "title", "k_england");
+
+	ASSERT_EQ(3, lines.size());
+	EXPECT_EQ("title k_england, held by 140, liege e_britannia", lines[0]);
+	EXPECT_EQ("\tholder: character 140: Harold, born 1022.1.1, dynasty 2, holds k_england", lines[1]);
+	EXPECT_EQ("\tliege: e_britannia (not in the save)", lines[2]);
+}
+
+TEST(CK2World_EntityQueryTests, provinceIsDecodedWithItsSettlements)
+{
+	const auto index = CK2::SaveIndex::build(gamestate);
+
+	const auto lines = CK2::queryEntity(gamestate, index, "province", "24");
+
+	ASSERT_EQ(2, lines.size());
+	EXPECT_EQ("province 24: Wessex, 1 of 4 settlements", lines[0]);
+	EXPECT_EQ("\tprimary settlement: title b_winchester, held by 140", lines[1]);
+}
+
+TEST(CK2World_EntityQueryTests, missingEntitiesAreReported)
+{
+	const auto index = CK2::SaveIndex::build(gamestate);
+
+	EXPECT_THROW((void)CK2::queryEntity(gamestate, index, "character", "8"), std::runtime_error);
+	EXPECT_THROW((void)CK2::queryEntity(gamestate, index, "character", "Harold"), std::runtime_error);
+	EXPECT_THROW((void)CK2::queryEntity(gamestate, index, "dynasty", "2"), std::runtime_error);
+}
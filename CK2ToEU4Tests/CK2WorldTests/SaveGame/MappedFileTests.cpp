@@ -0,0 +1,55 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/MappedFile.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+TEST(CK2World_MappedFileTests, fileContentsCanBeMapped)
+{
+	const std::string path = "mappedFileTest.ck2";
+	{
+		std::ofstream output(path, std::ios::binary);
+		output << "CK2txt\nversion=\"3.3.3\"\n";
+	}
+
+	const CK2::MappedFile mappedFile(path);
+
+	ASSERT_TRUE(mappedFile.isOpen());
+	ASSERT_EQ("CK2txt\nversion=\"3.3.3\"\n", std::string(mappedFile.data(), mappedFile.size()));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_MappedFileTests, emptyFileMapsToEmptyRange)
+{
+	const std::string path = "mappedFileEmptyTest.ck2";
+	std::ofstream(path, std::ios::binary).close();
+
+	const CK2::MappedFile mappedFile(path);
+
+	ASSERT_TRUE(mappedFile.isOpen());
+	ASSERT_EQ(0, mappedFile.size());
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_MappedFileTests, missingFileThrows)
+{
+	ASSERT_THROW(const CK2::MappedFile mappedFile("nonExistentSave.ck2"), std::runtime_error);
+}
+
+TEST(CK2World_MappedFileTests, mappingCanBeMovedAndClosed)
+{
+	const std::string path = "mappedFileMoveTest.ck2";
+	{
+		std::ofstream output(path, std::ios::binary);
+		output << "payload";
+	}
+
+	CK2::MappedFile source(path);
+	auto mappedFile = std::move(source);
+
+	ASSERT_FALSE(source.isOpen());
+	ASSERT_EQ("payload", std::string(mappedFile.data(), mappedFile.size()));
+
+	mappedFile.close();
+	ASSERT_FALSE(mappedFile.isOpen());
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,46 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveBuffer.h"
+#include "../../CK2ToEU4/Source/CK2World/Vars/Vars.h"
+#include "gtest/gtest.h"
+#include <istream>
+
+TEST(CK2World_SaveBufferTests, bufferCanBeReadAsStream)
+{
+	const std::string input = "first second";
+	CK2::SaveBuffer buffer(input.data(), input.size());
+	std::istream theStream(&buffer);
+
+	std::string first;
+	std::string second;
+	theStream >> first >> second;
+
+	ASSERT_EQ("first", first);
+	ASSERT_EQ("second", second);
+	ASSERT_TRUE(theStream.eof());
+}
+
+TEST(CK2World_SaveBufferTests, bufferSupportsSeeking)
+{
+	const std::string input = "abcdef";
+	CK2::SaveBuffer buffer(input.data(), input.size());
+	std::istream theStream(&buffer);
+
+	theStream.seekg(3);
+	ASSERT_EQ('d', theStream.get());
+	ASSERT_EQ(4, theStream.tellg());
+	theStream.seekg(-2, std::ios_base::end);
+	ASSERT_EQ('e', theStream.get());
+	theStream.unget();
+	ASSERT_EQ('e', theStream.get());
+}
+
+TEST(CK2World_SaveBufferTests, bufferCanBeParsed)
+{
+	const std::string input = "=\n{\nglobal_chinese_taoist_ = 3.000\n}";
+	CK2::SaveBuffer buffer(input.data(), input.size());
+	std::istream theStream(&buffer);
+
+	const CK2::Vars vars(theStream);
+
+	ASSERT_EQ(1, vars.getVars().size());
+	ASSERT_NEAR(3.0, vars.getVars().find("global_chinese_taoist_")->second, 0.001);
+}
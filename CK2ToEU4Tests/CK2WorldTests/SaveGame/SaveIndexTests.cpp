@@ -0,0 +1,71 @@
+#include "../../CK2ToEU4/Source/CK2World/CacheStore.h"
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveIndex.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+const std::string gamestate =
+	 "CK2txt\n"
+	 "version=\"2.8.3.2\"\n"
+	 "character=\n{\n\t140=\n\t{\n\t\tbn=\"Harold\" # {\n\t}\n\t7=\n\t{\n\t\tbn=\"Edith\"\n\t}\n}\n"
+	 "relation=\n{\n}\n"
+	 "title=\n{\n\tk_england=\n\t{\n\t\tholder=140\n\t}\n}\n"
+	 "relation=\n{\n}\n"
+	 "}\n";
+} // namespace
+
+TEST(CK2World_SaveIndexTests, topLevelItemsAreIndexedInSaveOrder)
+{
+	const auto index = CK2::SaveIndex::build(gamestate);
+
+	ASSERT_EQ(5, index.getBlocks().size());
+	EXPECT_EQ("version", index.getBlocks()[0].key);
+	EXPECT_EQ("version=\"2.8.3.2\"", CK2::SaveIndex::textOf(gamestate, index.getBlocks()[0].span));
+	EXPECT_EQ("relation", index.getBlocks()[2].key);
+	EXPECT_EQ("relation", index.getBlocks()[4].key);
+	EXPECT_EQ("relation=\n{\n}", CK2::SaveIndex::textOf(gamestate, index.getBlocks()[4].span));
+}
+
+TEST(CK2World_SaveIndexTests, entitiesAreFoundWithoutScanning)
+{
+	const auto index = CK2::SaveIndex::build(gamestate);
+
+	const auto edith = index.find("character", "7");
+	ASSERT_TRUE(edith);
+	EXPECT_EQ("7=\n\t{\n\t\tbn=\"Edith\"\n\t}", CK2::SaveIndex::textOf(gamestate, *edith));
+	const auto england = index.find("title", "k_england");
+	ASSERT_TRUE(england);
+	EXPECT_EQ("k_england=\n\t{\n\t\tholder=140\n\t}", CK2::SaveIndex::textOf(gamestate, *england));
+	EXPECT_FALSE(index.find("character", "8"));
+	EXPECT_FALSE(index.find("relation", "140"));
+}
+
+TEST(CK2World_SaveIndexTests, indexIsKeptUnderTheSaveHash)
+{
+	const auto saveHash = CK2::CacheStore::digest(gamestate);
+	CK2::SaveIndex::build(gamestate).save(saveHash);
+
+	const auto index = CK2::SaveIndex::load(saveHash);
+	ASSERT_TRUE(index);
+	ASSERT_EQ(5, index->getBlocks().size());
+	const auto harold = index->find("character", "140");
+	ASSERT_TRUE(harold);
+	EXPECT_EQ("140=\n\t{\n\t\tbn=\"Harold\" # {\n\t}", CK2::SaveIndex::textOf(gamestate, *harold));
+	EXPECT_FALSE(CK2::SaveIndex::load(CK2::CacheStore::digest("CK2txt\n}\n")));
+}
+
+TEST(CK2World_SaveIndexTests, saveIsIndexedOnceAndFoundAgainByItsStamp)
+{
+	const std::string path = "saveIndexTest.ck2";
+	std::ofstream(path, std::ios::binary) << gamestate;
+
+	const auto built = CK2::SaveIndex::forSave(path, gamestate);
+	ASSERT_TRUE(CK2::SaveIndex::load(CK2::CacheStore::digest(gamestate)));
+	const auto found = CK2::SaveIndex::forSave(path, gamestate);
+
+	ASSERT_EQ(built.getBlocks().size(), found.getBlocks().size());
+	EXPECT_TRUE(found.find("title", "k_england"));
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,72 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveInspector.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+const std::string gamestate =
+	 "CK2txt\n"
+	 "version=\"2.8.3.2\"\n"
+	 "date=\"1066.9.15\"\n"
+	 "player=\n{\n\tid=140\n\ttype=45\n}\n"
+	 "player_realm=\"k_england\"\n"
+	 "player_name=\"Harold\"\n"
+	 "character=\n{\n\t140=\n\t{\n\t\tbn=\"Harold\" # {\n\t\tdnt=\"ugly }\"\n\t}\n}\n"
+	 "relation=\n{\n\tdiplo_140=\n\t{\n\t}\n}\n"
+	 "relation=\n{\n}\n"
+	 "}\n";
+} // namespace
+
+TEST(CK2World_SaveInspectorTests, leadingKeysAreRead)
+{
+	CK2::SaveInspection inspection;
+	CK2::inspectGamestate(gamestate, inspection);
+
+	ASSERT_EQ("2.8.3.2", inspection.version);
+	ASSERT_EQ("1066.9.15", inspection.date);
+	ASSERT_EQ("k_england", inspection.playerRealm);
+	ASSERT_EQ("Harold", inspection.playerName);
+}
+
+TEST(CK2World_SaveInspectorTests, topLevelBlocksAreMeasuredPastCommentsAndQuotes)
+{
+	CK2::SaveInspection inspection;
+	CK2::inspectGamestate(gamestate, inspection);
+
+	ASSERT_EQ(7, inspection.blocks.size());
+	EXPECT_EQ("version", inspection.blocks[0].name);
+	EXPECT_EQ("character", inspection.blocks[5].name);
+	EXPECT_EQ(std::string("character=\n{\n\t140=\n\t{\n\t\tbn=\"Harold\" # {\n\t\tdnt=\"ugly }\"\n\t}\n}").size(), inspection.blocks[5].bytes);
+	EXPECT_EQ(1, inspection.blocks[5].count);
+	EXPECT_EQ("relation", inspection.blocks[6].name);
+	EXPECT_EQ(std::string("relation=\n{\n\tdiplo_140=\n\t{\n\t}\n}relation=\n{\n}").size(), inspection.blocks[6].bytes);
+	EXPECT_EQ(2, inspection.blocks[6].count);
+}
+
+TEST(CK2World_SaveInspectorTests, leadingKeysOnlyStopsBeforeTheBlocks)
+{
+	CK2::SaveInspection inspection;
+	CK2::inspectGamestate(gamestate, inspection, false);
+
+	ASSERT_EQ("Harold", inspection.playerName);
+	ASSERT_TRUE(inspection.blocks.empty());
+}
+
+TEST(CK2World_SaveInspectorTests, uncompressedSaveIsInspectedInPlace)
+{
+	const std::string path = "saveInspectorTest.ck2";
+	{
+		std::ofstream output(path, std::ios::binary);
+		output << gamestate;
+	}
+
+	const auto inspection = CK2::inspectSave(path);
+
+	ASSERT_FALSE(inspection.compressed);
+	ASSERT_EQ(gamestate.size(), inspection.fileBytes);
+	ASSERT_EQ(gamestate.size(), inspection.gamestateBytes);
+	ASSERT_EQ("1066.9.15", inspection.date);
+	ASSERT_EQ(7, inspection.blocks.size());
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,74 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveInspector.h"
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveTuning.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+constexpr std::size_t MiB = 1024 * 1024;
+
+CK2::SaveInspection inspectionOf(const std::size_t gamestateBytes, const std::size_t characterBytes)
+{
+	CK2::SaveInspection inspection;
+	inspection.gamestateBytes = gamestateBytes;
+	inspection.blocks.push_back(CK2::SaveInspection::Block{"character", characterBytes, 1});
+	return inspection;
+}
+} // namespace
+
+TEST(CK2World_SaveTuningTests, smallSavesGetFewThreadsAndEagerCharacters)
+{
+	const auto tuning = CK2::tuneForSave(inspectionOf(12 * MiB, 4 * MiB), 0, Configuration::CHARACTER_DECODING::AUTO, 16);
+
+	ASSERT_EQ(2, tuning.threads);
+	ASSERT_EQ(Configuration::CHARACTER_DECODING::EAGER, tuning.characterDecoding);
+}
+
+TEST(CK2World_SaveTuningTests, bigSavesGetEveryCoreAndLazyCharacters)
+{
+	const auto tuning = CK2::tuneForSave(inspectionOf(300 * MiB, 100 * MiB), 0, Configuration::CHARACTER_DECODING::AUTO, 16);
+
+	ASSERT_EQ(16, tuning.threads);
+	ASSERT_EQ(Configuration::CHARACTER_DECODING::LAZY, tuning.characterDecoding);
+}
+
+TEST(CK2World_SaveTuningTests, megacampaignsSpillTheirCharacters)
+{
+	const auto tuning = CK2::tuneForSave(inspectionOf(900 * MiB, 400 * MiB), 0, Configuration::CHARACTER_DECODING::AUTO, 16);
+
+	ASSERT_EQ(Configuration::CHARACTER_DECODING::SPILLED, tuning.characterDecoding);
+}
+
+TEST(CK2World_SaveTuningTests, emptySaveStillGetsAThread)
+{
+	const auto tuning = CK2::tuneForSave(CK2::SaveInspection(), 0, Configuration::CHARACTER_DECODING::AUTO, 0);
+
+	ASSERT_EQ(1, tuning.threads);
+}
+
+TEST(CK2World_SaveTuningTests, compressedSavesEstimateTheirCharacters)
+{
+	CK2::SaveInspection inspection;
+	inspection.compressed = true;
+	inspection.gamestateBytes = 300 * MiB;
+
+	const auto tuning = CK2::tuneForSave(inspection, 0, Configuration::CHARACTER_DECODING::AUTO, 16);
+
+	ASSERT_EQ(Configuration::CHARACTER_DECODING::LAZY, tuning.characterDecoding);
+}
+
+TEST(CK2World_SaveTuningTests, configuredChoicesAreKept)
+{
+	const auto tuning = CK2::tuneForSave(inspectionOf(900 * MiB, 400 * MiB), 3, Configuration::CHARACTER_DECODING::EAGER, 16);
+
+	ASSERT_EQ(3, tuning.threads);
+	ASSERT_EQ(Configuration::CHARACTER_DECODING::EAGER, tuning.characterDecoding);
+}
+
+TEST(CK2World_SaveTuningTests, memoryEstimatesGrowWithTheGamestate)
+{
+	const auto small = CK2::estimateConversionBytes(inspectionOf(12 * MiB, 4 * MiB));
+	const auto big = CK2::estimateConversionBytes(inspectionOf(300 * MiB, 100 * MiB));
+
+	ASSERT_LT(small, big);
+	ASSERT_GE(big, 4 * 300 * MiB);
+}
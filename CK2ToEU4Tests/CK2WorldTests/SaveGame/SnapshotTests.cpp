@@ -0,0 +1,332 @@
+#include "../../CK2ToEU4/Source/CK2World/Characters/Character.h"
+#include "../../CK2ToEU4/Source/CK2World/Characters/Characters.h"
+#include "../../CK2ToEU4/Source/CK2World/Dynasties/Dynasties.h"
+#include "../../CK2ToEU4/Source/CK2World/Dynasties/Dynasty.h"
+#include "../../CK2ToEU4/Source/CK2World/Flags/Flags.h"
+#include "../../CK2ToEU4/Source/CK2World/Offmaps/Offmaps.h"
+#include "../../CK2ToEU4/Source/CK2World/Provinces/Barony.h"
+#include "../../CK2ToEU4/Source/CK2World/Provinces/Province.h"
+#include "../../CK2ToEU4/Source/CK2World/Provinces/Provinces.h"
+#include "../../CK2ToEU4/Source/CK2World/Relations/AllRelations.h"
+#include "../../CK2ToEU4/Source/CK2World/Religions/Religions.h"
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/Snapshot.h"
+#include "../../CK2ToEU4/Source/CK2World/Titles/Liege.h"
+#include "../../CK2ToEU4/Source/CK2World/Titles/Title.h"
+#include "../../CK2ToEU4/Source/CK2World/Titles/Titles.h"
+#include "../../CK2ToEU4/Source/CK2World/Vars/Vars.h"
+#include "../../CK2ToEU4/Source/CK2World/Wonders/Wonder.h"
+#include "../../CK2ToEU4/Source/CK2World/Wonders/Wonders.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+
+namespace
+{
+struct TestWorld
+{
+	date endDate = date("1444.11.11");
+	date startDate = date("1.1.1");
+	GameVersion CK2Version;
+	CK2::Provinces provinces;
+	CK2::Characters characters;
+	CK2::Titles titles;
+	CK2::Dynasties dynasties;
+	CK2::Wonders wonders;
+	CK2::Offmaps offmaps;
+	CK2::Diplomacy diplomacy;
+	CK2::Flags flags;
+	CK2::Vars vars;
+	CK2::Religions religions;
+	std::map<std::string, CK2::Liege> dynamicTitles;
+	std::map<std::string, std::shared_ptr<CK2::Title>> independentTitles;
+	std::optional<std::pair<std::string, std::shared_ptr<CK2::Title>>> hreTitle;
+	bool leviathanDLC = false;
+	std::set<std::string> existentPremadeMonuments;
+
+	CK2::Snapshot::State state()
+	{
+		return CK2::Snapshot::State{endDate, startDate, CK2Version, provinces, characters, titles, dynasties, wonders, offmaps, diplomacy, flags, vars, religions, dynamicTitles};
+	}
+	CK2::Snapshot::Built built() { return CK2::Snapshot::Built{independentTitles, hreTitle, leviathanDLC, existentPremadeMonuments}; }
+};
+
+TestWorld parsedWorld()
+{
+	TestWorld world;
+	world.endDate = date("1066.9.15");
+	world.startDate = date("769.1.1");
+	world.CK2Version = GameVersion("3.3.3");
+
+	std::stringstream provinceInput;
+	provinceInput << "= {\n";
+	provinceInput << "\t42 = { name = \"Paris\" culture = frankish primary_settlement = b_paris b_paris = { type = city ca_marketplace_1 = yes } }\n";
+	provinceInput << "}";
+	world.provinces = CK2::Provinces(provinceInput);
+
+	std::stringstream characterInput;
+	characterInput << "= {\n";
+	characterInput << "\t7 = { bn = \"Charles\" piety = 17.5 b_d = \"742.4.2\" lge = 9 dnt = 3 dmn = { capital = b_paris primary = { title = k_france } } }\n";
+	characterInput << "\t9 = { bn = \"Pepin\" fem = yes }\n";
+	characterInput << "}";
+	world.characters = CK2::Characters(characterInput);
+
+	std::stringstream titleInput;
+	titleInput << "= {\n";
+	titleInput << "\tk_france = { holder = 7 law = succ_primogeniture name = \"Francia\" color = { 10 20 30 } liege = { title = e_francia } }\n";
+	titleInput << "}";
+	world.titles = CK2::Titles(titleInput);
+
+	std::stringstream dynastyInput;
+	dynastyInput << "= {\n";
+	dynastyInput << "\t3 = { name = \"Karling\" culture = frankish }\n";
+	dynastyInput << "}";
+	world.dynasties.loadDynasties(dynastyInput);
+
+	std::stringstream wonderInput;
+	wonderInput << "= {\n";
+	wonderInput << "\t5 = { type = wonder_cathedral province = 42 stage = 3 active = yes }\n";
+	wonderInput << "}";
+	world.wonders = CK2::Wonders(wonderInput);
+
+	std::stringstream diplomacyInput;
+	diplomacyInput << "= {\n";
+	diplomacyInput << "\tdiplo_7 = { 9 = { tributary = { tributary_type = default } } }\n";
+	diplomacyInput << "}";
+	world.diplomacy = CK2::Diplomacy(diplomacyInput);
+
+	std::stringstream flagsInput;
+	flagsInput << "= { aztec_explorers = 1000.1.1 }";
+	world.flags = CK2::Flags(flagsInput);
+
+	std::stringstream varsInput;
+	varsInput << "= { global_var = 2.5 }";
+	world.vars = CK2::Vars(varsInput);
+
+	std::stringstream liegeInput;
+	liegeInput << "= { title = d_dynamic is_dynamic = yes }";
+	world.dynamicTitles.emplace("d_dynamic", CK2::Liege(liegeInput));
+	return world;
+}
+} // namespace
+
+TEST(CK2World_SnapshotTests, parsedStateSurvivesARoundTrip)
+{
+	const std::string path = "snapshotRoundTrip.snapshot";
+	auto original = parsedWorld();
+	CK2::Snapshot::save(path, "key", original.state());
+
+	TestWorld loaded;
+	ASSERT_TRUE(CK2::Snapshot::load(path, "key", loaded.state()));
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(date("1066.9.15"), loaded.endDate);
+	EXPECT_EQ(date("769.1.1"), loaded.startDate);
+	EXPECT_EQ(GameVersion("3.3.3"), loaded.CK2Version);
+
+	const auto& province = loaded.provinces.getProvinces().at(42);
+	EXPECT_EQ("Paris", province->getName());
+	EXPECT_EQ("frankish", province->getCulture());
+	EXPECT_EQ("b_paris", province->getPrimarySettlement().first);
+	EXPECT_EQ(nullptr, province->getPrimarySettlement().second);
+	ASSERT_EQ(1, province->getBaronies().size());
+	EXPECT_EQ("city", province->getBaronies().at("b_paris")->getType());
+	EXPECT_EQ(1, province->getBaronies().at("b_paris")->getBuildingCount());
+
+	ASSERT_EQ(2, loaded.characters.getCharacters().size());
+	const auto& charles = loaded.characters.getCharacters().at(7);
+	EXPECT_EQ("Charles", charles->getName());
+	EXPECT_DOUBLE_EQ(17.5, charles->getPiety());
+	EXPECT_EQ(date("742.4.2"), charles->getBirthDate());
+	EXPECT_EQ(9, charles->getLiege().first);
+	EXPECT_EQ(nullptr, charles->getLiege().second);
+	EXPECT_EQ(3, charles->getDynasty().first);
+	EXPECT_EQ("b_paris", charles->getCapital().first);
+	ASSERT_NE(nullptr, charles->getPrimaryTitle().second);
+	EXPECT_EQ("k_france", charles->getPrimaryTitle().second->getTitle().first);
+	EXPECT_TRUE(loaded.characters.getCharacters().at(9)->isFemale());
+
+	const auto& france = loaded.titles.getTitles().at("k_france");
+	EXPECT_EQ(7, france->getHolder().first);
+	EXPECT_EQ(nullptr, france->getHolder().second);
+	EXPECT_EQ("Francia", france->getDisplayName());
+	EXPECT_EQ(1, france->getLaws().size());
+	EXPECT_EQ(1, france->getLaws().count("succ_primogeniture"));
+	ASSERT_TRUE(france->getColor());
+	EXPECT_EQ(commonItems::Color(std::array<int, 3>{10, 20, 30}), *france->getColor());
+	ASSERT_NE(nullptr, france->getLiege().second);
+	EXPECT_EQ("e_francia", france->getLiege().second->getName());
+
+	EXPECT_EQ("Karling", loaded.dynasties.getDynasties().at(3)->getName());
+	EXPECT_EQ("frankish", loaded.dynasties.getDynasties().at(3)->getCulture());
+
+	const auto& wonder = loaded.wonders.getWonders().at(5);
+	EXPECT_EQ("wonder_cathedral", wonder->getType());
+	EXPECT_EQ(42, wonder->getProvinceID());
+	EXPECT_TRUE(wonder->isTransferrable());
+
+	const auto& relations = loaded.diplomacy.getDiplomacy().at(7).getRelations();
+	ASSERT_EQ(1, relations.size());
+	EXPECT_EQ(7, relations[0].getFirst());
+	EXPECT_EQ(9, relations[0].getSecond());
+	EXPECT_EQ("default", relations[0].getTributaryType());
+
+	EXPECT_TRUE(loaded.flags.getInvasion());
+	EXPECT_DOUBLE_EQ(2.5, loaded.vars.getVars().at("global_var"));
+	EXPECT_TRUE(loaded.dynamicTitles.at("d_dynamic").isDynamic());
+}
+
+TEST(CK2World_SnapshotTests, largeTablesSurviveARoundTripAndAreCompressed)
+{
+	const std::string path = "snapshotLarge.snapshot";
+	TestWorld original;
+	std::stringstream characterInput;
+	characterInput << "= {\n";
+	for (auto characterID = 1; characterID <= 5000; ++characterID)
+		characterInput << "\t" << characterID << " = { bn = \"Charles\" piety = 17.5 b_d = \"742.4.2\" lge = 9 dnt = 3 }\n";
+	characterInput << "}";
+	original.characters = CK2::Characters(characterInput);
+	CK2::Snapshot::save(path, "key", original.state());
+	const auto snapshotSize = std::filesystem::file_size(path);
+
+	TestWorld loaded;
+	ASSERT_TRUE(CK2::Snapshot::load(path, "key", loaded.state()));
+	std::filesystem::remove(path);
+
+	ASSERT_EQ(5000, loaded.characters.getCharacters().size());
+	EXPECT_EQ("Charles", loaded.characters.getCharacters().at(4999)->getName());
+	EXPECT_EQ(3, loaded.characters.getCharacters().at(4999)->getDynasty().first);
+	// Every character takes far more than 20 bytes written out as-is.
+	EXPECT_LT(snapshotSize, 5000 * 20);
+}
+
+TEST(CK2World_SnapshotTests, checkpointKeepsWhereLinksLead)
+{
+	const std::string path = "snapshotCheckpoint.checkpoint";
+	auto original = parsedWorld();
+	original.characters.linkDynasties(original.dynasties);
+	original.titles.linkHolders(original.characters);
+	original.characters.linkPrimaryTitles(original.titles);
+	const auto& charles = original.characters.getCharacters().at(7);
+	const auto& pepin = original.characters.getCharacters().at(9);
+	const auto& france = original.titles.getTitles().at("k_france");
+	// As the CK2 phases leave things: an heir under a key that isn't their ID, and a liege no table holds.
+	charles->setHeir(std::pair(1234, pepin));
+	std::stringstream franciaInput("= { holder = 9 }");
+	const auto francia = std::make_shared<CK2::Title>(franciaInput, "e_francia");
+	francia->setHolder(pepin);
+	france->overrideLiege(std::pair(std::string("e_francia"), francia));
+	original.independentTitles.emplace("k_france", france);
+	original.hreTitle = std::pair(std::string("e_francia"), francia);
+	original.leviathanDLC = true;
+	original.existentPremadeMonuments.insert("wonder_cathedral");
+	CK2::Snapshot::saveCheckpoint(path, "key", original.state(), original.built());
+
+	TestWorld loaded;
+	ASSERT_TRUE(CK2::Snapshot::loadCheckpoint(path, "key", loaded.state(), loaded.built()));
+	std::filesystem::remove(path);
+
+	const auto& loadedCharles = loaded.characters.getCharacters().at(7);
+	const auto& loadedPepin = loaded.characters.getCharacters().at(9);
+	const auto& loadedFrance = loaded.titles.getTitles().at("k_france");
+	EXPECT_EQ(1234, loadedCharles->getHeir().first);
+	EXPECT_EQ(loadedPepin, loadedCharles->getHeir().second);
+	EXPECT_EQ(loaded.dynasties.getDynasties().at(3), loadedCharles->getDynasty().second);
+	EXPECT_EQ(loadedCharles, loadedFrance->getHolder().second);
+	ASSERT_NE(nullptr, loadedCharles->getPrimaryTitle().second);
+	EXPECT_EQ(loadedFrance, loadedCharles->getPrimaryTitle().second->getTitle().second);
+
+	// The liege no table holds comes back whole, and whatever led to it leads to the one entity.
+	const auto& loadedFrancia = loadedFrance->getLiege().second;
+	ASSERT_NE(nullptr, loadedFrancia);
+	EXPECT_EQ("e_francia", loadedFrancia->getName());
+	EXPECT_EQ(loadedPepin, loadedFrancia->getHolder().second);
+	EXPECT_FALSE(loaded.titles.getTitles().contains("e_francia"));
+	ASSERT_TRUE(loaded.hreTitle);
+	EXPECT_EQ(loadedFrancia, loaded.hreTitle->second);
+
+	ASSERT_EQ(1, loaded.independentTitles.size());
+	EXPECT_EQ(loadedFrance, loaded.independentTitles.at("k_france"));
+	EXPECT_TRUE(loaded.leviathanDLC);
+	EXPECT_EQ(std::set<std::string>{"wonder_cathedral"}, loaded.existentPremadeMonuments);
+}
+
+TEST(CK2World_SnapshotTests, snapshotsAndCheckpointsAreNotMistaken)
+{
+	const std::string path = "snapshotOrCheckpoint.snapshot";
+	auto original = parsedWorld();
+	CK2::Snapshot::save(path, "key", original.state());
+
+	TestWorld loaded;
+	EXPECT_FALSE(CK2::Snapshot::loadCheckpoint(path, "key", loaded.state(), loaded.built()));
+	CK2::Snapshot::saveCheckpoint(path, "key", original.state(), original.built());
+	EXPECT_FALSE(CK2::Snapshot::load(path, "key", loaded.state()));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_SnapshotTests, missingSnapshotIsNotLoaded)
+{
+	TestWorld loaded;
+
+	ASSERT_FALSE(CK2::Snapshot::load("nonExistent.snapshot", "key", loaded.state()));
+}
+
+TEST(CK2World_SnapshotTests, snapshotForAnotherKeyIsNotLoaded)
+{
+	const std::string path = "snapshotOtherKey.snapshot";
+	auto original = parsedWorld();
+	CK2::Snapshot::save(path, "key", original.state());
+
+	TestWorld loaded;
+	ASSERT_FALSE(CK2::Snapshot::load(path, "another key", loaded.state()));
+	std::filesystem::remove(path);
+
+	ASSERT_TRUE(loaded.characters.getCharacters().empty());
+}
+
+TEST(CK2World_SnapshotTests, truncatedSnapshotIsNotLoaded)
+{
+	const std::string path = "snapshotTruncated.snapshot";
+	auto original = parsedWorld();
+	CK2::Snapshot::save(path, "key", original.state());
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+	TestWorld loaded;
+	ASSERT_FALSE(CK2::Snapshot::load(path, "key", loaded.state()));
+	std::filesystem::remove(path);
+}
+
+TEST(CK2World_SnapshotTests, fileHashFollowsContents)
+{
+	const std::string path = "snapshotHash.ck2";
+	std::ofstream(path, std::ios::binary) << "CK2txt\nversion=\"3.3.3\"\n";
+	const auto firstHash = CK2::Snapshot::hashFile(path);
+	const auto sameHash = CK2::Snapshot::hashFile(path);
+	std::ofstream(path, std::ios::binary) << "CK2txt\nversion=\"3.3.4\"\n";
+	const auto otherHash = CK2::Snapshot::hashFile(path);
+	std::filesystem::remove(path);
+
+	ASSERT_EQ(16, firstHash.size());
+	ASSERT_EQ(firstHash, sameHash);
+	ASSERT_NE(firstHash, otherHash);
+}
+
+TEST(CK2World_SnapshotTests, keyTracksVersionAndMods)
+{
+	const auto key = CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {});
+
+	ASSERT_NE(key, CK2::Snapshot::makeKey("0123456789abcdef", "1.1", "ck2", {}));
+	ASSERT_NE(key, CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {Mod("CleanSlate", "mod/cleanslate")}));
+	ASSERT_EQ(key, CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {}));
+}
+
+TEST(CK2World_SnapshotTests, keyTracksPhaseOptions)
+{
+	const auto key = CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {}, {"eu4", "1"});
+
+	ASSERT_NE(key, CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {}));
+	ASSERT_NE(key, CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {}, {"eu4", "2"}));
+	ASSERT_EQ(key, CK2::Snapshot::makeKey("0123456789abcdef", "1.0", "ck2", {}, {"eu4", "1"}));
+}
@@ -0,0 +1,44 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SpillFile.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <string>
+
+namespace
+{
+std::size_t spillsInTempFolder()
+{
+	std::size_t spills = 0;
+	for (const auto& entry: std::filesystem::directory_iterator(std::filesystem::temp_directory_path()))
+		if (entry.path().extension() == ".spill" && entry.path().filename().string().starts_with("CK2ToEU4-"))
+			++spills;
+	return spills;
+}
+} // namespace
+
+TEST(CK2World_SpillFileTests, spilledBytesReadBack)
+{
+	const std::string block = "=\n{\n\t140=\n\t{\n\t\tbn=\"Harold\"\n\t}\n}";
+
+	const CK2::SpillFile spill(block);
+
+	ASSERT_EQ(block, spill.view());
+	ASSERT_NE(block.data(), spill.view().data());
+}
+
+TEST(CK2World_SpillFileTests, emptySpillIsEmpty)
+{
+	const CK2::SpillFile spill("");
+
+	ASSERT_TRUE(spill.view().empty());
+}
+
+TEST(CK2World_SpillFileTests, spillLeavesNoFileBehind)
+{
+	const auto spillsBefore = spillsInTempFolder();
+	{
+		const CK2::SpillFile spill(std::string(100000, 'x'));
+		ASSERT_EQ(100000, spill.view().size());
+	}
+
+	ASSERT_EQ(spillsBefore, spillsInTempFolder());
+}
@@ -0,0 +1,95 @@
+#include "../../CK2ToEU4/Source/CK2World/SliceLog.h"
+#include "../../CK2ToEU4/Source/CK2World/TaskGraph.h"
+#include "gmock/gmock-matchers.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(CK2World_SliceLogTests, linesAreWrittenInSliceOrder)
+{
+	std::stringstream log;
+	auto stdOutBuf = std::cout.rdbuf();
+	std::cout.rdbuf(log.rdbuf());
+
+	CK2::SliceLog warnings(LogLevel::Warning);
+	{
+		auto later = warnings.slice(10);
+		later.line("Spouse ID") << "Spouse ID: " << 11 << " has no definition!";
+	}
+	{
+		auto earlier = warnings.slice(0);
+		earlier.line("Liege ID") << "Liege ID: " << 1 << " has no definition!";
+		earlier.line("Liege ID") << "Liege ID: " << 2 << " has no definition!";
+	}
+	warnings.flush();
+
+	std::cout.rdbuf(stdOutBuf);
+	const auto stringLog = log.str();
+
+	const auto first = stringLog.find("[WARNING] Liege ID: 1 has no definition!");
+	const auto second = stringLog.find("[WARNING] Liege ID: 2 has no definition!");
+	const auto third = stringLog.find("[WARNING] Spouse ID: 11 has no definition!");
+	ASSERT_NE(std::string::npos, first);
+	ASSERT_LT(first, second);
+	ASSERT_LT(second, third);
+}
+
+TEST(CK2World_SliceLogTests, everySliceOfASweepIsHandedOver)
+{
+	std::stringstream log;
+	auto stdOutBuf = std::cout.rdbuf();
+	std::cout.rdbuf(log.rdbuf());
+
+	CK2::SliceLog warnings(LogLevel::Warning);
+	CK2::forEachSlice(
+		 1000,
+		 [&warnings](const std::size_t first, const std::size_t last) {
+			 auto sliceWarnings = warnings.slice(first);
+			 for (auto index = first; index < last; ++index)
+				 if (index % 100 == 0)
+					 sliceWarnings.line("Missing") << "Missing " << index;
+		 },
+		 10);
+	warnings.flush();
+
+	std::cout.rdbuf(stdOutBuf);
+	const auto stringLog = log.str();
+
+	std::size_t previous = 0;
+	for (auto index = 0; index < 1000; index += 100)
+	{
+		const auto position = stringLog.find("Missing " + std::to_string(index) + "\n");
+		ASSERT_NE(std::string::npos, position);
+		ASSERT_GE(position, previous);
+		previous = position;
+	}
+}
+
+TEST(CK2World_SliceLogTests, onlyTheFirstLinesOfACategoryAreWritten)
+{
+	std::stringstream log;
+	auto stdOutBuf = std::cout.rdbuf();
+	std::cout.rdbuf(log.rdbuf());
+
+	CK2::SliceLog warnings(LogLevel::Warning, 2);
+	{
+		auto later = warnings.slice(10);
+		for (auto spouse = 10; spouse < 15; ++spouse)
+			later.line("Spouse ID") << "Spouse ID: " << spouse << " has no definition!";
+		later.line("Liege ID") << "Liege ID: 3 has no definition!";
+	}
+	{
+		auto earlier = warnings.slice(0);
+		earlier.line("Spouse ID") << "Spouse ID: 1 has no definition!";
+	}
+	warnings.flush();
+
+	std::cout.rdbuf(stdOutBuf);
+	const auto stringLog = log.str();
+
+	EXPECT_NE(std::string::npos, stringLog.find("Spouse ID: 1 has no definition!"));
+	EXPECT_NE(std::string::npos, stringLog.find("Spouse ID: 10 has no definition!"));
+	EXPECT_EQ(std::string::npos, stringLog.find("Spouse ID: 11 has no definition!"));
+	EXPECT_NE(std::string::npos, stringLog.find("... and 4 more Spouse ID lines like these (6 in all)."));
+	EXPECT_NE(std::string::npos, stringLog.find("Liege ID: 3 has no definition!"));
+	EXPECT_EQ(std::string::npos, stringLog.find("more Liege ID"));
+}
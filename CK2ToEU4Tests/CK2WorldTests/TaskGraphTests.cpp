@@ -0,0 +1,210 @@
+#include "../../CK2ToEU4/Source/CK2World/Concurrency.h"
+#include "../../CK2ToEU4/Source/CK2World/TaskGraph.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(CK2World_TaskGraphTests, tasksRunAfterTheirDependencies)
+{
+	CK2::TaskGraph graph;
+	std::atomic<int> step = 0;
+	auto firstStep = 0;
+	auto secondStep = 0;
+	auto lastStep = 0;
+	graph.addTask("first", {}, [&step, &firstStep] {
+		firstStep = ++step;
+	});
+	graph.addTask("second", {"first"}, [&step, &secondStep] {
+		secondStep = ++step;
+	});
+	graph.addTask("last", {"first", "second"}, [&step, &lastStep] {
+		lastStep = ++step;
+	});
+
+	graph.run();
+
+	ASSERT_EQ(1, firstStep);
+	ASSERT_EQ(2, secondStep);
+	ASSERT_EQ(3, lastStep);
+}
+
+TEST(CK2World_TaskGraphTests, unknownAndDuplicateTasksAreRejected)
+{
+	CK2::TaskGraph graph;
+	graph.addTask("first", {}, [] {
+	});
+
+	ASSERT_THROW(graph.addTask("first", {}, [] {
+	}),
+		 std::invalid_argument);
+	ASSERT_THROW(graph.addTask("second", {"third"}, [] {
+	}),
+		 std::invalid_argument);
+}
+
+TEST(CK2World_TaskGraphTests, failureSkipsDependentsAndIsRethrown)
+{
+	CK2::TaskGraph graph;
+	auto dependentRan = false;
+	auto independentRan = false;
+	graph.addTask("failing", {}, [] {
+		throw std::runtime_error("failing");
+	});
+	graph.addTask("dependent", {"failing"}, [&dependentRan] {
+		dependentRan = true;
+	});
+	graph.addTask("independent", {}, [&independentRan] {
+		independentRan = true;
+	});
+
+	ASSERT_THROW(graph.run(), std::runtime_error);
+	ASSERT_FALSE(dependentRan);
+	ASSERT_TRUE(independentRan);
+}
+
+TEST(CK2World_TaskGraphTests, slicesCoverTheRangeOnce)
+{
+	for (const std::size_t count: {0, 5, 100000})
+	{
+		std::vector<std::atomic<int>> visits(count);
+		CK2::forEachSlice(count, [&visits](const std::size_t first, const std::size_t last) {
+			for (auto index = first; index < last; ++index)
+				++visits[index];
+		});
+
+		for (const auto& visit: visits)
+			ASSERT_EQ(1, visit.load());
+	}
+}
+
+TEST(CK2World_TaskGraphTests, smallMinimumSlicesStillVisitEveryIndexOnce)
+{
+	std::vector<std::atomic<int>> visits(1000);
+	CK2::forEachSlice(
+		 visits.size(),
+		 [&visits](const std::size_t first, const std::size_t last) {
+			 for (auto index = first; index < last; ++index)
+				 ++visits[index];
+		 },
+		 32);
+
+	for (const auto& visit: visits)
+		ASSERT_EQ(1, visit.load());
+}
+
+TEST(CK2World_TaskGraphTests, oneThreadRunsStepsOnTheCallingThread)
+{
+	CK2::Concurrency::configure(1, 0);
+	CK2::TaskGraph graph;
+	std::vector<std::thread::id> threads;
+	graph.addTask("first", {}, [&threads] {
+		threads.emplace_back(std::this_thread::get_id());
+	});
+	graph.addTask("second", {}, [&threads] {
+		threads.emplace_back(std::this_thread::get_id());
+	});
+
+	graph.run();
+	CK2::Concurrency::configure(0, 0);
+
+	ASSERT_EQ(2u, threads.size());
+	EXPECT_EQ(std::this_thread::get_id(), threads[0]);
+	EXPECT_EQ(std::this_thread::get_id(), threads[1]);
+}
+
+TEST(CK2World_TaskGraphTests, seededOrdersStillRespectDependencies)
+{
+	for (std::uint32_t seed = 1; seed <= 20; ++seed)
+	{
+		CK2::Concurrency::configure(0, seed);
+		CK2::TaskGraph graph;
+		std::vector<std::string> order;
+		for (const auto& name: {"a", "b", "c", "d"})
+			graph.addTask(name, {}, [&order, name] {
+				order.emplace_back(name);
+			});
+		graph.addTask("last", {"a", "b", "c", "d"}, [&order] {
+			order.emplace_back("last");
+		});
+
+		graph.run();
+
+		ASSERT_EQ(5, order.size());
+		EXPECT_EQ("last", order.back());
+	}
+	CK2::Concurrency::configure(0, 0);
+}
+
+TEST(CK2World_TaskGraphTests, seededRunsFailLikeParallelOnes)
+{
+	CK2::Concurrency::configure(0, 7);
+	CK2::TaskGraph graph;
+	auto skipped = true;
+	auto independent = false;
+	graph.addTask("failing", {}, [] {
+		throw std::runtime_error("failing");
+	});
+	graph.addTask("downstream", {"failing"}, [&skipped] {
+		skipped = false;
+	});
+	graph.addTask("independent", {}, [&independent] {
+		independent = true;
+	});
+
+	EXPECT_THROW(graph.run(), std::runtime_error);
+	CK2::Concurrency::configure(0, 0);
+	EXPECT_TRUE(skipped);
+	EXPECT_TRUE(independent);
+}
+
+TEST(CK2World_TaskGraphTests, claimedPassesVisitEveryIndexOnce)
+{
+	std::vector<std::atomic<int>> visits(300);
+	CK2::forEachClaimed(visits.size(), [&visits](const std::size_t index) {
+		++visits[index];
+	});
+
+	for (const auto& visit: visits)
+		ASSERT_EQ(1, visit.load());
+}
+
+TEST(CK2World_TaskGraphTests, claimedPassesRethrowFailures)
+{
+	std::atomic<int> visited = 0;
+	EXPECT_THROW(CK2::forEachClaimed(50,
+						  [&visited](const std::size_t index) {
+							  ++visited;
+							  if (index == 17)
+								  throw std::runtime_error("failing");
+						  }),
+		 std::runtime_error);
+	EXPECT_LE(1, visited.load());
+}
+
+TEST(CK2World_TaskGraphTests, jobCapsReachTheStepsTheyStart)
+{
+	CK2::Concurrency::configure(8, 0);
+	std::size_t stepThreads = 0;
+	std::atomic<std::size_t> claimedThreads = 0;
+	{
+		const CK2::Concurrency::JobCap cap(2);
+		CK2::TaskGraph graph;
+		graph.addTask("step", {}, [&stepThreads] {
+			stepThreads = CK2::Concurrency::threads();
+		});
+		graph.addTask("other", {}, [] {
+		});
+		graph.run();
+		CK2::forEachClaimed(50, [&claimedThreads](std::size_t) {
+			claimedThreads = CK2::Concurrency::threads();
+		});
+		EXPECT_EQ(2, CK2::Concurrency::threads());
+	}
+
+	EXPECT_EQ(2, stepThreads);
+	EXPECT_EQ(2, claimedThreads.load());
+	EXPECT_EQ(8, CK2::Concurrency::threads());
+	CK2::Concurrency::configure(0, 0);
+}
@@ -0,0 +1,119 @@
+#include "../../CK2ToEU4/Source/CK2World/Concurrency.h"
+#include "../../CK2ToEU4/Source/CK2World/TaskGraph.h"
+#include "../../CK2ToEU4/Source/CK2World/ThreadPool.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(CK2World_ThreadPoolTests, groupRunsEverythingAndRethrowsTheFirstFailure)
+{
+	CK2::ThreadPool pool(3);
+	CK2::TaskGroup group(pool);
+	std::atomic<int> ran = 0;
+	for (auto task = 0; task < 100; ++task)
+		group.run([&ran, task] {
+			++ran;
+			if (task == 40 || task == 60)
+				throw std::runtime_error(std::to_string(task));
+		});
+
+	try
+	{
+		group.wait();
+		FAIL();
+	}
+	catch (const std::runtime_error& e)
+	{
+		ASSERT_EQ("40", std::string(e.what()));
+	}
+	ASSERT_EQ(100, ran);
+}
+
+TEST(CK2World_ThreadPoolTests, nestedGroupsFinishOnASingleWorker)
+{
+	CK2::ThreadPool pool(1);
+	CK2::TaskGroup outer(pool);
+	std::atomic<int> ran = 0;
+	for (auto task = 0; task < 4; ++task)
+		outer.run([&pool, &ran] {
+			CK2::TaskGroup inner(pool);
+			for (auto innerTask = 0; innerTask < 4; ++innerTask)
+				inner.run([&ran] {
+					++ran;
+				});
+			inner.wait();
+		});
+
+	outer.wait();
+
+	ASSERT_EQ(16, ran);
+}
+
+TEST(CK2World_ThreadPoolTests, loopsAndGraphsRunOnTheInstalledPool)
+{
+	CK2::Concurrency::configure(4, 0);
+	{
+		const CK2::ThreadPool::Scope scope(3);
+		ASSERT_NE(nullptr, CK2::ThreadPool::current());
+
+		std::vector<int> touched(100000);
+		CK2::forEachItem(touched, [](int& item) {
+			++item;
+		});
+		ASSERT_EQ(std::vector<int>(100000, 1), touched);
+
+		CK2::TaskGraph graph;
+		std::atomic<int> step = 0;
+		auto firstStep = 0;
+		auto lastStep = 0;
+		graph.addTask("first", {}, [&step, &firstStep] {
+			firstStep = ++step;
+		});
+		graph.addTask("failing", {}, [] {
+			throw std::runtime_error("failing");
+		});
+		graph.addTask("skipped", {"failing"}, [] {
+			FAIL();
+		});
+		graph.addTask("last", {"first"}, [&step, &lastStep] {
+			lastStep = ++step;
+		});
+		ASSERT_THROW(graph.run(), std::runtime_error);
+		ASSERT_EQ(1, firstStep);
+		ASSERT_EQ(2, lastStep);
+	}
+	ASSERT_EQ(nullptr, CK2::ThreadPool::current());
+	CK2::Concurrency::configure(0, 0);
+}
+
+TEST(CK2World_ThreadPoolTests, reductionDoesNotDependOnTheThreadCount)
+{
+	std::vector<double> weights;
+	for (auto weight = 0; weight < 50000; ++weight)
+		weights.emplace_back(1.0 / (weight + 3));
+	const auto sum = [&weights] {
+		return CK2::reduceSlices(
+			 weights.size(),
+			 0.0,
+			 [&weights](const std::size_t first, const std::size_t last) {
+				 auto partial = 0.0;
+				 for (auto index = first; index < last; ++index)
+					 partial += weights[index];
+				 return partial;
+			 },
+			 [](const double total, const double partial) {
+				 return total + partial;
+			 },
+			 1000);
+	};
+
+	CK2::Concurrency::configure(1, 0);
+	const auto serialSum = sum();
+	CK2::Concurrency::configure(8, 0);
+	const auto parallelSum = sum();
+	CK2::Concurrency::configure(0, 0);
+
+	ASSERT_EQ(serialSum, parallelSum);
+}
@@ -1,6 +1,5 @@
 #include "../CK2ToEU4/Source/CK2World/Provinces/Province.h"
 #include "../CK2ToEU4/Source/CK2World/Provinces/Provinces.h"
-#include "../CK2ToEU4/Source/CK2World/Titles/Liege.h"
 #include "../CK2ToEU4/Source/CK2World/Titles/Title.h"
 #include "gtest/gtest.h"
 #include <sstream>
@@ -122,10 +121,8 @@ TEST(CK2World_TitleTests, previousHoldersCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getPreviousHolders().size(), 3);
-	ASSERT_EQ(theTitle.getPreviousHolders().find(1)->first, 1);
-	ASSERT_EQ(theTitle.getPreviousHolders().find(2)->first, 2);
-	ASSERT_EQ(theTitle.getPreviousHolders().find(3)->first, 3);
+	ASSERT_EQ(theTitle.getPreviousHolderIDs(), std::vector<int>({1, 2, 3}));
+	ASSERT_TRUE(theTitle.getPreviousHolders().empty());
 }
 
 TEST(CK2World_TitleTests, previousHoldersDefaultsToEmpty)
@@ -137,6 +134,7 @@ TEST(CK2World_TitleTests, previousHoldersDefaultsToEmpty)
 
 	const CK2::Title theTitle(input, "c_test");
 
+	ASSERT_TRUE(theTitle.getPreviousHolderIDs().empty());
 	ASSERT_TRUE(theTitle.getPreviousHolders().empty());
 }
 
@@ -288,7 +286,7 @@ TEST(CK2World_TitleTests, simpleLiegeCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getLiege().second->getTitle().first, "c_test2");
+	ASSERT_EQ(theTitle.getLiege().first, "c_test2");
 }
 
 TEST(CK2World_TitleTests, complexLiegeCanBeSet)
@@ -304,7 +302,7 @@ TEST(CK2World_TitleTests, complexLiegeCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getLiege().second->getTitle().first, "c_test2");
+	ASSERT_EQ(theTitle.getLiege().first, "c_test2");
 }
 
 TEST(CK2World_TitleTests, deJureLiegeTitleDefaultsToNull)
@@ -329,7 +327,7 @@ TEST(CK2World_TitleTests, simpleDeJureLiegeCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getDeJureLiege().second->getTitle().first, "c_test2");
+	ASSERT_EQ(theTitle.getDeJureLiege().first, "c_test2");
 }
 
 TEST(CK2World_TitleTests, complexDeJureLiegeCanBeSet)
@@ -345,7 +343,7 @@ TEST(CK2World_TitleTests, complexDeJureLiegeCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getDeJureLiege().second->getTitle().first, "c_test2");
+	ASSERT_EQ(theTitle.getDeJureLiege().first, "c_test2");
 }
 
 TEST(CK2World_TitleTests, baseTitleDefaultsToBlank)
@@ -370,7 +368,7 @@ TEST(CK2World_TitleTests, simpleBaseTitleCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getBaseTitle().second->getTitle().first, "c_base");
+	ASSERT_EQ(theTitle.getBaseTitle().first, "c_base");
 }
 
 TEST(CK2World_TitleTests, complexBaseTitleCanBeSet)
@@ -386,7 +384,26 @@ TEST(CK2World_TitleTests, complexBaseTitleCanBeSet)
 
 	const CK2::Title theTitle(input, "c_test");
 
-	ASSERT_EQ(theTitle.getBaseTitle().second->getTitle().first, "c_base");
+	ASSERT_EQ(theTitle.getBaseTitle().first, "c_base");
+}
+
+TEST(CK2World_TitleTests, nestedBaseTitleNameIsKept)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "\tbase_title=\n";
+	input << "\t{\n";
+	input << "\ttitle=c_base\n";
+	input << "\tbase_title=d_base\n";
+	input << "\t}\n";
+	input << "}";
+
+	const CK2::Title theTitle(input, "c_test");
+
+	ASSERT_EQ(theTitle.getBaseTitle().first, "c_base");
+	ASSERT_EQ(theTitle.getBaseTitleBase(), "d_base");
+	ASSERT_FALSE(theTitle.getBaseTitle().second);
 }
 
 TEST(CK2World_TitleTests, provincesDefaultToEmpty)
@@ -477,3 +494,68 @@ TEST(CK2World_TitleTests, electorsCanBeSet)
 	ASSERT_TRUE(theTitle.getElectors().count(2));
 	ASSERT_TRUE(theTitle.getElectors().count(3));
 }
+
+TEST(CK2World_TitleTests, coalescedProvincesFollowHierarchyChanges)
+{
+	std::stringstream input;
+	input << "= {}";
+	const auto duchy = std::make_shared<CK2::Title>(input, "d_test");
+	const auto county = std::make_shared<CK2::Title>(input, "c_test");
+	const auto otherCounty = std::make_shared<CK2::Title>(input, "c_other");
+	county->registerProvince(std::pair(1, std::make_shared<CK2::Province>()));
+	otherCounty->registerProvince(std::pair(2, std::make_shared<CK2::Province>()));
+	duchy->registerVassal(std::pair("c_test", county));
+
+	ASSERT_EQ(1, duchy->coalesceProvinces().size());
+	ASSERT_EQ(&duchy->coalesceProvinces(), &duchy->coalesceProvinces());
+
+	duchy->registerVassal(std::pair("c_other", otherCounty));
+	ASSERT_EQ(2, duchy->coalesceProvinces().size());
+
+	county->registerProvince(std::pair(3, std::make_shared<CK2::Province>()));
+	ASSERT_EQ(3, duchy->coalesceProvinces().size());
+
+	duchy->registerGeneratedVassal(std::pair("c_other", otherCounty));
+	ASSERT_EQ(2, duchy->coalesceProvinces().size());
+	ASSERT_FALSE(duchy->coalesceProvinces().count(2));
+}
+
+TEST(CK2World_TitleTests, deJureFlaggingCoversTheWholeTreeAndSurvivesShattering)
+{
+	std::stringstream input;
+	input << "= {}";
+	const auto empire = std::make_shared<CK2::Title>(input, "e_test");
+	const auto duchy = std::make_shared<CK2::Title>(input, "d_test");
+	const auto county = std::make_shared<CK2::Title>(input, "c_test");
+	const auto province = std::make_shared<CK2::Province>();
+	county->registerDeJureProvince(std::pair(1, province));
+	duchy->registerDeJureVassal(std::pair("c_test", county));
+	empire->registerDeJureVassal(std::pair("d_test", duchy));
+
+	ASSERT_EQ(1, empire->flagDeJureHREProvinces());
+	ASSERT_TRUE(province->isDeJureHRE());
+
+	const auto* deJureTree = &duchy->coalesceDeJureProvinces();
+	empire->registerVassal(std::pair("d_test", duchy));
+	empire->clearVassals();
+	ASSERT_EQ(deJureTree, &duchy->coalesceDeJureProvinces());
+	ASSERT_EQ(1, duchy->coalesceDeJureProvinces().size());
+
+	county->registerDeJureProvince(std::pair(2, std::make_shared<CK2::Province>()));
+	ASSERT_EQ(2, empire->coalesceDeJureProvinces().size());
+}
+
+TEST(CK2World_TitleTests, rankIsReadOffTheName)
+{
+	std::stringstream input;
+	input << "= {}";
+
+	ASSERT_EQ(CK2::Title::RANK::EMPIRE, CK2::Title(input, "e_hre").getRank());
+	ASSERT_EQ(CK2::Title::RANK::KINGDOM, CK2::Title::rankOf("k_france"));
+	ASSERT_EQ(CK2::Title::RANK::DUCHY, CK2::Title::rankOf("d_normandy"));
+	ASSERT_EQ(CK2::Title::RANK::COUNTY, CK2::Title::rankOf("c_paris"));
+	ASSERT_EQ(CK2::Title::RANK::BARONY, CK2::Title::rankOf("b_paris"));
+	ASSERT_EQ(CK2::Title::RANK::OTHER, CK2::Title::rankOf("The Pope"));
+	ASSERT_EQ(CK2::Title::RANK::OTHER, CK2::Title::rankOf("ek_weird"));
+	ASSERT_EQ(CK2::Title::RANK::OTHER, CK2::Title::rankOf(""));
+}
@@ -2,7 +2,6 @@
 #include "../../CK2ToEU4/Source/CK2World/Characters/Characters.h"
 #include "../../CK2ToEU4/Source/CK2World/Provinces/Province.h"
 #include "../../CK2ToEU4/Source/CK2World/Provinces/Provinces.h"
-#include "../../CK2ToEU4/Source/CK2World/Titles/Liege.h"
 #include "../../CK2ToEU4/Source/CK2World/Titles/Title.h"
 #include "../../CK2ToEU4/Source/CK2World/Titles/Titles.h"
 #include "gtest/gtest.h"
@@ -125,7 +124,7 @@ TEST(CK2World_TitlesTests, holderLinkCannotBeSetThrowsWarning)
 	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Holder ID: 34 has no definition!)"));
 }
 
-TEST(CK2World_TitlesTests, previousHolderLinksDefaultsToNull)
+TEST(CK2World_TitlesTests, previousHolderLinksDefaultToEmpty)
 {
 	std::stringstream input;
 	input << "=\n";
@@ -135,9 +134,9 @@ TEST(CK2World_TitlesTests, previousHolderLinksDefaultsToNull)
 
 	const CK2::Titles titles(input);
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& previousHolder = titleItr->second->getPreviousHolders().find(35);
 
-	ASSERT_FALSE(previousHolder->second);
+	ASSERT_EQ(2, titleItr->second->getPreviousHolderIDs().size());
+	ASSERT_TRUE(titleItr->second->getPreviousHolders().empty());
 }
 
 TEST(CK2World_TitlesTests, previousHolderLinksCanBeSet)
@@ -157,7 +156,8 @@ TEST(CK2World_TitlesTests, previousHolderLinksCanBeSet)
 	input2 << "}";
 	CK2::Characters characters(input2);
 
-	titles.linkPreviousHolders(characters);
+	const std::map<std::string, std::shared_ptr<CK2::Title>> all(titles.getTitles().begin(), titles.getTitles().end());
+	CK2::Titles::linkPreviousHolders(characters, all);
 	const auto& titleItr = titles.getTitles().find("c_title");
 	const auto& previousHolder = titleItr->second->getPreviousHolders().find(34);
 
@@ -165,115 +165,71 @@ TEST(CK2World_TitlesTests, previousHolderLinksCanBeSet)
 	ASSERT_EQ(previousHolder->second->getName(), "von Test");
 }
 
-TEST(CK2World_TitlesTests, liegePrimaryTitleLinkDefaultsToNull)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={liege=d_liege}\n";
-	input << "}";
-
-	const CK2::Titles titles(input);
-	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeTitle = titleItr->second->getLiege().second->getTitle();
-
-	ASSERT_FALSE(liegeTitle.second);
-}
-
-TEST(CK2World_TitlesTests, liegePrimaryTitleLinkCanBeSet)
+TEST(CK2World_TitlesTests, previousHoldersAreOnlyLinkedForTitlesAskedFor)
 {
 	std::stringstream input;
 	input << "=\n";
 	input << "{\n";
-	input << "c_title={liege=d_liege}\n";
-	input << "d_liege={}\n";
+	input << "c_title={previous={34}}\n";
+	input << "c_other={previous={35}}\n";
 	input << "}";
 	CK2::Titles titles(input);
 
-	titles.linkLiegePrimaryTitles();
-	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeTitle = titleItr->second->getLiege().second->getTitle();
-
-	ASSERT_TRUE(liegeTitle.second);
-	ASSERT_EQ(liegeTitle.second->getName(), "d_liege");
-}
-
-TEST(CK2World_TitlesTests, liegePrimaryTitleLinkCannotBeSetThrowsWarning)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={liege=d_liege}\n";
-	input << "d_liege2={}\n";
-	input << "}";
-	CK2::Titles titles(input);
-
-	std::stringstream log;
-	auto stdOutBuf = std::cout.rdbuf();
-	std::cout.rdbuf(log.rdbuf());
-
-	titles.linkLiegePrimaryTitles();
+	std::stringstream input2;
+	input2 << "=\n";
+	input2 << "{\n";
+	input2 << "34={bn=\"von Test\"}\n";
+	input2 << "35={bn=\"von Gangrene\"}\n";
+	input2 << "}";
+	CK2::Characters characters(input2);
 
-	std::cout.rdbuf(stdOutBuf);
-	auto stringLog = log.str();
+	const std::map<std::string, std::shared_ptr<CK2::Title>> converted = {*titles.getTitles().find("c_title")};
+	CK2::Titles::linkPreviousHolders(characters, converted);
 
-	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Primary liege title ID: d_liege has no definition!)"));
+	ASSERT_EQ(1, titles.getTitles().at("c_title")->getPreviousHolders().size());
+	ASSERT_TRUE(titles.getTitles().at("c_other")->getPreviousHolders().empty());
 }
 
-TEST(CK2World_TitlesTests, liegeBaseTitleLinkDefaultsToNull)
+TEST(CK2World_TitlesTests, liegePrimaryTitleLinkDefaultsToNull)
 {
 	std::stringstream input;
 	input << "=\n";
 	input << "{\n";
-	input << "c_title={\n";
-	input << "\tliege={\n";
-	input << "\t\ttitle=d_liege\n";
-	input << "\t\tbase_title=d_something\n";
-	input << "\t}}\n";
+	input << "c_title={liege=d_liege}\n";
 	input << "}";
 
 	const CK2::Titles titles(input);
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeBaseTitle = titleItr->second->getLiege().second->getBaseTitle();
+	const auto& liegeTitle = titleItr->second->getLiege();
 
-	ASSERT_FALSE(liegeBaseTitle.second);
+	ASSERT_FALSE(liegeTitle.second);
 }
 
-TEST(CK2World_TitlesTests, liegeBaseTitleLinkCanBeSet)
+TEST(CK2World_TitlesTests, liegePrimaryTitleLinkCanBeSet)
 {
 	std::stringstream input;
 	input << "=\n";
 	input << "{\n";
-	input << "c_title={\n";
-	input << "\tliege={\n";
-	input << "\t\ttitle=d_liege\n";
-	input << "\t\tbase_title=d_something\n";
-	input << "\t}}\n";
+	input << "c_title={liege=d_liege}\n";
 	input << "d_liege={}\n";
-	input << "d_something={}\n";
 	input << "}";
 	CK2::Titles titles(input);
 
 	titles.linkLiegePrimaryTitles();
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeBaseTitle = titleItr->second->getLiege().second->getBaseTitle();
+	const auto& liegeTitle = titleItr->second->getLiege();
 
-	ASSERT_TRUE(liegeBaseTitle.second);
-	ASSERT_EQ(liegeBaseTitle.second->getName(), "d_something");
+	ASSERT_TRUE(liegeTitle.second);
+	ASSERT_EQ(liegeTitle.second->getName(), "d_liege");
 }
 
-TEST(CK2World_TitlesTests, liegeBaseTitleLinkCannotBeSetThrowsWarning)
+TEST(CK2World_TitlesTests, liegePrimaryTitleLinkCannotBeSetThrowsWarning)
 {
 	std::stringstream input;
 	input << "=\n";
 	input << "{\n";
-	input << "c_title={\n";
-	input << "\tliege={\n";
-	input << "\t\ttitle=d_liege\n";
-	input << "\t\tbase_title=d_something\n";
-	input << "\t}}\n";
-	input << "d_liege={}\n";
-	input << "d_something2={}\n";
+	input << "c_title={liege=d_liege}\n";
+	input << "d_liege2={}\n";
 	input << "}";
 	CK2::Titles titles(input);
 
@@ -286,7 +242,7 @@ TEST(CK2World_TitlesTests, liegeBaseTitleLinkCannotBeSetThrowsWarning)
 	std::cout.rdbuf(stdOutBuf);
 	auto stringLog = log.str();
 
-	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Base liege title ID: d_something has no definition!)"));
+	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Primary liege title ID: d_liege has no definition!)"));
 }
 
 TEST(CK2World_TitlesTests, DJliegePrimaryTitleLinkDefaultsToNull)
@@ -299,7 +255,7 @@ TEST(CK2World_TitlesTests, DJliegePrimaryTitleLinkDefaultsToNull)
 
 	const CK2::Titles titles(input);
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& DJliegeTitle = titleItr->second->getDeJureLiege().second->getTitle();
+	const auto& DJliegeTitle = titleItr->second->getDeJureLiege();
 
 	ASSERT_FALSE(DJliegeTitle.second);
 }
@@ -316,7 +272,7 @@ TEST(CK2World_TitlesTests, DJliegePrimaryTitleLinkCanBeSet)
 
 	titles.linkLiegePrimaryTitles();
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& DJliegeTitle = titleItr->second->getDeJureLiege().second->getTitle();
+	const auto& DJliegeTitle = titleItr->second->getDeJureLiege();
 
 	ASSERT_TRUE(DJliegeTitle.second);
 	ASSERT_EQ(DJliegeTitle.second->getName(), "d_liege");
@@ -344,75 +300,6 @@ TEST(CK2World_TitlesTests, DJliegePrimaryTitleLinkCannotBeSetThrowsWarning)
 	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Primary DJ liege title ID: d_liege has no definition!)"));
 }
 
-TEST(CK2World_TitlesTests, DJliegeBaseTitleLinkDefaultsToNull)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={\n";
-	input << "\tde_jure_liege={\n";
-	input << "\t\ttitle=d_liege\n";
-	input << "\t\tbase_title=d_something\n";
-	input << "\t}}\n";
-	input << "}";
-
-	const CK2::Titles titles(input);
-	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& DJliegeBaseTitle = titleItr->second->getDeJureLiege().second->getBaseTitle();
-
-	ASSERT_FALSE(DJliegeBaseTitle.second);
-}
-
-TEST(CK2World_TitlesTests, DJliegeBaseTitleLinkCanBeSet)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={\n";
-	input << "\tde_jure_liege={\n";
-	input << "\t\ttitle=d_liege\n";
-	input << "\t\tbase_title=d_something\n";
-	input << "\t}}\n";
-	input << "d_liege={}\n";
-	input << "d_something={}\n";
-	input << "}";
-	CK2::Titles titles(input);
-
-	titles.linkLiegePrimaryTitles();
-	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& DJliegeBaseTitle = titleItr->second->getDeJureLiege().second->getBaseTitle();
-
-	ASSERT_TRUE(DJliegeBaseTitle.second);
-	ASSERT_EQ(DJliegeBaseTitle.second->getName(), "d_something");
-}
-
-TEST(CK2World_TitlesTests, DJliegeBaseTitleLinkCannotBeSetThrowsWarning)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={\n";
-	input << "\tde_jure_liege={\n";
-	input << "\t\ttitle=d_liege\n";
-	input << "\t\tbase_title=d_something\n";
-	input << "\t}}\n";
-	input << "d_liege={}\n";
-	input << "d_something2={}\n";
-	input << "}";
-	CK2::Titles titles(input);
-
-	std::stringstream log;
-	auto stdOutBuf = std::cout.rdbuf();
-	std::cout.rdbuf(log.rdbuf());
-
-	titles.linkLiegePrimaryTitles();
-
-	std::cout.rdbuf(stdOutBuf);
-	auto stringLog = log.str();
-
-	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Base DJ liege title ID: d_something has no definition!)"));
-}
-
 TEST(CK2World_TitlesTests, liegeVassalsDefaultToEmpty)
 {
 	std::stringstream input;
@@ -425,7 +312,7 @@ TEST(CK2World_TitlesTests, liegeVassalsDefaultToEmpty)
 	titles.linkLiegePrimaryTitles();
 
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeTitle = titleItr->second->getLiege().second->getTitle();
+	const auto& liegeTitle = titleItr->second->getLiege();
 
 	ASSERT_TRUE(liegeTitle.second->getVassals().empty());
 }
@@ -443,7 +330,7 @@ TEST(CK2World_TitlesTests, liegeVassalsCanBeSet)
 	titles.linkLiegePrimaryTitles();
 	titles.linkVassals();
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeTitle = titleItr->second->getLiege().second->getTitle();
+	const auto& liegeTitle = titleItr->second->getLiege();
 	const auto& linktoSelf = liegeTitle.second->getVassals().find("c_title");
 
 	ASSERT_FALSE(liegeTitle.second->getVassals().empty());
@@ -463,7 +350,7 @@ TEST(CK2World_TitlesTests, liegeDeJureVassalsDefaultToEmpty)
 	titles.linkLiegePrimaryTitles();
 
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeTitle = titleItr->second->getDeJureLiege().second->getTitle();
+	const auto& liegeTitle = titleItr->second->getDeJureLiege();
 
 	ASSERT_TRUE(liegeTitle.second->getDeJureVassals().empty());
 }
@@ -481,7 +368,7 @@ TEST(CK2World_TitlesTests, liegeDeJureVassalsCanBeSet)
 	titles.linkLiegePrimaryTitles();
 	titles.linkVassals();
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& liegeTitle = titleItr->second->getDeJureLiege().second->getTitle();
+	const auto& liegeTitle = titleItr->second->getDeJureLiege();
 	const auto& linktoSelf = liegeTitle.second->getDeJureVassals().find("c_title");
 
 	ASSERT_FALSE(liegeTitle.second->getDeJureVassals().empty());
@@ -501,7 +388,7 @@ TEST(CK2World_TitlesTests, baseTitleTitleLinkDefaultsToNull)
 
 	const CK2::Titles titles(input);
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& base = titleItr->second->getBaseTitle().second->getTitle();
+	const auto& base = titleItr->second->getBaseTitle();
 
 	ASSERT_FALSE(base.second);
 }
@@ -520,7 +407,7 @@ TEST(CK2World_TitlesTests, baseTitleTitleLinkCanBeSet)
 
 	titles.linkBaseTitles();
 	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& base = titleItr->second->getBaseTitle().second->getTitle();
+	const auto& base = titleItr->second->getBaseTitle();
 
 	ASSERT_TRUE(base.second);
 	ASSERT_EQ(base.second->getName(), "c_base");
@@ -550,47 +437,7 @@ TEST(CK2World_TitlesTests, baseTitleLinkCannotBeSetThrowsWarning)
 	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Base title title ID: c_base has no definition!)"));
 }
 
-TEST(CK2World_TitlesTests, baseTitleBaseTitleLinkDefaultsToNull)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={\n";
-	input << "\tbase_title=c_base\n";
-	input << "}\n";
-	input << "}";
-
-	const CK2::Titles titles(input);
-	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& base = titleItr->second->getBaseTitle().second->getBaseTitle();
-
-	ASSERT_FALSE(base.second);
-}
-
-TEST(CK2World_TitlesTests, baseTitleBaseTitleLinkCanBeSet)
-{
-	std::stringstream input;
-	input << "=\n";
-	input << "{\n";
-	input << "c_title={\n";
-	input << "\tbase_title={\n";
-	input << "\t\ttitle=c_something\n";
-	input << "\t\tbase_title=c_base\n";
-	input << "\t}\n";
-	input << "}\n";
-	input << "c_base={}\n";
-	input << "}";
-	CK2::Titles titles(input);
-
-	titles.linkBaseTitles();
-	const auto& titleItr = titles.getTitles().find("c_title");
-	const auto& base = titleItr->second->getBaseTitle().second->getBaseTitle();
-
-	ASSERT_TRUE(base.second);
-	ASSERT_EQ(base.second->getName(), "c_base");
-}
-
-TEST(CK2World_TitlesTests, baseTitleBaseTitleLinkCannotBeSetThrowsWarning)
+TEST(CK2World_TitlesTests, baseTitleBaseTitleNameOutlivesLinking)
 {
 	std::stringstream input;
 	input << "=\n";
@@ -605,16 +452,11 @@ TEST(CK2World_TitlesTests, baseTitleBaseTitleLinkCannotBeSetThrowsWarning)
 	input << "}";
 	CK2::Titles titles(input);
 
-	std::stringstream log;
-	auto stdOutBuf = std::cout.rdbuf();
-	std::cout.rdbuf(log.rdbuf());
-
 	titles.linkBaseTitles();
+	const auto& titleItr = titles.getTitles().find("c_title");
 
-	std::cout.rdbuf(stdOutBuf);
-	auto stringLog = log.str();
-
-	EXPECT_THAT(stringLog, testing::HasSubstr(R"([WARNING] Base title base title ID: c_base has no definition!)"));
+	ASSERT_EQ(titleItr->second->getBaseTitle().second->getName(), "c_something");
+	ASSERT_EQ(titleItr->second->getBaseTitleBase(), "c_base");
 }
 
 TEST(CK2World_TitlesTests, vassalsDefaultToEmpty)
@@ -823,3 +665,29 @@ TEST(CK2World_TitlesTests, revoltsCanBeMerged)
 	// revolt has been merged
 	ASSERT_EQ(title4->second->getVassals().size(), 3);
 }
+
+TEST(CK2World_TitlesTests, revoltsBasedOnRevoltsAreMergedIntoTheLastBase)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "c_test1={liege=d_revolt_a}\n";
+	input << "c_test2={liege=d_revolt_b}\n";
+	input << "d_revolt_a=\n{\nmajor_revolt=yes\nbase_title=d_test\n}\n";
+	input << "d_revolt_b=\n{\nmajor_revolt=yes\nbase_title=d_revolt_a\n}\n";
+	input << "d_test={}\n";
+	input << "}";
+	CK2::Titles theTitles(input);
+	theTitles.linkLiegePrimaryTitles();
+	theTitles.linkVassals();
+	theTitles.linkBaseTitles();
+	theTitles.mergeRevolts();
+
+	const auto& title2 = theTitles.getTitles().find("c_test2");
+	const auto& title5 = theTitles.getTitles().find("d_test");
+
+	ASSERT_EQ(title2->second->getLiege().first, "d_test");
+	ASSERT_EQ(title5->second->getVassals().size(), 2);
+	ASSERT_FALSE(theTitles.getTitles().contains("d_revolt_a"));
+	ASSERT_FALSE(theTitles.getTitles().contains("d_revolt_b"));
+}
@@ -0,0 +1,94 @@
+#include "../../CK2ToEU4/Source/CK2World/PhaseTimings.h"
+#include "../../CK2ToEU4/Source/CK2World/Trace.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+std::string readTrace()
+{
+	CK2::Trace::write("traceTest.json");
+	std::ifstream input("traceTest.json");
+	std::stringstream json;
+	json << input.rdbuf();
+	input.close();
+	std::filesystem::remove("traceTest.json");
+	return json.str();
+}
+} // namespace
+
+TEST(CK2World_TraceTests, spansAreDroppedWhileDisabled)
+{
+	CK2::Trace::reset();
+	{
+		const CK2::TraceSpan span("ignored");
+	}
+
+	EXPECT_EQ(std::string::npos, readTrace().find("ignored"));
+}
+
+TEST(CK2World_TraceTests, spansAreWrittenAsCompleteEvents)
+{
+	CK2::Trace::reset();
+	CK2::Trace::enable();
+	{
+		const CK2::TraceSpan outer("Parsing \"characters\"");
+		CK2::traced("inner", [] {
+		});
+	}
+	const auto text = readTrace();
+	CK2::Trace::reset();
+
+	EXPECT_EQ(0, text.find("{\"traceEvents\": ["));
+	EXPECT_NE(std::string::npos, text.find("{\"name\": \"Parsing \\\"characters\\\"\", \"ph\": \"X\""));
+	EXPECT_NE(std::string::npos, text.find("{\"name\": \"inner\", \"ph\": \"X\""));
+}
+
+TEST(CK2World_TraceTests, threadsGetTracksOfTheirOwn)
+{
+	CK2::Trace::reset();
+	CK2::Trace::enable();
+	{
+		const CK2::TraceSpan span("main");
+	}
+	std::thread([] {
+		const CK2::TraceSpan span("worker");
+	}).join();
+	const auto text = readTrace();
+	CK2::Trace::reset();
+
+	const auto tidOf = [&text](const std::string& name) {
+		const auto event = text.find("\"name\": \"" + name + "\"");
+		const auto tid = text.find("\"tid\": ", event) + 7;
+		return text.substr(tid, text.find(',', tid) - tid);
+	};
+	EXPECT_NE(tidOf("main"), tidOf("worker"));
+}
+
+TEST(CK2World_TraceTests, phasesShowUpAsSpans)
+{
+	CK2::Trace::reset();
+	CK2::Trace::enable();
+	CK2::PhaseTimings timings;
+	timings.begin("Linking");
+	timings.finish();
+	const auto text = readTrace();
+	CK2::Trace::reset();
+
+	EXPECT_NE(std::string::npos, text.find("\"name\": \"Linking\""));
+}
+
+TEST(CK2World_TraceTests, countersAreWrittenAsCounterEvents)
+{
+	CK2::Trace::reset();
+	CK2::Trace::enable();
+	CK2::Trace::count("parallel efficiency %", CK2::Trace::Clock::now(), 75);
+	const auto text = readTrace();
+	CK2::Trace::reset();
+
+	EXPECT_NE(std::string::npos, text.find("{\"name\": \"parallel efficiency %\", \"ph\": \"C\""));
+	EXPECT_NE(std::string::npos, text.find("\"args\": {\"value\": 75}"));
+}
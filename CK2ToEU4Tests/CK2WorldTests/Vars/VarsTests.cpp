@@ -67,3 +67,33 @@ TEST(CK2World_VarsTests, chineseReligionsReturnsChineseReligions)
 	ASSERT_NEAR(christian->second, 20, 0.001);
 	ASSERT_NEAR(sunni->second, 40, 0.001);
 }
+
+TEST(CK2World_VarsTests, onlyQueriedVarsAreKept)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "a_variaBLE1 = 8.900\n";
+	input << "global_chinese_sunnis = 40.000\n";
+	input << "}";
+
+	const CK2::Vars vars(input, CK2::Vars::queriedVars());
+
+	ASSERT_EQ(1, vars.getVars().size());
+	ASSERT_NEAR(vars.getChineseReligions()->at("sunni"), 40, 0.001);
+}
+
+TEST(CK2World_VarsTests, oddlyNamedVarsAreSkipped)
+{
+	std::stringstream input;
+	input << "=\n";
+	input << "{\n";
+	input << "\"quoted name\" = 8.900\n";
+	input << "plain = 1.000\n";
+	input << "}";
+
+	const CK2::Vars vars(input);
+
+	ASSERT_EQ(1, vars.getVars().size());
+	ASSERT_TRUE(vars.getVars().contains("plain"));
+}
@@ -165,3 +165,35 @@ TEST(CK2World_WonderTests, TransferrableCanBeSetForStageThreeAndActive)
 
 	ASSERT_TRUE(wonder.isTransferrable());
 }
+
+TEST(CK2World_WonderTests, deferredWonderReadsEntryUpFront)
+{
+	const auto source = std::make_shared<const std::string>(
+		 "=\n{\n\ttype=wonder_cathedral\n\tname=\"Numero Uno\"\n\tprovince=23\n\tconstruction_history={ { wonder_historical_event_character=7 } }\n\tstage=3\n\tactive=yes\n}");
+
+	const CK2::Wonder wonder(*source, source);
+
+	ASSERT_EQ("wonder_cathedral", wonder.getType());
+	ASSERT_EQ("Numero Uno", wonder.getName());
+	ASSERT_EQ(23, wonder.getProvinceID());
+	ASSERT_TRUE(wonder.isTransferrable());
+}
+
+TEST(CK2World_WonderTests, deferredWonderDecodesHistoryOnDemand)
+{
+	const std::string entry = "=\n{\n\ttype=wonder_cathedral\n\tconstruction_history=\n\t{\n\t\t{ wonder_historical_event_character=7 "
+									  "wonder_historical_event_date=300 wonder_upgrade=upgrade_tapestries }\n\t\t{ wonder_historical_event_date=200 "
+									  "wonder_upgrade=upgrade_bell_tower }\n\t}\n\tstage=-1\n}";
+	const auto source = std::make_shared<const std::string>(entry);
+	std::stringstream input(entry);
+
+	CK2::Wonder deferred(*source, source);
+	const CK2::Wonder eager(input);
+
+	ASSERT_EQ(7, deferred.getBuilder());
+	ASSERT_EQ(200, deferred.getBinaryDate());
+	ASSERT_EQ(eager.getUpgrades(), deferred.getUpgrades());
+	ASSERT_EQ(std::vector<std::string>({"wonder_cathedral", "upgrade_tapestries", "upgrade_bell_tower", "generic_misc_upgrade_3"}), deferred.getUpgrades());
+	deferred.addUpgrade("upgrade_padding");
+	ASSERT_EQ("upgrade_padding", deferred.getUpgrades().back());
+}
@@ -32,3 +32,16 @@ TEST(CK2World_WondersTests, WondersCanBeLoaded)
 	ASSERT_EQ(wonder->first, 42);
 	ASSERT_EQ(wonder2->first, 43);
 }
+
+TEST(CK2World_WondersTests, WondersCanBeLoadedFromRawBlock)
+{
+	const std::string block = "=\n{\n42={ type=wonder_cathedral province=23 }\n43={}\n}";
+
+	const CK2::Wonders wonders(block);
+
+	ASSERT_EQ(wonders.getWonders().size(), 2);
+	ASSERT_EQ(wonders.getWonders().at(42)->getWonderID(), 42);
+	ASSERT_EQ(wonders.getWonders().at(42)->getProvinceID(), 23);
+	ASSERT_EQ(wonders.getWonders().at(42)->getUpgrades(), std::vector<std::string>{"wonder_cathedral"});
+	ASSERT_EQ(wonders.getWonders().at(43)->getWonderID(), 43);
+}
@@ -143,3 +143,358 @@ TEST(CK2ToEU4_ConfigurationTests, ModFileNamesCanBeLoaded)
 	EXPECT_THAT(testConfiguration.getMods(),
 		 UnorderedElementsAre(Mod("", "modfilename1.mod"), Mod("", "oddlyshaped.mod.mod.mod.mod"), Mod("", "mod with spaces.mod")));
 }
+
+TEST(CK2ToEU4_ConfigurationTests, SnapshotDefaultsToEnabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getSnapshot(), Configuration::SNAPSHOT::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, SnapshotCanBeDisabled)
+{
+	std::stringstream input;
+	input << "snapshot = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getSnapshot(), Configuration::SNAPSHOT::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, SnapshotCanFollowACampaign)
+{
+	std::stringstream input;
+	input << "snapshot = \"3\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getSnapshot(), Configuration::SNAPSHOT::CAMPAIGN);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ArchiveDefaultsToFolder)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getArchive(), Configuration::ARCHIVE::FOLDER);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ArchiveCanBeSetToZip)
+{
+	std::stringstream input;
+	input << "archive = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getArchive(), Configuration::ARCHIVE::ZIP);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, IncrementalOutputDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getIncremental(), Configuration::INCREMENTAL::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, IncrementalOutputCanBeEnabled)
+{
+	std::stringstream input;
+	input << "incremental = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getIncremental(), Configuration::INCREMENTAL::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, StagingDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getStaging(), Configuration::STAGING::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, StagingCanBeEnabled)
+{
+	std::stringstream input;
+	input << "staging = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getStaging(), Configuration::STAGING::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, WithOutputNameKeepsEverythingElse)
+{
+	std::stringstream input;
+	input << "archive = \"2\" staging = \"2\"";
+	const Configuration testConfiguration(input);
+	const auto staged = testConfiguration.withOutputName("autosave.staging");
+
+	EXPECT_EQ(staged.getOutputName(), "autosave.staging");
+	EXPECT_EQ(staged.getArchive(), Configuration::ARCHIVE::ZIP);
+	EXPECT_EQ(staged.getStaging(), Configuration::STAGING::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, TimingsDefaultToLog)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getTimings(), Configuration::TIMINGS::LOG);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, TimingsCanBeWrittenAsJSON)
+{
+	std::stringstream input;
+	input << "timings = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getTimings(), Configuration::TIMINGS::JSON);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, HardwareCountersDefaultToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getHardwareCounters(), Configuration::HARDWARE_COUNTERS::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, HardwareCountersCanBeEnabled)
+{
+	std::stringstream input;
+	input << "hardware_counters = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getHardwareCounters(), Configuration::HARDWARE_COUNTERS::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, MemoryCensusDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getMemoryCensus(), Configuration::MEMORY_CENSUS::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, MemoryCensusCanBeEnabled)
+{
+	std::stringstream input;
+	input << "memory_census = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getMemoryCensus(), Configuration::MEMORY_CENSUS::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ContentionDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getContention(), Configuration::CONTENTION::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ContentionCanBeEnabled)
+{
+	std::stringstream input;
+	input << "contention = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getContention(), Configuration::CONTENTION::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, TraceDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getTrace(), Configuration::TRACE::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, TraceCanBeEnabled)
+{
+	std::stringstream input;
+	input << "trace = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getTrace(), Configuration::TRACE::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, LookupTraceDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getLookupTrace(), Configuration::LOOKUP_TRACE::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, LookupTraceCanBeEnabled)
+{
+	std::stringstream input;
+	input << "lookup_trace = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getLookupTrace(), Configuration::LOOKUP_TRACE::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ThreadsAndTaskOrderSeedDefaultToParallelInLaunchOrder)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getThreads(), 0);
+	EXPECT_EQ(testConfiguration.getTaskOrderSeed(), 0);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ThreadsAndTaskOrderSeedCanBeSet)
+{
+	std::stringstream input;
+	input << "threads = \"1\"\n";
+	input << "task_order_seed = \"1066\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getThreads(), 1);
+	EXPECT_EQ(testConfiguration.getTaskOrderSeed(), 1066);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, CacheLimitDefaultsToUnboundedAndLocal)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getCacheLimitMB(), 0);
+	EXPECT_TRUE(testConfiguration.getRemoteCache().empty());
+	EXPECT_TRUE(testConfiguration.getRemoteCacheKey().empty());
+}
+
+TEST(CK2ToEU4_ConfigurationTests, CacheLimitAndRemoteCacheCanBeSet)
+{
+	std::stringstream input;
+	input << "cache_limit = \"4096\"\n";
+	input << "remote_cache = \"http://cache.farm:8080/ck2toeu4\"\n";
+	input << "remote_cache_key = \"the farm's own key\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getCacheLimitMB(), 4096);
+	EXPECT_EQ(testConfiguration.getRemoteCache(), "http://cache.farm:8080/ck2toeu4");
+	EXPECT_EQ(testConfiguration.getRemoteCacheKey(), "the farm's own key");
+}
+
+TEST(CK2ToEU4_ConfigurationTests, CharacterDecodingDefaultsToAuto)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getCharacterDecoding(), Configuration::CHARACTER_DECODING::AUTO);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, TuningFillsInThreadsAndCharacterDecoding)
+{
+	std::stringstream input;
+	input << "character_decoding = \"3\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getCharacterDecoding(), Configuration::CHARACTER_DECODING::EAGER);
+	const auto tuned = testConfiguration.withTuning(4, Configuration::CHARACTER_DECODING::LAZY);
+	EXPECT_EQ(tuned.getThreads(), 4);
+	EXPECT_EQ(tuned.getCharacterDecoding(), Configuration::CHARACTER_DECODING::LAZY);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ReuseWorldDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getReuseWorld(), Configuration::REUSE_WORLD::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ReuseWorldCanBeEnabled)
+{
+	std::stringstream input;
+	input << "reuse_ck2_world = \"2\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getReuseWorld(), Configuration::REUSE_WORLD::ENABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, CheckpointDefaultsToDisabled)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getCheckpoint(), Configuration::CHECKPOINT::DISABLED);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, CheckpointCanBeResumedFrom)
+{
+	std::stringstream input;
+	input << "ck2_checkpoint = \"3\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getCheckpoint(), Configuration::CHECKPOINT::RESUME);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, PhaseWindowDefaultsToTheWholeConversion)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_TRUE(testConfiguration.getProfileFrom().empty());
+	EXPECT_TRUE(testConfiguration.getStopAfter().empty());
+}
+
+TEST(CK2ToEU4_ConfigurationTests, PhaseWindowCanBeSet)
+{
+	std::stringstream input;
+	input << "profile_from = \"Linking Titles With Provinces\"\n";
+	input << "stop_after = \"Importing Provinces\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getProfileFrom(), "Linking Titles With Provinces");
+	EXPECT_EQ(testConfiguration.getStopAfter(), "Importing Provinces");
+}
+
+TEST(CK2ToEU4_ConfigurationTests, WithPhaseWindowKeepsEverythingElse)
+{
+	std::stringstream input;
+	input << "threads = \"2\"";
+	const Configuration testConfiguration(input);
+
+	const auto windowed = testConfiguration.withPhaseWindow("", "Fixing Tengri");
+
+	EXPECT_EQ(windowed.getThreads(), 2);
+	EXPECT_TRUE(windowed.getProfileFrom().empty());
+	EXPECT_EQ(windowed.getStopAfter(), "Fixing Tengri");
+}
+
+TEST(CK2ToEU4_ConfigurationTests, OutputSinkDefaultsToDisk)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getOutputSink(), Configuration::OUTPUT_SINK::DISK);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, OutputSinkCanBeSetToHash)
+{
+	std::stringstream input;
+	input << "output_sink = \"3\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getOutputSink(), Configuration::OUTPUT_SINK::HASH);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ValidationDefaultsToSummary)
+{
+	std::stringstream input("");
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getValidation(), Configuration::VALIDATION::SUMMARY);
+}
+
+TEST(CK2ToEU4_ConfigurationTests, ValidationCanBeSet)
+{
+	std::stringstream input;
+	input << "validation = \"3\"";
+	const Configuration testConfiguration(input);
+
+	EXPECT_EQ(testConfiguration.getValidation(), Configuration::VALIDATION::FULL);
+}
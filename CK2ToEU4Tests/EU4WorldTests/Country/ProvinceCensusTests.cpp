@@ -0,0 +1,47 @@
+#include "../../CK2ToEU4/Source/EU4World/Country/Country.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/EU4Province.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+namespace
+{
+std::shared_ptr<EU4::Province> makeProvince(const std::string& religion, const int adm)
+{
+	auto province = std::make_shared<EU4::Province>();
+	province->setReligion(religion);
+	province->setAdm(adm);
+	return province;
+}
+} // namespace
+
+TEST(EU4World_ProvinceCensusTests, registeredProvincesAreTallied)
+{
+	const std::vector provinces{makeProvince("sunni", 3), makeProvince("sunni", 4), makeProvince("shiite", 10), makeProvince("", 1)};
+	EU4::Country country;
+	for (auto provinceID = 1; const auto& province: provinces)
+		country.registerProvince({provinceID++, province.get()});
+
+	const auto& religions = country.getCensus().getReligions();
+	ASSERT_EQ(2, religions.size());
+	ASSERT_EQ((EU4::ProvinceCensus::Share{2, 7}), religions.at("sunni"));
+	ASSERT_EQ((EU4::ProvinceCensus::Share{1, 10}), religions.at("shiite"));
+	ASSERT_EQ(4, country.getCensus().getBlanks()); // none of them has a culture
+	ASSERT_EQ("sunni", EU4::ProvinceCensus::mostProvinces(religions));
+	ASSERT_EQ("shiite", EU4::ProvinceCensus::mostDevelopment(religions));
+}
+
+TEST(EU4World_ProvinceCensusTests, changesToOwnedProvincesAreFollowed)
+{
+	const auto province = makeProvince("sunni", 3);
+	const auto otherProvince = makeProvince("sunni", 4);
+	EU4::Country country;
+	country.registerProvince({1, province.get()});
+	country.registerProvince({2, otherProvince.get()});
+
+	province->setAdm(5);
+	province->setReligion("tengri_pagan");
+
+	const auto& religions = country.getCensus().getReligions();
+	ASSERT_EQ((EU4::ProvinceCensus::Share{1, 4}), religions.at("sunni"));
+	ASSERT_EQ((EU4::ProvinceCensus::Share{1, 5}), religions.at("tengri_pagan"));
+}
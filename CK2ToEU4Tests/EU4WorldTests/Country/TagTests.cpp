@@ -0,0 +1,49 @@
+#include "../../CK2ToEU4/Source/EU4World/Country/Tag.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <sstream>
+
+TEST(EU4World_TagTests, defaultTagIsEmpty)
+{
+	const EU4::Tag tag;
+
+	ASSERT_TRUE(tag.empty());
+	ASSERT_EQ("", tag.str());
+	ASSERT_EQ(EU4::Tag(""), tag);
+}
+
+TEST(EU4World_TagTests, tagsRoundTripTheirSpelling)
+{
+	const EU4::Tag tag("FRA");
+
+	ASSERT_EQ("FRA", tag.str());
+	ASSERT_EQ(tag, "FRA");
+	ASSERT_EQ(tag, std::string("FRA"));
+	ASSERT_NE(tag, "FR");
+	ASSERT_NE(tag, "FRAN");
+	ASSERT_NE(tag, "FRANCE");
+	const std::string spelling = tag;
+	ASSERT_EQ("FRA", spelling);
+
+	std::stringstream output;
+	output << tag << EU4::Tag("Z01");
+	ASSERT_EQ("FRAZ01", output.str());
+}
+
+TEST(EU4World_TagTests, tagsOrderLikeTheirSpelling)
+{
+	const std::set<EU4::Tag> tags = {EU4::Tag("ZZZ"), EU4::Tag("A"), EU4::Tag("FRA"), EU4::Tag("AB"), EU4::Tag("ENG")};
+
+	std::vector<std::string> spellings;
+	for (const auto& tag: tags)
+		spellings.emplace_back(tag.str());
+
+	ASSERT_EQ((std::vector<std::string>{"A", "AB", "ENG", "FRA", "ZZZ"}), spellings);
+}
+
+TEST(EU4World_TagTests, overlongTagsAreRejected)
+{
+	ASSERT_TRUE(EU4::Tag::fits("ABCD"));
+	ASSERT_FALSE(EU4::Tag::fits("ABCDE"));
+	ASSERT_THROW(EU4::Tag("ABCDE"), std::invalid_argument);
+}
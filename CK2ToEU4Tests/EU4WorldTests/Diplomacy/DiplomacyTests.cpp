@@ -0,0 +1,66 @@
+#include "../../CK2ToEU4/Source/EU4World/Diplomacy/Diplomacy.h"
+#include "gtest/gtest.h"
+
+TEST(EU4World_DiplomacyTests, agreementTypesAreSortedIntoKinds)
+{
+	ASSERT_EQ(EU4::Agreement::KIND::VASSAL, EU4::Agreement("FRA", "BUR", "vassal", date(1444, 11, 11)).getKind());
+	ASSERT_EQ(EU4::Agreement::KIND::UNION, EU4::Agreement("FRA", "BUR", "union", date(1444, 11, 11)).getKind());
+	ASSERT_EQ(EU4::Agreement::KIND::DEPENDENCY, EU4::Agreement("FRA", "BUR", "dependency", "tributary_state", date(1444, 11, 11)).getKind());
+	ASSERT_EQ(EU4::Agreement::KIND::OTHER, EU4::Agreement("FRA", "BUR", "royal_marriage", date(1444, 11, 11)).getKind());
+}
+
+TEST(EU4World_DiplomacyTests, subjectsAreFoundOnTheSecondTagOnly)
+{
+	EU4::Diplomacy diplomacy;
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("FRA", "BUR", "vassal", date(1444, 11, 11)));
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("CAS", "ARA", "union", date(1444, 11, 11)));
+
+	ASSERT_TRUE(diplomacy.isCountryVassal("BUR"));
+	ASSERT_FALSE(diplomacy.isCountryVassal("FRA"));
+	ASSERT_FALSE(diplomacy.isCountryJunior("BUR"));
+	ASSERT_TRUE(diplomacy.isCountryJunior("ARA"));
+	ASSERT_FALSE(diplomacy.isCountryJunior("CAS"));
+	ASSERT_FALSE(diplomacy.isCountryVassal("ENG"));
+}
+
+TEST(EU4World_DiplomacyTests, renamedTagsCarryTheirAgreements)
+{
+	EU4::Diplomacy diplomacy;
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("MNG", "KOR", "vassal", date(1444, 11, 11)));
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("Z01", "MNG", "union", date(1444, 11, 11)));
+
+	diplomacy.updateTagsInAgreements("MNG", "Z01");
+
+	ASSERT_TRUE(diplomacy.isCountryVassal("KOR"));
+	ASSERT_TRUE(diplomacy.isCountryJunior("Z01"));
+	ASSERT_FALSE(diplomacy.isCountryJunior("MNG"));
+	ASSERT_EQ("Z01", diplomacy.getAgreements()[0]->getFirst());
+	ASSERT_EQ("Z01", diplomacy.getAgreements()[1]->getSecond());
+}
+
+TEST(EU4World_DiplomacyTests, deletedTagsTakeOnlyTheirAgreements)
+{
+	EU4::Diplomacy diplomacy;
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("FRA", "BUR", "vassal", date(1444, 11, 11)));
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("BUR", "FLA", "vassal", date(1444, 11, 11)));
+	diplomacy.addAgreement(std::make_shared<EU4::Agreement>("CAS", "ARA", "union", date(1444, 11, 11)));
+
+	diplomacy.deleteAgreementsWithTag("BUR");
+
+	ASSERT_EQ(1, diplomacy.getAgreements().size());
+	ASSERT_FALSE(diplomacy.isCountryVassal("BUR"));
+	ASSERT_FALSE(diplomacy.isCountryVassal("FLA"));
+	ASSERT_TRUE(diplomacy.isCountryJunior("ARA"));
+}
+
+TEST(EU4World_DiplomacyTests, easternTributariesAreCopiedIn)
+{
+	const std::vector<EU4::Agreement> easternTributaries{EU4::Agreement("MNG", "KOR", "dependency", "tributary_state", date(1444, 11, 11))};
+	EU4::Diplomacy diplomacy(easternTributaries);
+
+	diplomacy.updateTagsInAgreements("MNG", "Z01");
+
+	ASSERT_EQ(1, diplomacy.getAgreements().size());
+	ASSERT_EQ("Z01", diplomacy.getAgreements()[0]->getFirst());
+	ASSERT_EQ("MNG", easternTributaries[0].getFirst());
+}
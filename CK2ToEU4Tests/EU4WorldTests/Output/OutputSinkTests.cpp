@@ -0,0 +1,51 @@
+#include "../../CK2ToEU4/Source/EU4World/Output/OutputSink.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+TEST(EU4World_OutputSinkTests, diskSinkWritesEachFile)
+{
+	EU4::OutputSink sink;
+	sink.write("outputSinkTest.txt", "REB = \"countries/Rebels.txt\"\n");
+
+	std::ifstream input("outputSinkTest.txt");
+	std::stringstream contents;
+	contents << input.rdbuf();
+	input.close();
+	std::filesystem::remove("outputSinkTest.txt");
+
+	EXPECT_EQ("REB = \"countries/Rebels.txt\"\n", contents.str());
+	EXPECT_EQ(1, sink.getFiles());
+	EXPECT_EQ(29, sink.getBytes());
+}
+
+TEST(EU4World_OutputSinkTests, countingSinkTouchesNoFile)
+{
+	EU4::OutputSink sink(Configuration::OUTPUT_SINK::COUNT);
+	sink.write("outputSinkTest/missing/folder.txt", "12");
+	sink.write("outputSinkTest/missing/other.txt", "345");
+
+	EXPECT_FALSE(std::filesystem::exists("outputSinkTest"));
+	EXPECT_FALSE(sink.toDisk());
+	EXPECT_EQ(2, sink.getFiles());
+	EXPECT_EQ(5, sink.getBytes());
+	EXPECT_TRUE(sink.getDigest().empty());
+}
+
+TEST(EU4World_OutputSinkTests, hashingDigestDoesNotDependOnWriteOrder)
+{
+	EU4::OutputSink sink(Configuration::OUTPUT_SINK::HASH);
+	sink.write("a.txt", "owner = FRA");
+	sink.write("b.txt", "owner = ENG");
+	EU4::OutputSink reversed(Configuration::OUTPUT_SINK::HASH);
+	reversed.write("b.txt", "owner = ENG");
+	reversed.write("a.txt", "owner = FRA");
+	EU4::OutputSink changed(Configuration::OUTPUT_SINK::HASH);
+	changed.write("a.txt", "owner = FRA");
+	changed.write("b.txt", "owner = SCO");
+
+	EXPECT_FALSE(sink.getDigest().empty());
+	EXPECT_EQ(sink.getDigest(), reversed.getDigest());
+	EXPECT_NE(sink.getDigest(), changed.getDigest());
+}
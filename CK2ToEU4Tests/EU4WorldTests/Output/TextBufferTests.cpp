@@ -0,0 +1,39 @@
+#include "../../CK2ToEU4/Source/EU4World/Country/Tag.h"
+#include "../../CK2ToEU4/Source/EU4World/Output/TextBuffer.h"
+#include "Date.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(EU4World_TextBufferTests, numbersPrintAsADefaultStreamPrintsThem)
+{
+	for (const auto number: {0.0, 0.5, -2.25, 0.1, 1.0 / 3.0, 100.0, 123456.0, 1234567.0, 0.0001, 0.00001, -1e20})
+	{
+		EU4::TextBuffer buffer;
+		buffer << number;
+		std::ostringstream stream;
+		stream << number;
+		ASSERT_EQ(stream.str(), buffer.str());
+	}
+	for (const auto number: {0, 7, -15, 2147483647})
+	{
+		EU4::TextBuffer buffer;
+		buffer << number;
+		ASSERT_EQ(std::to_string(number), buffer.str());
+	}
+}
+
+TEST(EU4World_TextBufferTests, fragmentsAppendInOrder)
+{
+	EU4::TextBuffer buffer;
+	const std::string name = "Kurland";
+	buffer << "owner = " << EU4::Tag("KUR") << '\n' << name << " = " << 3 << "\n" << date("1444.11.11") << "= {\n";
+
+	ASSERT_EQ("owner = KUR\nKurland = 3\n1444.11.11= {\n", buffer.str());
+}
+
+TEST(EU4World_TextBufferTests, threadBufferComesBackEmpty)
+{
+	EU4::TextBuffer::forThisThread() << "leftovers";
+
+	ASSERT_TRUE(EU4::TextBuffer::forThisThread().str().empty());
+}
@@ -0,0 +1,57 @@
+#include "../../CK2ToEU4/Source/EU4World/Country/Tag.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/EU4Province.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/ProvinceOwners.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/ProvinceTable.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+EU4::ProvinceTable ownedProvinces()
+{
+	EU4::ProvinceTable provinces;
+	for (const auto ID: {1, 2, 3, 4})
+		provinces.insert({ID, std::make_shared<EU4::Province>(ID, "history/provinces/none.txt")});
+	provinces.find(1)->second->setOwner("KHA");
+	provinces.find(2)->second->setOwner("KHA");
+	provinces.find(3)->second->setOwner("MGE");
+	return provinces;
+}
+} // namespace
+
+TEST(EU4World_ProvinceOwnersTests, rebuildIndexesOwnersSetBeforehand)
+{
+	const auto provinces = ownedProvinces();
+	EU4::ProvinceOwners owners;
+	owners.rebuild(provinces);
+
+	ASSERT_EQ(std::set<int>({1, 2}), owners.provincesOf("KHA"));
+	ASSERT_EQ(std::set<int>({3}), owners.provincesOf("MGE"));
+	ASSERT_TRUE(owners.provincesOf("").empty());
+	ASSERT_TRUE(owners.provincesOf("MNG").empty());
+}
+
+TEST(EU4World_ProvinceOwnersTests, ownerChangesAreFollowed)
+{
+	const auto provinces = ownedProvinces();
+	EU4::ProvinceOwners owners;
+	owners.rebuild(provinces);
+
+	provinces.find(1)->second->setOwner("MGE");
+	provinces.find(4)->second->transferTo("MGE", EU4::Tag("MGE"), false);
+	provinces.find(3)->second->sterilize();
+
+	ASSERT_EQ(std::set<int>({2}), owners.provincesOf("KHA"));
+	ASSERT_EQ(std::set<int>({1, 4}), owners.provincesOf("MGE"));
+}
+
+TEST(EU4World_ProvinceOwnersTests, lastProvinceLeavingEmptiesTheOwner)
+{
+	const auto provinces = ownedProvinces();
+	EU4::ProvinceOwners owners;
+	owners.rebuild(provinces);
+
+	provinces.find(3)->second->setOwner("KHA");
+
+	ASSERT_EQ(std::set<int>({1, 2, 3}), owners.provincesOf("KHA"));
+	ASSERT_TRUE(owners.provincesOf("MGE").empty());
+}
@@ -0,0 +1,64 @@
+#include "../../CK2ToEU4/Source/EU4World/Province/EU4Province.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/ProvinceTable.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+EU4::ProvinceTable::value_type entry(const int ID)
+{
+	return {ID, std::make_shared<EU4::Province>()};
+}
+} // namespace
+
+TEST(EU4World_ProvinceTableTests, emptyTableFindsNothing)
+{
+	const EU4::ProvinceTable table;
+
+	ASSERT_TRUE(table.empty());
+	ASSERT_EQ(table.end(), table.find(1));
+	ASSERT_EQ(0, table.count(70000));
+}
+
+TEST(EU4World_ProvinceTableTests, provincesIterateInIDOrderWhateverTheInsertionOrder)
+{
+	EU4::ProvinceTable table;
+	for (const auto ID: {100, 1, 10, 2, 1000})
+		ASSERT_TRUE(table.insert(entry(ID)));
+	ASSERT_FALSE(table.insert(entry(10)));
+
+	std::vector<int> IDs;
+	for (const auto& province: table)
+		IDs.emplace_back(province.first);
+
+	ASSERT_EQ((std::vector{1, 2, 10, 100, 1000}), IDs);
+	ASSERT_EQ(10, table.find(10)->first);
+	ASSERT_EQ(1000, table.find(1000)->first);
+	ASSERT_EQ(table.end(), table.find(11));
+}
+
+TEST(EU4World_ProvinceTableTests, insertOrAssignReplacesExistingProvinces)
+{
+	EU4::ProvinceTable table;
+	table.insert(entry(5));
+	const auto replacement = std::make_shared<EU4::Province>();
+
+	table.insert_or_assign(5, replacement);
+	table.insert_or_assign(3, nullptr);
+
+	ASSERT_EQ(2, table.size());
+	ASSERT_EQ(replacement, table.find(5)->second);
+	ASSERT_EQ(1, table.count(3));
+}
+
+TEST(EU4World_ProvinceTableTests, outlyingIDsAreStillFound)
+{
+	EU4::ProvinceTable table;
+	table.insert(entry(2000000));
+	table.insert(entry(-3));
+	table.insert(entry(7));
+
+	ASSERT_EQ(2000000, table.find(2000000)->first);
+	ASSERT_EQ(-3, table.find(-3)->first);
+	ASSERT_EQ(7, table.find(7)->first);
+	ASSERT_EQ(table.end(), table.find(1999999));
+}
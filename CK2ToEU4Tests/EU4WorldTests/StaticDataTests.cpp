@@ -0,0 +1,87 @@
+#include "../../CK2ToEU4/Source/EU4World/StaticData.h"
+#include "../../CK2ToEU4/Source/EU4World/VanillaCache.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace
+{
+std::shared_ptr<const EU4::VanillaImage> imageOf(const std::string& specialTag)
+{
+	auto image = std::make_shared<EU4::VanillaImage>();
+	image->specialCountryTags.emplace(specialTag);
+	return image;
+}
+} // namespace
+
+TEST(EU4World_StaticDataTests, sharedDataIsLoadedOncePerKey)
+{
+	EU4::StaticData staticData(true);
+	std::atomic<int> loads = 0;
+	const auto load = [&loads] {
+		++loads;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		return imageOf("TST");
+	};
+
+	std::vector<std::shared_ptr<const EU4::VanillaImage>> images(4);
+	std::vector<std::thread> conversions;
+	for (auto& image: images)
+		conversions.emplace_back([&staticData, &load, &image] {
+			image = staticData.vanillaImage("countries", load);
+		});
+	for (auto& conversion: conversions)
+		conversion.join();
+	const auto other = staticData.vanillaImage("provinces", load);
+
+	EXPECT_EQ(2, loads);
+	for (const auto& image: images)
+		EXPECT_EQ(images.front(), image);
+	EXPECT_EQ(std::set<std::string>{"TST"}, other->specialCountryTags);
+	EXPECT_NE(images.front(), other);
+}
+
+TEST(EU4World_StaticDataTests, aFailedLoadFailsEveryoneWaitingForIt)
+{
+	EU4::StaticData staticData(true);
+	std::promise<void> waiting;
+	const auto load = [&waiting]() -> std::shared_ptr<const EU4::VanillaImage> {
+		waiting.get_future().wait();
+		throw std::runtime_error("No install");
+	};
+
+	std::thread first([&staticData, &load] {
+		EXPECT_THROW(auto image = staticData.vanillaImage("countries", load), std::runtime_error);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	std::thread second([&staticData] {
+		EXPECT_THROW(auto image = staticData.vanillaImage("countries", [] {
+			return imageOf("TST");
+		}),
+			 std::runtime_error);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	waiting.set_value();
+	first.join();
+	second.join();
+}
+
+TEST(EU4World_StaticDataTests, aFailedLoadIsTriedAgainLater)
+{
+	EU4::StaticData staticData(true);
+	const auto load = []() -> std::shared_ptr<const EU4::VanillaImage> {
+		throw std::runtime_error("No install");
+	};
+
+	EXPECT_THROW(auto image = staticData.vanillaImage("countries", load), std::runtime_error);
+	EXPECT_EQ(std::set<std::string>{"TST"}, staticData.vanillaImage("countries", [] {
+		return imageOf("TST");
+	})->specialCountryTags);
+}
+
+TEST(EU4World_StaticDataTests, loneConversionsDontShare)
+{
+	EXPECT_FALSE(EU4::StaticData().shared());
+	EXPECT_TRUE(EU4::StaticData(true).shared());
+}
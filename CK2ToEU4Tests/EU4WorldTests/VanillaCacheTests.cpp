@@ -0,0 +1,132 @@
+#include "../../CK2ToEU4/Source/EU4World/Country/Country.h"
+#include "../../CK2ToEU4/Source/EU4World/Output/TextBuffer.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/EU4Province.h"
+#include "../../CK2ToEU4/Source/EU4World/Province/ProvinceTable.h"
+#include "../../CK2ToEU4/Source/EU4World/VanillaCache.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+const std::string installPath = "vanillaCacheInstall";
+
+void writeFile(const std::string& filePath, const std::string& contents)
+{
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+	std::ofstream(filePath) << contents;
+}
+
+void writeInstall()
+{
+	writeFile(installPath + "/common/countries/Test.txt", "graphical_culture = easterngfx\nleader_names = { \"Zeno\" \"Abel\" }\n");
+	writeFile(installPath + "/history/countries/TST - Test.txt", "government = republic\nprimary_culture = dutch\ncapital = 12\n");
+	writeFile(installPath + "/history/provinces/12 - Test.txt", "owner = TST\nculture = dutch\nbase_tax = 3\nadd_core = TST\n");
+}
+} // namespace
+
+TEST(EU4World_VanillaCacheTests, vanillaStateSurvivesARoundTrip)
+{
+	writeInstall();
+	const std::string countriesPath = "vanillaCacheRoundTrip/countries.cache";
+	const std::string provincesPath = "vanillaCacheRoundTrip/provinces.cache";
+
+	parsing::NameMap<std::shared_ptr<EU4::Country>> countries;
+	countries.emplace("TST", std::make_shared<EU4::Country>("TST", installPath + "/common/countries/Test.txt"));
+	countries["TST"]->loadHistory(installPath + "/history/countries/TST - Test.txt");
+	EU4::ProvinceTable provinces;
+	provinces.insert({12, std::make_shared<EU4::Province>(12, installPath + "/history/provinces/12 - Test.txt")});
+	EU4::VanillaCache::saveCountries(countriesPath, "key", countries, {"TST"});
+	EU4::VanillaCache::saveProvinces(provincesPath, "key", provinces);
+
+	parsing::NameMap<std::shared_ptr<EU4::Country>> loadedCountries;
+	std::set<std::string> loadedSpecialTags;
+	EU4::ProvinceTable loadedProvinces;
+	ASSERT_TRUE(EU4::VanillaCache::loadCountries(countriesPath, "key", loadedCountries, loadedSpecialTags));
+	ASSERT_TRUE(EU4::VanillaCache::loadProvinces(provincesPath, "key", loadedProvinces));
+	std::filesystem::remove_all("vanillaCacheRoundTrip");
+	std::filesystem::remove_all(installPath);
+
+	const auto& country = loadedCountries.at("TST");
+	EXPECT_EQ("TST", country->getTag());
+	EXPECT_EQ("countries/Test.txt", country->getCommonCountryFile());
+	EXPECT_EQ("history/countries/TST - Test.txt", country->getHistoryCountryFile());
+	EXPECT_EQ("easterngfx", country->getGFX());
+	EXPECT_EQ("republic", country->getGovernment());
+	EXPECT_EQ("dutch", country->getPrimaryCulture());
+	EXPECT_EQ(12, country->getCapitalID());
+	EXPECT_EQ(std::set<std::string>{"TST"}, loadedSpecialTags);
+	EU4::TextBuffer commons;
+	country->outputCommons(commons);
+	EXPECT_NE(std::string::npos, commons.str().find("leader_names = {\n\t\"Abel\"\n\t\"Zeno\"\n}\n"));
+
+	const auto& province = loadedProvinces.find(12)->second;
+	EXPECT_EQ("history/provinces/12 - Test.txt", province->getHistoryCountryFile());
+	EXPECT_EQ("TST", province->getOwner());
+	EXPECT_EQ("dutch", province->getCulture());
+	EXPECT_EQ(3, province->getAdm());
+}
+
+TEST(EU4World_VanillaCacheTests, cacheForAnotherKeyIsNotLoaded)
+{
+	const std::string path = "vanillaCacheOtherKey.cache";
+	EU4::ProvinceTable provinces;
+	provinces.insert({1, std::make_shared<EU4::Province>()});
+	EU4::VanillaCache::saveProvinces(path, "key", provinces);
+
+	EU4::ProvinceTable loaded;
+	ASSERT_FALSE(EU4::VanillaCache::loadProvinces(path, "another key", loaded));
+	ASSERT_FALSE(EU4::VanillaCache::loadProvinces("nonExistent.cache", "key", loaded));
+	std::filesystem::remove(path);
+}
+
+TEST(EU4World_VanillaCacheTests, imagesCopyTheVanillaState)
+{
+	writeInstall();
+	parsing::NameMap<std::shared_ptr<EU4::Country>> countries;
+	countries.emplace("TST", std::make_shared<EU4::Country>("TST", installPath + "/common/countries/Test.txt"));
+	countries["TST"]->loadHistory(installPath + "/history/countries/TST - Test.txt");
+	EU4::ProvinceTable provinces;
+	provinces.insert({12, std::make_shared<EU4::Province>(12, installPath + "/history/provinces/12 - Test.txt")});
+	std::filesystem::remove_all(installPath);
+	const auto countriesImage = EU4::VanillaCache::countriesImage(countries, {"TST"});
+	const auto provincesImage = EU4::VanillaCache::provincesImage(provinces);
+	countries.at("TST")->setGovernment("monarchy");
+	provinces.find(12)->second->setOwner("FRA");
+
+	parsing::NameMap<std::shared_ptr<EU4::Country>> copiedCountries;
+	std::set<std::string> copiedSpecialTags;
+	EU4::ProvinceTable copiedProvinces;
+	EU4::VanillaCache::loadCountriesImage(*countriesImage, copiedCountries, copiedSpecialTags);
+	EU4::VanillaCache::loadProvincesImage(*provincesImage, copiedProvinces);
+
+	// Copies, not the same objects, and untouched by what the importer changed afterwards.
+	EXPECT_NE(countries.at("TST"), copiedCountries.at("TST"));
+	EXPECT_EQ("republic", copiedCountries.at("TST")->getGovernment());
+	EXPECT_EQ(12, copiedCountries.at("TST")->getCapitalID());
+	EXPECT_EQ(std::set<std::string>{"TST"}, copiedSpecialTags);
+	EXPECT_NE(provinces.find(12)->second, copiedProvinces.find(12)->second);
+	EXPECT_EQ("TST", copiedProvinces.find(12)->second->getOwner());
+	EXPECT_EQ(3, copiedProvinces.find(12)->second->getAdm());
+
+	// Nor by what another copy changes.
+	EU4::ProvinceTable otherProvinces;
+	EU4::VanillaCache::loadProvincesImage(*provincesImage, otherProvinces);
+	otherProvinces.find(12)->second->setAdm(5);
+	EXPECT_EQ(3, copiedProvinces.find(12)->second->getAdm());
+	EXPECT_EQ(5, otherProvinces.find(12)->second->getAdm());
+}
+
+TEST(EU4World_VanillaCacheTests, fingerprintFollowsTheInstall)
+{
+	writeInstall();
+	const auto firstPrint = EU4::VanillaCache::fingerprint({installPath});
+	const auto samePrint = EU4::VanillaCache::fingerprint({installPath});
+	writeFile(installPath + "/history/provinces/12 - Test.txt", "owner = TST\nculture = frisian\n");
+	const auto otherPrint = EU4::VanillaCache::fingerprint({installPath});
+	std::filesystem::remove_all(installPath);
+
+	ASSERT_EQ(firstPrint, samePrint);
+	ASSERT_NE(firstPrint, otherPrint);
+	ASSERT_NE(firstPrint, EU4::VanillaCache::fingerprint({installPath}));
+}
@@ -0,0 +1,68 @@
+#include "../CK2ToEU4/Source/Configuration/JobFolder.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+TEST(CK2ToEU4_JobFolderTests, JobsFilesAreTakenInNameOrder)
+{
+	std::filesystem::remove_all("jobFolder");
+	const JobFolder jobFolder("jobFolder");
+	EXPECT_FALSE(jobFolder.nextJobs());
+
+	std::ofstream("jobFolder/b.txt") << "job = { save = \"b.ck2\" }\n";
+	std::ofstream("jobFolder/a.txt") << "job = { save = \"a.ck2\" }\n";
+	std::ofstream("jobFolder/notes.md") << "not a jobs file\n";
+
+	EXPECT_EQ("jobFolder/a.txt", jobFolder.nextJobs());
+	EXPECT_EQ(2, jobFolder.countJobs());
+	std::filesystem::remove_all("jobFolder");
+}
+
+TEST(CK2ToEU4_JobFolderTests, FinishedJobsAreMovedAside)
+{
+	std::filesystem::remove_all("jobFolder");
+	const JobFolder jobFolder("jobFolder");
+	std::ofstream("jobFolder/a.txt") << "job = { save = \"a.ck2\" }\n";
+	std::ofstream("jobFolder/b.txt") << "job = { save = \"b.ck2\" }\n";
+
+	jobFolder.finish("jobFolder/a.txt", "");
+	jobFolder.finish("jobFolder/b.txt", "Could not open b.ck2");
+	std::ifstream errorFile("jobFolder/failed/b.error");
+	std::string error;
+	std::getline(errorFile, error);
+
+	EXPECT_FALSE(jobFolder.nextJobs());
+	EXPECT_TRUE(std::filesystem::exists("jobFolder/done/a.txt"));
+	EXPECT_TRUE(std::filesystem::exists("jobFolder/failed/b.txt"));
+	EXPECT_EQ("Could not open b.ck2", error);
+	errorFile.close();
+	std::filesystem::remove_all("jobFolder");
+}
+
+TEST(CK2ToEU4_JobFolderTests, StopRequestsAreTakenOnce)
+{
+	std::filesystem::remove_all("jobFolder");
+	const JobFolder jobFolder("jobFolder");
+	EXPECT_FALSE(jobFolder.takeStopRequest());
+
+	std::ofstream("jobFolder/stop").close();
+
+	EXPECT_TRUE(jobFolder.takeStopRequest());
+	EXPECT_FALSE(jobFolder.takeStopRequest());
+	std::filesystem::remove_all("jobFolder");
+}
+
+TEST(CK2ToEU4_JobFolderTests, CancelRequestsAreTakenPerJobsFile)
+{
+	std::filesystem::remove_all("jobFolder");
+	const JobFolder jobFolder("jobFolder");
+	std::ofstream("jobFolder/a.txt") << "job = { save = \"a.ck2\" }\n";
+	std::ofstream("jobFolder/b.txt") << "job = { save = \"b.ck2\" }\n";
+
+	std::ofstream("jobFolder/b.cancel").close();
+
+	EXPECT_FALSE(jobFolder.takeCancelRequest("jobFolder/a.txt"));
+	EXPECT_TRUE(jobFolder.takeCancelRequest("jobFolder/b.txt"));
+	EXPECT_FALSE(jobFolder.takeCancelRequest("jobFolder/b.txt"));
+	std::filesystem::remove_all("jobFolder");
+}
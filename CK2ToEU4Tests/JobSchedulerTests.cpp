@@ -0,0 +1,65 @@
+#include "../CK2ToEU4/Source/Configuration/JobScheduler.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+namespace
+{
+constexpr std::size_t GiB = 1024 * 1024 * 1024;
+}
+
+TEST(CK2ToEU4_JobSchedulerTests, InteractiveJobsStartFirst)
+{
+	const std::atomic<bool> cancelled = false;
+	constexpr auto bulk = BatchJobs::PRIORITY::BULK;
+	constexpr auto interactive = BatchJobs::PRIORITY::INTERACTIVE;
+	JobScheduler scheduler({{bulk, 0}, {interactive, 0}, {bulk, 0}, {interactive, 0}}, 0, cancelled);
+
+	EXPECT_EQ(1, scheduler.admit());
+	EXPECT_EQ(3, scheduler.admit());
+	EXPECT_EQ(0, scheduler.admit());
+	EXPECT_EQ(2, scheduler.admit());
+	EXPECT_FALSE(scheduler.admit());
+}
+
+TEST(CK2ToEU4_JobSchedulerTests, JobsWaitForMemoryToFree)
+{
+	const std::atomic<bool> cancelled = false;
+	JobScheduler scheduler({{BatchJobs::PRIORITY::BULK, 3 * GiB}, {BatchJobs::PRIORITY::BULK, 2 * GiB}}, 4 * GiB, cancelled);
+	ASSERT_EQ(0, scheduler.admit());
+
+	std::optional<std::size_t> second;
+	std::thread waiter([&scheduler, &second] {
+		second = scheduler.admit();
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_EQ(1, scheduler.countWaiting());
+	scheduler.release(0);
+	waiter.join();
+
+	EXPECT_EQ(1, second);
+	EXPECT_EQ(0, scheduler.countWaiting());
+}
+
+TEST(CK2ToEU4_JobSchedulerTests, OversizedJobsStillRunAlone)
+{
+	const std::atomic<bool> cancelled = false;
+	JobScheduler scheduler({{BatchJobs::PRIORITY::BULK, 10 * GiB}}, 4 * GiB, cancelled);
+
+	EXPECT_EQ(0, scheduler.admit());
+}
+
+TEST(CK2ToEU4_JobSchedulerTests, CancelledBatchesStartNothingMore)
+{
+	std::atomic<bool> cancelled = false;
+	JobScheduler scheduler({{BatchJobs::PRIORITY::BULK, 3 * GiB}, {BatchJobs::PRIORITY::BULK, 3 * GiB}}, 4 * GiB, cancelled);
+	ASSERT_EQ(0, scheduler.admit());
+
+	std::optional<std::size_t> second = 7;
+	std::thread waiter([&scheduler, &second] {
+		second = scheduler.admit();
+	});
+	cancelled = true;
+	waiter.join();
+
+	EXPECT_FALSE(second);
+}
@@ -0,0 +1,53 @@
+#include "../../CK2ToEU4/Source/Mappers/ColorScraper/ColorScraper.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(Mappers_ColorScraperTests, colorsDefaultToBlank)
+{
+	std::stringstream input;
+	mappers::ColorScraper scraper;
+	scraper.scrapeStream(input);
+
+	EXPECT_TRUE(scraper.getColors().empty());
+	EXPECT_FALSE(scraper.getColorForTitle("k_norway"));
+}
+
+TEST(Mappers_ColorScraperTests, nestedTitleColorsCanBeScraped)
+{
+	std::stringstream input;
+	input << "e_scandinavia = {\n";
+	input << "\tcolor = { 1 2 3 }\n";
+	input << "\tk_norway = {\n";
+	input << "\t\tcolor = { 4 5 6 }\n";
+	input << "\t\tallow = { color = { 9 9 9 } }\n";
+	input << "\t\td_vestlandet = {\n";
+	input << "\t\t\tc_bergen = { color = { 7 8 9 } b_bergen = { color = { 9 9 9 } } }\n";
+	input << "\t\t}\n";
+	input << "\t}\n";
+	input << "}\n";
+	mappers::ColorScraper scraper;
+	scraper.scrapeStream(input);
+
+	EXPECT_EQ(3u, scraper.getColors().size());
+	EXPECT_EQ(commonItems::Color(std::array<int, 3>{1, 2, 3}), scraper.getColorForTitle("e_scandinavia"));
+	EXPECT_EQ(commonItems::Color(std::array<int, 3>{4, 5, 6}), scraper.getColorForTitle("k_norway"));
+	EXPECT_EQ(commonItems::Color(std::array<int, 3>{7, 8, 9}), scraper.getColorForTitle("c_bergen"));
+	EXPECT_FALSE(scraper.getColorForTitle("d_vestlandet"));
+	EXPECT_FALSE(scraper.getColorForTitle("b_bergen"));
+}
+
+TEST(Mappers_ColorScraperTests, laterSourcesOverrideColors)
+{
+	std::stringstream vanilla;
+	vanilla << "k_norway = { color = { 4 5 6 } }\n";
+	vanilla << "k_sweden = { color = { 1 2 3 } }\n";
+	std::stringstream mod;
+	mod << "k_norway = { color = { 7 8 9 } }\n";
+	mod << "k_sweden = { capital = 1 }\n";
+	mappers::ColorScraper scraper;
+	scraper.scrapeStream(vanilla);
+	scraper.scrapeStream(mod);
+
+	EXPECT_EQ(commonItems::Color(std::array<int, 3>{7, 8, 9}), scraper.getColorForTitle("k_norway"));
+	EXPECT_EQ(commonItems::Color(std::array<int, 3>{1, 2, 3}), scraper.getColorForTitle("k_sweden"));
+}
@@ -0,0 +1,73 @@
+#include "../../CK2ToEU4/Source/Mappers/CompiledConfigurables/CompiledConfigurables.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+struct Mapping
+{
+	std::string tag;
+	std::vector<int> capitals;
+
+	void writeCompiled(mappers::CompiledConfigurables::Writer& writer) const
+	{
+		writer.put(tag);
+		writer.put(capitals);
+	}
+	void readCompiled(mappers::CompiledConfigurables::Reader& reader)
+	{
+		reader.get(tag);
+		reader.get(capitals);
+	}
+};
+} // namespace
+
+TEST(Mappers_CompiledConfigurablesTests, compiledMappingsSurviveTheRoundTrip)
+{
+	std::ofstream("compiledTest.txt") << "link = { eu4 = NOR ck2 = k_norway }\n";
+	const std::vector<std::string> sources{"compiledTest.txt"};
+	const std::map<std::string, Mapping> mappings{{"k_norway", {"NOR", {1, 2}}}, {"k_sweden", {"SWE", {}}}};
+	mappers::CompiledConfigurables::save(sources, "test 1", [&mappings](mappers::CompiledConfigurables::Writer& writer) {
+		writer.put(mappings);
+	});
+
+	std::map<std::string, Mapping> loaded;
+	EXPECT_TRUE(mappers::CompiledConfigurables::load(sources, "test 1", [&loaded](mappers::CompiledConfigurables::Reader& reader) {
+		reader.get(loaded);
+	}));
+
+	ASSERT_EQ(2u, loaded.size());
+	EXPECT_EQ("NOR", loaded["k_norway"].tag);
+	EXPECT_EQ((std::vector{1, 2}), loaded["k_norway"].capitals);
+	EXPECT_TRUE(loaded["k_sweden"].capitals.empty());
+	std::filesystem::remove(mappers::CompiledConfigurables::compiledPath("compiledTest.txt"));
+	std::filesystem::remove("compiledTest.txt");
+}
+
+TEST(Mappers_CompiledConfigurablesTests, editedSourcesAreReparsed)
+{
+	std::ofstream("compiledTest.txt") << "link = { eu4 = NOR ck2 = k_norway }\n";
+	const std::vector<std::string> sources{"compiledTest.txt"};
+	mappers::CompiledConfigurables::save(sources, "test 1", [](mappers::CompiledConfigurables::Writer& writer) {
+		writer.put(std::string("NOR"));
+	});
+	std::ofstream("compiledTest.txt") << "link = { eu4 = SWE ck2 = k_norway }\n";
+
+	EXPECT_FALSE(mappers::CompiledConfigurables::load(sources, "test 1", [](mappers::CompiledConfigurables::Reader&) {}));
+	std::filesystem::remove(mappers::CompiledConfigurables::compiledPath("compiledTest.txt"));
+	std::filesystem::remove("compiledTest.txt");
+}
+
+TEST(Mappers_CompiledConfigurablesTests, otherFormatsAreReparsed)
+{
+	std::ofstream("compiledTest.txt") << "link = { eu4 = NOR ck2 = k_norway }\n";
+	const std::vector<std::string> sources{"compiledTest.txt"};
+	mappers::CompiledConfigurables::save(sources, "test 1", [](mappers::CompiledConfigurables::Writer& writer) {
+		writer.put(std::string("NOR"));
+	});
+
+	EXPECT_FALSE(mappers::CompiledConfigurables::load(sources, "test 2", [](mappers::CompiledConfigurables::Reader&) {}));
+	std::filesystem::remove(mappers::CompiledConfigurables::compiledPath("compiledTest.txt"));
+	std::filesystem::remove("compiledTest.txt");
+}
@@ -11,7 +11,7 @@ TEST(Mappers_CultureMapperTests, nonMatchGivesEmptyOptional)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_FALSE(culMapper.cultureMatch("nonMatchingCulture", "", 0, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("nonMatchingCulture"), "", 0, ""));
 }
 
 TEST(Mappers_CultureMapperTests, simpleCultureMatches)
@@ -21,7 +21,7 @@ TEST(Mappers_CultureMapperTests, simpleCultureMatches)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_EQ(*culMapper.cultureMatch("test", "", 0, ""), "culture");
+	ASSERT_EQ(*culMapper.cultureMatch(parsing::Symbol("test"), "", 0, ""), "culture");
 }
 
 TEST(Mappers_CultureMapperTests, simpleCultureCorrectlyMatches)
@@ -31,7 +31,7 @@ TEST(Mappers_CultureMapperTests, simpleCultureCorrectlyMatches)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_EQ(*culMapper.cultureMatch("test", "", 0, ""), "culture");
+	ASSERT_EQ(*culMapper.cultureMatch(parsing::Symbol("test"), "", 0, ""), "culture");
 }
 
 TEST(Mappers_CultureMapperTests, cultureMatchesWithReligion)
@@ -41,7 +41,7 @@ TEST(Mappers_CultureMapperTests, cultureMatchesWithReligion)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_EQ(*culMapper.cultureMatch("test", "thereligion", 0, ""), "culture");
+	ASSERT_EQ(*culMapper.cultureMatch(parsing::Symbol("test"), "thereligion", 0, ""), "culture");
 }
 
 TEST(Mappers_CultureMapperTests, cultureFailsWithWrongReligion)
@@ -51,7 +51,7 @@ TEST(Mappers_CultureMapperTests, cultureFailsWithWrongReligion)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_FALSE(culMapper.cultureMatch("test", "unreligion", 0, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "unreligion", 0, ""));
 }
 
 TEST(Mappers_CultureMapperTests, cultureMatchesWithCapital)
@@ -61,7 +61,7 @@ TEST(Mappers_CultureMapperTests, cultureMatchesWithCapital)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_EQ(*culMapper.cultureMatch("test", "", 4, ""), "culture");
+	ASSERT_EQ(*culMapper.cultureMatch(parsing::Symbol("test"), "", 4, ""), "culture");
 }
 
 TEST(Mappers_CultureMapperTests, cultureFailsWithWrongCapital)
@@ -71,7 +71,7 @@ TEST(Mappers_CultureMapperTests, cultureFailsWithWrongCapital)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_FALSE(culMapper.cultureMatch("test", "", 3, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "", 3, ""));
 }
 
 TEST(Mappers_CultureMapperTests, cultureMatchesWithOwnerTag)
@@ -81,7 +81,7 @@ TEST(Mappers_CultureMapperTests, cultureMatchesWithOwnerTag)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_EQ(*culMapper.cultureMatch("test", "", 0, "TAG"), "culture");
+	ASSERT_EQ(*culMapper.cultureMatch(parsing::Symbol("test"), "", 0, "TAG"), "culture");
 }
 
 TEST(Mappers_CultureMapperTests, cultureFailsWithWrongTag)
@@ -91,7 +91,7 @@ TEST(Mappers_CultureMapperTests, cultureFailsWithWrongTag)
 	mappers::CultureMapper culMapper;
 	culMapper.initCultureMapper(input);
 
-	ASSERT_FALSE(culMapper.cultureMatch("test", "", 0, "GAT"));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "", 0, "GAT"));
 }
 
 TEST(Mappers_CultureMapperTests, cultureMapperThrowsExceptionWithoutRegionMapper)
@@ -102,7 +102,7 @@ TEST(Mappers_CultureMapperTests, cultureMapperThrowsExceptionWithoutRegionMapper
 	culMapper.initCultureMapper(input);
 	try
 	{
-		auto attempt = culMapper.cultureMatch("test", "", 4, "");
+		auto attempt = culMapper.cultureMatch(parsing::Symbol("test"), "", 4, "");
 		FAIL();
 	}
 	catch (const std::runtime_error& e)
@@ -131,7 +131,7 @@ TEST(Mappers_CultureMapperTests, cultureMapperFailsForInvalidRegion)
 	theMapper->loadRegions(areaStream, regionStream, superRegionStream);
 
 	culMapper.loadRegionMapper(theMapper);
-	ASSERT_FALSE(culMapper.cultureMatch("test", "", 7, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "", 7, ""));
 }
 
 TEST(Mappers_CultureMapperTests, cultureMapperMatchesOnRegion)
@@ -155,7 +155,7 @@ TEST(Mappers_CultureMapperTests, cultureMapperMatchesOnRegion)
 
 	culMapper.loadRegionMapper(theMapper);
 
-	ASSERT_EQ(*culMapper.cultureMatch("test", "", 1, ""), "culture");
+	ASSERT_EQ(*culMapper.cultureMatch(parsing::Symbol("test"), "", 1, ""), "culture");
 }
 
 TEST(Mappers_CultureMapperTests, cultureMapperFailsOnWrongRegion)
@@ -179,7 +179,109 @@ TEST(Mappers_CultureMapperTests, cultureMapperFailsOnWrongRegion)
 
 	culMapper.loadRegionMapper(theMapper);
 
-	ASSERT_FALSE(culMapper.cultureMatch("test", "", 6, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "", 6, ""));
+}
+
+TEST(Mappers_CultureMapperTests, firstMatchingRuleWinsAcrossSharedCultures)
+{
+	std::stringstream input;
+	input << "link = { eu4 = regional ck2 = test region = test_region }";
+	input << "link = { eu4 = other ck2 = other }";
+	input << "link = { eu4 = religious ck2 = test ck2 = other religion = thereligion }";
+	input << "link = { eu4 = fallback ck2 = test }";
+	mappers::CultureMapper culMapper;
+	culMapper.initCultureMapper(input);
+
+	auto theMapper = std::make_shared<mappers::RegionMapper>();
+	std::stringstream areaStream;
+	areaStream << "test_area = { 1 2 3 } \n";
+	areaStream << "test_area2 = { 4 5 6 } ";
+	std::stringstream regionStream;
+	regionStream << "test_region = { areas = { test_area } }";
+	regionStream << "test_region2 = { areas = { test_area2 } }\n";
+	std::stringstream superRegionStream;
+	superRegionStream << "test_superregion = { test_region }\n";
+	superRegionStream << "test_superregion2 = { test_region2 }";
+	theMapper->loadRegions(areaStream, regionStream, superRegionStream);
+	culMapper.loadRegionMapper(theMapper);
+
+	ASSERT_EQ("regional", *culMapper.cultureMatch(parsing::Symbol("test"), "thereligion", 2, ""));
+	ASSERT_EQ("religious", *culMapper.cultureMatch(parsing::Symbol("test"), "thereligion", 5, ""));
+	ASSERT_EQ("fallback", *culMapper.cultureMatch(parsing::Symbol("test"), "unreligion", 5, ""));
+	ASSERT_EQ("other", *culMapper.cultureMatch(parsing::Symbol("other"), "thereligion", 5, ""));
+	ASSERT_EQ("regional", *culMapper.cultureRegionalMatch(parsing::Symbol("test"), "", 3, ""));
+	ASSERT_FALSE(culMapper.cultureRegionalMatch(parsing::Symbol("test"), "", 4, ""));
+	ASSERT_EQ("fallback", *culMapper.cultureNonRegionalNonReligiousMatch(parsing::Symbol("test"), "", 2, ""));
+}
+
+TEST(Mappers_CultureMapperTests, provinceOverridesRegionOnCultureMatch)
+{
+	std::stringstream input;
+	input << "link = { eu4 = culture ck2 = test region = test_region province = 5 }";
+	mappers::CultureMapper culMapper;
+	culMapper.initCultureMapper(input);
+
+	auto theMapper = std::make_shared<mappers::RegionMapper>();
+	std::stringstream areaStream;
+	areaStream << "test_area = { 1 2 3 } \n";
+	areaStream << "test_area2 = { 4 5 6 } ";
+	std::stringstream regionStream;
+	regionStream << "test_region = { areas = { test_area } }";
+	regionStream << "test_region2 = { areas = { test_area2 } }\n";
+	std::stringstream superRegionStream;
+	superRegionStream << "test_superregion = { test_region }\n";
+	superRegionStream << "test_superregion2 = { test_region2 }";
+	theMapper->loadRegions(areaStream, regionStream, superRegionStream);
+	culMapper.loadRegionMapper(theMapper);
+
+	ASSERT_EQ("culture", *culMapper.cultureMatch(parsing::Symbol("test"), "", 1, ""));
+	ASSERT_EQ("culture", *culMapper.cultureMatch(parsing::Symbol("test"), "", 5, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "", 6, ""));
+}
+
+TEST(Mappers_CultureMapperTests, repeatedMatchesAreRemembered)
+{
+	std::stringstream input;
+	input << "link = { eu4 = culture ck2 = test religion = thereligion }";
+	mappers::CultureMapper culMapper;
+	culMapper.initCultureMapper(input);
+
+	ASSERT_EQ("culture", *culMapper.cultureMatch(parsing::Symbol("test"), "thereligion", 0, ""));
+	ASSERT_EQ("culture", *culMapper.cultureMatch(parsing::Symbol("test"), "thereligion", 0, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "unreligion", 0, ""));
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "unreligion", 0, ""));
+	ASSERT_FALSE(culMapper.cultureNonRegionalNonReligiousMatch(parsing::Symbol("test"), "thereligion", 0, ""));
+
+	ASSERT_EQ(2, culMapper.getCachedMatches());
+	ASSERT_EQ(3, culMapper.getResolvedMatches());
+}
+
+TEST(Mappers_CultureMapperTests, rememberedMatchesAreDroppedWithNewRegions)
+{
+	std::stringstream input;
+	input << "link = { eu4 = culture ck2 = test region = test_region }";
+	mappers::CultureMapper culMapper;
+	culMapper.initCultureMapper(input);
+
+	std::stringstream areaStream;
+	areaStream << "test_area = { 1 2 3 } \n";
+	std::stringstream regionStream;
+	regionStream << "test_region = { areas = { test_area } }";
+	std::stringstream superRegionStream;
+	auto theMapper = std::make_shared<mappers::RegionMapper>();
+	theMapper->loadRegions(areaStream, regionStream, superRegionStream);
+	culMapper.loadRegionMapper(theMapper);
+	ASSERT_EQ("culture", *culMapper.cultureMatch(parsing::Symbol("test"), "", 1, ""));
+
+	std::stringstream otherAreaStream;
+	otherAreaStream << "test_area = { 4 5 6 } \n";
+	std::stringstream otherRegionStream;
+	otherRegionStream << "test_region = { areas = { test_area } }";
+	std::stringstream otherSuperRegionStream;
+	auto otherMapper = std::make_shared<mappers::RegionMapper>();
+	otherMapper->loadRegions(otherAreaStream, otherRegionStream, otherSuperRegionStream);
+	culMapper.loadRegionMapper(otherMapper);
+	ASSERT_FALSE(culMapper.cultureMatch(parsing::Symbol("test"), "", 1, ""));
 }
 
 TEST(Mappers_CultureMapperTests, TechGroupCanBeRetrieved)
@@ -242,3 +344,17 @@ TEST(Mappers_CultureMapperTests, GFXFailsForMissingTechEntry)
 
 	ASSERT_FALSE(culMapper.getGFX("culture"));
 }
+
+TEST(Mappers_CultureMapperTests, techGroupAndGFXComeFromTheFirstRuleNamingThem)
+{
+	std::stringstream input;
+	input << "link = { eu4 = culture ck2 = qwe }\n";
+	input << "link = { eu4 = culture ck2 = test tech = first_tech }\n";
+	input << "link = { eu4 = culture ck2 = poi tech = second_tech gfx = first_gfx }\n";
+	input << "link = { eu4 = culture ck2 = asd gfx = second_gfx }\n";
+	mappers::CultureMapper culMapper;
+	culMapper.initCultureMapper(input);
+
+	ASSERT_EQ("first_tech", culMapper.getTechGroup("culture"));
+	ASSERT_EQ("first_gfx", culMapper.getGFX(std::string_view("culture")));
+}
@@ -39,3 +39,19 @@ TEST(Mappers_DevWeightsMapperTests, devFromBaronyCanBeSet)
 
 	ASSERT_NEAR(theMapper.getDevFromBarony(), 0.5, 0.001);
 }
+
+TEST(Mappers_DevWeightsMapperTests, castlesSplitBetweenAdmAndMil)
+{
+	const auto& split = mappers::DevWeightsMapper::getDevSplit(CK2::Barony::HOLDING::CASTLE);
+
+	ASSERT_NEAR(split[0], 0.333, 0.001);
+	ASSERT_NEAR(split[1], 0.0, 0.001);
+	ASSERT_NEAR(split[2], 0.667, 0.001);
+}
+
+TEST(Mappers_DevWeightsMapperTests, unknownHoldingsWeighNothing)
+{
+	const auto& split = mappers::DevWeightsMapper::getDevSplit(CK2::Barony::HOLDING::OTHER);
+
+	ASSERT_NEAR(split[0] + split[1] + split[2], 0.0, 0.001);
+}
@@ -10,7 +10,7 @@ TEST(Mappers_GovernmentsMapperTests, nonMatchGivesEmptyOptional)
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
 
-	ASSERT_FALSE(theMapper.matchGovernment("nonMatchingGovernment", "ck2title"));
+	ASSERT_FALSE(theMapper.matchGovernment(parsing::Symbol("nonMatchingGovernment"), "ck2title"));
 }
 
 
@@ -21,7 +21,7 @@ TEST(Mappers_GovernmentsMapperTests, eu4GovernmentCanBeFound)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("ck2Government", "ck2title");
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government"), "ck2title");
 
 	ASSERT_EQ(match->first, "eu4Government");
 }
@@ -34,7 +34,7 @@ TEST(Mappers_GovernmentsMapperTests, multipleCK2GovernmentsCanBeInARule)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("ck2Government2", "ck2title");
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government2"), "ck2title");
 
 	ASSERT_EQ(match->first, "eu4Government");
 }
@@ -47,7 +47,7 @@ TEST(Mappers_GovernmentsMapperTests, correctRuleMatches)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("ck2Government2", "ck2title");
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government2"), "ck2title");
 
 	ASSERT_EQ(match->first, "eu4Government2");
 }
@@ -60,7 +60,7 @@ TEST(Mappers_GovernmentsMapperTests, ck2TitleCanBeFound)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("", "c_test");
+	auto match = theMapper.matchGovernment(parsing::Symbol(""), "c_test");
 
 	ASSERT_EQ(match->first, "eu4Government2");
 }
@@ -73,7 +73,21 @@ TEST(Mappers_GovernmentsMapperTests, ck2TitleTakesPriority)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("ck2Government", "c_test");
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government"), "c_test");
+
+	ASSERT_EQ(match->first, "eu4Government2");
+}
+
+TEST(Mappers_GovernmentsMapperTests, titledLinksAreKeptForTheirTitles)
+{
+	std::stringstream input;
+	input << "link = { gov = eu4Government ck2gov = ck2Government ck2title = c_test }\n";
+	input << "link = { gov = eu4Government2 ck2gov = ck2Government }\n";
+	input << "link = { gov = eu4Government3 ck2gov = ck2Government }";
+
+	mappers::GovernmentsMapper theMapper;
+	theMapper.initGovernmentsMapper(input);
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government"), "c_other");
 
 	ASSERT_EQ(match->first, "eu4Government2");
 }
@@ -86,7 +100,7 @@ TEST(Mappers_GovernmentsMapperTests, reformIsReturnedIfExists)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("ck2Government", "c_test");
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government"), "c_test");
 
 	ASSERT_EQ(match->first, "eu4Government2");
 	ASSERT_EQ(match->second, "papacy_reform");
@@ -100,7 +114,7 @@ TEST(Mappers_GovernmentsMapperTests, reformIsEmptyIfDoesNotExist)
 
 	mappers::GovernmentsMapper theMapper;
 	theMapper.initGovernmentsMapper(input);
-	auto match = theMapper.matchGovernment("ck2Government", "c_test");
+	auto match = theMapper.matchGovernment(parsing::Symbol("ck2Government"), "c_test");
 
 	ASSERT_TRUE(match->second.empty());
 }
\ No newline at end of file
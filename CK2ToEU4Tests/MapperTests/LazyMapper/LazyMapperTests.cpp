@@ -0,0 +1,67 @@
+#include "../CK2ToEU4/Source/Mappers/LazyMapper/LazyMapper.h"
+#include "../CK2ToEU4/Source/Mappers/ShatterEmpiresMapper/ShatterEmpiresMapper.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::unique_ptr<mappers::ShatterEmpiresMapper> loadEmpires()
+{
+	std::stringstream input;
+	input << "shatter_empires = { e_byzantium e_rome }\n";
+	return std::make_unique<mappers::ShatterEmpiresMapper>(input);
+}
+} // namespace
+
+TEST(Mappers_LazyMapperTests, nothingIsLoadedUntilQueried)
+{
+	auto loads = 0;
+	const mappers::LazyMapper<mappers::ShatterEmpiresMapper> theMapper([&loads] {
+		++loads;
+		return loadEmpires();
+	});
+
+	ASSERT_EQ(0, loads);
+	ASSERT_TRUE(theMapper->isEmpireShatterable("e_rome"));
+	ASSERT_FALSE(theMapper->isEmpireShatterable("e_hispania"));
+	ASSERT_EQ(2, (*theMapper).getEmpires().size());
+	ASSERT_EQ(1, loads);
+}
+
+TEST(Mappers_LazyMapperTests, concurrentQueriesLoadOnce)
+{
+	std::atomic<int> loads = 0;
+	const mappers::LazyMapper<mappers::ShatterEmpiresMapper> theMapper([&loads] {
+		++loads;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		return loadEmpires();
+	});
+
+	std::vector<std::thread> queries;
+	for (auto query = 0; query < 4; ++query)
+		queries.emplace_back([&theMapper] {
+			EXPECT_TRUE(theMapper->isEmpireShatterable("e_byzantium"));
+		});
+	for (auto& query: queries)
+		query.join();
+
+	ASSERT_EQ(1, loads);
+}
+
+TEST(Mappers_LazyMapperTests, failedLoadIsTriedAgainOnTheNextQuery)
+{
+	auto loads = 0;
+	const mappers::LazyMapper<mappers::ShatterEmpiresMapper> theMapper([&loads] {
+		if (++loads == 1)
+			throw std::runtime_error("No configurables");
+		return loadEmpires();
+	});
+
+	ASSERT_THROW(auto shatterable = theMapper->isEmpireShatterable("e_rome"), std::runtime_error);
+	ASSERT_TRUE(theMapper->isEmpireShatterable("e_rome"));
+	ASSERT_EQ(2, loads);
+}
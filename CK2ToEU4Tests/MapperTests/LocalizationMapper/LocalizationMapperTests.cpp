@@ -0,0 +1,55 @@
+#include "../CK2ToEU4/Source/Mappers/LocalizationMapper/LocalizationMapper.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(Mappers_LocalizationMapperTests, localisationsCanBeScraped)
+{
+	std::stringstream input;
+	input << "#CODE;ENGLISH;FRENCH;GERMAN;;SPANISH;;;;;;;;;x\n";
+	input << "key1;english1;french1;german1;;spanish1;;;;;;;;;x\n";
+	input << "key2;english2;;;;;;;;;;;;;x\r\n";
+	input << "key3;english3;french3;german3;;spanish3";
+
+	mappers::LocalizationMapper theMapper;
+	theMapper.scrapeStream(input);
+
+	ASSERT_EQ("english1", theMapper.getLocBlockForKey("key1")->english);
+	ASSERT_EQ("french1", theMapper.getLocBlockForKey("key1")->french);
+	ASSERT_EQ("german1", theMapper.getLocBlockForKey("key1")->german);
+	ASSERT_EQ("spanish1", theMapper.getLocBlockForKey("key1")->spanish);
+	ASSERT_EQ("english2", theMapper.getLocBlockForKey("key2")->spanish);
+	ASSERT_FALSE(theMapper.getLocBlockForKey("key3"));
+	ASSERT_FALSE(theMapper.getLocBlockForKey("#CODE"));
+}
+
+TEST(Mappers_LocalizationMapperTests, laterStreamsOverrideEarlierKeys)
+{
+	std::stringstream input;
+	input << "key1;english1;french1;german1;;spanish1;;;;;;;;;x\n";
+	input << "key2;english2;french2;german2;;spanish2;;;;;;;;;x\n";
+	std::stringstream input2;
+	input2 << "key1;override;french;german;;spanish;;;;;;;;;x\n";
+
+	mappers::LocalizationMapper theMapper;
+	theMapper.scrapeStream(input);
+	theMapper.scrapeStream(input2);
+
+	ASSERT_EQ("override", theMapper.getLocBlockForKey("key1")->english);
+	ASSERT_EQ("english2", theMapper.getLocBlockForKey("key2")->english);
+}
+
+TEST(Mappers_LocalizationMapperTests, missingLanguagesShareTheEnglishText)
+{
+	std::stringstream input;
+	input << "key2;english2;;;;;;;;;;;;;x\n";
+
+	mappers::LocalizationMapper theMapper;
+	theMapper.scrapeStream(input);
+	const auto view = theMapper.getLocBlockForKey("key2");
+	const auto block = view->toBlock();
+
+	ASSERT_EQ(view->english.data(), view->french.data());
+	ASSERT_EQ(view->english.data(), view->german.data());
+	ASSERT_EQ("english2", block.german);
+	ASSERT_EQ("english2", block.spanish);
+}
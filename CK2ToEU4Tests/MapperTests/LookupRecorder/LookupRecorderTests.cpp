@@ -0,0 +1,92 @@
+#include "../../CK2ToEU4/Source/Mappers/LookupRecorder/LookupRecorder.h"
+#include "../../CK2ToEU4/Source/Mappers/ReligionMapper/ReligionMapper.h"
+#include "../../CK2ToEU4/Source/Mappers/TitleTagMapper/TitleTagMapper.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <sstream>
+
+using CALL = mappers::LookupRecorder::CALL;
+using Value = mappers::LookupRecorder::Value;
+
+namespace
+{
+std::vector<mappers::LookupRecorder::Call> readRecording()
+{
+	mappers::LookupRecorder::stop();
+	auto calls = mappers::LookupRecorder::read("lookupRecorderTest.bin");
+	std::filesystem::remove("lookupRecorderTest.bin");
+	return calls;
+}
+} // namespace
+
+TEST(Mappers_LookupRecorderTests, nothingIsRecordedWhileStopped)
+{
+	mappers::LookupRecorder::record(CALL::RELIGION, {std::string("catholic")}, {std::string("catholic")});
+
+	EXPECT_FALSE(mappers::LookupRecorder::recording());
+}
+
+TEST(Mappers_LookupRecorderTests, callsSurviveTheRoundTrip)
+{
+	mappers::LookupRecorder::start("lookupRecorderTest.bin");
+	mappers::LookupRecorder::record(CALL::CULTURE, {std::string("norse"), std::string("norse_pagan"), 1LL, std::string("NOR")}, {std::string("norwegian")});
+	mappers::LookupRecorder::record(CALL::CULTURE_REGIONAL, {std::string("norse"), std::string(), -17LL, std::string()}, {Value()});
+	mappers::LookupRecorder::record(CALL::PROVINCE, {3000000000LL}, {1LL, 2LL, 3LL});
+	mappers::LookupRecorder::record(CALL::TAG_REGISTRATION, {std::string("k_norway"), std::string("NOR")}, {});
+
+	const auto& calls = readRecording();
+
+	ASSERT_EQ(4, calls.size());
+	EXPECT_EQ(CALL::CULTURE, calls[0].call);
+	EXPECT_EQ((std::vector<Value>{std::string("norse"), std::string("norse_pagan"), 1LL, std::string("NOR")}), calls[0].arguments);
+	EXPECT_EQ(std::vector<Value>{std::string("norwegian")}, calls[0].results);
+	EXPECT_EQ(CALL::CULTURE_REGIONAL, calls[1].call);
+	EXPECT_EQ((std::vector<Value>{std::string("norse"), std::string(), -17LL, std::string()}), calls[1].arguments);
+	EXPECT_EQ(std::vector<Value>{Value()}, calls[1].results);
+	EXPECT_EQ(std::vector<Value>{3000000000LL}, calls[2].arguments);
+	EXPECT_EQ((std::vector<Value>{1LL, 2LL, 3LL}), calls[2].results);
+	EXPECT_EQ(CALL::TAG_REGISTRATION, calls[3].call);
+	EXPECT_TRUE(calls[3].results.empty());
+}
+
+TEST(Mappers_LookupRecorderTests, mapperLookupsAreRecorded)
+{
+	std::stringstream input;
+	input << "link = { eu4 = eu4Religion ck2 = ck2Religion }";
+	mappers::ReligionMapper theMapper;
+	theMapper.initReligionMapper(input);
+
+	mappers::LookupRecorder::start("lookupRecorderTest.bin");
+	(void)theMapper.getEu4ReligionForCk2Religion(parsing::Symbol("ck2Religion"));
+	(void)theMapper.getEu4ReligionForCk2Religion(parsing::Symbol("nonMatchingReligion"));
+	const auto& calls = readRecording();
+
+	ASSERT_EQ(2, calls.size());
+	EXPECT_EQ((mappers::LookupRecorder::Call{CALL::RELIGION, {std::string("ck2Religion")}, {std::string("eu4Religion")}}), calls[0]);
+	EXPECT_EQ((mappers::LookupRecorder::Call{CALL::RELIGION, {std::string("nonMatchingReligion")}, {Value()}}), calls[1]);
+}
+
+TEST(Mappers_LookupRecorderTests, tagRegistrationsAreRecordedButInternalClaimsAreNot)
+{
+	std::stringstream input;
+	input << "link = { ck2 = k_norway eu4 = NOR }";
+	mappers::TitleTagMapper theMapper;
+	theMapper.initTitleTagMapper(input);
+
+	mappers::LookupRecorder::start("lookupRecorderTest.bin");
+	theMapper.registerTitle("k_sweden", "SWE");
+	(void)theMapper.getTagForTitle("k_norway");
+	const auto& calls = readRecording();
+
+	ASSERT_EQ(2, calls.size());
+	EXPECT_EQ((mappers::LookupRecorder::Call{CALL::TAG_REGISTRATION, {std::string("k_sweden"), std::string("SWE")}, {}}), calls[0]);
+	EXPECT_EQ((mappers::LookupRecorder::Call{CALL::TAG, {std::string("k_norway"), std::string(), 0LL}, {std::string("NOR")}}), calls[1]);
+}
+
+TEST(Mappers_LookupRecorderTests, foreignFilesAreRejected)
+{
+	std::stringstream input;
+	input << "not a lookup trace";
+
+	EXPECT_THROW((void)mappers::LookupRecorder::read(input), std::runtime_error);
+}
@@ -35,3 +35,15 @@ TEST(Mappers_MonumentsMapperTests, doesItCatchMoreThanOne)
 	const auto& test = theMapper.getWonders().size();
 	ASSERT_EQ(3, test);
 }
+
+TEST(Mappers_MonumentsMapperTests, mappingsCanBeLookedUpByType)
+{
+	std::stringstream input;
+	input << "a_wonderful_wonder = { premade = yes }";
+
+	mappers::MonumentsMapper theMapper(input);
+
+	ASSERT_TRUE(theMapper.getMapping("a_wonderful_wonder"));
+	EXPECT_TRUE(theMapper.getMapping("a_wonderful_wonder")->isPremade());
+	EXPECT_FALSE(theMapper.getMapping("Greg"));
+}
@@ -102,3 +102,23 @@ TEST(Mappers_MonumentsMappingTests, doesItGetBuilderReligion)
 
 	EXPECT_TRUE(theMapper.isOfBuilderReligion());
 }
+
+TEST(Mappers_MonumentsMappingTests, doesItGetPremade)
+{
+	std::stringstream input;
+	input << "premade = yes";
+
+	mappers::MonumentsMapping theMapper(input);
+
+	EXPECT_TRUE(theMapper.isPremade());
+}
+
+TEST(Mappers_MonumentsMappingTests, doesItGetUpgradePadding)
+{
+	std::stringstream input;
+	input << "upgrade_padding = { generic_upgrade_1 generic_upgrade_2 generic_upgrade_3 }";
+
+	mappers::MonumentsMapping theMapper(input);
+
+	EXPECT_THAT(theMapper.getUpgradePadding(), ElementsAre("generic_upgrade_1", "generic_upgrade_2", "generic_upgrade_3"));
+}
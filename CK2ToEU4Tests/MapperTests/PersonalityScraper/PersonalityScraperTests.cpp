@@ -35,9 +35,9 @@ TEST(Mappers_PersonalityScraperTests, personalitiesAreAssignedAnIncrementalID)
 	mappers::PersonalityScraper personalityScraper;
 	personalityScraper.scrapePersonalities(input);
 
-	ASSERT_EQ(personalityScraper.getPersonalities().find(1)->second, "personality1");
-	ASSERT_EQ(personalityScraper.getPersonalities().find(2)->second, "personality2");
-	ASSERT_EQ(personalityScraper.getPersonalities().find(3)->second, "personality3");
+	ASSERT_EQ(personalityScraper.getPersonalities()[0], "personality1");
+	ASSERT_EQ(personalityScraper.getPersonalities()[1], "personality2");
+	ASSERT_EQ(personalityScraper.getPersonalities()[2], "personality3");
 }
 
 TEST(Mappers_PersonalityScraperTests, personalitiesCanMatchForID)
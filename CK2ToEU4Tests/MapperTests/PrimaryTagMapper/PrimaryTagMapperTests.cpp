@@ -44,3 +44,16 @@ TEST(Mappers_PrimaryTagMapperTests, TagMapperReturnsTagOnHit)
 	ASSERT_EQ(*tagMapper.getPrimaryTagForCulture("culture4"), "GAT");
 	ASSERT_EQ(*tagMapper.getPrimaryTagForCulture("culture6"), "GOT");
 }
+
+TEST(Mappers_PrimaryTagMapperTests, EarlierCulturesKeepTheirTagAndGroupFieldsAreSkipped)
+{
+	std::stringstream input;
+	input << "group1 = { graphical_culture = westerngfx male_names = { Anund primary } culture1 = { male_names = { primary } primary = TAG } }\n";
+	input << "group2 = { culture1 = { primary = GOT } culture2 = { unit = x primary = \"GAT\" } }\n";
+	const mappers::PrimaryTagMapper tagMapper(input);
+
+	ASSERT_EQ(tagMapper.getCultureTags().size(), 2);
+	ASSERT_EQ(*tagMapper.getPrimaryTagForCulture("culture1"), "TAG");
+	ASSERT_EQ(*tagMapper.getPrimaryTagForCulture("culture2"), "GAT");
+	ASSERT_FALSE(tagMapper.getPrimaryTagForCulture("male_names"));
+}
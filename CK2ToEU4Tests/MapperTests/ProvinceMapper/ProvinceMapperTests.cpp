@@ -47,6 +47,29 @@ TEST(Mappers_ProvinceMapperTests, canLookupEU4Provinces)
 	ASSERT_EQ(theMapper.getEU4ProvinceNumbers(2)[1], 1);
 }
 
+TEST(Mappers_ProvinceMapperTests, sparseNumbersAndFirstMappingWin)
+{
+	std::stringstream input;
+	input << "0.0.0.0 = {\n";
+	input << "	link = { eu4 = 10 ck2 = 7 }\n";
+	input << "	link = { eu4 = 3 eu4 = 4 ck2 = 1 }\n";
+	input << "	link = { eu4 = 5 ck2 = 7 }\n";
+	input << "}";
+
+	const mappers::ProvinceMapper theMapper(input);
+
+	ASSERT_EQ(1, theMapper.getEU4ProvinceNumbers(7).size());
+	ASSERT_EQ(10, theMapper.getEU4ProvinceNumbers(7)[0]);
+	ASSERT_EQ(2, theMapper.getEU4ProvinceNumbers(1).size());
+	ASSERT_EQ(4, theMapper.getEU4ProvinceNumbers(1)[1]);
+	ASSERT_TRUE(theMapper.getEU4ProvinceNumbers(2).empty());
+	ASSERT_TRUE(theMapper.getEU4ProvinceNumbers(8).empty());
+	ASSERT_TRUE(theMapper.getEU4ProvinceNumbers(-1).empty());
+	ASSERT_EQ(7, theMapper.getCK2ProvinceNumbers(5)[0]);
+	ASSERT_TRUE(theMapper.getCK2ProvinceNumbers(6).empty());
+	ASSERT_TRUE(theMapper.getCK2ProvinceNumbers(11).empty());
+}
+
 TEST(Mappers_ProvinceMapperTests, chineseProvincesDefaultToEmpty)
 {
 	std::stringstream dummyInput;
@@ -0,0 +1,45 @@
+#include "../../CK2ToEU4/Source/Mappers/ProvinceTitleMapper/ProvinceTitleGrabber.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+TEST(Mappers_ProvinceTitleGrabberTests, titleDefaultsToBlank)
+{
+	std::stringstream input;
+	const mappers::ProvinceTitleGrabber grabber(input);
+
+	EXPECT_TRUE(grabber.getTitle().empty());
+}
+
+TEST(Mappers_ProvinceTitleGrabberTests, titleCanBeGrabbed)
+{
+	std::stringstream input;
+	input << "\xEF\xBB\xBF# 1 - Vestisland\n";
+	input << "culture = norse\n";
+	input << "b_reykjavik = castle\n";
+	input << "title = c_vestisland\n";
+	const mappers::ProvinceTitleGrabber grabber(input);
+
+	EXPECT_EQ("c_vestisland", grabber.getTitle());
+}
+
+TEST(Mappers_ProvinceTitleGrabberTests, historyIsSkippedOverUntilTheTitle)
+{
+	std::stringstream input;
+	input << "culture = norse\n";
+	input << "867.1.1 = { b_reykjavik = castle title = c_nowhere }\n";
+	input << "title = c_vestisland\n";
+	const mappers::ProvinceTitleGrabber grabber(input);
+
+	EXPECT_EQ("c_vestisland", grabber.getTitle());
+}
+
+TEST(Mappers_ProvinceTitleGrabberTests, historyEndsTheScanOnceTheTitleIsKnown)
+{
+	std::stringstream input;
+	input << "title = c_vestisland\n";
+	input << "867.1.1 = { b_reykjavik = castle }\n";
+	input << "title = c_nowhere\n";
+	const mappers::ProvinceTitleGrabber grabber(input);
+
+	EXPECT_EQ("c_vestisland", grabber.getTitle());
+}
@@ -0,0 +1,98 @@
+#include "../../CK2ToEU4/Source/CK2World/Provinces/Provinces.h"
+#include "../../CK2ToEU4/Source/CK2World/Titles/Titles.h"
+#include "../../CK2ToEU4/Source/Mappers/ProvinceTitleMapper/ProvinceTitleMapper.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+void writeProvince(const std::string& root, const std::string& fileName, const std::string& title)
+{
+	std::filesystem::create_directories(root + "/history/provinces");
+	std::ofstream(root + "/history/provinces/" + fileName) << "title = " << title << "\n";
+}
+} // namespace
+
+TEST(Mappers_ProvinceTitleMapperTests, historyProvincesCanBeLoaded)
+{
+	std::filesystem::remove_all("provinceTitleTest");
+	writeProvince("provinceTitleTest/ck2", "1 - Vestisland.txt", "c_vestisland");
+	writeProvince("provinceTitleTest/ck2", "2 - Austisland.txt", "c_austisland");
+	writeProvince("provinceTitleTest/ck2", "3 - Also Austisland.txt", "c_austisland");
+	writeProvince("provinceTitleTest/ck2", "nonsense.txt", "c_nowhere");
+
+	mappers::ProvinceTitleMapper mapper;
+	mapper.loadProvinces("provinceTitleTest/ck2");
+
+	const std::multimap<int, std::string> expected{{1, "c_vestisland"}, {2, "c_austisland"}, {3, "c_austisland"}};
+	EXPECT_EQ(expected, mapper.getOrigProvinceTitles());
+	std::filesystem::remove_all("provinceTitleTest");
+	std::filesystem::remove_all("snapshots/province_history");
+}
+
+TEST(Mappers_ProvinceTitleMapperTests, modProvincesReplaceMappingsOfTheirIDAndTitle)
+{
+	std::filesystem::remove_all("provinceTitleTest");
+	writeProvince("provinceTitleTest/ck2", "1 - Vestisland.txt", "c_vestisland");
+	writeProvince("provinceTitleTest/ck2", "2 - Austisland.txt", "c_austisland");
+	writeProvince("provinceTitleTest/ck2", "3 - Also Austisland.txt", "c_austisland");
+	writeProvince("provinceTitleTest/ck2", "4 - Faereyar.txt", "c_faereyar");
+	writeProvince("provinceTitleTest/mod", "1 - Vestisland.txt", "c_reykjavik");
+	writeProvince("provinceTitleTest/mod", "5 - Austisland.txt", "c_austisland");
+
+	mappers::ProvinceTitleMapper mapper;
+	mapper.loadProvinces("provinceTitleTest/ck2");
+	mapper.updateProvinces("provinceTitleTest/mod");
+
+	const std::multimap<int, std::string> expected{{1, "c_reykjavik"}, {4, "c_faereyar"}, {5, "c_austisland"}};
+	EXPECT_EQ(expected, mapper.getOrigProvinceTitles());
+	std::filesystem::remove_all("provinceTitleTest");
+	std::filesystem::remove_all("snapshots/province_history");
+}
+
+TEST(Mappers_ProvinceTitleMapperTests, editedHistoryIsRescanned)
+{
+	std::filesystem::remove_all("provinceTitleTest");
+	writeProvince("provinceTitleTest/ck2", "1 - Vestisland.txt", "c_vestisland");
+	mappers::ProvinceTitleMapper().loadProvinces("provinceTitleTest/ck2");
+	writeProvince("provinceTitleTest/ck2", "1 - Vestisland.txt", "c_reykjavik");
+
+	mappers::ProvinceTitleMapper mapper;
+	mapper.loadProvinces("provinceTitleTest/ck2");
+
+	const std::multimap<int, std::string> expected{{1, "c_reykjavik"}};
+	EXPECT_EQ(expected, mapper.getOrigProvinceTitles());
+	std::filesystem::remove_all("provinceTitleTest");
+	std::filesystem::remove_all("snapshots/province_history");
+}
+
+TEST(Mappers_ProvinceTitleMapperTests, filteringKeepsTheFirstMappingOfEachIDAndTitleBothWays)
+{
+	std::filesystem::remove_all("provinceTitleTest");
+	writeProvince("provinceTitleTest/ck2", "1 - Vestisland.txt", "c_vestisland");
+	writeProvince("provinceTitleTest/ck2", "2 - Austisland.txt", "c_austisland");
+	writeProvince("provinceTitleTest/ck2", "3 - Also Austisland.txt", "c_austisland");
+	writeProvince("provinceTitleTest/ck2", "4 - Faereyar.txt", "c_faereyar");
+	writeProvince("provinceTitleTest/ck2", "5 - Nowhere.txt", "c_nowhere");
+	mappers::ProvinceTitleMapper mapper;
+	mapper.loadProvinces("provinceTitleTest/ck2");
+
+	std::stringstream provinceInput;
+	provinceInput << "= { 1 = {} 2 = {} 3 = {} 5 = {} }";
+	const CK2::Provinces provinces(provinceInput);
+	std::stringstream titleInput;
+	titleInput << "= { c_vestisland = {} c_austisland = {} c_faereyar = {} }";
+	const CK2::Titles titles(titleInput);
+	mapper.filterSelf(provinces, titles);
+
+	const std::map<int, std::string> expected{{1, "c_vestisland"}, {2, "c_austisland"}};
+	EXPECT_EQ(expected, mapper.getProvinceTitles());
+	EXPECT_EQ(1, mapper.getIDForTitle("c_vestisland"));
+	EXPECT_EQ(2, mapper.getIDForTitle("c_austisland"));
+	EXPECT_EQ(std::nullopt, mapper.getIDForTitle("c_faereyar"));
+	EXPECT_EQ(std::nullopt, mapper.getIDForTitle("c_nowhere"));
+	std::filesystem::remove_all("provinceTitleTest");
+	std::filesystem::remove_all("snapshots/province_history");
+}
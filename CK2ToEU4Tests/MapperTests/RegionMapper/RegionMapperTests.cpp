@@ -174,3 +174,65 @@ TEST(Mappers_RegionMapperTests, locationNameValidationWorks)
 	ASSERT_TRUE(theMapper.regionNameIsValid("test_superregion2"));
 	ASSERT_FALSE(theMapper.regionNameIsValid("nonsense"));
 }
+
+TEST(Mappers_RegionMapperTests, provincesInRegionCanBeListed)
+{
+	mappers::RegionMapper theMapper;
+	std::stringstream areaStream;
+	areaStream << "test_area = { 1 2 3 } \n";
+	areaStream << "test_area2 = { 4 5 6 } ";
+	std::stringstream regionStream;
+	regionStream << "test_region = { areas = { test_area } }";
+	regionStream << "test_region2 = { areas = { test_area2 } }\n";
+	std::stringstream superRegionStream;
+	superRegionStream << "test_superregion = { test_region test_region2 }\n";
+	theMapper.loadRegions(areaStream, regionStream, superRegionStream);
+
+	ASSERT_EQ((std::set{4, 5, 6}), theMapper.getProvincesInRegion("test_area2"));
+	ASSERT_EQ((std::set{1, 2, 3}), theMapper.getProvincesInRegion("test_region"));
+	ASSERT_EQ((std::set{1, 2, 3, 4, 5, 6}), theMapper.getProvincesInRegion("test_superregion"));
+	ASSERT_TRUE(theMapper.getProvincesInRegion("nonsense").empty());
+}
+
+TEST(Mappers_RegionMapperTests, doublyListedProvinceReportsFirstParentByName)
+{
+	mappers::RegionMapper theMapper;
+	std::stringstream areaStream;
+	areaStream << "b_area = { 1 2 } \n";
+	areaStream << "a_area = { 2 3 } ";
+	std::stringstream regionStream;
+	regionStream << "z_region = { areas = { b_area } }";
+	regionStream << "y_region = { areas = { a_area } }\n";
+	std::stringstream superRegionStream;
+	superRegionStream << "test_superregion = { y_region z_region }\n";
+	theMapper.loadRegions(areaStream, regionStream, superRegionStream);
+
+	ASSERT_EQ("a_area", *theMapper.getParentAreaName(2));
+	ASSERT_EQ("b_area", *theMapper.getParentAreaName(1));
+	ASSERT_EQ("y_region", *theMapper.getParentRegionName(2));
+	ASSERT_EQ("z_region", *theMapper.getParentRegionName(1));
+	ASSERT_EQ("test_superregion", *theMapper.getParentSuperRegionName(3));
+	ASSERT_TRUE(theMapper.provinceIsInRegion(2, "b_area"));
+	ASSERT_TRUE(theMapper.provinceIsInRegion(2, "z_region"));
+	ASSERT_FALSE(theMapper.provinceIsInRegion(3, "z_region"));
+	ASSERT_FALSE(theMapper.provinceIsInRegion(-1, "z_region"));
+	ASSERT_FALSE(theMapper.provinceIsInRegion(300, "test_superregion"));
+}
+
+TEST(Mappers_RegionMapperTests, areasAreNumberedByName)
+{
+	mappers::RegionMapper theMapper;
+	std::stringstream areaStream;
+	areaStream << "b_area = { 1 2 } \n";
+	areaStream << "a_area = { 2 3 } ";
+	std::stringstream regionStream;
+	regionStream << "test_region = { areas = { a_area b_area } }";
+	std::stringstream superRegionStream;
+	theMapper.loadRegions(areaStream, regionStream, superRegionStream);
+
+	ASSERT_EQ(2u, theMapper.getAreaCount());
+	ASSERT_EQ(1u, *theMapper.getParentAreaID(1));
+	ASSERT_EQ(0u, *theMapper.getParentAreaID(2));
+	ASSERT_EQ(0u, *theMapper.getParentAreaID(3));
+	ASSERT_FALSE(theMapper.getParentAreaID(4));
+}
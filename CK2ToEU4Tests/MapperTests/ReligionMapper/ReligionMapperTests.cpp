@@ -10,7 +10,7 @@ TEST(Mappers_ReligionMapperTests, nonMatchGivesEmptyOptional)
 	mappers::ReligionMapper theMapper;
 	theMapper.initReligionMapper(input);
 
-	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion("nonMatchingReligion");
+	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion(parsing::Symbol("nonMatchingReligion"));
 	ASSERT_FALSE(eu4Religion);
 }
 
@@ -23,7 +23,7 @@ TEST(Mappers_ReligionMapperTests, eu4ReligionCanBeFound)
 	mappers::ReligionMapper theMapper;
 	theMapper.initReligionMapper(input);
 
-	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion("ck2Religion");
+	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion(parsing::Symbol("ck2Religion"));
 	ASSERT_EQ(eu4Religion, "eu4Religion");
 }
 
@@ -36,7 +36,7 @@ TEST(Mappers_ReligionMapperTests, multipleEU4ReligionsCanBeInARule)
 	mappers::ReligionMapper theMapper;
 	theMapper.initReligionMapper(input);
 
-	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion("ck2Religion2");
+	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion(parsing::Symbol("ck2Religion2"));
 	ASSERT_EQ(eu4Religion, "eu4Religion");
 }
 
@@ -50,6 +50,6 @@ TEST(Mappers_ReligionMapperTests, correctRuleMatches)
 	mappers::ReligionMapper theMapper;
 	theMapper.initReligionMapper(input);
 
-	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion("ck2Religion2");
+	const auto& eu4Religion = theMapper.getEu4ReligionForCk2Religion(parsing::Symbol("ck2Religion2"));
 	ASSERT_EQ(eu4Religion, "eu4Religion2");
 }
\ No newline at end of file
@@ -72,8 +72,8 @@ TEST(Mappers_RulerPersonalitiesMapperTests, evaluationReturnsEmptyForNoRulesAndL
 	std::stringstream charinput;
 	auto newCharacter = std::make_shared<CK2::Character>(charinput, 1);
 	auto charPair = std::pair(1, newCharacter);
-	std::map<int, std::string> traits = {{1, "trait1"}, {2, "trait2"}};
-	newCharacter->setTraits(traits);
+	const std::vector<std::string> traitNames{"trait1", "trait2"};
+	newCharacter->setTraits(CK2::TraitSet({1, 2}, traitNames));
 
 	auto returned = mapper.evaluatePersonalities(charPair);
 
@@ -94,8 +94,8 @@ TEST(Mappers_RulerPersonalitiesMapperTests, evaluationReturnsTwoBestPersonalitie
 	std::stringstream charinput;
 	auto newCharacter = std::make_shared<CK2::Character>(charinput, 1);
 	auto charPair = std::pair(1, newCharacter);
-	std::map<int, std::string> traits = {{1, "trait1"}, {2, "trait2"}, {3, "trait3"}};
-	newCharacter->setTraits(traits);
+	const std::vector<std::string> traitNames{"trait1", "trait2", "trait3"};
+	newCharacter->setTraits(CK2::TraitSet({1, 2, 3}, traitNames));
 
 	auto returned = mapper.evaluatePersonalities(charPair);
 
@@ -103,3 +103,26 @@ TEST(Mappers_RulerPersonalitiesMapperTests, evaluationReturnsTwoBestPersonalitie
 	ASSERT_EQ(returned.count("z-personality"), 1); // score 99
 	ASSERT_EQ(returned.count("c-personality"), 1); // score 50
 }
+
+TEST(Mappers_RulerPersonalitiesMapperTests, evaluationSumsEveryMatchingTraitOnce)
+{
+	std::stringstream input;
+	input << "z-personality = { trait1 = 10 }\n";
+	input << "a-personality = { trait1 = 5 trait2 = 10 }\n";
+	input << "p-personality = { trait3 = 12 }\n";
+	mappers::RulerPersonalitiesMapper mapper;
+	mapper.initRulerPersonalitiesMapper(input);
+
+	std::stringstream charinput;
+	auto newCharacter = std::make_shared<CK2::Character>(charinput, 1);
+	auto charPair = std::pair(1, newCharacter);
+	const std::vector<std::string> traitNames{"trait1", "trait2", "trait1"};
+	newCharacter->setTraits(CK2::TraitSet({1, 2, 3}, traitNames));
+
+	auto returned = mapper.evaluatePersonalities(charPair);
+
+	ASSERT_EQ(returned.size(), 2);
+	ASSERT_EQ(returned.count("a-personality"), 1); // score 15
+	ASSERT_EQ(returned.count("p-personality"), 0); // score 0
+	ASSERT_EQ(returned.count("z-personality"), 1); // score 10
+}
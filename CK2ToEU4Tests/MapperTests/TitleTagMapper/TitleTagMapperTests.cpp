@@ -64,6 +64,24 @@ TEST(Mappers_TitleTagMapperTests, canMatchTagsOnTitlesAndBaseTitles)
 	ASSERT_EQ(*match, "TST2");
 }
 
+TEST(Mappers_TitleTagMapperTests, sharedCapitalsHandOutTagsInFileOrderSkippingUsedOnes)
+{
+	std::stringstream input;
+	input << "link = { eu4 = TST ck2 = c_test capitals = { 3 } }\n";
+	input << "link = { eu4 = TST2 ck2 = c_test2 capitals = { 1 3 } }\n";
+	input << "link = { eu4 = TST3 ck2 = c_test3 capitals = { 3 } }";
+
+	mappers::TitleTagMapper theMapper;
+	theMapper.initTitleTagMapper(input);
+	const auto& match = theMapper.getTagForTitle("c_other", 3);
+	const auto& match2 = theMapper.getTagForTitle("c_other2", 3);
+	const auto& match3 = theMapper.getTagForTitle("c_test3", 3);
+
+	ASSERT_EQ(*match, "TST");
+	ASSERT_EQ(*match2, "TST2");
+	ASSERT_EQ(*match3, "TST3");
+}
+
 TEST(Mappers_TitleTagMapperTests, canGenerateNewTagsForMismatches)
 {
 	std::stringstream input;
@@ -146,3 +164,22 @@ TEST(Mappers_TitleTagMapperTests, matchOnChinaMismatchThroughFallback)
 
 	ASSERT_EQ(*match, "TST2");
 }
+
+TEST(Mappers_TitleTagMapperTests, mappersSharingRulesClaimTagsOnTheirOwn)
+{
+	std::stringstream input;
+	input << "link = { eu4 = TST ck2 = c_test }\n";
+	input << "link = { eu4 = TS2 ck2 = c_test }";
+	const auto rules = std::make_shared<const mappers::TitleTagRules>(input);
+
+	mappers::TitleTagMapper theMapper(rules);
+	mappers::TitleTagMapper otherMapper(rules);
+	theMapper.registerTitle("c_other", "TST");
+	const auto& match = theMapper.getTagForTitle("c_test");
+	const auto& otherMatch = otherMapper.getTagForTitle("c_test");
+
+	ASSERT_EQ(*match, "TS2");
+	ASSERT_EQ(*otherMatch, "TST");
+	ASSERT_TRUE(otherMapper.getRegisteredTitleTags().count("c_test"));
+	ASSERT_FALSE(otherMapper.getRegisteredTitleTags().count("c_other"));
+}
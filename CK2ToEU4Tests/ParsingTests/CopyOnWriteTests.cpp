@@ -0,0 +1,50 @@
+#include "../../CK2ToEU4/Source/Parsing/CopyOnWrite.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <string>
+
+TEST(Parsing_CopyOnWriteTests, valueDefaultsToDefaultConstructed)
+{
+	const parsing::CopyOnWrite<std::set<std::string>> discoveredBy;
+
+	ASSERT_TRUE(discoveredBy->empty());
+}
+
+TEST(Parsing_CopyOnWriteTests, copiesShareTheValueUntilEdited)
+{
+	const parsing::CopyOnWrite<std::set<std::string>> vanilla(std::set<std::string>{"western"});
+	auto copy = vanilla;
+
+	ASSERT_TRUE(copy.sharesWith(vanilla));
+	ASSERT_EQ(&*vanilla, &*copy);
+
+	copy.edit().insert("eastern");
+
+	ASSERT_FALSE(copy.sharesWith(vanilla));
+	ASSERT_EQ(std::set<std::string>{"western"}, *vanilla);
+	ASSERT_EQ((std::set<std::string>{"eastern", "western"}), *copy);
+}
+
+TEST(Parsing_CopyOnWriteTests, soleOwnerEditsInPlace)
+{
+	parsing::CopyOnWrite<std::set<std::string>> discoveredBy(std::set<std::string>{"western"});
+	const auto* before = &*discoveredBy;
+
+	discoveredBy.edit().insert("eastern");
+
+	ASSERT_EQ(before, &*discoveredBy);
+	ASSERT_EQ(2, discoveredBy->size());
+}
+
+TEST(Parsing_CopyOnWriteTests, sharedConstantIsNeverChanged)
+{
+	const auto groups = std::make_shared<const std::set<std::string>>(std::set<std::string>{"western"});
+	parsing::CopyOnWrite<std::set<std::string>> discoveredBy(groups);
+
+	ASSERT_EQ(groups.get(), &*discoveredBy);
+
+	discoveredBy.edit().insert("eastern");
+
+	ASSERT_EQ(std::set<std::string>{"western"}, *groups);
+	ASSERT_EQ(2, discoveredBy->size());
+}
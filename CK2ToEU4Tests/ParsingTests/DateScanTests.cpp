@@ -0,0 +1,25 @@
+#include "../../CK2ToEU4/Source/Parsing/DateScan.h"
+#include "gtest/gtest.h"
+
+TEST(Parsing_DateScanTests, plainDatesAreReadFieldByField)
+{
+	const auto theDate = parsing::parseDate("1066.9.15");
+
+	ASSERT_EQ(1066, theDate.getYear());
+	ASSERT_EQ(9, theDate.getMonth());
+	ASSERT_EQ(15, theDate.getDay());
+	ASSERT_EQ(date(1066, 9, 15), theDate);
+}
+
+TEST(Parsing_DateScanTests, parsedDatesMatchTheStringConstructor)
+{
+	ASSERT_EQ(date("1.1.1"), parsing::parseDate("1.1.1"));
+	ASSERT_EQ(date("1444.11.11"), parsing::parseDate("1444.11.11"));
+	ASSERT_EQ(date("769.1.1"), parsing::parseDate("769.1.1"));
+}
+
+TEST(Parsing_DateScanTests, irregularDatesFallBackToTheStringConstructor)
+{
+	ASSERT_EQ(date("1066.9"), parsing::parseDate("1066.9"));
+	ASSERT_EQ(date("1066"), parsing::parseDate("1066"));
+}
@@ -0,0 +1,51 @@
+#include "../../CK2ToEU4/Source/Parsing/FlatSet.h"
+#include "../../CK2ToEU4/Source/Parsing/Symbol.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(Parsing_FlatSetTests, flatSetDefaultsToEmpty)
+{
+	const parsing::FlatSet<int> electors;
+
+	ASSERT_TRUE(electors.empty());
+	ASSERT_EQ(0, electors.size());
+	ASSERT_EQ(0, electors.count(1));
+}
+
+TEST(Parsing_FlatSetTests, insertKeepsOrderAndDropsDuplicates)
+{
+	parsing::FlatSet<int> electors;
+
+	ASSERT_TRUE(electors.insert(3).second);
+	ASSERT_TRUE(electors.insert(1).second);
+	ASSERT_FALSE(electors.insert(3).second);
+	const std::vector<int> more = {2, 1, 5, 2};
+	electors.insert(more.begin(), more.end());
+
+	ASSERT_EQ(std::vector<int>({1, 2, 3, 5}), std::vector<int>(electors.begin(), electors.end()));
+	ASSERT_EQ(1, electors.count(5));
+	ASSERT_EQ(0, electors.count(4));
+}
+
+TEST(Parsing_FlatSetTests, eraseRemovesOnlyPresentKeys)
+{
+	parsing::FlatSet<int> electors = {1, 2, 3};
+
+	ASSERT_EQ(1, electors.erase(2));
+	ASSERT_EQ(0, electors.erase(4));
+	ASSERT_EQ(std::vector<int>({1, 3}), std::vector<int>(electors.begin(), electors.end()));
+}
+
+TEST(Parsing_FlatSetTests, transparentSetsFindSymbolsByString)
+{
+	parsing::FlatSet<parsing::Symbol, std::less<>> laws;
+	laws.emplace("succ_tanistry");
+	laws.emplace("centralization_4");
+	laws.emplace("law_voting_power_1");
+
+	ASSERT_EQ(1, laws.count("centralization_4"));
+	ASSERT_EQ(0, laws.count("centralization_3"));
+	ASSERT_TRUE(laws.contains(std::string("law_voting_power_1")));
+	ASSERT_EQ("centralization_4", *laws.begin());
+	ASSERT_EQ("succ_tanistry", *laws.rbegin());
+}
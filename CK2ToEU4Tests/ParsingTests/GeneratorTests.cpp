@@ -0,0 +1,57 @@
+#include "../../CK2ToEU4/Source/Parsing/Generator.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+parsing::Generator<int> countTo(const int last, int& produced)
+{
+	for (auto number = 1; number <= last; ++number)
+	{
+		++produced;
+		co_yield number;
+	}
+}
+
+parsing::Generator<int> failAfterOne()
+{
+	co_yield 1;
+	throw std::runtime_error("broken entry");
+}
+} // namespace
+
+TEST(Parsing_GeneratorTests, valuesArePulledInOrder)
+{
+	auto produced = 0;
+	std::vector<int> numbers;
+	for (const auto number: countTo(3, produced))
+		numbers.push_back(number);
+
+	ASSERT_EQ((std::vector{1, 2, 3}), numbers);
+}
+
+TEST(Parsing_GeneratorTests, nothingRunsUntilPulledAndStoppingStopsProducing)
+{
+	auto produced = 0;
+	auto numbers = countTo(1000, produced);
+	ASSERT_EQ(0, produced);
+
+	for (const auto number: numbers)
+		if (number == 2)
+			break;
+
+	ASSERT_EQ(2, produced);
+}
+
+TEST(Parsing_GeneratorTests, exceptionsReachTheConsumer)
+{
+	std::vector<int> numbers;
+	EXPECT_THROW(
+		 {
+			 for (const auto number: failAfterOne())
+				 numbers.push_back(number);
+		 },
+		 std::runtime_error);
+	ASSERT_EQ(std::vector{1}, numbers);
+}
@@ -0,0 +1,119 @@
+#include "../../CK2ToEU4/Source/CK2World/SaveGame/SaveBuffer.h"
+#include "../../CK2ToEU4/Source/Parsing/ItemSkipper.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+namespace
+{
+std::string measured(const std::string& input)
+{
+	return input.substr(0, parsing::ItemSkipper::measure(input));
+}
+} // namespace
+
+TEST(Parsing_ItemSkipperTests, blocksAreSkippedToTheirClosingBrace)
+{
+	const std::string input = " = { war = { name = \"War for {Paris}\" attacker = { 1 2 } } history = { } } next = 1";
+
+	ASSERT_EQ(" = { war = { name = \"War for {Paris}\" attacker = { 1 2 } } history = { } }", measured(input));
+}
+
+TEST(Parsing_ItemSkipperTests, longBlocksAreScannedInFull)
+{
+	std::string input = "= {";
+	for (auto i = 0; i < 100; ++i)
+		input += " event = { id = 12345 scope = { char = 7 } }";
+	input += " } next = 1";
+
+	ASSERT_EQ(input.substr(0, input.size() - 9), measured(input));
+}
+
+TEST(Parsing_ItemSkipperTests, simpleValuesAreSkipped)
+{
+	ASSERT_EQ("= 1066.9.15", measured("= 1066.9.15 next = 1"));
+	ASSERT_EQ("= \"some } thing\"", measured("= \"some } thing\" next = 1"));
+	ASSERT_EQ("=yes", measured("=yes}"));
+}
+
+TEST(Parsing_ItemSkipperTests, colorsAreSkippedWithTheirComponents)
+{
+	ASSERT_EQ("= rgb { 10 20 30 }", measured("= rgb { 10 20 30 } next = 1"));
+	ASSERT_EQ("= hsv{ 0.1 0.2 0.3 }", measured("= hsv{ 0.1 0.2 0.3 } next = 1"));
+	ASSERT_EQ("= rgbish", measured("= rgbish { next = 1 }"));
+}
+
+TEST(Parsing_ItemSkipperTests, commentsDontCountBraces)
+{
+	ASSERT_EQ("= { # closing } early\n\tvalue = 1 }", measured("= { # closing } early\n\tvalue = 1 } next = 1"));
+	ASSERT_EQ("# { not a block\n= 2", measured("# { not a block\n= 2 next = 1"));
+}
+
+TEST(Parsing_ItemSkipperTests, missingValueLeavesClosingBraceAlone)
+{
+	ASSERT_EQ(" ", measured(" } next = 1"));
+}
+
+TEST(Parsing_ItemSkipperTests, scanResumesAcrossPieces)
+{
+	const std::string input = "= { name = \"a { b\" # }\n inner = { rgb } } next = 1";
+	const auto wholeLength = parsing::ItemSkipper::measure(input);
+
+	parsing::ItemSkipper skipper;
+	std::size_t length = 0;
+	for (std::size_t position = 0; position < input.size() && !skipper.done(); position += 3)
+		length += skipper.scan(std::string_view(input).substr(position, 3));
+
+	ASSERT_TRUE(skipper.done());
+	ASSERT_EQ(wholeLength, length);
+}
+
+TEST(Parsing_ItemSkipperTests, ignoreItemSkipsInMemoryStreams)
+{
+	const std::string input = " = { a = { b = c } } next";
+	CK2::SaveBuffer buffer(input.data(), input.size());
+	std::istream theStream(&buffer);
+
+	parsing::ignoreItem("unused", theStream);
+
+	std::string rest;
+	theStream >> rest;
+	ASSERT_EQ("next", rest);
+}
+
+TEST(Parsing_ItemSkipperTests, ignoreItemSkipsOtherStreams)
+{
+	std::stringstream input;
+	input << " = { a = { b = \"}\" } } next";
+
+	parsing::ignoreItem("unused", input);
+
+	std::string rest;
+	input >> rest;
+	ASSERT_EQ("next", rest);
+}
+
+TEST(Parsing_ItemSkipperTests, ignoreItemStopsAtEndOfStream)
+{
+	std::stringstream input;
+	input << " = { a = { b = c }";
+
+	parsing::ignoreItem("unused", input);
+
+	ASSERT_TRUE(input.eof());
+}
+
+TEST(Parsing_ItemSkipperTests, captureKeepsTheItemAsWritten)
+{
+	const std::string input = " = { a = { b = c } # }\n} next";
+	CK2::SaveBuffer buffer(input.data(), input.size());
+	std::istream theStream(&buffer);
+	std::stringstream otherStream;
+	otherStream << input;
+
+	ASSERT_EQ(" = { a = { b = c } # }\n}", parsing::ItemSkipper::capture(theStream));
+	ASSERT_EQ(" = { a = { b = c } # }\n}", parsing::ItemSkipper::capture(otherStream));
+
+	std::string rest;
+	otherStream >> rest;
+	ASSERT_EQ("next", rest);
+}
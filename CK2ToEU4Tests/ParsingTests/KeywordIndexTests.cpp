@@ -0,0 +1,51 @@
+#include "../../CK2ToEU4/Source/Parsing/KeywordIndex.h"
+#include "gtest/gtest.h"
+
+TEST(Parsing_KeywordIndexTests, emptyIndexFindsNothing)
+{
+	const parsing::KeywordIndex<int> index;
+
+	ASSERT_EQ(nullptr, index.find("bn"));
+	ASSERT_EQ(nullptr, index.find(""));
+}
+
+TEST(Parsing_KeywordIndexTests, everyKeywordFindsItsOwnValue)
+{
+	const std::vector<std::string> keywords =
+		 {"bn", "cul", "rel", "fem", "gov", "job", "md", "tr", "b_d", "d_d", "dnt", "lge", "mot", "fat", "dyn", "prs", "piety", "wealth", "spouse",
+			  "host", "emp", "primary", "lifestyle_traits", "player_dynasty_name", "historical_monarch_name"};
+	parsing::KeywordIndex<std::size_t> index;
+	for (std::size_t value = 0; value < keywords.size(); ++value)
+		index.insert(keywords[value], value);
+
+	ASSERT_EQ(keywords.size(), index.size());
+	for (std::size_t value = 0; value < keywords.size(); ++value)
+	{
+		const auto* found = index.find(keywords[value]);
+		ASSERT_NE(nullptr, found) << keywords[value];
+		EXPECT_EQ(value, *found) << keywords[value];
+	}
+}
+
+TEST(Parsing_KeywordIndexTests, nearMissesAreNotFound)
+{
+	parsing::KeywordIndex<int> index;
+	index.insert("b_d", 1);
+	index.insert("historical_monarch_name", 2);
+
+	ASSERT_EQ(nullptr, index.find("b_"));
+	ASSERT_EQ(nullptr, index.find("b_dd"));
+	ASSERT_EQ(nullptr, index.find("d_d"));
+	ASSERT_EQ(nullptr, index.find("historical_monarch_nam"));
+	ASSERT_EQ(nullptr, index.find("historical_monarch_namf"));
+}
+
+TEST(Parsing_KeywordIndexTests, firstValueForAKeywordStays)
+{
+	parsing::KeywordIndex<int> index;
+	index.insert("bn", 1);
+	index.insert("bn", 2);
+
+	ASSERT_EQ(1, index.size());
+	ASSERT_EQ(1, *index.find("bn"));
+}
@@ -0,0 +1,86 @@
+#include "../../CK2ToEU4/Source/Parsing/KeywordTable.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+namespace
+{
+struct TestEntity
+{
+	std::string name;
+	std::vector<std::string> prefixed;
+	int count = 0;
+};
+
+parsing::KeywordTable<TestEntity> testTable()
+{
+	parsing::KeywordTable<TestEntity> keywordTable;
+	keywordTable.registerKeyword("name", [](TestEntity& entity, const std::string& unused, std::istream& theStream) {
+		entity.name = commonItems::singleString(theStream).getString();
+	});
+	keywordTable.registerRegex("b_[a-z]+", [](TestEntity& entity, const std::string& key, std::istream& theStream) {
+		entity.prefixed.emplace_back(key);
+		commonItems::ignoreItem(key, theStream);
+	});
+	keywordTable.ignoreUnregistered();
+	return keywordTable;
+}
+} // namespace
+
+TEST(Parsing_KeywordTableTests, keywordsAndRegexesDispatch)
+{
+	std::stringstream input;
+	input << "= { name = \"Bob\" b_one = { a = b } b_two = yes unknown = { name = \"Not Bob\" } }";
+	static const auto keywordTable = testTable();
+	TestEntity entity;
+
+	keywordTable.parseStream(entity, input);
+
+	ASSERT_EQ("Bob", entity.name);
+	ASSERT_EQ(2, entity.prefixed.size());
+	ASSERT_EQ("b_one", entity.prefixed[0]);
+	ASSERT_EQ("b_two", entity.prefixed[1]);
+}
+
+TEST(Parsing_KeywordTableTests, quotedKeywordsAreMatched)
+{
+	std::stringstream input;
+	input << "= { \"name\" = Alice }";
+	static const auto keywordTable = testTable();
+	TestEntity entity;
+
+	keywordTable.parseStream(entity, input);
+
+	ASSERT_EQ("Alice", entity.name);
+}
+
+TEST(Parsing_KeywordTableTests, parsingStopsAtClosingBrace)
+{
+	std::stringstream input;
+	input << "= { name = first } name = second";
+	static const auto keywordTable = testTable();
+	TestEntity entity;
+
+	keywordTable.parseStream(entity, input);
+	std::string rest;
+	std::getline(input, rest);
+
+	ASSERT_EQ("first", entity.name);
+	ASSERT_EQ(" name = second", rest);
+}
+
+TEST(Parsing_KeywordTableTests, tableIsReusableAcrossEntities)
+{
+	static const auto keywordTable = testTable();
+	std::stringstream input1;
+	input1 << "= { name = one }";
+	std::stringstream input2;
+	input2 << "= { name = two }";
+	TestEntity entity1;
+	TestEntity entity2;
+
+	keywordTable.parseStream(entity1, input1);
+	keywordTable.parseStream(entity2, input2);
+
+	ASSERT_EQ("one", entity1.name);
+	ASSERT_EQ("two", entity2.name);
+}
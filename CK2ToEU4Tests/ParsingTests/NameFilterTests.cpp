@@ -0,0 +1,30 @@
+#include "../../CK2ToEU4/Source/Parsing/NameFilter.h"
+#include "gtest/gtest.h"
+
+TEST(Parsing_NameFilterTests, defaultFilterAdmitsEverything)
+{
+	const parsing::NameFilter filter;
+
+	ASSERT_TRUE(filter.admits("anything"));
+	ASSERT_TRUE(filter.admits(""));
+}
+
+TEST(Parsing_NameFilterTests, namesAreMatchedExactly)
+{
+	const parsing::NameFilter filter{"zun_reformation", "aztec_explorers"};
+
+	ASSERT_TRUE(filter.admits("aztec_explorers"));
+	ASSERT_TRUE(filter.admits("zun_reformation"));
+	ASSERT_FALSE(filter.admits("aztec_explorers_2"));
+	ASSERT_FALSE(filter.admits("zun"));
+}
+
+TEST(Parsing_NameFilterTests, prefixesMatchTheirWholeFamily)
+{
+	const parsing::NameFilter filter({"exact"}, {"global_chinese_"});
+
+	ASSERT_TRUE(filter.admits("global_chinese_sunnis"));
+	ASSERT_TRUE(filter.admits("exact"));
+	ASSERT_FALSE(filter.admits("global_chinese"));
+	ASSERT_FALSE(filter.admits("local_chinese_sunnis"));
+}
@@ -0,0 +1,58 @@
+#include "../../CK2ToEU4/Source/Parsing/NameMap.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST(Parsing_NameMapTests, iteratesInNameOrder)
+{
+	parsing::NameMap<int> countries;
+	countries.emplace("SWE", 3);
+	countries.emplace("FRA", 1);
+	countries["MGE"] = 2;
+
+	std::vector<std::string> tags;
+	for (const auto& [tag, value]: countries)
+		tags.emplace_back(tag);
+
+	ASSERT_EQ((std::vector<std::string>{"FRA", "MGE", "SWE"}), tags);
+}
+
+TEST(Parsing_NameMapTests, findsByStringView)
+{
+	parsing::NameMap<int> titles{{"k_france", 1}, {"e_hre", 2}};
+	const std::string_view wanted = "k_france and more";
+
+	ASSERT_EQ(1, titles.find(wanted.substr(0, 8))->second);
+	ASSERT_EQ(2, titles.at("e_hre"));
+	ASSERT_TRUE(titles.contains("e_hre"));
+	ASSERT_EQ(0, titles.count("k_dummy"));
+	ASSERT_EQ(titles.end(), titles.find("k_dummy"));
+	ASSERT_THROW(static_cast<void>(titles.at("k_dummy")), std::out_of_range);
+}
+
+TEST(Parsing_NameMapTests, erasedNamesAreNotFound)
+{
+	parsing::NameMap<int> titles{{"k_france", 1}, {"e_hre", 2}};
+
+	ASSERT_EQ(1, titles.erase("k_france"));
+	ASSERT_EQ(0, titles.erase("k_france"));
+	titles.erase(titles.find("e_hre"));
+
+	ASSERT_TRUE(titles.empty());
+	ASSERT_FALSE(titles.contains("k_france"));
+	ASSERT_FALSE(titles.contains("e_hre"));
+}
+
+TEST(Parsing_NameMapTests, copiesFindTheirOwnEntries)
+{
+	parsing::NameMap<int> countries{{"FRA", 1}};
+	auto copy = countries;
+	copy["FRA"] = 2;
+	auto moved = std::move(copy);
+	moved.insert_or_assign("FRA", 3);
+
+	ASSERT_EQ(1, countries.at("FRA"));
+	ASSERT_EQ(3, moved.at("FRA"));
+	ASSERT_EQ(1, moved.size());
+}
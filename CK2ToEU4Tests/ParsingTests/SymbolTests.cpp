@@ -0,0 +1,114 @@
+#include "../../CK2ToEU4/Source/Parsing/Symbol.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <sstream>
+#include <thread>
+
+TEST(Parsing_SymbolTests, defaultSymbolIsEmpty)
+{
+	const parsing::Symbol symbol;
+
+	ASSERT_TRUE(symbol.empty());
+	ASSERT_EQ(parsing::Symbol(""), symbol);
+	ASSERT_EQ("", symbol);
+}
+
+TEST(Parsing_SymbolTests, sameSpellingSharesOneEntry)
+{
+	const std::string spelling = "catholic";
+	const parsing::Symbol first(spelling);
+	const parsing::Symbol second("catholic");
+
+	ASSERT_EQ(first, second);
+	ASSERT_EQ(&first.str(), &second.str());
+	ASSERT_NE(parsing::Symbol("orthodox"), first);
+}
+
+TEST(Parsing_SymbolTests, symbolsCompareWithPlainStrings)
+{
+	const parsing::Symbol symbol("agnatic");
+
+	ASSERT_EQ(symbol, "agnatic");
+	ASSERT_EQ(std::string("agnatic"), symbol);
+	ASSERT_EQ(std::string_view("agnatic"), symbol);
+	ASSERT_NE(symbol, "cognatic");
+	const std::string& spelling = symbol;
+	ASSERT_EQ("agnatic", spelling);
+}
+
+TEST(Parsing_SymbolTests, setsOrderBySpellingAndFindByString)
+{
+	const std::set<parsing::Symbol, std::less<>> laws = {parsing::Symbol("succ_tanistry"), parsing::Symbol("centralization_4"), parsing::Symbol("law_voting_power_1")};
+
+	ASSERT_EQ(1, laws.count("centralization_4"));
+	ASSERT_EQ(0, laws.count("centralization_3"));
+	ASSERT_EQ("centralization_4", *laws.begin());
+	ASSERT_EQ("succ_tanistry", *laws.rbegin());
+}
+
+TEST(Parsing_SymbolTests, symbolsPrintTheirSpelling)
+{
+	std::stringstream output;
+	output << parsing::Symbol("nomadic_government");
+
+	ASSERT_EQ("nomadic_government", output.str());
+}
+
+TEST(Parsing_SymbolTests, concurrentInterningAgrees)
+{
+	std::vector<parsing::Symbol> left(200);
+	std::vector<parsing::Symbol> right(200);
+	auto intern = [](std::vector<parsing::Symbol>& symbols) {
+		for (auto index = 0; index < static_cast<int>(symbols.size()); ++index)
+			symbols[index] = parsing::Symbol("concurrent_" + std::to_string(index));
+	};
+
+	std::thread leftThread(intern, std::ref(left));
+	std::thread rightThread(intern, std::ref(right));
+	leftThread.join();
+	rightThread.join();
+
+	ASSERT_EQ(left, right);
+}
+
+TEST(Parsing_SymbolTests, symbolsComeBackFromTheirIDs)
+{
+	const parsing::Symbol culture("norse");
+	const parsing::Symbol religion("norse_pagan");
+
+	ASSERT_NE(culture.id(), religion.id());
+	ASSERT_EQ(culture, parsing::Symbol::fromID(culture.id()));
+	ASSERT_EQ(religion, parsing::Symbol::fromID(religion.id()));
+	ASSERT_EQ(0u, parsing::Symbol().id());
+	ASSERT_TRUE(parsing::Symbol::fromID(0).empty());
+	ASSERT_THROW(static_cast<void>(parsing::Symbol::fromID(0xFFFFFFF0)), std::out_of_range);
+	ASSERT_EQ(std::string_view("norse"), culture.view());
+}
+
+TEST(Parsing_SymbolTests, renumberingKeepsTheSpellingOrder)
+{
+	const parsing::Symbol zeta("renumbered_zeta");
+	const parsing::Symbol alpha("renumbered_alpha");
+	ASSERT_EQ(0u, alpha.ordinal());
+	parsing::Symbol::renumber();
+
+	// Numbered by spelling, not in the order they were interned.
+	ASSERT_NE(0u, alpha.ordinal());
+	ASSERT_LT(alpha.ordinal(), zeta.ordinal());
+	const auto alphaOrdinal = alpha.ordinal();
+	const auto zetaOrdinal = zeta.ordinal();
+
+	// Interned after, so left unnumbered even by a second call and compared by spelling.
+	const parsing::Symbol beta("renumbered_beta");
+	parsing::Symbol::renumber();
+	ASSERT_EQ(0u, beta.ordinal());
+	ASSERT_EQ(alphaOrdinal, alpha.ordinal());
+	ASSERT_EQ(zetaOrdinal, zeta.ordinal());
+
+	ASSERT_LT(alpha, zeta);
+	ASSERT_LT(alpha, beta);
+	ASSERT_LT(beta, zeta);
+	ASSERT_GT(zeta, alpha);
+	const std::set<parsing::Symbol> ordered{zeta, beta, alpha};
+	ASSERT_EQ(std::vector({alpha, beta, zeta}), std::vector(ordered.begin(), ordered.end()));
+}
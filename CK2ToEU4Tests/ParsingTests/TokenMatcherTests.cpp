@@ -0,0 +1,67 @@
+#include "../../CK2ToEU4/Source/Parsing/TokenMatcher.h"
+#include "gtest/gtest.h"
+
+TEST(Parsing_TokenMatcherTests, digitsMatchOnlyNumbers)
+{
+	const auto matcher = parsing::TokenMatcher::digits();
+
+	ASSERT_TRUE(matcher.matches("0"));
+	ASSERT_TRUE(matcher.matches("123456"));
+	ASSERT_FALSE(matcher.matches(""));
+	ASSERT_FALSE(matcher.matches("-1"));
+	ASSERT_FALSE(matcher.matches("12a"));
+	ASSERT_FALSE(matcher.matches("b_12"));
+}
+
+TEST(Parsing_TokenMatcherTests, charactersMatchIdentifiers)
+{
+	const auto matcher = parsing::TokenMatcher::characters(parsing::TokenMatcher::identifierCharacters);
+
+	ASSERT_TRUE(matcher.matches("k_england"));
+	ASSERT_TRUE(matcher.matches("c_al-andalus"));
+	ASSERT_TRUE(matcher.matches("42"));
+	ASSERT_FALSE(matcher.matches(""));
+	ASSERT_FALSE(matcher.matches("k_eng land"));
+	ASSERT_FALSE(matcher.matches("\"k_england\""));
+}
+
+TEST(Parsing_TokenMatcherTests, prefixedMatchesAnyPrefixFollowedByTail)
+{
+	const auto matcher = parsing::TokenMatcher::prefixed({"e_", "k_", "d_", "c_"});
+
+	ASSERT_TRUE(matcher.matches("e_hre"));
+	ASSERT_TRUE(matcher.matches("k_england"));
+	ASSERT_TRUE(matcher.matches("d_york"));
+	ASSERT_TRUE(matcher.matches("c_al-andalus"));
+	ASSERT_FALSE(matcher.matches("b_london"));
+	ASSERT_FALSE(matcher.matches("ke_nope"));
+	ASSERT_FALSE(matcher.matches("k_eng.land"));
+}
+
+TEST(Parsing_TokenMatcherTests, prefixedRejectsEmptyTail)
+{
+	const auto matcher = parsing::TokenMatcher::prefixed({"b_"});
+
+	ASSERT_FALSE(matcher.matches("b_"));
+	ASSERT_FALSE(matcher.matches("b"));
+	ASSERT_TRUE(matcher.matches("b_x"));
+}
+
+TEST(Parsing_TokenMatcherTests, prefixedTailCanBeRestricted)
+{
+	const auto matcher = parsing::TokenMatcher::prefixed({"diplo_"}, "0123456789");
+
+	ASSERT_TRUE(matcher.matches("diplo_12345"));
+	ASSERT_FALSE(matcher.matches("diplo_12a"));
+	ASSERT_FALSE(matcher.matches("diplo_"));
+	ASSERT_FALSE(matcher.matches("12345"));
+}
+
+TEST(Parsing_TokenMatcherTests, regexFallbackMatchesWholeToken)
+{
+	const auto matcher = parsing::TokenMatcher::regex("[a-z]+_[0-9]{2}");
+
+	ASSERT_TRUE(matcher.matches("abc_12"));
+	ASSERT_FALSE(matcher.matches("abc_123"));
+	ASSERT_FALSE(matcher.matches("xabc_12y "));
+}
@@ -0,0 +1,74 @@
+#include "../../CK2ToEU4/Source/Parsing/TokenTable.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+struct TestEntity
+{
+	std::string name;
+	int age = 0;
+	std::vector<std::string> numbers;
+	std::vector<TestEntity> children;
+
+	static parsing::TokenTable<TestEntity> registerKeys()
+	{
+		parsing::TokenTable<TestEntity> tokenTable;
+		tokenTable.registerKeyword("name", [](TestEntity& entity, std::string_view unused, parsing::Tokenizer& tokens) {
+			entity.name = tokens.getString();
+		});
+		tokenTable.registerKeyword("age", [](TestEntity& entity, std::string_view unused, parsing::Tokenizer& tokens) {
+			entity.age = tokens.getInt();
+		});
+		tokenTable.registerKeyword("child", [](TestEntity& entity, std::string_view unused, parsing::Tokenizer& tokens) {
+			entity.children.emplace_back(parse(tokens));
+		});
+		tokenTable.registerMatcher(parsing::TokenMatcher::digits(), [](TestEntity& entity, const std::string_view number, parsing::Tokenizer& tokens) {
+			entity.numbers.emplace_back(number);
+			tokens.skipItem();
+		});
+		tokenTable.ignoreUnregistered();
+		return tokenTable;
+	}
+
+	static TestEntity parse(parsing::Tokenizer& tokens)
+	{
+		static const auto tokenTable = registerKeys();
+		TestEntity entity;
+		tokenTable.parse(entity, tokens);
+		return entity;
+	}
+};
+} // namespace
+
+TEST(Parsing_TokenTableTests, keywordsAndMatchersAreDispatched)
+{
+	parsing::Tokenizer tokens("name = \"Charles\" age = 42 7 = { a } 9 = yes");
+
+	const auto entity = TestEntity::parse(tokens);
+
+	ASSERT_EQ("Charles", entity.name);
+	ASSERT_EQ(42, entity.age);
+	ASSERT_EQ((std::vector<std::string>{"7", "9"}), entity.numbers);
+}
+
+TEST(Parsing_TokenTableTests, unregisteredItemsAreSkipped)
+{
+	parsing::Tokenizer tokens("history = { name = \"Wrong\" } name = Right wars = { { } }");
+
+	const auto entity = TestEntity::parse(tokens);
+
+	ASSERT_EQ("Right", entity.name);
+}
+
+TEST(Parsing_TokenTableTests, nestedBlocksEndAtTheirClosingBrace)
+{
+	parsing::Tokenizer tokens("child = { name = Pepin age = 3 } child = { name = Carloman } name = Charles");
+
+	const auto entity = TestEntity::parse(tokens);
+
+	ASSERT_EQ("Charles", entity.name);
+	ASSERT_EQ(2, entity.children.size());
+	ASSERT_EQ("Pepin", entity.children[0].name);
+	ASSERT_EQ(3, entity.children[0].age);
+	ASSERT_EQ("Carloman", entity.children[1].name);
+}
@@ -0,0 +1,89 @@
+#include "../../CK2ToEU4/Source/Parsing/Tokenizer.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+using TokenType = parsing::Tokenizer::TokenType;
+}
+
+TEST(Parsing_TokenizerTests, operatorsBracesAndWordsAreSplit)
+{
+	parsing::Tokenizer tokens("key={ 12 b_paris }");
+
+	const std::vector<std::pair<TokenType, std::string_view>> expected = {
+		 {TokenType::WORD, "key"},
+		 {TokenType::EQUALS, "="},
+		 {TokenType::OPEN, "{"},
+		 {TokenType::WORD, "12"},
+		 {TokenType::WORD, "b_paris"},
+		 {TokenType::CLOSE, "}"},
+	};
+	for (const auto& [type, text]: expected)
+	{
+		const auto token = tokens.next();
+		EXPECT_EQ(type, token.type);
+		EXPECT_EQ(text, token.text);
+	}
+	ASSERT_TRUE(tokens.atEnd());
+}
+
+TEST(Parsing_TokenizerTests, quotedStringsKeepTheirContents)
+{
+	parsing::Tokenizer tokens("name = \"Jean { de } Paris\" next");
+
+	tokens.next();
+	tokens.next();
+	const auto token = tokens.next();
+
+	ASSERT_EQ(TokenType::QUOTED, token.type);
+	ASSERT_EQ("Jean { de } Paris", token.text);
+	ASSERT_EQ("next", tokens.next().text);
+}
+
+TEST(Parsing_TokenizerTests, commentsAndWhitespaceAreSkipped)
+{
+	parsing::Tokenizer tokens("  # a comment = { \n\t\r\n   word # trailing\n# last");
+
+	ASSERT_EQ("word", tokens.next().text);
+	ASSERT_TRUE(tokens.atEnd());
+}
+
+TEST(Parsing_TokenizerTests, longWordsAreReadWhole)
+{
+	const std::string word = "a_very_long_identifier_that_spans_several_scan_steps";
+	const auto input = "   \t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" + word + "=1";
+	parsing::Tokenizer tokens(input);
+
+	ASSERT_EQ(word, tokens.next().text);
+	ASSERT_EQ(TokenType::EQUALS, tokens.next().type);
+}
+
+TEST(Parsing_TokenizerTests, peekDoesNotAdvance)
+{
+	parsing::Tokenizer tokens("first second");
+
+	ASSERT_EQ("first", tokens.peek().text);
+	ASSERT_EQ("first", tokens.next().text);
+	ASSERT_EQ("second", tokens.next().text);
+}
+
+TEST(Parsing_TokenizerTests, valueHelpersReadSingleItems)
+{
+	parsing::Tokenizer tokens("= \"FRA\" = 12 = +3 = { a \"b c\" d } = nonsense");
+
+	ASSERT_EQ("FRA", tokens.getString());
+	ASSERT_EQ(12, tokens.getInt());
+	ASSERT_EQ(3, tokens.getInt());
+	ASSERT_EQ((std::vector<std::string_view>{"a", "b c", "d"}), tokens.getStrings());
+	ASSERT_EQ(0, tokens.getInt());
+	ASSERT_TRUE(tokens.atEnd());
+}
+
+TEST(Parsing_TokenizerTests, itemsCanBeSkippedOrTakenRaw)
+{
+	parsing::Tokenizer tokens("= { ignored = { deep } } = rgb { 1 2 3 } last");
+
+	tokens.skipItem();
+	ASSERT_EQ(" = rgb { 1 2 3 }", tokens.getItem());
+	ASSERT_EQ("last", tokens.next().text);
+}
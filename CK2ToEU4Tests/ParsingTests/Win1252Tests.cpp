@@ -0,0 +1,43 @@
+#include "../../CK2ToEU4/Source/Parsing/Win1252.h"
+#include "gtest/gtest.h"
+
+TEST(Parsing_Win1252Tests, asciiPassesThrough)
+{
+	const std::string text = "k_england: \"Kingdom of England\" with enough text to cross a few chunks\n";
+
+	ASSERT_EQ(text, parsing::win1252ToUTF8(text));
+}
+
+TEST(Parsing_Win1252Tests, latinOneBytesBecomeTwoByteSequences)
+{
+	ASSERT_EQ("Z\xC3\xBCrich", parsing::win1252ToUTF8("Z\xFCrich"));
+	ASSERT_EQ("\xC2\xA0\xC3\xBF", parsing::win1252ToUTF8("\xA0\xFF"));
+}
+
+TEST(Parsing_Win1252Tests, windowsSpecialsAreMapped)
+{
+	ASSERT_EQ("\xE2\x82\xAC", parsing::win1252ToUTF8("\x80"));		// euro sign
+	ASSERT_EQ("\xC5\xA0", parsing::win1252ToUTF8("\x8A"));			// S with caron
+	ASSERT_EQ("\xE2\x80\x9Ci\xE2\x80\x9D", parsing::win1252ToUTF8("\x93i\x94")); // curly quotes
+	ASSERT_EQ("\xC5\xB8", parsing::win1252ToUTF8("\x9F"));			// Y with diaeresis
+}
+
+TEST(Parsing_Win1252Tests, undefinedBytesBecomeControlCodes)
+{
+	ASSERT_EQ("\xC2\x81\xC2\x9D", parsing::win1252ToUTF8("\x81\x9D"));
+}
+
+TEST(Parsing_Win1252Tests, highBytesPastTheFirstChunkAreFound)
+{
+	const std::string ascii(37, 'a');
+
+	ASSERT_EQ(ascii + "\xC3\xA9" + ascii, parsing::win1252ToUTF8(ascii + "\xE9" + ascii));
+}
+
+TEST(Parsing_Win1252Tests, appendKeepsWhatIsThere)
+{
+	std::string output = "\xEF\xBB\xBFl_english:\n";
+	parsing::appendWin1252AsUTF8(output, " A: \"\xC9ire\"\n");
+
+	ASSERT_EQ("\xEF\xBB\xBFl_english:\n A: \"\xC3\x89ire\"\n", output);
+}
@@ -0,0 +1,45 @@
+#include "../CK2ToEU4/Source/Configuration/SaveFolder.h"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+
+TEST(CK2ToEU4_SaveFolderTests, NewSavesAreTakenOnceSettled)
+{
+	std::filesystem::remove_all("saveFolder");
+	std::filesystem::create_directories("saveFolder");
+	std::ofstream("saveFolder/old.ck2") << "CK2txt\n";
+	SaveFolder saveFolder("saveFolder");
+
+	std::ofstream("saveFolder/new.ck2") << "CK2txt\n";
+	std::ofstream("saveFolder/notes.txt") << "not a save\n";
+	EXPECT_TRUE(saveFolder.takeSettledSaves().empty());
+
+	EXPECT_EQ(std::vector<std::string>{"saveFolder/new.ck2"}, saveFolder.takeSettledSaves());
+	EXPECT_TRUE(saveFolder.takeSettledSaves().empty());
+	std::filesystem::remove_all("saveFolder");
+}
+
+TEST(CK2ToEU4_SaveFolderTests, OverwrittenSavesAreTakenAgain)
+{
+	std::filesystem::remove_all("saveFolder");
+	std::filesystem::create_directories("saveFolder");
+	std::ofstream("saveFolder/autosave.ck2") << "CK2txt\n";
+	SaveFolder saveFolder("saveFolder");
+
+	std::ofstream("saveFolder/autosave.ck2") << "CK2txt\nversion=\"2.8.3.2\"\n";
+	EXPECT_TRUE(saveFolder.takeSettledSaves().empty());
+	// Still being written.
+	std::ofstream("saveFolder/autosave.ck2", std::ios::app) << "date=\"1100.1.1\"\n";
+	EXPECT_TRUE(saveFolder.takeSettledSaves().empty());
+
+	EXPECT_EQ(std::vector<std::string>{"saveFolder/autosave.ck2"}, saveFolder.takeSettledSaves());
+	std::filesystem::remove_all("saveFolder");
+}
+
+TEST(CK2ToEU4_SaveFolderTests, MissingFolderHasNoSaves)
+{
+	std::filesystem::remove_all("saveFolder");
+	SaveFolder saveFolder("saveFolder");
+
+	EXPECT_TRUE(saveFolder.takeSettledSaves().empty());
+}